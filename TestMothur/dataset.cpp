@@ -126,5 +126,17 @@ void TestDataSet::fillLookup() {
     lookup = input.getSharedRAbundVectors();
 }
 /***********************************************************************/
-
-
+string TestDataSet::getRandomSeq(int length, string bases) {
+    string seq = "";
+    for (int i = 0; i < length; i++) { seq += bases[rand() % bases.length()]; }
+    return seq;
+}
+/***********************************************************************/
+string TestDataSet::readFile(string filename) {
+    ifstream in(filename.c_str(), ios::binary);
+    stringstream contents;
+    contents << in.rdbuf();
+    in.close();
+    return contents.str();
+}
+/***********************************************************************/
@@ -27,6 +27,10 @@ public:
     vector<SharedRAbundVector*> getLookup()     { fillLookup(); return lookup;          }
     vector<string> getSubsetFNGFiles(int);  //number of uniques, Fasta, name, group returned
     
+    void seedRandom(int offset = 0)             { srand(54321 + offset);                } //the same random fixtures every run
+    string getRandomSeq(int, string bases = "ACGT"); //length, characters to draw from
+    string readFile(string);                    //whole file, byte for byte
+    
 private:
     MothurOut* m;
     TestFastqDataSet fastqData;
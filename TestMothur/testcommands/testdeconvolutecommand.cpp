@@ -0,0 +1,195 @@
+//
+//  testdeconvolutecommand.cpp
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#include "catch.hpp"
+#include "testdeconvolutecommand.h"
+#include "sequence.hpp"
+
+/**************************************************************************************************/
+TestDeconvoluteCommand::TestDeconvoluteCommand() {  //setup
+    m = MothurOut::getInstance();
+    data.seedRandom();
+    
+    vector<string> distinct;
+    for (int i = 0; i < 50; i++) { distinct.push_back(data.getRandomSeq(60, "ACGT-")); }
+    
+    //duplicates are spread through the file so they land in different batches
+    fastaFile = "uniqueseqstest.fasta"; nameFile = "uniqueseqstest.input.names";
+    countFile = "uniqueseqstest.input.count_table"; partialNameFile = "uniqueseqstest.partial.names";
+    ofstream outFasta, outNames, outCount, outPartial;
+    m->openOutputFile(fastaFile, outFasta); m->openOutputFile(nameFile, outNames);
+    m->openOutputFile(countFile, outCount); m->openOutputFile(partialNameFile, outPartial);
+    outCount << "Representative_Sequence\ttotal" << endl;
+    for (int i = 0; i < 400; i++) {
+        string readName = "read" + toString(i);
+        string names = readName;
+        for (int j = 0; j < (i % 3); j++) { names += "," + readName + "_" + toString(j); }
+        nameMap[readName] = names;
+        countMap[readName] = 1 + (i % 4);
+        
+        outFasta << ">" << readName << endl << distinct[(i < distinct.size()) ? i : (rand() % distinct.size())] << endl;
+        outNames << readName << '\t' << names << endl;
+        outCount << readName << '\t' << countMap[readName] << endl;
+        if (i != 123) { outPartial << readName << '\t' << names << endl; } //read123 is missing
+    }
+    outFasta.close(); outNames.close(); outCount.close(); outPartial.close();
+}
+/**************************************************************************************************/
+TestDeconvoluteCommand::~TestDeconvoluteCommand() {
+    m->mothurRemove(fastaFile); m->mothurRemove(nameFile); m->mothurRemove(countFile); m->mothurRemove(partialNameFile); //teardown
+    for (int i = 0; i < outputFiles.size(); i++) { m->mothurRemove(outputFiles[i]); }
+}
+/**************************************************************************************************/
+bool TestDeconvoluteCommand::runUniqueSeqs(string options, int batchLength, string& fasta, string& names) {
+    DeconvoluteCommand uniqueSeqs("fasta=" + fastaFile + ", " + options);
+    uniqueSeqs.batchLength = batchLength;
+    uniqueSeqs.execute();
+    
+    fasta = ""; names = "";
+    if (uniqueSeqs.outputTypes["fasta"].size() == 0) { return false; }
+    
+    string uniqueFasta = uniqueSeqs.outputTypes["fasta"][0];
+    string uniqueNames = "";
+    if (uniqueSeqs.outputTypes["name"].size() != 0) { uniqueNames = uniqueSeqs.outputTypes["name"][0]; }
+    else { uniqueNames = uniqueSeqs.outputTypes["count"][0]; }
+    outputFiles.push_back(uniqueFasta); outputFiles.push_back(uniqueNames);
+    
+    fasta = data.readFile(uniqueFasta);
+    names = data.readFile(uniqueNames);
+    return true;
+}
+/**************************************************************************************************/
+void TestDeconvoluteCommand::findExpected(string input, string format, string& fasta, string& names) {
+    map<string, int> uniqueIndex; //sequenceString -> index of its unique
+    vector< vector<string> > uniqueReads; //reads of each unique, representative first
+    
+    ifstream in; m->openInputFile(fastaFile, in);
+    fasta = "";
+    while (!in.eof()) {
+        Sequence seq(in); m->gobble(in);
+        if (seq.getName() == "") { continue; }
+        
+        map<string, int>::iterator it = uniqueIndex.find(seq.getAligned());
+        if (it == uniqueIndex.end()) {
+            fasta += ">" + seq.getName() + "\n" + seq.getAligned() + "\n";
+            uniqueIndex[seq.getAligned()] = uniqueReads.size();
+            uniqueReads.push_back(vector<string>(1, seq.getName()));
+        }else { uniqueReads[it->second].push_back(seq.getName()); }
+    }
+    in.close();
+    
+    names = "";
+    if (format == "count") { names = "Representative_Sequence\ttotal\n"; }
+    for (int i = 0; i < uniqueReads.size(); i++) {
+        string list = ""; int total = 0;
+        for (int j = 0; j < uniqueReads[i].size(); j++) {
+            string readName = uniqueReads[i][j];
+            string readList = readName; int readTotal = 1;
+            if (input == "name") { readList = nameMap[readName]; readTotal = m->getNumNames(readList); }
+            else if (input == "count") {
+                readTotal = countMap[readName];
+                readList = readName + "_0";
+                for (int k = 1; k < readTotal; k++) { readList += "," + readName + "_" + toString(k); }
+            }
+            
+            if (j != 0) { list += ","; }
+            list += readList; total += readTotal;
+        }
+        
+        if (format == "count") { names += uniqueReads[i][0] + "\t" + toString(total) + "\n"; }
+        else { names += list.substr(0, list.find_first_of(',')) + "\t" + list + "\n"; }
+    }
+}
+/**************************************************************************************************/
+TEST_CASE("Testing DeconvoluteCommand Class") {
+    TestDeconvoluteCommand testUnique;
+    
+    string expectedFasta, expectedNames;
+    testUnique.findExpected("fasta", "name", expectedFasta, expectedNames);
+    
+    SECTION("One Processor") {
+        INFO("Using fasta only and one batch") // Only appears on a FAIL
+        
+        string fasta, names;
+        testUnique.runUniqueSeqs("processors=1", 16777216, fasta, names);
+        
+        CHECK(fasta == expectedFasta);
+        CHECK(names == expectedNames);
+    }
+    
+    SECTION("Several Processors And Batches") {
+        INFO("Using fasta only, 3 processors and about 8 reads per batch") // Only appears on a FAIL
+        
+        string fasta, names;
+        testUnique.runUniqueSeqs("processors=3", 500, fasta, names);
+        
+        CHECK(fasta == expectedFasta);
+        CHECK(names == expectedNames);
+    }
+    
+    SECTION("Name File") {
+        INFO("Using a name file, 2 processors and about 5 reads per batch") // Only appears on a FAIL
+        
+        testUnique.findExpected("name", "name", expectedFasta, expectedNames);
+        
+        string fasta, names;
+        testUnique.runUniqueSeqs("name=" + testUnique.nameFile + ", processors=2", 300, fasta, names);
+        
+        CHECK(fasta == expectedFasta);
+        CHECK(names == expectedNames);
+    }
+    
+    SECTION("Count File") {
+        INFO("Using a count file and format=count, 2 processors and about 5 reads per batch") // Only appears on a FAIL
+        
+        testUnique.findExpected("count", "count", expectedFasta, expectedNames);
+        
+        string fasta, names;
+        testUnique.runUniqueSeqs("count=" + testUnique.countFile + ", format=count, processors=2", 300, fasta, names);
+        
+        CHECK(fasta == expectedFasta);
+        CHECK(names == expectedNames);
+    }
+    
+    SECTION("Count File To Name File") {
+        INFO("Using a count file and format=name") // Only appears on a FAIL
+        
+        testUnique.findExpected("count", "name", expectedFasta, expectedNames);
+        
+        string fasta, names;
+        testUnique.runUniqueSeqs("count=" + testUnique.countFile + ", format=name, processors=1", 16777216, fasta, names);
+        
+        CHECK(fasta == expectedFasta);
+        CHECK(names == expectedNames);
+    }
+    
+    SECTION("Fasta To Count File") {
+        INFO("Using fasta only and format=count, 3 processors and about 8 reads per batch") // Only appears on a FAIL
+        
+        testUnique.findExpected("fasta", "count", expectedFasta, expectedNames);
+        
+        string fasta, names;
+        testUnique.runUniqueSeqs("format=count, processors=3", 500, fasta, names);
+        
+        CHECK(fasta == expectedFasta);
+        CHECK(names == expectedNames);
+    }
+    
+    SECTION("Read Missing From Name File") {
+        INFO("Using a name file without read123, unique.seqs must stop and leave no output") // Only appears on a FAIL
+        
+        string fasta, names;
+        bool finished = testUnique.runUniqueSeqs("name=" + testUnique.partialNameFile + ", processors=2", 300, fasta, names);
+        bool stopped = testUnique.m->control_pressed;
+        testUnique.m->control_pressed = false;
+        
+        CHECK(!finished);
+        CHECK(stopped);
+        CHECK(!testUnique.m->fileExists("uniqueseqstest.unique.fasta"));
+    }
+}
+/**************************************************************************************************/
@@ -0,0 +1,37 @@
+//
+//  testdeconvolutecommand.h
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testdeconvolutecommand__
+#define __Mothur__testdeconvolutecommand__
+
+#include "deconvolutecommand.h"
+#include "dataset.h"
+
+class TestDeconvoluteCommand {
+    
+public:
+    
+    TestDeconvoluteCommand();
+    ~TestDeconvoluteCommand();
+    
+    MothurOut* m;
+    string fastaFile, nameFile, countFile, partialNameFile;
+    vector<string> outputFiles;
+    
+    //runs unique.seqs and fills the unique fasta and names or count file it wrote, false if it wrote none
+    bool runUniqueSeqs(string, int, string&, string&);
+    //the unique fasta and names or count file of the map keyed by aligned sequence unique.seqs used before the fingerprints
+    void findExpected(string, string, string&, string&); //input fasta, name or count, output format
+    
+private:
+    vector<string> readNames, readSeqs;
+    map<string, string> nameMap;
+    map<string, int> countMap;
+    TestDataSet data;
+};
+
+#endif /* defined(__Mothur__testdeconvolutecommand__) */
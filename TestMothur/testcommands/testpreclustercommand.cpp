@@ -0,0 +1,156 @@
+//
+//  testpreclustercommand.cpp
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#include "catch.hpp"
+#include "testpreclustercommand.h"
+
+/**************************************************************************************************/
+TestPreClusterCommand::TestPreClusterCommand() {  //setup
+    m = MothurOut::getInstance();
+    data.seedRandom();
+
+    //a few parents aligned to 150 columns, with variants 0 to 4 changes away from them
+    vector<string> parents;
+    for (int i = 0; i < 8; i++) {
+        string aligned = "";
+        for (int j = 0; j < 150; j++) {
+            if ((j < 5) || (j >= 145))  { aligned += '.'; }
+            else if ((j % 9) == 0)      { aligned += '-'; }
+            else                        { aligned += data.getRandomSeq(1); }
+        }
+        parents.push_back(aligned);
+    }
+
+    set<string> seen;
+    for (int i = 0; uniqueSeqs.size() < 200; i++) {
+        string aligned = parents[rand() % parents.size()];
+        int changes = rand() % 5;
+        for (int c = 0; c < changes; c++) {
+            int column = 5 + (rand() % 140);
+            if ((column % 9) == 0) { aligned[column] = data.getRandomSeq(1)[0]; }
+            else { aligned[column] = (((rand() % 4) == 0) ? '-' : data.getRandomSeq(1)[0]); }
+        }
+        if (seen.count(aligned) != 0) { continue; }
+        seen.insert(aligned);
+        uniqueNames.push_back("seq" + toString(i)); uniqueSeqs.push_back(aligned);
+    }
+
+    fastaFile = "preclustertest.fasta"; nameFile = "preclustertest.names"; countFile = "preclustertest.count_table";
+    ofstream outFasta, outNames, outCount;
+    m->openOutputFile(fastaFile, outFasta); m->openOutputFile(nameFile, outNames); m->openOutputFile(countFile, outCount);
+    outCount << "Representative_Sequence\ttotal\tA\tB\tC" << endl;
+    for (int i = 0; i < uniqueSeqs.size(); i++) {
+        string names = uniqueNames[i];
+        int abundance = 1 + (rand() % 20);
+        for (int j = 1; j < abundance; j++) { names += "," + uniqueNames[i] + "_" + toString(j); }
+
+        //every seq is in group A, some are in B and C as well
+        int a = 1 + (rand() % 10); int b = rand() % 3; int c = (i % 2) * (rand() % 5);
+
+        outFasta << ">" << uniqueNames[i] << endl << uniqueSeqs[i] << endl;
+        outNames << uniqueNames[i] << '\t' << names << endl;
+        outCount << uniqueNames[i] << '\t' << (a+b+c) << '\t' << a << '\t' << b << '\t' << c << endl;
+    }
+    outFasta.close(); outNames.close(); outCount.close();
+}
+/**************************************************************************************************/
+TestPreClusterCommand::~TestPreClusterCommand() {
+    m->mothurRemove(fastaFile); m->mothurRemove(nameFile); m->mothurRemove(countFile); //teardown
+    for (int i = 0; i < outputFiles.size(); i++) { m->mothurRemove(outputFiles[i]); }
+}
+/**************************************************************************************************/
+map<string, string> TestPreClusterCommand::runPreCluster(string options, bool useIndex) {
+    PreClusterCommand preCluster("fasta=" + fastaFile + ", " + options);
+    preCluster.useIndex = useIndex;
+    preCluster.execute();
+
+    //the outputs of both runs have the same names, so they are read before the next run
+    map<string, string> outputs;
+    for (map<string, vector<string> >::iterator it = preCluster.outputTypes.begin(); it != preCluster.outputTypes.end(); it++) {
+        for (int i = 0; i < it->second.size(); i++) {
+            outputs[it->first] += data.readFile(it->second[i]);
+            outputFiles.push_back(it->second[i]);
+        }
+    }
+    return outputs;
+}
+/**************************************************************************************************/
+TEST_CASE("Testing PreClusterCommand Class") {
+    TestPreClusterCommand testPreCluster;
+
+    SECTION("Index Candidates") {
+        INFO("Every seq within diffs of seq i must be a candidate of seq i") // Only appears on a FAIL
+
+        vector<seqPNode> seqs;
+        for (int i = 0; i < testPreCluster.uniqueSeqs.size(); i++) {
+            seqs.push_back(seqPNode(1, Sequence(testPreCluster.uniqueNames[i], testPreCluster.uniqueSeqs[i]), testPreCluster.uniqueNames[i]));
+            seqs[i].filteredSeq = PackedSeq(testPreCluster.uniqueNames[i], testPreCluster.uniqueSeqs[i]);
+        }
+
+        for (int diffs = 1; diffs < 4; diffs++) {
+            PreClusterIndex index(seqs, diffs, true);
+            CHECK(index.isIndexed());
+
+            int numClose = 0; int numMissing = 0; int numCandidates = 0;
+            vector<int> candidates;
+            for (int i = 0; i < seqs.size(); i++) {
+                index.getCandidates(i, candidates);
+                numCandidates += candidates.size();
+                set<int> found(candidates.begin(), candidates.end());
+                for (int j = i+1; j < seqs.size(); j++) {
+                    if (seqs[i].filteredSeq.countMismatches(seqs[j].filteredSeq, diffs) > diffs) { continue; }
+                    numClose++;
+                    if (found.count(j) == 0) { numMissing++; }
+                }
+            }
+
+            CAPTURE(diffs);
+            CAPTURE(numClose);
+            CAPTURE(numCandidates);
+            CHECK(numClose > 0);
+            CHECK(numMissing == 0);
+            CHECK(numCandidates < (seqs.size() * (seqs.size()-1) / 2));
+        }
+    }
+
+    SECTION("Top Down With Names") {
+        INFO("Using a name file, diffs=2") // Only appears on a FAIL
+
+        map<string, string> expected = testPreCluster.runPreCluster("name=" + testPreCluster.nameFile + ", diffs=2", false);
+        map<string, string> indexed = testPreCluster.runPreCluster("name=" + testPreCluster.nameFile + ", diffs=2", true);
+
+        CHECK(expected["fasta"] != "");
+        CHECK(indexed["fasta"] == expected["fasta"]);
+        CHECK(indexed["name"] == expected["name"]);
+        CHECK(indexed["map"] == expected["map"]);
+    }
+
+    SECTION("Bottom Up With Groups") {
+        INFO("Using a count file with groups, diffs=1, topdown=F") // Only appears on a FAIL
+
+        map<string, string> expected = testPreCluster.runPreCluster("count=" + testPreCluster.countFile + ", diffs=1, topdown=F", false);
+        map<string, string> indexed = testPreCluster.runPreCluster("count=" + testPreCluster.countFile + ", diffs=1, topdown=F", true);
+
+        CHECK(expected["fasta"] != "");
+        CHECK(indexed["fasta"] == expected["fasta"]);
+        CHECK(indexed["count"] == expected["count"]);
+        CHECK(indexed["map"] == expected["map"]);
+    }
+
+    SECTION("Several Processors") {
+        INFO("Using a count file with groups, diffs=3, processors=2") // Only appears on a FAIL
+
+        map<string, string> expected = testPreCluster.runPreCluster("count=" + testPreCluster.countFile + ", diffs=3, processors=1", false);
+        map<string, string> indexed = testPreCluster.runPreCluster("count=" + testPreCluster.countFile + ", diffs=3, processors=2", true);
+
+        CHECK(expected["fasta"] != "");
+        CHECK(indexed["fasta"] == expected["fasta"]);
+        CHECK(indexed["count"] == expected["count"]);
+        CHECK(indexed["map"] == expected["map"]);
+    }
+}
+/**************************************************************************************************/
@@ -0,0 +1,33 @@
+//
+//  testpreclustercommand.h
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testpreclustercommand__
+#define __Mothur__testpreclustercommand__
+
+#include "preclustercommand.h"
+#include "dataset.h"
+
+class TestPreClusterCommand {
+
+public:
+
+    TestPreClusterCommand();
+    ~TestPreClusterCommand();
+
+    MothurOut* m;
+    string fastaFile, nameFile, countFile;
+    vector<string> uniqueNames, uniqueSeqs; //the seqs in the fasta file
+
+    //runs pre.cluster and returns the fasta, name or count and map files it wrote, keyed by output type
+    map<string, string> runPreCluster(string, bool); //options, use the index
+
+private:
+    TestDataSet data;
+    vector<string> outputFiles;
+};
+
+#endif /* defined(__Mothur__testpreclustercommand__) */
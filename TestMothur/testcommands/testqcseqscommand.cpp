@@ -0,0 +1,194 @@
+//
+//  testqcseqscommand.cpp
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#include "catch.hpp"
+#include "testqcseqscommand.h"
+#include "seqsummarycommand.h"
+#include "screenseqscommand.h"
+#include "filterseqscommand.h"
+#include "deconvolutecommand.h"
+
+/**************************************************************************************************/
+TestQcSeqsCommand::TestQcSeqsCommand() {  //setup
+    m = MothurOut::getInstance();
+    data.seedRandom();
+
+    //aligned to 120 columns, every 7th column is a gap in all of them, the ends vary and a few have N's
+    vector<string> distinct;
+    for (int i = 0; i < 40; i++) {
+        int leading = rand() % 12; int trailing = rand() % 12;
+        string aligned = "";
+        for (int j = 0; j < 120; j++) {
+            if ((j < leading) || (j >= (120 - trailing))) { aligned += '.'; }
+            else if ((j % 7) == 0)          { aligned += '-'; }
+            else if ((rand() % 100) < 3)    { aligned += '-'; }
+            else if ((rand() % 100) < 2)    { aligned += 'N'; }
+            else                            { aligned += data.getRandomSeq(1); }
+        }
+        distinct.push_back(aligned);
+    }
+
+    fastaFile = "qcseqstest.fasta"; nameFile = "qcseqstest.names"; countFile = "qcseqstest.count_table"; shortFastaFile = "qcseqstest.short.fasta";
+    ofstream outFasta, outNames, outCount, outShort;
+    m->openOutputFile(fastaFile, outFasta); m->openOutputFile(nameFile, outNames); m->openOutputFile(countFile, outCount); m->openOutputFile(shortFastaFile, outShort);
+    outCount << "Representative_Sequence\ttotal" << endl;
+    for (int i = 0; i < 300; i++) {
+        string readName = "read" + toString(i);
+        string names = readName;
+        for (int j = 0; j < (i % 3); j++) { names += "," + readName + "_" + toString(j); }
+
+        string aligned = distinct[(i < distinct.size()) ? i : (rand() % distinct.size())];
+        outFasta << ">" << readName << endl << aligned << endl;
+        outNames << readName << '\t' << names << endl;
+        outCount << readName << '\t' << (1 + (i % 4)) << endl;
+
+        //one sequence is a column short
+        if (i == 150) { aligned = aligned.substr(0, aligned.length()-1); }
+        outShort << ">" << readName << endl << aligned << endl;
+    }
+    outFasta.close(); outNames.close(); outCount.close(); outShort.close();
+}
+/**************************************************************************************************/
+TestQcSeqsCommand::~TestQcSeqsCommand() {
+    removeCache(); //teardown
+    m->mothurRemove(fastaFile); m->mothurRemove(nameFile); m->mothurRemove(countFile); m->mothurRemove(shortFastaFile);
+    for (int i = 0; i < outputFiles.size(); i++) { m->mothurRemove(outputFiles[i]); }
+}
+/**************************************************************************************************/
+void TestQcSeqsCommand::removeCache() {
+    m->mothurRemove(SummaryCache::getCacheName(fastaFile));
+    m->mothurRemove(SummaryCache::getCacheName(shortFastaFile));
+}
+/**************************************************************************************************/
+string TestQcSeqsCommand::inputOption(string input, string fasta) {
+    string option = "fasta=" + fasta;
+    if (input == "name")        { option += ", name=" + nameFile;   }
+    else if (input == "count")  { option += ", count=" + countFile; }
+    return option;
+}
+/**************************************************************************************************/
+void TestQcSeqsCommand::keepOutputs(Command& command, map<string, string>& outputs, string type, string saveAs) {
+    map<string, vector<string> > files = command.getOutputFiles();
+    for (map<string, vector<string> >::iterator it = files.begin(); it != files.end(); it++) {
+        outputFiles.insert(outputFiles.end(), it->second.begin(), it->second.end());
+    }
+    if (files[type].size() != 0) { outputs[saveAs] = data.readFile(files[type][0]); }
+}
+/**************************************************************************************************/
+map<string, string> TestQcSeqsCommand::runSeparately(string input, string screenOptions, string filterOptions) {
+    map<string, string> outputs;
+
+    SeqSummaryCommand summary(inputOption(input, fastaFile) + ", processors=1");
+    summary.execute();
+    keepOutputs(summary, outputs, "summary", "summary");
+
+    ScreenSeqsCommand screen(inputOption(input, fastaFile) + ", " + screenOptions + ", processors=1");
+    screen.execute();
+    keepOutputs(screen, outputs, "accnos", "accnos");
+    string goodFasta = screen.getOutputFiles()["fasta"][0];
+
+    string filterOption = "fasta=" + goodFasta + ", processors=1";
+    if (filterOptions != "") { filterOption += ", " + filterOptions; }
+    FilterSeqsCommand filter(filterOption);
+    filter.execute();
+    keepOutputs(filter, outputs, "filter", "filter");
+    string filteredFasta = filter.getOutputFiles()["fasta"][0];
+
+    string uniqueOption = "fasta=" + filteredFasta;
+    if (input == "name")        { uniqueOption += ", name=" + screen.getOutputFiles()["name"][0];   }
+    else if (input == "count")  { uniqueOption += ", count=" + screen.getOutputFiles()["count"][0]; }
+    DeconvoluteCommand unique(uniqueOption);
+    unique.execute();
+    keepOutputs(unique, outputs, "fasta", "fasta");
+    keepOutputs(unique, outputs, "name", "names");
+    keepOutputs(unique, outputs, "count", "names");
+
+    return outputs;
+}
+/**************************************************************************************************/
+map<string, string> TestQcSeqsCommand::runQcSeqs(string input, string screenOptions, string filterOptions, int processors) {
+    map<string, string> outputs;
+
+    string fasta = fastaFile;
+    if (input == "short") { fasta = shortFastaFile; input = ""; }
+
+    string options = inputOption(input, fasta) + ", " + screenOptions + ", processors=" + toString(processors);
+    if (filterOptions != "") { options += ", " + filterOptions; }
+    QcSeqsCommand qc(options);
+    qc.execute();
+
+    keepOutputs(qc, outputs, "summary", "summary");
+    keepOutputs(qc, outputs, "accnos", "accnos");
+    keepOutputs(qc, outputs, "filter", "filter");
+    keepOutputs(qc, outputs, "fasta", "fasta");
+    keepOutputs(qc, outputs, "name", "names");
+    keepOutputs(qc, outputs, "count", "names");
+
+    return outputs;
+}
+/**************************************************************************************************/
+TEST_CASE("Testing QcSeqsCommand Class") {
+    TestQcSeqsCommand testQc;
+
+    SECTION("Fasta Only") {
+        INFO("Using optimize=start-end, vertical=T and trump=.") // Only appears on a FAIL
+
+        testQc.removeCache();
+        map<string, string> expected = testQc.runSeparately("", "optimize=start-end, criteria=90", "vertical=T, trump=.");
+        testQc.removeCache();
+        map<string, string> qc = testQc.runQcSeqs("", "optimize=start-end, criteria=90", "vertical=T, trump=.", 1);
+
+        CHECK(expected.size() == 5);
+        CHECK(qc["summary"] == expected["summary"]);
+        CHECK(qc["accnos"] == expected["accnos"]);
+        CHECK(qc["filter"] == expected["filter"]);
+        CHECK(qc["fasta"] == expected["fasta"]);
+        CHECK(qc["names"] == expected["names"]);
+        CHECK(expected["accnos"] != "");
+    }
+
+    SECTION("Name File") {
+        INFO("Using a name file, maxambig=0, optimize=start-minlength and vertical=T with 2 processors") // Only appears on a FAIL
+
+        testQc.removeCache();
+        map<string, string> expected = testQc.runSeparately("name", "maxambig=0, optimize=start-minlength, criteria=90", "vertical=T");
+        map<string, string> qc = testQc.runQcSeqs("name", "maxambig=0, optimize=start-minlength, criteria=90", "vertical=T", 2);
+
+        CHECK(qc["summary"] == expected["summary"]);
+        CHECK(qc["accnos"] == expected["accnos"]);
+        CHECK(qc["filter"] == expected["filter"]);
+        CHECK(qc["fasta"] == expected["fasta"]);
+        CHECK(qc["names"] == expected["names"]);
+    }
+
+    SECTION("Count File") {
+        INFO("Using a count file, optimize=end, soft=30 and trump=N") // Only appears on a FAIL
+
+        testQc.removeCache();
+        map<string, string> expected = testQc.runSeparately("count", "optimize=end, criteria=90", "soft=30, trump=N");
+        testQc.removeCache();
+        map<string, string> qc = testQc.runQcSeqs("count", "optimize=end, criteria=90", "soft=30, trump=N", 2);
+
+        CHECK(qc["summary"] == expected["summary"]);
+        CHECK(qc["accnos"] == expected["accnos"]);
+        CHECK(qc["filter"] == expected["filter"]);
+        CHECK(qc["fasta"] == expected["fasta"]);
+        CHECK(qc["names"] == expected["names"]);
+    }
+
+    SECTION("Sequences Of Different Lengths") {
+        INFO("Like filter.seqs, qc.seqs stops when a sequence is not as long as the first, even when no columns are removed") // Only appears on a FAIL
+
+        map<string, string> qc = testQc.runQcSeqs("short", "maxambig=10", "vertical=F", 1);
+        bool stopped = testQc.m->control_pressed;
+        testQc.m->control_pressed = false;
+
+        CHECK(stopped);
+        CHECK(qc.size() == 0);
+    }
+}
+/**************************************************************************************************/
@@ -0,0 +1,39 @@
+//
+//  testqcseqscommand.h
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testqcseqscommand__
+#define __Mothur__testqcseqscommand__
+
+#include "qcseqscommand.h"
+#include "dataset.h"
+
+class TestQcSeqsCommand {
+
+public:
+
+    TestQcSeqsCommand();
+    ~TestQcSeqsCommand();
+
+    MothurOut* m;
+    string fastaFile, nameFile, countFile, shortFastaFile;
+
+    //the summary, accnos, filter, fasta and name or count files, by output type
+    //input is "", "name" or "count", the options are the screen.seqs and filter.seqs parameters, the separate commands run on one processor
+    map<string, string> runSeparately(string input, string screenOptions, string filterOptions);
+    map<string, string> runQcSeqs(string input, string screenOptions, string filterOptions, int processors);
+
+    void removeCache();
+
+private:
+    TestDataSet data;
+    vector<string> outputFiles;
+
+    string inputOption(string, string); //input type, fasta file
+    void keepOutputs(Command&, map<string, string>&, string, string); //command, outputs, output type, name to save it as
+};
+
+#endif /* defined(__Mothur__testqcseqscommand__) */
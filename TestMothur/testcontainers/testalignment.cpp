@@ -0,0 +1,104 @@
+//
+//  testalignment.cpp
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#include "catch.hpp"
+#include "testalignment.h"
+
+/**************************************************************************************************/
+TestAlignment::TestAlignment() {  //setup
+    m = MothurOut::getInstance();
+    data.seedRandom();
+    
+    for (int i = 0; i < 20; i++) {
+        string reference = data.getRandomSeq(300 + rand() % 1200);
+        int length = reference.length();
+        int indel = 40 + rand() % 160;
+        int middle = length / 4 + rand() % (length / 2);
+        
+        //a long insertion
+        templates.push_back(reference);
+        candidates.push_back(mutate(reference.substr(0, middle) + data.getRandomSeq(indel) + reference.substr(middle)));
+        
+        //a long deletion
+        templates.push_back(reference);
+        candidates.push_back(mutate(reference.substr(0, middle) + reference.substr(min(length, middle + indel))));
+        
+        //an insertion and a deletion, the diagonal moves twice
+        int second = min(length - 1, middle + indel + rand() % 100);
+        templates.push_back(reference);
+        candidates.push_back(mutate(reference.substr(0, length / 8) + data.getRandomSeq(indel) + reference.substr(length / 8, second - length / 8) + reference.substr(min(length, second + indel))));
+        
+        //deletions near the ends, the best end of the overlap is off the seed diagonal
+        int nearEnd = 1 + rand() % 30;
+        templates.push_back(reference);
+        candidates.push_back(mutate(reference.substr(nearEnd, length - nearEnd - indel - 40) + reference.substr(length - 40, 30)));
+        templates.push_back(reference);
+        candidates.push_back(mutate(reference.substr(0, 30) + reference.substr(30 + indel, length - 30 - indel - nearEnd)));
+        
+        //a partial candidate with a long deletion
+        templates.push_back(reference);
+        candidates.push_back(mutate(reference.substr(length / 5, middle - length / 5) + reference.substr(min(length, middle + indel), length / 5)));
+    }
+}
+/**************************************************************************************************/
+//about 3% substitutions and a few short gaps, like a close relative
+string TestAlignment::mutate(string seq) {
+    string mutated = "";
+    for (int i = 0; i < seq.length(); i++) {
+        int r = rand() % 1000;
+        if (r < 30)         { mutated += "ACGT"[rand() % 4];    }
+        else if (r < 33)    {                                   } //deleted
+        else if (r < 36)    { mutated += seq[i]; mutated += "ACGT"[rand() % 4]; }
+        else                { mutated += seq[i];                }
+    }
+    return mutated;
+}
+/**************************************************************************************************/
+int TestAlignment::countDifferences(Alignment* banded, Alignment* full) {
+    int differences = 0; firstDifference = "";
+    for (int i = 0; i < candidates.size(); i++) {
+        banded->align(candidates[i], templates[i]);
+        full->align(candidates[i], templates[i]);
+        
+        bool same = (banded->getSeqAAln() == full->getSeqAAln()) && (banded->getSeqBAln() == full->getSeqBAln());
+        same = same && (banded->getCandidateStartPos() == full->getCandidateStartPos()) && (banded->getCandidateEndPos() == full->getCandidateEndPos());
+        same = same && (banded->getTemplateStartPos() == full->getTemplateStartPos()) && (banded->getTemplateEndPos() == full->getTemplateEndPos());
+        
+        if (!same) {
+            if (differences == 0) { firstDifference = "pair " + toString(i) + ", lengths " + toString(candidates[i].length()) + " and " + toString(templates[i].length()); }
+            differences++;
+        }
+    }
+    return differences;
+}
+/**************************************************************************************************/
+TEST_CASE("Testing Banded Alignment") {
+    TestAlignment testAlign;
+    
+    SECTION("Needleman") {
+        INFO("Using sequences with long indels, gap -5 match 1 mismatch -1") // Only appears on a FAIL
+        NeedlemanOverlap banded(-5.0, 1.0, -1.0, 2000);
+        NeedlemanOverlap full(-5.0, 1.0, -1.0, 2000);
+        banded.setBanded(true);
+        
+        int differences = testAlign.countDifferences(&banded, &full);
+        CAPTURE(testAlign.firstDifference);
+        CHECK(differences == 0);
+    }
+    
+    SECTION("Gotoh") {
+        INFO("Using sequences with long indels, gap open -5 extend -2 match 1 mismatch -1") // Only appears on a FAIL
+        GotohOverlap banded(-5.0, -2.0, 1.0, -1.0, 2000);
+        GotohOverlap full(-5.0, -2.0, 1.0, -1.0, 2000);
+        banded.setBanded(true);
+        
+        int differences = testAlign.countDifferences(&banded, &full);
+        CAPTURE(testAlign.firstDifference);
+        CHECK(differences == 0);
+    }
+}
+/**************************************************************************************************/
@@ -0,0 +1,34 @@
+//
+//  testalignment.h
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testalignment__
+#define __Mothur__testalignment__
+
+#include "needlemanoverlap.hpp"
+#include "gotohoverlap.hpp"
+#include "dataset.h"
+
+class TestAlignment {
+    
+public:
+    
+    TestAlignment();
+    ~TestAlignment() {}
+    
+    MothurOut* m;
+    vector<string> candidates, templates;
+    string firstDifference;
+    
+    //number of pairs where the banded alignment differs from the full matrix
+    int countDifferences(Alignment*, Alignment*);
+    
+private:
+    TestDataSet data;
+    string mutate(string);
+};
+
+#endif /* defined(__Mothur__testalignment__) */
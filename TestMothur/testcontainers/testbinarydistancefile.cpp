@@ -0,0 +1,195 @@
+//
+//  testbinarydistancefile.cpp
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#include "catch.hpp"
+#include "testbinarydistancefile.h"
+
+/**************************************************************************************************/
+TestBinaryDistanceFile::TestBinaryDistanceFile(double c) : cutoff(c) {  //setup
+    m = MothurOut::getInstance();
+    data.seedRandom();
+    precision = BinaryDistanceFile::precisionForCutoff(cutoff);
+    
+    columnFile = "testbinarydist.column.dist";
+    binaryFile = "testbinarydist.binary.dist";
+    exportFile = "testbinarydist.export.dist";
+    damagedFile = "testbinarydist.damaged.dist";
+    
+    for (int i = 0; i < 40; i++) { names.push_back("seq" + toString(i)); }
+    
+    //the column file the way dist.seqs writes it, with small distances, 0 and the cutoff
+    ofstream out;
+    m->openOutputFile(columnFile, out);
+    out.setf(ios::fixed, ios::showpoint);
+    out << setprecision(4);
+    for (int i = 1; i < names.size(); i++) {
+        for (int j = 0; j < i; j++) {
+            double dist = (rand() % 100000) / 100000.0 * cutoff;
+            if ((i+j) % 7 == 0) { dist = dist / 100.0; }
+            if ((i+j) % 11 == 0) { dist = 0.0; }
+            if ((i+j) % 13 == 0) { dist = cutoff; }
+            if ((i+j) % 3 == 0) { continue; } //pairs above the cutoff are not in the file
+            
+            out << names[i] << ' ' << names[j] << ' ' << dist << '\n';
+            rows.push_back(i); cols.push_back(j);
+        }
+    }
+    out.close();
+    
+    //the printed distances, since that is what the binary file must reproduce
+    ifstream in;
+    m->openInputFile(columnFile, in);
+    string first, second, dist;
+    while (in >> first >> second >> dist) { distStrings.push_back(dist); }
+    in.close();
+}
+/**************************************************************************************************/
+TestBinaryDistanceFile::~TestBinaryDistanceFile() {
+    m->mothurRemove(columnFile);
+    m->mothurRemove(binaryFile);
+    m->mothurRemove(exportFile);
+    m->mothurRemove(damagedFile);
+}
+/**************************************************************************************************/
+void TestBinaryDistanceFile::writeBinary(string filename) {
+    BinaryDistanceFile::writeHeader(filename, names, precision);
+    
+    string buffer = "";
+    for (int k = 0; k < rows.size(); k++) {
+        double dist = atof(distStrings[k].c_str()); //column files can hold exponents
+        BinaryDistanceFile::appendRecord(buffer, rows[k], cols[k], dist, precision);
+        if (buffer.length() > 1000) { BinaryDistanceFile::appendRecords(filename, buffer); } //several appends, like the tiles
+    }
+    BinaryDistanceFile::appendRecords(filename, buffer);
+}
+/**************************************************************************************************/
+void TestBinaryDistanceFile::writeDamaged(string filename, unsigned long long length) {
+    string contents = data.readFile(binaryFile);
+    ofstream out(filename.c_str(), ios::binary);
+    out.write(contents.c_str(), min((unsigned long long)contents.length(), length));
+    out.close();
+}
+/**************************************************************************************************/
+//distances at or above 1000/precision keep all 4 significant digits, smaller ones are kept to the precision
+int TestBinaryDistanceFile::countDifferences(string exported) {
+    ifstream in;
+    m->openInputFile(exported, in);
+    
+    int differences = 0; firstDifference = "";
+    string first, second, printed;
+    for (int k = 0; k < rows.size(); k++) {
+        if (!(in >> first >> second >> printed)) { differences += rows.size() - k; break; }
+        
+        double dist, exportedDist;
+        dist = atof(distStrings[k].c_str()); exportedDist = atof(printed.c_str());
+        
+        bool same = (first == names[rows[k]]) && (second == names[cols[k]]);
+        if ((dist == 0) || (dist >= (1000.0 / precision))) { same = same && (printed == distStrings[k]); }
+        else { same = same && (fabs(exportedDist - dist) <= (0.5 / precision + 1e-9)); }
+        
+        if (!same) {
+            if (differences == 0) { firstDifference = first + " " + second + " " + printed + " != " + distStrings[k]; }
+            differences++;
+        }
+    }
+    if (in >> first) { differences++; }
+    in.close();
+    
+    return differences;
+}
+/**************************************************************************************************/
+TEST_CASE("Testing BinaryDistanceFile Class") {
+    
+    SECTION("Round Trip") {
+        INFO("Using column -> binary -> column with a cutoff of 0.06") // Only appears on a FAIL
+        TestBinaryDistanceFile testBinary(0.06);
+        testBinary.writeBinary(testBinary.binaryFile);
+        
+        CHECK(BinaryDistanceFile::isBinary(testBinary.binaryFile));
+        CHECK(!BinaryDistanceFile::isBinary(testBinary.columnFile));
+        
+        BinaryDistanceFile binary(testBinary.binaryFile);
+        CHECK(!testBinary.m->control_pressed);
+        CHECK(binary.getPrecision() == 1000000);
+        CHECK(binary.getNames() == testBinary.names);
+        CHECK(binary.getNumDists() == testBinary.rows.size());
+        
+        binary.exportColumn(testBinary.exportFile);
+        int differences = testBinary.countDifferences(testBinary.exportFile);
+        CAPTURE(testBinary.firstDifference);
+        CHECK(differences == 0);
+    }
+    
+    SECTION("Round Trip Default Cutoff") {
+        INFO("Using column -> binary -> column with a cutoff of 1.0") // Only appears on a FAIL
+        TestBinaryDistanceFile testBinary(1.0);
+        testBinary.writeBinary(testBinary.binaryFile);
+        
+        BinaryDistanceFile binary(testBinary.binaryFile);
+        CHECK(!testBinary.m->control_pressed);
+        CHECK(binary.getPrecision() == 10000);
+        CHECK(binary.getNames() == testBinary.names);
+        CHECK(binary.getNumDists() == testBinary.rows.size());
+        
+        binary.exportColumn(testBinary.exportFile);
+        int differences = testBinary.countDifferences(testBinary.exportFile);
+        CAPTURE(testBinary.firstDifference);
+        CHECK(differences == 0);
+    }
+    
+    SECTION("Damaged Files") {
+        INFO("Using missing, short, mislabeled and truncated files") // Only appears on a FAIL
+        TestBinaryDistanceFile testBinary(1.0);
+        testBinary.writeBinary(testBinary.binaryFile);
+        
+        string binaryContents = testBinary.data.readFile(testBinary.binaryFile);
+        unsigned long long headerAndNames = binaryContents.length() - (testBinary.rows.size() * BinaryDistanceFile::recordSize);
+        
+        //missing
+        testBinary.m->control_pressed = false;
+        BinaryDistanceFile missing("testbinarydist.missing.dist");
+        CHECK(testBinary.m->control_pressed);
+        CHECK(missing.getNumDists() == 0);
+        
+        //shorter than the header
+        testBinary.m->control_pressed = false;
+        testBinary.writeDamaged(testBinary.damagedFile, 20);
+        BinaryDistanceFile shortHeader(testBinary.damagedFile);
+        CHECK(testBinary.m->control_pressed);
+        CHECK(shortHeader.getNumDists() == 0);
+        
+        //a column file is not a binary file
+        testBinary.m->control_pressed = false;
+        BinaryDistanceFile column(testBinary.columnFile);
+        CHECK(testBinary.m->control_pressed);
+        CHECK(column.getNumDists() == 0);
+        
+        //cut inside the name table
+        testBinary.m->control_pressed = false;
+        testBinary.writeDamaged(testBinary.damagedFile, headerAndNames - 5);
+        BinaryDistanceFile cutNames(testBinary.damagedFile);
+        CHECK(testBinary.m->control_pressed);
+        CHECK(cutNames.getNumDists() == 0);
+        
+        //cut inside the last distance
+        testBinary.m->control_pressed = false;
+        testBinary.writeDamaged(testBinary.damagedFile, binaryContents.length() - 3);
+        BinaryDistanceFile cutDists(testBinary.damagedFile);
+        CHECK(testBinary.m->control_pressed);
+        CHECK(cutDists.getNumDists() == 0);
+        
+        //cut between distances is still readable
+        testBinary.m->control_pressed = false;
+        testBinary.writeDamaged(testBinary.damagedFile, headerAndNames + 5 * BinaryDistanceFile::recordSize);
+        BinaryDistanceFile cutBetween(testBinary.damagedFile);
+        CHECK(!testBinary.m->control_pressed);
+        CHECK(cutBetween.getNumDists() == 5);
+        
+        testBinary.m->control_pressed = false;
+    }
+}
+/**************************************************************************************************/
@@ -0,0 +1,36 @@
+//
+//  testbinarydistancefile.h
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testbinarydistancefile__
+#define __Mothur__testbinarydistancefile__
+
+#include "binarydistancefile.h"
+#include "dataset.h"
+
+class TestBinaryDistanceFile {
+    
+public:
+    
+    TestBinaryDistanceFile(double); //cutoff
+    ~TestBinaryDistanceFile();
+    
+    MothurOut* m;
+    double cutoff;
+    unsigned int precision;
+    vector<string> names;
+    vector<unsigned int> rows, cols;
+    vector<string> distStrings; //the distances as the column file prints them
+    string columnFile, binaryFile, exportFile, damagedFile;
+    
+    void writeBinary(string); //writes names and distances through the BinaryDistanceFile writers
+    void writeDamaged(string, unsigned long long); //copies the first bytes of the binary file
+    TestDataSet data;
+    int countDifferences(string); //compares an exported column file to the original, returns the number of distances that differ
+    string firstDifference;
+};
+
+#endif /* defined(__Mothur__testbinarydistancefile__) */
@@ -0,0 +1,327 @@
+//
+//  testblockreader.cpp
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#include "catch.hpp"
+#include "testblockreader.h"
+
+#ifdef USE_BOOST
+#include <zlib.h>
+#endif
+
+static const int blockSize = 4194304; //the reader fills its buffer this many bytes at a time
+
+/**************************************************************************************************/
+TestBlockReader::TestBlockReader() {  //setup
+    m = MothurOut::getInstance();
+    data.seedRandom();
+
+    //reads of 150 to 400 bases, the fasta bodies are wrapped at 80 columns and the qual bodies at 20 scores
+    fastaText = ""; qualText = ""; fastqText = "";
+    for (numReads = 0; (fastaText.length() < (blockSize + 100000)) || (fastqText.length() < (blockSize + 100000)); numReads++) {
+        int i = numReads;
+        string name = "read" + toString(i);
+        int length = 150 + (rand() % 251);
+        string bases = data.getRandomSeq(length);
+
+        vector<int> scores; string scoreString = "";
+        for (int j = 0; j < length; j++) { scores.push_back(2 + (rand() % 39)); scoreString += (char)(scores[j] + 33); }
+
+        fastaText += ">" + name + " sample=" + toString(i % 7) + "\n";
+        for (int j = 0; j < length; j += 80) { fastaText += bases.substr(j, 80) + "\n"; }
+
+        qualText += ">" + name + "\n";
+        for (int j = 0; j < length; j++) { qualText += toString(scores[j]) + (((j % 20) == 19) ? "\n" : " "); }
+        qualText += "\n";
+
+        fastqText += "@" + name + " 1:N:0:" + toString(i % 7) + "\n" + bases + "\n+\n" + scoreString + "\n";
+    }
+}
+/**************************************************************************************************/
+TestBlockReader::~TestBlockReader() {
+    for (int i = 0; i < filenames.size(); i++) { m->mothurRemove(filenames[i]); } //teardown
+}
+/**************************************************************************************************/
+string TestBlockReader::writeFile(string filename, string text) {
+    ofstream out;
+    m->openOutputFileBinary(filename, out);
+    out.write(text.c_str(), text.length());
+    out.close();
+    filenames.push_back(filename);
+    return filename;
+}
+/**************************************************************************************************/
+string TestBlockReader::toWindows(string text) {
+    string windows = ""; windows.reserve(text.length() + (text.length() / 10));
+    for (int i = 0; i < text.length(); i++) {
+        if (text[i] == '\n') { windows += '\r'; }
+        windows += text[i];
+    }
+    return windows;
+}
+/**************************************************************************************************/
+bool TestBlockReader::spansEdge(string text) {
+    return ((text.length() > blockSize) && (text[blockSize-1] != '\n') && (text[blockSize] != '\n'));
+}
+/**************************************************************************************************/
+#ifdef USE_BOOST
+string TestBlockReader::writeGzip(string filename, string text, int memberSize) {
+    string compressed = "";
+
+    //plain gzip is one member holding all the text
+    if (memberSize == 0) { memberSize = text.length(); }
+
+    for (int start = 0; start < text.length(); start += memberSize) {
+        string piece = text.substr(start, memberSize);
+
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        if (memberSize == text.length()) { deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15+16, 8, Z_DEFAULT_STRATEGY); }
+        else { deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY); }
+
+        vector<char> deflated(deflateBound(&stream, piece.length()));
+        stream.next_in = (Bytef*)piece.data(); stream.avail_in = piece.length();
+        stream.next_out = (Bytef*)deflated.data(); stream.avail_out = deflated.size();
+        deflate(&stream, Z_FINISH);
+        string body(deflated.data(), stream.total_out);
+        deflateEnd(&stream);
+
+        if (memberSize == text.length()) { compressed += body; continue; }
+
+        //a bgzf member is a gzip header with the 'BC' extra field, the raw deflate data, and the crc and length
+        int blockLength = 18 + body.length() + 8 - 1;
+        unsigned char header[18] = { 0x1f, 0x8b, 8, 4, 0, 0, 0, 0, 0, 0xff, 6, 0, 'B', 'C', 2, 0, (unsigned char)(blockLength & 0xff), (unsigned char)(blockLength >> 8) };
+        unsigned int crc = crc32(0, (Bytef*)piece.data(), piece.length());
+        unsigned int size = piece.length();
+        unsigned char trailer[8] = { (unsigned char)(crc & 0xff), (unsigned char)((crc >> 8) & 0xff), (unsigned char)((crc >> 16) & 0xff), (unsigned char)(crc >> 24),
+                                     (unsigned char)(size & 0xff), (unsigned char)((size >> 8) & 0xff), (unsigned char)((size >> 16) & 0xff), (unsigned char)(size >> 24) };
+        compressed += string((char*)header, 18) + body + string((char*)trailer, 8);
+    }
+
+    //bgzip ends the file with an empty member
+    if (memberSize != text.length()) {
+        unsigned char eofBlock[28] = { 0x1f, 0x8b, 8, 4, 0, 0, 0, 0, 0, 0xff, 6, 0, 'B', 'C', 2, 0, 0x1b, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+        compressed += string((char*)eofBlock, 28);
+    }
+
+    return writeFile(filename, compressed);
+}
+/**************************************************************************************************/
+string TestBlockReader::damage(string filename, int position) {
+    string text = data.readFile(filename);
+    text[position] = ~text[position];
+    return writeFile(filename + ".damaged", text);
+}
+/**************************************************************************************************/
+string TestBlockReader::truncate(string filename, int length) {
+    return writeFile(filename + ".truncated", data.readFile(filename).substr(0, length));
+}
+#endif
+/**************************************************************************************************/
+vector<string> TestBlockReader::readFasta(string filename) {
+    vector<string> records;
+    ifstream in; m->openInputFile(filename, in);
+    while (!in.eof()) {
+        Sequence seq(in); m->gobble(in);
+        if (seq.getName() != "") { records.push_back(seq.getName() + "|" + seq.getComment() + "|" + seq.getAligned()); }
+    }
+    in.close();
+    return records;
+}
+/**************************************************************************************************/
+vector<string> TestBlockReader::readFasta(BlockReader& in) {
+    vector<string> records;
+    while (!in.eof()) {
+        Sequence seq(in);
+        if (seq.getName() != "") { records.push_back(seq.getName() + "|" + seq.getComment() + "|" + seq.getAligned()); }
+    }
+    return records;
+}
+/**************************************************************************************************/
+vector<string> TestBlockReader::readQual(string filename) {
+    vector<string> records;
+    ifstream in; m->openInputFile(filename, in);
+    while (!in.eof()) {
+        QualityScores qual(in); m->gobble(in);
+        if (qual.getName() != "") { ostringstream out; qual.printQScores(out); records.push_back(out.str()); }
+    }
+    in.close();
+    return records;
+}
+/**************************************************************************************************/
+vector<string> TestBlockReader::readQual(BlockReader& in) {
+    vector<string> records;
+    while (!in.eof()) {
+        QualityScores qual(in);
+        if (qual.getName() != "") { ostringstream out; qual.printQScores(out); records.push_back(out.str()); }
+    }
+    return records;
+}
+/**************************************************************************************************/
+vector<string> TestBlockReader::readFastq(string filename) {
+    vector<string> records;
+    ifstream in; m->openInputFile(filename, in);
+    while (!in.eof()) {
+        bool ignore;
+        FastqRead read(in, ignore, "illumina1.8+"); m->gobble(in);
+        if (!ignore) { ostringstream out; read.printFastq(out); records.push_back(out.str()); }
+    }
+    in.close();
+    return records;
+}
+/**************************************************************************************************/
+vector<string> TestBlockReader::readFastq(BlockReader& in) {
+    vector<string> records;
+    while (!in.eof()) {
+        bool ignore;
+        FastqRead read(in, ignore, "illumina1.8+");
+        if (!ignore) { ostringstream out; read.printFastq(out); records.push_back(out.str()); }
+    }
+    return records;
+}
+/**************************************************************************************************/
+TEST_CASE("Testing BlockReader Class") {
+    TestBlockReader testReader;
+
+    SECTION("Records Across The Block Edge") {
+        INFO("Using fasta, qual and fastq files longer than one block, compared with the ifstream constructors") // Only appears on a FAIL
+
+        CHECK(testReader.spansEdge(testReader.fastaText));
+        CHECK(testReader.spansEdge(testReader.qualText));
+        CHECK(testReader.spansEdge(testReader.fastqText));
+
+        string fastaFile = testReader.writeFile("blockreadertest.fasta", testReader.fastaText);
+        vector<string> expected = testReader.readFasta(fastaFile);
+        BlockReader fastaReader(fastaFile, 1);
+        vector<string> found = testReader.readFasta(fastaReader);
+        CHECK(!fastaReader.isCompressed());
+        CHECK(expected.size() == testReader.numReads);
+        CHECK(found == expected);
+
+        string qualFile = testReader.writeFile("blockreadertest.qual", testReader.qualText);
+        expected = testReader.readQual(qualFile);
+        BlockReader qualReader(qualFile, 1);
+        found = testReader.readQual(qualReader);
+        CHECK(expected.size() == testReader.numReads);
+        CHECK(found == expected);
+
+        string fastqFile = testReader.writeFile("blockreadertest.fastq", testReader.fastqText);
+        expected = testReader.readFastq(fastqFile);
+        BlockReader fastqReader(fastqFile, 1);
+        found = testReader.readFastq(fastqReader);
+        CHECK(expected.size() == testReader.numReads);
+        CHECK(found == expected);
+        CHECK(!testReader.m->control_pressed);
+    }
+
+    SECTION("Windows Line Ends") {
+        INFO("Using \\r\\n line ends, which give the same records as \\n") // Only appears on a FAIL
+
+        vector<string> expected = testReader.readFasta(testReader.writeFile("blockreadertest.fasta", testReader.fastaText));
+        BlockReader fastaReader(testReader.writeFile("blockreadertest.windows.fasta", testReader.toWindows(testReader.fastaText)), 1);
+        CHECK(testReader.readFasta(fastaReader) == expected);
+
+        expected = testReader.readQual(testReader.writeFile("blockreadertest.qual", testReader.qualText));
+        BlockReader qualReader(testReader.writeFile("blockreadertest.windows.qual", testReader.toWindows(testReader.qualText)), 1);
+        CHECK(testReader.readQual(qualReader) == expected);
+
+        expected = testReader.readFastq(testReader.writeFile("blockreadertest.fastq", testReader.fastqText));
+        BlockReader fastqReader(testReader.writeFile("blockreadertest.windows.fastq", testReader.toWindows(testReader.fastqText)), 1);
+        CHECK(testReader.readFastq(fastqReader) == expected);
+
+        BlockReader lineReader("blockreadertest.windows.fastq", 1);
+        textView line;
+        CHECK(lineReader.getLine(line));
+        CHECK(line.getString() == "@read0 1:N:0:0");
+        CHECK(lineReader.getLine(line));
+        CHECK(line.getString() == testReader.fastqText.substr(15, line.length));
+    }
+
+    SECTION("Last Record Without A Line End") {
+        INFO("Using files whose last line has no \\n") // Only appears on a FAIL
+
+        string fasta = ">seq1 first\nACGT\nACGT\n>seq2\nTTGCA";
+        BlockReader fastaReader(testReader.writeFile("blockreadertest.short.fasta", fasta), 1);
+        vector<string> found = testReader.readFasta(fastaReader);
+        CHECK(found.size() == 2);
+        CHECK(found == testReader.readFasta("blockreadertest.short.fasta"));
+        CHECK(found[1] == "seq2||TTGCA");
+
+        string qual = ">seq1\n40 40 30\n>seq2\n20 10";
+        BlockReader qualReader(testReader.writeFile("blockreadertest.short.qual", qual), 1);
+        found = testReader.readQual(qualReader);
+        CHECK(found.size() == 2);
+        CHECK(found == testReader.readQual("blockreadertest.short.qual"));
+
+        string fastq = "@seq1\nACGT\n+\nIIII\n@seq2\nTTGCA\n+\nIIIHH";
+        BlockReader fastqReader(testReader.writeFile("blockreadertest.short.fastq", fastq), 1);
+        found = testReader.readFastq(fastqReader);
+        CHECK(found.size() == 2);
+        CHECK(found == testReader.readFastq("blockreadertest.short.fastq"));
+
+        BlockReader lineReader("blockreadertest.short.fastq", 1);
+        textView line; string lastLine = "";
+        while (lineReader.getLine(line)) { lastLine = line.getString(); }
+        CHECK(lastLine == "IIIHH");
+        CHECK(lineReader.eof());
+    }
+
+    #ifdef USE_BOOST
+    SECTION("Gzip Files") {
+        INFO("Using a gzip file, a gzip file with two members and a bgzf file of many members and the empty last member") // Only appears on a FAIL
+
+        string plainFile = testReader.writeFile("blockreadertest.fastq", testReader.fastqText);
+        vector<string> expected = testReader.readFastq(plainFile);
+
+        BlockReader gzReader(testReader.writeGzip("blockreadertest.fastq.gz", testReader.fastqText, 0), 1);
+        CHECK(gzReader.isCompressed());
+        CHECK(testReader.readFastq(gzReader) == expected);
+
+        //gzip -c a >> b makes a file of several members
+        int half = testReader.fastqText.find("\n@read5000 ") + 1;
+        string first = testReader.data.readFile(testReader.writeGzip("blockreadertest.first.gz", testReader.fastqText.substr(0, half), 0));
+        string second = testReader.data.readFile(testReader.writeGzip("blockreadertest.second.gz", testReader.fastqText.substr(half), 0));
+        BlockReader membersReader(testReader.writeFile("blockreadertest.members.fastq.gz", first + second), 1);
+        CHECK(testReader.readFastq(membersReader) == expected);
+
+        //with 2 threads a batch is 64 members, so this makes several batches
+        BlockReader bgzfReader(testReader.writeGzip("blockreadertest.fastq.bgz", testReader.fastqText, 10000), 2);
+        CHECK(bgzfReader.isCompressed());
+        CHECK(testReader.readFastq(bgzfReader) == expected);
+
+        BlockReader fastaReader(testReader.writeGzip("blockreadertest.fasta.bgz", testReader.fastaText, 65000), 3);
+        CHECK(testReader.readFasta(fastaReader) == testReader.readFasta(testReader.writeFile("blockreadertest.fasta", testReader.fastaText)));
+        CHECK(!testReader.m->control_pressed);
+    }
+
+    SECTION("Truncated And Damaged Files") {
+        INFO("Using gzip and bgzf files that are cut short or have a changed byte, which stop the reader") // Only appears on a FAIL
+
+        string gzFile = testReader.writeGzip("blockreadertest.fastq.gz", testReader.fastqText, 0);
+        string bgzfFile = testReader.writeGzip("blockreadertest.fastq.bgz", testReader.fastqText, 10000);
+        int gzLength = testReader.data.readFile(gzFile).length();
+        int bgzfLength = testReader.data.readFile(bgzfFile).length();
+
+        vector<string> files;
+        files.push_back(testReader.truncate(gzFile, gzLength / 2));
+        files.push_back(testReader.damage(gzFile, gzLength / 2));
+        files.push_back(testReader.truncate(bgzfFile, (bgzfLength / 2) + 1000));
+        files.push_back(testReader.damage(bgzfFile, bgzfLength / 2));
+
+        for (int i = 0; i < files.size(); i++) {
+            BlockReader reader(files[i], 2);
+            vector<string> found = testReader.readFastq(reader);
+            bool stopped = testReader.m->control_pressed;
+            testReader.m->control_pressed = false;
+
+            CAPTURE(files[i]);
+            CHECK(stopped);
+            CHECK(found.size() < testReader.numReads);
+        }
+    }
+    #endif
+}
+/**************************************************************************************************/
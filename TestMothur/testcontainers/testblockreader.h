@@ -0,0 +1,50 @@
+//
+//  testblockreader.h
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testblockreader__
+#define __Mothur__testblockreader__
+
+#include "blockreader.h"
+#include "sequence.hpp"
+#include "qualityscores.h"
+#include "fastqread.h"
+#include "dataset.h"
+
+class TestBlockReader {
+
+public:
+
+    TestBlockReader();
+    ~TestBlockReader();
+
+    MothurOut* m;
+    TestDataSet data;
+    string fastaText, qualText, fastqText; //each is longer than the 4MB blocks the reader fills
+    int numReads;
+
+    string writeFile(string, string); //filename, text. Returns the filename.
+    string toWindows(string); //changes the line ends to \r\n
+    bool spansEdge(string); //a line is split by the edge of the first block
+    #ifdef USE_BOOST
+    string writeGzip(string, string, int); //filename, text, bgzf member size or 0 for plain gzip
+    string damage(string, int); //copy of the file with a byte changed at the given distance into it
+    string truncate(string, int); //copy of the file with the given number of bytes
+    #endif
+
+    //each record as text, so the BlockReader and ifstream constructors can be compared
+    vector<string> readFasta(string);
+    vector<string> readFasta(BlockReader&);
+    vector<string> readQual(string);
+    vector<string> readQual(BlockReader&);
+    vector<string> readFastq(string);
+    vector<string> readFastq(BlockReader&);
+
+private:
+    vector<string> filenames;
+};
+
+#endif /* defined(__Mothur__testblockreader__) */
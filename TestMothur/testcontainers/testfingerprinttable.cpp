@@ -0,0 +1,102 @@
+//
+//  testfingerprinttable.cpp
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#include "catch.hpp"
+#include "testfingerprinttable.h"
+
+/**************************************************************************************************/
+TestFingerprintTable::TestFingerprintTable() {  //setup
+    m = MothurOut::getInstance();
+    data.seedRandom();
+    
+    vector<string> distinct;
+    for (int i = 0; i < 60; i++) { distinct.push_back(data.getRandomSeq(80, "ACGT-")); }
+    
+    //the same bases aligned differently are different sequences
+    string moved = distinct[0];
+    int gap = moved.find('-');
+    if (gap != string::npos) { moved.erase(gap, 1); moved += "-"; if (moved != distinct[0]) { distinct.push_back(moved); } }
+    
+    //duplicates are spread through the file so they land in different batches
+    for (int i = 0; i < 500; i++) { reads.push_back(distinct[(i < distinct.size()) ? i : (rand() % distinct.size())]); }
+    random_shuffle(reads.begin(), reads.end());
+    
+    map<string, int> firstRead;
+    for (int i = 0; i < reads.size(); i++) {
+        map<string, int>::iterator it = firstRead.find(reads[i]);
+        if (it == firstRead.end()) { int id = firstRead.size(); firstRead[reads[i]] = id; expectedIds.push_back(id); }
+        else { expectedIds.push_back(it->second); }
+    }
+    numExpected = firstRead.size();
+}
+/**************************************************************************************************/
+vector<int> TestFingerprintTable::findIds(int numThreads, int batchSize, bool collide) {
+    FingerprintTable table(numThreads);
+    vector<int> ids;
+    
+    for (int start = 0; start < reads.size(); start += batchSize) {
+        vector<string> batch(reads.begin() + start, reads.begin() + min((int)reads.size(), start + batchSize));
+        vector<int> batchIds;
+        
+        if (collide) {
+            vector<seqFingerprint> fingerprints(batch.size());
+            for (int i = 0; i < batch.size(); i++) { fingerprints[i].first = 7; fingerprints[i].second = 11; }
+            table.addFingerprinted(batch, fingerprints, batchIds);
+        }else { table.add(batch, batchIds); }
+        
+        ids.insert(ids.end(), batchIds.begin(), batchIds.end());
+    }
+    
+    if (table.getNumUniques() != numExpected) { ids.clear(); }
+    return ids;
+}
+/**************************************************************************************************/
+int TestFingerprintTable::countPartitions(int numThreads) {
+    set<unsigned long long> partitions;
+    for (int i = 0; i < reads.size(); i++) { partitions.insert(FingerprintTable::getFingerprint(reads[i]).first % numThreads); }
+    return partitions.size();
+}
+/**************************************************************************************************/
+TEST_CASE("Testing FingerprintTable Class") {
+    TestFingerprintTable testTable;
+    
+    SECTION("Same Ids As A Map") {
+        INFO("Using 1 to 4 threads and batches of 1, 37 and all reads") // Only appears on a FAIL
+        
+        int batchSizes[] = { 1, 37, 500 };
+        for (int threads = 1; threads <= 4; threads++) {
+            for (int b = 0; b < 3; b++) {
+                int batchSize = batchSizes[b];
+                bool sameIds = (testTable.findIds(threads, batchSize, false) == testTable.expectedIds);
+                CAPTURE(threads);
+                CAPTURE(batchSize);
+                CHECK(sameIds);
+            }
+        }
+    }
+    
+    SECTION("Uniques In Every Partition") {
+        INFO("The reads must be spread over the partitions for the threads to be tested") // Only appears on a FAIL
+        
+        int numPartitions = testTable.countPartitions(4);
+        
+        CAPTURE(numPartitions);
+        
+        CHECK(numPartitions == 4);
+    }
+    
+    SECTION("Fingerprint Collisions") {
+        INFO("Every read has the same fingerprint, so different sequences are told apart by comparing them") // Only appears on a FAIL
+        
+        for (int threads = 1; threads <= 3; threads++) {
+            bool sameIds = (testTable.findIds(threads, 37, true) == testTable.expectedIds);
+            CAPTURE(threads);
+            CHECK(sameIds);
+        }
+    }
+}
+/**************************************************************************************************/
@@ -0,0 +1,34 @@
+//
+//  testfingerprinttable.h
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testfingerprinttable__
+#define __Mothur__testfingerprinttable__
+
+#include "fingerprinttable.h"
+#include "dataset.h"
+
+class TestFingerprintTable {
+    
+public:
+    
+    TestFingerprintTable();
+    ~TestFingerprintTable() {}
+    
+    MothurOut* m;
+    vector<string> reads;
+    vector<int> expectedIds; //unique ids found by a map keyed by the sequence, numbered by first read
+    int numExpected;
+    
+    //adds the reads in batches of batchSize, true to give every read the same fingerprint
+    vector<int> findIds(int numThreads, int batchSize, bool collide);
+    int countPartitions(int numThreads); //partitions holding at least one unique
+    
+private:
+    TestDataSet data;
+};
+
+#endif /* defined(__Mothur__testfingerprinttable__) */
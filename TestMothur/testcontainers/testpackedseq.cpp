@@ -0,0 +1,155 @@
+//
+//  testpackedseq.cpp
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#include "catch.hpp"
+#include "testpackedseq.h"
+
+/**************************************************************************************************/
+TestPackedSeq::TestPackedSeq() {  //setup
+    m = MothurOut::getInstance();
+    data.seedRandom();
+    
+    //lengths below, at and across the 64 column words
+    int lengths[] = { 50, 64, 130, 200 };
+    for (int l = 0; l < 4; l++) {
+        for (int i = 0; i < 25; i++) {
+            string aligned = randomSeq(lengths[l]);
+            seqs.push_back(Sequence("seq" + toString(l) + "_" + toString(i), aligned));
+            
+            //a close copy, so some distances are below the cutoff
+            for (int j = 0; j < 3; j++) { int pos = rand() % aligned.length(); if (aligned[pos] != '.') { aligned[pos] = "AC-G"[rand() % 4]; } }
+            seqs.push_back(Sequence("close" + toString(l) + "_" + toString(i), aligned));
+        }
+        
+        //all dots, and no dots at the ends
+        seqs.push_back(Sequence("dots" + toString(l), string(lengths[l], '.')));
+        seqs.push_back(Sequence("full" + toString(l), string(lengths[l], 'A')));
+    }
+}
+/**************************************************************************************************/
+//end dots, runs of gaps, ambiguous bases and the odd '.' inside the sequence
+string TestPackedSeq::randomSeq(int length) {
+    string bases = "ACGTACGTACGTACGTNRY";
+    string seq = "";
+    int leading = rand() % 20;
+    int trailing = rand() % 20;
+    
+    for (int i = 0; i < length; i++) {
+        if ((i < leading) || (i >= (length - trailing))) { seq += '.'; continue; }
+        
+        int r = rand() % 100;
+        if (r < 10) { int run = 1 + rand() % 5; for (int j = 0; (j < run) && (i < length - trailing); j++, i++) { seq += '-'; } i--; }
+        else if (r < 12) { seq += '.'; }
+        else { seq += bases[rand() % bases.length()]; }
+    }
+    return seq;
+}
+/**************************************************************************************************/
+//the packed distance must match the string distance when it is at or below the cutoff, and be above the cutoff otherwise
+int TestPackedSeq::countDifferences(Dist* calc, double cutoff) {
+    int numDifferent = 0;
+    numBelow = 0;
+    for (int i = 0; i < seqs.size(); i++) {
+        PackedSeq A(seqs[i]);
+        for (int j = 0; j < i; j++) {
+            if (seqs[i].getAligned().length() != seqs[j].getAligned().length()) { continue; }
+            PackedSeq B(seqs[j]);
+            
+            calc->calcDist(seqs[i], seqs[j]);
+            double stringDist = calc->getDist();
+            
+            bool above = calc->aboveCutoff(A, B, cutoff);
+            calc->calcDist(A, B, cutoff);
+            double packedDist = calc->getDist();
+            
+            if (stringDist <= cutoff) {
+                numBelow++;
+                if (above || (packedDist != stringDist)) { numDifferent++; }
+            }else if (packedDist <= cutoff) { numDifferent++; }
+        }
+    }
+    return numDifferent;
+}
+/**************************************************************************************************/
+TEST_CASE("Testing PackedSeq Class") {
+    TestPackedSeq testPacked;
+    
+    SECTION("Testing Pack and Unpack") {
+        INFO("Using random aligned sequences with gaps, dots and ambiguous bases") // Only appears on a FAIL
+        
+        for (int i = 0; i < testPacked.seqs.size(); i++) {
+            PackedSeq packed(testPacked.seqs[i]);
+            
+            CAPTURE(testPacked.seqs[i].getAligned()); // Displays this variable on a FAIL
+            
+            CHECK(packed.isPacked());
+            CHECK(packed.getAligned() == testPacked.seqs[i].getAligned());
+        }
+        
+        PackedSeq unpackable("lower", "..acgt-ACGT..");
+        CHECK(!unpackable.isPacked());
+        CHECK(unpackable.getAligned() == "..acgt-ACGT..");
+    }
+    
+    SECTION("Testing eachGapDist") {
+        INFO("Comparing the 64 column kernel to the per column calculator") // Only appears on a FAIL
+        eachGapDist calc;
+        
+        CHECK(testPacked.countDifferences(&calc, 1.0) == 0);
+        CHECK(testPacked.countDifferences(&calc, 0.1) == 0);
+        CHECK(testPacked.numBelow != 0);
+    }
+    
+    SECTION("Testing eachGapIgnoreTermGapDist") {
+        INFO("Comparing the 64 column kernel to the per column calculator") // Only appears on a FAIL
+        eachGapIgnoreTermGapDist calc;
+        
+        CHECK(testPacked.countDifferences(&calc, 1.0) == 0);
+        CHECK(testPacked.countDifferences(&calc, 0.1) == 0);
+        CHECK(testPacked.numBelow != 0);
+    }
+    
+    SECTION("Testing ignoreGaps") {
+        INFO("Comparing the 64 column kernel to the per column calculator") // Only appears on a FAIL
+        ignoreGaps calc;
+        
+        CHECK(testPacked.countDifferences(&calc, 1.0) == 0);
+        CHECK(testPacked.countDifferences(&calc, 0.1) == 0);
+        CHECK(testPacked.numBelow != 0);
+    }
+    
+    SECTION("Testing oneGapDist") {
+        INFO("Comparing the 64 column kernel to the per column calculator") // Only appears on a FAIL
+        oneGapDist calc;
+        
+        CHECK(testPacked.countDifferences(&calc, 1.0) == 0);
+        CHECK(testPacked.countDifferences(&calc, 0.1) == 0);
+        CHECK(testPacked.numBelow != 0);
+    }
+    
+    SECTION("Testing oneGapIgnoreTermGapDist") {
+        INFO("Comparing the 64 column kernel to the per column calculator") // Only appears on a FAIL
+        oneGapIgnoreTermGapDist calc;
+        
+        CHECK(testPacked.countDifferences(&calc, 1.0) == 0);
+        CHECK(testPacked.countDifferences(&calc, 0.1) == 0);
+        CHECK(testPacked.numBelow != 0);
+    }
+    
+    SECTION("Testing unpacked fallback") {
+        INFO("Using ..acgt-ACGT.. and ..ACGT-ACGT..") // Only appears on a FAIL
+        eachGapDist calc;
+        Sequence lower("lower", "..acgt-ACGT.."); Sequence upper("upper", "..ACGT-ACGT..");
+        
+        calc.calcDist(lower, upper);
+        double stringDist = calc.getDist();
+        calc.calcDist(PackedSeq(lower), PackedSeq(upper), 1.0);
+        
+        CHECK(calc.getDist() == stringDist);
+    }
+}
+/**************************************************************************************************/
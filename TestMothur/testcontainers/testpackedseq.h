@@ -0,0 +1,39 @@
+//
+//  testpackedseq.h
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testpackedseq__
+#define __Mothur__testpackedseq__
+
+#include "packedseq.h"
+#include "eachgapdist.h"
+#include "eachgapignore.h"
+#include "ignoregaps.h"
+#include "onegapdist.h"
+#include "onegapignore.h"
+#include "dataset.h"
+
+class TestPackedSeq {
+    
+public:
+    
+    TestPackedSeq();
+    ~TestPackedSeq() {}
+    
+    MothurOut* m;
+    vector<Sequence> seqs;
+    int numBelow; //pairs at or below the cutoff in the last countDifferences
+    
+    //number of pairs where the packed distance differs from the string distance
+    int countDifferences(Dist*, double);
+    
+private:
+    TestDataSet data;
+    
+    string randomSeq(int);
+};
+
+#endif /* defined(__Mothur__testpackedseq__) */
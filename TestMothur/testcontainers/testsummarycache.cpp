@@ -0,0 +1,302 @@
+//
+//  testsummarycache.cpp
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#include "catch.hpp"
+#include "testsummarycache.h"
+#include "seqsummarycommand.h"
+#include "screenseqscommand.h"
+#include "getseqscommand.h"
+#include "removeseqscommand.h"
+#include <utime.h>
+#include <fcntl.h>
+
+/**************************************************************************************************/
+TestSummaryCache::TestSummaryCache() {  //setup
+    m = MothurOut::getInstance();
+    fastaFile = "summarycachetest.fasta"; accnosFile = "summarycachetest.accnos";
+    
+    writeFasta(0, 3000, "seq");
+    
+    //runs of close reads are read through, the far ones are seeked to
+    ofstream out; m->openOutputFile(accnosFile, out);
+    for (int i = 0; i < 500; i += 7) { out << "seq" << setw(5) << setfill('0') << i << endl; }
+    out << "seq01200" << endl << "seq02999" << endl << "seq03003" << endl;
+    out.close();
+}
+/**************************************************************************************************/
+TestSummaryCache::~TestSummaryCache() {
+    removeCache(); m->mothurRemove(fastaFile); m->mothurRemove(accnosFile); //teardown
+    for (int i = 0; i < outputFiles.size(); i++) { m->mothurRemove(outputFiles[i]); }
+}
+/**************************************************************************************************/
+//reads of 200 to 400 bases, some with comments and N's
+void TestSummaryCache::writeFasta(int first, int last, string tag) {
+    data.seedRandom(first);
+    ofstream out;
+    if (first == 0) { m->openOutputFile(fastaFile, out); }
+    else { m->openOutputFileAppend(fastaFile, out); }
+    
+    for (int i = first; i < last; i++) {
+        out << ">" << tag << setw(5) << setfill('0') << i;
+        if ((i % 5) == 0) { out << "\tcomment " << i; }
+        out << endl;
+        
+        int length = 200 + rand() % 200;
+        for (int j = 0; j < length; j++) { out << (((rand() % 100) == 0) ? 'N' : "ACGT"[rand() % 4]); }
+        out << endl;
+    }
+    out.close();
+}
+/**************************************************************************************************/
+void TestSummaryCache::createCache() { summarySeqs(1); }
+/**************************************************************************************************/
+string TestSummaryCache::summarySeqs(int processors) {
+    SeqSummaryCommand summary("fasta=" + fastaFile + ", processors=" + toString(processors));
+    summary.execute();
+    
+    string outputFile = summary.getOutputFiles()["summary"][0];
+    outputFiles.push_back(outputFile);
+    return data.readFile(outputFile);
+}
+/**************************************************************************************************/
+string TestSummaryCache::screenSeqs(int processors) {
+    ScreenSeqsCommand screen("fasta=" + fastaFile + ", optimize=minlength-maxlength-maxn, criteria=90, processors=" + toString(processors));
+    screen.execute();
+    
+    map<string, vector<string> > outputs = screen.getOutputFiles();
+    outputFiles.push_back(outputs["fasta"][0]); outputFiles.push_back(outputs["accnos"][0]);
+    return data.readFile(outputs["fasta"][0]) + data.readFile(outputs["accnos"][0]);
+}
+/**************************************************************************************************/
+//overwrites the name offset of the second sequence in the first block, so the name runs past the end of the block
+void TestSummaryCache::damageNameOffset() {
+    string cacheName = SummaryCache::getCacheName(fastaFile);
+    string contents = data.readFile(cacheName);
+    
+    unsigned long long pathLength, numSeqs;
+    memcpy(&pathLength, &contents[56], 8);
+    unsigned long long blockStart = 64 + (pathLength + 7) / 8 * 8;
+    memcpy(&numSeqs, &contents[blockStart], 8);
+    
+    unsigned int offset = 4000000000u;
+    memcpy(&contents[blockStart + 16 + 32 * numSeqs + 4], &offset, 4);
+    
+    ofstream out(cacheName.c_str(), ios::binary);
+    out << contents;
+    out.close();
+}
+/**************************************************************************************************/
+bool TestSummaryCache::cacheMatches() {
+    SummaryCache cache(fastaFile);
+    return cache.read();
+}
+/**************************************************************************************************/
+void TestSummaryCache::removeCache() { m->mothurRemove(SummaryCache::getCacheName(fastaFile)); }
+/**************************************************************************************************/
+void TestSummaryCache::touchFasta() {
+    struct stat fileInfo; stat(fastaFile.c_str(), &fileInfo);
+    struct utimbuf times;
+    times.actime = fileInfo.st_atime; times.modtime = fileInfo.st_mtime + 10;
+    utime(fastaFile.c_str(), &times);
+}
+/**************************************************************************************************/
+//the names trade places, but the size and modification time of the fasta file stay the same so the cache still matches it
+void TestSummaryCache::swapNames(string first, string second) {
+    struct stat fileInfo; stat(fastaFile.c_str(), &fileInfo);
+    
+    string contents = data.readFile(fastaFile);
+    int firstPos = contents.find(">" + first); int secondPos = contents.find(">" + second);
+    contents.replace(firstPos + 1, first.length(), second); contents.replace(secondPos + 1, second.length(), first);
+    
+    ofstream out(fastaFile.c_str(), ios::binary);
+    out << contents;
+    out.close();
+    
+    struct timespec times[2];
+    times[0] = fileInfo.st_atim; times[1] = fileInfo.st_mtim;
+    utimensat(AT_FDCWD, fastaFile.c_str(), times, 0);
+}
+/**************************************************************************************************/
+string TestSummaryCache::getSeqs() {
+    GetSeqsCommand getSeqs("fasta=" + fastaFile + ", accnos=" + accnosFile);
+    getSeqs.execute();
+    
+    string outputFile = getSeqs.getOutputFiles()["fasta"][0];
+    outputFiles.push_back(outputFile);
+    return data.readFile(outputFile);
+}
+/**************************************************************************************************/
+string TestSummaryCache::removeSeqs() {
+    RemoveSeqsCommand removeSeqs("fasta=" + fastaFile + ", accnos=" + accnosFile);
+    removeSeqs.execute();
+    
+    string outputFile = removeSeqs.getOutputFiles()["fasta"][0];
+    outputFiles.push_back(outputFile);
+    return data.readFile(outputFile);
+}
+/**************************************************************************************************/
+TEST_CASE("Testing SummaryCache Class") {
+    TestSummaryCache testCache;
+    
+    SECTION("Get.seqs And Remove.seqs") {
+        INFO("The output with a cache written by summary.seqs must be the same as without one") // Only appears on a FAIL
+        
+        testCache.removeCache();
+        string expectedGet = testCache.getSeqs();
+        string expectedRemove = testCache.removeSeqs();
+        
+        testCache.createCache();
+        bool cached = testCache.cacheMatches();
+        
+        CHECK(cached);
+        CHECK(testCache.getSeqs() == expectedGet);
+        CHECK(testCache.removeSeqs() == expectedRemove);
+        CHECK(expectedGet.find(">seq02999") != string::npos);
+    }
+    
+    SECTION("Touched Fasta") {
+        INFO("A cache is not used once the modification time of the fasta file changes") // Only appears on a FAIL
+        
+        testCache.createCache();
+        testCache.touchFasta();
+        bool cached = testCache.cacheMatches();
+        
+        CHECK(!cached);
+        
+        //the same size, but a selected read is renamed
+        testCache.createCache();
+        testCache.writeFasta(0, 3000, "new");
+        string getWithOldCache = testCache.getSeqs();
+        string removeWithOldCache = testCache.removeSeqs();
+        
+        testCache.removeCache();
+        
+        CHECK(getWithOldCache == testCache.getSeqs());
+        CHECK(removeWithOldCache == testCache.removeSeqs());
+        CHECK(getWithOldCache.find(">seq") == string::npos);
+    }
+    
+    SECTION("Resized Fasta") {
+        INFO("A cache is not used once reads are added to the fasta file") // Only appears on a FAIL
+        
+        testCache.createCache();
+        testCache.writeFasta(3000, 3010, "seq");
+        bool cached = testCache.cacheMatches();
+        
+        CHECK(!cached);
+        
+        string getWithOldCache = testCache.getSeqs();
+        string removeWithOldCache = testCache.removeSeqs();
+        
+        testCache.removeCache();
+        
+        CHECK(getWithOldCache == testCache.getSeqs());
+        CHECK(removeWithOldCache == testCache.removeSeqs());
+        CHECK(getWithOldCache.find(">seq03003") != string::npos);
+    }
+    
+    SECTION("Summary.seqs And Screen.seqs") {
+        INFO("Summary.seqs and screen.seqs must write the same files from a cache as from the fasta file") // Only appears on a FAIL
+        
+        testCache.removeCache();
+        string expectedScreen = testCache.screenSeqs(1);
+        
+        //screen.seqs leaves a cache behind too
+        bool cached = testCache.cacheMatches();
+        CHECK(cached);
+        
+        testCache.removeCache();
+        string expectedSummary = testCache.summarySeqs(1);
+        
+        CHECK(testCache.summarySeqs(1) == expectedSummary);
+        CHECK(testCache.screenSeqs(1) == expectedScreen);
+        CHECK(expectedScreen.find(">seq") != string::npos);
+    }
+    
+    SECTION("Several Processors") {
+        INFO("The parts written by each process are appended in order") // Only appears on a FAIL
+        
+        testCache.removeCache();
+        string expectedSummary = testCache.summarySeqs(1);
+        testCache.removeCache();
+        string expectedScreen = testCache.screenSeqs(1);
+        testCache.removeCache();
+        string expectedGet = testCache.getSeqs();
+        
+        string summaryWritingCache = testCache.summarySeqs(3);
+        bool cached = testCache.cacheMatches();
+        
+        CHECK(cached);
+        CHECK(summaryWritingCache == expectedSummary);
+        CHECK(testCache.summarySeqs(2) == expectedSummary);
+        CHECK(testCache.getSeqs() == expectedGet);
+        
+        testCache.removeCache();
+        testCache.screenSeqs(3);
+        cached = testCache.cacheMatches();
+        
+        CHECK(cached);
+        CHECK(testCache.screenSeqs(2) == expectedScreen);
+        CHECK(testCache.summarySeqs(1) == expectedSummary);
+    }
+    
+    SECTION("Unfinished Part") {
+        INFO("Appending a part that was never closed abandons the cache") // Only appears on a FAIL
+        
+        testCache.removeCache();
+        string partName = testCache.fastaFile + ".part.stats.temp";
+        
+        SummaryCache part(testCache.fastaFile);
+        part.createPart(partName);
+        part.add("seq00001", 1, 200, 200, 0, 3, 0, 250);
+        
+        SummaryCache cache(testCache.fastaFile);
+        cache.create();
+        cache.add("seq00000", 1, 220, 220, 0, 4, 0, 0);
+        cache.appendPart(partName);
+        cache.close();
+        part.remove();
+        
+        bool cached = testCache.cacheMatches();
+        
+        CHECK(!cached);
+        CHECK(!testCache.m->fileExists(partName));
+    }
+    
+    SECTION("Damaged Name Offsets") {
+        INFO("A cache with a name outside the name data is not used") // Only appears on a FAIL
+        
+        testCache.removeCache();
+        string expectedGet = testCache.getSeqs();
+        
+        testCache.createCache();
+        testCache.damageNameOffset();
+        bool cached = testCache.cacheMatches();
+        
+        CHECK(!cached);
+        CHECK(testCache.getSeqs() == expectedGet);
+    }
+    
+    SECTION("Renamed Reads") {
+        INFO("When the name read at a cached position is not the cached name, the whole fasta file is read") // Only appears on a FAIL
+        
+        testCache.createCache();
+        testCache.swapNames("seq00000", "seq00001");
+        bool cached = testCache.cacheMatches();
+        
+        CHECK(cached);
+        
+        string getWithOldCache = testCache.getSeqs();
+        string removeWithOldCache = testCache.removeSeqs();
+        
+        testCache.removeCache();
+        
+        CHECK(getWithOldCache == testCache.getSeqs());
+        CHECK(removeWithOldCache == testCache.removeSeqs());
+    }
+}
+/**************************************************************************************************/
@@ -0,0 +1,43 @@
+//
+//  testsummarycache.h
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testsummarycache__
+#define __Mothur__testsummarycache__
+
+#include "summarycache.h"
+#include "dataset.h"
+
+class TestSummaryCache {
+    
+public:
+    
+    TestSummaryCache();
+    ~TestSummaryCache();
+    
+    MothurOut* m;
+    string fastaFile, accnosFile;
+    
+    void writeFasta(int, int, string); //first and last read, tag of the names, appends if first is not 0
+    void createCache(); //runs summary.seqs
+    void damageNameOffset(); //points a name of the first block past the name data
+    bool cacheMatches(); //true if the cache would be used for the fasta file
+    void removeCache();
+    void touchFasta(); //moves the modification time of the fasta file forward without changing it
+    void swapNames(string, string); //renames two reads without changing the size or modification time of the fasta file
+    
+    //the fasta files written by get.seqs and remove.seqs
+    string getSeqs();
+    string removeSeqs();
+    string summarySeqs(int); //the summary file written with this many processors
+    string screenSeqs(int); //the good fasta and bad accnos files written with this many processors
+    
+private:
+    vector<string> outputFiles;
+    TestDataSet data;
+};
+
+#endif /* defined(__Mothur__testsummarycache__) */
@@ -6,7 +6,7 @@
 //  Copyright © 2016 Schloss Lab. All rights reserved.
 //
 
-
+#include "catch.hpp"
 #include "testtrimoligos.hpp"
 
 /**************************************************************************************************/
@@ -15,10 +15,25 @@ TestTrimOligos::TestTrimOligos() {  //setup
     
     //set up barcodes, primers, pairedBarcodes and pairedPrimers
     
-    //Set up vector of seqs with barcodes and primers
+    //far apart, a read one substitution from one of them can only be that one
+    barcodes["AAAAAAAA"] = 0;
+    barcodes["CCCCCCCC"] = 1;
+    barcodes["GGGGGGGG"] = 2;
+    
+    //the second is the first shifted by one base, a read can be one substitution from the first and one insertion from the second
+    primers["ACGTACGTAA"] = 0;
+    primers["CGTACGTACT"] = 1;
+    primers["TTTTTTTTTT"] = 2;
     
-    //Set up vector of seqs with pairedbarcodes and pairedprimers
+    oligosPair first("AAAAAAAA", "CCCCCCCC");
+    oligosPair second("GGGGGGGG", "TTTTTTTT");
+    pairedBarcodes[0] = first;
+    pairedBarcodes[1] = second;
     
+    oligosPair shifted("ACGTACGTAA", "GGGGGGGGGG");
+    oligosPair shiftedBy1("CGTACGTACT", "GGGGGGGGGG");
+    pairedPrimers[0] = shifted;
+    pairedPrimers[1] = shiftedBy1;
 }
 /**************************************************************************************************/
 TestTrimOligos::~TestTrimOligos() {
@@ -28,16 +43,133 @@ TestTrimOligos::~TestTrimOligos() {
 
 TEST_CASE("Testing TrimOligos Class") {
     TestTrimOligos testTrim;
+    vector<string> revPrimers, linkers, spacers;
+    map<string, int> noOligos;
+    string tail = "ACTGACTGACTGACTGACTG"; //a tail starting with a barcode base lets the aligner trade a substitution for an insertion
     
+    SECTION("stripBarcode") {
+        INFO("Using barcodes AAAAAAAA, CCCCCCCC, GGGGGGGG and bdiffs=2") // Only appears on a FAIL
+        TrimOligos trim(0, 2, 0, 0, noOligos, testTrim.barcodes, revPrimers, linkers, spacers);
+        int group = -1;
+        
+        //exact
+        Sequence exact("exact", "CCCCCCCC" + tail);
+        vector<int> results = trim.stripBarcode(exact, group);
+        CHECK(results[0] == 0); CHECK(results[1] == 0); CHECK(group == 1);
+        CHECK(exact.getUnaligned() == tail);
+        
+        //one mismatch
+        group = -1;
+        Sequence mismatch("mismatch", "GGGTGGGG" + tail);
+        results = trim.stripBarcode(mismatch, group);
+        CHECK(results[0] == 1); CHECK(results[1] == 0); CHECK(group == 2);
+        CHECK(mismatch.getUnaligned() == tail);
+        
+        //one insertion, the substitution table can't find it
+        group = -1;
+        Sequence insertion("insertion", "CCCCTCCCC" + tail);
+        results = trim.stripBarcode(insertion, group);
+        CHECK(results[0] == 1); CHECK(results[1] == 0); CHECK(group == 1);
+        CHECK(insertion.getUnaligned() == tail);
+        
+        //too many differences
+        group = -1;
+        Sequence noMatch("noMatch", "ACACACAC" + tail);
+        results = trim.stripBarcode(noMatch, group);
+        CHECK(results[1] == 1e6); CHECK(group == -1);
+    }
     
-    //Create trimoligos classes with various constructors
-    
-    
-    //run all public strip functions
+    SECTION("stripBarcode ambiguous") {
+        INFO("Using barcodes AAAACCCC, AAAACCGC and bdiffs=1") // Only appears on a FAIL
+        map<string, int> closeBarcodes;
+        closeBarcodes["AAAACCCC"] = 0;
+        closeBarcodes["AAAACCGC"] = 1;
+        TrimOligos trim(0, 1, 0, 0, noOligos, closeBarcodes, revPrimers, linkers, spacers);
+        int group = -1;
+        
+        //one substitution from both
+        Sequence tie("tie", "AAAACCTC" + tail);
+        vector<int> results = trim.stripBarcode(tie, group);
+        CHECK(results[0] == 1); CHECK(results[1] == 10001); CHECK(group == -1);
+        CHECK(tie.getUnaligned() == "AAAACCTC" + tail);
+        
+        //one substitution from the first, two from the second
+        group = -1;
+        Sequence closest("closest", "ATAACCCC" + tail);
+        results = trim.stripBarcode(closest, group);
+        CHECK(results[0] == 1); CHECK(results[1] == 0); CHECK(group == 0);
+    }
     
+    SECTION("stripForward") {
+        INFO("Using primers ACGTACGTAA, CGTACGTACT, TTTTTTTTTT and pdiffs=1") // Only appears on a FAIL
+        TrimOligos trim(1, 0, 0, 0, testTrim.primers, noOligos, revPrimers, linkers, spacers);
+        int group = -1;
+        
+        //exact
+        Sequence exact("exact", "CGTACGTACT" + tail);
+        vector<int> results = trim.stripForward(exact, group);
+        CHECK(results[0] == 0); CHECK(results[1] == 0); CHECK(group == 1);
+        
+        //one substitution from ACGTACGTAA and one insertion from CGTACGTACT, the search can't tell them apart
+        group = -1;
+        Sequence indelTie("indelTie", "ACGTACGTACT" + tail);
+        results = trim.stripForward(indelTie, group);
+        CHECK(results[0] == 1); CHECK(results[1] == 10001); CHECK(group == -1);
+        
+        //one mismatch
+        group = -1;
+        Sequence mismatch("mismatch", "TTTTTATTTT" + tail);
+        results = trim.stripForward(mismatch, group);
+        CHECK(results[0] == 1); CHECK(results[1] == 0); CHECK(group == 2);
+    }
     
-    //run private functions
+    SECTION("stripForward degenerate primer") {
+        INFO("Using primers CCTACGGGNGGCWGCAG, GACTACHVGGGTATCTAATCC and pdiffs=1") // Only appears on a FAIL
+        map<string, int> degenerate;
+        degenerate["CCTACGGGNGGCWGCAG"] = 0;
+        degenerate["GACTACHVGGGTATCTAATCC"] = 1;
+        TrimOligos trim(1, 0, 0, 0, degenerate, noOligos, revPrimers, linkers, spacers);
+        int group = -1;
+        
+        Sequence exact("exact", "CCTACGGGAGGCAGCAG" + tail);
+        vector<int> results = trim.stripForward(exact, group);
+        CHECK(results[0] == 0); CHECK(results[1] == 0); CHECK(group == 0);
+        CHECK(exact.getUnaligned() == tail);
+        
+        group = -1;
+        Sequence mismatch("mismatch", "GACTACACGGCTATCTAATCC" + tail); //H matches A and V matches C, the C after GG is a substitution
+        results = trim.stripForward(mismatch, group);
+        CHECK(results[0] == 1); CHECK(results[1] == 0); CHECK(group == 1);
+        CHECK(mismatch.getUnaligned() == tail);
+    }
     
+    SECTION("stripBarcode paired") {
+        INFO("Using paired barcodes AAAAAAAA CCCCCCCC, GGGGGGGG TTTTTTTT and bdiffs=1") // Only appears on a FAIL
+        map<int, oligosPair> noPairs;
+        TrimOligos trim(0, 1, 0, 0, noPairs, testTrim.pairedBarcodes, false);
+        int group = -1;
+        
+        Sequence forward("forward", "GGGGGGGG" + tail); Sequence reverse("reverse", "TTTTTTTT" + tail);
+        vector<int> results = trim.stripBarcode(forward, reverse, group);
+        CHECK(results[0] == 0); CHECK(results[1] == 0); CHECK(group == 1);
+        
+        group = -1;
+        Sequence forwardMismatch("forward", "GGGGCGGG" + tail); Sequence reverseMismatch("reverse", "TTTTTTGT" + tail);
+        results = trim.stripBarcode(forwardMismatch, reverseMismatch, group);
+        CHECK(results[0] == 1); CHECK(results[1] == 0); CHECK(results[2] == 1); CHECK(results[3] == 0); CHECK(group == 1);
+        CHECK(forwardMismatch.getUnaligned() == tail); CHECK(reverseMismatch.getUnaligned() == tail);
+    }
     
+    SECTION("stripForward paired") {
+        INFO("Using paired primers ACGTACGTAA GGGGGGGGGG, CGTACGTACT GGGGGGGGGG and pdiffs=1") // Only appears on a FAIL
+        map<int, oligosPair> noPairs;
+        TrimOligos trim(1, 0, 0, 0, testTrim.pairedPrimers, noPairs, false);
+        int group = -1;
+        
+        //the forward read is one substitution from one primer and one insertion from the other
+        Sequence forward("forward", "ACGTACGTACT" + tail); Sequence reverse("reverse", "GGGGGGGGGG" + tail);
+        vector<int> results = trim.stripForward(forward, reverse, group);
+        CHECK(results[0] == 1); CHECK(results[1] == 10001);
+    }
 }
 /**************************************************************************************************/
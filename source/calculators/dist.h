@@ -11,6 +11,7 @@
 
 #include "mothur.h"
 #include "sequence.hpp"
+#include "packedseq.h"
 
 /**************************************************************************************************/
 
@@ -21,11 +22,56 @@ public:
 	Dist(const Dist& d) : dist(d.dist) { m = MothurOut::getInstance(); }
 	virtual ~Dist() {}
 	virtual void calcDist(Sequence, Sequence) = 0;
+	
+	virtual void calcDist(const PackedSeq& A, const PackedSeq& B) { calcDist(A, B, 1.0); }
+	
+	//calculators with a bit parallel version override this, the rest use their Sequence version.
+	//the calculators stop as soon as the distance has to be above the cutoff and set it to 1.0, so the distance is only exact if it is at or below the cutoff.
+	virtual void calcDist(const PackedSeq& A, const PackedSeq& B, double cutoff) { calcDist(A.getSequence(), B.getSequence()); }
+	
+	//cheap test run before calcDist. Uses the per block base counts of the sequences to find a lower bound on the distance.
+	//returns true if the distance is certainly above the cutoff, false if it may be at or below it.
+	virtual bool aboveCutoff(const PackedSeq& A, const PackedSeq& B, double cutoff) {
+		if (!canUseBlockCounts(A, B, cutoff)) { return false; }
+		return pastCutoff(PackedSeq::minMismatches(A, B), A.getNumBases() + B.getNumBases(), cutoff);
+	}
+	
 	double getDist()	{	return dist;	}
 
 protected:
 	double dist;
 	MothurOut* m;
+	
+	//columns below bit, bit must be 0-63
+	static packedWord lowMask(int bit) { return (((packedWord)1) << bit) - 1; }
+	//columns up to and including bit, bit must be 0-63
+	static packedWord throughMask(int bit) { return (bit == 63) ? ~((packedWord)0) : lowMask(bit+1); }
+	
+	//the packed kernels need both sequences packed and the same alignment length
+	static bool canUsePacked(const PackedSeq& A, const PackedSeq& B) {
+		return (A.isPacked() && B.isPacked() && (A.getAlignLength() == B.getAlignLength()));
+	}
+	
+	//true if diff mismatches out of at most maxLength columns is already above the cutoff
+	static bool pastCutoff(int diff, int maxLength, double cutoff) {
+		return ((cutoff < 1.0) && (diff > 0) && (maxLength > 0) && (((double)diff / (double)maxLength) > cutoff));
+	}
+	
+	//the block count bounds assume every column where both sequences have a base is counted. That holds for all of the
+	//calculators as long as neither sequence has '.' between its bases.
+	static bool canUseBlockCounts(const PackedSeq& A, const PackedSeq& B, double cutoff) {
+		return ((cutoff < 1.0) && canUsePacked(A, B) && A.hasEndDotsOnly() && B.hasEndDotsOnly());
+	}
+	
+	//last column where both sequences have a base, -1 if there is none
+	static int lastBothBases(const PackedSeq& A, const PackedSeq& B) {
+		for (int w = A.getNumWords()-1; w >= 0; w--) {
+			const packedWord* a = A.getWord(w); const packedWord* b = B.getWord(w);
+			packedWord bothBases = ~(a[4] | a[5] | b[4] | b[5]) & A.getValidMask(w);
+			if (bothBases != 0) { return (w * 64) + PackedSeq::lastSet(bothBases); }
+		}
+		return -1;
+	}
 };
 
 /**************************************************************************************************/
@@ -17,6 +17,7 @@
 class eachGapDist : public Dist {
 	
 public:
+	using Dist::calcDist;
 	
 	eachGapDist() {}
 	
@@ -53,6 +54,57 @@ public:
 		if(length == 0)	{	dist = 1.0000;								}
 		else			{	dist = ((double)diff  / (double)length);	}
 	}
+	
+	//every base column is counted here, so a base that the other sequence does not have in the block is a difference.
+	//that only holds if there is no column of '.' in both between the sequences, so they must overlap or touch.
+	bool aboveCutoff(const PackedSeq& A, const PackedSeq& B, double cutoff) {
+		if (!canUseBlockCounts(A, B, cutoff)) { return false; }
+		if ((A.getFirstNonDot() > (B.getLastNonDot()+1)) || (B.getFirstNonDot() > (A.getLastNonDot()+1))) { return false; }
+		return pastCutoff(PackedSeq::minDifferences(A, B), A.getNumBases() + B.getNumBases(), cutoff);
+	}
+	
+	//same as above, 64 columns at a time. Stops early once the distance has to be above the cutoff.
+	void calcDist(const PackedSeq& A, const PackedSeq& B, double cutoff){
+		if (!canUsePacked(A, B)) { calcDist(A.getSequence(), B.getSequence()); return; }
+		
+		int diff = 0;
+		int length = 0;
+		int remainingA = A.getNumBases();
+		int remainingB = B.getNumBases();
+		bool started = false;
+		
+		for(int w=0;w<A.getNumWords();w++){
+			const packedWord* a = A.getWord(w);
+			const packedWord* b = B.getWord(w);
+			packedWord validCols = A.getValidMask(w);
+			if(cutoff < 1.0){ remainingA -= PackedSeq::popCount(~(a[4] | a[5]) & validCols); remainingB -= PackedSeq::popCount(~(b[4] | b[5]) & validCols); }
+			packedWord range = validCols;
+			packedWord bothDots = a[4] & b[4];
+			
+			if(!started){
+				packedWord notBothDots = ~bothDots & range;
+				if(notBothDots == 0){ continue; }
+				range &= ~lowMask(PackedSeq::firstSet(notBothDots));
+				started = true;
+			}
+			
+			packedWord stop = bothDots & range;
+			if(stop != 0){ range &= lowMask(PackedSeq::firstSet(stop)); }
+			
+			packedWord bothGaps = (a[4] | a[5]) & (b[4] | b[5]) & (a[5] | b[5]);
+			packedWord counted = range & ~bothGaps;
+			
+			diff += PackedSeq::popCount(counted & PackedSeq::notEqual(a, b));
+			length += PackedSeq::popCount(counted);
+			
+			if(pastCutoff(diff, length + remainingA + remainingB, cutoff)){ dist = 1.0000; return; }
+			
+			if(stop != 0){ break; }
+		}
+		
+		if(length == 0)	{	dist = 1.0000;								}
+		else			{	dist = ((double)diff  / (double)length);	}
+	}
 };
 
 /**************************************************************************************************/
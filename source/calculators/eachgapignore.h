@@ -17,6 +17,7 @@
 class eachGapIgnoreTermGapDist : public Dist {
 	
 public:
+	using Dist::calcDist;
 	eachGapIgnoreTermGapDist() {}
 	eachGapIgnoreTermGapDist(const eachGapIgnoreTermGapDist& ddb) {}
 	
@@ -68,6 +69,54 @@ public:
 		
 	}
 	
+	
+	//same as above, 64 columns at a time. Stops early once the distance has to be above the cutoff.
+	void calcDist(const PackedSeq& A, const PackedSeq& B, double cutoff){
+		if (!canUsePacked(A, B)) { calcDist(A.getSequence(), B.getSequence()); return; }
+		
+		int diff = 0;
+		int length = 0;
+		int remainingA = A.getNumBases();
+		int remainingB = B.getNumBases();
+		
+		//non-overlapping sequences
+		int end = lastBothBases(A, B);
+		if (end == -1) { dist = 1.0000; return; }
+		
+		bool started = false;
+		int endWord = end / 64;
+		for(int w=0;w<=endWord;w++){
+			const packedWord* a = A.getWord(w);
+			const packedWord* b = B.getWord(w);
+			packedWord validCols = A.getValidMask(w);
+			if(cutoff < 1.0){ remainingA -= PackedSeq::popCount(~(a[4] | a[5]) & validCols); remainingB -= PackedSeq::popCount(~(b[4] | b[5]) & validCols); }
+			packedWord range = validCols;
+			if(w == endWord){ range &= throughMask(end % 64); }
+			
+			if(!started){
+				packedWord bothBases = ~(a[4] | a[5] | b[4] | b[5]) & range;
+				if(bothBases == 0){ continue; }
+				range &= ~lowMask(PackedSeq::firstSet(bothBases));
+				started = true;
+			}
+			
+			packedWord stop = (a[4] | b[4]) & range;
+			if(stop != 0){ range &= lowMask(PackedSeq::firstSet(stop)); }
+			
+			packedWord counted = range & ~(a[5] & b[5]);
+			
+			diff += PackedSeq::popCount(counted & PackedSeq::notEqual(a, b));
+			length += PackedSeq::popCount(counted);
+			
+			if(pastCutoff(diff, length + remainingA + remainingB, cutoff)){ dist = 1.0000; return; }
+			
+			if(stop != 0){ break; }
+		}
+		
+		if(length == 0)	{	dist = 1.0000;								}
+		else			{	dist = ((double)diff  / (double)length);	}
+	}
+	
 };
 
 /**************************************************************************************************/
@@ -75,7 +75,7 @@ public:
         
     }
 	
-	void doTrump(Sequence seq) {
+	void doTrump(Sequence& seq) {
 	
 		string curAligned = seq.getAligned();
 
@@ -98,7 +98,7 @@ public:
         if (filter.length() != alignmentLength) {  m->mothurOut("[ERROR]: Sequences are not all the same length as the filter, please correct.\n");  m->control_pressed = true; }
 	}
 
-	void getFreqs(Sequence seq) {
+	void getFreqs(Sequence& seq) {
 	
 		string curAligned = seq.getAligned();
 	
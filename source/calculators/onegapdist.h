@@ -17,6 +17,7 @@
 class oneGapDist : public Dist {
 	
 public:
+	using Dist::calcDist;
 	
 	oneGapDist() {}
 	
@@ -79,6 +80,63 @@ public:
 		else				{	dist = (double)difference / minLength;	}
 	}
 	
+	//same as above, 64 columns at a time. Stops early once the distance has to be above the cutoff. A run of gap columns in one sequence counts once. Columns where both
+	//sequences have a gap do not end a run, so the runs are filled through them with PackedSeq::fillThrough.
+	void calcDist(const PackedSeq& A, const PackedSeq& B, double cutoff){
+		if (!canUsePacked(A, B)) { calcDist(A.getSequence(), B.getSequence()); return; }
+		
+		int difference = 0;
+		int minLength = 0;
+		int remainingA = A.getNumBases();
+		int remainingB = B.getNumBases();
+		packedWord carryA = 0;
+		packedWord carryB = 0;
+		bool started = false;
+		
+		for(int w=0;w<A.getNumWords();w++){
+			const packedWord* a = A.getWord(w);
+			const packedWord* b = B.getWord(w);
+			packedWord validCols = A.getValidMask(w);
+			if(cutoff < 1.0){ remainingA -= PackedSeq::popCount(~(a[4] | a[5]) & validCols); remainingB -= PackedSeq::popCount(~(b[4] | b[5]) & validCols); }
+			packedWord range = validCols;
+			packedWord bothDots = a[4] & b[4];
+			
+			if(!started){
+				packedWord notBothDots = ~bothDots & range;
+				if(notBothDots == 0){ continue; }
+				range &= ~lowMask(PackedSeq::firstSet(notBothDots));
+				started = true;
+			}
+			
+			packedWord stop = bothDots & range;
+			if(stop != 0){ range &= lowMask(PackedSeq::firstSet(stop)); }
+			
+			packedWord gapA = a[4] | a[5];
+			packedWord gapB = b[4] | b[5];
+			packedWord bothGaps = gapA & gapB & (a[5] | b[5]) & range;
+			packedWord onlyGapA = gapA & ~gapB & range;
+			packedWord onlyGapB = gapB & ~gapA & range;
+			packedWord bases = ~gapA & ~gapB & range;
+			
+			packedWord prevA = carryA;
+			packedWord prevB = carryB;
+			packedWord runA = PackedSeq::fillThrough(onlyGapA, bothGaps, carryA);
+			packedWord runB = PackedSeq::fillThrough(onlyGapB, bothGaps, carryB);
+			
+			int gapOpens = PackedSeq::popCount(onlyGapA & ~((runA << 1) | prevA)) + PackedSeq::popCount(onlyGapB & ~((runB << 1) | prevB));
+			
+			difference += gapOpens + PackedSeq::popCount(bases & PackedSeq::notEqual(a, b));
+			minLength += gapOpens + PackedSeq::popCount(bases);
+			
+			if(pastCutoff(difference, minLength + remainingA + remainingB, cutoff)){ dist = 1.0000; return; }
+			
+			if(stop != 0){ break; }
+		}
+		
+		if(minLength == 0)	{	dist = 1.0000;							}
+		else				{	dist = (double)difference / minLength;	}
+	}
+	
 };
 
 /**************************************************************************************************/
@@ -17,6 +17,7 @@
 class oneGapIgnoreTermGapDist : public Dist {
 	
 public:
+	using Dist::calcDist;
 	
 	oneGapIgnoreTermGapDist() {}
 	
@@ -86,6 +87,62 @@ public:
 		if(minLength == 0)	{	dist = 1.0000;							}
 		else				{	dist = (double)difference / minLength;	}
 	}
+	
+	//same as above, 64 columns at a time. Stops early once the distance has to be above the cutoff. A run of gap columns in one sequence counts once. Columns where both
+	//sequences have a gap do not end a run, so the runs are filled through them with PackedSeq::fillThrough.
+	void calcDist(const PackedSeq& A, const PackedSeq& B, double cutoff){
+		if (!canUsePacked(A, B)) { calcDist(A.getSequence(), B.getSequence()); return; }
+		
+		int difference = 0;
+		int minLength = 0;
+		int remainingA = A.getNumBases() + A.getNumDots();
+		int remainingB = B.getNumBases() + B.getNumDots();
+		packedWord carryA = 0;
+		packedWord carryB = 0;
+		
+		//non-overlapping sequences
+		int end = lastBothBases(A, B);
+		if (end == -1) { dist = 1.0000; return; }
+		
+		bool started = false;
+		int endWord = end / 64;
+		for(int w=0;w<=endWord;w++){
+			const packedWord* a = A.getWord(w);
+			const packedWord* b = B.getWord(w);
+			packedWord validCols = A.getValidMask(w);
+			if(cutoff < 1.0){ remainingA -= PackedSeq::popCount(~a[5] & validCols); remainingB -= PackedSeq::popCount(~b[5] & validCols); }
+			packedWord range = validCols;
+			if(w == endWord){ range &= throughMask(end % 64); }
+			
+			if(!started){
+				packedWord bothBases = ~(a[4] | a[5] | b[4] | b[5]) & range;
+				if(bothBases == 0){ continue; }
+				range &= ~lowMask(PackedSeq::firstSet(bothBases));
+				started = true;
+			}
+			
+			//'.' is treated as a base here, only '-' is a gap
+			packedWord bothGaps = a[5] & b[5] & range;
+			packedWord onlyGapA = a[5] & ~b[5] & range;
+			packedWord onlyGapB = b[5] & ~a[5] & range;
+			packedWord bases = ~a[5] & ~b[5] & range;
+			
+			packedWord prevA = carryA;
+			packedWord prevB = carryB;
+			packedWord runA = PackedSeq::fillThrough(onlyGapA, bothGaps, carryA);
+			packedWord runB = PackedSeq::fillThrough(onlyGapB, bothGaps, carryB);
+			
+			int gapOpens = PackedSeq::popCount(onlyGapA & ~((runA << 1) | prevA)) + PackedSeq::popCount(onlyGapB & ~((runB << 1) | prevB));
+			
+			difference += gapOpens + PackedSeq::popCount(bases & PackedSeq::notEqual(a, b));
+			minLength += gapOpens + PackedSeq::popCount(bases);
+			
+			if(pastCutoff(difference, minLength + remainingA + remainingB, cutoff)){ dist = 1.0000; return; }
+		}
+		
+		if(minLength == 0)	{	dist = 1.0000;							}
+		else				{	dist = (double)difference / minLength;	}
+	}
 
 };
 
@@ -85,6 +85,9 @@ EstOutput Parsimony::createProcesses(Tree* t, vector< vector<string> > namesOfGr
         bool recalc = false;
 		
 		EstOutput results;
+        
+        //the group indexed copy the combinations are scored on
+        DenseTree denseTree(t, ct->getNamesOfGroups());
 
 #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
 				
@@ -97,7 +100,7 @@ EstOutput Parsimony::createProcesses(Tree* t, vector< vector<string> > namesOfGr
 				process++;
 			}else if (pid == 0){
 				EstOutput myresults;
-				myresults = driver(t, namesOfGroupCombos, lines[process].start, lines[process].num, ct);
+				myresults = driver(&denseTree, namesOfGroupCombos, lines[process].start, lines[process].num);
 				
 				if (m->control_pressed) { exit(0); }
 				
@@ -154,7 +157,7 @@ EstOutput Parsimony::createProcesses(Tree* t, vector< vector<string> > namesOfGr
                     process++;
                 }else if (pid == 0){
                     EstOutput myresults;
-                    myresults = driver(t, namesOfGroupCombos, lines[process].start, lines[process].num, ct);
+                    myresults = driver(&denseTree, namesOfGroupCombos, lines[process].start, lines[process].num);
                     
                     if (m->control_pressed) { exit(0); }
                     
@@ -176,7 +179,7 @@ EstOutput Parsimony::createProcesses(Tree* t, vector< vector<string> > namesOfGr
         }
 
         
-		results = driver(t, namesOfGroupCombos, lines[0].start, lines[0].num, ct);
+		results = driver(&denseTree, namesOfGroupCombos, lines[0].start, lines[0].num);
 		
 		//force parent to wait until all the processes are done
 		for (int i=0;i<processIDS.size();i++) { 
@@ -214,27 +217,21 @@ EstOutput Parsimony::createProcesses(Tree* t, vector< vector<string> > namesOfGr
         vector<parsData*> pDataArray;
 		DWORD   dwThreadIdArray[processors-1];
 		HANDLE  hThreadArray[processors-1];
-        vector<CountTable*> cts;
-        vector<Tree*> trees;
+        vector<DenseTree*> trees;
 		
 		//Create processor worker threads.
 		for( int i=1; i<processors; i++ ){
-            CountTable* copyCount = new CountTable();
-            copyCount->copy(ct);
-            Tree* copyTree = new Tree(copyCount);
-            copyTree->getCopy(t);
-            
-            cts.push_back(copyCount);
+            DenseTree* copyTree = new DenseTree(denseTree);
             trees.push_back(copyTree);
             
-            parsData* temppars = new parsData(m, lines[i].start, lines[i].num, namesOfGroupCombos, copyTree, copyCount);
+            parsData* temppars = new parsData(m, lines[i].start, lines[i].num, namesOfGroupCombos, copyTree);
 			pDataArray.push_back(temppars);
 			processIDS.push_back(i);
             
 			hThreadArray[i-1] = CreateThread(NULL, 0, MyParsimonyThreadFunction, pDataArray[i-1], 0, &dwThreadIdArray[i-1]);
 		}
 		
-		results = driver(t, namesOfGroupCombos, lines[0].start, lines[0].num, ct);
+		results = driver(&denseTree, namesOfGroupCombos, lines[0].start, lines[0].num);
 		
 		//Wait until all threads have terminated.
 		WaitForMultipleObjects(processors-1, hThreadArray, TRUE, INFINITE);
@@ -242,7 +239,6 @@ EstOutput Parsimony::createProcesses(Tree* t, vector< vector<string> > namesOfGr
 		//Close all thread handles and free memory allocations.
 		for(int i=0; i < pDataArray.size(); i++){
             for (int j = 0; j < pDataArray[i]->results.size(); j++) {  results.push_back(pDataArray[i]->results[j]);  }
-			delete cts[i];
             delete trees[i];
 			CloseHandle(hThreadArray[i]);
 			delete pDataArray[i];
@@ -257,56 +253,24 @@ EstOutput Parsimony::createProcesses(Tree* t, vector< vector<string> > namesOfGr
 	}
 }
 /**************************************************************************************************/
-EstOutput Parsimony::driver(Tree* t, vector< vector<string> > namesOfGroupCombos, int start, int num, CountTable* ct) { 
+EstOutput Parsimony::driver(DenseTree* t, vector< vector<string> > namesOfGroupCombos, int start, int num) { 
 	try {
 		
 		EstOutput results; results.resize(num);
 		
-		Tree* copyTree = new Tree(ct);
 		int count = 0;
 		
 		for (int h = start; h < (start+num); h++) {
 					
-			if (m->control_pressed) { delete copyTree; return results; }
-	
-			int score = 0;
+			if (m->control_pressed) { return results; }
 			
 			//groups in this combo
-			vector<string> groups = namesOfGroupCombos[h];
-			
-			//copy users tree so that you can redo pgroups 
-			copyTree->getCopy(t);
-			
-			//create pgroups that reflect the groups the user want to use
-			for(int i=copyTree->getNumLeaves();i<copyTree->getNumNodes();i++){
-				copyTree->tree[i].pGroups = (copyTree->mergeUserGroups(i, groups));
-			}
-			
-			for(int i=copyTree->getNumLeaves();i<copyTree->getNumNodes();i++){
-				
-				if (m->control_pressed) { return data; }
-				
-				int lc = copyTree->tree[i].getLChild();
-				int rc = copyTree->tree[i].getRChild();
-				
-				int iSize = copyTree->tree[i].pGroups.size();
-				int rcSize = copyTree->tree[rc].pGroups.size();
-				int lcSize = copyTree->tree[lc].pGroups.size();
-				
-				//if isize are 0 then that branch is to be ignored
-				if (iSize == 0) { }
-				else if ((rcSize == 0) || (lcSize == 0)) { }
-				//if you have more groups than either of your kids then theres been a change.
-				else if(iSize > rcSize || iSize > lcSize){
-					score++;
-				}
-			} 
+			vector<int> groups;
+			for (int g = 0; g < namesOfGroupCombos[h].size(); g++) { groups.push_back(t->getGroupIndex(namesOfGroupCombos[h][g])); }
 			
-			results[count] = score;
+			results[count] = t->getParsimony(groups);
 			count++;
 		}
-					
-		delete copyTree;
 			
 		return results; 
 	}
@@ -13,6 +13,7 @@
 
 #include "treecalculator.h"
 #include "counttable.h"
+#include "densetree.h"
 
 /***********************************************************************/
 
@@ -35,7 +36,7 @@ class Parsimony : public TreeCalculator  {
 		int processors;
 		string outputDir;
 	
-		EstOutput driver(Tree*, vector< vector<string> >, int, int, CountTable*); 
+		EstOutput driver(DenseTree*, vector< vector<string> >, int, int); 
 		EstOutput createProcesses(Tree*, vector< vector<string> >, CountTable*);
 };
 /***********************************************************************/
@@ -45,17 +46,15 @@ struct parsData {
 	MothurOut* m;
     EstOutput results;
     vector< vector<string> > namesOfGroupCombos;
-    Tree* t;
-    CountTable* ct;
+    DenseTree* t;
     
 	parsData(){}
-	parsData(MothurOut* mout, int st, int en, vector< vector<string> > ngc, Tree* tree, CountTable* count) {
+	parsData(MothurOut* mout, int st, int en, vector< vector<string> > ngc, DenseTree* tree) {
         m = mout;
 		start = st;
 		num = en;
         namesOfGroupCombos = ngc;
         t = tree;
-        ct = count;
 	}
 };
 
@@ -69,52 +68,20 @@ static DWORD WINAPI MyParsimonyThreadFunction(LPVOID lpParam){
         
         pDataArray->results.resize(pDataArray->num);
 		
-		Tree* copyTree = new Tree(pDataArray->ct);
 		int count = 0;
 		
 		for (int h = pDataArray->start; h < (pDataArray->start+pDataArray->num); h++) {
             
-			if (pDataArray->m->control_pressed) { delete copyTree; return 0; }
-            
-			int score = 0;
+			if (pDataArray->m->control_pressed) { return 0; }
 			
 			//groups in this combo
-			vector<string> groups = pDataArray->namesOfGroupCombos[h];
-			
-			//copy users tree so that you can redo pgroups
-			copyTree->getCopy(pDataArray->t);
-			
-			//create pgroups that reflect the groups the user want to use
-			for(int i=copyTree->getNumLeaves();i<copyTree->getNumNodes();i++){
-				copyTree->tree[i].pGroups = (copyTree->mergeUserGroups(i, groups));
-			}
+			vector<int> groups;
+			for (int g = 0; g < pDataArray->namesOfGroupCombos[h].size(); g++) { groups.push_back(pDataArray->t->getGroupIndex(pDataArray->namesOfGroupCombos[h][g])); }
 			
-			for(int i=copyTree->getNumLeaves();i<copyTree->getNumNodes();i++){
-				
-				if (pDataArray->m->control_pressed) { return 0; }
-				
-				int lc = copyTree->tree[i].getLChild();
-				int rc = copyTree->tree[i].getRChild();
-				
-				int iSize = copyTree->tree[i].pGroups.size();
-				int rcSize = copyTree->tree[rc].pGroups.size();
-				int lcSize = copyTree->tree[lc].pGroups.size();
-				
-				//if isize are 0 then that branch is to be ignored
-				if (iSize == 0) { }
-				else if ((rcSize == 0) || (lcSize == 0)) { }
-				//if you have more groups than either of your kids then theres been a change.
-				else if(iSize > rcSize || iSize > lcSize){
-					score++;
-				}
-			}
-			
-			pDataArray->results[count] = score;
+			pDataArray->results[count] = pDataArray->t->getParsimony(groups);
 			count++;
 		}
         
-		delete copyTree;
-        
         return 0;
         
     }
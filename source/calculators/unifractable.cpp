@@ -0,0 +1,297 @@
+//
+//  unifractable.cpp
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#include "unifractable.h"
+
+//pairs summed per stripe, two sums of this many doubles stay in cache
+static const int pairsPerStripe = 8192;
+
+/**************************************************************************************************/
+//adds node branch bl to pair p of groups x and y, the same terms Weighted::driver and Unweighted::driver add for the node
+static inline void scorePair(int p, int x, int y, vector<double>& freqs, vector<char>& present, vector<char>& full, bool excludable, bool weighted, bool addDepth, float bl, float absBl, vector<double>& first, vector<double>& second) {
+    if (excludable && full[x] && full[y]) { return; } //at or above the root of the pair
+
+    if (weighted) {
+        double u = 0.00;
+        if (present[x]) { u = freqs[x]; }
+        if (present[y]) { u -= freqs[y]; }
+        first[p] += abs(u * bl);
+        if (addDepth) { second[p] += absBl * (freqs[x] + freqs[y]); }
+    }else {
+        if ((present[x] + present[y]) == 1) { first[p] += absBl; }
+        second[p] += absBl;
+    }
+}
+/**************************************************************************************************/
+UnifracTable::UnifracTable(Tree* t, vector<string> g) {
+    try {
+        m = MothurOut::getInstance();
+        groups = g;
+        numGroups = groups.size();
+        numNodes = t->getNumNodes();
+        numLeaves = t->getNumLeaves();
+        root = t->findRoot();
+
+        CountTable* ct = t->getCountTable();
+        map<string, int> groupIndex;
+        for (int i = 0; i < numGroups; i++) {
+            groupIndex[groups[i]] = i;
+            groupSizes.push_back((double)ct->getGroupCount(groups[i]));
+        }
+
+        for (int i = 0; i < numNodes; i++) {
+            if (m->control_pressed) { break; }
+
+            branchLengths.push_back(t->tree[i].getBranchLength());
+            nodeStart.push_back(entryGroup.size());
+            for (map<string, int>::iterator it = t->tree[i].pcount.begin(); it != t->tree[i].pcount.end(); it++) {
+                map<string, int>::iterator itIndex = groupIndex.find(it->first);
+                if (itIndex != groupIndex.end()) { entryGroup.push_back(itIndex->second); entryCount.push_back(it->second); }
+            }
+        }
+        nodeStart.push_back(entryGroup.size());
+
+        totals.assign(numGroups, 0);
+        inTree.assign(numGroups, false);
+        if ((root != -1) && (nodeStart.size() == (numNodes+1))) {
+            for (int e = nodeStart[root]; e < nodeStart[root+1]; e++) { totals[entryGroup[e]] = entryCount[e]; inTree[entryGroup[e]] = true; }
+        }
+
+        createStripes();
+    }
+    catch(exception& e) {
+        m->errorOut(e, "UnifracTable", "UnifracTable");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//row x holds the x pairs (x,0) to (x,x-1), rows are grouped until a stripe has pairsPerStripe pairs
+void UnifracTable::createStripes() {
+    try {
+        stripeStarts.clear();
+        int pairsInStripe = 0;
+        for (int x = 0; x < numGroups; x++) {
+            if ((pairsInStripe == 0) || (pairsInStripe + x > pairsPerStripe)) { stripeStarts.push_back(x); pairsInStripe = 0; }
+            pairsInStripe += x;
+        }
+        stripeStarts.push_back(numGroups);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "UnifracTable", "createStripes");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+EstOutput UnifracTable::getWeighted(bool includeRoot, int processors) {
+    try {
+        EstOutput results;
+        vector<double> branchSums(getNumPairs(), 0.0); //WScore
+        vector<double> depthSums(getNumPairs(), 0.0); //D, the normalizing sum of the distances to the root of the pair
+
+        runStripes(true, includeRoot, processors, branchSums, depthSums);
+
+        for (int p = 0; p < branchSums.size(); p++) {
+            double UN = branchSums[p] / depthSums[p];
+            if (isnan(UN) || isinf(UN)) { UN = 0; }
+            results.push_back(UN);
+        }
+
+        return results;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "UnifracTable", "getWeighted");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+EstOutput UnifracTable::getUnweighted(bool includeRoot, int processors) {
+    try {
+        EstOutput results;
+        vector<double> uniqueSums(getNumPairs(), 0.0); //UniqueBL
+        vector<double> totalSums(getNumPairs(), 0.0); //totalBL
+
+        runStripes(false, includeRoot, processors, uniqueSums, totalSums);
+
+        for (int x = 0; x < numGroups; x++) {
+            for (int y = 0; y < x; y++) {
+                if (!inTree[x] && !inTree[y]) { vector<int> grouping; grouping.push_back(x); grouping.push_back(y); warnMissing(grouping); }
+            }
+        }
+
+        for (int p = 0; p < uniqueSums.size(); p++) {
+            double UW = uniqueSums[p] / totalSums[p];
+            if (isnan(UW) || isinf(UW)) { UW = 0; }
+            results.push_back(UW);
+        }
+
+        return results;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "UnifracTable", "getUnweighted");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//unweighted score of several groups together, a branch is unique if only one of them is below it
+double UnifracTable::getUnweighted(vector<int> grouping, bool includeRoot) {
+    try {
+        vector<bool> inGrouping(numGroups, false);
+        int numNeeded = 0; //groups of the grouping in the tree, a node holding all of their sequences is at or above the root
+        for (int i = 0; i < grouping.size(); i++) {
+            inGrouping[grouping[i]] = true;
+            if (inTree[grouping[i]]) { numNeeded++; }
+        }
+
+        if (numNeeded == 0) { warnMissing(grouping); return 0.0; }
+
+        double UniqueBL = 0.0000;
+        double totalBL = 0.00;
+
+        for (int v = 0; v < numNodes; v++) {
+            if (m->control_pressed) { return 0.0; }
+
+            float bl = branchLengths[v];
+            if (bl == -1) { continue; }
+
+            int numPresent = 0; int numFull = 0;
+            for (int e = nodeStart[v]; e < nodeStart[v+1]; e++) {
+                if (!inGrouping[entryGroup[e]]) { continue; }
+                numPresent++;
+                if (entryCount[e] == totals[entryGroup[e]]) { numFull++; }
+            }
+
+            if (numPresent == 0) { continue; }
+            if (!includeRoot && (v >= numLeaves) && (numFull == numNeeded)) { continue; }
+
+            if (numPresent == 1) { UniqueBL += abs(bl); }
+            totalBL += abs(bl);
+        }
+
+        double UW = (UniqueBL / totalBL);
+        if (isnan(UW) || isinf(UW)) { UW = 0; }
+
+        return UW;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "UnifracTable", "getUnweighted");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void UnifracTable::runStripes(bool weighted, bool includeRoot, int processors, vector<double>& first, vector<double>& second) {
+    try {
+        int numStripes = stripeStarts.size() - 1;
+        if (processors > numStripes) { processors = numStripes; }
+
+        if (processors < 2) {
+            for (int s = 0; s < numStripes; s++) {
+                if (m->control_pressed) { break; }
+                scoreStripe(s, weighted, includeRoot, first, second);
+            }
+        }else {
+            //each stripe writes its own range of the sums, so the threads share nothing but the counter
+            atomic<int> nextStripe(0);
+
+            vector<thread*> workerThreads;
+            for (int i = 1; i < processors; i++) {
+                workerThreads.push_back(new thread(&UnifracTable::stripeThread, this, &nextStripe, weighted, includeRoot, &first, &second));
+            }
+            stripeThread(&nextStripe, weighted, includeRoot, &first, &second);
+
+            for (int i = 0; i < workerThreads.size(); i++) {
+                workerThreads[i]->join();
+                delete workerThreads[i];
+            }
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "UnifracTable", "runStripes");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void UnifracTable::stripeThread(atomic<int>* nextStripe, bool weighted, bool includeRoot, vector<double>* first, vector<double>* second) {
+    try {
+        int numStripes = stripeStarts.size() - 1;
+        while (!m->control_pressed) {
+            int s = (*nextStripe)++;
+            if (s >= numStripes) { break; }
+            scoreStripe(s, weighted, includeRoot, *first, *second);
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "UnifracTable", "stripeThread");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//adds every node to the pairs of rows stripeStarts[s] to stripeStarts[s+1]-1
+void UnifracTable::scoreStripe(int s, bool weighted, bool includeRoot, vector<double>& first, vector<double>& second) {
+    try {
+        int firstRow = stripeStarts[s];
+        int lastRow = stripeStarts[s+1];
+
+        //a group missing from a node is full there only if it is missing from the tree
+        vector<double> freqs(numGroups, 0.0);
+        vector<char> present(numGroups, 0);
+        vector<char> full(numGroups, 0);
+        for (int g = 0; g < numGroups; g++) { full[g] = !inTree[g]; }
+
+        for (int v = 0; v < numNodes; v++) {
+            if (m->control_pressed) { return; }
+
+            float bl = branchLengths[v];
+            if (bl == -1) { continue; }
+            float absBl = abs(bl);
+
+            bool excludable = (!includeRoot) && (v >= numLeaves); //a leaf is never the root of a pair
+            bool addDepth = (v != root); //the distance to the root never includes the branch above it
+
+            int start = nodeStart[v]; int end = nodeStart[v+1];
+            for (int e = start; e < end; e++) {
+                int g = entryGroup[e];
+                present[g] = 1;
+                freqs[g] = (double) entryCount[e] / groupSizes[g];
+                full[g] = (entryCount[e] == totals[g]);
+            }
+
+            for (int e = start; e < end; e++) {
+                int a = entryGroup[e];
+
+                //pairs (a,y), every y
+                if ((a >= firstRow) && (a < lastRow)) {
+                    int rowStart = (a * (a-1)) / 2;
+                    for (int y = 0; y < a; y++) { scorePair(rowStart + y, a, y, freqs, present, full, excludable, weighted, addDepth, bl, absBl, first, second); }
+                }
+
+                //pairs (x,a), skipping the x that are here too, their row already scored the pair
+                int x = max(firstRow, a+1);
+                for (; x < lastRow; x++) {
+                    if (present[x]) { continue; }
+                    scorePair(((x * (x-1)) / 2) + a, x, a, freqs, present, full, excludable, weighted, addDepth, bl, absBl, first, second);
+                }
+            }
+
+            for (int e = start; e < end; e++) {
+                int g = entryGroup[e];
+                present[g] = 0; freqs[g] = 0.0; full[g] = !inTree[g];
+            }
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "UnifracTable", "scoreStripe");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void UnifracTable::warnMissing(vector<int>& grouping) {
+    m->mothurOut("[WARNING]: cannot find a nodes in the tree from grouping ");
+    for (int g = 0; g < grouping.size()-1; g++) { m->mothurOut(groups[grouping[g]] + "-"); }
+    m->mothurOut(groups[grouping[grouping.size()-1]]);
+    m->mothurOut(", skipping."); m->mothurOutEndLine();
+}
+/**************************************************************************************************/
@@ -0,0 +1,61 @@
+//
+//  unifractable.h
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__unifractable__
+#define __Mothur__unifractable__
+
+#include "mothur.h"
+#include "mothurout.h"
+#include "treecalculator.h"
+
+/* This class scores every pair of groups on a tree in one pass over its nodes, instead of walking the tree once per pair.
+ Each node keeps the groups below it as (group, count) entries, for a node with k groups only the pairs touching those k groups
+ change, so the leaves cost k * numGroups instead of numGroups * numGroups.  Pairs are scored in stripes of rows small enough
+ for their sums to stay in cache, and the stripes are shared by the threads.
+
+ Pairs are numbered the way Weighted and Unweighted build their combinations, pair (x,y) with y < x is x*(x-1)/2 + y, and the
+ nodes are added in index order so the unweighted sums and the weighted branch sums come out the same as the pair by pair walks.
+
+ The root of a pair is the lowest node holding every sequence of both groups, it and the nodes above it are left out unless
+ includeRoot is set.
+ */
+
+/**************************************************************************************************/
+
+class UnifracTable {
+
+public:
+    UnifracTable(Tree*, vector<string>); //tree, groups in the order of the combinations
+    ~UnifracTable() {}
+
+    EstOutput getWeighted(bool, int); //includeRoot, processors
+    EstOutput getUnweighted(bool, int); //includeRoot, processors
+    double getUnweighted(vector<int>, bool); //groups scored together, includeRoot
+
+    int getNumPairs() { return (numGroups * (numGroups-1)) / 2; }
+
+private:
+    MothurOut* m;
+    vector<string> groups;
+    int numGroups, numNodes, numLeaves, root;
+    vector<float> branchLengths;
+    vector<int> nodeStart, entryGroup, entryCount; //node i's groups are entries nodeStart[i] to nodeStart[i+1]
+    vector<int> totals; //sequences of each group in the tree, counts at the root
+    vector<bool> inTree;
+    vector<double> groupSizes; //sequences of each group in the count table
+    vector<int> stripeStarts; //first row of each stripe, the last entry is numGroups
+
+    void createStripes();
+    void runStripes(bool, bool, int, vector<double>&, vector<double>&);
+    void scoreStripe(int, bool, bool, vector<double>&, vector<double>&);
+    void stripeThread(atomic<int>*, bool, bool, vector<double>*, vector<double>*);
+    void warnMissing(vector<int>&);
+};
+
+/**************************************************************************************************/
+
+#endif
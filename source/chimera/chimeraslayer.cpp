@@ -14,7 +14,7 @@
 
 //***************************************************************************************************************
 ChimeraSlayer::ChimeraSlayer(string file, string temp, bool trim, string mode, int k, int ms, int mms, int win, float div, 
-int minsim, int mincov, int minbs, int minsnp, int par, int it, int inc, int numw, bool r, string blas, int tid) : MothurChimera()  {  	
+int minsim, int mincov, int minbs, int minsnp, int par, int it, int inc, int numw, bool r, string blas, int tid) : MothurChimera(), maligner(ms, mms, div, minsim, mincov), slayer(win, inc, minsim, div, it, minsnp, minbs)  {  	
 	try {
 		fastafile = file;
 		templateFileName = temp; templateSeqs = readSeqs(temp);
@@ -37,6 +37,7 @@ int minsim, int mincov, int minbs, int minsnp, int par, int it, int inc, int num
 		numNoParents = 0;
 		blastlocation = blas;
 		threadID = tid;
+		sharedTemplate = false;
 	
 		doPrep();
 	}
@@ -48,7 +49,7 @@ int minsim, int mincov, int minbs, int minsnp, int par, int it, int inc, int num
 //***************************************************************************************************************
 //template=self
 ChimeraSlayer::ChimeraSlayer(string file, string temp, bool trim, map<string, int>& prior, string mode, int k, int ms, int mms, int win, float div, 
-							 int minsim, int mincov, int minbs, int minsnp, int par, int it, int inc, int numw, bool r, string blas, int tid, bool bg) : MothurChimera()  {  	
+							 int minsim, int mincov, int minbs, int minsnp, int par, int it, int inc, int numw, bool r, string blas, int tid, bool bg) : MothurChimera(), maligner(ms, mms, div, minsim, mincov), slayer(win, inc, minsim, div, it, minsnp, minbs)  {  	
 	try {
 		byGroup = bg;
 		fastafile = file; templateSeqs = readSeqs(fastafile);
@@ -73,6 +74,7 @@ ChimeraSlayer::ChimeraSlayer(string file, string temp, bool trim, map<string, in
 		numNoParents = 0;
 		blastlocation = blas;
 		threadID = tid;
+		sharedTemplate = false;
 		
 		
 		createFilter(templateSeqs, 0.0); //just removed columns where all seqs have a gap
@@ -98,7 +100,7 @@ ChimeraSlayer::ChimeraSlayer(string file, string temp, bool trim, map<string, in
 //***************************************************************************************************************
 //template=self
 ChimeraSlayer::ChimeraSlayer(string file, string temp, bool trim, map<string, int>& prior, string mode, int k, int ms, int mms, int win, float div, 
-							 int minsim, int mincov, int minbs, int minsnp, int par, int it, int inc, int numw, bool r, string blas, int tid) : MothurChimera()  {  	
+							 int minsim, int mincov, int minbs, int minsnp, int par, int it, int inc, int numw, bool r, string blas, int tid) : MothurChimera(), maligner(ms, mms, div, minsim, mincov), slayer(win, inc, minsim, div, it, minsnp, minbs)  {  	
 	try {
 		fastafile = file; templateSeqs = readSeqs(fastafile);
 		templateFileName = temp; 
@@ -122,6 +124,7 @@ ChimeraSlayer::ChimeraSlayer(string file, string temp, bool trim, map<string, in
 		numNoParents = 0;
 		blastlocation = blas;
 		threadID = tid;
+		sharedTemplate = false;
 		
 		
 		createFilter(templateSeqs, 0.0); //just removed columns where all seqs have a gap
@@ -145,6 +148,56 @@ ChimeraSlayer::ChimeraSlayer(string file, string temp, bool trim, map<string, in
 	}
 }
 //***************************************************************************************************************
+//a copy for another thread. The templates and the blast database are only read by a search, so they are shared with
+//main. The kmer databases keep scratch space for their searches, so the copy reads its own from the files main wrote.
+ChimeraSlayer::ChimeraSlayer(ChimeraSlayer* main) : MothurChimera(), maligner(main->match, main->misMatch, main->divR, main->minSim, main->minCov), slayer(main->window, main->increment, main->minSim, main->divR, main->iters, main->minSNP, main->minBS)  {
+	try {
+		byGroup = main->byGroup;
+		fastafile = main->fastafile;
+		templateFileName = main->templateFileName;
+		templateSeqs = main->templateSeqs;
+		filteredTemplateSeqs = main->filteredTemplateSeqs;
+		filter = main->filter;
+		unaligned = main->unaligned;
+		length = main->length;
+		seqMask = main->seqMask;
+		filterString = main->filterString;
+		outputDir = main->outputDir;
+		searchMethod = main->searchMethod;
+		kmerSize = main->kmerSize;
+		match = main->match;
+		misMatch = main->misMatch;
+		window = main->window;
+		divR = main->divR;
+		minSim = main->minSim;
+		minCov = main->minCov;
+		minBS = main->minBS;
+		minSNP = main->minSNP;
+		parents = main->parents;
+		iters = main->iters;
+		increment = main->increment;
+		numWanted = main->numWanted;
+		realign = main->realign;
+		trimChimera = main->trimChimera;
+		priority = main->priority;
+		chimericSeqs = main->chimericSeqs;
+		numNoParents = 0;
+		blastlocation = main->blastlocation;
+		threadID = main->threadID;
+		decalc = main->decalc;
+		sharedTemplate = true;
+		
+		if (templateFileName != "self") {
+			if (searchMethod == "kmer") { createKmerDBs(); }
+			else if (searchMethod == "blast") { databaseLeft = main->databaseLeft; }
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ChimeraSlayer", "ChimeraSlayer");
+		exit(1);
+	}
+}
+//***************************************************************************************************************
 int ChimeraSlayer::doPrep() {
 	try {
 		if (searchMethod == "distance") { 
@@ -169,83 +222,12 @@ int ChimeraSlayer::doPrep() {
 				filteredTemplateSeqs.push_back(newSeq);
 			}
 		}
-		string 	kmerDBNameLeft;
-		string 	kmerDBNameRight;
-	
 		//generate the kmerdb to pass to maligner
-		if (searchMethod == "kmer") { 
-			string templatePath = m->hasPath(templateFileName);
-			string rightTemplateFileName = templatePath + "right." + m->getRootName(m->getSimpleName(templateFileName));
-			databaseRight = new KmerDB(rightTemplateFileName, kmerSize);
-				
-			string leftTemplateFileName = templatePath + "left." + m->getRootName(m->getSimpleName(templateFileName));
-			databaseLeft = new KmerDB(leftTemplateFileName, kmerSize);	
-		
-			//leftside
-			kmerDBNameLeft = leftTemplateFileName.substr(0,leftTemplateFileName.find_last_of(".")+1) + char('0'+ kmerSize) + "mer";
-			ifstream kmerFileTestLeft(kmerDBNameLeft.c_str());
-			bool needToGenerateLeft = true;
-			
-			if(kmerFileTestLeft){	
-				bool GoodFile = m->checkReleaseVersion(kmerFileTestLeft, m->getVersion());
-				if (GoodFile) {  needToGenerateLeft = false;	}
-			}
-			
-			if(needToGenerateLeft){	
-			
-				for (int i = 0; i < templateSeqs.size(); i++) {
-					
-					if (m->control_pressed) { return 0; } 
-					
-					string leftFrag = templateSeqs[i]->getUnaligned();
-					leftFrag = leftFrag.substr(0, int(leftFrag.length() * 0.33));
-					
-					Sequence leftTemp(templateSeqs[i]->getName(), leftFrag);
-					databaseLeft->addSequence(leftTemp);	
-				}
-				databaseLeft->generateDB();
-				
-			}else {	
-				databaseLeft->readKmerDB(kmerFileTestLeft);	
-			}
-			kmerFileTestLeft.close();
-			
-			databaseLeft->setNumSeqs(templateSeqs.size());
-			
-			//rightside
-			kmerDBNameRight = rightTemplateFileName.substr(0,rightTemplateFileName.find_last_of(".")+1) + char('0'+ kmerSize) + "mer";
-			ifstream kmerFileTestRight(kmerDBNameRight.c_str());
-			bool needToGenerateRight = true;
-			
-			if(kmerFileTestRight){	
-				bool GoodFile = m->checkReleaseVersion(kmerFileTestRight, m->getVersion());
-				if (GoodFile) {  needToGenerateRight = false;	}
-			}
-			
-			if(needToGenerateRight){	
-			
-				for (int i = 0; i < templateSeqs.size(); i++) {
-					if (m->control_pressed) { return 0; } 
-					
-					string rightFrag = templateSeqs[i]->getUnaligned();
-					rightFrag = rightFrag.substr(int(rightFrag.length() * 0.66));
-					
-					Sequence rightTemp(templateSeqs[i]->getName(), rightFrag);
-					databaseRight->addSequence(rightTemp);	
-				}
-				databaseRight->generateDB();
-				
-			}else {	
-				databaseRight->readKmerDB(kmerFileTestRight);	
-			}
-			kmerFileTestRight.close();
-			
-			databaseRight->setNumSeqs(templateSeqs.size());
-    
-		}else if (searchMethod == "blast") {
+		if (searchMethod == "kmer") { createKmerDBs(); }
+		else if (searchMethod == "blast") {
 		
 			//generate blastdb
-			databaseLeft = new BlastDB(m->getRootName(m->getSimpleName(fastafile)), -1.0, -1.0, 1, -3, blastlocation, threadID);
+			databaseLeft = new BlastDB();
 			
 			if (m->control_pressed) { return 0; }
 
@@ -263,6 +245,88 @@ int ChimeraSlayer::doPrep() {
 	}
 }
 //***************************************************************************************************************
+//reads the left and right kmer databases from their files, or generates them and writes the files if they are missing or old
+int ChimeraSlayer::createKmerDBs() {
+	try {
+		string 	kmerDBNameLeft;
+		string 	kmerDBNameRight;
+		
+		string templatePath = m->hasPath(templateFileName);
+		string rightTemplateFileName = templatePath + "right." + m->getRootName(m->getSimpleName(templateFileName));
+		databaseRight = new KmerDB(rightTemplateFileName, kmerSize);
+			
+		string leftTemplateFileName = templatePath + "left." + m->getRootName(m->getSimpleName(templateFileName));
+		databaseLeft = new KmerDB(leftTemplateFileName, kmerSize);	
+	
+		//leftside
+		kmerDBNameLeft = leftTemplateFileName.substr(0,leftTemplateFileName.find_last_of(".")+1) + char('0'+ kmerSize) + "mer";
+		ifstream kmerFileTestLeft(kmerDBNameLeft.c_str());
+		bool needToGenerateLeft = true;
+		
+		if(kmerFileTestLeft){	
+			bool GoodFile = m->checkReleaseVersion(kmerFileTestLeft, m->getVersion());
+			if (GoodFile) {  needToGenerateLeft = false;	}
+		}
+		
+		if(needToGenerateLeft){	
+		
+			for (int i = 0; i < templateSeqs.size(); i++) {
+				
+				if (m->control_pressed) { return 0; } 
+				
+				string leftFrag = templateSeqs[i]->getUnaligned();
+				leftFrag = leftFrag.substr(0, int(leftFrag.length() * 0.33));
+				
+				Sequence leftTemp(templateSeqs[i]->getName(), leftFrag);
+				databaseLeft->addSequence(leftTemp);	
+			}
+			databaseLeft->generateDB();
+			
+		}else {	
+			databaseLeft->readKmerDB(kmerFileTestLeft);	
+		}
+		kmerFileTestLeft.close();
+		
+		databaseLeft->setNumSeqs(templateSeqs.size());
+		
+		//rightside
+		kmerDBNameRight = rightTemplateFileName.substr(0,rightTemplateFileName.find_last_of(".")+1) + char('0'+ kmerSize) + "mer";
+		ifstream kmerFileTestRight(kmerDBNameRight.c_str());
+		bool needToGenerateRight = true;
+		
+		if(kmerFileTestRight){	
+			bool GoodFile = m->checkReleaseVersion(kmerFileTestRight, m->getVersion());
+			if (GoodFile) {  needToGenerateRight = false;	}
+		}
+		
+		if(needToGenerateRight){	
+		
+			for (int i = 0; i < templateSeqs.size(); i++) {
+				if (m->control_pressed) { return 0; } 
+				
+				string rightFrag = templateSeqs[i]->getUnaligned();
+				rightFrag = rightFrag.substr(int(rightFrag.length() * 0.66));
+				
+				Sequence rightTemp(templateSeqs[i]->getName(), rightFrag);
+				databaseRight->addSequence(rightTemp);	
+			}
+			databaseRight->generateDB();
+			
+		}else {	
+			databaseRight->readKmerDB(kmerFileTestRight);	
+		}
+		kmerFileTestRight.close();
+		
+		databaseRight->setNumSeqs(templateSeqs.size());
+		
+		return 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ChimeraSlayer", "createKmerDBs");
+		exit(1);
+	}
+}
+//***************************************************************************************************************
 vector<Sequence*> ChimeraSlayer::getTemplate(Sequence q, vector<Sequence*>& userTemplateFiltered) {
 	try {
 		
@@ -314,7 +378,7 @@ vector<Sequence*> ChimeraSlayer::getTemplate(Sequence q, vector<Sequence*>& user
 				Sequence leftTemp(userTemplate[i]->getName(), leftFrag);
 				databaseLeft->addSequence(leftTemp);	
 			}
-			databaseLeft->generateDB();
+			//the kmers are searched in memory, so generateDB is not called to write a database file for every query
 			databaseLeft->setNumSeqs(userTemplate.size());
 				
 			for (int i = 0; i < userTemplate.size(); i++) {
@@ -326,13 +390,12 @@ vector<Sequence*> ChimeraSlayer::getTemplate(Sequence q, vector<Sequence*>& user
 				Sequence rightTemp(userTemplate[i]->getName(), rightFrag);
 				databaseRight->addSequence(rightTemp);	
 			}
-			databaseRight->generateDB();
 			databaseRight->setNumSeqs(userTemplate.size());
 	
 		}else if (searchMethod == "blast") {
 			
 			//generate blastdb
-			databaseLeft = new BlastDB(m->getRootName(m->getSimpleName(templateFileName)), -1.0, -1.0, 1, -3, blastlocation, threadID);
+			databaseLeft = new BlastDB();
 			
 			if (m->control_pressed) { return userTemplate; }
 
@@ -354,8 +417,11 @@ vector<Sequence*> ChimeraSlayer::getTemplate(Sequence q, vector<Sequence*>& user
 ChimeraSlayer::~ChimeraSlayer() { 	
 	if (templateFileName != "self") {
 		if (searchMethod == "kmer") {  delete databaseRight;  delete databaseLeft;  }	
-		else if (searchMethod == "blast") {  delete databaseLeft; }
+		else if ((searchMethod == "blast") && !sharedTemplate) {  delete databaseLeft; }
 	}
+	
+	//so ~MothurChimera does not delete main's templates
+	if (sharedTemplate) { templateSeqs.clear(); filteredTemplateSeqs.clear(); }
 }
 //***************************************************************************************************************
 void ChimeraSlayer::printHeader(ostream& out) {
@@ -380,7 +446,6 @@ Sequence ChimeraSlayer::print(ostream& out, ostream& outAcc) {
 			
 			if (chimeraFlag == "yes") {	
 				if ((chimeraResults[0].bsa >= minBS) || (chimeraResults[0].bsb >= minBS)) {
-					m->mothurOut(querySeq.getName() + "\tyes"); m->mothurOutEndLine();
 					outAcc << querySeq.getName() << endl;
 					
 					if (templateFileName == "self") {  chimericSeqs.insert(querySeq.getName()); }
@@ -449,7 +514,6 @@ Sequence ChimeraSlayer::print(ostream& out, ostream& outAcc, data_results leftPi
 				if (leftPiece.flag == "yes") { if ((leftPiece.results[0].bsa >= minBS) || (leftPiece.results[0].bsb >= minBS))	{ leftChimeric = true;	} }
 				
 				if (rightChimeric || leftChimeric) {
-					m->mothurOut(querySeq.getName() + "\tyes"); m->mothurOutEndLine();
 					outAcc << querySeq.getName() << endl;
 					
 					if (templateFileName == "self") {  chimericSeqs.insert(querySeq.getName()); }
@@ -539,10 +603,7 @@ int ChimeraSlayer::getChimeras(Sequence* query) {
 		if (thisTemplate.size() == 0) {  return 0; } //not chimeric
 		
 		//moved this out of maligner - 4/29/11
-		vector<Sequence> refSeqs = getRefSeqs(*query, thisTemplate, thisFilteredTemplate);
-		
-		Maligner maligner(refSeqs, match, misMatch, divR, minSim, minCov); 
-		Slayer slayer(window, increment, minSim, divR, iters, minSNP, minBS);
+		vector<Sequence*> refSeqs = getRefSeqs(*query, thisTemplate, thisFilteredTemplate);
 		
 		if (templateFileName == "self") {
 			if (searchMethod == "kmer") {  delete databaseRight;  delete databaseLeft;  }	
@@ -551,7 +612,7 @@ int ChimeraSlayer::getChimeras(Sequence* query) {
 	
 		if (m->control_pressed) {  return 0;  }
 
-		string chimeraFlag = maligner.getResults(*query, decalc);
+		string chimeraFlag = maligner.getResults(*query, refSeqs, decalc);
 
 		if (m->control_pressed) {  return 0;  }
 		
@@ -779,16 +840,18 @@ string ChimeraSlayer::getBlock(data_struct data, string flag){
 	}
 }
 //***************************************************************************************************************
-vector<Sequence> ChimeraSlayer::getRefSeqs(Sequence q, vector<Sequence*>& thisTemplate, vector<Sequence*>& thisFilteredTemplate){
+//the parents are not copied, they point to the templates or closestSeqs
+vector<Sequence*> ChimeraSlayer::getRefSeqs(Sequence& q, vector<Sequence*>& thisTemplate, vector<Sequence*>& thisFilteredTemplate){
 	try {
 		
-		vector<Sequence> refSeqs;
+		vector<Sequence*> refSeqs;
 		
 		if (searchMethod == "distance") {
-			//find closest seqs to query in template - returns copies of seqs so trim does not destroy - remember to deallocate
+			//find closest seqs to query in template - returns copies of seqs so trim does not destroy
 			Sequence* newSeq = new Sequence(q.getName(), q.getAligned());
 			runFilter(newSeq);
-			refSeqs = decalc.findClosest(*newSeq, thisTemplate, thisFilteredTemplate, numWanted, minSim);
+			closestSeqs = decalc.findClosest(*newSeq, thisTemplate, thisFilteredTemplate, numWanted, minSim);
+			for (int i = 0; i < closestSeqs.size(); i++) { refSeqs.push_back(&closestSeqs[i]); }
 			delete newSeq;
 		}else if (searchMethod == "blast")  {
 			refSeqs = getBlastSeqs(q, thisTemplate, numWanted); //fills indexes
@@ -804,10 +867,10 @@ vector<Sequence> ChimeraSlayer::getRefSeqs(Sequence q, vector<Sequence*>& thisTe
 	}
 }
 //***************************************************************************************************************/
-vector<Sequence> ChimeraSlayer::getBlastSeqs(Sequence q, vector<Sequence*>& db, int num) {
+vector<Sequence*> ChimeraSlayer::getBlastSeqs(Sequence& q, vector<Sequence*>& db, int num) {
 	try {	
 		
-		vector<Sequence> refResults;
+		vector<Sequence*> refResults;
 		
 		//get parts of query
 		string queryUnAligned = q.getUnaligned();
@@ -817,8 +880,10 @@ vector<Sequence> ChimeraSlayer::getBlastSeqs(Sequence q, vector<Sequence*>& db,
 		Sequence* queryLeft = new Sequence(q.getName(), leftQuery);
 		Sequence* queryRight = new Sequence(q.getName(), rightQuery);
 		
-		vector<int> tempIndexesLeft = databaseLeft->findClosestMegaBlast(queryLeft, num+1, minSim);
-		vector<int> tempIndexesRight = databaseLeft->findClosestMegaBlast(queryRight, num+1, minSim);
+		//the blast database is shared by the threads, so the scores go in locals instead of the database
+		vector<float> scoresLeft, scoresRight;
+		vector<int> tempIndexesLeft = databaseLeft->findClosestMegaBlast(queryLeft, num+1, minSim, scoresLeft);
+		vector<int> tempIndexesRight = databaseLeft->findClosestMegaBlast(queryRight, num+1, minSim, scoresRight);
 				
 		
 		//cout << q->getName() << '\t' << leftQuery << '\t' << "leftMatches = " << tempIndexesLeft.size() << '\t' << rightQuery	<< " rightMatches = " << tempIndexesRight.size() << endl;
@@ -884,10 +949,7 @@ vector<Sequence> ChimeraSlayer::getBlastSeqs(Sequence q, vector<Sequence*>& db,
 		
 		for (int i = 0; i < mergedResults.size(); i++) {
 			//cout << q->getName() << mergedResults[i]  << '\t' << db[mergedResults[i]]->getName() << endl;	
-			if (db[mergedResults[i]]->getName() != q.getName()) { 
-				Sequence temp(db[mergedResults[i]]->getName(), db[mergedResults[i]]->getAligned());
-				refResults.push_back(temp);
-			}
+			if (db[mergedResults[i]]->getName() != q.getName()) { refResults.push_back(db[mergedResults[i]]); }
 		}
 		//cout << endl << endl;
 
@@ -902,9 +964,9 @@ vector<Sequence> ChimeraSlayer::getBlastSeqs(Sequence q, vector<Sequence*>& db,
 	}
 }
 //***************************************************************************************************************
-vector<Sequence> ChimeraSlayer::getKmerSeqs(Sequence q, vector<Sequence*>& db, int num) {
+vector<Sequence*> ChimeraSlayer::getKmerSeqs(Sequence& q, vector<Sequence*>& db, int num) {
 	try {	
-		vector<Sequence> refResults;
+		vector<Sequence*> refResults;
 		
 		//get parts of query
 		string queryUnAligned = q.getUnaligned();
@@ -969,11 +1031,7 @@ vector<Sequence> ChimeraSlayer::getKmerSeqs(Sequence q, vector<Sequence*>& db, i
 		
 		for (int i = 0; i < mergedResults.size(); i++) {
 			//cout << mergedResults[i]  << '\t' << db[mergedResults[i]]->getName() << endl;	
-			if (db[mergedResults[i]]->getName() != q.getName()) { 
-				Sequence temp(db[mergedResults[i]]->getName(), db[mergedResults[i]]->getAligned());
-				refResults.push_back(temp);
-				
-			}
+			if (db[mergedResults[i]]->getName() != q.getName()) { refResults.push_back(db[mergedResults[i]]); }
 		}
 
 		//cout << endl;		
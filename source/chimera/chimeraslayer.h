@@ -27,6 +27,7 @@ class ChimeraSlayer : public MothurChimera {
 		ChimeraSlayer(string, string, bool, string, int, int, int, int, float, int, int, int, int, int, int, int, int, bool, string, int);
 		ChimeraSlayer(string, string, bool, map<string, int>&, string,  int, int, int, int, float, int, int, int, int, int, int, int, int, bool, string, int);
 		ChimeraSlayer(string, string, bool, map<string, int>&, string,  int, int, int, int, float, int, int, int, int, int, int, int, int, bool, string, int, bool);
+		ChimeraSlayer(ChimeraSlayer*); //a copy for another thread, shares the templates and blast database of the one given
 
 		~ChimeraSlayer();
 		
@@ -37,16 +38,22 @@ class ChimeraSlayer : public MothurChimera {
 		int doPrep();
 		int getNumNoParents() { return numNoParents; }
 		data_results getResults() { return printResults; }
+		void setRandomEngine(mt19937_64* e) { slayer.setRandomEngine(e); }
+		void addChimericSeq(string name) { chimericSeqs.insert(name); } //for template=self, a sequence another thread found to be chimeric
 		
 	private:
 		Sequence querySeq;
 		Sequence trimQuery;
 		DeCalculator decalc;
+		Maligner maligner;
+		Slayer slayer;
 		Database* databaseRight;
 		Database* databaseLeft;
 		map<string, int> priority; //for template=self, seqname, seqAligned, abundance
 		set<string> chimericSeqs; //for template=self, so we don't add chimeric sequences to the userTemplate set
 		int numNoParents, threadID;
+		bool sharedTemplate; //templateSeqs, filteredTemplateSeqs and a blast database belong to the ChimeraSlayer this was copied from
+		vector<Sequence> closestSeqs; //parents found by a distance search
 	
 		vector<data_struct>  chimeraResults;
 		data_results printResults;
@@ -61,9 +68,10 @@ class ChimeraSlayer : public MothurChimera {
 		string getBlock(data_results, data_results, bool, bool, string);
 		//int readNameFile(string);
 		vector<Sequence*> getTemplate(Sequence, vector<Sequence*>&);
-		vector<Sequence> getRefSeqs(Sequence, vector<Sequence*>&, vector<Sequence*>&);
-		vector<Sequence> getBlastSeqs(Sequence, vector<Sequence*>&, int);
-		vector<Sequence> getKmerSeqs(Sequence, vector<Sequence*>&, int);
+		int createKmerDBs();
+		vector<Sequence*> getRefSeqs(Sequence&, vector<Sequence*>&, vector<Sequence*>&);
+		vector<Sequence*> getBlastSeqs(Sequence&, vector<Sequence*>&, int);
+		vector<Sequence*> getKmerSeqs(Sequence&, vector<Sequence*>&, int);
 		
 };
 
@@ -10,49 +10,39 @@
 #include "maligner.h"
 
 /***********************************************************************/ //int num, int match, int misMatch, , string mode, Database* dataLeft, Database* dataRight
-Maligner::Maligner(vector<Sequence> temp, int match, int misMatch, float div, int ms, int minCov) : db(temp), matchScore(match), misMatchPenalty(misMatch), minDivR(div), minSimilarity(ms), minCoverage(minCov) { 
+Maligner::Maligner(int match, int misMatch, float div, int ms, int minCov) : matchScore(match), misMatchPenalty(misMatch), minDivR(div), minSimilarity(ms), minCoverage(minCov) {
 			//numWanted(num),  , searchMethod(mode), databaseLeft(dataLeft), databaseRight(dataRight)
-			
-			m = MothurOut::getInstance(); 
-			
+
+			m = MothurOut::getInstance();
+			percentIdenticalQueryChimera = 0.0;
+			numRows = 0; numCols = 0;
 }
 /***********************************************************************/
-string Maligner::getResults(Sequence q, DeCalculator decalc) {
+//parents are the closest templates to the query, they are not changed
+string Maligner::getResults(Sequence& q, vector<Sequence*>& parents, DeCalculator& decalc) {
 	try {
-		
+
 		outputResults.clear();
-		
-		//make copy so trimming doesn't destroy query from calling class - remember to deallocate
+
+		//make copy so trimming doesn't destroy query from calling class
 		query.setName(q.getName()); query.setAligned(q.getAligned());
-		
+
 		string chimera;
-		
-		//copy refSeqs so that filter does not effect original
-		for(int i = 0; i < db.size(); i++) {  
-			Sequence newSeq(db[i].getName(), db[i].getAligned());
-			refSeqs.push_back(newSeq);
-		}
-		
-		refSeqs = minCoverageFilter(refSeqs);
-		
-		if (refSeqs.size() < 2)  { 
-			//for (int i = 0; i < refSeqs.size(); i++) {  delete refSeqs[i];	}
+
+		//copy the parents with enough coverage so that filter does not effect original
+		db = parents;
+		minCoverageFilter();
+
+		if (refSeqs.size() < 2)  {
 			percentIdenticalQueryChimera = 0.0;
-			return "unknown"; 
+			return "unknown";
 		}
-		
+
 		int chimeraPenalty = computeChimeraPenalty();
-	
+
 		//fills outputResults
 		chimera = chimeraMaligner(chimeraPenalty, decalc);
-		
-		if (m->control_pressed) { return chimera;  }
-				
-		//free memory
-		//delete query;
 
-		//for (int i = 0; i < refSeqs.size(); i++) {  delete refSeqs[i];	}
-		
 		return chimera;
 	}
 	catch(exception& e) {
@@ -61,107 +51,74 @@ string Maligner::getResults(Sequence q, DeCalculator decalc) {
 	}
 }
 /***********************************************************************/
-string Maligner::chimeraMaligner(int chimeraPenalty, DeCalculator decalc) {
+string Maligner::chimeraMaligner(int chimeraPenalty, DeCalculator& decalc) {
 	try {
-		
+
 		string chimera;
 		//trims seqs to first non gap char in all seqs and last non gap char in all seqs
-		spotMap = decalc.trimSeqs(query, refSeqs);
+		map<int, int> trimMap = decalc.trimSeqs(query, refSeqs);
 
 		//you trimmed the whole sequence, skip
 		if (query.getAligned() == "") { return "no"; }
 
-		vector<Sequence> temp = refSeqs;
-		temp.push_back(query);
-			
-		temp = verticalFilter(temp);
-		query = temp[temp.size()-1];
-		for (int i = 0; i < temp.size()-1; i++) {  refSeqs[i] = temp[i]; }
-		
-		//for (int i = 0; i < refSeqs.size(); i++) { cout << refSeqs[i]->getName() << endl ; }//<< refSeqs[i]->getAligned() << endl
+		verticalFilter(trimMap); //fills refAligned, spotMap and unalignedMap
+
+		buildScoreMatrix(refAligned[refSeqs.size()].length(), refSeqs.size()); //sizes and initializes
 
-		vector< vector<score_struct> > matrix = buildScoreMatrix(query.getAligned().length(), refSeqs.size()); //builds and initializes
-		
 		if (m->control_pressed) { return chimera;  }
-		
-		fillScoreMatrix(matrix, refSeqs, chimeraPenalty);
-		
-		vector<score_struct> path = extractHighestPath(matrix);
-		
+
+		fillScoreMatrix(chimeraPenalty);
+
+		vector<score_struct> path = extractHighestPath();
+
 		if (m->control_pressed) { return chimera;  }
-		
+
+		//nothing in the query matched any parent
+		if (path.size() == 0) { chimera = "no";	return chimera; }
+
 		vector<trace_struct> trace = mapTraceRegionsToAlignment(path);
-				
+
 		if (trace.size() > 1) {		chimera = "yes";	}
 		else { chimera = "no";	return chimera; }
-		
+
+		const string& queryAligned = refAligned[refSeqs.size()];
 		int traceStart = path[0].col;
-		int traceEnd = path[path.size()-1].col;	
-		string queryInRange = query.getAligned();
-		queryInRange = queryInRange.substr(traceStart, (traceEnd-traceStart+1));
-//		cout << queryInRange << endl;
-		string chimeraSeq = constructChimericSeq(trace, refSeqs);
-//		cout << chimeraSeq << endl;
-		
-//		cout << queryInRange.length() << endl;
-//		cout << chimeraSeq.length() << endl;
-		
+		int traceEnd = path[path.size()-1].col;
+		string queryInRange = queryAligned.substr(traceStart, (traceEnd-traceStart+1));
+		string chimeraSeq = constructChimericSeq(trace);
+
 		percentIdenticalQueryChimera = computePercentID(queryInRange, chimeraSeq);
-		
-//		cout << percentIdenticalQueryChimera << endl;
-	/*	
-		vector<trace_struct> trace = extractHighestPath(matrix);
-				
-		//cout << "traces\n";
-		//for(int i=0;i<trace.size();i++){
-		//	cout << trace[i].col << '\t' << trace[i].oldCol << '\t' << refSeqs[trace[i].row]->getName() << endl;
-		//}
-		
-		if (trace.size() > 1) {		chimera = "yes";	}
-		else { chimera = "no";	return chimera; }
-		
-		int traceStart = trace[0].col;
-		int traceEnd = trace[trace.size()-1].oldCol;	
-		string queryInRange = query->getAligned();
-		queryInRange = queryInRange.substr(traceStart, (traceEnd-traceStart));*/
-		
+
 		if (m->control_pressed) { return chimera;  }
-		
+
 		//save output results
 		for (int i = 0; i < trace.size(); i++) {
 			int regionStart = trace[i].col;
 			int regionEnd = trace[i].oldCol;
 			int seqIndex = trace[i].row;
-			
-//			cout << regionStart << '\t' << regionEnd << '\t' << seqIndex << endl;
+
 			results temp;
-			
+
 			temp.parent = refSeqs[seqIndex].getName();
-			temp.parentAligned = db[seqIndex].getAligned();
+			temp.parentAligned = db[seqIndex]->getAligned();
 			temp.nastRegionStart = spotMap[regionStart];
 			temp.nastRegionEnd = spotMap[regionEnd];
 			temp.regionStart = unalignedMap[regionStart];
 			temp.regionEnd = unalignedMap[regionEnd];
-			
-			string parentInRange = refSeqs[seqIndex].getAligned();
-			parentInRange = parentInRange.substr(traceStart, (traceEnd-traceStart+1));
-			
+
+			string parentInRange = refAligned[seqIndex].substr(traceStart, (traceEnd-traceStart+1));
+
 			temp.queryToParent = computePercentID(queryInRange, parentInRange);
 			temp.divR = (percentIdenticalQueryChimera / temp.queryToParent);
 
-			string queryInRegion = query.getAligned();
-			queryInRegion = queryInRegion.substr(regionStart, (regionEnd-regionStart+1));
-			
-			string parentInRegion = refSeqs[seqIndex].getAligned();
-			parentInRegion = parentInRegion.substr(regionStart, (regionEnd-regionStart+1));
-			
+			string queryInRegion = queryAligned.substr(regionStart, (regionEnd-regionStart+1));
+			string parentInRegion = refAligned[seqIndex].substr(regionStart, (regionEnd-regionStart+1));
+
 			temp.queryToParentLocal = computePercentID(queryInRegion, parentInRegion);
-			
-			//cout << query->getName() << '\t' << temp.parent << '\t' << "NAST:" << temp.nastRegionStart << '-' << temp.nastRegionEnd << " G:" << temp.queryToParent << " L:" << temp.queryToParentLocal << ", " <<  temp.divR << endl;
 
 			outputResults.push_back(temp);
 		}
-		
+
 		return chimera;
 	}
 	catch(exception& e) {
@@ -170,43 +127,39 @@ string Maligner::chimeraMaligner(int chimeraPenalty, DeCalculator decalc) {
 	}
 }
 /***********************************************************************/
-//removes top matches that do not have minimum coverage with query.
-vector<Sequence> Maligner::minCoverageFilter(vector<Sequence> ref){  
+//copies the parents that have minimum coverage with query into refSeqs.
+void Maligner::minCoverageFilter(){
 	try {
-		vector<Sequence> newRefs;
-		
+		refSeqs.clear();
+
 		string queryAligned = query.getAligned();
-		
-		for (int i = 0; i < ref.size(); i++) {
-			
-			string refAligned = ref[i].getAligned();
-			
+
+		for (int i = 0; i < db.size(); i++) {
+
+			string refAligned = db[i]->getAligned();
+
 			int numBases = 0;
 			int numCovered = 0;
-			
+
 			//calculate coverage
 			for (int j = 0; j < queryAligned.length(); j++) {
-				
+
 				if (isalpha(queryAligned[j])) {
 					numBases++;
-					
+
 					if (isalpha(refAligned[j])) {
 						numCovered++;
 					}
 				}
 			}
-			
+
 			int coverage = ((numCovered/(float)numBases)*100);
-			
+
 			//if coverage above minimum
 			if (coverage > minCoverage) {
-				newRefs.push_back(ref[i]);
-			}//else {
-				//delete ref[i];
-			//}
+				refSeqs.push_back(Sequence(db[i]->getName(), refAligned));
+			}
 		}
-		
-		return newRefs;
 	}
 	catch(exception& e) {
 		m->errorOut(e, "Maligner", "minCoverageFilter");
@@ -217,11 +170,11 @@ vector<Sequence> Maligner::minCoverageFilter(vector<Sequence> ref){
 // a breakpoint should yield fewer mismatches than this number with respect to the best parent sequence.
 int Maligner::computeChimeraPenalty() {
 	try {
-		
+
 		int numAllowable = ((1.0 - (1.0/minDivR)) * query.getNumBases());
 
 //		if(numAllowable < 1){	numAllowable = 1;	}
-		
+
 		int penalty = int(numAllowable + 1) * misMatchPenalty;
 
 		return penalty;
@@ -233,68 +186,64 @@ int Maligner::computeChimeraPenalty() {
 	}
 }
 /***********************************************************************/
-//this is a vertical filter
-vector<Sequence> Maligner::verticalFilter(vector<Sequence> seqs) {
+//this is a vertical filter, it removes the columns where the query and all the parents have gaps
+void Maligner::verticalFilter(map<int, int>& trimMap) {
 	try {
-		vector<int> gaps;	gaps.resize(query.getAligned().length(), 0);
-		
-		string filterString = (string(query.getAligned().length(), '1'));
-		
+		int numSeqs = refSeqs.size() + 1; //the parents and the query
+
+		refAligned.resize(numSeqs);
+		for (int i = 0; i < refSeqs.size(); i++) { refAligned[i] = refSeqs[i].getAligned(); }
+		refAligned[numSeqs-1] = query.getAligned();
+
+		int alignLength = refAligned[numSeqs-1].length();
+		vector<int> gaps(alignLength, 0);
+
 		//for each sequence
-		for (int i = 0; i < seqs.size(); i++) {
-		
-			string seqAligned = seqs[i].getAligned();
-			
+		for (int i = 0; i < numSeqs; i++) {
+			const string& seqAligned = refAligned[i];
+
 			for (int j = 0; j < seqAligned.length(); j++) {
 				//if this spot is a gap
 				if ((seqAligned[j] == '-') || (seqAligned[j] == '.'))	{	gaps[j]++;	}
 			}
 		}
-		
-		//zero out spot where all sequences have blanks
-		int numColRemoved = 0;
-		for(int i = 0; i < seqs[0].getAligned().length(); i++){
-			if(gaps[i] == seqs.size())	{	filterString[i] = '0'; 	numColRemoved++;  }
+
+		//keep the spots where any sequence has a base
+		vector<int> keep;
+		spotMap.clear();
+		for(int i = 0; i < alignLength; i++){
+			if(gaps[i] != numSeqs)	{
+				keep.push_back(i);
+				map<int, int>::iterator it = trimMap.find(i);
+				if (it != trimMap.end()) { spotMap.push_back(it->second); }
+				else { spotMap.push_back(0); }
+			}
 		}
-		
-		map<int, int> newMap;
+
 		//for each sequence
-		for (int i = 0; i < seqs.size(); i++) {
-		
-			string seqAligned = seqs[i].getAligned();
-			string newAligned = "";
-			int count = 0;
-			
-			for (int j = 0; j < seqAligned.length(); j++) {
-				//if this spot is not a gap
-				if (filterString[j] == '1') { 
-					newAligned += seqAligned[j]; 
-					newMap[count] = spotMap[j];
-					count++;
-				}
-			}
-			
-			seqs[i].setAligned(newAligned);
+		string newAligned;
+		for (int i = 0; i < numSeqs; i++) {
+			newAligned.resize(keep.size());
+			for (int j = 0; j < keep.size(); j++) { newAligned[j] = refAligned[i][keep[j]]; }
+
+			//setAligned marks end gaps as missing data, so the filtered strings are read back
+			if (i < refSeqs.size()) { refSeqs[i].setAligned(newAligned); refAligned[i] = refSeqs[i].getAligned(); }
+			else { query.setAligned(newAligned); refAligned[i] = query.getAligned(); }
 		}
-		
-		string query = seqs[seqs.size()-1].getAligned();
-		int queryLength = query.length();
-		
-		unalignedMap.resize(queryLength, 0);
-		
-		
+
+		const string& queryAligned = refAligned[numSeqs-1];
+		int queryLength = queryAligned.length();
+
+		unalignedMap.assign(queryLength, 0);
+
 		for(int i=1;i<queryLength;i++){
-			if(query[i] != '.' && query[i] != '-'){
+			if(queryAligned[i] != '.' && queryAligned[i] != '-'){
 				unalignedMap[i] = unalignedMap[i-1] + 1;
 			}
 			else{
 				unalignedMap[i] = unalignedMap[i-1];
 			}
 		}
-		
-		spotMap = newMap;
-		
-		return seqs;
 	}
 	catch(exception& e) {
 		m->errorOut(e, "Maligner", "verticalFilter");
@@ -302,26 +251,15 @@ vector<Sequence> Maligner::verticalFilter(vector<Sequence> seqs) {
 	}
 }
 //***************************************************************************************************************
-vector< vector<score_struct> > Maligner::buildScoreMatrix(int cols, int rows) {
+//sizes the score matrix for this query, the space is kept for the next query
+void Maligner::buildScoreMatrix(int cols, int rows) {
 	try{
-		
-		vector< vector<score_struct> > m(rows);
-		
-		for (int i = 0; i < rows; i++) {
-			for (int j = 0; j < cols; j++) {
-				
-				//initialize each cell
-				score_struct temp;
-				temp.prev = -1;
-				temp.score = -9999999;
-				temp.col = j;
-				temp.row = i;
-				
-				m[i].push_back(temp);
-			}
-		}
-		
-		return m;
+		numCols = cols;
+		numRows = rows;
+
+		//initialize each cell
+		scores.assign(numRows*numCols, -9999999);
+		prevs.assign(numRows*numCols, -1);
 	}
 	catch(exception& e) {
 		m->errorOut(e, "Maligner", "buildScoreMatrix");
@@ -330,97 +268,81 @@ vector< vector<score_struct> > Maligner::buildScoreMatrix(int cols, int rows) {
 }
 
 //***************************************************************************************************************
-
-void Maligner::fillScoreMatrix(vector<vector<score_struct> >& ms, vector<Sequence> seqs, int penalty) {
+//A cell's score is its match or mismatch score plus the best score in the previous column, less the penalty when
+//the best is another parent. Only the best and second best scores in the previous column can be the best for a row,
+//so each column takes one pass over the rows. Ties go to the lower row and a score below 0 is 0 from row 0, the same
+//as comparing every row of the previous column in order.
+void Maligner::fillScoreMatrix(int penalty) {
 	try{
-		
-		//get matrix dimensions
-		int numCols = query.getAligned().length();
-		int numRows = seqs.size();
-		
-//		cout << numRows << endl;
-		
+
+		const string& queryAligned = refAligned[numRows];
+
 		//initialize first col
-		string queryAligned = query.getAligned();
 		for (int i = 0; i < numRows; i++) {
-			string subjectAligned = seqs[i].getAligned();
-			
+			const string& subjectAligned = refAligned[i];
+
 			//are you both gaps?
 			if ((!isalpha(queryAligned[0])) && (!isalpha(subjectAligned[0]))) {
-				ms[i][0].score = 0;
-//				ms[i][0].mismatches = 0;
+				scores[i] = 0;
 			}else if (queryAligned[0] == subjectAligned[0])  { //|| subjectAligned[0] == 'N')
-				ms[i][0].score = matchScore;
-//				ms[i][0].mismatches = 0;
+				scores[i] = matchScore;
 			}else{
-				ms[i][0].score = 0;
-//				ms[i][0].mismatches = 1;
+				scores[i] = 0;
 			}
 		}
-		
+
 		//fill rest of matrix
 		for (int j = 1; j < numCols; j++) {  //iterate through matrix columns
-		
-//			for (int i = 0; i < 1; i++) {  //iterate through matrix rows
+
+			const int* prevScores = &scores[(j-1)*numRows];
+			int* colScores = &scores[j*numRows];
+			int* colPrevs = &prevs[j*numRows];
+
+			//rows with the best and second best scores in the previous column
+			int best = 0;
+			int second = -1;
+			for (int i = 1; i < numRows; i++) {
+				if (prevScores[i] > prevScores[best]) { second = best; best = i; }
+				else if ((second == -1) || (prevScores[i] > prevScores[second])) { second = i; }
+			}
+
+			char queryChar = queryAligned[j];
+
 			for (int i = 0; i < numRows; i++) {  //iterate through matrix rows
-				
-				string subjectAligned = seqs[i].getAligned();
-				
+
+				char subjectChar = refAligned[i][j];
+
 				int matchMisMatchScore = 0;
 				//are you both gaps?
-				if ((!isalpha(queryAligned[j])) && (!isalpha(subjectAligned[j]))) {
+				if ((!isalpha(queryChar)) && (!isalpha(subjectChar))) {
 					//leave the same
-				}else if ((toupper(queryAligned[j]) == 'N') || (toupper(subjectAligned[j]) == 'N')) {
+				}else if ((toupper(queryChar) == 'N') || (toupper(subjectChar) == 'N')) {
 					//leave the same
-				}else if (queryAligned[j] == subjectAligned[j]) {
+				}else if (queryChar == subjectChar) {
 					matchMisMatchScore = matchScore;
-				}else if (queryAligned[j] != subjectAligned[j]) {
+				}else {
 					matchMisMatchScore = misMatchPenalty;
 				}
 
-				//compute score based on previous columns scores
-				for (int prevIndex = 0; prevIndex < numRows; prevIndex++) { //iterate through rows
-					
-					int sumScore = matchMisMatchScore + ms[prevIndex][j-1].score;
-					
-					//you are not at yourself
-					if (prevIndex != i) {   sumScore += penalty;	}
-					if (sumScore < 0)	{	sumScore = 0;			}
-					
-					if (sumScore > ms[i][j].score) {
-						ms[i][j].score = sumScore;
-						ms[i][j].prev = prevIndex;
-					}
+				//stay on this parent
+				int score = matchMisMatchScore + prevScores[i];
+				int prev = i;
+
+				//or jump from the best other parent
+				if (numRows > 1) {
+					int other = best;
+					if (other == i) { other = second; }
+
+					int otherScore = matchMisMatchScore + prevScores[other] + penalty;
+					if ((otherScore > score) || ((otherScore == score) && (other < i))) { score = otherScore; prev = other; }
 				}
-//				cout << i << '\t' << j << '\t' << queryAligned[j] << '\t' << subjectAligned[j] << '\t' << matchMisMatchScore << '\t' << ms[i][j].score << endl;
 
+				if (score <= 0) { score = 0; prev = 0; }
+
+				colScores[i] = score;
+				colPrevs[i] = prev;
 			}
-			
 		}
-		
-		
-		
-		
-		
-//		cout << numRows << '\t' << numCols << endl;
-//		for(int i=0;i<numRows;i++){
-//			cout << seqs[i]->getName();
-//			for(int j=0;j<numCols;j++){
-//				cout << '\t' << ms[i][j].score;
-//			}
-//			cout << endl;
-//		}
-//		cout << endl;
-//		
-//		for(int i=0;i<numRows;i++){
-//			cout << seqs[i]->getName();
-//			for(int j=0;j<numCols;j++){
-//				cout << '\t' << ms[i][j].prev;
-//			}
-//			cout << endl;
-//		}
-		
-		
 	}
 	catch(exception& e) {
 		m->errorOut(e, "Maligner", "fillScoreMatrix");
@@ -428,49 +350,46 @@ void Maligner::fillScoreMatrix(vector<vector<score_struct> >& ms, vector<Sequenc
 	}
 }
 //***************************************************************************************************************
-vector<score_struct> Maligner::extractHighestPath(vector<vector<score_struct> > ms) {
+vector<score_struct> Maligner::extractHighestPath() {
 	try {
-		
-		//get matrix dimensions
-		int numCols = query.getAligned().length();
-		int numRows = ms.size();
-		
-		
+
 		//find highest score scoring matrix
-		score_struct highestStruct;
 		int highestScore = 0;
-		
+		int rowIndex = 0;
+		int pos = 0;
+
 		for (int i = 0; i < numRows; i++) {
 			for (int j = 0; j < numCols; j++) {
-				if (ms[i][j].score > highestScore) {
-					highestScore = ms[i][j].score;
-					highestStruct = ms[i][j];
+				if (scores[j*numRows+i] > highestScore) {
+					highestScore = scores[j*numRows+i];
+					rowIndex = i;
+					pos = j;
 				}
 			}
 		}
-		
+
 		vector<score_struct> path;
-		
-		int rowIndex = highestStruct.row;
-		int pos = highestStruct.col;
-		int score = highestStruct.score;
 
-//		cout << rowIndex << '\t' << pos << '\t' << score << endl;
-		
+		int score = highestScore;
+
 		while (pos >= 0 && score > 0) {
-			score_struct temp = ms[rowIndex][pos];
+			score_struct temp;
+			temp.row = rowIndex;
+			temp.col = pos;
+			temp.score = scores[pos*numRows+rowIndex];
+			temp.prev = prevs[pos*numRows+rowIndex];
 			score = temp.score;
-			
+
 			if (score > 0) {	path.push_back(temp);	}
-			
+
 			rowIndex = temp.prev;
 			pos--;
 		}
-		
+
 		reverse(path.begin(), path.end());
-		
+
 		return path;
-		
+
 	}
 	catch(exception& e) {
 		m->errorOut(e, "Maligner", "extractHighestPath");
@@ -478,43 +397,43 @@ vector<score_struct> Maligner::extractHighestPath(vector<vector<score_struct> >
 	}
 }
 //***************************************************************************************************************
-vector<trace_struct> Maligner::mapTraceRegionsToAlignment(vector<score_struct> path) {
+vector<trace_struct> Maligner::mapTraceRegionsToAlignment(vector<score_struct>& path) {
 	try {
 		vector<trace_struct> trace;
-		
+
 		int region_index = path[0].row;
 		int region_start = path[0].col;
-		
+
 		for (int i = 1; i < path.size(); i++) {
-			
+
 			int next_region_index = path[i].row;
 			//cout << i << '\t' << next_region_index << endl;
 
 			if (next_region_index != region_index) {
-				
+
 				// add trace region
 				int col_index = path[i].col;
 				trace_struct temp;
 				temp.col = region_start;
 				temp.oldCol = col_index-1;
 				temp.row = region_index;
-				
+
 				trace.push_back(temp);
-				
+
 				region_index = path[i].row;
 				region_start = col_index;
 			}
 		}
-		
+
 		// get last one
 		trace_struct temp;
 		temp.col = region_start;
 		temp.oldCol = path[path.size()-1].col;
 		temp.row = region_index;
 		trace.push_back(temp);
-		
+
 		return trace;
-		
+
 	}
 	catch(exception& e) {
 		m->errorOut(e, "Maligner", "mapTraceRegionsToAlignment");
@@ -666,16 +585,14 @@ vector<trace_struct> Maligner::mapTraceRegionsToAlignment(vector<score_struct> p
 */
 //***************************************************************************************************************
 
-string Maligner::constructChimericSeq(vector<trace_struct> trace, vector<Sequence> seqs) {
+string Maligner::constructChimericSeq(vector<trace_struct>& trace) {
 	try {
 		string chimera = "";
 		
 		for (int i = 0; i < trace.size(); i++) {
 //			cout << i << '\t' << trace[i].row << '\t' << trace[i].col << '\t' << trace[i].oldCol << endl;
 			
-			string seqAlign = seqs[trace[i].row].getAligned();
-			seqAlign = seqAlign.substr(trace[i].col, (trace[i].oldCol-trace[i].col+1));
-			chimera += seqAlign;
+			chimera += refAligned[trace[i].row].substr(trace[i].col, (trace[i].oldCol-trace[i].col+1));
 		}
 //		cout << chimera << endl;
 //		if (chimera != "") { chimera = chimera.substr(0, (chimera.length()-1)); }	//this was introducing a fence post error
@@ -690,7 +607,7 @@ string Maligner::constructChimericSeq(vector<trace_struct> trace, vector<Sequenc
 
 //***************************************************************************************************************
 
-string Maligner::constructAntiChimericSeq(vector<trace_struct> trace, vector<Sequence> seqs) {
+string Maligner::constructAntiChimericSeq(vector<trace_struct>& trace) {
 	try {
 		string antiChimera = "";
 		
@@ -699,9 +616,7 @@ string Maligner::constructAntiChimericSeq(vector<trace_struct> trace, vector<Seq
 			
 			int oppositeIndex = trace.size() - i - 1;
 			
-			string seqAlign = seqs[trace[oppositeIndex].row].getAligned();
-			seqAlign = seqAlign.substr(trace[i].col, (trace[i].oldCol-trace[i].col+1));
-			antiChimera += seqAlign;
+			antiChimera += refAligned[trace[oppositeIndex].row].substr(trace[i].col, (trace[i].oldCol-trace[i].col+1));
 		}
 		
 		return antiChimera;
@@ -713,7 +628,7 @@ string Maligner::constructAntiChimericSeq(vector<trace_struct> trace, vector<Seq
 }
 
 //***************************************************************************************************************
-float Maligner::computePercentID(string queryAlign, string chimera) {
+float Maligner::computePercentID(const string& queryAlign, const string& chimera) {
 	try {
 	
 		if (queryAlign.length() != chimera.length()) {
@@ -20,35 +20,41 @@ class Maligner {
 
 	public:
 		
-		Maligner(vector<Sequence>, int, int, float, int, int); //int, int, int, , string, Database*, Database*
+		Maligner(int, int, float, int, int); //match, misMatch, divR, minSim, minCov
 		~Maligner() {};
 		
-		string getResults(Sequence, DeCalculator);
+		string getResults(Sequence&, vector<Sequence*>&, DeCalculator&);
 		float getPercentID() {	return percentIdenticalQueryChimera;	}
 		vector<results> getOutput()  {	return outputResults;			}
 		
 				
 	private:
 		Sequence query;
-		vector<Sequence> refSeqs;
-		vector<Sequence> db;
+		vector<Sequence*> db;
 		int minCoverage, minSimilarity, matchScore, misMatchPenalty;
 		float minDivR, percentIdenticalQueryChimera;
 		vector<results> outputResults;
-		map<int, int> spotMap;
+		vector<int> spotMap;
 		vector<int> unalignedMap;
-		vector<Sequence> minCoverageFilter(vector<Sequence>);  //removes top matches that do not have minimum coverage with query.
+		
+		//workspace kept from query to query, so checking a sequence does not allocate once it has seen one as long
+		vector<Sequence> refSeqs;		//copies of the parents that cover the query, trimmed and filtered
+		vector<string> refAligned;		//their aligned strings, followed by the query's
+		vector<int> scores, prevs;		//the score matrix, column j row i is at j*numRows+i
+		int numRows, numCols;
+		
+		void minCoverageFilter();  //copies the parents that have minimum coverage with query into refSeqs.
 		int computeChimeraPenalty();
-		vector<Sequence> verticalFilter(vector<Sequence>);
+		void verticalFilter(map<int, int>&);
 		
-		vector< vector<score_struct> > buildScoreMatrix(int, int);
-		void fillScoreMatrix(vector<vector<score_struct> >&, vector<Sequence>, int);
-		vector<score_struct> extractHighestPath(vector<vector<score_struct> >);
-		vector<trace_struct> mapTraceRegionsToAlignment(vector<score_struct>);
-		string constructChimericSeq(vector<trace_struct>, vector<Sequence>);
-		string constructAntiChimericSeq(vector<trace_struct>, vector<Sequence>);
-		float computePercentID(string, string);
-		string chimeraMaligner(int, DeCalculator);
+		void buildScoreMatrix(int, int);
+		void fillScoreMatrix(int);
+		vector<score_struct> extractHighestPath();
+		vector<trace_struct> mapTraceRegionsToAlignment(vector<score_struct>&);
+		string constructChimericSeq(vector<trace_struct>&);
+		string constructAntiChimericSeq(vector<trace_struct>&);
+		float computePercentID(const string&, const string&);
+		string chimeraMaligner(int, DeCalculator&);
 		MothurOut* m;
 		
 };
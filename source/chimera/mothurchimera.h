@@ -53,7 +53,7 @@ struct data_results {
 };
 /***********************************************************************/
 //sorts lowest to highest first by bsMax, then if tie by chimeraMax
-inline bool compareDataStruct(data_struct left, data_struct right){
+inline bool compareDataStruct(const data_struct& left, const data_struct& right){
 	if (left.bsMax < right.bsMax) { return true; }
 	else if (left.bsMax == right.bsMax) {
 		return (left.chimeraMax < right.chimeraMax);
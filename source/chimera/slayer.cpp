@@ -11,98 +11,80 @@
 
 /***********************************************************************/
 Slayer::Slayer(int win, int increment, int parentThreshold, float div, int i, int snp, int mi) :
-		minBS(mi), windowSize(win), windowStep(increment), parentFragmentThreshold(parentThreshold), divRThreshold(div), iters(i), percentSNPSample(snp){ m = MothurOut::getInstance(); }
+		minBS(mi), window(win), windowSize(win), windowStep(increment), parentFragmentThreshold(parentThreshold), divRThreshold(div), iters(i), percentSNPSample(snp){ m = MothurOut::getInstance(); randomEngine = NULL; baseSpots.resize(3); }
 /***********************************************************************/
-string Slayer::getResults(Sequence query, vector<Sequence> refSeqs) {
+string Slayer::getResults(Sequence& q, vector<Sequence>& refSeqs) {
 	try {
 		vector<data_struct> all; all.clear();
-		myQuery = query;
+
+		//the window size is reset for each query
+		windowSize = window;
+
+		string queryAligned = q.getAligned();
+		vector<string> refAligned(refSeqs.size());
+		for (int i = 0; i < refSeqs.size(); i++) { refAligned[i] = refSeqs[i].getAligned(); }
 
 		for (int i = 0; i < refSeqs.size(); i++) {
-		
+
 			for (int j = i+1; j < refSeqs.size(); j++) {
-			
+
 				if (m->control_pressed) { return "no";  }
-	
-				//make copies of query and each parent because runBellerophon removes gaps and messes them up
-				Sequence q(query.getName(), query.getAligned());
-				Sequence leftParent(refSeqs[i].getName(), refSeqs[i].getAligned());
-				Sequence rightParent(refSeqs[j].getName(), refSeqs[j].getAligned());
-				
-				//cout << q->getName() << endl << q->getAligned() << endl << endl;	
-				//cout << leftParent.getName() << '\t' << leftParent.getAligned().length() << endl << endl;
-				//cout << rightParent.getName() << '\t' << rightParent.getAligned().length() << endl << endl;
-				//cout << q.getName() << '\t' << q.getAligned().length() << endl << endl;
-				//cout << rightParent->getName() << endl << rightParent->getAligned() << endl << endl;	
-				//cout << " length = " << rightParent->getAligned().length() << endl;
-	
-				map<int, int> spots;  //map from spot in original sequence to spot in filtered sequence for query and both parents
-				vector<data_struct> divs = runBellerophon(q, leftParent, rightParent, spots);
-	
+
+				//removes the gaps from copies of query and each parent, fills spots
+				verticalFilter(queryAligned, refAligned[i], refAligned[j]);
+
+				vector<data_struct> divs = runBellerophon();
+
 				if (m->control_pressed) { return "no"; }
-//				cout << "examining:\t" << refSeqs[i]->getName() << '\t' << refSeqs[j]->getName() << endl;
-				vector<data_struct> selectedDivs;
+
 				for (int k = 0; k < divs.size(); k++) {
-					
-					vector<snps> snpsLeft = getSNPS(divs[k].parentA.getAligned(), divs[k].querySeq.getAligned(), divs[k].parentB.getAligned(), divs[k].winLStart, divs[k].winLEnd);
-					vector<snps> snpsRight = getSNPS(divs[k].parentA.getAligned(), divs[k].querySeq.getAligned(), divs[k].parentB.getAligned(), divs[k].winRStart, divs[k].winREnd);
-	
+
+					getSNPS(divs[k].winLStart, divs[k].winLEnd, snpsLeft);
+					getSNPS(divs[k].winRStart, divs[k].winREnd, snpsRight);
+
 					if (m->control_pressed) {  return "no"; }
-					
+
 					int numSNPSLeft = snpsLeft.size();
 					int numSNPSRight = snpsRight.size();
-					
-//					cout << numSNPSLeft << '\t' << numSNPSRight << endl;
+
 					//require at least 4 SNPs on each side of the break
 					if ((numSNPSLeft >= 4) && (numSNPSRight >= 4)) {
-							
+
 						float BS_A, BS_B;
 						bootstrapSNPS(snpsLeft, snpsRight, BS_A, BS_B, iters);
-						
+
 						if (m->control_pressed) { return "no"; }
 
 						divs[k].bsa = BS_A;
 						divs[k].bsb = BS_B;
 						divs[k].bsMax = max(BS_A, BS_B);
 						divs[k].chimeraMax = max(divs[k].qla_qrb, divs[k].qlb_qra);
-						
-						
-						//are we within 10 points of the bootstrap cutoff?
-//						if ((divs[k].bsMax >= (minBS-10)) && (iters < 1000)) {
-//							bootstrapSNPS(snpsLeft, snpsRight, BS_A, BS_B, 1000);
-//								
-//							if (m->control_pressed) { delete q; delete leftParent; delete rightParent; return "no"; }
-//								
-//							divs[k].bsa = BS_A;
-//							divs[k].bsb = BS_B;
-//							divs[k].bsMax = max(BS_A, BS_B);
-//							divs[k].chimeraMax = max(divs[k].qla_qrb, divs[k].qlb_qra);
-//						}
-						
+
 						//so results reflect orignal alignment
 						divs[k].winLStart = spots[divs[k].winLStart];
-						divs[k].winLEnd = spots[divs[k].winLEnd];  
-						divs[k].winRStart = spots[divs[k].winRStart]; 
-						divs[k].winREnd = spots[divs[k].winREnd]; 
-						
-						selectedDivs.push_back(divs[k]);
+						divs[k].winLEnd = spots[divs[k].winLEnd];
+						divs[k].winRStart = spots[divs[k].winRStart];
+						divs[k].winREnd = spots[divs[k].winREnd];
+
+						divs[k].querySeq = Sequence(q.getName(), query);
+						divs[k].parentA = Sequence(refSeqs[i].getName(), parentA);
+						divs[k].parentB = Sequence(refSeqs[j].getName(), parentB);
+
+						all.push_back(divs[k]);
 					}
 				}
-
-				//save selected
-				for (int mi = 0; mi < selectedDivs.size(); mi++) {  all.push_back(selectedDivs[mi]);	}
 			}
 		}
-		
+
 
 		// compute bootstrap support
 		if (all.size() > 0) {
 			//sort them
 			sort(all.begin(), all.end(), compareDataStruct);
 			reverse(all.begin(), all.end());
-						
+
 			outputResults = all;
-			return "yes"; 
+			return "yes";
 		}else {
 			outputResults = all;
 			return "no";
@@ -114,117 +96,95 @@ string Slayer::getResults(Sequence query, vector<Sequence> refSeqs) {
 	}
 }
 /***********************************************************************/
-vector<data_struct> Slayer::runBellerophon(Sequence q, Sequence pA, Sequence pB, map<int, int>& spots) {
+//the windows of the filtered query and parents that could be a breakpoint. The sequences are left out of the
+//results, getResults adds them to the windows it keeps.
+vector<data_struct> Slayer::runBellerophon() {
 	try{
-		
+
 		vector<data_struct> data;
-		
-		//vertical filter
-		//cout << q.getName() << endl << q.getAligned() << endl << endl;	
-		//cout << pA.getName() << endl << pA.getUnaligned() << endl << endl;		
-		//cout << pB.getName() << endl << pB.getUnaligned() << endl << endl;	
-		
-		//maps spot in new alignment to spot in alignment before filter
-		spots = verticalFilter(q, pA, pB);  //fills baseSpots
-		
-		//get these to avoid numerous function calls
-		string query = q.getAligned();
-		string parentA = pA.getAligned();
-		string parentB = pB.getAligned();
+
 		int length = query.length();
-//cout << q.getName() << endl << q.getAligned() << endl << endl;	
-//cout << pA.getName() << endl << pA.getUnaligned() << endl << endl;		
-//cout << pB.getName() << endl << pB.getUnaligned() << endl << endl;	
-//cout << " length = " << length << endl;
-	
+
 		//check window size
-		if (length < (2*windowSize+windowStep)) { 
-//			m->mothurOut("Your window size is too large for " + q->getName() + ". I will make the window size " + toString(length/4) + " which is 1/4 the filtered length."); m->mothurOutEndLine();	
+		if (length < (2*windowSize+windowStep)) {
+//			m->mothurOut("Your window size is too large for " + q->getName() + ". I will make the window size " + toString(length/4) + " which is 1/4 the filtered length."); m->mothurOutEndLine();
 			windowSize = length / 4;
 		}
-		
+
+		//each window's percent identities come from the running counts, so a window takes the same time however long it is
+		countIdentities(query, parentA, sumsQA);
+		countIdentities(query, parentB, sumsQB);
+		countIdentities(parentA, parentB, sumsAB);
+
 		for (int i = windowSize-1; i <= (length - windowSize); i += windowStep) {
-		
+
 			if (m->control_pressed) { return data; }
-		
+
 			int breakpoint = i;
 			int leftLength = breakpoint + 1;
 			int rightLength = length - leftLength;
-				
-			float QLA = computePercentID(query, parentA, 0, breakpoint);
-			float QRB = computePercentID(query, parentB, breakpoint+1, length-1);
-		
-			float QLB = computePercentID(query, parentB, 0, breakpoint);
-			float QRA = computePercentID(query, parentA, breakpoint+1, length-1);
-		
-			float LAB = computePercentID(parentA, parentB, 0, breakpoint);
-			float RAB = computePercentID(parentA, parentB, breakpoint+1, length-1);	
-			
+
+			float QLA = computePercentID(sumsQA, 0, breakpoint);
+			float QRB = computePercentID(sumsQB, breakpoint+1, length-1);
+
+			float QLB = computePercentID(sumsQB, 0, breakpoint);
+			float QRA = computePercentID(sumsQA, breakpoint+1, length-1);
+
+			float LAB = computePercentID(sumsAB, 0, breakpoint);
+			float RAB = computePercentID(sumsAB, breakpoint+1, length-1);
+
 			float AB = ((LAB*leftLength) + (RAB*rightLength)) / (float) length;
 			float QA = ((QLA*leftLength) + (QRA*rightLength)) / (float) length;
 			float QB = ((QLB*leftLength) + (QRB*rightLength)) / (float) length;
-		
+
 			float QLA_QRB = ((QLA*leftLength) + (QRB*rightLength)) / (float) length;
 			float QLB_QRA = ((QLB*leftLength) + (QRA*rightLength)) / (float) length;
-		
+
 			//in original and not used
 			//float avgQA_QB = ((QA*leftLength) + (QB*rightLength)) / (float) length;
-		
+
 			float divR_QLA_QRB = min((QLA_QRB/QA), (QLA_QRB/QB));
 			float divR_QLB_QRA = min((QLB_QRA/QA), (QLB_QRA/QB));
-			
-			
-			//cout << q->getName() << '\t';
-			//cout << pA->getName() << '\t';
-			//cout << pB->getName() << '\t';
-		    //cout << "bp: " << breakpoint << " CHIM_TYPE_A\t" << divR_QLA_QRB << "\tQLA: " << QLA << "\tQRB: " << QRB << "\tQLA_QRB: " << QLA_QRB;
-			//cout << "\tCHIM_TYPE_B\t" << divR_QLB_QRA << "\tQLB: " << QLB << "\tQRA: " << QRA << "\tQLB_QRA: " << QLB_QRA << endl;
-//cout << leftLength << '\t' << rightLength << '\t' << QLA << '\t' << QRB << '\t' << QLB << '\t' << QRA  << '\t' << LAB << '\t' << RAB << '\t' << AB << '\t' << QA << '\t' << QB << '\t' << QLA_QRB << '\t' <<  QLB_QRA <<    endl;    		
-
-//cout << divRThreshold << endl;
-//cout << breakpoint << '\t' << divR_QLA_QRB << '\t' << divR_QLB_QRA << endl;
-			//is one of them above the 
+
+			//is one of them above the
 			if (divR_QLA_QRB >= divRThreshold || divR_QLB_QRA >= divRThreshold) {
-				
+
 				if (((QLA_QRB > QA) && (QLA_QRB > QB) && (QLA >= parentFragmentThreshold) && (QRB >= parentFragmentThreshold))  ||
 					((QLB_QRA > QA) && (QLB_QRA > QB) && (QLB >=parentFragmentThreshold) && (QRA >= parentFragmentThreshold)))  {
-					
+
 					data_struct member;
-					
+
 					member.divr_qla_qrb = divR_QLA_QRB;
 					member.divr_qlb_qra = divR_QLB_QRA;
 					member.qla_qrb = QLA_QRB;
 					member.qlb_qra = QLB_QRA;
 					member.qla = QLA;
 					member.qrb = QRB;
-					member.ab = AB; 
+					member.ab = AB;
 					member.qa = QA;
-					member.qb = QB; 
-					member.lab = LAB; 
-					member.rab = RAB; 
-					member.qra = QRA; 
-					member.qlb = QLB; 
+					member.qb = QB;
+					member.lab = LAB;
+					member.rab = RAB;
+					member.qra = QRA;
+					member.qlb = QLB;
 					member.winLStart = 0;
-					member.winLEnd = breakpoint;  
-					member.winRStart = breakpoint+1; 
-					member.winREnd = length-1; 
-					member.querySeq = q;
-					member.parentA = pA;
-					member.parentB = pB;
+					member.winLEnd = breakpoint;
+					member.winRStart = breakpoint+1;
+					member.winREnd = length-1;
 					member.bsa = 0;
 					member.bsb = 0;
 					member.bsMax = 0;
 					member.chimeraMax = 0;
-					
+
 					data.push_back(member);
-					
+
 				}//if
 			}//if
 		}//for
-		
-		
+
+
 		return data;
-		
+
 	}
 	catch(exception& e) {
 		m->errorOut(e, "Slayer", "runBellerophon");
@@ -232,36 +192,39 @@ vector<data_struct> Slayer::runBellerophon(Sequence q, Sequence pA, Sequence pB,
 	}
 }
 /***********************************************************************/
-vector<snps> Slayer::getSNPS(string parentA, string query, string parentB, int left, int right) {
+//fills data with the spots between left and right where the query differs from a parent
+void Slayer::getSNPS(int left, int right, vector<snps>& data) {
 	try {
-	
-		vector<snps> data;
+
+		data.clear();
+
+		int length = query.length();
 
 		for (int i = left; i <= right; i++) {
-			
+
 			char A = parentA[i];
 			char Q = query[i];
 			char B = parentB[i];
-			
+
 			if ((A != Q) || (B != Q)) {
 
 				//ensure not neighboring a gap. change to 12/09 release of chimeraSlayer - not sure what this adds, but it eliminates alot of SNPS
 
-				
+
 				if (
 					//did query loose a base here during filter??
 					( i == 0 || abs (baseSpots[0][i] - baseSpots[0][i-1]) == 1) &&
-					( i == query.length()-1 || abs (baseSpots[0][i] - baseSpots[0][i+1]) == 1)
+					( i == length-1 || abs (baseSpots[0][i] - baseSpots[0][i+1]) == 1)
 					&&
 					//did parentA loose a base here during filter??
 					( i == 0 || abs (baseSpots[1][i] - baseSpots[1][i-1]) == 1) &&
-					( i == parentA.length()-1 || abs (baseSpots[1][i] - baseSpots[1][i+1]) == 1) 
+					( i == length-1 || abs (baseSpots[1][i] - baseSpots[1][i+1]) == 1)
 					&&
 					//did parentB loose a base here during filter??
 					( i == 0 || abs (baseSpots[2][i] - baseSpots[2][i-1]) == 1) &&
-					( i == parentB.length()-1 || abs (baseSpots[2][i] - baseSpots[2][i+1]) == 1)
-					) 
-				{ 
+					( i == length-1 || abs (baseSpots[2][i] - baseSpots[2][i+1]) == 1)
+					)
+				{
 					snps member;
 					member.queryChar = Q;
 					member.parentAChar = A;
@@ -270,9 +233,7 @@ vector<snps> Slayer::getSNPS(string parentA, string query, string parentB, int l
 				}
 			}
 		}
-		
-		return data;
-		
+
 	}
 	catch(exception& e) {
 		m->errorOut(e, "Slayer", "getSNPS");
@@ -280,35 +241,44 @@ vector<snps> Slayer::getSNPS(string parentA, string query, string parentB, int l
 	}
 }
 /***********************************************************************/
-int Slayer::bootstrapSNPS(vector<snps> left, vector<snps> right, float& BSA, float& BSB, int numIters) {
+//each iteration samples the snps with replacement and only counts how many of the sampled snps match each parent
+int Slayer::bootstrapSNPS(vector<snps>& left, vector<snps>& right, float& BSA, float& BSB, int numIters) {
 	try {
 
-		srand((unsigned)time( NULL ));
-
 		int count_A = 0; // sceneario QLA,QRB supported
 		int count_B = 0; // sceneario QLB,QRA supported
-	
+
 		int numLeft = max(1, int(left.size() * percentSNPSample/(float)100 + 0.5));
 		int numRight = max(1, int(right.size() * percentSNPSample/(float)100 + 0.5));
 
+		uniform_int_distribution<int> randomLeft(0, left.size()-1);
+		uniform_int_distribution<int> randomRight(0, right.size()-1);
+
 		for (int i = 0; i < numIters; i++) {
 			//random sampling with replacement.
-		
+
 			if (m->control_pressed) { return 0;  }
-			
-			vector<snps> selectedLeft;
 
+			int leftA = 0; int leftB = 0;
 			for (int j = 0; j < numLeft; j++) {
-				int index = m->getRandomIndex(left.size()-1);
-				selectedLeft.push_back(left[index]);
+				int index;
+				if (randomEngine == NULL)	{ index = m->getRandomIndex(left.size()-1);	}
+				else						{ index = randomLeft(*randomEngine);		}
+
+				if (left[index].parentAChar == left[index].queryChar) { leftA++; }
+				if (left[index].parentBChar == left[index].queryChar) { leftB++; }
 			}
 
-			vector<snps> selectedRight;
+			int rightA = 0; int rightB = 0;
 			for (int j = 0; j < numRight; j++) {
-				int index = m->getRandomIndex(right.size()-1);
-				selectedRight.push_back(right[index]);
+				int index;
+				if (randomEngine == NULL)	{ index = m->getRandomIndex(right.size()-1);	}
+				else						{ index = randomRight(*randomEngine);		}
+
+				if (right[index].parentAChar == right[index].queryChar) { rightA++; }
+				if (right[index].parentBChar == right[index].queryChar) { rightB++; }
 			}
-		
+
 			/* A  ------------------------------------------
 			#       QLA                     QRA
 			# Q  ------------------------------------------
@@ -317,158 +287,93 @@ int Slayer::bootstrapSNPS(vector<snps> left, vector<snps> right, float& BSA, flo
 			# Q  ------------------------------------------
 			#       QLB                     QRB
 			# B  ------------------------------------------ */
-		
-		
-			float QLA = snpQA(selectedLeft);
-			float QRA = snpQA(selectedRight);
-		
-			float QLB = snpQB(selectedLeft);
-			float QRB = snpQB(selectedRight);
-	
-			//in original - not used - not sure why?
-			//float ALB = snpAB(selectedLeft);
-			//float ARB = snpAB(selectedRight);
-		
+
+
+			float QLA = (leftA / (float) numLeft) * 100;
+			float QRA = (rightA / (float) numRight) * 100;
+
+			float QLB = (leftB / (float) numLeft) * 100;
+			float QRB = (rightB / (float) numRight) * 100;
+
 			if ((QLA > QLB) && (QRB > QRA)) {
 				count_A++;
 			}
-		
+
 			if ((QLB > QLA) && (QRA > QRB)) {
 				count_B++;
 			}
-			
-//cout << "selected left snp: \n";
-//for (int j = 0; j < selectedLeft.size(); j++) {  cout << selectedLeft[j].parentAChar;  } 
-//cout << endl;
-//for (int j = 0; j < selectedLeft.size(); j++) {  cout << selectedLeft[j].queryChar;  }
-//cout << endl;
-//for (int j = 0; j < selectedLeft.size(); j++) {  cout << selectedLeft[j].parentBChar;  }
-//cout << endl;
-//cout << "selected right snp: \n";
-//for (int j = 0; j < selectedRight.size(); j++) {  cout << selectedRight[j].parentAChar;  } 
-//cout << endl;
-//for (int i = 0; i < selectedRight.size(); i++) {  cout << selectedRight[i].queryChar;  }
-//cout << endl;
-//for (int i = 0; i < selectedRight.size(); i++) {  cout << selectedRight[i].parentBChar;  }
-//cout << endl;		
 		}
 
-
-		//cout << count_A << '\t' << count_B << endl;
-
 		BSA = (float) count_A / (float) numIters * 100;
 		BSB = (float) count_B / (float) numIters * 100;
-//cout << "bsa = " << BSA << " bsb = " << BSB << endl;
 
 		return 0;
-	
-	}
-	catch(exception& e) {
-		m->errorOut(e, "Slayer", "bootstrapSNPS");
-		exit(1);
-	}
-}
-/***********************************************************************/
-float Slayer::snpQA(vector<snps> data) {
-	try {
-	
-		int numIdentical = 0;
-	
-		for (int i = 0; i < data.size(); i++) {
-			if (data[i].parentAChar == data[i].queryChar) {
-				numIdentical++;
-			}
-		}
-
-		float percentID = (numIdentical / (float) data.size()) * 100;
-		
-		return percentID;
-	}
-	catch(exception& e) {
-		m->errorOut(e, "Slayer", "snpQA");
-		exit(1);
-	}
-}
-/***********************************************************************/
-float Slayer::snpQB(vector<snps> data) {
-	try {
-	
-		int numIdentical = 0;
-	
-		for (int i = 0; i < data.size(); i++) {
-			if (data[i].parentBChar == data[i].queryChar) {
-				numIdentical++;
-			}
-		}
-
-		float percentID = (numIdentical / (float) data.size()) * 100;
-		
-		return percentID;
 
 	}
 	catch(exception& e) {
-		m->errorOut(e, "Slayer", "snpQB");
+		m->errorOut(e, "Slayer", "bootstrapSNPS");
 		exit(1);
 	}
 }
 /***********************************************************************/
-float Slayer::snpAB(vector<snps> data) {
+//sums gets the running counts for computePercentID: the bases in each string and the identical bases,
+//up to but not including each column
+void Slayer::countIdentities(const string& queryAlign, const string& chimera, vector<int>& sums) {
 	try {
-		int numIdentical = 0;
-	
-		for (int i = 0; i < data.size(); i++) {
-			if (data[i].parentAChar == data[i].parentBChar) {
-				numIdentical++;
-			}
-		}
-
-		float percentID = (numIdentical / (float) data.size()) * 100;
-		
-		return percentID;
+		int length = queryAlign.length();
+		sums.resize(3*(length+1));
 
-	}
-	catch(exception& e) {
-		m->errorOut(e, "Slayer", "snpAB");
-		exit(1);
-	}
-}
-/***********************************************************************/
-float Slayer::computePercentID(string queryAlign, string chimera, int left, int right) {
-	try {
-				
 		int numIdentical = 0;
 		int countA = 0;
 		int countB = 0;
-		for (int i = left; i <= right; i++) {
+		sums[0] = 0; sums[1] = 0; sums[2] = 0;
+
+		for (int i = 0; i < length; i++) {
 			if (((queryAlign[i] != 'G') && (queryAlign[i] != 'T') && (queryAlign[i] != 'A') && (queryAlign[i] != 'C')&& (queryAlign[i] != '.') && (queryAlign[i] != '-')) ||
 				((chimera[i] != 'G') && (chimera[i] != 'T') && (chimera[i] != 'A') && (chimera[i] != 'C')&& (chimera[i] != '.') && (chimera[i] != '-'))) {}
 			else {
-				
+
 				bool charA = false; bool charB = false;
 				if ((queryAlign[i] == 'G') || (queryAlign[i] == 'T') || (queryAlign[i] == 'A') || (queryAlign[i] == 'C')) { charA = true; }
 				if ((chimera[i] == 'G') || (chimera[i] == 'T') || (chimera[i] == 'A') || (chimera[i] == 'C')) { charB = true; }
-				
+
 				if (charA || charB) {
-					
+
 					if (charA) { countA++; }
 					if (charB) { countB++; }
-					
+
 					if (queryAlign[i] == chimera[i]) {
 						numIdentical++;
 					}
 				}
 			}
-			
+
+			sums[3*(i+1)] = numIdentical;
+			sums[3*(i+1)+1] = countA;
+			sums[3*(i+1)+2] = countB;
 		}
-		
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Slayer", "countIdentities");
+		exit(1);
+	}
+}
+/***********************************************************************/
+float Slayer::computePercentID(const vector<int>& sums, int left, int right) {
+	try {
+
+		int numIdentical = sums[3*(right+1)] - sums[3*left];
+		int countA = sums[3*(right+1)+1] - sums[3*left+1];
+		int countB = sums[3*(right+1)+2] - sums[3*left+2];
+
 		float numBases = (countA + countB) /(float) 2;
-		
+
 		if (numBases == 0) { return 0; }
-		
+
 		float percentIdentical = (numIdentical/(float)numBases) * 100;
 
 		return percentIdentical;
-		
+
 	}
 	catch(exception& e) {
 		m->errorOut(e, "Slayer", "computePercentID");
@@ -476,108 +381,39 @@ float Slayer::computePercentID(string queryAlign, string chimera, int left, int
 	}
 }
 /***********************************************************************/
-//remove columns that contain any gaps
-map<int, int> Slayer::verticalFilter(Sequence& q, Sequence& pA, Sequence& pB) {
+//remove columns that contain any gaps, fills query, parentA, parentB, baseSpots and spots
+void Slayer::verticalFilter(const string& q, const string& pA, const string& pB) {
 	try {
-		//find baseSpots
-		baseSpots.clear(); 
-		baseSpots.resize(3);  //query, parentA, parentB
-	
-		vector<int> gaps;	gaps.resize(q.getAligned().length(), 0);
-		
-		string filterString = (string(q.getAligned().length(), '1'));
-		
-		string seqAligned = q.getAligned();
-		for (int j = 0; j < seqAligned.length(); j++) {
-			//if this spot is a gap
-			if ((seqAligned[j] == '-') || (seqAligned[j] == '.') || (toupper(seqAligned[j]) == 'N'))	{   gaps[j]++;	}
-		}
-		
-		seqAligned = pA.getAligned();
-		for (int j = 0; j < seqAligned.length(); j++) {
-			//if this spot is a gap
-			if ((seqAligned[j] == '-') || (seqAligned[j] == '.') || (toupper(seqAligned[j]) == 'N'))	{   gaps[j]++;	}
-		}
-		
-		seqAligned = pB.getAligned();
-		for (int j = 0; j < seqAligned.length(); j++) {
-			//if this spot is a gap
-			if ((seqAligned[j] == '-') || (seqAligned[j] == '.') || (toupper(seqAligned[j]) == 'N'))	{   gaps[j]++;	}
-		}
-		
-		
-		//zero out spot where any sequences have blanks
-		int numColRemoved = 0;
-		int count = 0;
-		map<int, int> maskMap; maskMap.clear();
-
-		for(int i = 0; i < q.getAligned().length(); i++){
-			if(gaps[i] != 0)	{	filterString[i] = '0'; 	numColRemoved++;  }
-			else {
-				maskMap[count] = i;
-				count++;
-			}
-		}
+		int alignLength = q.length();
 
-		seqAligned = q.getAligned();
-		string newAligned = "";
-			
-		int baseCount = 0;
-		count = 0;
-		for (int j = 0; j < seqAligned.length(); j++) {
-			//are you a base
-			if ((seqAligned[j] != '-') && (seqAligned[j] != '.') && (toupper(seqAligned[j]) != 'N'))	{ baseCount++; }
-			
-			//if this spot is not a gap
-			if (filterString[j] == '1') { 
-				newAligned += seqAligned[j]; 
-				baseSpots[0][count] = baseCount;
-				count++;
-			}
-		}
-			
-		q.setAligned(newAligned);
-		
-		seqAligned = pA.getAligned();
-		newAligned = "";
-		
-		baseCount = 0;
-		count = 0;
-		for (int j = 0; j < seqAligned.length(); j++) {
-			//are you a base
-			if ((seqAligned[j] != '-') && (seqAligned[j] != '.') && (toupper(seqAligned[j]) != 'N'))	{ baseCount++; }
-			
-			//if this spot is not a gap
-			if (filterString[j] == '1') { 
-				newAligned += seqAligned[j]; 
-				baseSpots[1][count] = baseCount;
-				count++;
-			}
-		}
-		
-		pA.setAligned(newAligned);
-		
-		seqAligned = pB.getAligned();
-		newAligned = "";
-		
-		baseCount = 0;
-		count = 0;
-		for (int j = 0; j < seqAligned.length(); j++) {
+		query.clear(); parentA.clear(); parentB.clear(); spots.clear();
+		for (int k = 0; k < 3; k++) { baseSpots[k].clear(); }
+
+		int baseCountQ = 0; int baseCountA = 0; int baseCountB = 0;
+
+		for (int j = 0; j < alignLength; j++) {
 			//are you a base
-			if ((seqAligned[j] != '-') && (seqAligned[j] != '.') && (toupper(seqAligned[j]) != 'N'))	{ baseCount++; }
-			
-			//if this spot is not a gap
-			if (filterString[j] == '1') { 
-				newAligned += seqAligned[j]; 
-				baseSpots[2][count] = baseCount;
-				count++;
+			bool gapQ = ((q[j] == '-') || (q[j] == '.') || (toupper(q[j]) == 'N'));
+			bool gapA = ((pA[j] == '-') || (pA[j] == '.') || (toupper(pA[j]) == 'N'));
+			bool gapB = ((pB[j] == '-') || (pB[j] == '.') || (toupper(pB[j]) == 'N'));
+
+			if (!gapQ) { baseCountQ++; }
+			if (!gapA) { baseCountA++; }
+			if (!gapB) { baseCountB++; }
+
+			//zero out spot where any sequences have blanks
+			if (!gapQ && !gapA && !gapB) {
+				spots.push_back(j);
+
+				query += q[j];
+				parentA += pA[j];
+				parentB += pB[j];
+
+				baseSpots[0].push_back(baseCountQ);
+				baseSpots[1].push_back(baseCountA);
+				baseSpots[2].push_back(baseCountB);
 			}
 		}
-		
-		pB.setAligned(newAligned);
-		
-		
-		return maskMap;
 	}
 	catch(exception& e) {
 		m->errorOut(e, "Slayer", "verticalFilter");
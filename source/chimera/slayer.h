@@ -32,27 +32,32 @@ class Slayer {
 		Slayer(int, int, int, float, int, int, int);
 		~Slayer() {};
 		
-		string getResults(Sequence, vector<Sequence>);
+		string getResults(Sequence&, vector<Sequence>&);
 		vector<data_struct> getOutput()  {	return outputResults;			}
+		void setRandomEngine(mt19937_64* e) { randomEngine = e; } //the bootstrap draws from e, or from mothur's generator if e is NULL
 		
 				
 	private:
 		
-		int windowSize, windowStep, parentFragmentThreshold, iters, percentSNPSample, minBS;
+		int window, windowSize, windowStep, parentFragmentThreshold, iters, percentSNPSample, minBS;
 		float divRThreshold; 
 		vector<data_struct>  outputResults;
-		vector< map<int, int> > baseSpots;
-		Sequence myQuery;
+		mt19937_64* randomEngine;
 		
-		map<int, int> verticalFilter(Sequence&, Sequence&, Sequence&);
-		float computePercentID(string, string, int, int);
+		//workspace kept from pair to pair, filled by verticalFilter
+		string query, parentA, parentB;		//without the columns where any of the three has a gap
+		vector< vector<int> > baseSpots;	//bases up to each column for the query, parentA and parentB
+		vector<int> spots;					//maps spot in filtered alignment to spot in the alignment before filter
+		vector<int> sumsQA, sumsQB, sumsAB;	//running counts for computePercentID, 3 per column
+		vector<snps> snpsLeft, snpsRight;
 		
-		vector<data_struct> runBellerophon(Sequence, Sequence, Sequence, map<int, int>&);
-		vector<snps> getSNPS(string, string, string, int, int);
-		int bootstrapSNPS(vector<snps>, vector<snps>, float&, float&, int);
-		float snpQA(vector<snps>);
-		float snpQB(vector<snps>);
-		float snpAB(vector<snps>);
+		void verticalFilter(const string&, const string&, const string&);
+		void countIdentities(const string&, const string&, vector<int>&);
+		float computePercentID(const vector<int>&, int, int);
+		
+		vector<data_struct> runBellerophon();
+		void getSNPS(int, int, vector<snps>&);
+		int bootstrapSNPS(vector<snps>&, vector<snps>&, float&, float&, int);
 		MothurOut* m;
 				
 };
@@ -83,10 +83,9 @@ Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
 				numKmers = database->getMaxKmer() + 1;
 			
 				//initialze probabilities
-				wordGenusProb.resize(numKmers);
+				numGenera = genusNodes.size();
+				wordGenusProb.resize((size_t)numKmers * numGenera);
                 for (int j = 0; j < numKmers; j++) {  diffPair tempDiffPair; WordPairDiffArr.push_back(tempDiffPair); }
-			
-				for (int j = 0; j < wordGenusProb.size(); j++) {	wordGenusProb[j].resize(genusNodes.size());		}
                 ofstream out;
 				ofstream out2;
 
@@ -129,14 +128,15 @@ Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
 					WordPairDiffArr[i] = tempProb;
 						
 					int numNotZero = 0;
+					float* genusProbs = getGenusProbs(i);
 					for (int k = 0; k < genusNodes.size(); k++) {
 						//probabilityInThisTaxonomy = (# of seqs with that word in this taxonomy + probabilityInTemplate) / (total number of seqs in this taxonomy + 1);
 						
 						
-						wordGenusProb[i][k] = log((count[k] + probabilityInTemplate) / (float) (genusTotals[k] + 1));  
+						genusProbs[k] = log((count[k] + probabilityInTemplate) / (float) (genusTotals[k] + 1));  
 									
 						if (count[k] != 0) {
-                            if (shortcuts) { out << k << '\t' << wordGenusProb[i][k] << '\t' ; }
+                            if (shortcuts) { out << k << '\t' << genusProbs[k] << '\t' ; }
 							numNotZero++;
 						}
 					}
@@ -162,6 +162,8 @@ Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
 			}
 		}
 		
+        setNodeArrays();
+        
         if (m->debug) { m->mothurOut("[DEBUG]: about to generateWordPairDiffArr\n"); }
 		generateWordPairDiffArr();
         if (m->debug) { m->mothurOut("[DEBUG]: done generateWordPairDiffArr\n"); }
@@ -188,10 +190,31 @@ Bayesian::~Bayesian() {
 
 /**************************************************************************************************/
 string Bayesian::getTaxonomy(Sequence* seq) {
+	try {
+		return classify(seq, simpleTax, flipped, NULL, NULL);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "getTaxonomy");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+string Bayesian::classifySequence(Sequence* seq, string& simple, bool& flip, string& warnings, string& matchDistances, mt19937_64& engine) {
+	try {
+		return classify(seq, simple, flip, &warnings, &engine);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "classifySequence");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//if engine is NULL the bootstrap samples are drawn from mothur's random number generator, if warnings is NULL the warnings are printed
+string Bayesian::classify(Sequence* seq, string& simple, bool& seqFlipped, string* warnings, mt19937_64* engine) {
 	try {
 		string tax = "";
 		Kmer kmer(kmerSize);
-		flipped = false;
+		seqFlipped = false;
 		
 		//get words contained in query
 		//getKmerString returns a string where the index in the string is hte kmer number 
@@ -208,7 +231,7 @@ string Bayesian::getTaxonomy(Sequence* seq) {
 		//if user wants to test reverse compliment and its reversed use that instead
 		if (flip) {	
 			if (isReversed(queryKmers)) { 
-				flipped = true;
+				seqFlipped = true;
 				seq->reverseComplement(); 
 				queryKmerString = kmer.getKmerString(seq->getUnaligned()); 
 				queryKmers.clear();
@@ -220,7 +243,12 @@ string Bayesian::getTaxonomy(Sequence* seq) {
 			}  
 		}
 		
-		if (queryKmers.size() == 0) {  m->mothurOut(seq->getName() + " is bad. It has no kmers of length " + toString(kmerSize) + "."); m->mothurOutEndLine(); simpleTax = "unknown;";  return "unknown;"; }
+		if (queryKmers.size() == 0) {
+			string warning = seq->getName() + " is bad. It has no kmers of length " + toString(kmerSize) + ".\n";
+			if (warnings == NULL)	{ m->mothurOut(warning);	}
+			else					{ *warnings += warning;		}
+			simple = "unknown;";  return "unknown;";
+		}
 		
 		
 		int index = getMostProbableTaxonomy(queryKmers);
@@ -230,72 +258,90 @@ string Bayesian::getTaxonomy(Sequence* seq) {
 		//bootstrap - to set confidenceScore
 		int numToSelect = queryKmers.size() / 8;
 	
-        if (m->debug) {  m->mothurOut(seq->getName() + "\t"); }
+        if (m->debug && (engine == NULL)) {  m->mothurOut(seq->getName() + "\t"); }
         
-		tax = bootstrapResults(queryKmers, index, numToSelect);
+		tax = bootstrapResults(queryKmers, index, numToSelect, simple, engine);
         
-        if (m->debug) {  m->mothurOut("\n"); }
+        if (m->debug && (engine == NULL)) {  m->mothurOut("\n"); }
 		
 		return tax;	
 	}
 	catch(exception& e) {
-		m->errorOut(e, "Bayesian", "getTaxonomy");
+		m->errorOut(e, "Bayesian", "classify");
 		exit(1);
 	}
 }
 /**************************************************************************************************/
-string Bayesian::bootstrapResults(vector<int> kmers, int tax, int numToSelect) {
+void Bayesian::setNodeArrays() {
 	try {
-				
-		map<int, int> confidenceScores; 
-		
-		//initialize confidences to 0 
-		int seqIndex = tax;
-		TaxNode seq = phyloTree->get(tax);
-		confidenceScores[tax] = 0;
-		
-		while (seq.level != 0) { //while you are not at the root
-			seqIndex = seq.parent;
-			confidenceScores[seqIndex] = 0;
-			seq = phyloTree->get(seq.parent);
+		nodeParents.resize(phyloTree->getNumNodes());
+		nodeLevels.resize(phyloTree->getNumNodes());
+		for (int i = 0; i < nodeParents.size(); i++) {
+			TaxNode node = phyloTree->get(i);
+			nodeParents[i] = node.parent;
+			nodeLevels[i] = node.level;
 		}
-				
-		map<int, int>::iterator itBoot;
-		map<int, int>::iterator itBoot2;
-		map<int, int>::iterator itConvert;
-			
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "setNodeArrays");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//All the bootstrap samples are drawn first, then scored together one block of genera at a time. The rows of the
+//query's kmers for a block fit in cache, so each row is read from memory once for all the iterations instead of once
+//per iteration. Each sample still adds its kmers in the order they were drawn, so the scores are the same as scoring
+//the samples one at a time.
+string Bayesian::bootstrapResults(vector<int>& kmers, int tax, int numToSelect, string& simple, mt19937_64* engine) {
+	try {
+		uniform_int_distribution<int> randomKmer(0, max(0, (int)kmers.size()-1));
+		
+		vector<int> samples(iters * numToSelect);
 		for (int i = 0; i < iters; i++) {
 			if (m->control_pressed) { return "control"; }
 			
-			vector<int> temp;
 			for (int j = 0; j < numToSelect; j++) {
-				int index = m->getRandomIndex(kmers.size()-1);
+				int index;
+				if (engine == NULL)	{ index = m->getRandomIndex(kmers.size()-1);	}
+				else				{ index = randomKmer(*engine);					}
 				
 				//add word to temp
-				temp.push_back(kmers[index]);
+				samples[i*numToSelect + j] = kmers[index];
 			}
+		}
+		
+		vector<double> maxProbability(iters, -1000000.0);
+		vector<int> indexofGenus(iters, 0);
+		double probs[genusBlockSize];
+		
+		for (int blockStart = 0; blockStart < numGenera; blockStart += genusBlockSize) {
+			if (m->control_pressed) { return "control"; }
 			
-			//get taxonomy
-			int newTax = getMostProbableTaxonomy(temp);
-			//int newTax = 1;
-			TaxNode taxonomyTemp = phyloTree->get(newTax);
+			int blockSize = min((int)genusBlockSize, numGenera - blockStart);
 			
-			//add to confidence results
-			while (taxonomyTemp.level != 0) { //while you are not at the root
-				itBoot2 = confidenceScores.find(newTax); //is this a classification we already have a count on
+			for (int i = 0; i < iters; i++) {
+				for (int k = 0; k < blockSize; k++) { probs[k] = 0.0; }
 				
-				if (itBoot2 != confidenceScores.end()) { //this is a classification we need a confidence for
-					(itBoot2->second)++;
+				const int* sample = &samples[i*numToSelect];
+				for (int j = 0; j < numToSelect; j++) {
+					const float* genusProbs = getGenusProbs(sample[j]) + blockStart;
+					for (int k = 0; k < blockSize; k++) { probs[k] += genusProbs[k]; }
 				}
 				
-				newTax = taxonomyTemp.parent;
-				taxonomyTemp = phyloTree->get(newTax);
+				for (int k = 0; k < blockSize; k++) {
+					if (probs[k] > maxProbability[i]) { maxProbability[i] = probs[k]; indexofGenus[i] = genusNodes[blockStart + k]; }
+				}
 			}
-	
+		}
+		
+		//add to confidence results, only the nodes above tax are reported
+		vector<int> confidenceScores(nodeParents.size(), 0);
+		for (int i = 0; i < iters; i++) {
+			for (int newTax = indexofGenus[i]; nodeLevels[newTax] != 0; newTax = nodeParents[newTax]) { confidenceScores[newTax]++; }
 		}
 		
 		string confidenceTax = "";
-		simpleTax = "";
+		simple = "";
 		
 		int seqTaxIndex = tax;
 		TaxNode seqTax = phyloTree->get(tax);
@@ -303,25 +349,20 @@ string Bayesian::bootstrapResults(vector<int> kmers, int tax, int numToSelect) {
         
 		while (seqTax.level != 0) { //while you are not at the root
 					
-				itBoot2 = confidenceScores.find(seqTaxIndex); //is this a classification we already have a count on
-				
-				int confidence = 0;
-				if (itBoot2 != confidenceScores.end()) { //already in confidence scores
-					confidence = itBoot2->second;
-				}
+				int confidence = confidenceScores[seqTaxIndex];
 				
-                if (m->debug) { m->mothurOut(seqTax.name + "(" + toString(((confidence/(float)iters) * 100)) + ");"); }
+                if (m->debug && (engine == NULL)) { m->mothurOut(seqTax.name + "(" + toString(((confidence/(float)iters) * 100)) + ");"); }
             
 				if (((confidence/(float)iters) * 100) >= confidenceThreshold) {
 					confidenceTax = seqTax.name + "(" + toString(((confidence/(float)iters) * 100)) + ");" + confidenceTax;
-					simpleTax = seqTax.name + ";" + simpleTax;
+					simple = seqTax.name + ";" + simple;
 				}
             
 				seqTaxIndex = seqTax.parent;
 				seqTax = phyloTree->get(seqTax.parent);
 		}
 		
-		if (confidenceTax == "") { confidenceTax = "unknown;"; simpleTax = "unknown;";  }
+		if (confidenceTax == "") { confidenceTax = "unknown;"; simple = "unknown;";  }
 	
 		return confidenceTax;
 		
@@ -332,34 +373,27 @@ string Bayesian::bootstrapResults(vector<int> kmers, int tax, int numToSelect) {
 	}
 }
 /**************************************************************************************************/
-int Bayesian::getMostProbableTaxonomy(vector<int> queryKmer) {
+//adds the genus rows of the query's kmers, the rows are contiguous so the adds vectorize
+int Bayesian::getMostProbableTaxonomy(vector<int>& queryKmer) {
 	try {
 		int indexofGenus = 0;
 		
 		double maxProbability = -1000000.0;
 		//find taxonomy with highest probability that this sequence is from it
 		
+		vector<double> probs(numGenera, 0.0);
+		for (int i = 0; i < queryKmer.size(); i++) {
+			const float* genusProbs = getGenusProbs(queryKmer[i]);
+			for (int k = 0; k < numGenera; k++) { probs[k] += genusProbs[k]; }
+		}
 		
-//		cout << genusNodes.size() << endl;
-		
-		
-		for (int k = 0; k < genusNodes.size(); k++) {
-			//for each taxonomy calc its probability
-			
-			double prob = 0.0000;
-			for (int i = 0; i < queryKmer.size(); i++) {
-				prob += wordGenusProb[queryKmer[i]][k];
-			}
-			
-//			cout << phyloTree->get(genusNodes[k]).name << '\t' << prob << endl;
-
+		for (int k = 0; k < numGenera; k++) {
 			//is this the taxonomy with the greatest probability?
-			if (prob > maxProbability) { 
+			if (probs[k] > maxProbability) { 
 				indexofGenus = genusNodes[k];
-				maxProbability = prob;
+				maxProbability = probs[k];
 			}
 		}
-		
 			
 		return indexofGenus;
 	}
@@ -417,9 +451,8 @@ void Bayesian::readProbFile(ifstream& in, ifstream& inNum, string inName, string
         
         in >> numKmers; m->gobble(in);
         //initialze probabilities
-        wordGenusProb.resize(numKmers);
-        
-        for (int j = 0; j < wordGenusProb.size(); j++) {	wordGenusProb[j].resize(genusNodes.size());		}
+        numGenera = genusNodes.size();
+        wordGenusProb.resize((size_t)numKmers * numGenera);
         
         int kmer, name, count;  count = 0;
         vector<int> num; num.resize(numKmers);
@@ -444,14 +477,15 @@ void Bayesian::readProbFile(ifstream& in, ifstream& inNum, string inName, string
             in >> kmer;
             
             //set them all to zero value
+            float* genusProbs = getGenusProbs(kmer);
             for (int i = 0; i < genusNodes.size(); i++) {
-                wordGenusProb[kmer][i] = log(zeroCountProb[kmer] / (float) (genusTotals[i]+1));
+                genusProbs[i] = log(zeroCountProb[kmer] / (float) (genusTotals[i]+1));
             }
            
             //get probs for nonzero values
             for (int i = 0; i < num[kmer]; i++) {
                 in >> name >> prob;
-                wordGenusProb[kmer][name] = prob;
+                genusProbs[name] = prob;
             }
             
             m->gobble(in);
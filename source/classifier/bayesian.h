@@ -22,20 +22,27 @@ public:
 	~Bayesian();
 	
 	string getTaxonomy(Sequence*);
+	bool isThreadSafe() { return true; } //the probability tables are only read once built
+	string classifySequence(Sequence*, string&, bool&, string&, string&, mt19937_64&);
 	
 private:
-	vector< vector<float> > wordGenusProb;	//vector of maps from genus to probability
-										//wordGenusProb[0][392] = probability that a sequence within genus that's index in the tree is 392 would contain kmer 0;
+	vector<float> wordGenusProb;	//numKmers rows of numGenera probabilities, kmer major so the rows of a query's kmers can be added a genus block at a time
+									//wordGenusProb[0*numGenera+392] = probability that a sequence within genus that's index in the tree is 392 would contain kmer 0;
 	
 	vector<int> genusTotals;
 	vector<int> genusNodes;  //indexes in phyloTree where genus' are located
+	vector<int> nodeParents, nodeLevels; //parent and level of each phyloTree node, so the bootstrap can walk the tree without copying nodes
 	
 	vector<diffPair> WordPairDiffArr; 
 	
-	int kmerSize, numKmers, confidenceThreshold, iters;
+	int kmerSize, numKmers, numGenera, confidenceThreshold, iters;
+	static const int genusBlockSize = 256;
 	
-	string bootstrapResults(vector<int>, int, int);
-	int getMostProbableTaxonomy(vector<int>);
+	float* getGenusProbs(int kmer) { return &wordGenusProb[(size_t)kmer * numGenera]; }
+	void setNodeArrays();
+	string classify(Sequence*, string&, bool&, string*, mt19937_64*);
+	string bootstrapResults(vector<int>&, int, int, string&, mt19937_64*);
+	int getMostProbableTaxonomy(vector<int>&);
 	void readProbFile(ifstream&, ifstream&, string, string);
 	bool checkReleaseDate(ifstream&, ifstream&, ifstream&, ifstream&);
 	bool isReversed(vector<int>&);
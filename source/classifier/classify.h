@@ -29,6 +29,16 @@ public:
 	virtual string getTaxonomy(Sequence*) = 0;
 	virtual string getSimpleTax()  { return simpleTax;	}
 	virtual bool getFlipped()  { return flipped;	}
+	
+	//classifiers that return true from isThreadSafe can be shared by several threads. classifySequence returns the taxonomy
+	//and fills in the simple taxonomy and flipped for the sequence instead of saving them, appends its warnings and its line
+	//of the match distance file to the strings passed in instead of printing them, and draws its random numbers from the
+	//engine passed in. The default version is for the classifiers that are not thread safe and have no warnings, it saves
+	//its results as usual.
+	virtual bool isThreadSafe() { return false; }
+	virtual string classifySequence(Sequence* seq, string& simple, bool& flip, string& warnings, string& matchDistances, mt19937_64&) {
+		string tax = getTaxonomy(seq); simple = getSimpleTax(); flip = getFlipped(); return tax;
+	}
 	virtual void generateDatabaseAndNames(string, string, string, int, float, float, float, float);
 	virtual void setDistName(string s) {} //for knn, so if distance method is selected with knn you can create the smallest distance file in the right place.
     int getMaxLevel() { return maxLevel; }
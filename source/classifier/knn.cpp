@@ -51,13 +51,44 @@ Knn::~Knn() {
 }
 /**************************************************************************************************/
 string Knn::getTaxonomy(Sequence* seq) {
+	try {
+		string warnings = "", matchDistance = "";
+		string tax = findTaxonomy(seq, warnings, matchDistance);
+		
+		if (warnings != "") { m->mothurOut(warnings); }
+		if (matchDistance != "") { ofstream outDistance; m->openOutputFileAppend(outDistName, outDistance); outDistance << matchDistance; outDistance.close();  }
+		
+		simpleTax = tax;
+		return tax;	
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Knn", "getTaxonomy");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//the worker threads of classify.seqs use this, so the warnings and the match distance line are printed in file order by the writer
+string Knn::classifySequence(Sequence* seq, string& simple, bool& flip, string& warnings, string& matchDistances, mt19937_64&) {
+	try {
+		string tax = findTaxonomy(seq, warnings, matchDistances);
+		simple = tax; flip = flipped;
+		return tax;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Knn", "classifySequence");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//appends the warnings and, with search=distance, the line of the match distance file for seq
+string Knn::findTaxonomy(Sequence* seq, string& warnings, string& matchDistances) {
 	try {
 		string tax;
 		
 		//use database to find closest seq
 		vector<int> closest = database->findClosestSequences(seq, num);
 	
-		if (search == "distance") { ofstream outDistance; m->openOutputFileAppend(outDistName, outDistance); outDistance << seq->getName() << '\t' << database->getName(closest[0]) << '\t' << database->getSearchScore() << endl; outDistance.close();  }
+		if (search == "distance") { matchDistances += seq->getName() + '\t' + database->getName(closest[0]) + '\t' + toString(database->getSearchScore()) + '\n'; }
 	
 		if (m->control_pressed) { return tax; }
 
@@ -68,23 +99,22 @@ string Knn::getTaxonomy(Sequence* seq) {
 		
 			//is this sequence in the taxonomy file
 			if (it == taxonomy.end()) { //error not in file
-				m->mothurOut("Error: sequence " + names[closest[i]] + " is not in the taxonomy file.  It will be eliminated as a match to sequence " + seq->getName() + "."); m->mothurOutEndLine();
+				warnings += "Error: sequence " + names[closest[i]] + " is not in the taxonomy file.  It will be eliminated as a match to sequence " + seq->getName() + ".\n";
 			}else{   closestNames.push_back(it->first);	}
 		}
 		
 		if (closestNames.size() == 0) {
-			m->mothurOut("Error: All the matches for sequence " + seq->getName() + " have been eliminated. "); m->mothurOutEndLine();
+			warnings += "Error: All the matches for sequence " + seq->getName() + " have been eliminated. \n";
 			tax = "unknown;";
 		}else{
 			tax = findCommonTaxonomy(closestNames);
-			if (tax == "") { m->mothurOut("There are no common levels for sequence " + seq->getName() + ". "); m->mothurOutEndLine(); tax = "unknown;"; }
+			if (tax == "") { warnings += "There are no common levels for sequence " + seq->getName() + ". \n"; tax = "unknown;"; }
 		}
 		
-		simpleTax = tax;
 		return tax;	
 	}
 	catch(exception& e) {
-		m->errorOut(e, "Knn", "getTaxonomy");
+		m->errorOut(e, "Knn", "findTaxonomy");
 		exit(1);
 	}
 }
@@ -23,9 +23,11 @@ public:
 	
 	void setDistName(string s);
 	string getTaxonomy(Sequence*);
+	string classifySequence(Sequence*, string&, bool&, string&, string&, mt19937_64&);
 	
 private:
 	int num;
+	string findTaxonomy(Sequence*, string&, string&);
 	string findCommonTaxonomy(vector<string>);
 	string search, outDistName;
 	
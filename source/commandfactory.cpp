@@ -153,6 +153,7 @@
 #include "renamefilecommand.h"
 #include "chimeravsearchcommand.h"
 #include "mergecountcommand.hpp"
+#include "qcseqscommand.h"
 
 //needed for testing project
 //CommandFactory* CommandFactory::_uniqueInstance;
@@ -329,6 +330,7 @@ CommandFactory::CommandFactory(){
     commands["set.seed"]            = "set.seed";
     commands["rename.file"]         = "rename.file";
     commands["merge.count"]         = "merge.count";
+    commands["qc.seqs"]             = "qc.seqs";
 
 
 }
@@ -436,6 +438,7 @@ Command* CommandFactory::getCommand(string commandName, string optionString){
 
 		if(commandName == "cluster")                    {	command = new ClusterCommand(optionString);					}
 		else if(commandName == "unique.seqs")			{	command = new DeconvoluteCommand(optionString);				}
+		else if(commandName == "qc.seqs")				{	command = new QcSeqsCommand(optionString);					}
 		else if(commandName == "parsimony")				{	command = new ParsimonyCommand(optionString);				}
 		else if(commandName == "help")					{	command = new HelpCommand(optionString);					}
 		else if(commandName == "quit")					{	command = new QuitCommand(optionString);					}
@@ -610,6 +613,7 @@ Command* CommandFactory::getCommand(string commandName, string optionString, str
 
 		if(commandName == "cluster")				{	pipecommand = new ClusterCommand(optionString);					}
 		else if(commandName == "unique.seqs")			{	pipecommand = new DeconvoluteCommand(optionString);				}
+		else if(commandName == "qc.seqs")				{	pipecommand = new QcSeqsCommand(optionString);					}
 		else if(commandName == "parsimony")				{	pipecommand = new ParsimonyCommand(optionString);				}
 		else if(commandName == "help")					{	pipecommand = new HelpCommand(optionString);					}
 		else if(commandName == "quit")					{	pipecommand = new QuitCommand(optionString);					}
@@ -770,6 +774,7 @@ Command* CommandFactory::getCommand(string commandName){
 
 		if(commandName == "cluster")				{	shellcommand = new ClusterCommand();				}
 		else if(commandName == "unique.seqs")			{	shellcommand = new DeconvoluteCommand();			}
+		else if(commandName == "qc.seqs")				{	shellcommand = new QcSeqsCommand();					}
 		else if(commandName == "parsimony")				{	shellcommand = new ParsimonyCommand();				}
 		else if(commandName == "help")					{	shellcommand = new HelpCommand();					}
 		else if(commandName == "quit")					{	shellcommand = new QuitCommand();					}
@@ -415,6 +415,7 @@ int AlignCommand::driver(linePair* filePos, string alignFName, string reportFNam
 			m->mothurOutEndLine();
 			alignment = new NeedlemanOverlap(gapOpen, match, misMatch, longestBase);
 		}
+		alignment->setBanded(true); //only fill the cells near the diagonal the candidate and template share
 	
 		while (!done) {
 			
@@ -149,6 +149,7 @@ static DWORD WINAPI MyAlignThreadFunction(LPVOID lpParam){
 			pDataArray->m->mothurOutEndLine();
 			alignment = new NeedlemanOverlap(pDataArray->gapOpen, pDataArray->match, pDataArray->misMatch, longestBase);
 		}
+		alignment->setBanded(true);
 		
 		pDataArray->count = 0;
 		for(int i = 0; i < pDataArray->end; i++){ //end is the number of sequences to process
@@ -86,7 +86,7 @@ string ChimeraSlayerCommand::getHelpString(){
 		helpString += "The minsnp parameter allows you to specify percent of SNPs to sample on each side of breakpoint for computing bootstrap support (default: 10) \n";
 		helpString += "The search parameter allows you to specify search method for finding the closest parent. Choices are blast and kmer. Default=blast. \n";
 		helpString += "The realign parameter allows you to realign the query to the potential parents. Choices are true or false, default true.  \n";
-		helpString += "The blastlocation parameter allows you to specify the location of your blast executable. By default mothur will look in ./blast/bin relative to mothur's executable.  \n";
+		helpString += "The blastlocation parameter is no longer needed, blast searches are done within mothur.  \n";
 		helpString += "The chimera.slayer command should be in the following format: \n";
 		helpString += "chimera.slayer(fasta=yourFastaFile, reference=yourTemplate, search=yourSearch) \n";
 		helpString += "Example: chimera.slayer(fasta=AD.align, reference=core_set_aligned.imputed.fasta, search=kmer) \n";
@@ -583,42 +583,9 @@ ChimeraSlayerCommand::ChimeraSlayerCommand(string option)  {
 			if (temp == "not found") { temp = "false";			}
 			dups = m->isTrue(temp);
 			
-			blastlocation = validParameter.validFile(parameters, "blastlocation", false);	
+			//blast searches are done within mothur, blastlocation is accepted so older batch files still run
+			blastlocation = validParameter.validFile(parameters, "blastlocation", false);
 			if (blastlocation == "not found") { blastlocation = ""; }
-			else {
-				//add / to name if needed
-				string lastChar = blastlocation.substr(blastlocation.length()-1);
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-				if (lastChar != "/") { blastlocation += "/"; }
-#else
-				if (lastChar != "\\") { blastlocation += "\\"; }	
-#endif
-				blastlocation = m->getFullPathName(blastlocation);
-				string formatdbCommand = "";
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-				formatdbCommand = blastlocation + "formatdb";	
-#else
-				formatdbCommand = blastlocation + "formatdb.exe";
-#endif
-				
-				//test to make sure formatdb exists
-				ifstream in;
-				formatdbCommand = m->getFullPathName(formatdbCommand);
-				int ableToOpen = m->openInputFile(formatdbCommand, in, "no error"); in.close();
-				if(ableToOpen == 1) {	m->mothurOut("[ERROR]: " + formatdbCommand + " file does not exist. mothur requires formatdb.exe to run chimera.slayer."); m->mothurOutEndLine(); abort = true; }
-				
-				string blastCommand = "";
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-				blastCommand = blastlocation + "megablast";	
-#else
-				blastCommand = blastlocation + "megablast.exe";
-#endif
-				//test to make sure formatdb exists
-				ifstream in2;
-				blastCommand = m->getFullPathName(blastCommand);
-				ableToOpen = m->openInputFile(blastCommand, in2, "no error"); in2.close();
-				if(ableToOpen == 1) {	m->mothurOut("[ERROR]: " + blastCommand + " file does not exist. mothur requires blastall.exe to run chimera.slayer."); m->mothurOutEndLine(); abort = true; }
-			}
 
 			if ((search != "blast") && (search != "kmer")) { m->mothurOut(search + " is not a valid search."); m->mothurOutEndLine(); abort = true;  }
 			
@@ -675,7 +642,6 @@ int ChimeraSlayerCommand::execute(){
 			fileGroup[fastaFileNames[s]] = "noGroup";
             map<string, string> uniqueNames; 
 			int totalChimeras = 0;
-			lines.clear();
 			
 			if (templatefile == "self") { 
                 if (hasCount) {
@@ -695,60 +661,33 @@ int ChimeraSlayerCommand::execute(){
 				itFile = fileToPriority.begin();
 				string thisFastaName = itFile->first;
 				map<string, int> thisPriority = itFile->second;
-				//break up file
-				vector<unsigned long long> positions; 
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-				positions = m->divideFile(thisFastaName, processors);
-				for (int i = 0; i < (positions.size()-1); i++) {	lines.push_back(linePair(positions[i], positions[(i+1)]));	}
-#else
-				if (processors == 1) {	lines.push_back(linePair(0, 1000)); }
-				else {
-					positions = m->setFilePosFasta(thisFastaName, numSeqs); 
-                    if (numSeqs < processors) { processors = numSeqs; }
-					
-					//figure out how many sequences you have to process
-					int numSeqsPerProcessor = numSeqs / processors;
-					for (int i = 0; i < processors; i++) {
-						int startIndex =  i * numSeqsPerProcessor;
-						if(i == (processors - 1)){	numSeqsPerProcessor = numSeqs - i * numSeqsPerProcessor; 	}
-						lines.push_back(linePair(positions[startIndex], numSeqsPerProcessor));
-					}
-				}
-#endif
-				if(processors == 1){ numSeqs = driver(lines[0], outputFileName, thisFastaName, accnosFileName, trimFastaFileName, thisPriority);  }
-				else{ numSeqs = createProcesses(outputFileName, thisFastaName, accnosFileName, trimFastaFileName, thisPriority); }
+				numSeqs = driver(outputFileName, thisFastaName, accnosFileName, trimFastaFileName, thisPriority, processors);
 				
 				if (m->control_pressed) {  outputTypes.clear(); if (trim) { m->mothurRemove(trimFastaFileName); } m->mothurRemove(outputFileName); m->mothurRemove(accnosFileName); for (int j = 0; j < outputNames.size(); j++) {	m->mothurRemove(outputNames[j]);	}  return 0; }				
 
 			}else { //you have provided a groupfile
-                string countFile = "";
                 if (hasCount) {
-                    countFile = nameFileNames[s];
                     variables["[filename]"] = outputDir + m->getRootName(m->getSimpleName(nameFileNames[s]));
                     newCountFile = getOutputFileName("count", variables);
                 }
 
-				if (processors == 1) {
-                    numSeqs = driverGroups(outputFileName, accnosFileName, trimFastaFileName, fileToPriority, fileGroup, newCountFile);
-                    if (hasCount && dups) {
-                        CountTable c; c.readTable(nameFileNames[s], true, false);
-                        if (!m->isBlank(newCountFile)) {
-                            ifstream in2;
-                            m->openInputFile(newCountFile, in2);
-                            
-                            string name, group;
-                            while (!in2.eof()) {
-                                in2 >> name >> group; m->gobble(in2);
-                                c.setAbund(name, group, 0);
-                            }
-                            in2.close();
+                numSeqs = driverGroups(outputFileName, accnosFileName, trimFastaFileName, fileToPriority, fileGroup, newCountFile);
+                if (hasCount && dups) {
+                    CountTable c; c.readTable(nameFileNames[s], true, false);
+                    if (!m->isBlank(newCountFile)) {
+                        ifstream in2;
+                        m->openInputFile(newCountFile, in2);
+                        
+                        string name, group;
+                        while (!in2.eof()) {
+                            in2 >> name >> group; m->gobble(in2);
+                            c.setAbund(name, group, 0);
                         }
-                        m->mothurRemove(newCountFile);
-                        c.printTable(newCountFile);
+                        in2.close();
                     }
-
+                    m->mothurRemove(newCountFile);
+                    c.printTable(newCountFile);
                 }
-				else {  numSeqs = createProcessesGroups(outputFileName, accnosFileName, trimFastaFileName, fileToPriority, fileGroup, newCountFile, countFile); 		} //destroys fileToPriority
 
 
                     if (!dups) {
@@ -1031,7 +970,6 @@ int ChimeraSlayerCommand::setUpForSelfReference(SequenceParser*& parser, map<str
 		if (groupFileNames.size() != 0) { groupFile = groupFileNames[s]; }
 		
 		if (groupFile == "") { 
-			if (processors != 1) { m->mothurOut("When using template=self, mothur can only use 1 processor, continuing."); m->mothurOutEndLine(); processors = 1; }
 						
 			//sort fastafile by abundance, returns new sorted fastafile name
 			m->mothurOut("Sorting fastafile according to abundance..."); cout.flush(); 
@@ -1078,7 +1016,6 @@ int ChimeraSlayerCommand::setUpForSelfReference(SequenceCountParser*& parser, ma
          
 		CountTable ct;
 		if (!ct.testGroups(nameFile)) {  
-			if (processors != 1) { m->mothurOut("When using template=self, mothur can only use 1 processor, continuing."); m->mothurOutEndLine(); processors = 1; }
             
 			//sort fastafile by abundance, returns new sorted fastafile name
 			m->mothurOut("Sorting fastafile according to abundance..."); cout.flush(); 
@@ -1145,36 +1082,47 @@ string ChimeraSlayerCommand::getNamesFile(string& inputFile){
 }
 //**********************************************************************************************************************
 
+//the threads check a group at a time with driver, then the group files are appended in group order
 int ChimeraSlayerCommand::driverGroups(string outputFName, string accnos, string fasta, map<string, map<string, int> >& fileToPriority, map<string, string>& fileGroup, string countlist){
 	try {
+		slayerGroupData data;
+		for (map<string, map<string, int> >::iterator itFile = fileToPriority.begin(); itFile != fileToPriority.end(); itFile++) {
+			string thisFastaName = itFile->first;
+			string thisGroup = fileGroup[thisFastaName];
+			data.fastaFiles.push_back(thisFastaName);
+			data.groups.push_back(thisGroup);
+			data.outputFNames.push_back(outputDir + m->getRootName(m->getSimpleName(thisFastaName)) + thisGroup + "slayer.chimera");
+			data.accnos.push_back(outputDir + m->getRootName(m->getSimpleName(thisFastaName)) + thisGroup + "slayer.accnos");
+			data.fasta.push_back(outputDir + m->getRootName(m->getSimpleName(thisFastaName)) + thisGroup + "slayer.fasta");
+			data.priorities.push_back(&(itFile->second));
+		}
+		data.numSeqs.resize(data.fastaFiles.size(), 0);
+
+		int numThreads = processors;
+		if (numThreads > data.fastaFiles.size()) { numThreads = data.fastaFiles.size(); }
+
+		vector<thread*> workerThreads;
+		for (int i = 1; i < numThreads; i++) { workerThreads.push_back(new thread(&ChimeraSlayerCommand::driverGroupsThread, this, &data)); }
+		driverGroupsThread(&data);
+		for (int i = 0; i < workerThreads.size(); i++) { workerThreads[i]->join(); delete workerThreads[i]; }
+
+		if (m->control_pressed) {
+			for (int i = 0; i < data.fastaFiles.size(); i++) {
+				m->mothurRemove(data.outputFNames[i]); m->mothurRemove(data.accnos[i]);
+				if (trim) { m->mothurRemove(data.fasta[i]); }
+				m->mothurRemove(data.fastaFiles[i]);
+			}
+			return 0;
+		}
+
 		int totalSeqs = 0;
         ofstream outCountList;
 
         if (hasCount && dups) { m->openOutputFile(countlist, outCountList); }
-		
-		for (map<string, map<string, int> >::iterator itFile = fileToPriority.begin(); itFile != fileToPriority.end(); itFile++) {
-			
-			if (m->control_pressed) {  return 0;  }
-			
-			int start = time(NULL);
-			string thisFastaName = itFile->first;
-			map<string, int> thisPriority = itFile->second;
-			string thisoutputFileName = outputDir + m->getRootName(m->getSimpleName(thisFastaName)) + fileGroup[thisFastaName] + "slayer.chimera";
-			string thisaccnosFileName = outputDir + m->getRootName(m->getSimpleName(thisFastaName)) + fileGroup[thisFastaName] + "slayer.accnos";
-			string thistrimFastaFileName = outputDir + m->getRootName(m->getSimpleName(thisFastaName)) + fileGroup[thisFastaName] + "slayer.fasta";
-			
-			m->mothurOutEndLine(); m->mothurOut("Checking sequences from group: " + fileGroup[thisFastaName] + "."); m->mothurOutEndLine(); 
-			
-			lines.clear();
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-			int proc = 1;
-			vector<unsigned long long> positions = m->divideFile(thisFastaName, proc);
-			lines.push_back(linePair(positions[0], positions[1]));	
-#else
-			lines.push_back(linePair(0, 1000)); 
-#endif			
-			int numSeqs = driver(lines[0], thisoutputFileName, thisFastaName, thisaccnosFileName, thistrimFastaFileName, thisPriority);
-			
+
+		for (int i = 0; i < data.fastaFiles.size(); i++) {
+			string thisaccnosFileName = data.accnos[i];
+
             //if we provided a count file with group info and set dereplicate=t, then we want to create a *.pick.count_table
             //This table will zero out group counts for seqs determined to be chimeric by that group.
             if (dups) {
@@ -1185,11 +1133,11 @@ int ChimeraSlayerCommand::driverGroups(string outputFName, string accnos, string
                     if (hasCount) {
                         while (!in.eof()) {
                             in >> name; m->gobble(in);
-                            outCountList << name << '\t' << fileGroup[thisFastaName] << endl;
+                            outCountList << name << '\t' << data.groups[i] << endl;
                         }
                         in.close();
                     }else {
-                        map<string, map<string, string> >::iterator itGroupNameMap = group2NameMap.find(fileGroup[thisFastaName]);
+                        map<string, map<string, string> >::iterator itGroupNameMap = group2NameMap.find(data.groups[i]);
                         if (itGroupNameMap != group2NameMap.end()) {
                             map<string, string> thisnamemap = itGroupNameMap->second;
                             map<string, string>::iterator itN;
@@ -1201,31 +1149,29 @@ int ChimeraSlayerCommand::driverGroups(string outputFName, string accnos, string
                                 if (itN != thisnamemap.end()) {
                                     vector<string> tempNames; m->splitAtComma(itN->second, tempNames);
                                     for (int j = 0; j < tempNames.size(); j++) { out << tempNames[j] << endl; }
-                                
+
                                 }else { m->mothurOut("[ERROR]: parsing cannot find " + name + ".\n"); m->control_pressed = true; }
                             }
                             out.close();
                             in.close();
                             m->renameFile(thisaccnosFileName+".temp", thisaccnosFileName);
-                        }else { m->mothurOut("[ERROR]: parsing cannot find " + fileGroup[thisFastaName] + ".\n"); m->control_pressed = true; }
+                        }else { m->mothurOut("[ERROR]: parsing cannot find " + data.groups[i] + ".\n"); m->control_pressed = true; }
                     }
-                    
+
                 }
             }
 
 			//append files
-			m->appendFiles(thisoutputFileName, outputFName); m->mothurRemove(thisoutputFileName); 
+			m->appendFiles(data.outputFNames[i], outputFName); m->mothurRemove(data.outputFNames[i]);
 			m->appendFiles(thisaccnosFileName, accnos); m->mothurRemove(thisaccnosFileName);
-			if (trim) { m->appendFiles(thistrimFastaFileName, fasta); m->mothurRemove(thistrimFastaFileName); }
-			m->mothurRemove(thisFastaName);
-			
-			totalSeqs += numSeqs;
-			
-			m->mothurOutEndLine(); m->mothurOut("It took " + toString(time(NULL) - start) + " secs to check " + toString(numSeqs) + " sequences from group " + fileGroup[thisFastaName] + ".");	m->mothurOutEndLine();
+			if (trim) { m->appendFiles(data.fasta[i], fasta); m->mothurRemove(data.fasta[i]); }
+			m->mothurRemove(data.fastaFiles[i]);
+
+			totalSeqs += data.numSeqs[i];
 		}
-		
+
         if (hasCount && dups) { outCountList.close(); }
-        
+
 		return totalSeqs;
 	}
 	catch(exception& e) {
@@ -1234,367 +1180,153 @@ int ChimeraSlayerCommand::driverGroups(string outputFName, string accnos, string
 	}
 }
 /**************************************************************************************************/
-int ChimeraSlayerCommand::createProcessesGroups(string outputFName, string accnos, string fasta, map<string, map<string, int> >& fileToPriority, map<string, string>& fileGroup, string countlist, string countFile) {
+void ChimeraSlayerCommand::driverGroupsThread(slayerGroupData* data) {
 	try {
-		int process = 1;
-		int num = 0;
-		processIDS.clear();
-        bool recalc = false;
-        map<string, map<string, int> > copyFileToPriority;
-        copyFileToPriority = fileToPriority;
-		
-		if (fileToPriority.size() < processors) { processors = fileToPriority.size(); }
-        
-        CountTable newCount;
-        if (hasCount && dups) { newCount.readTable(countFile, true, false); }
-		
-		int groupsPerProcessor = fileToPriority.size() / processors;
-		int remainder = fileToPriority.size() % processors;
-		
-		vector< map<string, map<string, int> > > breakUp;
-		
-		for (int i = 0; i < processors; i++) {
-			map<string, map<string, int> > thisFileToPriority;
-			map<string, map<string, int> >::iterator itFile;
-			int count = 0;
-			int enough = groupsPerProcessor;
-			if (i == 0) { enough = groupsPerProcessor + remainder; }
-			
-			for (itFile = fileToPriority.begin(); itFile != fileToPriority.end();) {
-				thisFileToPriority[itFile->first] = itFile->second;
-				fileToPriority.erase(itFile++);
-				count++;
-				if (count == enough) { break; }
-			}	
-			breakUp.push_back(thisFileToPriority);
-		}
-				
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-		//loop through and create all the processes you want
-		while (process != processors) {
-			pid_t pid = fork();
-			
-			if (pid > 0) {
-				processIDS.push_back(pid);  //create map from line number to pid so you can append files in correct order later
-				process++;
-			}else if (pid == 0){
-				num = driverGroups(outputFName + toString(m->mothurGetpid(process)) + ".temp", accnos + m->mothurGetpid(process) + ".temp", fasta + toString(m->mothurGetpid(process)) + ".temp", breakUp[process], fileGroup, accnos + toString(m->mothurGetpid(process)) + ".byCount");
-				
-				//pass numSeqs to parent
-				ofstream out;
-				string tempFile = outputFName + toString(m->mothurGetpid(process)) + ".num.temp";
-				m->openOutputFile(tempFile, out);
-				out << num << endl;
-				out.close();
-				exit(0);
-            }else {
-                m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(process) + "\n"); processors = process;
-                for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-                //wait to die
-                for (int i=0;i<processIDS.size();i++) {
-                    int temp = processIDS[i];
-                    wait(&temp);
-                }
-                m->control_pressed = false;
-                recalc = true;
-                break;
-            }
-		}
-		
-        if (recalc) {
-            //test line, also set recalc to true.
-            //for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); } for (int i=0;i<processIDS.size();i++) { int temp = processIDS[i]; wait(&temp); } m->control_pressed = false;  processors=3; m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(processors) + "\n");
-            groupsPerProcessor = copyFileToPriority.size() / processors;
-            remainder = copyFileToPriority.size() % processors;
-            breakUp.clear();
-            
-            for (int i = 0; i < processors; i++) {
-                map<string, map<string, int> > thisFileToPriority;
-                map<string, map<string, int> >::iterator itFile;
-                int count = 0;
-                int enough = groupsPerProcessor;
-                if (i == 0) { enough = groupsPerProcessor + remainder; }
-                
-                for (itFile = copyFileToPriority.begin(); itFile != copyFileToPriority.end();) {
-                    thisFileToPriority[itFile->first] = itFile->second;
-                    copyFileToPriority.erase(itFile++);
-                    count++;
-                    if (count == enough) { break; }
-                }	
-                breakUp.push_back(thisFileToPriority);
-            }
-            
-            num = 0;
-            processIDS.resize(0);
-            process = 1;
-            
-            while (process != processors) {
-                pid_t pid = fork();
-                
-                if (pid > 0) {
-                    processIDS.push_back(pid);  //create map from line number to pid so you can append files in correct order later
-                    process++;
-                }else if (pid == 0){
-                    num = driverGroups(outputFName + toString(m->mothurGetpid(process)) + ".temp", accnos + m->mothurGetpid(process) + ".temp", fasta + toString(m->mothurGetpid(process)) + ".temp", breakUp[process], fileGroup, accnos + toString(m->mothurGetpid(process)) + ".byCount");
-                    
-                    //pass numSeqs to parent
-                    ofstream out;
-                    string tempFile = outputFName + toString(m->mothurGetpid(process)) + ".num.temp";
-                    m->openOutputFile(tempFile, out);
-                    out << num << endl;
-                    out.close();
-                    exit(0);
-                }else {
-                    m->mothurOut("[ERROR]: unable to spawn the necessary processes."); m->mothurOutEndLine();
-                    for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-                    exit(0);
-                }
-            }
-        }
-
-		num = driverGroups(outputFName, accnos, fasta, breakUp[0], fileGroup, accnos + ".byCount");
+		while (!m->control_pressed) {
+			int i = data->nextItem++;
+			if (i >= data->fastaFiles.size()) { break; }
 
-		//force parent to wait until all the processes are done
-		for (int i=0;i<processors;i++) { 
-			int temp = processIDS[i];
-			wait(&temp);
-		}
-		
-		for (int i = 0; i < processIDS.size(); i++) {
-			ifstream in;
-			string tempFile =  outputFName + toString(processIDS[i]) + ".num.temp";
-			m->openInputFile(tempFile, in);
-			if (!in.eof()) { int tempNum = 0;  in >> tempNum; num += tempNum; }
-			in.close(); m->mothurRemove(tempFile);
-		}
-#else
-		
-		//////////////////////////////////////////////////////////////////////////////////////////////////////
-		//Windows version shared memory, so be careful when passing variables through the slayerData struct. 
-		//Above fork() will clone, so memory is separate, but that's not the case with windows, 
-		//////////////////////////////////////////////////////////////////////////////////////////////////////
-		
-		vector<slayerData*> pDataArray; 
-		DWORD   dwThreadIdArray[processors-1];
-		HANDLE  hThreadArray[processors-1]; 
-		
-		//Create processor worker threads.
-		for(int i=1; i<processors; i++ ){
-			string extension = toString(i) + ".temp";
-			slayerData* tempslayer = new slayerData(group2NameMap, hasCount, dups, (accnos + toString(i) +".byCount"), (outputFName + extension), (fasta + extension), (accnos + extension), templatefile, search, blastlocation, trimera, trim, realign, m, breakUp[i], fileGroup, ksize, match, mismatch, window, minSimilarity, minCoverage, minBS, minSNP, parents, iters, increment, numwanted, divR, priority, i);
-			pDataArray.push_back(tempslayer);
-			processIDS.push_back(i);
-			
-			//MySlayerThreadFunction is in header. It must be global or static to work with the threads.
-			//default security attributes, thread function name, argument to thread function, use default creation flags, returns the thread identifier
-			hThreadArray[i-1] = CreateThread(NULL, 0, MySlayerGroupThreadFunction, pDataArray[i-1], 0, &dwThreadIdArray[i-1]);   
-		}
-		
-		num = driverGroups(outputFName, accnos, fasta, breakUp[0], fileGroup, accnos + ".byCount");
-		
-		//Wait until all threads have terminated.
-		WaitForMultipleObjects(processors-1, hThreadArray, TRUE, INFINITE);
-		
-		//Close all thread handles and free memory allocations.
-		for(int i=0; i < pDataArray.size(); i++){
-            if (pDataArray[i]->fileToPriority.size() != pDataArray[i]->end) {
-                m->mothurOut("[ERROR]: process " + toString(i) + " only processed " + toString(pDataArray[i]->end) + " of " + toString(pDataArray[i]->fileToPriority.size()) + " groups assigned to it, quitting. \n"); m->control_pressed = true;
-            }
-			num += pDataArray[i]->count;
-			CloseHandle(hThreadArray[i]);
-			delete pDataArray[i];
-		}
-#endif	
-        //read my own
-        if (hasCount && dups) {
-            if (!m->isBlank(accnos + ".byCount")) {
-                ifstream in2;
-                m->openInputFile(accnos + ".byCount", in2);
-                
-                string name, group;
-                while (!in2.eof()) {
-                    in2 >> name >> group; m->gobble(in2);
-                    newCount.setAbund(name, group, 0);
-                }
-                in2.close();
-            }
-            m->mothurRemove(accnos + ".byCount");
-        }
-
-		
-		//append output files
-		for(int i=0;i<processIDS.size();i++){
-			m->appendFiles((outputFName + toString(processIDS[i]) + ".temp"), outputFName);
-			m->mothurRemove((outputFName + toString(processIDS[i]) + ".temp"));
-			
-			m->appendFiles((accnos + toString(processIDS[i]) + ".temp"), accnos);
-			m->mothurRemove((accnos + toString(processIDS[i]) + ".temp"));
-			
-			if (trim) {
-				m->appendFiles((fasta + toString(processIDS[i]) + ".temp"), fasta);
-				m->mothurRemove((fasta + toString(processIDS[i]) + ".temp"));
+			int start = time(NULL);
+			{
+				lock_guard<mutex> guard(printMutex);
+				m->mothurOutEndLine(); m->mothurOut("Checking sequences from group: " + data->groups[i] + "."); m->mothurOutEndLine();
 			}
-            
-            if (hasCount && dups) {
-                if (!m->isBlank(accnos + toString(processIDS[i]) + ".byCount")) {
-                    ifstream in2;
-                    m->openInputFile(accnos  + toString(processIDS[i]) + ".byCount", in2);
-                    
-                    string name, group;
-                    while (!in2.eof()) {
-                        in2 >> name >> group; m->gobble(in2);
-                        newCount.setAbund(name, group, 0);
-                    }
-                    in2.close();
-                }
-                m->mothurRemove(accnos + toString(processIDS[i]) + ".byCount");
-            }
 
+			data->numSeqs[i] = driver(data->outputFNames[i], data->fastaFiles[i], data->accnos[i], data->fasta[i], *(data->priorities[i]), 1);
+
+			lock_guard<mutex> guard(printMutex);
+			m->mothurOutEndLine(); m->mothurOut("It took " + toString(time(NULL) - start) + " secs to check " + toString(data->numSeqs[i]) + " sequences from group " + data->groups[i] + ".");	m->mothurOutEndLine();
 		}
-		
-        //print new *.pick.count_table
-        if (hasCount && dups) {  newCount.printTable(countlist);   }
-		
-		return num;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "ChimeraSlayerCommand", "createProcessesGroups");
+		m->errorOut(e, "ChimeraSlayerCommand", "driverGroupsThread");
 		exit(1);
 	}
 }
 //**********************************************************************************************************************
-
-int ChimeraSlayerCommand::driver(linePair filePos, string outputFName, string filename, string accnos, string fasta, map<string, int>& priority){
+//checks the sequences in filename a batch at a time, numThreads threads each check the next sequence of the batch with their own
+//ChimeraSlayer and the results are written in file order. With template=self a sequence is only compared to more abundant ones,
+//so a batch holds sequences of one abundance and the chimeras found are added to every ChimeraSlayer before the next batch.
+//Each sequence draws its bootstrap samples from a generator seeded by its place in the file, so the results do not depend on numThreads.
+int ChimeraSlayerCommand::driver(string outputFName, string filename, string accnos, string fasta, map<string, int>& priority, int numThreads){
 	try {
-		
+
         if (m->debug) { m->mothurOut("[DEBUG]: filename = " + filename + "\n"); }
-        
-		MothurChimera* chimera;
-		if (templatefile != "self") { //you want to run slayer with a reference template
-			chimera = new ChimeraSlayer(filename, templatefile, trim, search, ksize, match, mismatch, window, divR, minSimilarity, minCoverage, minBS, minSNP, parents, iters, increment, numwanted, realign, blastlocation, m->getRandomNumber());
-		}else {
-			chimera = new ChimeraSlayer(filename, templatefile, trim, priority, search, ksize, match, mismatch, window, divR, minSimilarity, minCoverage, minBS, minSNP, parents, iters, increment, numwanted, realign, blastlocation, m->getRandomNumber());	
+
+		vector<ChimeraSlayer*> chimeras;
+		unsigned long long seed;
+		{
+			//the constructor reports its progress and getRandomNumber shares mothur's generator
+			lock_guard<mutex> guard(printMutex);
+			if (templatefile != "self") { //you want to run slayer with a reference template
+				chimeras.push_back(new ChimeraSlayer(filename, templatefile, trim, search, ksize, match, mismatch, window, divR, minSimilarity, minCoverage, minBS, minSNP, parents, iters, increment, numwanted, realign, blastlocation, m->getRandomNumber()));
+			}else {
+				chimeras.push_back(new ChimeraSlayer(filename, templatefile, trim, priority, search, ksize, match, mismatch, window, divR, minSimilarity, minCoverage, minBS, minSNP, parents, iters, increment, numwanted, realign, blastlocation, m->getRandomNumber()));
+			}
+			seed = m->getRandomNumber();
 		}
-		
-		if (m->control_pressed) { delete chimera; return 0; }
-		
-		if (chimera->getUnaligned()) { delete chimera; m->mothurOut("Your template sequences are different lengths, please correct."); m->mothurOutEndLine(); m->control_pressed = true; return 0; }
-		templateSeqsLength = chimera->getLength();
-		
+
+		if (m->control_pressed) { delete chimeras[0]; return 0; }
+
+		if (chimeras[0]->getUnaligned()) {
+			delete chimeras[0];
+			lock_guard<mutex> guard(printMutex);
+			m->mothurOut("Your template sequences are different lengths, please correct."); m->mothurOutEndLine(); m->control_pressed = true; return 0;
+		}
+		int templateSeqsLength = chimeras[0]->getLength();
+
+		//the copies share the templates and search databases of the first
+		for (int i = 1; i < numThreads; i++) { chimeras.push_back(new ChimeraSlayer(chimeras[0])); }
+
 		ofstream out;
 		m->openOutputFile(outputFName, out);
-		
+
 		ofstream out2;
 		m->openOutputFile(accnos, out2);
-		
+
 		ofstream out3;
 		if (trim) {  m->openOutputFile(fasta, out3); }
-		
+
 		ifstream inFASTA;
 		m->openInputFile(filename, inFASTA);
 
-		inFASTA.seekg(filePos.start);
-		
-		if (filePos.start == 0) { chimera->printHeader(out); }
+		{
+			lock_guard<mutex> guard(printMutex);
+			chimeras[0]->printHeader(out);
+		}
 
-		bool done = false;
 		int count = 0;
-	
-		while (!done) {
-		
-			if (m->control_pressed) {	delete chimera; out.close(); out2.close(); if (trim) { out3.close(); } inFASTA.close(); return 1;	}
-		
-			Sequence* candidateSeq = new Sequence(inFASTA);  m->gobble(inFASTA);
-			string candidateAligned = candidateSeq->getAligned();
-			
-			if (candidateSeq->getName() != "") { //incase there is a commented sequence at the end of a file
-				if (candidateSeq->getAligned().length() != templateSeqsLength) {  
-					m->mothurOut(candidateSeq->getName() + " is not the same length as the template sequences. Skipping."); m->mothurOutEndLine();
-				}else{
-					//find chimeras
-					chimera->getChimeras(candidateSeq);
-					
-					if (m->control_pressed) {	delete chimera; delete candidateSeq; return 1;	}
-						
-					//if you are not chimeric, then check each half
-					data_results wholeResults = chimera->getResults();
-					
-					//determine if we need to split
-					bool isChimeric = false;
-					
-					if (wholeResults.flag == "yes") {
-						string chimeraFlag = "no";
-						if(  (wholeResults.results[0].bsa >= minBS && wholeResults.results[0].divr_qla_qrb >= divR)
-						   ||
-						   (wholeResults.results[0].bsb >= minBS && wholeResults.results[0].divr_qlb_qra >= divR) ) { chimeraFlag = "yes"; }
-						
-						
-						if (chimeraFlag == "yes") {	
-							if ((wholeResults.results[0].bsa >= minBS) || (wholeResults.results[0].bsb >= minBS)) { isChimeric = true; }
-						}
-					}
-					
-					if ((!isChimeric) && trimera) {
-						
-						//split sequence in half by bases
-						string leftQuery, rightQuery;
-						Sequence tempSeq(candidateSeq->getName(), candidateAligned);
-						divideInHalf(tempSeq, leftQuery, rightQuery);
-						
-						//run chimeraSlayer on each piece
-						Sequence* left = new Sequence(candidateSeq->getName(), leftQuery);
-						Sequence* right = new Sequence(candidateSeq->getName(), rightQuery);
-						
-						//find chimeras
-						chimera->getChimeras(left);
-						data_results leftResults = chimera->getResults();
-						
-						chimera->getChimeras(right);
-						data_results rightResults = chimera->getResults();
-						
-						//if either piece is chimeric then report
-						Sequence trimmed = chimera->print(out, out2, leftResults, rightResults);
-						if (trim) { trimmed.printSequence(out3);  }
-						
-						delete left; delete right;
-						
-					}else { //already chimeric
-						//print results
-						Sequence trimmed = chimera->print(out, out2);
-						if (trim) { trimmed.printSequence(out3);  }
-					}
-					
-					
+		int batchSize = 100 * numThreads;
+		Sequence nextSeq; bool hasNext = false;
+
+		while (!m->control_pressed) {
+
+			slayerData data(seed + count);
+			if (hasNext) { data.seqs.push_back(nextSeq); hasNext = false; }
+
+			while (!inFASTA.eof() && (data.seqs.size() < batchSize)) {
+				Sequence candidateSeq(inFASTA);  m->gobble(inFASTA);
+				if (candidateSeq.getName() == "") { continue; } //incase there is a commented sequence at the end of a file
+
+				//a less abundant sequence is compared to this batch, so it waits for the next one
+				if ((templatefile == "self") && (data.seqs.size() != 0)) {
+					map<string, int>::iterator itFirst = priority.find(data.seqs[0].getName());
+					map<string, int>::iterator itThis = priority.find(candidateSeq.getName());
+					int firstAbund = 0; if (itFirst != priority.end()) { firstAbund = itFirst->second; }
+					int thisAbund = 0; if (itThis != priority.end()) { thisAbund = itThis->second; }
+					if (thisAbund != firstAbund) { nextSeq = candidateSeq; hasNext = true; break; }
 				}
-				count++;
+
+				data.seqs.push_back(candidateSeq);
 			}
-			
-			#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-				unsigned long long pos = inFASTA.tellg();
-				if ((pos == -1) || (pos >= filePos.end)) { break; }
-			#else
-				if (inFASTA.eof()) { break; }
-			#endif
-			
-			delete candidateSeq;
+
+			int numItems = data.seqs.size();
+			if (numItems == 0) { break; }
+
+			data.report.resize(numItems); data.accnos.resize(numItems); data.trimmed.resize(numItems); data.warnings.resize(numItems);
+
+			int numWorkers = numThreads;
+			if (numWorkers > numItems) { numWorkers = numItems; }
+
+			vector<thread*> workerThreads;
+			for (int i = 1; i < numWorkers; i++) { workerThreads.push_back(new thread(&ChimeraSlayerCommand::driverThread, this, chimeras[i], &data, templateSeqsLength)); }
+			driverThread(chimeras[0], &data, templateSeqsLength);
+			for (int i = 0; i < workerThreads.size(); i++) { workerThreads[i]->join(); delete workerThreads[i]; }
+
+			if (m->control_pressed) { break; }
+
+			for (int i = 0; i < numItems; i++) {
+				out << data.report[i];
+				out2 << data.accnos[i];
+				if (trim) { out3 << data.trimmed[i]; }
+
+				if (data.warnings[i] != "") { lock_guard<mutex> guard(printMutex); m->mothurOut(data.warnings[i]); m->mothurOutEndLine(); }
+				else if (data.accnos[i] != "") {
+					{ lock_guard<mutex> guard(printMutex); m->mothurOut(data.seqs[i].getName() + "\tyes"); m->mothurOutEndLine(); }
+					if (templatefile == "self") { for (int j = 0; j < chimeras.size(); j++) { chimeras[j]->addChimericSeq(data.seqs[i].getName()); } }
+				}
+			}
+
 			//report progress
-			if((count) % 100 == 0){	m->mothurOutJustToScreen("Processing sequence: " + toString(count) + "\n");		}
+			if ((count / 100) != ((count + numItems) / 100)) { lock_guard<mutex> guard(printMutex); m->mothurOutJustToScreen("Processing sequence: " + toString(count + numItems) + "\n"); }
+			count += numItems;
 		}
 		//report progress
-		if((count) % 100 != 0){	m->mothurOutJustToScreen("Processing sequence: " + toString(count)+ "\n"); 		}
-		
-		int numNoParents = chimera->getNumNoParents();
-		if (numNoParents == count) { m->mothurOut("[WARNING]: megablast returned 0 potential parents for all your sequences. This could be due to formatdb.exe not being setup properly, please check formatdb.log for errors."); m->mothurOutEndLine(); } 
-		
+		if((count) % 100 != 0){	lock_guard<mutex> guard(printMutex); m->mothurOutJustToScreen("Processing sequence: " + toString(count)+ "\n"); 		}
+
+		int numNoParents = 0;
+		for (int i = 0; i < chimeras.size(); i++) { numNoParents += chimeras[i]->getNumNoParents(); }
+		if (numNoParents == count) { lock_guard<mutex> guard(printMutex); m->mothurOut("[WARNING]: the blast search returned 0 potential parents for all your sequences."); m->mothurOutEndLine(); }
+
 		out.close();
 		out2.close();
 		if (trim) { out3.close(); }
 		inFASTA.close();
-		delete chimera;
-				
+		for (int i = 0; i < chimeras.size(); i++) { delete chimeras[i]; }
+
+		if (m->control_pressed) { return 1; }
+
 		return count;
-		
-		
 	}
 	catch(exception& e) {
 		m->errorOut(e, "ChimeraSlayerCommand", "driver");
@@ -1602,154 +1334,84 @@ int ChimeraSlayerCommand::driver(linePair filePos, string outputFName, string fi
 	}
 }
 /**************************************************************************************************/
-
-int ChimeraSlayerCommand::createProcesses(string outputFileName, string filename, string accnos, string fasta, map<string, int>& thisPriority) {
+//checks the next sequence of the batch until there are none left
+void ChimeraSlayerCommand::driverThread(ChimeraSlayer* chimera, slayerData* data, int templateSeqsLength) {
 	try {
-		int process = 0;
-		int num = 0;
-		processIDS.clear();
-        bool recalc = false;
-        
-        if (m->debug) { m->mothurOut("[DEBUG]: filename = " + filename + "\n"); }
-		
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-		//loop through and create all the processes you want
-		while (process != processors) {
-			pid_t pid = fork();
-			
-			if (pid > 0) {
-				processIDS.push_back(pid);  //create map from line number to pid so you can append files in correct order later
-				process++;
-			}else if (pid == 0){
-				num = driver(lines[process], outputFileName + toString(m->mothurGetpid(process)) + ".temp", filename, accnos + toString(m->mothurGetpid(process)) + ".temp", fasta + toString(m->mothurGetpid(process)) + ".temp", thisPriority);
-				
-				//pass numSeqs to parent
-				ofstream out;
-				string tempFile = outputFileName + toString(m->mothurGetpid(process)) + ".num.temp";
-				m->openOutputFile(tempFile, out);
-				out << num << endl;
-				out.close();
-				exit(0);
-            }else {
-                m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(process) + "\n"); processors = process;
-                for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-                //wait to die
-                for (int i=0;i<processIDS.size();i++) {
-                    int temp = processIDS[i];
-                    wait(&temp);
-                }
-                m->control_pressed = false;
-                recalc = true;
-                break;
-            }
-		}
-        
-        if (recalc) {
-            //test line, also set recalc to true.
-            //for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); } for (int i=0;i<processIDS.size();i++) { int temp = processIDS[i]; wait(&temp); } m->control_pressed = false;  processors=3; m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(processors) + "\n");
-            lines.clear();
-            vector<unsigned long long> positions = m->divideFile(filename, processors);
-            for (int i = 0; i < (positions.size()-1); i++) {	lines.push_back(linePair(positions[i], positions[(i+1)]));	}
-            
-            num = 0;
-            processIDS.resize(0);
-            process = 0;
-            
-            while (process != processors) {
-                pid_t pid = fork();
-                
-                if (pid > 0) {
-                    processIDS.push_back(pid);  //create map from line number to pid so you can append files in correct order later
-                    process++;
-                }else if (pid == 0){
-                    num = driver(lines[process], outputFileName + toString(m->mothurGetpid(process)) + ".temp", filename, accnos + toString(m->mothurGetpid(process)) + ".temp", fasta + toString(m->mothurGetpid(process)) + ".temp", thisPriority);
-                    
-                    //pass numSeqs to parent
-                    ofstream out;
-                    string tempFile = outputFileName + toString(m->mothurGetpid(process)) + ".num.temp";
-                    m->openOutputFile(tempFile, out);
-                    out << num << endl;
-                    out.close();
-                    exit(0);
-                }else {
-                    m->mothurOut("[ERROR]: unable to spawn the necessary processes."); m->mothurOutEndLine();
-                    for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-                    exit(0);
-                }
-            }
-        }
+		while (!m->control_pressed) {
+			int i = data->nextItem++;
+			if (i >= data->seqs.size()) { break; }
 
-		
-		//force parent to wait until all the processes are done
-		for (int i=0;i<processors;i++) { 
-			int temp = processIDS[i];
-			wait(&temp);
-		}
-		
-		for (int i = 0; i < processIDS.size(); i++) {
-			ifstream in;
-			string tempFile =  outputFileName + toString(processIDS[i]) + ".num.temp";
-			m->openInputFile(tempFile, in);
-			if (!in.eof()) { int tempNum = 0;  in >> tempNum; num += tempNum; }
-			in.close(); m->mothurRemove(tempFile);
-		}
-#else
-		
-		//////////////////////////////////////////////////////////////////////////////////////////////////////
-		//Windows version shared memory, so be careful when passing variables through the slayerData struct. 
-		//Above fork() will clone, so memory is separate, but that's not the case with windows, 
-		//////////////////////////////////////////////////////////////////////////////////////////////////////
-		
-		vector<slayerData*> pDataArray; 
-		DWORD   dwThreadIdArray[processors];
-		HANDLE  hThreadArray[processors]; 
-		
-		//Create processor worker threads.
-		for( int i=0; i<processors; i++ ){
-			string extension = toString(i) + ".temp";
-			slayerData* tempslayer = new slayerData((outputFileName + extension), (fasta + extension), (accnos + extension), filename, templatefile, search, blastlocation, trimera, trim, realign, m, lines[i].start, lines[i].end, ksize, match, mismatch, window, minSimilarity, minCoverage, minBS, minSNP, parents, iters, increment, numwanted, divR, priority, i);
-			pDataArray.push_back(tempslayer);
-			processIDS.push_back(i);
-			
-			//MySlayerThreadFunction is in header. It must be global or static to work with the threads.
-			//default security attributes, thread function name, argument to thread function, use default creation flags, returns the thread identifier
-			hThreadArray[i] = CreateThread(NULL, 0, MySlayerThreadFunction, pDataArray[i], 0, &dwThreadIdArray[i]);   
-		}
-				
-		//Wait until all threads have terminated.
-		WaitForMultipleObjects(processors, hThreadArray, TRUE, INFINITE);
-		
-		//Close all thread handles and free memory allocations.
-		for(int i=0; i < pDataArray.size(); i++){
-			num += pDataArray[i]->count;
-			CloseHandle(hThreadArray[i]);
-			delete pDataArray[i];
-		}
-#endif	
-		
-		rename((outputFileName + toString(processIDS[0]) + ".temp").c_str(), outputFileName.c_str());
-		rename((accnos + toString(processIDS[0]) + ".temp").c_str(), accnos.c_str());
-		if (trim) {  rename((fasta + toString(processIDS[0]) + ".temp").c_str(), fasta.c_str()); }
-		
-		//append output files
-		for(int i=1;i<processIDS.size();i++){
-			m->appendFiles((outputFileName + toString(processIDS[i]) + ".temp"), outputFileName);
-			m->mothurRemove((outputFileName + toString(processIDS[i]) + ".temp"));
-			
-			m->appendFiles((accnos + toString(processIDS[i]) + ".temp"), accnos);
-			m->mothurRemove((accnos + toString(processIDS[i]) + ".temp"));
-			
-			if (trim) {
-				m->appendFiles((fasta + toString(processIDS[i]) + ".temp"), fasta);
-				m->mothurRemove((fasta + toString(processIDS[i]) + ".temp"));
+			Sequence* candidateSeq = &(data->seqs[i]);
+			string candidateAligned = candidateSeq->getAligned();
+
+			if (candidateAligned.length() != templateSeqsLength) {
+				data->warnings[i] = candidateSeq->getName() + " is not the same length as the template sequences. Skipping.";
+				continue;
 			}
+
+			mt19937_64 engine(data->seed + i);
+			chimera->setRandomEngine(&engine);
+
+			ostringstream out, out2, out3;
+
+			//find chimeras
+			chimera->getChimeras(candidateSeq);
+
+			if (m->control_pressed) { chimera->setRandomEngine(NULL); break; }
+
+			//if you are not chimeric, then check each half
+			data_results wholeResults = chimera->getResults();
+
+			//determine if we need to split
+			bool isChimeric = false;
+
+			if (wholeResults.flag == "yes") {
+				string chimeraFlag = "no";
+				if(  (wholeResults.results[0].bsa >= minBS && wholeResults.results[0].divr_qla_qrb >= divR)
+				   ||
+				   (wholeResults.results[0].bsb >= minBS && wholeResults.results[0].divr_qlb_qra >= divR) ) { chimeraFlag = "yes"; }
+
+
+				if (chimeraFlag == "yes") {
+					if ((wholeResults.results[0].bsa >= minBS) || (wholeResults.results[0].bsb >= minBS)) { isChimeric = true; }
+				}
+			}
+
+			if ((!isChimeric) && trimera) {
+
+				//split sequence in half by bases
+				string leftQuery, rightQuery;
+				Sequence tempSeq(candidateSeq->getName(), candidateAligned);
+				divideInHalf(tempSeq, leftQuery, rightQuery);
+
+				//run chimeraSlayer on each piece
+				Sequence left(candidateSeq->getName(), leftQuery);
+				Sequence right(candidateSeq->getName(), rightQuery);
+
+				//find chimeras
+				chimera->getChimeras(&left);
+				data_results leftResults = chimera->getResults();
+
+				chimera->getChimeras(&right);
+				data_results rightResults = chimera->getResults();
+
+				//if either piece is chimeric then report
+				Sequence trimmed = chimera->print(out, out2, leftResults, rightResults);
+				if (trim) { trimmed.printSequence(out3);  }
+
+			}else { //already chimeric
+				//print results
+				Sequence trimmed = chimera->print(out, out2);
+				if (trim) { trimmed.printSequence(out3);  }
+			}
+
+			chimera->setRandomEngine(NULL);
+
+			data->report[i] = out.str(); data->accnos[i] = out2.str(); data->trimmed[i] = out3.str();
 		}
-		
-		
-		return num;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "ChimeraSlayerCommand", "createProcesses");
+		m->errorOut(e, "ChimeraSlayerCommand", "driverThread");
 		exit(1);
 	}
 }
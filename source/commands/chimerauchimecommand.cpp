@@ -10,7 +10,7 @@
 #include "chimerauchimecommand.h"
 #include "deconvolutecommand.h"
 #include "sequence.hpp"
-#include "systemcommand.h"
+#include "uchime.h"
 
 //**********************************************************************************************************************
 vector<string> ChimeraUchimeCommand::setParameters(){	
@@ -120,7 +120,7 @@ string ChimeraUchimeCommand::getOutputPattern(string type) {
 //**********************************************************************************************************************
 ChimeraUchimeCommand::ChimeraUchimeCommand(){	
 	try {
-		abort = true; calledHelp = true;
+		abort = true; calledHelp = true; refDB = NULL;
 		setParameters();
 		vector<string> tempOutNames;
 		outputTypes["chimera"] = tempOutNames;
@@ -136,7 +136,7 @@ ChimeraUchimeCommand::ChimeraUchimeCommand(){
 //***************************************************************************************************************
 ChimeraUchimeCommand::ChimeraUchimeCommand(string option)  {
 	try {
-		abort = false; calledHelp = false; hasName=false; hasCount=false;
+		abort = false; calledHelp = false; hasName=false; hasCount=false; refDB = NULL;
 		
 		//allow user to run help
 		if(option == "help") { help(); abort = true; calledHelp = true; }
@@ -554,51 +554,7 @@ ChimeraUchimeCommand::ChimeraUchimeCommand(string option)  {
 			if (hasName && (templatefile != "self")) { m->mothurOut("You have provided a namefile and the reference parameter is not set to self. I am not sure what reference you are trying to use, aborting."); m->mothurOutEndLine(); abort=true; }
             if (hasCount && (templatefile != "self")) { m->mothurOut("You have provided a countfile and the reference parameter is not set to self. I am not sure what reference you are trying to use, aborting."); m->mothurOutEndLine(); abort=true; }
 			if (hasGroup && (templatefile != "self")) { m->mothurOut("You have provided a group file and the reference parameter is not set to self. I am not sure what reference you are trying to use, aborting."); m->mothurOutEndLine(); abort=true; }
-			
-			//look for uchime exe
-			path = m->mothurProgramPath;
-			
-			string uchimeCommand;
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-			uchimeCommand = path + "uchime";	//	format the database, -o option gives us the ability
-            if (m->debug) { 
-                m->mothurOut("[DEBUG]: Uchime location using \"which uchime\" = "); 
-                Command* newCommand = new SystemCommand("which uchime"); m->mothurOutEndLine();
-                newCommand->execute();
-                delete newCommand;
-                m->mothurOut("[DEBUG]: Mothur's location using \"which mothur\" = "); 
-                newCommand = new SystemCommand("which mothur"); m->mothurOutEndLine();
-                newCommand->execute();
-                delete newCommand;
-            }
-#else
-			uchimeCommand = path + "\\uchime.exe";
-#endif
-        
-			//test to make sure uchime exists
-			ifstream in;
-			uchimeCommand = m->getFullPathName(uchimeCommand);
-			int ableToOpen = m->openInputFile(uchimeCommand, in, "no error"); in.close();
-			if(ableToOpen == 1) {	
-                m->mothurOut(uchimeCommand + " file does not exist. Checking path... \n");
-                //check to see if uchime is in the path??
-                
-                string uLocation = ""; 
-                
-                ifstream in2;
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-                uLocation = m->findProgramPath("uchime");
-                ableToOpen = m->openInputFile(uLocation, in2, "no error"); in2.close();
-#else
-                uLocation = m->findProgramPath("uchime.exe");
-                ableToOpen = m->openInputFile(uLocation, in2, "no error"); in2.close();
-#endif
 
-                if(ableToOpen == 1) { m->mothurOut("[ERROR]: " + uLocation + " file does not exist. mothur requires the uchime executable."); m->mothurOutEndLine(); abort = true; } 
-                else {  m->mothurOut("Found uchime in your path, using " + uLocation + "\n");uchimeLocation = uLocation; }
-            }else {  uchimeLocation = uchimeCommand; }
-            
-            uchimeLocation = m->getFullPathName(uchimeLocation);
         }
 	}
 	catch(exception& e) {
@@ -607,6 +563,10 @@ ChimeraUchimeCommand::ChimeraUchimeCommand(string option)  {
 	}
 }
 //***************************************************************************************************************
+ChimeraUchimeCommand::~ChimeraUchimeCommand(){
+	if (refDB != NULL) { UChimeFreeDB(refDB); }
+}
+//***************************************************************************************************************
 
 int ChimeraUchimeCommand::execute(){
 	try{
@@ -615,6 +575,12 @@ int ChimeraUchimeCommand::execute(){
 		
 		m->mothurOut("\nuchime by Robert C. Edgar\nhttp://drive5.com/uchime\nThis code is donated to the public domain.\n\n");
 		
+        //uchime runs inside mothur, its options are set once and the reference is read once for all the files and threads
+        try {
+            UChimeSetOpts(getUchimeOptions());
+            if (templatefile != "self") { refDB = UChimeReadDB(templatefile); }
+        }catch(runtime_error& e) { m->mothurOut("[ERROR]: " + string(e.what()) + "\n"); return 0; }
+        
 		for (int s = 0; s < fastaFileNames.size(); s++) {
 			
 			m->mothurOut("Checking sequences from " + fastaFileNames[s] + " ..." ); m->mothurOutEndLine();
@@ -629,7 +595,6 @@ int ChimeraUchimeCommand::execute(){
 			string outputFileName = getOutputFileName("chimera", variables);
 			string accnosFileName = getOutputFileName("accnos", variables);
 			string alnsFileName = getOutputFileName("alns", variables);
-			string newFasta = m->getRootName(fastaFileNames[s]) + "temp";
             string newCountFile = "";
 				
 			//you provided a groupfile
@@ -643,9 +608,10 @@ int ChimeraUchimeCommand::execute(){
                 newCountFile = getOutputFileName("count", variables);
             }
 			
+			vector<seqPriorityNode> nameMapCount;
 			if ((templatefile == "self") && (!hasGroup)) { //you want to run uchime with a template=self and no groups
 
-				if (processors != 1) { m->mothurOut("When using template=self, mothur can only use 1 processor, continuing."); m->mothurOutEndLine(); processors = 1; }
+				if (processors != 1) { m->mothurOut("When using template=self, mothur can only use 1 processor, continuing."); m->mothurOutEndLine(); }
 				if (nameFileNames.size() != 0) { //you provided a namefile and we don't need to create one
 					nameFile = nameFileNames[s];
 				}else { nameFile = getNamesFile(fastaFileNames[s]); }
@@ -654,7 +620,6 @@ int ChimeraUchimeCommand::execute(){
 				readFasta(fastaFileNames[s], seqs);  if (m->control_pressed) { for (int j = 0; j < outputNames.size(); j++) {	m->mothurRemove(outputNames[j]);	}  return 0; }
 
 				//read namefile
-				vector<seqPriorityNode> nameMapCount;
                 int error;
                 if (hasCount) {
                     CountTable ct;
@@ -673,8 +638,8 @@ int ChimeraUchimeCommand::execute(){
 				if (error == 1) { for (int j = 0; j < outputNames.size(); j++) {	m->mothurRemove(outputNames[j]);	}  return 0; }
 				if (seqs.size() != nameMapCount.size()) { m->mothurOut( "The number of sequences in your fastafile does not match the number of sequences in your namefile, aborting."); m->mothurOutEndLine(); for (int j = 0; j < outputNames.size(); j++) {	m->mothurRemove(outputNames[j]);	}  return 0; }
 				
-                m->printVsearchFile(nameMapCount, newFasta, "/ab=", "/");
-				fastaFileNames[s] = newFasta;
+                //most abundant first
+                sort(nameMapCount.begin(), nameMapCount.end(), compareSeqPriorityNodes);
 			}
 			
 			if (m->control_pressed) {  for (int j = 0; j < outputNames.size(); j++) {	m->mothurRemove(outputNames[j]);	}  return 0;	}				
@@ -705,29 +670,14 @@ int ChimeraUchimeCommand::execute(){
 				m->openOutputFile(outputFileName, out); out.close(); 
 				m->openOutputFile(accnosFileName, out1); out1.close();
 				if (chimealns) { m->openOutputFile(alnsFileName, out2); out2.close(); }
-				int totalSeqs = 0;
 				
-				if(processors == 1)	{	totalSeqs = driverGroups(outputFileName, newFasta, accnosFileName, alnsFileName, newCountFile, 0, groups.size(), groups);
-                    
-                    if (hasCount && dups) {
-                        CountTable c; c.readTable(nameFile, true, false);
-                        if (!m->isBlank(newCountFile)) {
-                            ifstream in2;
-                            m->openInputFile(newCountFile, in2);
-                            
-                            string name, group;
-                            while (!in2.eof()) {
-                                in2 >> name >> group; m->gobble(in2);
-                                c.setAbund(name, group, 0);
-                            }
-                            in2.close();
-                        }
-                        m->mothurRemove(newCountFile);
-                        c.printTable(newCountFile);
-                    }
-
-                }else{	totalSeqs = createProcessesGroups(outputFileName, newFasta, accnosFileName, alnsFileName, newCountFile, groups, nameFile, groupFile, fastaFileNames[s]);			}
-
+                //the groups are shared by the threads
+                uchimeData data(outputFileName, accnosFileName, alnsFileName);
+                data.groups = groups;
+                int totalSeqs = createProcesses(data, processors);
+                
+                appendResults(data, nameFile, newCountFile);
+                
 				if (m->control_pressed) {  for (int j = 0; j < outputNames.size(); j++) {	m->mothurRemove(outputNames[j]);	}  return 0;	}				
                
                 
@@ -768,26 +718,43 @@ int ChimeraUchimeCommand::execute(){
 			}else{
 				if (m->control_pressed) {  for (int j = 0; j < outputNames.size(); j++) {	m->mothurRemove(outputNames[j]);	}  return 0;	}
 			
-				int numSeqs = 0;
-				int numChimeras = 0;
-
-				if(processors == 1){ numSeqs = driver(outputFileName, fastaFileNames[s], accnosFileName, alnsFileName, numChimeras); }
-				else{	numSeqs = createProcesses(outputFileName, fastaFileNames[s], accnosFileName, alnsFileName, numChimeras); }
-				
-				//add headings
-				ofstream out;
-				m->openOutputFile(outputFileName+".temp", out); 
+				//clears files and adds headings
+				ofstream out, out1, out2;
+				m->openOutputFile(outputFileName, out);
 				out << "Score\tQuery\tParentA\tParentB\tIdQM\tIdQA\tIdQB\tIdAB\tIdQT\tLY\tLN\tLA\tRY\tRN\tRA\tDiv\tYN\n";
 				out.close();
+				m->openOutputFile(accnosFileName, out1); out1.close();
+				if (chimealns) { m->openOutputFile(alnsFileName, out2); out2.close(); }
 				
-				m->appendFiles(outputFileName, outputFileName+".temp");
-				m->mothurRemove(outputFileName); rename((outputFileName+".temp").c_str(), outputFileName.c_str());
+                //template=self is checked in one block, the reference is checked in a block of sequences per processor
+                uchimeData data(outputFileName, accnosFileName, alnsFileName);
+                if (templatefile == "self") { data.blocks.push_back(nameMapCount); }
+                else {
+                    vector<seqPriorityNode> seqs;
+                    readFasta(fastaFileNames[s], seqs);
+                    
+                    int numBlocks = processors;
+                    if (numBlocks > seqs.size()) { numBlocks = seqs.size(); }
+                    if (numBlocks < 1) { numBlocks = 1; }
+                    
+                    //blocks are in file order, so the results come out in the order of the fasta file
+                    int startIndex = 0;
+                    for (int i = 0; i < numBlocks; i++) {
+                        int endIndex = ((i+1) * seqs.size()) / numBlocks;
+                        data.blocks.push_back(vector<seqPriorityNode>(seqs.begin()+startIndex, seqs.begin()+endIndex));
+                        startIndex = endIndex;
+                    }
+                }
+                nameMapCount.clear();
+                
+				int numSeqs = createProcesses(data, processors);
+				int numChimeras = 0;
+                for (int i = 0; i < data.numChimeras.size(); i++) { numChimeras += data.numChimeras[i]; }
+                
+                appendResults(data, "", "");
 				
 				if (m->control_pressed) { for (int j = 0; j < outputNames.size(); j++) {	m->mothurRemove(outputNames[j]);	} return 0; }
 			
-				//remove file made for uchime
-				if (templatefile == "self") {  m->mothurRemove(fastaFileNames[s]); }
-			
 				m->mothurOutEndLine(); m->mothurOut("It took " + toString(time(NULL) - start) + " secs to check " + toString(numSeqs) + " sequences. " + toString(numChimeras) + " chimeras were found.");	m->mothurOutEndLine();
 			}
 			
@@ -1142,373 +1109,157 @@ string ChimeraUchimeCommand::getNamesFile(string& inputFile){
 	}
 }
 //**********************************************************************************************************************
-int ChimeraUchimeCommand::driverGroups(string outputFName, string filename, string accnos, string alns, string countlist, int start, int end, vector<string> groups){
+//reference sequences are checked in file order, the name is uchime's label so it includes the comment
+int ChimeraUchimeCommand::readFasta(string filename, vector<seqPriorityNode>& seqs){
 	try {
+		ifstream in;
+		m->openInputFile(filename, in);
 		
-		int totalSeqs = 0;
-		int numChimeras = 0;
-        
-        
-        ofstream outCountList;
-        if (hasCount && dups) { m->openOutputFile(countlist, outCountList); }
-        
-		for (int i = start; i < end; i++) {
-			int start = time(NULL);	 if (m->control_pressed) {  outCountList.close(); m->mothurRemove(countlist); return 0; }
-            
-			int error;
-            long long numSeqs = 0;
-            if (hasCount) { error = cparser->getSeqs(groups[i], filename, "/ab=", "/", numSeqs, true); if ((error == 1) || m->control_pressed) {  return 0; } }
-            else { error = sparser->getSeqs(groups[i], filename, "/ab=", "/", numSeqs, true); if ((error == 1) || m->control_pressed) {  return 0; } }
-			totalSeqs += numSeqs;
-            
-			driver((outputFName + groups[i]), filename, (accnos+groups[i]), (alns+ groups[i]), numChimeras);
-			
-			if (m->control_pressed) { return 0; }
-			
-			//remove file made for uchime
-			if (!m->debug) {  m->mothurRemove(filename);  }
-            else { m->mothurOut("[DEBUG]: saving file: " + filename + ".\n"); }
+		while (!in.eof()) {
 			
-            //if we provided a count file with group info and set dereplicate=t, then we want to create a *.pick.count_table
-            //This table will zero out group counts for seqs determined to be chimeric by that group.
-            if (dups) {
-                if (!m->isBlank(accnos+groups[i])) {
-                    ifstream in;
-                    m->openInputFile(accnos+groups[i], in);
-                    string name;
-                    if (hasCount) {
-                        while (!in.eof()) {
-                            in >> name; m->gobble(in);
-                            outCountList << name << '\t' << groups[i] << endl;
-                        }
-                        in.close();
-                    }else {
-                        map<string, string> thisnamemap = sparser->getNameMap(groups[i]);
-                        map<string, string>::iterator itN;
-                        ofstream out;
-                        m->openOutputFile(accnos+groups[i]+".temp", out);
-                        while (!in.eof()) {
-                            in >> name; m->gobble(in); 
-                            itN = thisnamemap.find(name);
-                            if (itN != thisnamemap.end()) {
-                                vector<string> tempNames; m->splitAtComma(itN->second, tempNames); 
-                                for (int j = 0; j < tempNames.size(); j++) { out << tempNames[j] << endl; }
-                                
-                            }else { m->mothurOut("[ERROR]: parsing cannot find " + name + ".\n"); m->control_pressed = true; }
-                        }
-                        out.close();
-                        in.close();
-                        m->renameFile(accnos+groups[i]+".temp", accnos+groups[i]);
-                    }
-                   
-                }
-            }
-            
-			//append files
-			m->appendFiles((outputFName+groups[i]), outputFName); m->mothurRemove((outputFName+groups[i]));
-			m->appendFiles((accnos+groups[i]), accnos); m->mothurRemove((accnos+groups[i]));
-			if (chimealns) { m->appendFiles((alns+groups[i]), alns); m->mothurRemove((alns+groups[i])); }
+			if (m->control_pressed) { break; }
 			
-			m->mothurOutEndLine(); m->mothurOut("It took " + toString(time(NULL) - start) + " secs to check " + toString(numSeqs) + " sequences from group " + groups[i] + ".");	m->mothurOutEndLine();					
+			Sequence seq(in); m->gobble(in);
+			if (seq.getName() != "") { seqs.push_back(seqPriorityNode(1, seq.getAligned(), seq.getName() + seq.getComment())); }
 		}
-
-        if (hasCount && dups) { outCountList.close(); }
-        
-        return totalSeqs;
+		in.close();
 		
+		return 0;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "ChimeraUchimeCommand", "driverGroups");
+		m->errorOut(e, "ChimeraUchimeCommand", "readFasta");
 		exit(1);
 	}
-}	
+}
 //**********************************************************************************************************************
-
-int ChimeraUchimeCommand::driver(string outputFName, string filename, string accnos, string alns, int& numChimeras){
+vector<string> ChimeraUchimeCommand::getUchimeOptions(){
 	try {
+		vector<string> options;
+		
+		if (strand != "")		{ options.push_back("--strand");			options.push_back(strand);			}
+		if (useAbskew)			{ options.push_back("--abskew");			options.push_back(abskew);			}
+		if (useMinH)			{ options.push_back("--minh");				options.push_back(minh);			}
+		if (useMindiv)			{ options.push_back("--mindiv");			options.push_back(mindiv);			}
+		if (useXn)				{ options.push_back("--xn");				options.push_back(xn);				}
+		if (useDn)				{ options.push_back("--dn");				options.push_back(dn);				}
+		if (useXa)				{ options.push_back("--xa");				options.push_back(xa);				}
+		if (useChunks)			{ options.push_back("--chunks");			options.push_back(chunks);			}
+		if (useMinchunk)		{ options.push_back("--minchunk");			options.push_back(minchunk);		}
+		if (useIdsmoothwindow)	{ options.push_back("--idsmoothwindow");	options.push_back(idsmoothwindow);	}
+		if (useMaxp)			{ options.push_back("--maxp");				options.push_back(maxp);			}
+		if (!skipgaps)			{ options.push_back("--noskipgaps");											}
+		if (!skipgaps2)			{ options.push_back("--noskipgaps2");											}
+		if (useMinlen)			{ options.push_back("--minlen");			options.push_back(minlen);			}
+		if (useMaxlen)			{ options.push_back("--maxlen");			options.push_back(maxlen);			}
+		if (ucl)				{ options.push_back("--ucl");													}
+		if (useQueryfract)		{ options.push_back("--queryfract");		options.push_back(queryfract);		}
+		
+		//mothur reports the progress
+		options.push_back("--quiet");
+		
+		if (m->debug) { m->mothurOut("[DEBUG]: uchime options = " + m->getStringFromVector(options, " ") + ".\n"); }
+		
+		return options;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ChimeraUchimeCommand", "getUchimeOptions");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+int ChimeraUchimeCommand::createProcesses(uchimeData& data, int numThreads) {
+	try {
+		int numItems = data.getNumItems();
+		data.numSeqs.assign(numItems, 0);
+		data.numChimeras.assign(numItems, 0);
 		
-		outputFName = m->getFullPathName(outputFName);
-		filename = m->getFullPathName(filename);
-		alns = m->getFullPathName(alns);
-		
-		//to allow for spaces in the path
-		outputFName = "\"" + outputFName + "\"";
-		filename = "\"" + filename + "\"";
-		alns = "\"" + alns + "\"";
-        
-        if (filename.length() > 257) {
-            m->mothurOut("[ERROR]: " + filename + " filename is " + toString(filename.length()) + " long. The uchime program can't handle files with a full path longer than 257 characters, please correct.\n"); m->control_pressed = true; return 0;
-        }else if ((alns.length() > 257) && (chimealns)) {
-            m->mothurOut("[ERROR]: " + alns + " filename is " + toString(alns.length()) + " long. The uchime program can't handle files with a full path longer than 257 characters, please correct.\n"); m->control_pressed = true; return 0;
-        }else if (outputFName.length() > 257) {
-            m->mothurOut("[ERROR]: " + outputFName + " filename is " + toString(outputFName.length()) + " long. The uchime program can't handle files with a full path longer than 257 characters, please correct input file name.\n"); m->control_pressed = true; return 0;
-        }
-				
-		vector<char*> cPara;
-		
-		string uchimeCommand = uchimeLocation;
-        uchimeCommand = "\"" + uchimeCommand + "\" ";
-        
-        char* tempUchime;
-		tempUchime= new char[uchimeCommand.length()+1]; 
-		*tempUchime = '\0';
-		strncat(tempUchime, uchimeCommand.c_str(), uchimeCommand.length());
-		cPara.push_back(tempUchime);
-		
-        //are you using a reference file
-		if (templatefile != "self") {
-            string outputFileName = filename.substr(1, filename.length()-2) + ".uchime_formatted";
-            prepFile(filename.substr(1, filename.length()-2), outputFileName);
-            filename = outputFileName;
-            filename = "\"" + filename + "\"";
-			//add reference file
-			char* tempRef = new char[5]; 
-			//strcpy(tempRef, "--db"); 
-			*tempRef = '\0'; strncat(tempRef, "--db", 4);
-			cPara.push_back(tempRef);  
-			char* tempR = new char[templatefile.length()+1];
-			//strcpy(tempR, templatefile.c_str());
-			*tempR = '\0'; strncat(tempR, templatefile.c_str(), templatefile.length());
-			cPara.push_back(tempR);
-		}
-		
-		char* tempIn = new char[8]; 
-		*tempIn = '\0'; strncat(tempIn, "--input", 7);
-		//strcpy(tempIn, "--input"); 
-		cPara.push_back(tempIn);
-		char* temp = new char[filename.length()+1];
-		*temp = '\0'; strncat(temp, filename.c_str(), filename.length());
-		//strcpy(temp, filename.c_str());
-		cPara.push_back(temp);
-		
-		char* tempO = new char[12]; 
-		*tempO = '\0'; strncat(tempO, "--uchimeout", 11);
-		//strcpy(tempO, "--uchimeout"); 
-		cPara.push_back(tempO);
-		char* tempout = new char[outputFName.length()+1];
-		//strcpy(tempout, outputFName.c_str());
-		*tempout = '\0'; strncat(tempout, outputFName.c_str(), outputFName.length());
-		cPara.push_back(tempout);
-		
-		if (chimealns) {
-			char* tempA = new char[13]; 
-			*tempA = '\0'; strncat(tempA, "--uchimealns", 12);
-			//strcpy(tempA, "--uchimealns"); 
-			cPara.push_back(tempA);
-			char* tempa = new char[alns.length()+1];
-			//strcpy(tempa, alns.c_str());
-			*tempa = '\0'; strncat(tempa, alns.c_str(), alns.length());
-			cPara.push_back(tempa);
-		}
-        
-        if (strand != "") {
-			char* tempA = new char[9]; 
-			*tempA = '\0'; strncat(tempA, "--strand", 8);
-			cPara.push_back(tempA);
-			char* tempa = new char[strand.length()+1];
-			*tempa = '\0'; strncat(tempa, strand.c_str(), strand.length());
-			cPara.push_back(tempa);
-		}
-		
-		if (useAbskew) {
-			char* tempskew = new char[9];
-			*tempskew = '\0'; strncat(tempskew, "--abskew", 8);
-			//strcpy(tempskew, "--abskew"); 
-			cPara.push_back(tempskew);
-			char* tempSkew = new char[abskew.length()+1];
-			//strcpy(tempSkew, abskew.c_str());
-			*tempSkew = '\0'; strncat(tempSkew, abskew.c_str(), abskew.length());
-			cPara.push_back(tempSkew);
-		}
-		
-		if (useMinH) {
-			char* tempminh = new char[7]; 
-			*tempminh = '\0'; strncat(tempminh, "--minh", 6);
-			//strcpy(tempminh, "--minh"); 
-			cPara.push_back(tempminh);
-			char* tempMinH = new char[minh.length()+1];
-			*tempMinH = '\0'; strncat(tempMinH, minh.c_str(), minh.length());
-			//strcpy(tempMinH, minh.c_str());
-			cPara.push_back(tempMinH);
-		}
-		
-		if (useMindiv) {
-			char* tempmindiv = new char[9]; 
-			*tempmindiv = '\0'; strncat(tempmindiv, "--mindiv", 8);
-			//strcpy(tempmindiv, "--mindiv"); 
-			cPara.push_back(tempmindiv);
-			char* tempMindiv = new char[mindiv.length()+1];
-			*tempMindiv = '\0'; strncat(tempMindiv, mindiv.c_str(), mindiv.length());
-			//strcpy(tempMindiv, mindiv.c_str());
-			cPara.push_back(tempMindiv);
-		}
-		
-		if (useXn) {
-			char* tempxn = new char[5]; 
-			//strcpy(tempxn, "--xn"); 
-			*tempxn = '\0'; strncat(tempxn, "--xn", 4);
-			cPara.push_back(tempxn);
-			char* tempXn = new char[xn.length()+1];
-			//strcpy(tempXn, xn.c_str());
-			*tempXn = '\0'; strncat(tempXn, xn.c_str(), xn.length());
-			cPara.push_back(tempXn);
-		}
-		
-		if (useDn) {
-			char* tempdn = new char[5]; 
-			//strcpy(tempdn, "--dn"); 
-			*tempdn = '\0'; strncat(tempdn, "--dn", 4);
-			cPara.push_back(tempdn);
-			char* tempDn = new char[dn.length()+1];
-			*tempDn = '\0'; strncat(tempDn, dn.c_str(), dn.length());
-			//strcpy(tempDn, dn.c_str());
-			cPara.push_back(tempDn);
-		}
-		
-		if (useXa) {
-			char* tempxa = new char[5]; 
-			//strcpy(tempxa, "--xa"); 
-			*tempxa = '\0'; strncat(tempxa, "--xa", 4);
-			cPara.push_back(tempxa);
-			char* tempXa = new char[xa.length()+1];
-			*tempXa = '\0'; strncat(tempXa, xa.c_str(), xa.length());
-			//strcpy(tempXa, xa.c_str());
-			cPara.push_back(tempXa);
-		}
-		
-		if (useChunks) {
-			char* tempchunks = new char[9]; 
-			//strcpy(tempchunks, "--chunks"); 
-			*tempchunks = '\0'; strncat(tempchunks, "--chunks", 8);
-			cPara.push_back(tempchunks);
-			char* tempChunks = new char[chunks.length()+1];
-			*tempChunks = '\0'; strncat(tempChunks, chunks.c_str(), chunks.length());
-			//strcpy(tempChunks, chunks.c_str());
-			cPara.push_back(tempChunks);
-		}
-		
-		if (useMinchunk) {
-			char* tempminchunk = new char[11]; 
-			//strcpy(tempminchunk, "--minchunk"); 
-			*tempminchunk = '\0'; strncat(tempminchunk, "--minchunk", 10);
-			cPara.push_back(tempminchunk);
-			char* tempMinchunk = new char[minchunk.length()+1];
-			*tempMinchunk = '\0'; strncat(tempMinchunk, minchunk.c_str(), minchunk.length());
-			//strcpy(tempMinchunk, minchunk.c_str());
-			cPara.push_back(tempMinchunk);
-		}
+		//sanity check
+		if (numThreads > numItems) { numThreads = numItems; }
 		
-		if (useIdsmoothwindow) {
-			char* tempidsmoothwindow = new char[17]; 
-			*tempidsmoothwindow = '\0'; strncat(tempidsmoothwindow, "--idsmoothwindow", 16);
-			//strcpy(tempidsmoothwindow, "--idsmoothwindow"); 
-			cPara.push_back(tempidsmoothwindow);
-			char* tempIdsmoothwindow = new char[idsmoothwindow.length()+1];
-			*tempIdsmoothwindow = '\0'; strncat(tempIdsmoothwindow, idsmoothwindow.c_str(), idsmoothwindow.length());
-			//strcpy(tempIdsmoothwindow, idsmoothwindow.c_str());
-			cPara.push_back(tempIdsmoothwindow);
+		vector<thread*> workerThreads;
+		for (int i = 1; i < numThreads; i++) {
+			workerThreads.push_back(new thread(&ChimeraUchimeCommand::driverThread, this, &data));
 		}
 		
-		/*if (useMinsmoothid) {
-			char* tempminsmoothid = new char[14]; 
-			//strcpy(tempminsmoothid, "--minsmoothid"); 
-			*tempminsmoothid = '\0'; strncat(tempminsmoothid, "--minsmoothid", 13);
-			cPara.push_back(tempminsmoothid);
-			char* tempMinsmoothid = new char[minsmoothid.length()+1];
-			*tempMinsmoothid = '\0'; strncat(tempMinsmoothid, minsmoothid.c_str(), minsmoothid.length());
-			//strcpy(tempMinsmoothid, minsmoothid.c_str());
-			cPara.push_back(tempMinsmoothid);
-		}*/
+		//using the main process as a worker saves time and memory
+		driverThread(&data);
 		
-		if (useMaxp) {
-			char* tempmaxp = new char[7]; 
-			//strcpy(tempmaxp, "--maxp"); 
-			*tempmaxp = '\0'; strncat(tempmaxp, "--maxp", 6);
-			cPara.push_back(tempmaxp);
-			char* tempMaxp = new char[maxp.length()+1];
-			*tempMaxp = '\0'; strncat(tempMaxp, maxp.c_str(), maxp.length());
-			//strcpy(tempMaxp, maxp.c_str());
-			cPara.push_back(tempMaxp);
+		for (int i = 0; i < workerThreads.size(); i++) {
+			workerThreads[i]->join();
+			delete workerThreads[i];
 		}
 		
-		if (!skipgaps) {
-			char* tempskipgaps = new char[13]; 
-			//strcpy(tempskipgaps, "--[no]skipgaps");
-			*tempskipgaps = '\0'; strncat(tempskipgaps, "--noskipgaps", 12);
-			cPara.push_back(tempskipgaps);
-		}
+		int num = 0;
+		for (int i = 0; i < numItems; i++) { num += data.numSeqs[i]; }
 		
-		if (!skipgaps2) {
-			char* tempskipgaps2 = new char[14]; 
-			//strcpy(tempskipgaps2, "--[no]skipgaps2"); 
-			*tempskipgaps2 = '\0'; strncat(tempskipgaps2, "--noskipgaps2", 13);
-			cPara.push_back(tempskipgaps2);
-		}
+		return num;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ChimeraUchimeCommand", "createProcesses");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+//the threads take the next group or block until they are all checked, each item writes its own files
+void ChimeraUchimeCommand::driverThread(uchimeData* data){
+	try {
+		int numItems = data->getNumItems();
 		
-		if (useMinlen) {
-			char* tempminlen = new char[9]; 
-			*tempminlen = '\0'; strncat(tempminlen, "--minlen", 8);
-			//strcpy(tempminlen, "--minlen"); 
-			cPara.push_back(tempminlen);
-			char* tempMinlen = new char[minlen.length()+1];
-			//strcpy(tempMinlen, minlen.c_str());
-			*tempMinlen = '\0'; strncat(tempMinlen, minlen.c_str(), minlen.length());
-			cPara.push_back(tempMinlen);
+		while (!m->control_pressed) {
+			int i = data->nextItem++;
+			if (i >= numItems) { break; }
+			
+			string extension = data->getExtension(i);
+			
+			if (data->groups.size() == 0) {
+				data->numSeqs[i] = driver(data->outputFName+extension, data->blocks[i], data->accnos+extension, data->alns+extension, data->numChimeras[i]);
+			}else {
+				int start = time(NULL);
+				
+				vector<seqPriorityNode> seqs;
+				int error;
+				{
+					lock_guard<mutex> guard(printMutex);
+					if (hasCount) { error = cparser->getSeqs(data->groups[i], seqs); }
+					else { error = sparser->getSeqs(data->groups[i], seqs); }
+				}
+				if (error == 1) { m->control_pressed = true; break; }
+				
+				driver(data->outputFName+extension, seqs, data->accnos+extension, data->alns+extension, data->numChimeras[i]);
+				data->numSeqs[i] = seqs.size();
+				
+				lock_guard<mutex> guard(printMutex);
+				m->mothurOutEndLine(); m->mothurOut("It took " + toString(time(NULL) - start) + " secs to check " + toString(seqs.size()) + " sequences from group " + data->groups[i] + ".");	m->mothurOutEndLine();
+			}
 		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ChimeraUchimeCommand", "driverThread");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+//checks the sequences in the order given, template=self labels carry the abundance as /ab=numRedundantSeqs/
+int ChimeraUchimeCommand::driver(string outputFName, vector<seqPriorityNode>& seqs, string accnos, string alns, int& numChimeras){
+	try {
 		
-		if (useMaxlen) {
-			char* tempmaxlen = new char[9]; 
-			//strcpy(tempmaxlen, "--maxlen"); 
-			*tempmaxlen = '\0'; strncat(tempmaxlen, "--maxlen", 8);
-			cPara.push_back(tempmaxlen);
-			char* tempMaxlen = new char[maxlen.length()+1];
-			*tempMaxlen = '\0'; strncat(tempMaxlen, maxlen.c_str(), maxlen.length());
-			//strcpy(tempMaxlen, maxlen.c_str());
-			cPara.push_back(tempMaxlen);
+		vector<string> labels, sequences;
+		for (int i = 0; i < seqs.size(); i++) {
+			if (templatefile == "self") { labels.push_back(seqs[i].name + "/ab=" + toString(seqs[i].numIdentical) + "/"); }
+			else { labels.push_back(seqs[i].name); }
+			sequences.push_back(seqs[i].seq);
 		}
 		
-		if (ucl) {
-			char* tempucl = new char[5]; 
-			strcpy(tempucl, "--ucl"); 
-			cPara.push_back(tempucl);
-		}
+		if (!chimealns) { alns = ""; }
 		
-		if (useQueryfract) {
-			char* tempqueryfract = new char[13]; 
-			*tempqueryfract = '\0'; strncat(tempqueryfract, "--queryfract", 12);
-			//strcpy(tempqueryfract, "--queryfract"); 
-			cPara.push_back(tempqueryfract);
-			char* tempQueryfract = new char[queryfract.length()+1];
-			*tempQueryfract = '\0'; strncat(tempQueryfract, queryfract.c_str(), queryfract.length());
-			//strcpy(tempQueryfract, queryfract.c_str());
-			cPara.push_back(tempQueryfract);
+		try {
+			unsigned numHits = 0;
+			UChime(labels, sequences, refDB, outputFName, alns, numHits);
+		}catch(runtime_error& e) {
+			lock_guard<mutex> guard(printMutex);
+			m->mothurOut("[ERROR]: " + string(e.what()) + "\n"); m->control_pressed = true; return 0;
 		}
 		
-		
-		char** uchimeParameters;
-		uchimeParameters = new char*[cPara.size()];
-		string commandString = "";
-		for (int i = 0; i < cPara.size(); i++) {  uchimeParameters[i] = cPara[i];  commandString += toString(cPara[i]) + " "; } 
-		//int numArgs = cPara.size();
-		
-		//uchime_main(numArgs, uchimeParameters); 
-		
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-#else
-		commandString = "\"" + commandString + "\"";
-#endif
-        if (m->debug) { m->mothurOut("[DEBUG]: uchime command = " + commandString + ".\n"); }
-		system(commandString.c_str());
-		
-		//free memory
-		for(int i = 0; i < cPara.size(); i++)  {  delete cPara[i];  }
-		delete[] uchimeParameters; 
-		
-		//remove "" from filenames
-		outputFName = outputFName.substr(1, outputFName.length()-2);
-		filename = filename.substr(1, filename.length()-2);
-		alns = alns.substr(1, alns.length()-2);
-		
 		if (m->control_pressed) { return 0; }
 		
 		//create accnos file from uchime results
@@ -1549,8 +1300,6 @@ int ChimeraUchimeCommand::driver(string outputFName, string filename, string acc
 		in.close();
 		out.close();
 		
-        //if (templatefile != "self") {  m->mothurRemove(filename); }
-        
 		return num;
 	}
 	catch(exception& e) {
@@ -1559,367 +1308,68 @@ int ChimeraUchimeCommand::driver(string outputFName, string filename, string acc
 	}
 }
 /**************************************************************************************************/
-//uchime can't handle some of the things allowed in mothurs fasta files. This functions "cleans up" the file.
-int ChimeraUchimeCommand::prepFile(string filename, string output) {
+//appends the files of the groups or blocks in order. With dereplicate=t the chimeras of a group are listed by the names they
+//represent, or their group counts are zeroed in the new count table.
+int ChimeraUchimeCommand::appendResults(uchimeData& data, string nameFile, string newCountFile) {
 	try {
-        
-        ifstream in;
-        m->openInputFile(filename, in);
-        
-        ofstream out;
-        m->openOutputFile(output, out);
-        
-        while (!in.eof()) {
-            if (m->control_pressed) { break;  }
-            
-            Sequence seq(in); m->gobble(in);
-            
-            if (seq.getName() != "") { seq.printSequence(out); }
-        }
-        in.close();
-        out.close();
-        
-        return 0;
-    }
-	catch(exception& e) {
-		m->errorOut(e, "ChimeraUchimeCommand", "prepFile");
-		exit(1);
-	}
-}
-/**************************************************************************************************/
-
-int ChimeraUchimeCommand::createProcesses(string outputFileName, string filename, string accnos, string alns, int& numChimeras) {
-	try {
-		
-		processIDS.clear();
-		int process = 1;
-		int num = 0;
-		vector<string> files;
+		CountTable newCount;
+		bool byGroup = (data.groups.size() != 0);
+		if (byGroup && hasCount && dups) { newCount.readTable(nameFile, true, false); }
 		
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)		
-		//break up file into multiple files
-		m->divideFile(filename, processors, files);
-		
-		if (m->control_pressed) {  return 0;  }
-				
-		//loop through and create all the processes you want
-		while (process != processors) {
-			pid_t pid = fork();
+		for (int i = 0; i < data.getNumItems(); i++) {
+			string extension = data.getExtension(i);
 			
-			if (pid > 0) {
-				processIDS.push_back(pid);  //create map from line number to pid so you can append files in correct order later
-				process++;
-			}else if (pid == 0){
-				num = driver(outputFileName + toString(m->mothurGetpid(process)) + ".temp", files[process], accnos + toString(m->mothurGetpid(process)) + ".temp", alns + toString(m->mothurGetpid(process)) + ".temp", numChimeras);
-				
-				//pass numSeqs to parent
-				ofstream out;
-				string tempFile = outputFileName + toString(m->mothurGetpid(process)) + ".num.temp";
-				m->openOutputFile(tempFile, out);
-				out << num << endl;
-				out << numChimeras << endl;
-				out.close();
-				
-				exit(0);
-            }else {
-                m->mothurOut("[ERROR]: unable to spawn the necessary processes."); m->mothurOutEndLine();
-                for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-                exit(0);
-            }
-		}
-		
-		//do my part
-		num = driver(outputFileName, files[0], accnos, alns, numChimeras);
-		
-		//force parent to wait until all the processes are done
-		for (int i=0;i<processIDS.size();i++) { 
-			int temp = processIDS[i];
-			wait(&temp);
-		}
-		
-		for (int i = 0; i < processIDS.size(); i++) {
-			ifstream in;
-			string tempFile =  outputFileName + toString(processIDS[i]) + ".num.temp";
-			m->openInputFile(tempFile, in);
-			if (!in.eof()) { 
-				int tempNum = 0; 
-				in >> tempNum; m->gobble(in);
-				num += tempNum; 
-				in >> tempNum;
-				numChimeras += tempNum;
+			if (m->control_pressed) {
+				m->mothurRemove((data.outputFName+extension)); m->mothurRemove((data.accnos+extension));
+				if (chimealns) { m->mothurRemove((data.alns+extension)); }
+				continue;
 			}
-			in.close(); m->mothurRemove(tempFile);
-		}
-#else
-		//////////////////////////////////////////////////////////////////////////////////////////////////////
-		//Windows version shared memory, so be careful when passing variables through the preClusterData struct. 
-		//Above fork() will clone, so memory is separate, but that's not the case with windows, 
-		//////////////////////////////////////////////////////////////////////////////////////////////////////
-		
-		//divide file
-		int count = 0;
-		int spot = 0;
-        files.resize(processors, "");
-        
-		for (int i = 0; i < processors; i++) {
-            ofstream temp;
-			files[i] = filename+toString(i)+".temp";
-			m->openOutputFile(filename+toString(i)+".temp", temp);
-		}
-		
-		ifstream in;
-		m->openInputFile(filename, in);
-		
-		while(!in.eof()) {
-			Sequence tempSeq(in); m->gobble(in); 
-			
-			if (tempSeq.getName() != "") {
-                ofstream temp;
-                m->openOutputFileAppend(files[spot], temp);
-                tempSeq.printSequence(temp); temp.close();
-				spot++; count++;
-				if (spot == processors) { spot = 0; }
-			}
-		}
-		in.close();
-		
-		//sanity check for number of processors
-		if (count < processors) { processors = count; }
-		
-		vector<uchimeData*> pDataArray; 
-		DWORD   dwThreadIdArray[processors-1];
-		HANDLE  hThreadArray[processors-1]; 
-		vector<string> dummy; //used so that we can use the same struct for MyUchimeSeqsThreadFunction and MyUchimeThreadFunction
-		
-		//Create processor worker threads.
-		for( int i=1; i<processors; i++ ){
-			// Allocate memory for thread data.
-			string extension = toString(i) + ".temp";
-			
-			uchimeData* tempUchime = new uchimeData(outputFileName+extension, uchimeLocation, templatefile, files[i], "", "", "", accnos+extension, alns+extension, "", dummy, m, 0, 0,  i);
-			tempUchime->setBooleans(dups, useAbskew, chimealns, useMinH, useMindiv, useXn, useDn, useXa, useChunks, useMinchunk, useIdsmoothwindow, useMinsmoothid, useMaxp, skipgaps, skipgaps2, useMinlen, useMaxlen, ucl, useQueryfract, hasCount);
-			tempUchime->setVariables(abskew, minh, mindiv, xn, dn, xa, chunks, minchunk, idsmoothwindow, minsmoothid, maxp, minlen, maxlen, queryfract, strand);
 			
-			pDataArray.push_back(tempUchime);
-			processIDS.push_back(i);
-			
-			//MySeqSumThreadFunction is in header. It must be global or static to work with the threads.
-			//default security attributes, thread function name, argument to thread function, use default creation flags, returns the thread identifier
-			hThreadArray[i-1] = CreateThread(NULL, 0, MyUchimeSeqsThreadFunction, pDataArray[i-1], 0, &dwThreadIdArray[i-1]);   
-		}
-		
-		
-		//using the main process as a worker saves time and memory
-		num = driver(outputFileName, files[0], accnos, alns, numChimeras);
-		
-		//Wait until all threads have terminated.
-		WaitForMultipleObjects(processors-1, hThreadArray, TRUE, INFINITE);
-		
-		//Close all thread handles and free memory allocations.
-		for(int i=0; i < pDataArray.size(); i++){
-			num += pDataArray[i]->count;
-			numChimeras += pDataArray[i]->numChimeras;
-			CloseHandle(hThreadArray[i]);
-			delete pDataArray[i];
-		}
-#endif		
-		
-		//append output files
-		for(int i=0;i<processIDS.size();i++){
-			m->appendFiles((outputFileName + toString(processIDS[i]) + ".temp"), outputFileName);
-			m->mothurRemove((outputFileName + toString(processIDS[i]) + ".temp"));
-			
-			m->appendFiles((accnos + toString(processIDS[i]) + ".temp"), accnos);
-			m->mothurRemove((accnos + toString(processIDS[i]) + ".temp"));
-			
-			if (chimealns) {
-				m->appendFiles((alns + toString(processIDS[i]) + ".temp"), alns);
-				m->mothurRemove((alns + toString(processIDS[i]) + ".temp"));
+			if (byGroup && dups) {
+				if (!m->isBlank(data.accnos+extension)) {
+					ifstream in;
+					m->openInputFile(data.accnos+extension, in);
+					string name;
+					if (hasCount) {
+						while (!in.eof()) {
+							in >> name; m->gobble(in);
+							newCount.setAbund(name, data.groups[i], 0);
+						}
+						in.close();
+					}else {
+						map<string, string> thisnamemap = sparser->getNameMap(data.groups[i]);
+						map<string, string>::iterator itN;
+						ofstream out;
+						m->openOutputFile(data.accnos+extension+".temp", out);
+						while (!in.eof()) {
+							in >> name; m->gobble(in); 
+							itN = thisnamemap.find(name);
+							if (itN != thisnamemap.end()) {
+								vector<string> tempNames; m->splitAtComma(itN->second, tempNames); 
+								for (int j = 0; j < tempNames.size(); j++) { out << tempNames[j] << endl; }
+								
+							}else { m->mothurOut("[ERROR]: parsing cannot find " + name + ".\n"); m->control_pressed = true; }
+						}
+						out.close();
+						in.close();
+						m->renameFile(data.accnos+extension+".temp", data.accnos+extension);
+					}
+				}
 			}
-		}
-		
-		//get rid of the file pieces.
-		for (int i = 0; i < files.size(); i++) { m->mothurRemove(files[i]); }
-        
-		return num;	
-	}
-	catch(exception& e) {
-		m->errorOut(e, "ChimeraUchimeCommand", "createProcesses");
-		exit(1);
-	}
-}
-/**************************************************************************************************/
-
-int ChimeraUchimeCommand::createProcessesGroups(string outputFName, string filename, string accnos, string alns, string newCountFile, vector<string> groups, string nameFile, string groupFile, string fastaFile) {
-	try {
-		
-		processIDS.clear();
-		int process = 1;
-		int num = 0;
-        
-        CountTable newCount;
-        if (hasCount && dups) { newCount.readTable(nameFile, true, false); }
-		
-		//sanity check
-		if (groups.size() < processors) { processors = groups.size(); }
-		
-		//divide the groups between the processors
-		vector<linePair> lines;
-        int remainingPairs = groups.size();
-        int startIndex = 0;
-        for (int remainingProcessors = processors; remainingProcessors > 0; remainingProcessors--) {
-            int numPairs = remainingPairs; //case for last processor
-            if (remainingProcessors != 1) { numPairs = ceil(remainingPairs / remainingProcessors); }
-            lines.push_back(linePair(startIndex, (startIndex+numPairs))); //startIndex, endIndex
-            startIndex = startIndex + numPairs;
-            remainingPairs = remainingPairs - numPairs;
-        }
-
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)		
-				
-		//loop through and create all the processes you want
-		while (process != processors) {
-			pid_t pid = fork();
-			
-			if (pid > 0) {
-				processIDS.push_back(pid);  //create map from line number to pid so you can append files in correct order later
-				process++;
-			}else if (pid == 0){
-				num = driverGroups(outputFName + toString(m->mothurGetpid(process)) + ".temp", filename + toString(m->mothurGetpid(process)) + ".temp", accnos + toString(m->mothurGetpid(process)) + ".temp", alns + toString(m->mothurGetpid(process)) + ".temp", accnos + ".byCount." + toString(m->mothurGetpid(process)) + ".temp", lines[process].start, lines[process].end, groups);
-				
-				//pass numSeqs to parent
-				ofstream out;
-				string tempFile = outputFName + toString(m->mothurGetpid(process)) + ".num.temp";
-				m->openOutputFile(tempFile, out);
-				out << num << endl;
-				out.close();
-				
-				exit(0);
-            }else {
-                m->mothurOut("[ERROR]: unable to spawn the necessary processes."); m->mothurOutEndLine();
-                for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-                exit(0);
-            }
-
-		}
-            
-		//do my part
-		num = driverGroups(outputFName, filename, accnos, alns, accnos + ".byCount", lines[0].start, lines[0].end, groups);
-		
-		//force parent to wait until all the processes are done
-		for (int i=0;i<processIDS.size();i++) { 
-			int temp = processIDS[i];
-			wait(&temp);
-		}
-        
-		for (int i = 0; i < processIDS.size(); i++) {
-			ifstream in;
-			string tempFile =  outputFName + toString(processIDS[i]) + ".num.temp";
-			m->openInputFile(tempFile, in);
-			if (!in.eof()) { int tempNum = 0; in >> tempNum; num += tempNum; }
-			in.close(); m->mothurRemove(tempFile);
-        }
-        
-#else
-		//////////////////////////////////////////////////////////////////////////////////////////////////////
-		//Windows version shared memory, so be careful when passing variables through the uchimeData struct. 
-		//Above fork() will clone, so memory is separate, but that's not the case with windows, 
-		//////////////////////////////////////////////////////////////////////////////////////////////////////
-		
-		vector<uchimeData*> pDataArray; 
-		DWORD   dwThreadIdArray[processors-1];
-		HANDLE  hThreadArray[processors-1]; 
-		
-		//Create processor worker threads.
-		for( int i=1; i<processors; i++ ){
-			// Allocate memory for thread data.
-			string extension = toString(i) + ".temp";
-			
-			uchimeData* tempUchime = new uchimeData(outputFName+extension, uchimeLocation, templatefile, filename+extension, fastaFile, nameFile, groupFile, accnos+extension, alns+extension, accnos+".byCount."+extension, groups, m, lines[i].start, lines[i].end,  i);
-			tempUchime->setBooleans(dups, useAbskew, chimealns, useMinH, useMindiv, useXn, useDn, useXa, useChunks, useMinchunk, useIdsmoothwindow, useMinsmoothid, useMaxp, skipgaps, skipgaps2, useMinlen, useMaxlen, ucl, useQueryfract, hasCount);
-			tempUchime->setVariables(abskew, minh, mindiv, xn, dn, xa, chunks, minchunk, idsmoothwindow, minsmoothid, maxp, minlen, maxlen, queryfract, strand);
-			
-			pDataArray.push_back(tempUchime);
-			processIDS.push_back(i);
 			
-			//MyUchimeThreadFunction is in header. It must be global or static to work with the threads.
-			//default security attributes, thread function name, argument to thread function, use default creation flags, returns the thread identifier
-			hThreadArray[i-1] = CreateThread(NULL, 0, MyUchimeThreadFunction, pDataArray[i-1], 0, &dwThreadIdArray[i-1]);   
+			m->appendFiles((data.outputFName+extension), data.outputFName); m->mothurRemove((data.outputFName+extension));
+			m->appendFiles((data.accnos+extension), data.accnos); m->mothurRemove((data.accnos+extension));
+			if (chimealns) { m->appendFiles((data.alns+extension), data.alns); m->mothurRemove((data.alns+extension)); }
 		}
 		
+		//print new *.pick.count_table
+		if (byGroup && hasCount && dups && !m->control_pressed) { newCount.printTable(newCountFile); }
 		
-		//using the main process as a worker saves time and memory
-		num = driverGroups(outputFName, filename, accnos, alns, accnos + ".byCount", lines[0].start, lines[0].end, groups);
-		
-		//Wait until all threads have terminated.
-		WaitForMultipleObjects(processors-1, hThreadArray, TRUE, INFINITE);
-		
-		//Close all thread handles and free memory allocations.
-		for(int i=0; i < pDataArray.size(); i++){
-			num += pDataArray[i]->count;
-			CloseHandle(hThreadArray[i]);
-			delete pDataArray[i];
-		}
-        
-        
-#endif		
-      
-        //read my own
-        if (hasCount && dups) {
-            if (!m->isBlank(accnos + ".byCount")) {
-                ifstream in2;
-                m->openInputFile(accnos + ".byCount", in2);
-                
-                string name, group;
-                while (!in2.eof()) {
-                    in2 >> name >> group; m->gobble(in2);
-                    newCount.setAbund(name, group, 0);
-                }
-                in2.close();
-            }
-            m->mothurRemove(accnos + ".byCount");
-        }
-       
-		//append output files
-		for(int i=0;i<processIDS.size();i++){
-			m->appendFiles((outputFName + toString(processIDS[i]) + ".temp"), outputFName);
-			m->mothurRemove((outputFName + toString(processIDS[i]) + ".temp"));
-			
-			m->appendFiles((accnos + toString(processIDS[i]) + ".temp"), accnos);
-			m->mothurRemove((accnos + toString(processIDS[i]) + ".temp"));
-			
-			if (chimealns) {
-				m->appendFiles((alns + toString(processIDS[i]) + ".temp"), alns);
-				m->mothurRemove((alns + toString(processIDS[i]) + ".temp"));
-			}
-            
-            if (hasCount && dups) {
-                if (!m->isBlank(accnos + ".byCount." + toString(processIDS[i]) + ".temp")) {
-                    ifstream in2;
-                    m->openInputFile(accnos + ".byCount." + toString(processIDS[i]) + ".temp", in2);
-                    
-                    string name, group;
-                    while (!in2.eof()) {
-                        in2 >> name >> group; m->gobble(in2);
-                        newCount.setAbund(name, group, 0);
-                    }
-                    in2.close();
-                }
-                m->mothurRemove(accnos + ".byCount." + toString(processIDS[i]) + ".temp");
-            }
-
-		}
-        
-        //print new *.pick.count_table
-        if (hasCount && dups) {  newCount.printTable(newCountFile);   }
- 		
-		return num;	
-		
+		return 0;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "ChimeraUchimeCommand", "createProcessesGroups");
+		m->errorOut(e, "ChimeraUchimeCommand", "appendResults");
 		exit(1);
 	}
 }
 /**************************************************************************************************/
-
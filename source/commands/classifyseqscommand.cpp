@@ -583,11 +583,7 @@ ClassifySeqsCommand::ClassifySeqsCommand(string option)  {
 }
 
 //**********************************************************************************************************************
-ClassifySeqsCommand::~ClassifySeqsCommand(){	
-	if (abort == false) {
-		for (int i = 0; i < lines.size(); i++) {  delete lines[i];  }  lines.clear();
-	}
-}
+ClassifySeqsCommand::~ClassifySeqsCommand(){}
 //**********************************************************************************************************************
 
 int ClassifySeqsCommand::execute(){
@@ -595,18 +591,8 @@ int ClassifySeqsCommand::execute(){
 		if (abort == true) { if (calledHelp) { return 0; }  return 2;	}
         
         string outputMethodTag = method;
-		if(method == "wang"){	classify = new Bayesian(taxonomyFileName, templateFileName, search, kmerSize, cutoff, iters, m->getRandomNumber(), flip, writeShortcuts);	}
-		else if(method == "knn"){	classify = new Knn(taxonomyFileName, templateFileName, search, kmerSize, gapOpen, gapExtend, match, misMatch, numWanted, m->getRandomNumber());				}
-        else if(method == "zap"){	
-            outputMethodTag = search + "_" + outputMethodTag;
-            if (search == "kmer") {   classify = new KmerTree(templateFileName, taxonomyFileName, kmerSize, cutoff); }
-            else {  classify = new AlignTree(templateFileName, taxonomyFileName, cutoff);  }
-        }
-		else {
-			m->mothurOut(search + " is not a valid method option. I will run the command using wang.");
-			m->mothurOutEndLine();
-			classify = new Bayesian(taxonomyFileName, templateFileName, search, kmerSize, cutoff, iters, m->getRandomNumber(), flip, writeShortcuts);	
-		}
+        if (method == "zap") { outputMethodTag = search + "_" + outputMethodTag; }
+		classify = createClassifier();
 		
 		if (m->control_pressed) { delete classify; return 0; }
 				
@@ -638,41 +624,14 @@ int ClassifySeqsCommand::execute(){
 			
 			if ((method == "knn") && (search == "distance")) { 
 				string DistName = getOutputFileName("matchdist", variables);
-				classify->setDistName(DistName);  outputNames.push_back(DistName); outputTypes["matchdist"].push_back(DistName);
+				classify->setDistName(DistName); distanceFileName = DistName; outputNames.push_back(DistName); outputTypes["matchdist"].push_back(DistName);
 			}
 			
 			outputNames.push_back(newTaxonomyFile); outputTypes["taxonomy"].push_back(newTaxonomyFile);
 			outputNames.push_back(taxSummary);	outputTypes["taxsummary"].push_back(taxSummary);
 			
 			int start = time(NULL);
-			int numFastaSeqs = 0;
-			for (int i = 0; i < lines.size(); i++) {  delete lines[i];  }  lines.clear();
-		
-			vector<unsigned long long> positions; 
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-			positions = m->divideFile(fastaFileNames[s], processors);
-			for (int i = 0; i < (positions.size()-1); i++) {	lines.push_back(new linePair(positions[i], positions[(i+1)]));	}
-#else
-			if (processors == 1) {
-				lines.push_back(new linePair(0, 1000));
-			}else {
-				positions = m->setFilePosFasta(fastaFileNames[s], numFastaSeqs); 
-                if (numFastaSeqs < processors) { processors = numFastaSeqs; }
-				
-				//figure out how many sequences you have to process
-				int numSeqsPerProcessor = numFastaSeqs / processors;
-				for (int i = 0; i < processors; i++) {
-					int startIndex =  i * numSeqsPerProcessor;
-					if(i == (processors - 1)){	numSeqsPerProcessor = numFastaSeqs - i * numSeqsPerProcessor; 	}
-					lines.push_back(new linePair(positions[startIndex], numSeqsPerProcessor));
-				}
-			}
-#endif
-			if(processors == 1){
-				numFastaSeqs = driver(lines[0], newTaxonomyFile, tempTaxonomyFile, newaccnosFile, fastaFileNames[s]);
-			}else{
-				numFastaSeqs = createProcesses(newTaxonomyFile, tempTaxonomyFile, newaccnosFile, fastaFileNames[s]); 
-			}
+			int numFastaSeqs = createProcesses(newTaxonomyFile, tempTaxonomyFile, newaccnosFile, fastaFileNames[s]);
 			
 			if (!m->isBlank(newaccnosFile)) { m->mothurOutEndLine(); m->mothurOut("[WARNING]: mothur reversed some your sequences for a better classification.  If you would like to take a closer look, please check " + newaccnosFile + " for the list of the sequences."); m->mothurOutEndLine(); 
                 outputNames.push_back(newaccnosFile); outputTypes["accnos"].push_back(newaccnosFile);
@@ -796,260 +755,219 @@ int ClassifySeqsCommand::execute(){
 	}
 }
 /**************************************************************************************************/
-
+//the wang method is thread safe, so one classifier with one copy of its probability tables serves every thread.
+//The other methods save state as they classify and each thread gets its own classifier.
+Classify* ClassifySeqsCommand::createClassifier() {
+	try {
+		Classify* newClassify;
+		if(method == "wang"){	newClassify = new Bayesian(taxonomyFileName, templateFileName, search, kmerSize, cutoff, iters, m->getRandomNumber(), flip, writeShortcuts);	}
+		else if(method == "knn"){	newClassify = new Knn(taxonomyFileName, templateFileName, search, kmerSize, gapOpen, gapExtend, match, misMatch, numWanted, m->getRandomNumber());				}
+        else if(method == "zap"){	
+            if (search == "kmer") {   newClassify = new KmerTree(templateFileName, taxonomyFileName, kmerSize, cutoff); }
+            else {  newClassify = new AlignTree(templateFileName, taxonomyFileName, cutoff);  }
+        }
+		else {
+			m->mothurOut(search + " is not a valid method option. I will run the command using wang.");
+			m->mothurOutEndLine();
+			newClassify = new Bayesian(taxonomyFileName, templateFileName, search, kmerSize, cutoff, iters, m->getRandomNumber(), flip, writeShortcuts);	
+		}
+		
+		return newClassify;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ClassifySeqsCommand", "createClassifier");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//a reader thread fills blocks from the fasta file, the worker threads classify them and this thread writes the
+//results in file order as they finish. No temp files are created. Each block draws its bootstrap samples from
+//its own generator seeded by its index, so the results are the same for any number of processors.
 int ClassifySeqsCommand::createProcesses(string taxFileName, string tempTaxFile, string accnos, string filename) {
 	try {
+		vector<Classify*> classifiers; classifiers.push_back(classify);
+		if (!classify->isThreadSafe()) {
+			for (int i = 1; i < processors; i++) {
+				if (m->control_pressed) { break; }
+				classifiers.push_back(createClassifier());
+			}
+		}
 		
-		int num = 0;
-		processIDS.clear();
-        bool recalc = false;
+		numBlocksRead = 0;
+		nextToWrite = 0;
+		doneReading = false;
+		blockSeed = m->getRandomNumber();
 		
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-		int process = 1;
+		thread* reader = new thread(&ClassifySeqsCommand::readerThread, this, filename);
 		
-		//loop through and create all the processes you want
-		while (process != processors) {
-			pid_t pid = fork();
-			
-			if (pid > 0) {
-				processIDS.push_back(pid);  //create map from line number to pid so you can append files in correct order later
-				process++;
-			}else if (pid == 0){
-				num = driver(lines[process], taxFileName + m->mothurGetpid(process) + ".temp", tempTaxFile + m->mothurGetpid(process) + ".temp", accnos + m->mothurGetpid(process) + ".temp", filename);
-
-				//pass numSeqs to parent
-				ofstream out;
-				string tempFile = filename + m->mothurGetpid(process) + ".num.temp";
-				m->openOutputFile(tempFile, out);
-				out << num << endl;
-				out.close();
-
-				exit(0);
-            }else {
-                m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(process) + "\n"); processors = process;
-                for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-                //wait to die
-                for (int i=0;i<processIDS.size();i++) {
-                    int temp = processIDS[i];
-                    wait(&temp);
-                }
-                m->control_pressed = false;
-                recalc = true;
-                break;
-            }
+		vector<thread*> workerThreads;
+		for (int i = 0; i < processors; i++) {
+			workerThreads.push_back(new thread(&ClassifySeqsCommand::workerThread, this, classifiers[i % classifiers.size()]));
 		}
-        
-        if (recalc) {
-            //test line, also set recalc to true.
-            //for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); } for (int i=0;i<processIDS.size();i++) { int temp = processIDS[i]; wait(&temp); } m->control_pressed = false;  processors=3; m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(processors) + "\n");
-            for (int i = 0; i < lines.size(); i++) {  delete lines[i];  }  lines.clear();
-            vector<unsigned long long> positions = m->divideFile(filename, processors);
-            for (int i = 0; i < (positions.size()-1); i++) {	lines.push_back(new linePair(positions[i], positions[(i+1)]));	}
-            
-            num = 0;
-            processIDS.resize(0);
-            process = 1;
-            
-            while (process != processors) {
-                pid_t pid = fork();
-                
-                if (pid > 0) {
-                    processIDS.push_back(pid);  //create map from line number to pid so you can append files in correct order later
-                    process++;
-                }else if (pid == 0){
-                    num = driver(lines[process], taxFileName + m->mothurGetpid(process) + ".temp", tempTaxFile + m->mothurGetpid(process) + ".temp", accnos + m->mothurGetpid(process) + ".temp", filename);
-                    
-                    //pass numSeqs to parent
-                    ofstream out;
-                    string tempFile = filename + m->mothurGetpid(process) + ".num.temp";
-                    m->openOutputFile(tempFile, out);
-                    out << num << endl;
-                    out.close();
-                    
-                    exit(0);
-                }else {
-                    m->mothurOut("[ERROR]: unable to spawn the necessary processes."); m->mothurOutEndLine();
-                    for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-                    exit(0);
-                }
-            }
-        }
-
 		
-		//parent does its part
-		num = driver(lines[0], taxFileName, tempTaxFile, accnos, filename);
+		ofstream outTax;
+		m->openOutputFile(taxFileName, outTax);
 		
-		//force parent to wait until all the processes are done
-		for (int i=0;i<processIDS.size();i++) { 
-			int temp = processIDS[i];
-			wait(&temp);
-		}
+		ofstream outTaxSimple;
+		m->openOutputFile(tempTaxFile, outTaxSimple);
 		
-		for (int i = 0; i < processIDS.size(); i++) {
-			ifstream in;
-			string tempFile =  filename + toString(processIDS[i]) + ".num.temp";
-			m->openInputFile(tempFile, in);
-			if (!in.eof()) { int tempNum = 0; in >> tempNum; num += tempNum; }
-			in.close(); m->mothurRemove(m->getFullPathName(tempFile));
-		}
-#else
-		//////////////////////////////////////////////////////////////////////////////////////////////////////
-		//Windows version shared memory, so be careful when passing variables through the alignData struct. 
-		//Above fork() will clone, so memory is separate, but that's not the case with windows, 
-		//////////////////////////////////////////////////////////////////////////////////////////////////////
+		ofstream outAcc;
+		m->openOutputFile(accnos, outAcc);
 		
-		vector<classifyData*> pDataArray; 
-		DWORD   dwThreadIdArray[processors-1];
-		HANDLE  hThreadArray[processors-1]; 
+		//setDistName wrote the header
+		ofstream outDistance;
+		if ((method == "knn") && (search == "distance")) { m->openOutputFileAppend(distanceFileName, outDistance); }
 		
-		//Create processor worker threads.
-		for( int i=0; i<processors-1; i++ ){
-			// Allocate memory for thread data.
-			string extension = "";
-			if (i != 0) { extension = toString(i) + ".temp"; processIDS.push_back(i); }
+		int num = 0;
+		while (true) {
+			classifyBlock* block = NULL;
+			{
+				unique_lock<mutex> lock(blockLock);
+				while (!m->control_pressed && (finishedBlocks.count(nextToWrite) == 0) && !(doneReading && (nextToWrite == numBlocksRead))) {
+					blockReady.wait_for(lock, chrono::milliseconds(100));
+				}
+				if (m->control_pressed || (finishedBlocks.count(nextToWrite) == 0)) { break; }
+				
+				block = finishedBlocks[nextToWrite];
+				finishedBlocks.erase(nextToWrite);
+				nextToWrite++;
+			}
+			blockSpace.notify_all();
+			
+			if (block->warnings != "") { m->mothurOut(block->warnings); }
 			
-			classifyData* tempclass = new classifyData((accnos + extension), probs, method, templateFileName, taxonomyFileName, (taxFileName + extension), (tempTaxFile + extension), filename, search, kmerSize, iters, numWanted, m, lines[i]->start, lines[i]->end, match, misMatch, gapOpen, gapExtend, cutoff, i, flip, false);
-			pDataArray.push_back(tempclass);
+			outTax << block->taxonomy;
+			outTaxSimple << block->simpleTaxonomy;
+			outAcc << block->accnos;
+			if (outDistance.is_open()) { outDistance << block->matchDistances; }
 			
-			//MySeqSumThreadFunction is in header. It must be global or static to work with the threads.
-			//default security attributes, thread function name, argument to thread function, use default creation flags, returns the thread identifier
-			hThreadArray[i] = CreateThread(NULL, 0, MyClassThreadFunction, pDataArray[i], 0, &dwThreadIdArray[i]);  
+			//report progress
+			if (((num / 100) != ((num + block->count) / 100))) { m->mothurOutJustToScreen("Processing sequence: " + toString(num + block->count) +"\n"); }
+			num += block->count;
 			
+			delete block;
 		}
+		//report progress
+		if((num) % 100 != 0){	m->mothurOutJustToScreen("Processing sequence: " + toString(num)+"\n"); 		}
+		blockSpace.notify_all();
+		blockRead.notify_all();
 		
-		//parent does its part
-		num = driver(lines[processors-1], taxFileName + toString(processors-1) + ".temp", tempTaxFile + toString(processors-1) + ".temp", accnos + toString(processors-1) + ".temp", filename);
-		processIDS.push_back((processors-1));
+		reader->join();
+		delete reader;
+		for (int i = 0; i < workerThreads.size(); i++) {
+			workerThreads[i]->join();
+			delete workerThreads[i];
+		}
 		
-		//Wait until all threads have terminated.
-		WaitForMultipleObjects(processors-1, hThreadArray, TRUE, INFINITE);
+		//left over if the command was cancelled
+		for (map<int, classifyBlock*>::iterator it = readBlocks.begin(); it != readBlocks.end(); it++) { delete it->second; }
+		readBlocks.clear();
+		for (map<int, classifyBlock*>::iterator it = finishedBlocks.begin(); it != finishedBlocks.end(); it++) { delete it->second; }
+		finishedBlocks.clear();
 		
-		//Close all thread handles and free memory allocations.
-		for(int i=0; i < pDataArray.size(); i++){
-			num += pDataArray[i]->count;
-            if (pDataArray[i]->count != pDataArray[i]->end) {
-                m->mothurOut("[ERROR]: process " + toString(i) + " only processed " + toString(pDataArray[i]->count) + " of " + toString(pDataArray[i]->end) + " sequences assigned to it, quitting. \n"); m->control_pressed = true; 
-            }
-			CloseHandle(hThreadArray[i]);
-			delete pDataArray[i];
-		}
+		for (int i = 1; i < classifiers.size(); i++) { delete classifiers[i]; }
 		
-	#endif	
-        vector<string> nonBlankAccnosFiles;
-		if (!(m->isBlank(accnos))) { nonBlankAccnosFiles.push_back(accnos); }
-		else { m->mothurRemove(accnos); } //remove so other files can be renamed to it
-        
-		for(int i=0;i<processIDS.size();i++){
-			m->appendFiles((taxFileName + toString(processIDS[i]) + ".temp"), taxFileName);
-			m->appendFiles((tempTaxFile + toString(processIDS[i]) + ".temp"), tempTaxFile);
-            if (!(m->isBlank(accnos + toString(processIDS[i]) + ".temp"))) {
-				nonBlankAccnosFiles.push_back(accnos + toString(processIDS[i]) + ".temp");
-			}else { m->mothurRemove((accnos + toString(processIDS[i]) + ".temp"));  }
-
-			m->mothurRemove((m->getFullPathName(taxFileName) + toString(processIDS[i]) + ".temp"));
-			m->mothurRemove((m->getFullPathName(tempTaxFile) + toString(processIDS[i]) + ".temp"));
-		}
+		outTax.close();
+		outTaxSimple.close();
+		outAcc.close();
+		if (outDistance.is_open()) { outDistance.close(); }
 		
-        //append accnos files
-		if (nonBlankAccnosFiles.size() != 0) { 
-			rename(nonBlankAccnosFiles[0].c_str(), accnos.c_str());
-			
-			for (int h=1; h < nonBlankAccnosFiles.size(); h++) {
-				m->appendFiles(nonBlankAccnosFiles[h], accnos);
-				m->mothurRemove(nonBlankAccnosFiles[h]);
-			}
-		}else { //recreate the accnosfile if needed
-			ofstream out;
-			m->openOutputFile(accnos, out);
-			out.close();
-		}
-
 		return num;
-		
 	}
 	catch(exception& e) {
 		m->errorOut(e, "ClassifySeqsCommand", "createProcesses");
 		exit(1);
 	}
 }
-//**********************************************************************************************************************
-
-int ClassifySeqsCommand::driver(linePair* filePos, string taxFName, string tempTFName, string accnos, string filename){
+/**************************************************************************************************/
+//reads blocks of 100 sequences, staying at most 4 blocks per thread ahead of the writer so memory stays flat
+void ClassifySeqsCommand::readerThread(string filename) {
 	try {
-		ofstream outTax;
-		m->openOutputFile(taxFName, outTax);
-		
-		ofstream outTaxSimple;
-		m->openOutputFile(tempTFName, outTaxSimple);
-		
-		ofstream outAcc;
-		m->openOutputFile(accnos, outAcc);
-	
 		ifstream inFASTA;
 		m->openInputFile(filename, inFASTA);
 		
-		string taxonomy;
-
-		inFASTA.seekg(filePos->start);
-
-		bool done = false;
-		int count = 0;
+		int maxAhead = processors * 4;
 		
-		while (!done) {
-			if (m->control_pressed) { 
-				inFASTA.close();
-				outTax.close();
-				outTaxSimple.close();
-				outAcc.close(); return 0; }
+		while (!inFASTA.eof() && !m->control_pressed) {
+			classifyBlock* block = new classifyBlock();
+			while (!inFASTA.eof() && (block->seqs.size() < 100)) {
+				Sequence candidateSeq(inFASTA); m->gobble(inFASTA);
+				if (candidateSeq.getName() != "") { block->seqs.push_back(candidateSeq); }
+			}
+			
+			{
+				unique_lock<mutex> lock(blockLock);
+				while (!m->control_pressed && (numBlocksRead >= (nextToWrite + maxAhead))) { blockSpace.wait_for(lock, chrono::milliseconds(100)); }
+				if (m->control_pressed) { delete block; break; }
+				
+				readBlocks[numBlocksRead] = block;
+				numBlocksRead++;
+			}
+			blockRead.notify_one();
+		}
+		inFASTA.close();
 		
-			Sequence* candidateSeq = new Sequence(inFASTA); m->gobble(inFASTA);
+		{
+			lock_guard<mutex> lock(blockLock);
+			doneReading = true;
+		}
+		blockRead.notify_all();
+		blockReady.notify_all();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ClassifySeqsCommand", "readerThread");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+void ClassifySeqsCommand::workerThread(Classify* myClassify) {
+	try {
+		while (true) {
+			int thisBlock;
+			classifyBlock* block;
+			{
+				unique_lock<mutex> lock(blockLock);
+				while (!m->control_pressed && readBlocks.empty() && !doneReading) { blockRead.wait_for(lock, chrono::milliseconds(100)); }
+				if (m->control_pressed || readBlocks.empty()) { break; }
+				
+				thisBlock = readBlocks.begin()->first;
+				block = readBlocks.begin()->second;
+				readBlocks.erase(readBlocks.begin());
+			}
 			
-			if (candidateSeq->getName() != "") {
+			mt19937_64 engine(blockSeed + thisBlock);
 			
-				taxonomy = classify->getTaxonomy(candidateSeq);
+			for (int i = 0; i < block->seqs.size(); i++) {
+				string simpleTax = "";
+				bool flipped = false;
+				string taxonomy = myClassify->classifySequence(&block->seqs[i], simpleTax, flipped, block->warnings, block->matchDistances, engine);
 				
-				if (m->control_pressed) { delete candidateSeq; return 0; }
+				if (m->control_pressed) { break; }
 				
-				if (taxonomy == "unknown;") { m->mothurOut("[WARNING]: " + candidateSeq->getName() + " could not be classified. You can use the remove.lineage command with taxon=unknown; to remove such sequences."); m->mothurOutEndLine(); }
+				string name = block->seqs[i].getName();
+				if (taxonomy == "unknown;") { block->warnings += "[WARNING]: " + name + " could not be classified. You can use the remove.lineage command with taxon=unknown; to remove such sequences.\n"; }
 				
 				//output confidence scores or not
-				if (probs) {
-					outTax << candidateSeq->getName() << '\t' << taxonomy << endl;
-				}else{
-					outTax << candidateSeq->getName() << '\t' << classify->getSimpleTax() << endl;
-				}
+				if (probs)	{ block->taxonomy += name + '\t' + taxonomy + '\n';	}
+				else		{ block->taxonomy += name + '\t' + simpleTax + '\n';	}
 				
-				if (classify->getFlipped()) { outAcc << candidateSeq->getName() << endl; }
+				if (flipped) { block->accnos += name + '\n'; }
 				
-				outTaxSimple << candidateSeq->getName() << '\t' << classify->getSimpleTax() << endl;
+				block->simpleTaxonomy += name + '\t' + simpleTax + '\n';
 				
-				count++;
+				block->count++;
 			}
-			delete candidateSeq;
-			
-			#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-				unsigned long long pos = inFASTA.tellg();
-				if ((pos == -1) || (pos >= filePos->end)) { break; }
-			#else
-				if (inFASTA.eof()) { break; }
-			#endif
-			
-			//report progress
-			if((count) % 100 == 0){	m->mothurOutJustToScreen("Processing sequence: " + toString(count) +"\n"); 		}
+			block->seqs.clear();
 			
+			{
+				lock_guard<mutex> lock(blockLock);
+				finishedBlocks[thisBlock] = block;
+			}
+			blockReady.notify_one();
 		}
-		//report progress
-		if((count) % 100 != 0){	m->mothurOutJustToScreen("Processing sequence: " + toString(count)+"\n"); 		}
-			
-		inFASTA.close();
-		outTax.close();
-		outTaxSimple.close();
-		outAcc.close();
-		
-		return count;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "ClassifySeqsCommand", "driver");
+		m->errorOut(e, "ClassifySeqsCommand", "workerThread");
 		exit(1);
 	}
 }
@@ -32,6 +32,18 @@
 
 
 
+//a block of sequences from the fasta file. The reader thread fills seqs, a worker thread classifies them into the
+//output lines and the writer prints the blocks in file order.
+struct classifyBlock {
+	vector<Sequence> seqs;
+	string taxonomy, simpleTaxonomy, accnos, warnings, matchDistances;
+	int count;
+	
+	classifyBlock() : count(0) {}
+};
+
+/**************************************************************************************************/
+
 class ClassifySeqsCommand : public Command {
 	
 public:
@@ -55,8 +67,6 @@ public:
 	
 private:
 
-	vector<int> processIDS;   //processid
-	vector<linePair*> lines;
 	vector<string> fastaFileNames;
 	vector<string> namefileNames;
     vector<string> countfileNames;
@@ -72,154 +82,20 @@ private:
 	float match, misMatch, gapOpen, gapExtend;
 	bool abort, probs, save, flip, hasName, hasCount, writeShortcuts, relabund;
 	
-	int driver(linePair*, string, string, string, string);
-	int createProcesses(string, string, string, string); 
-};
-
-/**************************************************************************************************/
-//custom data structure for threads to use.
-// This is passed by void pointer so it can be any data type
-// that can be passed using a single void pointer (LPVOID).
-struct classifyData {
-	string taxFName; 
-	string tempTFName; 
-	string filename;
-	string search, taxonomyFileName, templateFileName, method, accnos;
-	unsigned long long start;
-	unsigned long long end;
-	MothurOut* m;
-	float match, misMatch, gapOpen, gapExtend;
-	int count, kmerSize, threadID, cutoff, iters, numWanted;
-	bool probs, flip, writeShortcuts;
-	 
-	classifyData(){}
-	classifyData(string acc, bool p, string me, string te, string tx, string a, string r, string f, string se, int ks, int i, int numW, MothurOut* mout, unsigned long long st, unsigned long long en, float ma, float misMa, float gapO, float gapE, int cut, int tid, bool fli, bool wsh) {
-		accnos = acc;
-		taxonomyFileName = tx;
-		templateFileName = te;
-		taxFName = a;
-		tempTFName = r;
-		filename = f;
-		search = se;
-		method = me;
-		m = mout;
-		start = st;
-		end = en;
-		match = ma; 
-		misMatch = misMa;
-		gapOpen = gapO; 
-		gapExtend = gapE; 
-		kmerSize = ks;
-		cutoff = cut;
-		iters = i;
-		numWanted = numW;
-		threadID = tid;
-		probs = p;
-		count = 0;
-		flip = fli;
-        writeShortcuts = wsh;
-	}
-};
-
-/**************************************************************************************************/
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-#else
-static DWORD WINAPI MyClassThreadFunction(LPVOID lpParam){ 
-	classifyData* pDataArray;
-	pDataArray = (classifyData*)lpParam;
+	//shared by the reader, the worker threads and the writer in createProcesses
+	map<int, classifyBlock*> readBlocks; //block index -> sequences waiting to be classified
+	map<int, classifyBlock*> finishedBlocks; //block index -> output lines waiting to be written
+	int numBlocksRead, nextToWrite;
+	bool doneReading;
+	unsigned long long blockSeed;
+	mutex blockLock;
+	condition_variable blockRead, blockReady, blockSpace;
 	
-	try {
-		ofstream outTax;
-		pDataArray->m->openOutputFile(pDataArray->taxFName, outTax);
-		
-		ofstream outTaxSimple;
-		pDataArray->m->openOutputFile(pDataArray->tempTFName, outTaxSimple);
-		
-		ofstream outAcc;
-		pDataArray->m->openOutputFile(pDataArray->accnos, outAcc);
-		
-		ifstream inFASTA;
-		pDataArray->m->openInputFile(pDataArray->filename, inFASTA);
-		
-		string taxonomy;
-				
-		//print header if you are process 0
-		if ((pDataArray->start == 0) || (pDataArray->start == 1)) {
-			inFASTA.seekg(0);
-            pDataArray->m->zapGremlins(inFASTA);
-		}else { //this accounts for the difference in line endings. 
-			inFASTA.seekg(pDataArray->start-1); pDataArray->m->gobble(inFASTA); 
-		}
-		
-		//make classify
-		Classify* myclassify;
-        string outputMethodTag = pDataArray->method + ".";
-		if(pDataArray->method == "wang"){	myclassify = new Bayesian(pDataArray->taxonomyFileName, pDataArray->templateFileName, pDataArray->search, pDataArray->kmerSize, pDataArray->cutoff, pDataArray->iters, pDataArray->threadID, pDataArray->flip, pDataArray->writeShortcuts);		}
-		else if(pDataArray->method == "knn"){	myclassify = new Knn(pDataArray->taxonomyFileName, pDataArray->templateFileName, pDataArray->search, pDataArray->kmerSize, pDataArray->gapOpen, pDataArray->gapExtend, pDataArray->match, pDataArray->misMatch, pDataArray->numWanted, pDataArray->threadID);				}
-        else if(pDataArray->method == "zap"){	
-            outputMethodTag = pDataArray->search + "_" + outputMethodTag;
-            if (pDataArray->search == "kmer") {   myclassify = new KmerTree(pDataArray->templateFileName, pDataArray->taxonomyFileName, pDataArray->kmerSize, pDataArray->cutoff); }
-            else {  myclassify = new AlignTree(pDataArray->templateFileName, pDataArray->taxonomyFileName, pDataArray->cutoff);  }
-        }
-		else {
-			pDataArray->m->mothurOut(pDataArray->method + " is not a valid method option. I will run the command using wang.");
-			pDataArray->m->mothurOutEndLine();
-			myclassify = new Bayesian(pDataArray->taxonomyFileName, pDataArray->templateFileName, pDataArray->search, pDataArray->kmerSize, pDataArray->cutoff, pDataArray->iters, pDataArray->threadID, pDataArray->flip, pDataArray->writeShortcuts);	
-		}
-		
-		if (pDataArray->m->control_pressed) { delete myclassify; return 0; }
-		
-		pDataArray->count = 0;
-		for(int i = 0; i < pDataArray->end; i++){ //end is the number of sequences to process
-			
-			if (pDataArray->m->control_pressed) { delete myclassify; return 0; }
-			
-			Sequence* candidateSeq = new Sequence(inFASTA); pDataArray->m->gobble(inFASTA);
-			
-			if (candidateSeq->getName() != "") {
-				
-				taxonomy = myclassify->getTaxonomy(candidateSeq);
-				
-				if (pDataArray->m->control_pressed) { delete candidateSeq; return 0; }
-				
-				if (taxonomy == "unknown;") { pDataArray->m->mothurOut("[WARNING]: " + candidateSeq->getName() + " could not be classified. You can use the remove.lineage command with taxon=unknown; to remove such sequences."); pDataArray->m->mothurOutEndLine(); }
-
-				//output confidence scores or not
-				if (pDataArray->probs) {
-					outTax << candidateSeq->getName() << '\t' << taxonomy << endl;
-				}else{
-					outTax << candidateSeq->getName() << '\t' << myclassify->getSimpleTax() << endl;
-				}
-					
-				outTaxSimple << candidateSeq->getName() << '\t' << myclassify->getSimpleTax() << endl;
-					
-				if (myclassify->getFlipped()) { outAcc << candidateSeq->getName() << endl; }
-				
-				pDataArray->count++;
-			}
-			delete candidateSeq;
-			//report progress
-			if((pDataArray->count) % 100 == 0){	pDataArray->m->mothurOutJustToScreen("Processing sequence: " + toString(pDataArray->count)+"\n"); 	}
-			
-		}
-		//report progress
-		if((pDataArray->count) % 100 != 0){	pDataArray->m->mothurOutJustToScreen("Processing sequence: " + toString(pDataArray->count)+"\n"); 		}
-		
-		delete myclassify;
-		inFASTA.close();
-		outTax.close();
-		outTaxSimple.close();
-		
-	}
-	catch(exception& e) {
-		pDataArray->m->errorOut(e, "ClassifySeqsCommand", "MyClassThreadFunction");
-		exit(1);
-	}
-} 
-#endif
-
-
-
+	Classify* createClassifier();
+	int createProcesses(string, string, string, string);
+	void readerThread(string);
+	void workerThread(Classify*);
+};
 
 #endif
 
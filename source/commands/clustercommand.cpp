@@ -63,7 +63,7 @@ string ClusterCommand::getHelpString(){
         helpString += "The initialize parameter allows to select the initial randomization for the opticluster method. Options are singleton, meaning each sequence is randomly assigned to its own OTU, or oneotu meaning all sequences are assigned to one otu. Default=singleton.\n";
         helpString += "The delta parameter allows to set the stable value for the metric in the opticluster method (delta=0.0001). \n";
         helpString += "The method parameter allows you to enter your clustering mothod. Options are furthest, nearest, average, weighted, agc, dgc and opti. Default=opti.  The agc and dgc methods require a fasta file.";
-        helpString += "The processors parameter allows you to specify the number of processors to use. The default is 1.\n";
+        helpString += "The processors parameter allows you to specify the number of processors to use with the agc, dgc and opti methods. The opti method finds the moves for batches of sequences in parallel. The default is 1.\n";
        helpString += "The cluster command should be in the following format: \n";
 		helpString += "cluster(method=yourMethod, cutoff=yourCutoff, precision=yourPrecision) \n";
 		helpString += "The acceptable cluster methods are furthest, nearest, average and weighted.  If no method is provided then average is assumed.\n";	
@@ -307,8 +307,8 @@ ClusterCommand::ClusterCommand(string option)  {
             
             if ((method == "agc") || (method == "dgc")) {
                 if (fastafile == "") { m->mothurOut("[ERROR]: You must provide a fasta file when using the agc or dgc clustering methods, aborting\n."); abort = true;}
-            }else if (setProcessors) {
-                m->mothurOut("[WARNING]: You can only use the processors option when using the agc or dgc clustering methods. Using 1 processor.\n.");
+            }else if ((method != "opti") && setProcessors) {
+                m->mothurOut("[WARNING]: You can only use the processors option when using the agc, dgc or opti clustering methods. Using 1 processor.\n.");
             }
             
             cutOffSet = false;
@@ -854,7 +854,7 @@ int ClusterCommand::runOptiCluster(){
         
         //m->mothurOut("It took " + toString(time(NULL) - rstart) + " seconds to read and process matrix"); m->mothurOutEndLine();
         
-        OptiCluster cluster(&matrix, metric, 0);
+        OptiCluster cluster(&matrix, metric, 0, processors);
         tag = cluster.getTag();
         
         m->mothurOutEndLine(); m->mothurOut("Clustering " + distfile); m->mothurOutEndLine();
@@ -1399,7 +1399,7 @@ string ClusterSplitCommand::runOptiCluster(string thisDistFile, string thisNamef
         
         OptiMatrix matrix(thisDistFile, thisNamefile, nameOrCount, "column", cutoff, false);
         
-        OptiCluster cluster(&matrix, metric, numSingletons);
+        OptiCluster cluster(&matrix, metric, numSingletons, 1);
         tag = cluster.getTag();
         
         m->mothurOutEndLine(); m->mothurOut("Clustering " + thisDistFile); m->mothurOutEndLine();
@@ -1637,7 +1637,14 @@ int ClusterSplitCommand::createMergedDistanceFile(vector< map<string, string> >
 			
 			string thisDistFile = distNames[i].begin()->first;
 			
-			m->appendFiles(thisDistFile, outputFileName);
+			//binary distance files have their own name tables, so they are merged as column text
+			if (BinaryDistanceFile::isBinary(thisDistFile)) {
+				string tempColumnFile = thisDistFile + ".column.temp";
+				BinaryDistanceFile dists(thisDistFile);
+				dists.exportColumn(tempColumnFile);
+				m->appendFiles(tempColumnFile, outputFileName);
+				m->mothurRemove(tempColumnFile);
+			}else { m->appendFiles(thisDistFile, outputFileName); }
 		}	
 			
 		outputTypes["column"].push_back(outputFileName); outputNames.push_back(outputFileName);
@@ -9,6 +9,7 @@
 
 #include "deconvolutecommand.h"
 #include "sequence.hpp"
+#include <unordered_set>
 
 //**********************************************************************************************************************
 vector<string> DeconvoluteCommand::setParameters(){	
@@ -17,6 +18,7 @@ vector<string> DeconvoluteCommand::setParameters(){
 		CommandParameter pname("name", "InputTypes", "", "", "namecount", "none", "none","name",false,false,true); parameters.push_back(pname);
         CommandParameter pcount("count", "InputTypes", "", "", "namecount", "none", "none","count",false,false,true); parameters.push_back(pcount);
         CommandParameter pformat("format", "Multiple", "count-name", "name", "", "", "","",false,false, true); parameters.push_back(pformat);
+        CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
         CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -35,10 +37,11 @@ string DeconvoluteCommand::getHelpString(){
 	try {
 		string helpString = "";
 		helpString += "The unique.seqs command reads a fastafile and creates a name or count file.\n";
-		helpString += "The unique.seqs command parameters are fasta, name, count and format.  fasta is required, unless there is a valid current fasta file.\n";
+		helpString += "The unique.seqs command parameters are fasta, name, count, format and processors.  fasta is required, unless there is a valid current fasta file.\n";
         helpString += "The name parameter is used to provide an existing name file associated with the fasta file. \n";
         helpString += "The count parameter is used to provide an existing count file associated with the fasta file. \n";
         helpString += "The format parameter is used to indicate what type of file you want outputted.  Choices are name and count, default=name unless count file used then default=count.\n";
+        helpString += "The processors parameter allows you to specify the number of processors to use. The default is 1.\n";
 		helpString += "The unique.seqs command should be in the following format: \n";
 		helpString += "unique.seqs(fasta=yourFastaFile) \n";	
 		return helpString;
@@ -84,7 +87,7 @@ DeconvoluteCommand::DeconvoluteCommand(){
 /**************************************************************************************/
 DeconvoluteCommand::DeconvoluteCommand(string option)  {	
 	try {
-		abort = false; calledHelp = false;   
+		abort = false; calledHelp = false;   batchLength = 16777216;
 		
 		//allow user to run help
 		if(option == "help") { help(); abort = true; calledHelp = true; }
@@ -174,6 +177,10 @@ DeconvoluteCommand::DeconvoluteCommand(string option)  {
                 else { format = "name";                     }
             }
             
+            string temp = validParameter.validFile(parameters, "processors", false);	if (temp == "not found"){	temp = m->getProcessors();	}
+			m->setProcessors(temp);
+			m->mothurConvert(temp, processors);
+            
             if ((format != "name") && (format != "count")) {
                 m->mothurOut(format + " is not a valid format option. Options are count or name.");
                 if (countfile == "") { m->mothurOut("I will use name.\n"); format = "name"; }
@@ -196,6 +203,27 @@ DeconvoluteCommand::DeconvoluteCommand(string option)  {
 	}
 }
 /**************************************************************************************/
+//finds the uniques of a batch in file order, printing each new unique as it is found
+void DeconvoluteCommand::findUniques(FingerprintTable& uniques, vector<string>& seqs, vector<string>& headers, vector<int>& reads, vector< vector<int> >& uniqueReads, ofstream& outFasta) {
+	try {
+		vector<int> ids;
+		uniques.add(seqs, ids);
+		
+		for (int i = 0; i < ids.size(); i++) {
+			if (ids[i] == uniqueReads.size()) { //this is a new unique sequence
+				outFasta << ">" << headers[i] << endl << seqs[i] << endl;
+				uniqueReads.push_back(vector<int>(1, reads[i]));
+			}else { uniqueReads[ids[i]].push_back(reads[i]); } //this is a dup
+		}
+		
+		seqs.clear(); headers.clear(); reads.clear();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "DeconvoluteCommand", "findUniques");
+		exit(1);
+	}
+}
+/**************************************************************************************/
 int DeconvoluteCommand::execute() {	
 	try {
 		
@@ -234,99 +262,52 @@ int DeconvoluteCommand::execute() {
 		
 		if (m->control_pressed) { return 0; }
 		
-		ifstream in; 
-		m->openInputFile(fastafile, in);
+		BlockReader in(fastafile, 1);
 		
 		ofstream outFasta;
 		m->openOutputFile(outFastaFile, outFasta);
 		
-		map<string, string> sequenceStrings; //sequenceString -> list of names.  "atgc...." -> seq1,seq2,seq3.
-		map<string, string>::iterator itStrings;
-		set<string> nameInFastaFile; //for sanity checking
-		set<string>::iterator itname;
-		vector<string> nameFileOrder;
-        CountTable newCt;
+		//reads are numbered in file order, each unique keeps the numbers of its reads with the representative first
+		FingerprintTable uniques(processors);
+		vector<string> readNames;
+		vector< vector<int> > uniqueReads;
+		unordered_set<string> nameInFastaFile; //for sanity checking
+		vector<string> batchSeqs, batchHeaders; vector<int> batchReads;
+		int batchSize = 0;
 		int count = 0;
 		while (!in.eof()) {
 			
-			if (m->control_pressed) { in.close(); outFasta.close(); m->mothurRemove(outFastaFile); return 0; }
+			if (m->control_pressed) { outFasta.close(); m->mothurRemove(outFastaFile); return 0; }
 			
 			Sequence seq(in);
 			
 			if (seq.getName() != "") {
 				
 				//sanity checks
-				itname = nameInFastaFile.find(seq.getName());
-				if (itname == nameInFastaFile.end()) { nameInFastaFile.insert(seq.getName());  }
-				else { m->mothurOut("[ERROR]: You already have a sequence named " + seq.getName() + " in your fasta file, sequence names must be unique, please correct."); m->mothurOutEndLine(); }
-
-				itStrings = sequenceStrings.find(seq.getAligned());
+				if (!nameInFastaFile.insert(seq.getName()).second) { m->mothurOut("[ERROR]: You already have a sequence named " + seq.getName() + " in your fasta file, sequence names must be unique, please correct."); m->mothurOutEndLine(); }
 				
-				if (itStrings == sequenceStrings.end()) { //this is a new unique sequence
-					//output to unique fasta file
-					seq.printSequence(outFasta);
-					
-					if (namefile != "") {
-						itNames = nameMap.find(seq.getName());
-						
-						if (itNames == nameMap.end()) { //namefile and fastafile do not match
-							m->mothurOut("[ERROR]: " + seq.getName() + " is in your fasta file, and not in your namefile, please correct."); m->mothurOutEndLine();
-						}else {
-                            if (format == "name") { sequenceStrings[seq.getAligned()] = itNames->second;  nameFileOrder.push_back(seq.getAligned());
-                            }else {  newCt.push_back(seq.getName(), m->getNumNames(itNames->second)); sequenceStrings[seq.getAligned()] = seq.getName();	nameFileOrder.push_back(seq.getAligned()); }
-						}
-					}else if (countfile != "") {
-                        if (format == "name") {
-                            int numSeqs = ct.getNumSeqs(seq.getName());
-                            string expandedName = seq.getName()+"_0";
-                            for (int i = 1; i < numSeqs; i++) {  expandedName += "," + seq.getName() + "_" + toString(i);  }
-                            sequenceStrings[seq.getAligned()] = expandedName;  nameFileOrder.push_back(seq.getAligned());
-                        }else {
-                            ct.getNumSeqs(seq.getName()); //checks to make sure seq is in table
-                            sequenceStrings[seq.getAligned()] = seq.getName();	nameFileOrder.push_back(seq.getAligned());
-                        }
-                    }else {
-                        if (format == "name") { sequenceStrings[seq.getAligned()] = seq.getName();	nameFileOrder.push_back(seq.getAligned()); }
-                        else {  newCt.push_back(seq.getName()); sequenceStrings[seq.getAligned()] = seq.getName();	nameFileOrder.push_back(seq.getAligned()); }
-                    }
-				}else { //this is a dup
-					if (namefile != "") {
-						itNames = nameMap.find(seq.getName());
-						
-						if (itNames == nameMap.end()) { //namefile and fastafile do not match
-							m->mothurOut("[ERROR]: " + seq.getName() + " is in your fasta file, and not in your namefile, please correct."); m->mothurOutEndLine();
-						}else {
-                            if (format == "name") { sequenceStrings[seq.getAligned()] += "," + itNames->second;  }
-                            else {  int currentReps = newCt.getNumSeqs(itStrings->second);  newCt.setNumSeqs(itStrings->second, currentReps+(m->getNumNames(itNames->second)));  }
-						}
-                    }else if (countfile != "") {
-                        if (format == "name") {
-                            int numSeqs = ct.getNumSeqs(seq.getName());
-                            string expandedName = seq.getName()+"_0";
-                            for (int i = 1; i < numSeqs; i++) {  expandedName += "," + seq.getName() + "_" + toString(i);  }
-                            sequenceStrings[seq.getAligned()] += "," + expandedName;
-                        }else {
-                            int num = ct.getNumSeqs(seq.getName()); //checks to make sure seq is in table
-                            if (num != 0) { //its in the table
-                                ct.mergeCounts(itStrings->second, seq.getName()); //merges counts and saves in uniques name
-                            }
-                        }
-                    }else {
-                        if (format == "name") {  sequenceStrings[seq.getAligned()] += "," + seq.getName(); }
-                        else {  int currentReps = newCt.getNumSeqs(itStrings->second); newCt.setNumSeqs(itStrings->second, currentReps+1);  }
-                    }
+				//namefile and fastafile do not match, the read would have no names in the output so stop
+				if ((namefile != "") && (nameMap.count(seq.getName()) == 0)) {
+					m->mothurOut("[ERROR]: " + seq.getName() + " is in your fasta file, and not in your namefile, please correct."); m->mothurOutEndLine();
+					m->control_pressed = true; continue;
 				}
+				
+				batchReads.push_back(readNames.size()); readNames.push_back(seq.getName());
+				batchHeaders.push_back(seq.getName() + seq.getComment());
+				batchSeqs.push_back(seq.getAligned());
+				batchSize += batchSeqs.back().length();
 				count++;
 			}
 			
-			m->gobble(in);
-			
-			if(count % 1000 == 0)	{ m->mothurOutJustToScreen(toString(count) + "\t" + toString(sequenceStrings.size()) + "\n");	}
+			if ((batchSize >= batchLength) || in.eof()) {
+				findUniques(uniques, batchSeqs, batchHeaders, batchReads, uniqueReads, outFasta);
+				batchSize = 0;
+				m->mothurOutJustToScreen(toString(count) + "\t" + toString(uniqueReads.size()) + "\n");
+			}
 		}
 		
-		if(count % 1000 != 0)	{ m->mothurOut(toString(count) + "\t" + toString(sequenceStrings.size())); m->mothurOutEndLine();	}
+		if(count % 1000 != 0)	{ m->mothurOut(toString(count) + "\t" + toString(uniqueReads.size())); m->mothurOutEndLine();	}
 		
-		in.close();
 		outFasta.close();
 		
 		if (m->control_pressed) { m->mothurRemove(outFastaFile); return 0; }
@@ -336,29 +317,49 @@ int DeconvoluteCommand::execute() {
 		if (format == "name") { m->openOutputFile(outNameFile, outNames); outputNames.push_back(outNameFile); outputTypes["name"].push_back(outNameFile);   }
         else { m->openOutputFile(outCountFile, outNames); outputTypes["count"].push_back(outCountFile); outputNames.push_back(outCountFile);                }
         
+        CountTable newCt;
         if ((countfile != "") && (format == "count")) { ct.printHeaders(outNames); }
         else if ((countfile == "") && (format == "count")) { newCt.printHeaders(outNames); }
 		
-		for (int i = 0; i < nameFileOrder.size(); i++) {
+		for (int i = 0; i < uniqueReads.size(); i++) {
 			if (m->control_pressed) { outputTypes.clear(); m->mothurRemove(outFastaFile); outNames.close(); for (int j = 0; j < outputNames.size(); j++) { m->mothurRemove(outputNames[j]); } return 0; }
 			
-			itStrings = sequenceStrings.find(nameFileOrder[i]);
+			vector<int>& reads = uniqueReads[i];
+			string repName = readNames[reads[0]];
 			
-			if (itStrings != sequenceStrings.end()) {
-                if (format == "name") {
-                    //get rep name
-                    int pos = (itStrings->second).find_first_of(',');
-                    
-                    if (pos == string::npos) { // only reps itself
-                        outNames << itStrings->second << '\t' << itStrings->second << endl;
-                    }else {
-                        outNames << (itStrings->second).substr(0, pos) << '\t' << itStrings->second << endl;
-                    }
-                }else {
-                    if (countfile != "") {  ct.printSeq(outNames, itStrings->second);  }
-                    else if (format == "count")  {  newCt.printSeq(outNames, itStrings->second);  }
-                }
-			}else{ m->mothurOut("[ERROR]: mismatch in namefile print."); m->mothurOutEndLine(); m->control_pressed = true; }
+			if (format == "name") {
+				string names = "";
+				for (int j = 0; j < reads.size(); j++) {
+					string name = readNames[reads[j]];
+					if (j != 0) { names += ","; }
+					
+					if (namefile != "") { names += nameMap[name]; }
+					else if (countfile != "") {
+						int numSeqs = ct.getNumSeqs(name);
+						names += name + "_0";
+						for (int k = 1; k < numSeqs; k++) {  names += "," + name + "_" + toString(k);  }
+					}else { names += name; }
+				}
+				
+				//get rep name
+				int pos = names.find_first_of(',');
+				if (pos == string::npos) { outNames << names << '\t' << names << endl; } // only reps itself
+				else { outNames << names.substr(0, pos) << '\t' << names << endl; }
+			}else if (countfile != "") {
+				ct.getNumSeqs(repName); //checks to make sure seq is in table
+				for (int j = 1; j < reads.size(); j++) {
+					if (ct.getNumSeqs(readNames[reads[j]]) != 0) { ct.mergeCounts(repName, readNames[reads[j]]); } //merges counts and saves in uniques name
+				}
+				ct.printSeq(outNames, repName);
+			}else {
+				int total = 0;
+				for (int j = 0; j < reads.size(); j++) {
+					if (namefile != "") { total += m->getNumNames(nameMap[readNames[reads[j]]]); }
+					else { total++; }
+				}
+				newCt.push_back(repName, total);
+				newCt.printSeq(outNames, repName);
+			}
 		}
 		outNames.close();
 		
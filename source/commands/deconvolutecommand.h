@@ -12,6 +12,7 @@
 #include "command.hpp"
 #include "fastamap.h"
 #include "counttable.h"
+#include "fingerprinttable.h"
 
 /* The unique.seqs command reads a fasta file, finds the duplicate sequences and outputs a names file
 	containing 2 columns.  The first being the groupname and the second the list of identical sequence names. */ 
@@ -19,6 +20,10 @@
 
 class DeconvoluteCommand : public Command {
 
+#ifdef UNIT_TEST
+    friend class TestDeconvoluteCommand;
+#endif
+
 public:
 	DeconvoluteCommand(string);
 	DeconvoluteCommand();
@@ -41,8 +46,11 @@ public:
 private:
 	string fastafile, namefile, outputDir, countfile, format;
 	vector<string> outputNames;
+	int processors, batchLength; //characters of sequence fingerprinted at a time
 
 	bool abort;
+	
+	void findUniques(FingerprintTable&, vector<string>&, vector<string>&, vector<int>&, vector< vector<int> >&, ofstream&);
 };
 
 #endif
@@ -15,7 +15,7 @@ vector<string> DistanceCommand::setParameters(){
 		CommandParameter pcolumn("column", "InputTypes", "", "", "none", "none", "OldFastaColumn","column",false,false); parameters.push_back(pcolumn);
 		CommandParameter poldfasta("oldfasta", "InputTypes", "", "", "none", "none", "OldFastaColumn","",false,false); parameters.push_back(poldfasta);
 		CommandParameter pfasta("fasta", "InputTypes", "", "", "none", "none", "none","phylip-column",false,true, true); parameters.push_back(pfasta);
-		CommandParameter poutput("output", "Multiple", "column-lt-square-phylip", "column", "", "", "","phylip-column",false,false, true); parameters.push_back(poutput);
+		CommandParameter poutput("output", "Multiple", "column-lt-square-phylip-binary", "column", "", "", "","phylip-column",false,false, true); parameters.push_back(poutput);
 		CommandParameter pcalc("calc", "Multiple", "nogaps-eachgap-onegap", "onegap", "", "", "","",false,false); parameters.push_back(pcalc);
 		CommandParameter pcountends("countends", "Boolean", "", "T", "", "", "","",false,false); parameters.push_back(pcountends);
 		CommandParameter pcompress("compress", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pcompress);
@@ -45,7 +45,7 @@ string DistanceCommand::getHelpString(){
 		helpString += "The calc parameter allows you to specify the method of calculating the distances.  Your options are: nogaps, onegap or eachgap. The default is onegap.\n";
 		helpString += "The countends parameter allows you to specify whether to include terminal gaps in distance.  Your options are: T or F. The default is T.\n";
 		helpString += "The cutoff parameter allows you to specify maximum distance to keep. The default is 1.0.\n";
-		helpString += "The output parameter allows you to specify format of your distance matrix. Options are column, lt, and square. The default is column.\n";
+		helpString += "The output parameter allows you to specify format of your distance matrix. Options are column, lt, square and binary. The default is column. The binary option writes the column distances in a compact binary file that the cluster and cluster.split commands can read in place of a column file.\n";
 		helpString += "The processors parameter allows you to specify number of processors to use.  The default is 1.\n";
 		helpString += "The compress parameter allows you to indicate that you want the resulting distance file compressed.  The default is false.\n";
 		helpString += "The dist.seqs command should be in the following format: \n";
@@ -65,7 +65,7 @@ string DistanceCommand::getOutputPattern(string type) {
         string pattern = "";
         
         if (type == "phylip") {  pattern = "[filename],[outputtag],dist"; } 
-        else if (type == "column") { pattern = "[filename],dist"; }
+        else if (type == "column") { pattern = "[filename],dist-[filename],[outputtag],dist"; }
         else { m->mothurOut("[ERROR]: No definition for type " + type + " output pattern.\n"); m->control_pressed = true;  }
         
         return pattern;
@@ -212,7 +212,7 @@ DistanceCommand::DistanceCommand(string option) {
 			
 			if ((column != "") && (oldfastafile != "") && (output != "column")) { m->mothurOut("You have provided column and oldfasta, indicating you want to append distances to your column file. Your output must be in column format to do so."); m->mothurOutEndLine(); abort=true; }
 			
-			if ((output != "column") && (output != "lt") && (output != "square")) { m->mothurOut(output + " is not a valid output form. Options are column, lt and square. I will use column."); m->mothurOutEndLine(); output = "column"; }
+			if ((output != "column") && (output != "lt") && (output != "square") && (output != "binary")) { m->mothurOut(output + " is not a valid output form. Options are column, lt, square and binary. I will use column."); m->mothurOutEndLine(); output = "column"; }
 
 		}
 				
@@ -265,6 +265,11 @@ int DistanceCommand::execute(){
 			}
 			
 			m->mothurRemove(outputFile);
+		}else if (output == "binary") { //column distances in the binary format
+			variables["[outputtag]"] = "binary";
+			outputFile = getOutputFileName("column", variables);
+			m->mothurRemove(outputFile);
+			outputTypes["column"].push_back(outputFile);
 		}else { //assume square
 			variables["[outputtag]"] = "square";
 			outputFile = getOutputFileName("phylip", variables);
@@ -272,21 +277,27 @@ int DistanceCommand::execute(){
 			outputTypes["phylip"].push_back(outputFile);
 		}
 
-		//if you don't need to fork anything
-		if(processors == 1){
-			if (output != "square") {  driver(0, numSeqs, outputFile, cutoff); }
-			else { driver(0, numSeqs, outputFile, "square");  }
-		}else{ //you have multiple processors
-			createProcesses(outputFile, numSeqs);
-		}
+		//pack the sequences once so the calculators can compare 64 columns at a time
+		packedSeqs.clear();
+		for (int i = 0; i < numSeqs; i++) { packedSeqs.push_back(PackedSeq(alignDB.get(i))); }
+		alignDB.clear();
+		
+		if (m->control_pressed) { outputTypes.clear(); return 0; }
+		
+		createProcesses(outputFile, numSeqs);
 
 		if (m->control_pressed) { outputTypes.clear();  m->mothurRemove(outputFile); return 0; }
 		
-		ifstream fileHandle;
-		fileHandle.open(outputFile.c_str());
-		if(fileHandle) {
-			m->gobble(fileHandle);
-			if (fileHandle.eof()) { m->mothurOut(outputFile + " is blank. This can result if there are no distances below your cutoff.");  m->mothurOutEndLine(); }
+		if (output == "binary") {
+			BinaryDistanceFile distFile(outputFile);
+			if (distFile.getNumDists() == 0) { m->mothurOut(outputFile + " has no distances. This can result if there are no distances below your cutoff.");  m->mothurOutEndLine(); }
+		}else {
+			ifstream fileHandle;
+			fileHandle.open(outputFile.c_str());
+			if(fileHandle) {
+				m->gobble(fileHandle);
+				if (fileHandle.eof()) { m->mothurOut(outputFile + " is blank. This can result if there are no distances below your cutoff.");  m->mothurOutEndLine(); }
+			}
 		}
 		
 		//append the old column file to the new one
@@ -348,181 +359,152 @@ int DistanceCommand::execute(){
 	}
 }
 /**************************************************************************************************/
-void DistanceCommand::createProcesses(string filename, int numSeqs) {
+//splits the rows into tiles of roughly equal work. Tiles are small enough that a fast thread keeps pulling
+//new ones while a slow thread finishes its last, and the writer never holds more than a few in memory.
+void DistanceCommand::createTiles(int numSeqs) {
 	try {
-        unsigned long long numDists = 0;
-        
-        if (output == "square") {
-            numDists = numSeqs * numSeqs;
-        }else {
-            for(int i=0;i<numSeqs;i++){
-                for(int j=0;j<i;j++){
-                    numDists++;
-                    if (numDists > processors) { break; }
-                }
-            }
-        }
-        
-        if (numDists < processors) { processors = numDists; }
-        
-        for (int i = 0; i < processors; i++) {
-            distlinePair tempLine;
-            lines.push_back(tempLine);
-            if (output != "square") {
-                lines[i].start = int (sqrt(float(i)/float(processors)) * numSeqs);
-                lines[i].end = int (sqrt(float(i+1)/float(processors)) * numSeqs);
-            }else{
-                lines[i].start = int ((float(i)/float(processors)) * numSeqs);
-                lines[i].end = int ((float(i+1)/float(processors)) * numSeqs);
-            }
-            
-        }
-
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-		int process = 1;
-		processIDS.clear();
-        bool recalc = false;
-		
-		//loop through and create all the processes you want
-		while (process != processors) {
-			pid_t pid = fork();
+		tiles.clear();
+		
+		unsigned long long numDists = 0;
+		for (int i = 0; i < numSeqs; i++) {
+			if (output == "square")		{ numDists += numSeqs; }
+			else if (i < numNewFasta)	{ numDists += i; }
+			else						{ numDists += numNewFasta; }
+		}
+		
+		unsigned long long distsPerTile = numDists / (processors * 64);
+		if (distsPerTile > 1000000)	{ distsPerTile = 1000000; }
+		if (distsPerTile < 1)		{ distsPerTile = 1; }
+		
+		int start = 0;
+		unsigned long long tileDists = 0;
+		for (int i = 0; i < numSeqs; i++) {
+			if (output == "square")		{ tileDists += numSeqs; }
+			else if (i < numNewFasta)	{ tileDists += i; }
+			else						{ tileDists += numNewFasta; }
 			
-			if (pid > 0) {
-                processIDS.push_back(pid);  //create map from line number to pid so you can append files in correct order later
-                process++;
-                if (m->debug) { m->mothurOut("[DEBUG]: parent process is saving child pid " + toString(pid) + ".\n"); }
-            }else if (pid == 0){
-				if (output != "square") {  driver(lines[process].start, lines[process].end, filename + m->mothurGetpid(process) + ".temp", cutoff); }
-				else { driver(lines[process].start, lines[process].end, filename + m->mothurGetpid(process) + ".temp", "square"); }
-				exit(0);
-			}else { 
-                m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(process) + "\n"); processors = process;
-                for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-                //wait to die
-                for (int i=0;i<processIDS.size();i++) {
-                    int temp = processIDS[i];
-                    wait(&temp);
-                }
-                for (int i=0;i<processIDS.size();i++) {
-                    m->mothurRemove(filename + (toString(processIDS[i]) + ".temp"));
-                }
-                m->control_pressed = false;
-                recalc = true;
-                break;
-			}
+			if (tileDists >= distsPerTile) { tiles.push_back(distTile(start, i+1)); start = i+1; tileDists = 0; }
 		}
-        
-        if (recalc) {
-            //test line, also set recalc to true.
-            //for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); } for (int i=0;i<processIDS.size();i++) { int temp = processIDS[i]; wait(&temp); } for (int i=0;i<processIDS.size();i++) {m->mothurRemove(filename + (toString(processIDS[i]) + ".temp"));}m->control_pressed = false;  processors=3; m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(processors) + "\n");
-            
-            processIDS.resize(0);
-            process = 1;
-            lines.clear();
-            
-            for (int i = 0; i < processors; i++) {
-                distlinePair tempLine;
-                lines.push_back(tempLine);
-                if (output != "square") {
-                    lines[i].start = int (sqrt(float(i)/float(processors)) * numSeqs);
-                    lines[i].end = int (sqrt(float(i+1)/float(processors)) * numSeqs);
-                }else{
-                    lines[i].start = int ((float(i)/float(processors)) * numSeqs);
-                    lines[i].end = int ((float(i+1)/float(processors)) * numSeqs);
-                }
-            }
-            
-            //loop through and create all the processes you want
-            while (process != processors) {
-                pid_t pid = fork();
-                
-                if (pid > 0) {
-                    processIDS.push_back(pid);  //create map from line number to pid so you can append files in correct order later
-                    process++;
-                    if (m->debug) { m->mothurOut("[DEBUG]: parent process is saving child pid " + toString(pid) + ".\n"); }
-                }else if (pid == 0){
-                    if (output != "square") {  driver(lines[process].start, lines[process].end, filename + m->mothurGetpid(process) + ".temp", cutoff); }
-                    else { driver(lines[process].start, lines[process].end, filename + m->mothurGetpid(process) + ".temp", "square"); }
-                    exit(0);
-                }else {
-                    m->mothurOut("[ERROR]: unable to spawn the necessary processes. Error code: " + toString(pid)); m->mothurOutEndLine();
-                    perror(" : ");
-                    for (int i=0;i<processIDS.size();i++) {  int temp = processIDS[i]; kill (temp, SIGINT); }
-                    exit(0);
-                }
-            }
-        }
-		
-		//parent does its part
-		if (output != "square") {  driver(lines[0].start, lines[0].end, filename, cutoff); }
-		else { driver(lines[0].start, lines[0].end, filename, "square"); }
-		
-		
-		//force parent to wait until all the processes are done
-		for (int i=0;i<processIDS.size();i++) { 
-			int temp = processIDS[i];
-			wait(&temp);
+		if (start < numSeqs) { tiles.push_back(distTile(start, numSeqs)); }
+	}
+	catch(exception& e) {
+		m->errorOut(e, "DistanceCommand", "createTiles");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//all threads share packedSeqs. Each worker pulls the next tile, formats its rows in memory and hands them to
+//this thread, which writes the tiles to the output file in row order. No temp files are created.
+void DistanceCommand::createProcesses(string filename, int numSeqs) {
+	try {
+		createTiles(numSeqs);
+		
+		if (tiles.size() < processors) { processors = tiles.size(); }
+		if (processors < 1) { processors = 1; }
+		
+		nextTile = 0;
+		nextToWrite = 0;
+		finishedTiles.clear();
+		
+		//the binary file starts with the name table, the tiles are appended after it
+		binaryPrecision = BinaryDistanceFile::precisionForCutoff(cutoff);
+		if (output == "binary") {
+			vector<string> names;
+			for (int i = 0; i < packedSeqs.size(); i++) { names.push_back(packedSeqs[i].getName()); }
+			BinaryDistanceFile::writeHeader(filename, names, binaryPrecision);
+		}
+		
+		vector<thread*> workerThreads;
+		for (int i = 0; i < processors; i++) {
+			workerThreads.push_back(new thread(&DistanceCommand::workerThread, this));
 		}
-#else
-		//////////////////////////////////////////////////////////////////////////////////////////////////////
-		//Windows version shared memory, so be careful when passing variables through the distanceData struct. 
-		//Above fork() will clone, so memory is separate, but that's not the case with windows, 
-		//that's why the distance calculator was moved inside of the driver to make separate copies.
-		//////////////////////////////////////////////////////////////////////////////////////////////////////
-		
-		vector<distanceData*> pDataArray; //[processors-1];
-		DWORD   dwThreadIdArray[processors-1];
-		HANDLE  hThreadArray[processors-1]; 
-		
-		//Create processor-1 worker threads.
-		for( int i=0; i<processors-1; i++ ){
+		
+		ofstream outFile;
+		if (output == "binary")	{ outFile.open(filename.c_str(), ios::binary | ios::app); }
+		else					{ outFile.open(filename.c_str(), ios::trunc); }
+		
+		int startTime = time(NULL);
+		while (nextToWrite < tiles.size()) {
+			string buffer;
+			{
+				unique_lock<mutex> lock(tileLock);
+				while (!m->control_pressed && (finishedTiles.count(nextToWrite) == 0)) { tileReady.wait_for(lock, chrono::milliseconds(100)); }
+				if (m->control_pressed) { break; }
+				
+				map<int, string>::iterator it = finishedTiles.find(nextToWrite);
+				buffer.swap(it->second);
+				finishedTiles.erase(it);
+				nextToWrite++;
+			}
+			tileSpace.notify_all();
 			
-			// Allocate memory for thread data.
-			distanceData* tempDist = new distanceData(lines[i+1].start, lines[i+1].end, (filename + toString(i) + ".temp"), cutoff, alignDB, Estimators, m, output, numNewFasta, countends);
-			pDataArray.push_back(tempDist);
-			processIDS.push_back(i);
+			outFile << buffer;
 			
-			//MyDistThreadFunction is in header. It must be global or static to work with the threads.
-			//default security attributes, thread function name, argument to thread function, use default creation flags, returns the thread identifier
-			hThreadArray[i] = CreateThread(NULL, 0, MyDistThreadFunction, pDataArray[i], 0, &dwThreadIdArray[i]);   
+			distTile& written = tiles[nextToWrite-1];
+			if (((written.start / 100) != (written.end / 100)) || (nextToWrite == tiles.size())) {
+				m->mothurOutJustToScreen(toString(written.end-1) + "\t" + toString(time(NULL) - startTime)+"\n");
+			}
 		}
+		tileSpace.notify_all();
 		
-		//do your part
-		if (output != "square") {  driver(lines[0].start, lines[0].end, filename, cutoff); }
-		else { driver(lines[0].start, lines[0].end, filename, "square"); }
+		for (int i = 0; i < workerThreads.size(); i++) {
+			workerThreads[i]->join();
+			delete workerThreads[i];
+		}
 		
-		//Wait until all threads have terminated.
-		WaitForMultipleObjects(processors-1, hThreadArray, TRUE, INFINITE);
+		outFile.close();
+		finishedTiles.clear();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "DistanceCommand", "createProcesses");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+void DistanceCommand::workerThread() {
+	try {
+		Dist* distCalculator = createDistCalculator();
 		
-		//Close all thread handles and free memory allocations.
-		for(int i=0; i < pDataArray.size(); i++){
-            if (pDataArray[i]->count != (pDataArray[i]->endLine-pDataArray[i]->startLine)) {
-                m->mothurOut("[ERROR]: process " + toString(i) + " only processed " + toString(pDataArray[i]->count) + " of " + toString(pDataArray[i]->endLine-pDataArray[i]->startLine) + " sequences assigned to it, quitting. \n"); m->control_pressed = true; 
-            }
-			CloseHandle(hThreadArray[i]);
-			delete pDataArray[i];
-		}
-#endif
+		//bound how far the workers can get ahead of the writer, so memory stays flat
+		int maxAhead = processors * 4;
 		
-		//append and remove temp files
-		for (int i=0;i<processIDS.size();i++) {
-            if (m->debug) { m->mothurOut("[DEBUG]: parent process is appending child pid " + toString(processIDS[i]) + ".\n"); }
-			m->appendFiles((filename + toString(processIDS[i]) + ".temp"), filename);
-			m->mothurRemove((filename + toString(processIDS[i]) + ".temp"));
+		while (!m->control_pressed) {
+			int thisTile = nextTile++;
+			if (thisTile >= tiles.size()) { break; }
+			
+			{
+				unique_lock<mutex> lock(tileLock);
+				while (!m->control_pressed && (thisTile >= (nextToWrite + maxAhead))) { tileSpace.wait_for(lock, chrono::milliseconds(100)); }
+			}
+			if (m->control_pressed) { break; }
+			
+			ostringstream out;
+			out.setf(ios::fixed, ios::showpoint);
+			out << setprecision(4);
+			
+			if (output != "square") { driver(tiles[thisTile].start, tiles[thisTile].end, out, distCalculator, cutoff); }
+			else { driver(tiles[thisTile].start, tiles[thisTile].end, out, distCalculator, "square"); }
+			
+			{
+				lock_guard<mutex> lock(tileLock);
+				finishedTiles[thisTile] = out.str();
+			}
+			tileReady.notify_one();
 		}
 		
+		delete distCalculator;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "DistanceCommand", "createProcesses");
+		m->errorOut(e, "DistanceCommand", "workerThread");
 		exit(1);
 	}
 }
 /**************************************************************************************************/
-/////// need to fix to work with calcs and sequencedb
-int DistanceCommand::driver(int startLine, int endLine, string dFileName, float cutoff){
+//each thread needs its own calculator, since the calculators save the last distance
+Dist* DistanceCommand::createDistCalculator() {
 	try {
 		ValidCalculators validCalculator;
-		Dist* distCalculator;
+		Dist* distCalculator = NULL;
 		if (m->isTrue(countends) == true) {
 			for (int i=0; i<Estimators.size(); i++) {
 				if (validCalculator.isValidCalculator("distance", Estimators[i]) == true) { 
@@ -541,18 +523,21 @@ int DistanceCommand::driver(int startLine, int endLine, string dFileName, float
 			}
 		}
 		
-		int startTime = time(NULL);
-		
-		//column file
-		ofstream outFile(dFileName.c_str(), ios::trunc);
-		outFile.setf(ios::fixed, ios::showpoint);
-		outFile << setprecision(4);
-		
-		if((output == "lt") && startLine == 0){	outFile << alignDB.getNumSeqs() << endl;	}
+		return distCalculator;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "DistanceCommand", "createDistCalculator");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+int DistanceCommand::driver(int startLine, int endLine, ostream& outFile, Dist* distCalculator, float cutoff){
+	try {
+		if((output == "lt") && startLine == 0){	outFile << packedSeqs.size() << endl;	}
 		
 		for(int i=startLine;i<endLine;i++){
 			if(output == "lt")	{	
-				string name = alignDB.get(i).getName();
+				string name = packedSeqs[i].getName();
 				if (name.length() < 10) { //pad with spaces to make compatible
 					while (name.length() < 10) {  name += " ";  }
 				}
@@ -560,32 +545,34 @@ int DistanceCommand::driver(int startLine, int endLine, string dFileName, float
 			}
 			for(int j=0;j<i;j++){
 				
-				if (m->control_pressed) { delete distCalculator; outFile.close(); return 0;  }
+				if (m->control_pressed) { return 0;  }
                 
 				//if there was a column file given and we are appending, we don't want to calculate the distances that are already in the column file
 				//the alignDB contains the new sequences and then the old, so if i an oldsequence and j is an old sequence then break out of this loop
 				if ((i >= numNewFasta) && (j >= numNewFasta)) { break; }
 				
-				distCalculator->calcDist(alignDB.get(i), alignDB.get(j));
-				double dist = distCalculator->getDist();
-				
-				if(dist <= cutoff){
-					if (output == "column") { outFile << alignDB.get(i).getName() << ' ' << alignDB.get(j).getName() << ' ' << dist << endl; }
+				//column files only need the distances at or below the cutoff, so pairs that are certainly above it can be skipped early
+				if ((output == "column") || (output == "binary")) {
+					if (distCalculator->aboveCutoff(packedSeqs[i], packedSeqs[j], cutoff)) { continue; }
+					
+					distCalculator->calcDist(packedSeqs[i], packedSeqs[j], cutoff);
+					double dist = distCalculator->getDist();
+					
+					if(dist <= cutoff){
+						if (output == "binary") {
+							string record;
+							BinaryDistanceFile::appendRecord(record, i, j, dist, binaryPrecision);
+							outFile << record;
+						}else { outFile << packedSeqs[i].getName() << ' ' << packedSeqs[j].getName() << ' ' << dist << '\n'; }
+					}
+				}else {
+					distCalculator->calcDist(packedSeqs[i], packedSeqs[j]);
+					outFile  << '\t' << distCalculator->getDist();
 				}
-                if (output == "lt") {  outFile  << '\t' << dist; }
-			}
-			
-			if (output == "lt") { outFile << endl; }
-            
-            if(i % 100 == 0){
-				m->mothurOutJustToScreen(toString(i) + "\t" + toString(time(NULL) - startTime)+"\n"); 
 			}
 			
+			if (output == "lt") { outFile << '\n'; }
 		}
-		m->mothurOutJustToScreen(toString(endLine-1) + "\t" + toString(time(NULL) - startTime)+"\n");
-		
-		outFile.close();
-		delete distCalculator;
 		
 		return 1;
 	}
@@ -595,67 +582,30 @@ int DistanceCommand::driver(int startLine, int endLine, string dFileName, float
 	}
 }
 /**************************************************************************************************/
-/////// need to fix to work with calcs and sequencedb
-int DistanceCommand::driver(int startLine, int endLine, string dFileName, string square){
+int DistanceCommand::driver(int startLine, int endLine, ostream& outFile, Dist* distCalculator, string square){
 	try {
-		ValidCalculators validCalculator;
-		Dist* distCalculator;
-		if (m->isTrue(countends) == true) {
-			for (int i=0; i<Estimators.size(); i++) {
-				if (validCalculator.isValidCalculator("distance", Estimators[i]) == true) { 
-					if (Estimators[i] == "nogaps")			{	distCalculator = new ignoreGaps();	}
-					else if (Estimators[i] == "eachgap")	{	distCalculator = new eachGapDist();	}
-					else if (Estimators[i] == "onegap")		{	distCalculator = new oneGapDist();	}
-				}
-			}
-		}else {
-			for (int i=0; i<Estimators.size(); i++) {
-				if (validCalculator.isValidCalculator("distance", Estimators[i]) == true) { 
-					if (Estimators[i] == "nogaps")		{	distCalculator = new ignoreGaps();					}
-					else if (Estimators[i] == "eachgap"){	distCalculator = new eachGapIgnoreTermGapDist();	}
-					else if (Estimators[i] == "onegap")	{	distCalculator = new oneGapIgnoreTermGapDist();		}
-				}
-			}
-		}
-		
-		int startTime = time(NULL);
-		
-		//column file
-		ofstream outFile(dFileName.c_str(), ios::trunc);
-		outFile.setf(ios::fixed, ios::showpoint);
-		outFile << setprecision(4);
-		
-		if(startLine == 0){	outFile << alignDB.getNumSeqs() << endl;	}
+		if(startLine == 0){	outFile << packedSeqs.size() << endl;	}
 		
 		for(int i=startLine;i<endLine;i++){
 				
-			string name = alignDB.get(i).getName();
+			string name = packedSeqs[i].getName();
 			//pad with spaces to make compatible
 			if (name.length() < 10) { while (name.length() < 10) {  name += " ";  } }
 				
 			outFile << name << '\t';	
 			
-			for(int j=0;j<alignDB.getNumSeqs();j++){
+			for(int j=0;j<packedSeqs.size();j++){
 				
-				if (m->control_pressed) { delete distCalculator; outFile.close(); return 0;  }
+				if (m->control_pressed) { return 0;  }
 				
-				distCalculator->calcDist(alignDB.get(i), alignDB.get(j));
+				distCalculator->calcDist(packedSeqs[i], packedSeqs[j]);
 				double dist = distCalculator->getDist();
 				
 				outFile << dist << '\t'; 
 			}
 			
-			outFile << endl; 
-			
-			if(i % 100 == 0){
-				m->mothurOutJustToScreen(toString(i) + "\t" + toString(time(NULL) - startTime)+"\n");
-			}
-			
+			outFile << '\n'; 
 		}
-		m->mothurOutJustToScreen(toString(endLine-1) + "\t" + toString(time(NULL) - startTime)+"\n");
-		
-		outFile.close();
-		delete distCalculator;
 		
 		return 1;
 	}
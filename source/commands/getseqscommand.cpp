@@ -509,7 +509,59 @@ int GetSeqsCommand::readFasta(){
         if (m->debug) { set<string> temp; sanity["fasta"] = temp; }
 		
         set<string> uniqueNames;
-		while(!in.eof()){
+        
+        //the names and record positions in a summary cache let us read only the selected sequences
+        SummaryCache cache(fastafile);
+        bool cached = cache.read();
+        //after reading a record the file is at the start of the next one, so short gaps are read through instead of seeking
+        long long recordNum = 0; long long nextRecord = -1; unsigned long long filePos = 0;
+        for (int b = 0; cached && (b < cache.getNumBlocks()); b++) {
+            
+            if (m->control_pressed) { in.close(); out.close(); m->mothurRemove(outputFileName);  return 0; }
+            
+            const summaryBlock& block = cache.getBlock(b);
+            for (int i = 0; cached && (i < block.numSeqs); i++, recordNum++) {
+                if (recordNum == nextRecord) { filePos = block.recordStarts[i]; }
+                name = block.getName(i);
+                
+                if (!dups) {//adjust name if needed
+                    map<string, string>::iterator it = uniqueMap.find(name);
+                    if (it != uniqueMap.end()) { name = it->second; }
+                }
+                
+                //if this name is in the accnos file
+                if (names.count(name) != 0) {
+                    if (uniqueNames.count(name) == 0) { //this name hasn't been seen yet
+                        wroteSomething = true;
+                        
+                        unsigned long long recordStart = block.recordStarts[i];
+                        if ((nextRecord == -1) || ((recordStart - filePos) > 65536)) { in.clear(); in.seekg(recordStart); }
+                        else if (recordStart != filePos) { in.ignore(recordStart - filePos); }
+                        Sequence currSeq(in); m->gobble(in);
+                        if (currSeq.getName() != block.getName(i)) { cached = false; break; } //the cache does not describe this file
+                        currSeq.setName(name);
+                        nextRecord = recordNum + 1;
+                        currSeq.printSequence(out);
+                        selectedCount++;
+                        uniqueNames.insert(name);
+                        
+                        if (m->debug) { sanity["fasta"].insert(name); }
+                    }else {
+                        m->mothurOut("[WARNING]: " + name + " is in your fasta file more than once.  Mothur requires sequence names to be unique. I will only add it once.\n");
+                    }
+                }
+            }
+        }
+        
+        if (!cached && (cache.getNumBlocks() != 0)) { //start over and read the whole file
+            m->mothurOut("[WARNING]: " + fastafile + " does not match its summary cache, reading the whole file.\n");
+            in.clear(); in.seekg(0);
+            out.close(); m->openOutputFile(outputFileName, out);
+            wroteSomething = false; selectedCount = 0; uniqueNames.clear();
+            if (m->debug) { sanity["fasta"].clear(); }
+        }
+        
+		while(!cached && !in.eof()){
 		
 			if (m->control_pressed) { in.close(); out.close(); m->mothurRemove(outputFileName);  return 0; }
 			
@@ -351,6 +351,7 @@ MakeContigsCommand::MakeContigsCommand(string option)  {
 			temp = validParameter.validFile(parameters, "processors", false);	if (temp == "not found"){	temp = m->getProcessors();	}
 			m->setProcessors(temp);
 			m->mothurConvert(temp, processors);
+			gzThreads = processors;
             
             temp = validParameter.validFile(parameters, "bdiffs", false);		if (temp == "not found") { temp = "0"; }
 			m->mothurConvert(temp, bdiffs);
@@ -956,6 +957,10 @@ unsigned long long MakeContigsCommand::createProcessesGroups(vector< vector<stri
         
         if (remainingPairs < processors) { processors = remainingPairs; }
         
+        //each process inflates its own files, so split the decompression threads between them
+        int totalGzThreads = gzThreads;
+        gzThreads = max(1, totalGzThreads / processors);
+        
         int startIndex = 0;
         for (int remainingProcessors = processors; remainingProcessors > 0; remainingProcessors--) {
             int numPairs = remainingPairs; //case for last processor
@@ -1034,6 +1039,7 @@ unsigned long long MakeContigsCommand::createProcessesGroups(vector< vector<stri
             //for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); } for (int i=0;i<processIDS.size();i++) { int temp = processIDS[i]; wait(&temp); } m->control_pressed = false;  for (int i=0;i<processIDS.size();i++) {m->mothurRemove((toString(processIDS[i]) + ".num.temp"));}processors=3; m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(processors) + "\n");
             
             vector<linePair> startEndIndexes;
+            gzThreads = max(1, totalGzThreads / processors);
             
             //divide files between processors
             int remainingPairs = fileInputs.size();
@@ -1828,46 +1834,16 @@ unsigned long long MakeContigsCommand::driver(vector<string> inputFiles, vector<
         
         if (m->debug) {  m->mothurOut("[DEBUG]: ffasta = " + thisffastafile + ".\n[DEBUG]: rfasta = " + thisrfastafile + ".\n[DEBUG]: fqualindex = " + thisfqualindexfile + ".\n[DEBUG]: rqualindex = " + thisfqualindexfile + ".\n"); }
         
-        ifstream inFFasta, inRFasta, inFQualIndex, inRQualIndex;
-        #ifdef USE_BOOST
-        boost::iostreams::filtering_istream inFF, inRF, inFQ, inRQ;
-        #endif
-        if (!gz) { //plain text files
-            m->openInputFile(thisffastafile, inFFasta);
-            m->openInputFile(thisrfastafile, inRFasta);
-            
-            inFFasta.seekg(linesInput.start);
-            inRFasta.seekg(linesInputReverse.start);
-        }else { //compressed files - no need to seekg because compressed files divide workload differently
-            #ifdef USE_BOOST
-            m->openInputFileBinary(thisffastafile, inFFasta, inFF);
-            m->openInputFileBinary(thisrfastafile, inRFasta, inRF);
-            #endif
-        }
+        //plain text files are read from their piece of the file, compressed files are read whole because they divide the workload by file
+        BlockReader* inFFasta = openReader(thisffastafile, linesInput);
+        BlockReader* inRFasta = openReader(thisrfastafile, linesInputReverse);
+        BlockReader* inFQualIndex = NULL; BlockReader* inRQualIndex = NULL;
         
         ofstream outFasta, outMisMatch, outScrapFasta, outQual, outScrapQual;
         if (thisfqualindexfile != "") {
-            if (thisfqualindexfile != "NONE") {
-                if (!gz) { //plain text files
-                    m->openInputFile(thisfqualindexfile, inFQualIndex);
-                    inFQualIndex.seekg(qlinesInput.start);
-                }else {
-                    #ifdef USE_BOOST
-                    m->openInputFileBinary(thisfqualindexfile, inFQualIndex, inFQ);
-                    #endif
-                } //compressed files - no need to seekg because compressed files divide workload differently
-            }
+            if (thisfqualindexfile != "NONE") { inFQualIndex = openReader(thisfqualindexfile, qlinesInput); }
             else {  thisfqualindexfile = ""; }
-            if (thisrqualindexfile != "NONE") {
-                if (!gz) { //plain text files
-                    m->openInputFile(thisrqualindexfile, inRQualIndex);
-                    inRQualIndex.seekg(qlinesInputReverse.start);
-                }else {
-                    #ifdef USE_BOOST
-                    m->openInputFileBinary(thisrqualindexfile, inRQualIndex, inRQ);
-                    #endif
-                } //compressed files - no need to seekg because compressed files divide workload differently
-            }
+            if (thisrqualindexfile != "NONE") { inRQualIndex = openReader(thisrqualindexfile, qlinesInputReverse); }
             else { thisrqualindexfile = ""; }
         }
         
@@ -1922,13 +1898,7 @@ unsigned long long MakeContigsCommand::driver(vector<string> inputFiles, vector<
             Sequence findexBarcode("findex", "NONE");  Sequence rindexBarcode("rindex", "NONE");
             
             //read from input files
-            if (gz) {
-                #ifdef USE_BOOST
-                ignore = read(fSeq, rSeq, fQual, rQual, savedFQual, savedRQual, findexBarcode, rindexBarcode, delim, inFF, inRF, inFQ, inRQ, thisfqualindexfile, thisrqualindexfile);
-                #endif
-            }else    {
-                ignore = read(fSeq, rSeq, fQual, rQual, savedFQual, savedRQual, findexBarcode, rindexBarcode, delim, inFFasta, inRFasta, inFQualIndex, inRQualIndex, thisfqualindexfile, thisrqualindexfile);
-            }
+            ignore = read(fSeq, rSeq, fQual, rQual, savedFQual, savedRQual, findexBarcode, rindexBarcode, delim, inFFasta, inRFasta, inFQualIndex, inRQualIndex, thisfqualindexfile, thisrqualindexfile);
             
             //remove primers and barcodes if neccessary
             if (!ignore) {
@@ -2103,24 +2073,7 @@ unsigned long long MakeContigsCommand::driver(vector<string> inputFiles, vector<
             }
             num++;
             
-            #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-                if (!gz) {
-                    unsigned long long pos = inFFasta.tellg();
-                    if ((pos == -1) || (pos >= linesInput.end)) { good = false; break; }
-                }else {
-                    #ifdef USE_BOOST
-                    if (inFF.eof() || inRF.eof()) { good = false; break; }
-                    #endif
-                }
-            #else
-                if (!gz) {
-                    if ((inFFasta.eof()) || (inRFasta.eof())) { good = false; break; }
-                }else {
-                    #ifdef USE_BOOST
-                    if (inFF.eof() || inRF.eof()) { good = false; break; }
-                    #endif
-                }
-            #endif
+            if (inFFasta->eof() || inRFasta->eof()) { good = false; break; }
             
 			//report progress
             if((num) % 1000 == 0){	m->mothurOutJustToScreen(toString(num)+"\n"); }
@@ -2130,45 +2083,15 @@ unsigned long long MakeContigsCommand::driver(vector<string> inputFiles, vector<
 		if((num) % 1000 != 0){	m->mothurOutJustToScreen(toString(num)+"\n"); }
         
         //close files
-        inFFasta.close();
-        inRFasta.close();
-        if (gz) {
-            #ifdef USE_BOOST
-            inFF.pop(); inRF.pop();
-            #endif
-        }
+        delete inFFasta; delete inRFasta;
+        if (inFQualIndex != NULL) { delete inFQualIndex; }
+        if (inRQualIndex != NULL) { delete inRQualIndex; }
         outFasta.close();
         outScrapFasta.close();
         outMisMatch.close();
-        if (delim == '@') {
-            if (thisfqualindexfile != "") { inFQualIndex.close();
-                if (gz) {
-                    #ifdef USE_BOOST
-                    inFQ.pop();
-                    #endif
-                }
-            }
-            if (thisrqualindexfile != "") { inRQualIndex.close();
-                if (gz) {
-                    #ifdef USE_BOOST
-                    inRQ.pop();
-                    #endif
-                }
-            }
+        if (hasQuality) {
             outQual.close();
             outScrapQual.close();
-        }else{
-            if (hasQuality) {
-                inFQualIndex.close();
-                inRQualIndex.close();
-                if (gz) {
-                    #ifdef USE_BOOST
-                    inFQ.pop(); inRQ.pop();
-                    #endif
-                }
-                outQual.close();
-                outScrapQual.close();
-            }
         }
         
         //cleanup memory
@@ -2188,6 +2111,23 @@ unsigned long long MakeContigsCommand::driver(vector<string> inputFiles, vector<
 	}
 }
 /**************************************************************************************************/
+BlockReader* MakeContigsCommand::openReader(string filename, linePair lines) {
+    try {
+        if (gz) { return new BlockReader(filename, gzThreads); }
+        
+        #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+            return new BlockReader(filename, lines.start, lines.end);
+        #else
+            //windows pieces hold a number of reads, so read to the end of the file
+            return new BlockReader(filename, lines.start, numeric_limits<unsigned long long>::max());
+        #endif
+    }
+    catch(exception& e) {
+        m->errorOut(e, "MakeContigsCommand", "openReader");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
 //vector<int> contigScores = assembleFragments(qual_match_simple_bayesian, qual_mismatch_simple_bayesian, fSeq, rSeq, alignment, contig);
 vector<int> MakeContigsCommand::assembleFragments(vector< vector<double> >&qual_match_simple_bayesian, vector< vector<double> >& qual_mismatch_simple_bayesian, Sequence& fSeq, Sequence& rSeq, QualityScores*& fQual, QualityScores*& rQual, QualityScores*& savedFQual, QualityScores*& savedRQual, bool hasQuality, Alignment*& alignment, string& contig, string& trashCode, int& oend, int& oStart, int& numMismatches) {
     try {
@@ -2324,20 +2264,18 @@ vector<int> MakeContigsCommand::assembleFragments(vector< vector<double> >&qual_
     }
 }
 /**************************************************************************************************/
-#ifdef USE_BOOST
-//ignore = read(fSeq, rSeq, fQual, rQual, savedFQual, savedRQual, findexBarcode, rindexBarcode, delim,  inFF, inRF, inFQ, inRQ);
-bool MakeContigsCommand::read(Sequence& fSeq, Sequence& rSeq, QualityScores*& fQual, QualityScores*& rQual, QualityScores*& savedFQual, QualityScores*& savedRQual, Sequence& findexBarcode, Sequence& rindexBarcode, char delim, boost::iostreams::filtering_istream& inFF, boost::iostreams::filtering_istream& inRF, boost::iostreams::filtering_istream& inFQ, boost::iostreams::filtering_istream& inRQ, string thisfqualindexfile, string thisrqualindexfile) {
+bool MakeContigsCommand::read(Sequence& fSeq, Sequence& rSeq, QualityScores*& fQual, QualityScores*& rQual, QualityScores*& savedFQual, QualityScores*& savedRQual, Sequence& findexBarcode, Sequence& rindexBarcode, char delim, BlockReader* inFFasta, BlockReader* inRFasta, BlockReader* inFQualIndex, BlockReader* inRQualIndex, string thisfqualindexfile, string thisrqualindexfile) {
     try {
         bool ignore = false;
         
         if (delim == '@') { //fastq files
             bool tignore;
-            FastqRead fread(inFF, tignore, format);
-            FastqRead rread(inRF, ignore, format);
+            FastqRead fread(*inFFasta, tignore, format);
+            FastqRead rread(*inRFasta, ignore, format);
             if (!checkName(fread, rread)) {
-                FastqRead f2read(inFF, tignore, format);
+                FastqRead f2read(*inFFasta, tignore, format);
                 if (!checkName(f2read, rread)) {
-                    FastqRead r2read(inRF, ignore, format);
+                    FastqRead r2read(*inRFasta, ignore, format);
                     if (!checkName(fread, r2read)) {
                         m->mothurOut("[WARNING]: name mismatch in forward and reverse fastq file. Ignoring, " + fread.getName() + ".\n"); ignore = true;
                     }else { rread = r2read; }
@@ -2351,11 +2289,11 @@ bool MakeContigsCommand::read(Sequence& fSeq, Sequence& rSeq, QualityScores*& fQ
             savedFQual = new QualityScores(fQual->getName(), fQual->getQualityScores());
             savedRQual = new QualityScores(rQual->getName(), rQual->getQualityScores());
             if (thisfqualindexfile != "") { //forward index file
-                FastqRead firead(inFQ, tignore, format);
+                FastqRead firead(*inFQualIndex, tignore, format);
                 if (tignore) { ignore=true; }
                 findexBarcode.setAligned(firead.getSeq());
                 if (!checkName(fread, firead)) {
-                    FastqRead f2iread(inFQ, tignore, format);
+                    FastqRead f2iread(*inFQualIndex, tignore, format);
                     if (tignore) { ignore=true; }
                     if (!checkName(fread, f2iread)) {
                         m->mothurOut("[WARNING]: name mismatch in forward index file. Ignoring, " + fread.getName() + ".\n"); ignore = true;
@@ -2363,11 +2301,11 @@ bool MakeContigsCommand::read(Sequence& fSeq, Sequence& rSeq, QualityScores*& fQ
                 }
             }
             if (thisrqualindexfile != "") { //reverse index file
-                FastqRead riread(inRQ, tignore, format);
+                FastqRead riread(*inRQualIndex, tignore, format);
                 if (tignore) { ignore=true; }
                 rindexBarcode.setAligned(riread.getSeq());
                 if (!checkName(fread, riread)) {
-                    FastqRead r2iread(inRQ, tignore, format); m->gobble(inRQ);
+                    FastqRead r2iread(*inRQualIndex, tignore, format);
                     if (tignore) { ignore=true; }
                     if (!checkName(fread, r2iread)) {
                         m->mothurOut("[WARNING]: name mismatch in reverse index file. Ignoring, " + fread.getName() + ".\n"); ignore = true;
@@ -2375,12 +2313,12 @@ bool MakeContigsCommand::read(Sequence& fSeq, Sequence& rSeq, QualityScores*& fQ
                 }
             }
         }else { //reading fasta and maybe qual
-            Sequence tfSeq(inFF);
-            Sequence trSeq(inRF);
+            Sequence tfSeq(*inFFasta);
+            Sequence trSeq(*inRFasta);
             if (!checkName(tfSeq, trSeq)) {
-                Sequence t2fSeq(inFF);
+                Sequence t2fSeq(*inFFasta);
                 if (!checkName(t2fSeq, trSeq)) {
-                    Sequence t2rSeq(inRF);
+                    Sequence t2rSeq(*inRFasta);
                     if (!checkName(tfSeq, t2rSeq)) {
                         m->mothurOut("[WARNING]: name mismatch in forward and reverse fasta file. Ignoring, " + tfSeq.getName() + ".\n"); ignore = true;
                     }else { trSeq = t2fSeq; }
@@ -2389,95 +2327,8 @@ bool MakeContigsCommand::read(Sequence& fSeq, Sequence& rSeq, QualityScores*& fQ
             fSeq.setName(tfSeq.getName()); fSeq.setAligned(tfSeq.getAligned());
             rSeq.setName(trSeq.getName()); rSeq.setAligned(trSeq.getAligned());
             if (thisfqualindexfile != "") {
-                fQual = new QualityScores(inFQ); m->gobble(inFQ);
-                rQual = new QualityScores(inRQ); m->gobble(inRQ);
-                if (!checkName(*fQual, *rQual)) {
-                    m->mothurOut("[WARNING]: name mismatch in forward and reverse qual file. Ignoring, " + fQual->getName() + ".\n"); ignore = true;
-                }
-                savedFQual = new QualityScores(fQual->getName(), fQual->getQualityScores());
-                savedRQual = new QualityScores(rQual->getName(), rQual->getQualityScores());
-                if (fQual->getName() != tfSeq.getName()) { m->mothurOut("[WARNING]: name mismatch in forward quality file. Ignoring, " + tfSeq.getName() + ".\n"); ignore = true; }
-                if (rQual->getName() != trSeq.getName()) { m->mothurOut("[WARNING]: name mismatch in reverse quality file. Ignoring, " + trSeq.getName() + ".\n"); ignore = true; }
-            }
-            if (tfSeq.getName() != trSeq.getName()) { m->mothurOut("[WARNING]: name mismatch in forward and reverse fasta file. Ignoring, " + tfSeq.getName() + ".\n"); ignore = true; }
-        }
-
-        return ignore;
-        
-    }
-    catch(exception& e) {
-        m->errorOut(e, "MakeContigsCommand", "read");
-        exit(1);
-    }
-}
-#endif
-/**************************************************************************************************/
-
-bool MakeContigsCommand::read(Sequence& fSeq, Sequence& rSeq, QualityScores*& fQual, QualityScores*& rQual, QualityScores*& savedFQual, QualityScores*& savedRQual, Sequence& findexBarcode, Sequence& rindexBarcode, char delim, ifstream& inFFasta, ifstream& inRFasta, ifstream& inFQualIndex, ifstream& inRQualIndex, string thisfqualindexfile, string thisrqualindexfile) {
-    try {
-        bool ignore = false;
-        
-        if (delim == '@') { //fastq files
-            bool tignore;
-            FastqRead fread(inFFasta, tignore, format); m->gobble(inFFasta);
-            FastqRead rread(inRFasta, ignore, format); m->gobble(inRFasta);
-            if (!checkName(fread, rread)) {
-                FastqRead f2read(inFFasta, tignore, format); m->gobble(inFFasta);
-                if (!checkName(f2read, rread)) {
-                    FastqRead r2read(inRFasta, ignore, format); m->gobble(inRFasta);
-                    if (!checkName(fread, r2read)) {
-                        m->mothurOut("[WARNING]: name mismatch in forward and reverse fastq file. Ignoring, " + fread.getName() + ".\n"); ignore = true;
-                    }else { rread = r2read; }
-                }else { fread = f2read; }
-            }
-            if (tignore) { ignore=true; }
-            fSeq.setName(fread.getName()); fSeq.setAligned(fread.getSeq());
-            rSeq.setName(rread.getName()); rSeq.setAligned(rread.getSeq());
-            fQual = new QualityScores(fread.getName(), fread.getScores());
-            rQual = new QualityScores(rread.getName(), rread.getScores());
-            savedFQual = new QualityScores(fQual->getName(), fQual->getQualityScores());
-            savedRQual = new QualityScores(rQual->getName(), rQual->getQualityScores());
-            if (thisfqualindexfile != "") { //forward index file
-                FastqRead firead(inFQualIndex, tignore, format); m->gobble(inFQualIndex);
-                if (tignore) { ignore=true; }
-                findexBarcode.setAligned(firead.getSeq());
-                if (!checkName(fread, firead)) {
-                    FastqRead f2iread(inFQualIndex, tignore, format); m->gobble(inFQualIndex);
-                    if (tignore) { ignore=true; }
-                    if (!checkName(fread, f2iread)) {
-                        m->mothurOut("[WARNING]: name mismatch in forward index file. Ignoring, " + fread.getName() + ".\n"); ignore = true;
-                    }else { firead = f2iread; findexBarcode.setAligned(firead.getSeq()); }
-                }
-            }
-            if (thisrqualindexfile != "") { //reverse index file
-                FastqRead riread(inRQualIndex, tignore, format); m->gobble(inRQualIndex);
-                if (tignore) { ignore=true; }
-                rindexBarcode.setAligned(riread.getSeq());
-                if (!checkName(fread, riread)) {
-                    FastqRead r2iread(inRQualIndex, tignore, format); m->gobble(inRQualIndex);
-                    if (tignore) { ignore=true; }
-                    if (!checkName(fread, r2iread)) {
-                        m->mothurOut("[WARNING]: name mismatch in reverse index file. Ignoring, " + fread.getName() + ".\n"); ignore = true;
-                    }else { riread = r2iread; rindexBarcode.setAligned(riread.getSeq()); }
-                }
-            }
-        }else { //reading fasta and maybe qual
-            Sequence tfSeq(inFFasta); m->gobble(inFFasta);
-            Sequence trSeq(inRFasta); m->gobble(inRFasta);
-            if (!checkName(tfSeq, trSeq)) {
-                Sequence t2fSeq(inFFasta); m->gobble(inFFasta);
-                if (!checkName(t2fSeq, trSeq)) {
-                    Sequence t2rSeq(inRFasta); m->gobble(inRFasta);
-                    if (!checkName(tfSeq, t2rSeq)) {
-                        m->mothurOut("[WARNING]: name mismatch in forward and reverse fasta file. Ignoring, " + tfSeq.getName() + ".\n"); ignore = true;
-                    }else { trSeq = t2fSeq; }
-                }else { tfSeq = t2fSeq; }
-            }
-            fSeq.setName(tfSeq.getName()); fSeq.setAligned(tfSeq.getAligned());
-            rSeq.setName(trSeq.getName()); rSeq.setAligned(trSeq.getAligned());
-            if (thisfqualindexfile != "") {
-                fQual = new QualityScores(inFQualIndex); m->gobble(inFQualIndex);
-                rQual = new QualityScores(inRQualIndex); m->gobble(inRQualIndex);
+                fQual = new QualityScores(*inFQualIndex);
+                rQual = new QualityScores(*inRQualIndex);
                 if (!checkName(*fQual, *rQual)) {
                     m->mothurOut("[WARNING]: name mismatch in forward and reverse qual file. Ignoring, " + fQual->getName() + ".\n"); ignore = true;
                 }
@@ -2574,42 +2425,19 @@ int MakeContigsCommand::setNameType(string forwardFile, string reverseFile, char
         int type = 0; bool error = false;
         string forward = ""; string reverse = "";
         
-        ifstream inForward, inReverse;
-#ifdef USE_BOOST
-        boost::iostreams::filtering_istream inFF, inRF;
-#endif
-        if (!gz) { //plain text files
-            m->openInputFile(forwardFile, inForward);
-            m->openInputFile(reverseFile, inReverse);
-            
-            if (delim == '>') {
-                Sequence fread(inForward);
-                forward = fread.getName();
-                Sequence rread(inReverse);
-                reverse = rread.getName();
-            }else {
-                FastqRead fread(inForward, error, format);
-                forward = fread.getName();
-                FastqRead rread(inReverse, error, format);
-                reverse = rread.getName();
-            }
-        }else { //compressed files
-#ifdef USE_BOOST
-            m->openInputFileBinary(forwardFile, inForward, inFF);
-            m->openInputFileBinary(reverseFile, inReverse, inRF);
-            
-            if (delim == '>') {
-                Sequence fread(inFF);
-                forward = fread.getName();
-                Sequence rread(inRF);
-                reverse = rread.getName();
-            }else {
-                FastqRead fread(inFF, error, format);
-                forward = fread.getName();
-                FastqRead rread(inRF, error, format);
-                reverse = rread.getName();
-            }
-#endif
+        BlockReader inForward(forwardFile, 1);
+        BlockReader inReverse(reverseFile, 1);
+        
+        if (delim == '>') {
+            Sequence fread(inForward);
+            forward = fread.getName();
+            Sequence rread(inReverse);
+            reverse = rread.getName();
+        }else {
+            FastqRead fread(inForward, error, format);
+            forward = fread.getName();
+            FastqRead rread(inReverse, error, format);
+            reverse = rread.getName();
         }
         
         type = setNameType(forward, reverse);
@@ -2633,6 +2461,14 @@ int MakeContigsCommand::setLines(vector<string> fasta, vector<string> qual, vect
         
         nameType = setNameType(fasta[0], fasta[1], delim);
         
+        //compressed files cannot be divided, so one process reads them while the processors decompress
+        if (gz) {
+            processors = 1;
+            lines.push_back(linePair(0, 0)); lines.push_back(linePair(0, 0));
+            qLines.push_back(linePair(0, 0)); qLines.push_back(linePair(0, 0));
+            return processors;
+        }
+        
 #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
         //set file positions for fasta file
         fastaFilePos = m->divideFile(fasta[0], processors, delim);
@@ -199,96 +199,14 @@ MatrixOutputCommand::MatrixOutputCommand(string option)  {
             
 			if (abort == false) {
 			
+				//keep the valid calculators, each thread makes its own set from them
 				ValidCalculators validCalculator;
-				
-				int i;
-				for (i=0; i<Estimators.size(); i++) {
-					if (validCalculator.isValidCalculator("matrix", Estimators[i]) == true) { 
-						if (Estimators[i] == "sharedsobs") { 
-							matrixCalculators.push_back(new SharedSobsCS());
-						}else if (Estimators[i] == "sharedchao") { 
-							matrixCalculators.push_back(new SharedChao1());
-						}else if (Estimators[i] == "sharedace") { 
-							matrixCalculators.push_back(new SharedAce());
-						}else if (Estimators[i] == "jabund") { 	
-							matrixCalculators.push_back(new JAbund());
-						}else if (Estimators[i] == "sorabund") { 
-							matrixCalculators.push_back(new SorAbund());
-						}else if (Estimators[i] == "jclass") { 
-							matrixCalculators.push_back(new Jclass());
-						}else if (Estimators[i] == "sorclass") { 
-							matrixCalculators.push_back(new SorClass());
-						}else if (Estimators[i] == "jest") { 
-							matrixCalculators.push_back(new Jest());
-						}else if (Estimators[i] == "sorest") { 
-							matrixCalculators.push_back(new SorEst());
-						}else if (Estimators[i] == "thetayc") { 
-							matrixCalculators.push_back(new ThetaYC());
-						}else if (Estimators[i] == "thetan") { 
-							matrixCalculators.push_back(new ThetaN());
-						}else if (Estimators[i] == "kstest") { 
-							matrixCalculators.push_back(new KSTest());
-						}else if (Estimators[i] == "sharednseqs") { 
-							matrixCalculators.push_back(new SharedNSeqs());
-						}else if (Estimators[i] == "ochiai") { 
-							matrixCalculators.push_back(new Ochiai());
-						}else if (Estimators[i] == "anderberg") { 
-							matrixCalculators.push_back(new Anderberg());
-						}else if (Estimators[i] == "kulczynski") { 
-							matrixCalculators.push_back(new Kulczynski());
-						}else if (Estimators[i] == "kulczynskicody") { 
-							matrixCalculators.push_back(new KulczynskiCody());
-						}else if (Estimators[i] == "lennon") { 
-							matrixCalculators.push_back(new Lennon());
-						}else if (Estimators[i] == "morisitahorn") { 
-							matrixCalculators.push_back(new MorHorn());
-						}else if (Estimators[i] == "braycurtis") { 
-							matrixCalculators.push_back(new BrayCurtis());
-						}else if (Estimators[i] == "whittaker") { 
-							matrixCalculators.push_back(new Whittaker());
-						}else if (Estimators[i] == "odum") { 
-							matrixCalculators.push_back(new Odum());
-						}else if (Estimators[i] == "canberra") { 
-							matrixCalculators.push_back(new Canberra());
-						}else if (Estimators[i] == "structeuclidean") { 
-							matrixCalculators.push_back(new StructEuclidean());
-						}else if (Estimators[i] == "structchord") { 
-							matrixCalculators.push_back(new StructChord());
-						}else if (Estimators[i] == "hellinger") { 
-							matrixCalculators.push_back(new Hellinger());
-						}else if (Estimators[i] == "manhattan") { 
-							matrixCalculators.push_back(new Manhattan());
-						}else if (Estimators[i] == "structpearson") { 
-							matrixCalculators.push_back(new StructPearson());
-						}else if (Estimators[i] == "soergel") { 
-							matrixCalculators.push_back(new Soergel());
-						}else if (Estimators[i] == "spearman") { 
-							matrixCalculators.push_back(new Spearman());
-						}else if (Estimators[i] == "structkulczynski") { 
-							matrixCalculators.push_back(new StructKulczynski());
-						}else if (Estimators[i] == "speciesprofile") { 
-							matrixCalculators.push_back(new SpeciesProfile());
-						}else if (Estimators[i] == "hamming") { 
-							matrixCalculators.push_back(new Hamming());
-						}else if (Estimators[i] == "structchi2") { 
-							matrixCalculators.push_back(new StructChi2());
-						}else if (Estimators[i] == "gower") { 
-							matrixCalculators.push_back(new Gower());
-						}else if (Estimators[i] == "memchi2") { 
-							matrixCalculators.push_back(new MemChi2());
-						}else if (Estimators[i] == "memchord") { 
-							matrixCalculators.push_back(new MemChord());
-						}else if (Estimators[i] == "memeuclidean") { 
-							matrixCalculators.push_back(new MemEuclidean());
-						}else if (Estimators[i] == "mempearson") { 
-							matrixCalculators.push_back(new MemPearson());
-                        }else if (Estimators[i] == "jsd") {
-                                matrixCalculators.push_back(new JSD());
-                        }else if (Estimators[i] == "rjsd") {
-                            matrixCalculators.push_back(new RJSD());
-						}
-					}
+				vector<string> validEstimators;
+				for (int i=0; i<Estimators.size(); i++) {
+					if (validCalculator.isValidCalculator("matrix", Estimators[i]) == true) { validEstimators.push_back(Estimators[i]); }
 				}
+				Estimators = validEstimators;
+				matrixCalculators = createCalculators();
 				
 			}
 		}
@@ -300,6 +218,102 @@ MatrixOutputCommand::MatrixOutputCommand(string option)  {
 	}
 }
 
+//**********************************************************************************************************************
+vector<Calculator*> MatrixOutputCommand::createCalculators(){
+	try {
+		vector<Calculator*> calcs;
+		for (int i=0; i<Estimators.size(); i++) {
+			if (Estimators[i] == "sharedsobs") { 
+				calcs.push_back(new SharedSobsCS());
+			}else if (Estimators[i] == "sharedchao") { 
+				calcs.push_back(new SharedChao1());
+			}else if (Estimators[i] == "sharedace") { 
+				calcs.push_back(new SharedAce());
+			}else if (Estimators[i] == "jabund") { 	
+				calcs.push_back(new JAbund());
+			}else if (Estimators[i] == "sorabund") { 
+				calcs.push_back(new SorAbund());
+			}else if (Estimators[i] == "jclass") { 
+				calcs.push_back(new Jclass());
+			}else if (Estimators[i] == "sorclass") { 
+				calcs.push_back(new SorClass());
+			}else if (Estimators[i] == "jest") { 
+				calcs.push_back(new Jest());
+			}else if (Estimators[i] == "sorest") { 
+				calcs.push_back(new SorEst());
+			}else if (Estimators[i] == "thetayc") { 
+				calcs.push_back(new ThetaYC());
+			}else if (Estimators[i] == "thetan") { 
+				calcs.push_back(new ThetaN());
+			}else if (Estimators[i] == "kstest") { 
+				calcs.push_back(new KSTest());
+			}else if (Estimators[i] == "sharednseqs") { 
+				calcs.push_back(new SharedNSeqs());
+			}else if (Estimators[i] == "ochiai") { 
+				calcs.push_back(new Ochiai());
+			}else if (Estimators[i] == "anderberg") { 
+				calcs.push_back(new Anderberg());
+			}else if (Estimators[i] == "kulczynski") { 
+				calcs.push_back(new Kulczynski());
+			}else if (Estimators[i] == "kulczynskicody") { 
+				calcs.push_back(new KulczynskiCody());
+			}else if (Estimators[i] == "lennon") { 
+				calcs.push_back(new Lennon());
+			}else if (Estimators[i] == "morisitahorn") { 
+				calcs.push_back(new MorHorn());
+			}else if (Estimators[i] == "braycurtis") { 
+				calcs.push_back(new BrayCurtis());
+			}else if (Estimators[i] == "whittaker") { 
+				calcs.push_back(new Whittaker());
+			}else if (Estimators[i] == "odum") { 
+				calcs.push_back(new Odum());
+			}else if (Estimators[i] == "canberra") { 
+				calcs.push_back(new Canberra());
+			}else if (Estimators[i] == "structeuclidean") { 
+				calcs.push_back(new StructEuclidean());
+			}else if (Estimators[i] == "structchord") { 
+				calcs.push_back(new StructChord());
+			}else if (Estimators[i] == "hellinger") { 
+				calcs.push_back(new Hellinger());
+			}else if (Estimators[i] == "manhattan") { 
+				calcs.push_back(new Manhattan());
+			}else if (Estimators[i] == "structpearson") { 
+				calcs.push_back(new StructPearson());
+			}else if (Estimators[i] == "soergel") { 
+				calcs.push_back(new Soergel());
+			}else if (Estimators[i] == "spearman") { 
+				calcs.push_back(new Spearman());
+			}else if (Estimators[i] == "structkulczynski") { 
+				calcs.push_back(new StructKulczynski());
+			}else if (Estimators[i] == "speciesprofile") { 
+				calcs.push_back(new SpeciesProfile());
+			}else if (Estimators[i] == "hamming") { 
+				calcs.push_back(new Hamming());
+			}else if (Estimators[i] == "structchi2") { 
+				calcs.push_back(new StructChi2());
+			}else if (Estimators[i] == "gower") { 
+				calcs.push_back(new Gower());
+			}else if (Estimators[i] == "memchi2") { 
+				calcs.push_back(new MemChi2());
+			}else if (Estimators[i] == "memchord") { 
+				calcs.push_back(new MemChord());
+			}else if (Estimators[i] == "memeuclidean") { 
+				calcs.push_back(new MemEuclidean());
+			}else if (Estimators[i] == "mempearson") { 
+				calcs.push_back(new MemPearson());
+			}else if (Estimators[i] == "jsd") {
+				calcs.push_back(new JSD());
+			}else if (Estimators[i] == "rjsd") {
+				calcs.push_back(new RJSD());
+			}
+		}
+		return calcs;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "MatrixOutputCommand", "createCalculators");
+		exit(1);
+	}
+}
 //**********************************************************************************************************************
 
 MatrixOutputCommand::~MatrixOutputCommand(){}
@@ -489,278 +503,111 @@ void MatrixOutputCommand::printSims(ostream& out, vector< vector<double> >& simM
 /***********************************************************/
 int MatrixOutputCommand::process(vector<SharedRAbundVector*> thisLookup){
 	try {
-		vector< vector< vector<seqDist> > > calcDistsTotals;  //each iter, one for each calc, then each groupCombos dists. this will be used to make .dist files
-        vector< vector<seqDist>  > calcDists; calcDists.resize(matrixCalculators.size()); 		
-                  
+        //the whole dataset is split into the blocks of rows, each subsampled iteration is one item unless there are fewer iterations than processors
+        vector<linePair> blocks;
+        for (int i = 0; i < lines.size(); i++) { if (lines[i].start != lines[i].end) { blocks.push_back(lines[i]); } }
+        
+        int blocksPerIter = 1;
+        if (iters < processors) { blocksPerIter = blocks.size(); }
+        
+        int seed = 0;
+        if (subsample) { seed = m->getRandomNumber(); }
+        
+        distSharedData data(thisLookup, blocksPerIter, seed);
+        
+        for (int i = 0; i < blocks.size(); i++) { data.items.push_back(iterBlock(0, blocks[i].start, blocks[i].end)); }
+        for (int thisIter = 1; thisIter < iters+1; thisIter++) {
+            if (blocksPerIter == 1) { data.items.push_back(iterBlock(thisIter, 0, numGroups)); }
+            else { for (int i = 0; i < blocks.size(); i++) { data.items.push_back(iterBlock(thisIter, blocks[i].start, blocks[i].end)); } }
+        }
+        
+        int numPairs = (numGroups * (numGroups-1)) / 2;
+        data.calcDistsTotals.resize(iters+1);
         for (int thisIter = 0; thisIter < iters+1; thisIter++) {
-            map<string, string> variables; 
-            variables["[filename]"] = outputDir + m->getRootName(m->getSimpleName(sharedfile));
-            variables["[distance]"] = thisLookup[0]->getLabel();
-            variables["[tag2]"] = "";
-            
-            vector<SharedRAbundVector*> thisItersLookup = thisLookup;
-            
-            if (subsample && (thisIter != 0)) {
-                SubSample sample;
-                vector<string> tempLabels; //dont need since we arent printing the sampled sharedRabunds
-                
-                //make copy of lookup so we don't get access violations
-                vector<SharedRAbundVector*> newLookup;
-                for (int k = 0; k < thisItersLookup.size(); k++) {
-                    SharedRAbundVector* temp = new SharedRAbundVector();
-                    temp->setLabel(thisItersLookup[k]->getLabel());
-                    temp->setGroup(thisItersLookup[k]->getGroup());
-                    newLookup.push_back(temp);
+            data.calcDistsTotals[thisIter].resize(matrixCalculators.size());
+            for (int i = 0; i < matrixCalculators.size(); i++) {
+                data.calcDistsTotals[thisIter][i].resize(numPairs);
+                for (int k = 0; k < numGroups; k++) {
+                    for (int l = 0; l < k; l++) { data.calcDistsTotals[thisIter][i][(k*(k-1))/2+l] = seqDist(l, k, 0.0); }
                 }
-                
-                //for each bin
-                for (int k = 0; k < thisItersLookup[0]->getNumBins(); k++) {
-                    if (m->control_pressed) { for (int j = 0; j < newLookup.size(); j++) {  delete newLookup[j];  } return 0; }
-                    for (int j = 0; j < thisItersLookup.size(); j++) { newLookup[j]->push_back(thisItersLookup[j]->getAbundance(k), thisItersLookup[j]->getGroup()); }
-                }
-                
-                tempLabels = sample.getSample(newLookup, subsampleSize);
-                thisItersLookup = newLookup;
             }
+        }
         
-            if(processors == 1){
-                driver(thisItersLookup, 0, numGroups, calcDists);
-            }else{
-                int process = 1;
-                vector<int> processIDS;
-                bool recalc = false;
-                
-                #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-                //loop through and create all the processes you want
-                while (process != processors) {
-                    pid_t pid = fork();
-                    
-                    if (pid > 0) {
-                        processIDS.push_back(pid); 
-                        process++;
-                    }else if (pid == 0){
-                        
-                        driver(thisItersLookup, lines[process].start, lines[process].end, calcDists);   
-                        
-                        string tempdistFileName = m->getRootName(m->getSimpleName(sharedfile)) + m->mothurGetpid(process) + ".dist";
-                        ofstream outtemp;
-                        m->openOutputFile(tempdistFileName, outtemp);
-                            
-                        for (int i = 0; i < calcDists.size(); i++) {
-                            outtemp << calcDists[i].size() << endl;
-                                
-                            for (int j = 0; j < calcDists[i].size(); j++) {
-                                outtemp << calcDists[i][j].seq1 << '\t' << calcDists[i][j].seq2 << '\t' << calcDists[i][j].dist << endl;
-                            }
-                        }
-                        outtemp.close();
-                                        
-                        exit(0);
-                    }else { 
-                        m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(process) + "\n"); processors = process;
-                        for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-                        //wait to die
-                        for (int i=0;i<processIDS.size();i++) {
-                            int temp = processIDS[i];
-                            wait(&temp);
-                        }
-                        m->control_pressed = false;
-                        for (int i=0;i<processIDS.size();i++) {
-                            m->mothurRemove(m->getRootName(m->getSimpleName(sharedfile)) + m->mothurGetpid(process) + ".dist");
-                        }
-                        recalc = true;
-                        break;
-                    }
-                }
-                
-                if (recalc) {
-                    //test line, also set recalc to true.
-                    //for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); } for (int i=0;i<processIDS.size();i++) { int temp = processIDS[i]; wait(&temp); } m->control_pressed = false;  for (int i=0;i<processIDS.size();i++) {m->mothurRemove(m->getRootName(m->getSimpleName(sharedfile)) + m->mothurGetpid(process) + ".dist");}processors=3; m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(processors) + "\n");
-                    
-                    
-                    lines.clear();
-                    lines.resize(processors);
-                    for (int i = 0; i < processors; i++) {
-                        lines[i].start = int (sqrt(float(i)/float(processors)) * numGroups);
-                        lines[i].end = int (sqrt(float(i+1)/float(processors)) * numGroups);
-                    }
-                    
-                    processIDS.resize(0);
-                    process = 1;
-                    
-                    //loop through and create all the processes you want
-                    while (process != processors) {
-                        pid_t pid = fork();
-                        
-                        if (pid > 0) {
-                            processIDS.push_back(pid);
-                            process++;
-                        }else if (pid == 0){
-                            
-                            driver(thisItersLookup, lines[process].start, lines[process].end, calcDists);
-                            
-                            string tempdistFileName = m->getRootName(m->getSimpleName(sharedfile)) + m->mothurGetpid(process) + ".dist";
-                            ofstream outtemp;
-                            m->openOutputFile(tempdistFileName, outtemp);
-                            
-                            for (int i = 0; i < calcDists.size(); i++) {
-                                outtemp << calcDists[i].size() << endl;
-                                
-                                for (int j = 0; j < calcDists[i].size(); j++) {
-                                    outtemp << calcDists[i][j].seq1 << '\t' << calcDists[i][j].seq2 << '\t' << calcDists[i][j].dist << endl;
-                                }
-                            }
-                            outtemp.close();
-                            
-                            exit(0);
-                        }else {
-                            m->mothurOut("[ERROR]: unable to spawn the necessary processes."); m->mothurOutEndLine();
-                            for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-                            exit(0);
-                        }
-                    }
-                }
-
-                
-                //parent do your part
-                driver(thisItersLookup, lines[0].start, lines[0].end, calcDists);   
-                            
-                //force parent to wait until all the processes are done
-                for (int i = 0; i < processIDS.size(); i++) {
-                    int temp = processIDS[i];
-                    wait(&temp);
-                }
-                
-                for (int i = 0; i < processIDS.size(); i++) {
-                    string tempdistFileName = m->getRootName(m->getSimpleName(sharedfile)) + toString(processIDS[i]) +  ".dist";
-                    ifstream intemp;
-                    m->openInputFile(tempdistFileName, intemp);
-                        
-                    for (int k = 0; k < calcDists.size(); k++) {
-                        int size = 0;
-                        intemp >> size; m->gobble(intemp);
-                            
-                        for (int j = 0; j < size; j++) {
-                            int seq1 = 0;
-                            int seq2 = 0;
-                            float dist = 1.0;
-                                
-                            intemp >> seq1 >> seq2 >> dist;   m->gobble(intemp);
-                                
-                            seqDist tempDist(seq1, seq2, dist);
-                            calcDists[k].push_back(tempDist);
-                        }
-                    }
-                    intemp.close();
-                    m->mothurRemove(tempdistFileName);
-                }
-                #else
-                //////////////////////////////////////////////////////////////////////////////////////////////////////
-                //Windows version shared memory, so be careful when passing variables through the distSharedData struct. 
-                //Above fork() will clone, so memory is separate, but that's not the case with windows, 
-                //Taking advantage of shared memory to pass results vectors.
-                //////////////////////////////////////////////////////////////////////////////////////////////////////
-                
-                vector<distSharedData*> pDataArray; 
-                DWORD   dwThreadIdArray[processors-1];
-                HANDLE  hThreadArray[processors-1]; 
-                
-                //Create processor worker threads.
-                for( int i=1; i<processors; i++ ){
-                    
-                    //make copy of lookup so we don't get access violations
-                    vector<SharedRAbundVector*> newLookup;
-                    for (int k = 0; k < thisItersLookup.size(); k++) {
-                        SharedRAbundVector* temp = new SharedRAbundVector();
-                        temp->setLabel(thisItersLookup[k]->getLabel());
-                        temp->setGroup(thisItersLookup[k]->getGroup());
-                        newLookup.push_back(temp);
-                    }
-                    
-                    //for each bin
-                    for (int k = 0; k < thisItersLookup[0]->getNumBins(); k++) {
-                        if (m->control_pressed) { for (int j = 0; j < newLookup.size(); j++) {  delete newLookup[j];  } return 0; }
-                        for (int j = 0; j < thisItersLookup.size(); j++) { newLookup[j]->push_back(thisItersLookup[j]->getAbundance(k), thisItersLookup[j]->getGroup()); }
-                    }
-                    
-                    // Allocate memory for thread data.
-                    distSharedData* tempSum = new distSharedData(m, lines[i].start, lines[i].end, Estimators, newLookup);
-                    pDataArray.push_back(tempSum);
-                    processIDS.push_back(i);
-                    
-                    hThreadArray[i-1] = CreateThread(NULL, 0, MyDistSharedThreadFunction, pDataArray[i-1], 0, &dwThreadIdArray[i-1]);   
-                }
-                
-                //parent do your part
-                driver(thisItersLookup, lines[0].start, lines[0].end, calcDists);   
-                           
-                //Wait until all threads have terminated.
-                WaitForMultipleObjects(processors-1, hThreadArray, TRUE, INFINITE);
-                
-                //Close all thread handles and free memory allocations.
-                for(int i=0; i < pDataArray.size(); i++){
-                    if (pDataArray[i]->count != (pDataArray[i]->end-pDataArray[i]->start)) {
-                        m->mothurOut("[ERROR]: process " + toString(i) + " only processed " + toString(pDataArray[i]->count) + " of " + toString(pDataArray[i]->end-pDataArray[i]->start) + " groups assigned to it, quitting. \n"); m->control_pressed = true; 
-                    }
-                    for (int j = 0; j < pDataArray[i]->thisLookup.size(); j++) {  delete pDataArray[i]->thisLookup[j];  } 
-                    
-                    for (int k = 0; k < calcDists.size(); k++) {
-                        int size = pDataArray[i]->calcDists[k].size();
-                        for (int j = 0; j < size; j++) {    calcDists[k].push_back(pDataArray[i]->calcDists[k][j]);    }
+        int numThreads = processors;
+        if (numThreads > data.items.size()) { numThreads = data.items.size(); }
+        
+        //each thread needs its own calculators
+        vector< vector<Calculator*> > threadCalcs;
+        for (int i = 1; i < numThreads; i++) { threadCalcs.push_back(createCalculators()); }
+        
+        vector<thread*> workerThreads;
+        for (int i = 1; i < numThreads; i++) {
+            workerThreads.push_back(new thread(&MatrixOutputCommand::iterThread, this, &data, &threadCalcs[i-1]));
+        }
+        
+        //parent do your part
+        iterThread(&data, &matrixCalculators);
+        
+        for (int i = 0; i < workerThreads.size(); i++) {
+            workerThreads[i]->join();
+            delete workerThreads[i];
+            for (int j = 0; j < threadCalcs[i].size(); j++) { delete threadCalcs[i][j]; }
+        }
+        
+        if (m->control_pressed) { return 0; }
+        
+        vector< vector< vector<seqDist> > >& calcDistsTotals = data.calcDistsTotals;
+        
+        if (m->debug) {
+            for (int thisIter = 1; thisIter < iters+1; thisIter++) {
+                for (int i = 0; i < calcDistsTotals[thisIter].size(); i++) {
+                    for (int j = 0; j < calcDistsTotals[thisIter][i].size(); j++) {
+                        seqDist& temp = calcDistsTotals[thisIter][i][j];
+                        m->mothurOut("[DEBUG]: Results: iter = " + toString(thisIter) + ", " + thisLookup[temp.seq1]->getGroup() + " - " + thisLookup[temp.seq2]->getGroup() + " distance = " + toString(temp.dist) + ".\n");
                     }
-                    
-                    CloseHandle(hThreadArray[i]);
-                    delete pDataArray[i];
                 }
-
-                #endif
             }
+        }
+        
+        //print results for whole dataset
+        vector< vector<seqDist>  > calcDists = calcDistsTotals[0];
+        calcDistsTotals.erase(calcDistsTotals.begin());
+        
+        map<string, string> variables; 
+        variables["[filename]"] = outputDir + m->getRootName(m->getSimpleName(sharedfile));
+        variables["[distance]"] = thisLookup[0]->getLabel();
+        variables["[tag2]"] = "";
+        
+        for (int i = 0; i < calcDists.size(); i++) {
+            if (m->control_pressed) { break; }
             
-            if (subsample && (thisIter != 0)) {  
-                if((thisIter) % 100 == 0){	m->mothurOutJustToScreen(toString(thisIter)+"\n"); 		}
-                calcDistsTotals.push_back(calcDists);
-                for (int i = 0; i < calcDists.size(); i++) {
-                    for (int j = 0; j < calcDists[i].size(); j++) {
-                        if (m->debug) {  m->mothurOut("[DEBUG]: Results: iter = " + toString(thisIter) + ", " + thisLookup[calcDists[i][j].seq1]->getGroup() + " - " + thisLookup[calcDists[i][j].seq2]->getGroup() + " distance = " + toString(calcDists[i][j].dist) + ".\n");  }
-                    } 
-                }
-                //clean up memory
-                for (int i = 0; i < thisItersLookup.size(); i++) { delete thisItersLookup[i]; }
-                thisItersLookup.clear();
-            }else { //print results for whole dataset
-                for (int i = 0; i < calcDists.size(); i++) {
-                    if (m->control_pressed) { break; }
-                    
-                    //initialize matrix
-                    vector< vector<double> > matrix; //square matrix to represent the distance
-                    matrix.resize(thisLookup.size());
-                    for (int k = 0; k < thisLookup.size(); k++) {  matrix[k].resize(thisLookup.size(), 0.0); }
-                    
-                    for (int j = 0; j < calcDists[i].size(); j++) {
-                        int row = calcDists[i][j].seq1;
-                        int column = calcDists[i][j].seq2;
-                        double dist = calcDists[i][j].dist;
-                        
-                        matrix[row][column] = dist;
-                        matrix[column][row] = dist;
-                    }
-                    
-                    variables["[outputtag]"] = output;
-                    variables["[calc]"] = matrixCalculators[i]->getName();
-                    string distFileName = getOutputFileName("phylip",variables);
-                    outputNames.push_back(distFileName); outputTypes["phylip"].push_back(distFileName);
-                    
-                    ofstream outDist;
-                    m->openOutputFile(distFileName, outDist);
-                    outDist.setf(ios::fixed, ios::floatfield); outDist.setf(ios::showpoint);
-                    
-                    printSims(outDist, matrix);
-                    
-                    outDist.close();
-                }
+            //initialize matrix
+            vector< vector<double> > matrix; //square matrix to represent the distance
+            matrix.resize(thisLookup.size());
+            for (int k = 0; k < thisLookup.size(); k++) {  matrix[k].resize(thisLookup.size(), 0.0); }
+            
+            for (int j = 0; j < calcDists[i].size(); j++) {
+                int row = calcDists[i][j].seq1;
+                int column = calcDists[i][j].seq2;
+                double dist = calcDists[i][j].dist;
+                
+                matrix[row][column] = dist;
+                matrix[column][row] = dist;
             }
-            for (int i = 0; i < calcDists.size(); i++) {  calcDists[i].clear(); }
-		}
+            
+            variables["[outputtag]"] = output;
+            variables["[calc]"] = matrixCalculators[i]->getName();
+            string distFileName = getOutputFileName("phylip",variables);
+            outputNames.push_back(distFileName); outputTypes["phylip"].push_back(distFileName);
+            
+            ofstream outDist;
+            m->openOutputFile(distFileName, outDist);
+            outDist.setf(ios::fixed, ios::floatfield); outDist.setf(ios::showpoint);
+            
+            printSims(outDist, matrix);
+            
+            outDist.close();
+        }
 		
         if (iters != 0) {
             //we need to find the average distance and standard deviation for each groups distance
@@ -832,7 +679,45 @@ int MatrixOutputCommand::process(vector<SharedRAbundVector*> thisLookup){
 	}
 }
 /**************************************************************************************************/
-int MatrixOutputCommand::driver(vector<SharedRAbundVector*> thisLookup, int start, int end, vector< vector<seqDist> >& calcDists) { 
+//pulls (iteration, rows) items until there are none left. A subsampled iteration draws its sample from an engine seeded with
+//seed+iteration, so every block of it sees the same sample and the results do not depend on the number of processors.
+void MatrixOutputCommand::iterThread(distSharedData* data, vector<Calculator*>* calcs) {
+	try {
+        SubSample sample; //keeps its buffers from one iteration to the next
+        
+        while (!m->control_pressed) {
+            int i = data->nextItem++;
+            if (i >= data->items.size()) { break; }
+            
+            iterBlock item = data->items[i];
+            
+            if (item.iter == 0) { driver(data->thisLookup, item.start, item.end, *calcs, data->calcDistsTotals[0]); continue; }
+            
+            //make copy of lookup so we don't get access violations
+            vector<SharedRAbundVector*> thisItersLookup;
+            for (int k = 0; k < data->thisLookup.size(); k++) { thisItersLookup.push_back(new SharedRAbundVector(*(data->thisLookup[k]))); }
+            
+            mt19937_64 engine(data->seed + item.iter);
+            sample.getSample(thisItersLookup, subsampleSize, engine);
+            
+            driver(thisItersLookup, item.start, item.end, *calcs, data->calcDistsTotals[item.iter]);
+            
+            for (int k = 0; k < thisItersLookup.size(); k++) { delete thisItersLookup[k]; }
+            
+            int done = ++(data->itemsDone);
+            if ((done % (100*data->blocksPerIter)) == 0) {
+                lock_guard<mutex> guard(progressMutex);
+                m->mothurOutJustToScreen(toString(done/data->blocksPerIter)+"\n");
+            }
+        }
+	}
+	catch(exception& e) {
+		m->errorOut(e, "MatrixOutputCommand", "iterThread");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+int MatrixOutputCommand::driver(vector<SharedRAbundVector*>& thisLookup, int start, int end, vector<Calculator*>& calcs, vector< vector<seqDist> >& calcDists) { 
 	try {
 		vector<SharedRAbundVector*> subset;
         
@@ -840,28 +725,25 @@ int MatrixOutputCommand::driver(vector<SharedRAbundVector*> thisLookup, int star
 			
 			for (int l = 0; l < k; l++) {
 				
-				if (k != l) { //we dont need to similarity of a groups to itself
-					subset.clear(); //clear out old pair of sharedrabunds
-					//add new pair of sharedrabunds
-					subset.push_back(thisLookup[k]); subset.push_back(thisLookup[l]); 
+				subset.clear(); //clear out old pair of sharedrabunds
+				//add new pair of sharedrabunds
+				subset.push_back(thisLookup[k]); subset.push_back(thisLookup[l]); 
+				
+				for(int i=0;i<calcs.size();i++) {
 					
-					for(int i=0;i<matrixCalculators.size();i++) {
-						
-						//if this calc needs all groups to calculate the pair load all groups
-						if (matrixCalculators[i]->getNeedsAll()) { 
-							//load subset with rest of lookup for those calcs that need everyone to calc for a pair
-							for (int w = 0; w < thisLookup.size(); w++) {
-								if ((w != k) && (w != l)) { subset.push_back(thisLookup[w]); }
-							}
+					//if this calc needs all groups to calculate the pair load all groups
+					if (calcs[i]->getNeedsAll()) { 
+						//load subset with rest of lookup for those calcs that need everyone to calc for a pair
+						for (int w = 0; w < thisLookup.size(); w++) {
+							if ((w != k) && (w != l)) { subset.push_back(thisLookup[w]); }
 						}
-						
-						vector<double> tempdata = matrixCalculators[i]->getValues(subset); //saves the calculator outputs
-						
-						if (m->control_pressed) { return 1; }
-        
-						seqDist temp(l, k, tempdata[0]);
-						calcDists[i].push_back(temp);
 					}
+					
+					vector<double> tempdata = calcs[i]->getValues(subset); //saves the calculator outputs
+					
+					if (m->control_pressed) { return 1; }
+					
+					calcDists[i][(k*(k-1))/2+l].dist = tempdata[0];
 				}
 			}
 		}
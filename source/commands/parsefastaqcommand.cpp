@@ -435,15 +435,15 @@ int ParseFastaQCommand::processFile(vector<string> files, TrimOligos*& trimOligo
         if (fasta) { m->openOutputFile(ffastaFile, outfFasta);  outputNames.push_back(ffastaFile); outputTypes["fasta"].push_back(ffastaFile);	m->openOutputFile(rfastaFile, outrFasta);  outputNames.push_back(rfastaFile); outputTypes["fasta"].push_back(rfastaFile);}
         if (qual) { m->openOutputFile(fqualFile, outfQual);	outputNames.push_back(fqualFile);  outputTypes["qfile"].push_back(fqualFile);	m->openOutputFile(rqualFile, outrQual);	outputNames.push_back(rqualFile);  outputTypes["qfile"].push_back(rqualFile);	}
         
-        ifstream inf;
-        m->openInputFile(inputfile, inf);
+        //compressed files are decompressed with the current number of processors
+        int numThreads = 1; string temp = m->getProcessors(); m->mothurConvert(temp, numThreads);
         
-        ifstream inr;
-        m->openInputFile(inputReverse, inr);
+        BlockReader inf(inputfile, numThreads);
+        BlockReader inr(inputReverse, numThreads);
         
-        ifstream inFIndex, inRIndex;
-        if (files[2] != "") { m->openInputFile(files[2], inFIndex);  }
-        if (files[3] != "") { m->openInputFile(files[3], inRIndex);  }
+        BlockReader* inFIndex = NULL; BlockReader* inRIndex = NULL;
+        if (files[2] != "") { inFIndex = new BlockReader(files[2], numThreads);  }
+        if (files[3] != "") { inRIndex = new BlockReader(files[3], numThreads);  }
         
         int count = 0;
         while (!inf.eof() && !inr.eof()) {
@@ -489,12 +489,12 @@ int ParseFastaQCommand::processFile(vector<string> files, TrimOligos*& trimOligo
                         bool ignorefi, ignoreri;
                     
                         if (files[2] != "") {
-                            FastqRead thisfiRead(inFIndex, ignorefi, format);
+                            FastqRead thisfiRead(*inFIndex, ignorefi, format);
                             if (!ignorefi) {  findexBarcode.setAligned(thisfiRead.getSequence().getAligned());  }
                         }
                         
                         if (files[3] != "") {
-                            FastqRead thisriRead(inRIndex, ignoreri, format);
+                            FastqRead thisriRead(*inRIndex, ignoreri, format);
                             if (!ignoreri) {  rindexBarcode.setAligned(thisriRead.getSequence().getAligned());  }
                         }
                     }
@@ -595,9 +595,8 @@ int ParseFastaQCommand::processFile(vector<string> files, TrimOligos*& trimOligo
             }
         }
         
-        inf.close(); inr.close();
-        if (files[2] != "") { inFIndex.close();  }
-        if (files[3] != "") { inRIndex.close();  }
+        if (inFIndex != NULL) { delete inFIndex;  }
+        if (inRIndex != NULL) { delete inRIndex;  }
         
         if (fasta)	{ outfFasta.close(); outrFasta.close();	}
         if (qual)	{ outfQual.close();	outrQual.close();   }
@@ -628,8 +627,9 @@ int ParseFastaQCommand::processFile(string inputfile, TrimOligos*& trimOligos, T
         if (fasta) { m->openOutputFile(fastaFile, outFasta);  outputNames.push_back(fastaFile); outputTypes["fasta"].push_back(fastaFile);	}
         if (qual) { m->openOutputFile(qualFile, outQual);	outputNames.push_back(qualFile);  outputTypes["qfile"].push_back(qualFile);		}
         
-        ifstream in;
-        m->openInputFile(inputfile, in);
+        //compressed files are decompressed with the current number of processors
+        int numThreads = 1; string temp = m->getProcessors(); m->mothurConvert(temp, numThreads);
+        BlockReader in(inputfile, numThreads);
         
         //fill convert table - goes from solexa to sanger. Used fq_all2std.pl as a reference.
         for (int i = -64; i < 65; i++) {
@@ -728,7 +728,6 @@ int ParseFastaQCommand::processFile(string inputfile, TrimOligos*& trimOligos, T
             }
         }
         
-        in.close();
         if (fasta)	{ outFasta.close();	}
         if (qual)	{ outQual.close();	}
         
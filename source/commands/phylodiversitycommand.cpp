@@ -596,61 +596,63 @@ int PhyloDiversityCommand::driver(Tree* t, map< string, vector<float> >& div, ma
 		int numLeafNodes = randomLeaf.size();
 		vector<string> mGroups = m->getGroups();
         
-        map<string, int> rootForGroup = getRootForGroups(t); //maps groupName to root node in tree. "root" for group may not be the trees root and we don't want to include the extra branches.
+        //index the users groups in the order the leaves list them
+        vector<string> groups;
+        vector<string> allGroups = t->getCountTable()->getNamesOfGroups();
+        for (int j = 0; j < allGroups.size(); j++) { if (m->inUsersGroups(allGroups[j], mGroups)) { groups.push_back(allGroups[j]); } }
+        DenseTree denseTree(t, groups);
+        int numGroups = groups.size();
         
+        map<string, int> rootForGroup = getRootForGroups(t); //maps groupName to root node in tree. "root" for group may not be the trees root and we don't want to include the extra branches.
+        vector<int> roots(numGroups, 0);
+        vector< vector<float>* > groupDiv(numGroups);
+        for (int j = 0; j < numGroups; j++) {
+            map<string, int>::iterator it = rootForGroup.find(groups[j]);
+            if (it != rootForGroup.end()) { roots[j] = it->second; }
+            groupDiv[j] = &div[groups[j]];
+        }
         
 		for (int l = 0; l < numIters; l++) {
             m->mothurRandomShuffle(randomLeaf);
             
             //initialize counts
-            map<string, int> counts;
-            vector< map<string, bool> > countedBranch;
-            for (int i = 0; i < t->getNumNodes(); i++) {
-                map<string, bool> temp;
-                for (int j = 0; j < mGroups.size(); j++) { temp[mGroups[j]] = false; }
-                countedBranch.push_back(temp);
-            }
+            vector<int> counts(numGroups, 0);
+            vector<char> countedBranch(t->getNumNodes()*numGroups, 0);
             
-            for (int j = 0; j < mGroups.size(); j++) {  counts[mGroups[j]] = 0;   }
-            
-            map<string, int> metCount; bool allDone = false;
-            for (int j = 0; j < mGroups.size(); j++) {  counts[mGroups[j]] = false;   }
+            vector<bool> metCount(numGroups, false); bool allDone = false;
             for(int k = 0; k < numLeafNodes; k++){
                 
                 if (m->control_pressed) { return 0; }
                 
+                //the users groups in this leaf
+                vector<int> leafGroups;
+                for (int j = 0; j < numGroups; j++) { if (denseTree.getLeafCount(randomLeaf[k], j) != 0) { leafGroups.push_back(j); } }
+                
                 //calc branch length of randomLeaf k
-                vector<float> br = calcBranchLength(t, randomLeaf[k], countedBranch, rootForGroup);
+                vector<float> br = calcBranchLength(&denseTree, randomLeaf[k], leafGroups, countedBranch, roots);
                 
                 //for each group in the groups update the total branch length accounting for the names file
-                vector<string> groups = t->tree[randomLeaf[k]].getGroup();
-                
-                for (int j = 0; j < groups.size(); j++) {
+                for (int h = 0; h < leafGroups.size(); h++) {
+                    int j = leafGroups[h];
+                    vector<float>& thisDiv = *groupDiv[j];
                     
-                    if (m->inUsersGroups(groups[j], mGroups)) {
-                        int numSeqsInGroupJ = 0;
-                        map<string, int>::iterator it;
-                        it = t->tree[randomLeaf[k]].pcount.find(groups[j]);
-                        if (it != t->tree[randomLeaf[k]].pcount.end()) { //this leaf node contains seqs from group j
-                            numSeqsInGroupJ = it->second;
-                        }
-                        
-                        if (numSeqsInGroupJ != 0) {	div[groups[j]][(counts[groups[j]]+1)] = div[groups[j]][counts[groups[j]]] + br[j];  }
-                        
-                        for (int s = (counts[groups[j]]+2); s <= (counts[groups[j]]+numSeqsInGroupJ); s++) {
-                            div[groups[j]][s] = div[groups[j]][s-1];  //update counts, but don't add in redundant branch lengths
-                        }
-                        counts[groups[j]] += numSeqsInGroupJ;
-                        if (subsample) {
-                            if (counts[groups[j]] >= subsampleSize) { metCount[groups[j]] = true; }
-                            bool allTrue = true;
-                            for (int h = 0; h < mGroups.size(); h++) {
-                                if (!metCount[mGroups[h]]) { allTrue = false; }
-                            }
-                            if (allTrue) { allDone = true; }
+                    int numSeqsInGroupJ = denseTree.getLeafCount(randomLeaf[k], j);
+                    
+                    thisDiv[(counts[j]+1)] = thisDiv[counts[j]] + br[h];
+                    
+                    for (int s = (counts[j]+2); s <= (counts[j]+numSeqsInGroupJ); s++) {
+                        thisDiv[s] = thisDiv[s-1];  //update counts, but don't add in redundant branch lengths
+                    }
+                    counts[j] += numSeqsInGroupJ;
+                    if (subsample) {
+                        if (counts[j] >= subsampleSize) { metCount[j] = true; }
+                        bool allTrue = true;
+                        for (int g = 0; g < numGroups; g++) {
+                            if (!metCount[g]) { allTrue = false; }
                         }
-                        if (allDone) { j+=groups.size(); k+=numLeafNodes; }
+                        if (allTrue) { allDone = true; }
                     }
+                    if (allDone) { h+=leafGroups.size(); k+=numLeafNodes; }
                 }
             }
             
@@ -749,45 +751,46 @@ void PhyloDiversityCommand::printData(set<int>& num, map< string, vector<float>
 }
 //**********************************************************************************************************************
 //need a vector of floats one branch length for every group the node represents.
-vector<float> PhyloDiversityCommand::calcBranchLength(Tree* t, int leaf, vector< map<string, bool> >& counted, map<string, int> roots){
+vector<float> PhyloDiversityCommand::calcBranchLength(DenseTree* t, int leaf, vector<int>& groups, vector<char>& counted, vector<int>& roots){
 	try {
         
 		//calc the branch length
 		//while you aren't at root
 		vector<float> sums; 
 		int index = leaf;
+		int numGroups = t->getNumGroups();
 		
-		vector<string> groups = t->tree[leaf].getGroup();
 		sums.resize(groups.size(), 0.0);
 		
         
         //you are a leaf
-		if(t->tree[index].getBranchLength() != -1){	
+		if(t->getBranchLength(index) != -1){	
 			for (int k = 0; k < groups.size(); k++) { 
-                sums[k] += abs(t->tree[index].getBranchLength());	
+                sums[k] += abs(t->getBranchLength(index));	
 			}
 		}
         
         
-        index = t->tree[index].getParent();	
+        index = t->getParent(index);	
         
 		//while you aren't at root
-		while(t->tree[index].getParent() != -1){
+		while(t->getParent(index) != -1){
             
 			if (m->control_pressed) {  return sums; }
 			
 			for (int k = 0; k < groups.size(); k++) {
+                char& done = counted[index*numGroups+groups[k]];
                 
-                if (index >= roots[groups[k]]) { counted[index][groups[k]] = true; } //if you are at this groups "root", then say we are done
+                if (index >= roots[groups[k]]) { done = true; } //if you are at this groups "root", then say we are done
                 
-                if (!counted[index][groups[k]]){ //if counted[index][groups[k] is true this groups has already added all br from here to root, so quit early
-                    if (t->tree[index].getBranchLength() != -1) {
-                        sums[k] += abs(t->tree[index].getBranchLength());
+                if (!done){ //if counted[index][groups[k] is true this groups has already added all br from here to root, so quit early
+                    if (t->getBranchLength(index) != -1) {
+                        sums[k] += abs(t->getBranchLength(index));
                     }
-                    counted[index][groups[k]] = true;
+                    done = true;
                 }
             }
-            index = t->tree[index].getParent();	
+            index = t->getParent(index);	
         }
         
 		return sums;
@@ -14,6 +14,7 @@
 #include "counttable.h"
 #include "sharedutilities.h"
 #include "tree.h"
+#include "densetree.h"
 
 
 class PhyloDiversityCommand : public Command {
@@ -46,7 +47,7 @@ private:
 		int readNamesFile();
 		void printData(set<int>&, map< string, vector<float> >&, ofstream&, int);
 		void printSumData(map< string, vector<float> >&, ofstream&, int);
-        vector<float> calcBranchLength(Tree*, int, vector< map<string, bool> >&, map<string, int>);
+        vector<float> calcBranchLength(DenseTree*, int, vector<int>&, vector<char>&, vector<int>&);
 		int driver(Tree*, map< string, vector<float> >&, map<string, vector<float> >&, int, int, vector<int>&, set<int>&, ofstream&, ofstream&, bool);
 		int createProcesses(vector<int>&, Tree*, map< string, vector<float> >&, map<string, vector<float> >&, int, int, vector<int>&, set<int>&, ofstream&, ofstream&);
 
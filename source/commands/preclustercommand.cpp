@@ -107,7 +107,7 @@ PreClusterCommand::PreClusterCommand(){
 
 PreClusterCommand::PreClusterCommand(string option) {
 	try {
-		abort = false; calledHelp = false;   
+		abort = false; calledHelp = false; useIndex = true;
 		
 		//allow user to run help
 		if(option == "help") { help(); abort = true; calledHelp = true; }
@@ -403,16 +403,7 @@ int PreClusterCommand::createProcessesGroups(string newFName, string newNName, s
 		if (groups.size() < processors) { processors = groups.size(); }
 		
 		//divide the groups between the processors
-		vector<linePair> lines;
-		int remainingPairs = groups.size();
-        int startIndex = 0;
-        for (int remainingProcessors = processors; remainingProcessors > 0; remainingProcessors--) {
-            int numPairs = remainingPairs; //case for last processor
-            if (remainingProcessors != 1) { numPairs = ceil(remainingPairs / remainingProcessors); }
-            lines.push_back(linePair(startIndex, (startIndex+numPairs))); //startIndex, endIndex
-            startIndex = startIndex + numPairs;
-            remainingPairs = remainingPairs - numPairs;
-        }
+		vector<linePair> lines = divideGroups(groups, processors);
 		
 #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)		
 		
@@ -457,20 +448,11 @@ int PreClusterCommand::createProcessesGroups(string newFName, string newNName, s
             //test line, also set recalc to true.
             //for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); } for (int i=0;i<processIDS.size();i++) { int temp = processIDS[i]; wait(&temp); } m->control_pressed = false;  for (int i=0;i<processIDS.size();i++) {m->mothurRemove((toString(processIDS[i]) + ".outputNames.temp"));}processors=3; m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(processors) + "\n");
             
-            lines.clear();
             num = 0;
             processIDS.resize(0);
             process = 1;
             
-            int remainingPairs = groups.size();
-            int startIndex = 0;
-            for (int remainingProcessors = processors; remainingProcessors > 0; remainingProcessors--) {
-                int numPairs = remainingPairs; //case for last processor
-                if (remainingProcessors != 1) { numPairs = ceil(remainingPairs / remainingProcessors); }
-                lines.push_back(linePair(startIndex, (startIndex+numPairs))); //startIndex, endIndex
-                startIndex = startIndex + numPairs;
-                remainingPairs = remainingPairs - numPairs;
-            }
+            lines = divideGroups(groups, processors);
             
             while (process != processors) {
                 pid_t pid = fork();
@@ -592,6 +574,80 @@ int PreClusterCommand::createProcessesGroups(string newFName, string newNName, s
 	}
 }
 /**************************************************************************************************/
+//splits the groups into contiguous ranges with about the same number of unique seqs in each, so one process does not get
+//all the big groups. The ranges stay in group order so the appended output files come out the same for any processors.
+vector<linePair> PreClusterCommand::divideGroups(vector<string>& groups, int numProcessors) {
+	try {
+		vector<linePair> lines;
+        if (numProcessors == 1) { lines.push_back(linePair(0, groups.size())); return lines; }
+        
+        vector<double> sizes(groups.size(), 0);
+        if (countfile != "") {
+            CountTable temp; temp.readTable(countfile, true, false);
+            vector<string> tableGroups = temp.getNamesOfGroups();
+            map<string, int> groupIndex;
+            for (int i = 0; i < groups.size(); i++) { groupIndex[groups[i]] = i; }
+            
+            vector<string> names = temp.getNamesOfSeqs();
+            for (int i = 0; i < names.size(); i++) {
+                if (m->control_pressed) { break; }
+                vector<int> groupCounts = temp.getGroupCounts(names[i]);
+                for (int k = 0; k < groupCounts.size(); k++) {
+                    if (groupCounts[k] != 0) { map<string, int>::iterator it = groupIndex.find(tableGroups[k]); if (it != groupIndex.end()) { sizes[it->second]++; } }
+                }
+            }
+        }else {
+            GroupMap gp; gp.readMap(groupfile);
+            if (namefile == "") { for (int i = 0; i < groups.size(); i++) { sizes[i] = gp.getNumSeqs(groups[i]); } }
+            else {
+                //the parser splits a unique into one seq per group its redundant seqs are in
+                map<string, int> groupIndex;
+                for (int i = 0; i < groups.size(); i++) { groupIndex[groups[i]] = i; }
+                
+                map<string, vector<string> > nameMap;
+                m->readNames(namefile, nameMap);
+                for (map<string, vector<string> >::iterator itName = nameMap.begin(); itName != nameMap.end(); itName++) {
+                    if (m->control_pressed) { break; }
+                    set<int> uniqueGroups;
+                    for (int j = 0; j < itName->second.size(); j++) {
+                        map<string, int>::iterator it = groupIndex.find(gp.getGroup(itName->second[j]));
+                        if (it != groupIndex.end()) { uniqueGroups.insert(it->second); }
+                    }
+                    for (set<int>::iterator it = uniqueGroups.begin(); it != uniqueGroups.end(); it++) { sizes[*it]++; }
+                }
+            }
+        }
+        
+        double remainingSize = 0;
+        for (int i = 0; i < sizes.size(); i++) { remainingSize += sizes[i]; }
+        
+        int startIndex = 0;
+        for (int remainingProcessors = numProcessors; remainingProcessors > 0; remainingProcessors--) {
+            int endIndex = groups.size(); //case for last processor
+            double thisSize = 0;
+            
+            if (remainingProcessors != 1) {
+                //take at least one group, and the next group while at least half of it fits under this processors share
+                int maxEnd = groups.size() - (remainingProcessors-1);
+                double target = remainingSize / (double) remainingProcessors;
+                endIndex = startIndex;
+                thisSize += sizes[endIndex]; endIndex++;
+                while ((endIndex < maxEnd) && ((thisSize + sizes[endIndex] / 2.0) <= target)) { thisSize += sizes[endIndex]; endIndex++; }
+            }
+            
+            lines.push_back(linePair(startIndex, endIndex)); //startIndex, endIndex
+            startIndex = endIndex;
+            remainingSize -= thisSize;
+        }
+        
+        return lines;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PreClusterCommand", "divideGroups");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
 int PreClusterCommand::driverGroups(string newFFile, string newNFile, string newMFile, int start, int end, vector<string> groups){
 	try {
         vector<string> subsetGroups;
@@ -666,6 +722,11 @@ int PreClusterCommand::process(string newMapFile){
 		int count = 0;
 		int numSeqs = alignSeqs.size();
 		
+        //only the seqs sharing enough of their filtered columns with seq i can be within diffs, the candidates come back in
+        //increasing order so the merges happen in the same greedy order as a scan over every j
+        PreClusterIndex index(alignSeqs, diffs, ((method == "aligned") && useIndex));
+        vector<int> candidates;
+        
         if (topdown) {
             //think about running through twice...
             for (int i = 0; i < numSeqs; i++) {
@@ -675,7 +736,9 @@ int PreClusterCommand::process(string newMapFile){
                     string chunk = alignSeqs[i].seq.getName() + "\t" + toString(alignSeqs[i].numIdentical) + "\t" + toString(0) + "\t" + alignSeqs[i].seq.getAligned() + "\n";
                     
                     //try to merge it with all smaller seqs
-                    for (int j = i+1; j < numSeqs; j++) {
+                    index.getCandidates(i, candidates);
+                    for (int c = 0; c < candidates.size(); c++) {
+                        int j = candidates[c];
                         
                         if (m->control_pressed) { out.close(); return 0; }
                         
@@ -683,7 +746,7 @@ int PreClusterCommand::process(string newMapFile){
                             //are you within "diff" bases
                             int mismatch = length;
                             if (method == "unaligned") { mismatch = calcMisMatches(alignSeqs[i].seq.getAligned(), alignSeqs[j].seq.getAligned()); }
-                            else { mismatch = calcMisMatches(alignSeqs[i].filteredSeq, alignSeqs[j].filteredSeq); }
+                            else { mismatch = alignSeqs[i].filteredSeq.countMismatches(alignSeqs[j].filteredSeq, diffs); if (mismatch > diffs) { mismatch = length; } }
                             
                             if (mismatch <= diffs) {
                                 //merge
@@ -709,16 +772,18 @@ int PreClusterCommand::process(string newMapFile){
                 if(i % 100 == 0)	{ m->mothurOutJustToScreen(toString(i) + "\t" + toString(numSeqs - count) + "\t" + toString(count)+"\n"); 	}
             }
         }else {
-            map<int, string> mapFile;
-            map<int, int> originalCount;
-            map<int, int>::iterator itCount;
-            for (int i = 0; i < numSeqs; i++) { mapFile[i] = ""; originalCount[i] = alignSeqs[i].numIdentical; }
+            //map lines of the seqs merged into each seq, newest last so a merge moves the list instead of copying it
+            vector< vector<string> > mapLines(numSeqs);
+            vector<int> originalCount(numSeqs, 0);
+            for (int i = 0; i < numSeqs; i++) { originalCount[i] = alignSeqs[i].numIdentical; }
             
             //think about running through twice...
             for (int i = 0; i < numSeqs; i++) {
                 
                 //try to merge it into larger seqs
-                for (int j = i+1; j < numSeqs; j++) {
+                index.getCandidates(i, candidates);
+                for (int c = 0; c < candidates.size(); c++) {
+                    int j = candidates[c];
                     
                     if (m->control_pressed) { out.close(); return 0; }
                     
@@ -726,19 +791,19 @@ int PreClusterCommand::process(string newMapFile){
                         //are you within "diff" bases
                         int mismatch = length;
                         if (method == "unaligned") { mismatch = calcMisMatches(alignSeqs[i].seq.getAligned(), alignSeqs[j].seq.getAligned()); }
-                        else { mismatch = calcMisMatches(alignSeqs[i].filteredSeq, alignSeqs[j].filteredSeq); }
+                        else { mismatch = alignSeqs[i].filteredSeq.countMismatches(alignSeqs[j].filteredSeq, diffs); if (mismatch > diffs) { mismatch = length; } }
                         
                         if (mismatch <= diffs) {
                             //merge
                             alignSeqs[j].names += ',' + alignSeqs[i].names;
                             alignSeqs[j].numIdentical += alignSeqs[i].numIdentical;
                             
-                            mapFile[j] = alignSeqs[i].seq.getName() + "\t" + toString(alignSeqs[i].numIdentical) + "\t" + toString(mismatch) + "\t" + alignSeqs[i].seq.getAligned() + "\n" + mapFile[i];
+                            mapLines[j].swap(mapLines[i]); mapLines[i].clear();
+                            mapLines[j].push_back(alignSeqs[i].seq.getName() + "\t" + toString(alignSeqs[i].numIdentical) + "\t" + toString(mismatch) + "\t" + alignSeqs[i].seq.getAligned() + "\n");
                             alignSeqs[i].numIdentical = 0;
-                            originalCount.erase(i);
-                            mapFile[i] = "";
+                            originalCount[i] = 0;
                             count++;
-                            j+=numSeqs; //exit search, we merged this one in.
+                            break; //exit search, we merged this one in.
                         }
                     }//end abundance check
                 }//end for loop j
@@ -748,7 +813,9 @@ int PreClusterCommand::process(string newMapFile){
             
             for (int i = 0; i < numSeqs; i++) {
                 if (alignSeqs[i].numIdentical != 0) {
-                    out << "ideal_seq_" << (i+1) << '\t' << alignSeqs[i].numIdentical << endl  << alignSeqs[i].seq.getName() + "\t" + toString(alignSeqs[i].numIdentical) + "\t" + toString(0) + "\t" + alignSeqs[i].seq.getAligned() + "\n" << mapFile[i] << endl;
+                    out << "ideal_seq_" << (i+1) << '\t' << alignSeqs[i].numIdentical << endl  << alignSeqs[i].seq.getName() + "\t" + toString(alignSeqs[i].numIdentical) + "\t" + toString(0) + "\t" + alignSeqs[i].seq.getAligned() + "\n";
+                    for (int k = mapLines[i].size()-1; k >= 0; k--) { out << mapLines[i][k]; }
+                    out << endl;
                 }
             }
             
@@ -1075,11 +1142,12 @@ int PreClusterCommand::filterSeqs(){
         
         //run filter
         for (int i = 0; i < alignSeqs.size(); i++) {
-            alignSeqs[i].filteredSeq = "";
+            string filtered = "";
             string align = alignSeqs[i].seq.getAligned();
             for(int j=0;j<length;j++){
-                if(filterString[j] == '1'){ alignSeqs[i].filteredSeq += align[j]; }
+                if(filterString[j] == '1'){ filtered += align[j]; }
             }
+            alignSeqs[i].filteredSeq = PackedSeq(alignSeqs[i].seq.getName(), filtered);
         }
         
         return 0;
@@ -1092,3 +1160,80 @@ int PreClusterCommand::filterSeqs(){
 /**************************************************************************************************/
 
 
+PreClusterIndex::PreClusterIndex(vector<seqPNode>& seqs, int diffs, bool aligned) {
+    try {
+        m = MothurOut::getInstance();
+        numSeqs = seqs.size();
+        indexed = false;
+        
+        if (!aligned || (numSeqs == 0)) { return; }
+        
+        //more segments than diffs+1 means a pair has to share several of them, which weeds out most of the pairs that share one by chance
+        int filteredLength = seqs[0].filteredSeq.getAlignLength();
+        numSegments = min(2*(diffs+1), filteredLength);
+        minShared = numSegments - diffs;
+        if (minShared < 1) { return; }
+        
+        vector<int> segmentStarts(numSegments+1, 0);
+        for (int s = 0; s <= numSegments; s++) { segmentStarts[s] = (int)(((long long)s * filteredLength) / numSegments); }
+        
+        //fnv-1a hash of each segment, collisions only add candidates that are checked anyway
+        seqHashes.resize(numSeqs*numSegments);
+        segments.resize(numSegments);
+        for (int i = 0; i < numSeqs; i++) {
+            if (m->control_pressed) { return; }
+            
+            string aligned = seqs[i].filteredSeq.getAligned();
+            for (int s = 0; s < numSegments; s++) {
+                unsigned long long hash = 14695981039346656037ULL;
+                for (int k = segmentStarts[s]; k < segmentStarts[s+1]; k++) {
+                    hash ^= (unsigned char)aligned[k];
+                    hash *= 1099511628211ULL;
+                }
+                seqHashes[i*numSegments+s] = hash;
+                segments[s].push_back(make_pair(hash, i));
+            }
+        }
+        for (int s = 0; s < numSegments; s++) { sort(segments[s].begin(), segments[s].end()); }
+        
+        hits.resize(numSeqs, 0);
+        indexed = true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "PreClusterIndex", "PreClusterIndex");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void PreClusterIndex::getCandidates(int i, vector<int>& candidates) {
+    try {
+        candidates.clear();
+        
+        if (!indexed) { //compare to everyone after me
+            for (int j = i+1; j < numSeqs; j++) { candidates.push_back(j); }
+            return;
+        }
+        
+        touched.clear();
+        for (int s = 0; s < numSegments; s++) {
+            unsigned long long hash = seqHashes[i*numSegments+s];
+            vector< pair<unsigned long long, int> >::iterator it = lower_bound(segments[s].begin(), segments[s].end(), make_pair(hash, i+1));
+            
+            for (; (it != segments[s].end()) && (it->first == hash); it++) {
+                if (hits[it->second] == 0) { touched.push_back(it->second); }
+                hits[it->second]++;
+            }
+        }
+        
+        for (int t = 0; t < touched.size(); t++) {
+            if (hits[touched[t]] >= minShared) { candidates.push_back(touched[t]); }
+            hits[touched[t]] = 0;
+        }
+        sort(candidates.begin(), candidates.end());
+    }
+    catch(exception& e) {
+        m->errorOut(e, "PreClusterIndex", "getCandidates");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
@@ -22,17 +22,18 @@
 #include "blastalign.hpp"
 #include "noalign.hpp"
 #include "filters.h"
+#include "packedseq.h"
 
 /************************************************************/
 struct seqPNode {
 	int numIdentical;
 	Sequence seq;
-    string filteredSeq;
+    PackedSeq filteredSeq;
 	string names;
 	bool active;
 	int diffs;
 	seqPNode() {}
-	seqPNode(int n, Sequence s, string nm) : numIdentical(n), seq(s), names(nm), active(1) { diffs = 0; filteredSeq = "";}
+	seqPNode(int n, Sequence s, string nm) : numIdentical(n), seq(s), names(nm), active(1) { diffs = 0; }
 	~seqPNode() {}
 };
 /************************************************************/
@@ -52,9 +53,33 @@ inline bool comparePriorityDownTop(seqPNode first, seqPNode second) {
     //}
     return false; 
 }
+/************************************************************/
+//pigeonhole index of the filtered aligned seqs. The columns are cut into segments and two seqs within diffs mismatches
+//must have at least numSegments - diffs identical segments, so only seqs sharing that many segments need to be compared.
+class PreClusterIndex {
+    
+public:
+    PreClusterIndex(vector<seqPNode>&, int, bool); //seqs, diffs, aligned
+    ~PreClusterIndex(){}
+    
+    bool isIndexed() { return indexed; }
+    void getCandidates(int, vector<int>&); //fills with the seqs after i that share enough segments with i, in increasing order
+    
+private:
+    MothurOut* m;
+    bool indexed;
+    int numSeqs, numSegments, minShared;
+    vector< vector< pair<unsigned long long, int> > > segments; //sorted hash, seq index pairs for each segment
+    vector<unsigned long long> seqHashes; //numSegments hashes per seq
+    vector<int> hits, touched;
+};
 //************************************************************/
 
 class PreClusterCommand : public Command {
+    
+#ifdef UNIT_TEST
+    friend class TestPreClusterCommand;
+#endif
 	
 public:
 	PreClusterCommand(string);
@@ -82,7 +107,7 @@ private:
     
 	int diffs, length, processors;
     float match, misMatch, gapOpen, gapExtend;
-	bool abort, bygroup, topdown;
+	bool abort, bygroup, topdown, useIndex; //useIndex is only turned off by the tests, to check the index finds the same merges as the full scan
 	string fastafile, namefile, outputDir, groupfile, countfile, method, align;
 	vector<seqPNode> alignSeqs; //maps the number of identical seqs to a sequence
 	vector<string> outputNames;
@@ -94,6 +119,7 @@ private:
 	int loadSeqs(map<string, string>&, vector<Sequence>&, string);
 	int driverGroups(string, string, string, int, int, vector<string>);
 	int createProcessesGroups(string, string, string);
+    vector<linePair> divideGroups(vector<string>&, int);
     int mergeGroupCounts(string, string, string);
     int filterSeqs();
 };
@@ -273,11 +299,12 @@ static DWORD WINAPI MyPreclusterThreadFunction(LPVOID lpParam){
                 
                 //run filter
                 for (int i = 0; i < alignSeqs.size(); i++) {
-                    alignSeqs[i].filteredSeq = "";
+                    string filtered = "";
                     string align = alignSeqs[i].seq.getAligned();
                     for(int j=0;j<length;j++){
-                        if(filterString[j] == '1'){ alignSeqs[i].filteredSeq += align[j]; }
+                        if(filterString[j] == '1'){ filtered += align[j]; }
                     }
+                    alignSeqs[i].filteredSeq = PackedSeq(alignSeqs[i].seq.getName(), filtered);
                 }
                 ////////////////////////////////////////////////////
             }
@@ -306,6 +333,9 @@ static DWORD WINAPI MyPreclusterThreadFunction(LPVOID lpParam){
             else {  sort(alignSeqs.begin(), alignSeqs.end(), comparePriorityDownTop);  }
             
 			int count = 0;
+            
+            PreClusterIndex index(alignSeqs, pDataArray->diffs, (pDataArray->method == "aligned"));
+            vector<int> candidates;
 			
             if (pDataArray->topdown) {
                 //think about running through twice...
@@ -319,7 +349,9 @@ static DWORD WINAPI MyPreclusterThreadFunction(LPVOID lpParam){
                         string chunk = alignSeqs[i].seq.getName() + "\t" + toString(alignSeqs[i].numIdentical) + "\t" + toString(0) + "\t" + alignSeqs[i].seq.getAligned() + "\n";
 
                         //try to merge it with all smaller seqs
-                        for (int j = i+1; j < numSeqs; j++) {
+                        index.getCandidates(i, candidates);
+                        for (int c = 0; c < candidates.size(); c++) {
+                            int j = candidates[c];
                             
                             if (pDataArray->m->control_pressed) { delete parser; delete alignment; return 0; }
                             
@@ -351,11 +383,8 @@ static DWORD WINAPI MyPreclusterThreadFunction(LPVOID lpParam){
                                         if (mismatch > pDataArray->diffs) { mismatch = length; break;  } //to far to cluster
                                     }
                                 }else {
-                                    for (int k = 0; k < alignSeqs[i].filteredSeq.length(); k++) {
-                                        //do they match
-                                        if (alignSeqs[i].filteredSeq[k] != alignSeqs[j].filteredSeq[k]) { mismatch++; }
-                                        if (mismatch > pDataArray->diffs) { mismatch = length; break; } //to far to cluster
-                                    }
+                                    mismatch = alignSeqs[i].filteredSeq.countMismatches(alignSeqs[j].filteredSeq, pDataArray->diffs);
+                                    if (mismatch > pDataArray->diffs) { mismatch = length; } //to far to cluster
                                 }
                                 ////////////////////////////////////////////////////
                                 
@@ -392,7 +421,9 @@ static DWORD WINAPI MyPreclusterThreadFunction(LPVOID lpParam){
                 for (int i = 0; i < numSeqs; i++) {
                     
                     //try to merge it into larger seqs
-                    for (int j = i+1; j < numSeqs; j++) {
+                    index.getCandidates(i, candidates);
+                    for (int c = 0; c < candidates.size(); c++) {
+                        int j = candidates[c];
                         
                         if (pDataArray->m->control_pressed) { out.close(); delete alignment; return 0; }
                         
@@ -423,12 +454,8 @@ static DWORD WINAPI MyPreclusterThreadFunction(LPVOID lpParam){
                                     if (mismatch > pDataArray->diffs) { mismatch = length; break;  } //to far to cluster
                                 }
                             }else {
-
-                                for (int k = 0; k < alignSeqs[i].filteredSeq.length(); k++) {
-                                    //do they match
-                                    if (alignSeqs[i].filteredSeq[k] != alignSeqs[j].filteredSeq[k]) { mismatch++; }
-                                    if (mismatch > pDataArray->diffs) { mismatch = length; break; } //to far to cluster
-                                }
+                                mismatch = alignSeqs[i].filteredSeq.countMismatches(alignSeqs[j].filteredSeq, pDataArray->diffs);
+                                if (mismatch > pDataArray->diffs) { mismatch = length; } //to far to cluster
                             }
                             if (mismatch <= pDataArray->diffs) {
                                 //merge
@@ -440,7 +467,7 @@ static DWORD WINAPI MyPreclusterThreadFunction(LPVOID lpParam){
                                 originalCount.erase(i);
                                 mapFile[i] = "";
                                 count++;
-                                j+=numSeqs; //exit search, we merged this one in.
+                                break; //exit search, we merged this one in.
                             }
                         }//end abundance check
                     }//end for loop j
@@ -0,0 +1,814 @@
+//
+//  qcseqscommand.cpp
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#include "qcseqscommand.h"
+
+static const int batchLength = 16777216; //characters of sequence read before the batch is processed
+
+//**********************************************************************************************************************
+vector<string> QcSeqsCommand::setParameters(){
+	try {
+		CommandParameter pfasta("fasta", "InputTypes", "", "", "none", "none", "none","fasta-name-summary",false,true,true); parameters.push_back(pfasta);
+		CommandParameter pname("name", "InputTypes", "", "", "namecount", "none", "none","name",false,false,true); parameters.push_back(pname);
+        CommandParameter pcount("count", "InputTypes", "", "", "namecount", "none", "none","count",false,false,true); parameters.push_back(pcount);
+		CommandParameter pstart("start", "Number", "", "-1", "", "", "","",false,false,true); parameters.push_back(pstart);
+		CommandParameter pend("end", "Number", "", "-1", "", "", "","",false,false,true); parameters.push_back(pend);
+		CommandParameter pmaxambig("maxambig", "Number", "", "-1", "", "", "","",false,false); parameters.push_back(pmaxambig);
+		CommandParameter pmaxhomop("maxhomop", "Number", "", "-1", "", "", "","",false,false); parameters.push_back(pmaxhomop);
+		CommandParameter pminlength("minlength", "Number", "", "10", "", "", "","",false,false); parameters.push_back(pminlength);
+		CommandParameter pmaxlength("maxlength", "Number", "", "-1", "", "", "","",false,false); parameters.push_back(pmaxlength);
+        CommandParameter pmaxn("maxn", "Number", "", "-1", "", "", "","",false,false); parameters.push_back(pmaxn);
+		CommandParameter pcriteria("criteria", "Number", "", "90", "", "", "","",false,false); parameters.push_back(pcriteria);
+		CommandParameter poptimize("optimize", "Multiple", "none-start-end-maxambig-maxhomop-minlength-maxlength-maxn", "none", "", "", "","",true,false); parameters.push_back(poptimize);
+		CommandParameter phard("hard", "InputTypes", "", "", "none", "none", "none","",false,false); parameters.push_back(phard);
+		CommandParameter ptrump("trump", "String", "", "*", "", "", "","",false,false, true); parameters.push_back(ptrump);
+		CommandParameter psoft("soft", "Number", "", "0", "", "", "","",false,false); parameters.push_back(psoft);
+		CommandParameter pvertical("vertical", "Boolean", "", "T", "", "", "","",false,false, true); parameters.push_back(pvertical);
+        CommandParameter pformat("format", "Multiple", "count-name", "name", "", "", "","",false,false, true); parameters.push_back(pformat);
+		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
+        CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
+        CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
+		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
+
+		vector<string> myArray;
+		for (int i = 0; i < parameters.size(); i++) {	myArray.push_back(parameters[i].name);		}
+		return myArray;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "QcSeqsCommand", "setParameters");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+string QcSeqsCommand::getHelpString(){
+	try {
+		string helpString = "";
+		helpString += "The qc.seqs command runs summary.seqs, screen.seqs, filter.seqs and unique.seqs on a fasta file in one pass, and only writes their final files.\n";
+		helpString += "The qc.seqs command parameters are fasta, name, count, start, end, maxambig, maxhomop, minlength, maxlength, maxn, optimize, criteria, hard, trump, soft, vertical, format and processors. fasta is required, unless you have a valid current fasta file.\n";
+		helpString += "The name parameter allows you to enter a name file associated with your fasta file. \n";
+        helpString += "The count parameter allows you to enter a count file associated with your fasta file. \n";
+		helpString += "The start, end, maxambig, maxhomop, minlength, maxlength, maxn, optimize and criteria parameters screen the sequences as they do in the screen.seqs command.\n";
+		helpString += "The hard, trump, soft and vertical parameters create the filter from the good sequences as they do in the filter.seqs command.\n";
+        helpString += "The format parameter is used to indicate what type of file you want outputted.  Choices are name and count, default=name unless count file used then default=count.\n";
+		helpString += "When optimize is used, or the filter is created from the sequences, the fasta file is read once more to find the statistics first.\n";
+		helpString += "The processors parameter allows you to specify the number of processors to use. The default is 1.\n";
+		helpString += "The qc.seqs command should be in the following format: \n";
+		helpString += "qc.seqs(fasta=yourFastaFile, count=yourCountFile, start=yourStart, end=yourEnd, maxhomop=yourMaxhomop, trump=.) \n";
+		helpString += "Note: No spaces between parameter labels (i.e. fasta), '=' and parameters (i.e.yourFastaFile).\n";
+		return helpString;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "QcSeqsCommand", "getHelpString");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+string QcSeqsCommand::getOutputPattern(string type) {
+    try {
+        string pattern = "";
+
+        if (type == "fasta")            {   pattern = "[filename],good.filter.unique,[extension]";  }
+        else if (type == "name")        {   pattern = "[filename],good.filter.names";               }
+        else if (type == "count")       {   pattern = "[filename],good.filter.count_table";         }
+        else if (type == "accnos")      {   pattern = "[filename],bad.accnos";                      }
+        else if (type == "filter")      {   pattern = "[filename],filter";                          }
+        else if (type == "summary")     {   pattern = "[filename],summary";                         }
+        else { m->mothurOut("[ERROR]: No definition for type " + type + " output pattern.\n"); m->control_pressed = true;  }
+
+        return pattern;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "QcSeqsCommand", "getOutputPattern");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
+QcSeqsCommand::QcSeqsCommand(){
+	try {
+		abort = true; calledHelp = true;
+		setParameters();
+		vector<string> tempOutNames;
+		outputTypes["fasta"] = tempOutNames;
+		outputTypes["name"] = tempOutNames;
+		outputTypes["count"] = tempOutNames;
+		outputTypes["accnos"] = tempOutNames;
+		outputTypes["filter"] = tempOutNames;
+		outputTypes["summary"] = tempOutNames;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "QcSeqsCommand", "QcSeqsCommand");
+		exit(1);
+	}
+}
+//***************************************************************************************************************
+QcSeqsCommand::QcSeqsCommand(string option)  {
+	try {
+		abort = false; calledHelp = false;
+
+		//allow user to run help
+		if(option == "help") { help(); abort = true; calledHelp = true; }
+		else if(option == "citation") { citation(); abort = true; calledHelp = true;}
+
+		else {
+			vector<string> myArray = setParameters();
+
+			OptionParser parser(option);
+			map<string,string> parameters = parser.getParameters();
+
+			ValidParameters validParameter("qc.seqs");
+			map<string,string>::iterator it;
+
+			//check to make sure all parameters are valid for command
+			for (it = parameters.begin(); it != parameters.end(); it++) {
+				if (validParameter.isValidParameter(it->first, myArray, it->second) != true) {  abort = true;  }
+			}
+
+			//initialize outputTypes
+			vector<string> tempOutNames;
+			outputTypes["fasta"] = tempOutNames;
+			outputTypes["name"] = tempOutNames;
+			outputTypes["count"] = tempOutNames;
+			outputTypes["accnos"] = tempOutNames;
+			outputTypes["filter"] = tempOutNames;
+			outputTypes["summary"] = tempOutNames;
+
+			//if the user changes the input directory command factory will send this info to us in the output parameter
+			string inputDir = validParameter.validFile(parameters, "inputdir", false);
+			if (inputDir == "not found"){	inputDir = "";		}
+			else {
+				string path;
+				it = parameters.find("fasta");
+				//user has given a template file
+				if(it != parameters.end()){
+					path = m->hasPath(it->second);
+					//if the user has not given a path then, add inputdir. else leave path alone.
+					if (path == "") {	parameters["fasta"] = inputDir + it->second;		}
+				}
+
+				it = parameters.find("name");
+				//user has given a template file
+				if(it != parameters.end()){
+					path = m->hasPath(it->second);
+					//if the user has not given a path then, add inputdir. else leave path alone.
+					if (path == "") {	parameters["name"] = inputDir + it->second;		}
+				}
+
+                it = parameters.find("count");
+				//user has given a template file
+				if(it != parameters.end()){
+					path = m->hasPath(it->second);
+					//if the user has not given a path then, add inputdir. else leave path alone.
+					if (path == "") {	parameters["count"] = inputDir + it->second;		}
+				}
+
+				it = parameters.find("hard");
+				//user has given a template file
+				if(it != parameters.end()){
+					path = m->hasPath(it->second);
+					//if the user has not given a path then, add inputdir. else leave path alone.
+					if (path == "") {	parameters["hard"] = inputDir + it->second;		}
+				}
+			}
+
+			//check for required parameters
+			fastafile = validParameter.validFile(parameters, "fasta", true);
+			if (fastafile == "not open") { abort = true; }
+			else if (fastafile == "not found") {
+				fastafile = m->getFastaFile();
+				if (fastafile != "") { m->mothurOut("Using " + fastafile + " as input file for the fasta parameter."); m->mothurOutEndLine(); }
+				else { 	m->mothurOut("You have no current fastafile and the fasta parameter is required."); m->mothurOutEndLine(); abort = true; }
+			}else { m->setFastaFile(fastafile); }
+
+			namefile = validParameter.validFile(parameters, "name", true);
+			if (namefile == "not open") { namefile = ""; abort = true; }
+			else if (namefile == "not found") { namefile = "";  }
+			else { m->setNameFile(namefile); }
+
+            countfile = validParameter.validFile(parameters, "count", true);
+			if (countfile == "not open") { abort = true; countfile = ""; }
+			else if (countfile == "not found") { countfile = ""; }
+			else { m->setCountTableFile(countfile); }
+
+            if ((countfile != "") && (namefile != "")) { m->mothurOut("You must enter ONLY ONE of the following: count or name."); m->mothurOutEndLine(); abort = true; }
+
+			//if the user changes the output directory command factory will send this info to us in the output parameter
+			outputDir = validParameter.validFile(parameters, "outputdir", false);		if (outputDir == "not found"){
+				outputDir = "";
+				outputDir += m->hasPath(fastafile); //if user entered a file with a path then preserve it
+			}
+
+			string temp;
+			temp = validParameter.validFile(parameters, "start", false);		if (temp == "not found") { temp = "-1"; }
+			m->mothurConvert(temp, startPos);
+
+			temp = validParameter.validFile(parameters, "end", false);			if (temp == "not found") { temp = "-1"; }
+			m->mothurConvert(temp, endPos);
+
+			temp = validParameter.validFile(parameters, "maxambig", false);		if (temp == "not found") { temp = "-1"; }
+			m->mothurConvert(temp, maxAmbig);
+
+			temp = validParameter.validFile(parameters, "maxhomop", false);		if (temp == "not found") { temp = "-1"; }
+			m->mothurConvert(temp, maxHomoP);
+
+			temp = validParameter.validFile(parameters, "minlength", false);	if (temp == "not found") { temp = "10"; }
+			m->mothurConvert(temp, minLength);
+
+			temp = validParameter.validFile(parameters, "maxlength", false);	if (temp == "not found") { temp = "-1"; }
+			m->mothurConvert(temp, maxLength);
+
+            temp = validParameter.validFile(parameters, "maxn", false);         if (temp == "not found") { temp = "-1"; }
+			m->mothurConvert(temp, maxN);
+
+			temp = validParameter.validFile(parameters, "optimize", false);	//optimizing trumps the optimized values original value
+			if (temp == "not found"){	temp = "none";		}
+			m->splitAtDash(temp, optimize);
+
+			//check for invalid optimize options
+			set<string> validOptimizers;
+			validOptimizers.insert("none"); validOptimizers.insert("start"); validOptimizers.insert("end"); validOptimizers.insert("maxambig"); validOptimizers.insert("maxhomop"); validOptimizers.insert("minlength"); validOptimizers.insert("maxlength"); validOptimizers.insert("maxn");
+			for (int i = 0; i < optimize.size(); i++) {
+				if (validOptimizers.count(optimize[i]) == 0) {
+					m->mothurOut(optimize[i] + " is not a valid optimizer. Valid options are end, maxambig, maxhomop, maxlength, maxn, minlength, none, start."); m->mothurOutEndLine();
+					optimize.erase(optimize.begin()+i);
+					i--;
+				}
+			}
+
+			if (optimize.size() == 1) { if (optimize[0] == "none") { optimize.clear(); } }
+
+			temp = validParameter.validFile(parameters, "criteria", false);	if (temp == "not found"){	temp = "90";				}
+			m->mothurConvert(temp, criteria);
+
+			hard = validParameter.validFile(parameters, "hard", true);				if (hard == "not found") { hard = ""; }
+			else if (hard == "not open") { hard = ""; abort = true; }
+
+			temp = validParameter.validFile(parameters, "trump", false);			if (temp == "not found") { temp = "*"; }
+			trump = temp[0];
+
+			temp = validParameter.validFile(parameters, "soft", false);				if (temp == "not found") { soft = 0; }
+			else {  soft = (float)atoi(temp.c_str()) / 100.0;  }
+
+			vertical = validParameter.validFile(parameters, "vertical", false);
+			if (vertical == "not found") {
+				if ((hard == "") && (trump == '*') && (soft == 0)) { vertical = "T"; } //you have not given a hard file or set the trump char.
+				else { vertical = "F";  }
+			}
+
+            format = validParameter.validFile(parameters, "format", false);
+            if(format == "not found"){
+                if (countfile != "") { format = "count";    }
+                else { format = "name";                     }
+            }
+
+            if ((format != "name") && (format != "count")) {
+                m->mothurOut(format + " is not a valid format option. Options are count or name.");
+                if (countfile == "") { m->mothurOut("I will use name.\n"); format = "name"; }
+                else {  m->mothurOut("I will use count.\n"); format = "count"; }
+            }
+
+			temp = validParameter.validFile(parameters, "processors", false);	if (temp == "not found"){	temp = m->getProcessors();	}
+			m->setProcessors(temp);
+			m->mothurConvert(temp, processors);
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "QcSeqsCommand", "QcSeqsCommand");
+		exit(1);
+	}
+}
+//***************************************************************************************************************
+int QcSeqsCommand::execute(){
+	try{
+
+		if (abort == true) { if (calledHelp) { return 0; }  return 2;	}
+
+        int start = time(NULL);
+
+        map<string, string> variables;
+        variables["[filename]"] = outputDir + m->getRootName(m->getSimpleName(fastafile));
+        string summaryFile = getOutputFileName("summary", variables);
+        string accnosFile = getOutputFileName("accnos", variables);
+        string filterFile = getOutputFileName("filter", variables);
+        string outNameFile = getOutputFileName("name", variables);
+        string outCountFile = getOutputFileName("count", variables);
+        variables["[extension]"] = m->getExtension(fastafile);
+        string outFastaFile = getOutputFileName("fasta", variables);
+
+        map<string, string> names;
+        CountTable ct;
+        if (namefile != "") {
+            m->readNames(namefile, names);
+            for (map<string, string>::iterator it = names.begin(); it != names.end(); it++) { nameMap[it->first] = m->getNumNames(it->second); }
+        }
+        else if (countfile != "") {
+            ct.readTable(countfile, true, false);
+            nameMap = ct.getNameMap();
+        }
+
+        if (m->control_pressed) { return 0; }
+
+        //the filter is as long as the first sequence, like filter.seqs
+        alignmentLength = 0;
+        {
+            BlockReader first(fastafile, 1);
+            if (!first.eof()) { Sequence testSeq(first); alignmentLength = testSeq.getAlignLength(); }
+        }
+
+        F.setLength(alignmentLength);
+        if (soft != 0)			{  F.setSoft(soft);		}
+		if (trump != '*')		{  F.setTrump(trump);	}
+        if(trump != '*' || m->isTrue(vertical) || soft != 0){ F.initialize(); }
+
+        if(hard != "")	{	F.doHard(hard);		}
+		else			{	F.setFilter(string(alignmentLength, '1'));	}
+
+        bool countingColumns = (trump != '*' || m->isTrue(vertical) || soft != 0);
+
+        ofstream outSummary;
+        m->openOutputFile(summaryFile, outSummary);
+        outSummary << "seqname\tstart\tend\tnbases\tambigs\tpolymer\tnumSeqs" << endl;
+        outputNames.push_back(summaryFile); outputTypes["summary"].push_back(summaryFile);
+
+        //statistics passes, the summary and the cache are written by the first pass over the file
+        ofstream* summary = &outSummary;
+        SummaryCache cache(fastafile);
+        SummaryCache* newCache = &cache;
+        if (cache.read()) { newCache = NULL; }
+        
+        if ((optimize.size() != 0) && (newCache == NULL)) {
+            startPosition.clear(); endPosition.clear(); seqLength.clear(); ambigBases.clear(); longHomoPolymer.clear(); numNs.clear();
+            numSeqs = cache.fillSummary(((namefile != "") || (countfile != "")), nameMap, startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, numNs, &outSummary); summary = NULL;
+            numReads = 0;
+            for (map<int, long long>::iterator it = startPosition.begin(); it != startPosition.end(); it++) { numReads += it->second; }
+
+            if (m->control_pressed) { outputTypes.clear(); outSummary.close(); for (int i = 0; i < outputNames.size(); i++) { m->mothurRemove(outputNames[i]); } return 0; }
+
+            optimizeScreen();
+        }else if (optimize.size() != 0) {
+            m->mothurOut("Finding the screening statistics... "); m->mothurOutEndLine();
+            readFasta(false, false, summary, NULL, NULL, newCache); summary = NULL;
+
+            if (m->control_pressed) { outputTypes.clear(); outSummary.close(); for (int i = 0; i < outputNames.size(); i++) { m->mothurRemove(outputNames[i]); } return 0; }
+
+            optimizeScreen();
+        }
+
+        numFilterSeqs = 0;
+        if (countingColumns && !m->control_pressed) {
+            m->mothurOut("Creating Filter... "); m->mothurOutEndLine();
+            readFasta(true, true, summary, NULL, NULL, newCache); summary = NULL;
+        }
+
+        if (m->control_pressed) { outputTypes.clear(); outSummary.close(); for (int i = 0; i < outputNames.size(); i++) { m->mothurRemove(outputNames[i]); } return 0; }
+
+        F.setNumSeqs(numFilterSeqs);
+		if(m->isTrue(vertical) == 1)	{	F.doVertical();	}
+		if(soft != 0)				{	F.doSoft();		}
+		filter = F.getFilter();
+
+        int filteredLength = 0;
+		for(int i=0;i<alignmentLength;i++){ if(filter[i] == '1'){	filteredLength++;	} }
+        filtering = (filteredLength != alignmentLength);
+
+        ofstream outFilter;
+        m->openOutputFile(filterFile, outFilter);
+		outFilter << filter << endl;
+		outFilter.close();
+		outputNames.push_back(filterFile); outputTypes["filter"].push_back(filterFile);
+
+        //screen, filter and unique the sequences
+        ofstream outAccnos, outFasta;
+        m->openOutputFile(accnosFile, outAccnos); outputNames.push_back(accnosFile); outputTypes["accnos"].push_back(accnosFile);
+        m->openOutputFile(outFastaFile, outFasta); outputNames.push_back(outFastaFile); outputTypes["fasta"].push_back(outFastaFile);
+
+        m->mothurOut("Screening, filtering and finding unique sequences... "); m->mothurOutEndLine();
+        int numGood = readFasta(true, false, summary, &outAccnos, &outFasta, newCache);
+
+        outSummary.close(); outAccnos.close(); outFasta.close();
+
+        if ((namefile != "") || (countfile != "")) {
+            string type = "count";
+            if (namefile != "") { type = "name"; }
+            if (numSeqs != nameMap.size()) { // do fasta and name/count files match
+                m->mothurOut("[ERROR]: Your " + type + " file contains " + toString(nameMap.size()) + " unique sequences, but your fasta file contains " + toString(numSeqs) + ". File mismatch detected, quitting command.\n"); m->control_pressed = true;
+            }
+        }
+
+        if (m->control_pressed) { outputTypes.clear(); for (int i = 0; i < outputNames.size(); i++) { m->mothurRemove(outputNames[i]); } return 0; }
+
+        //print new names file
+		ofstream outNames;
+		if (format == "name") { m->openOutputFile(outNameFile, outNames); outputNames.push_back(outNameFile); outputTypes["name"].push_back(outNameFile);   }
+        else { m->openOutputFile(outCountFile, outNames); outputTypes["count"].push_back(outCountFile); outputNames.push_back(outCountFile);                }
+
+        CountTable newCt;
+        if ((countfile != "") && (format == "count")) { ct.printHeaders(outNames); }
+        else if ((countfile == "") && (format == "count")) { newCt.printHeaders(outNames); }
+
+		for (int i = 0; i < uniqueReads.size(); i++) {
+			if (m->control_pressed) { outputTypes.clear(); outNames.close(); for (int j = 0; j < outputNames.size(); j++) { m->mothurRemove(outputNames[j]); } return 0; }
+
+			vector<int>& reads = uniqueReads[i];
+			string repName = readNames[reads[0]];
+
+			if (format == "name") {
+				string dups = "";
+				for (int j = 0; j < reads.size(); j++) {
+					string name = readNames[reads[j]];
+					if (j != 0) { dups += ","; }
+
+					if (namefile != "") { dups += names[name]; }
+					else if (countfile != "") {
+						int num = ct.getNumSeqs(name);
+						dups += name + "_0";
+						for (int k = 1; k < num; k++) {  dups += "," + name + "_" + toString(k);  }
+					}else { dups += name; }
+				}
+
+				//get rep name
+				int pos = dups.find_first_of(',');
+				if (pos == string::npos) { outNames << dups << '\t' << dups << endl; } // only reps itself
+				else { outNames << dups.substr(0, pos) << '\t' << dups << endl; }
+			}else if (countfile != "") {
+				for (int j = 1; j < reads.size(); j++) { ct.mergeCounts(repName, readNames[reads[j]]); } //merges counts and saves in uniques name
+				ct.printSeq(outNames, repName);
+			}else {
+				int total = 0;
+				for (int j = 0; j < reads.size(); j++) {
+					if (namefile != "") { total += nameMap[readNames[reads[j]]]; }
+					else { total++; }
+				}
+				newCt.push_back(repName, total);
+				newCt.printSeq(outNames, repName);
+			}
+		}
+		outNames.close();
+
+        if (m->control_pressed) { outputTypes.clear(); for (int j = 0; j < outputNames.size(); j++) { m->mothurRemove(outputNames[j]); }  return 0; }
+
+        printSummary();
+
+        m->mothurOutEndLine();
+        m->mothurOut("Length of filtered alignment: " + toString(filteredLength)); m->mothurOutEndLine();
+		m->mothurOut("Number of columns removed: " + toString((alignmentLength-filteredLength))); m->mothurOutEndLine();
+		m->mothurOut("Length of the original alignment: " + toString(alignmentLength)); m->mothurOutEndLine();
+		m->mothurOut("Number of sequences used to construct filter: " + toString(numFilterSeqs)); m->mothurOutEndLine();
+
+        m->mothurOutEndLine();
+        m->mothurOut(toString(numGood) + " of " + toString(numSeqs) + " sequences passed the screen, leaving " + toString(uniqueReads.size()) + " unique sequences."); m->mothurOutEndLine();
+
+        m->mothurOutEndLine();
+		m->mothurOut("Output File Names: "); m->mothurOutEndLine();
+		for (int i = 0; i < outputNames.size(); i++) {	m->mothurOut(outputNames[i]); m->mothurOutEndLine();	}
+		m->mothurOutEndLine();
+
+        m->mothurOut("It took " + toString(time(NULL) - start) + " secs to process " + toString(numSeqs) + " sequences."); m->mothurOutEndLine();
+
+        //set fasta file as new current fastafile
+		string current = "";
+		itTypes = outputTypes.find("fasta");
+		if (itTypes != outputTypes.end()) {
+			if ((itTypes->second).size() != 0) { current = (itTypes->second)[0]; m->setFastaFile(current); }
+		}
+
+		itTypes = outputTypes.find("name");
+		if (itTypes != outputTypes.end()) {
+			if ((itTypes->second).size() != 0) { current = (itTypes->second)[0]; m->setNameFile(current); }
+		}
+
+        itTypes = outputTypes.find("count");
+		if (itTypes != outputTypes.end()) {
+			if ((itTypes->second).size() != 0) { current = (itTypes->second)[0]; m->setCountTableFile(current); }
+		}
+
+        itTypes = outputTypes.find("accnos");
+		if (itTypes != outputTypes.end()) {
+			if ((itTypes->second).size() != 0) { current = (itTypes->second)[0]; m->setAccnosFile(current); }
+		}
+
+        itTypes = outputTypes.find("summary");
+		if (itTypes != outputTypes.end()) {
+			if ((itTypes->second).size() != 0) { current = (itTypes->second)[0]; m->setSummaryFile(current); }
+		}
+
+		return 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "QcSeqsCommand", "execute");
+		exit(1);
+	}
+}
+/**************************************************************************************/
+//reads the fasta file in batches. The sequences of a batch are processed on the worker threads, then the main thread
+//writes their results in file order. Returns the number of good sequences.
+int QcSeqsCommand::readFasta(bool screening, bool countingColumns, ofstream* outSummary, ofstream* outAccnos, ofstream* outFasta, SummaryCache* cache) {
+	try {
+        bool filteringSeqs = (outFasta != NULL);
+        if (outSummary == NULL) { cache = NULL; } //only the first pass writes the cache
+
+        if (outSummary != NULL) {
+            numSeqs = 0; numReads = 0;
+            startPosition.clear(); endPosition.clear(); seqLength.clear(); ambigBases.clear(); longHomoPolymer.clear(); numNs.clear();
+        }
+
+        //each thread counts the columns of its own reads
+        vector<Filters> columnCounts;
+        if (countingColumns) {
+            columnCounts.resize(processors);
+            for (int i = 0; i < processors; i++) {
+                columnCounts[i].setLength(alignmentLength);
+                if (trump != '*') { columnCounts[i].setTrump(trump); }
+                columnCounts[i].initialize();
+                columnCounts[i].setFilter(string(alignmentLength, '1'));
+            }
+        }
+
+        FingerprintTable uniques(processors);
+        readNames.clear(); uniqueReads.clear();
+        vector<string> batchSeqs; vector<int> batchReads;
+
+        BlockReader in(fastafile, 1);
+
+        //the positions of records in a decompressed file cannot be used to find them again
+        if ((cache != NULL) && (in.isCompressed() || !cache->create())) { cache = NULL; }
+
+        vector<Sequence> seqs;
+        vector<unsigned long long> recordStarts;
+        vector<qcRead> reads;
+        int batchSize = 0;
+        int count = 0;
+        int numGood = 0;
+		while (!in.eof()) {
+
+			if (m->control_pressed) { break; }
+
+            unsigned long long recordStart = in.tell();
+			Sequence seq(in);
+			if (seq.getName() != "") { batchSize += seq.getAligned().length(); seqs.push_back(seq); recordStarts.push_back(recordStart); }
+
+			if ((batchSize < batchLength) && !in.eof()) { continue; }
+
+            reads.resize(seqs.size());
+            atomic<int> nextRead(0);
+            vector<thread*> workerThreads;
+            for (int i = 1; i < processors; i++) { workerThreads.push_back(new thread(&QcSeqsCommand::processReads, this, i, &seqs, &reads, &nextRead, screening, countingColumns, filteringSeqs, &columnCounts)); }
+            processReads(0, &seqs, &reads, &nextRead, screening, countingColumns, filteringSeqs, &columnCounts);
+            for (int i = 0; i < workerThreads.size(); i++) { workerThreads[i]->join(); delete workerThreads[i]; }
+
+            for (int i = 0; i < seqs.size(); i++) {
+                string name = seqs[i].getName();
+                qcRead& read = reads[i];
+
+                int num = 1;
+				if ((namefile != "") || (countfile != "")) {
+					//make sure this sequence is in the namefile, else error
+					map<string, int>::iterator it = nameMap.find(name);
+
+					if (it == nameMap.end()) { m->mothurOut("[ERROR]: '" + name + "' is not in your name or count file, please correct."); m->mothurOutEndLine(); m->control_pressed = true; }
+					else { num = it->second; }
+				}
+
+                if (outSummary != NULL) {
+                    startPosition[read.start] += num;
+                    endPosition[read.end] += num;
+                    seqLength[read.numBases] += num;
+                    ambigBases[read.ambigs] += num;
+                    longHomoPolymer[read.homop] += num;
+                    numNs[read.numNs] += num;
+                    numSeqs++; numReads += num;
+
+                    (*outSummary) << name << '\t' << read.start << '\t' << read.end << '\t' << read.numBases << '\t' << read.ambigs << '\t' << read.homop << '\t' << num << endl;
+                    if (cache != NULL) { cache->add(name, read.start, read.end, read.numBases, read.ambigs, read.homop, read.numNs, recordStarts[i]); }
+                }
+
+                if (read.wrongLength) { m->mothurOut("[ERROR]: " + name + " is " + toString(seqs[i].getAligned().length()) + " long, but the filter is " + toString(alignmentLength) + ". Sequences are not all the same length, please correct."); m->mothurOutEndLine(); m->control_pressed = true; }
+
+                if (read.trashCode != "") {
+                    if (outAccnos != NULL) { (*outAccnos) << name << '\t' << read.trashCode.substr(0, read.trashCode.length()-1) << endl; }
+                    continue;
+                }
+
+                if (screening) { numGood++; if (countingColumns) { numFilterSeqs++; } }
+                if (filteringSeqs) { batchReads.push_back(readNames.size()); readNames.push_back(name); batchSeqs.push_back(read.filtered); }
+            }
+            count += seqs.size();
+
+            if (filteringSeqs) { findUniques(uniques, batchSeqs, batchReads, *outFasta); }
+
+            seqs.clear(); recordStarts.clear(); reads.clear(); batchSize = 0;
+
+            //report progress
+            m->mothurOutJustToScreen(toString(count) + "\n");
+		}
+
+        if (cache != NULL) {
+            if (m->control_pressed) { cache->remove(); }
+            else { cache->close(); }
+        }
+
+        if (countingColumns) {
+            string trumpFilter = F.getFilter();
+            for (int i = 0; i < processors; i++) {
+                string threadFilter = columnCounts[i].getFilter();
+                for (int j = 0; j < alignmentLength; j++) {
+                    F.a[j] += columnCounts[i].a[j]; F.t[j] += columnCounts[i].t[j]; F.g[j] += columnCounts[i].g[j]; F.c[j] += columnCounts[i].c[j]; F.gap[j] += columnCounts[i].gap[j];
+                    if (threadFilter[j] == '0') { trumpFilter[j] = '0'; }
+                }
+            }
+            F.setFilter(trumpFilter);
+        }
+
+		return numGood;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "QcSeqsCommand", "readFasta");
+		exit(1);
+	}
+}
+/**************************************************************************************/
+void QcSeqsCommand::processReads(int thread, vector<Sequence>* seqs, vector<qcRead>* reads, atomic<int>* nextRead, bool screening, bool countingColumns, bool filteringSeqs, vector<Filters>* columnCounts) {
+	try {
+        int numSeqs = seqs->size();
+        bool gettingFreqs = (m->isTrue(vertical) || soft != 0);
+        while (true) {
+            int i = (*nextRead)++;
+            if (i >= numSeqs) { break; }
+
+            Sequence& seq = (*seqs)[i];
+            qcRead& read = (*reads)[i];
+
+            read.start = seq.getStartPos(); read.end = seq.getEndPos(); read.numBases = seq.getNumBases();
+            read.ambigs = seq.getAmbigBases(); read.homop = seq.getLongHomoPolymer(); read.numNs = seq.getNumNs();
+            read.trashCode = ""; read.filtered = ""; read.wrongLength = false;
+
+            if (!screening) { continue; }
+
+            //the screen.seqs tests, in the same order
+            if(startPos != -1 && startPos < read.start)			{	read.trashCode += "start|"; }
+            if(endPos != -1 && endPos > read.end)				{	read.trashCode += "end|";}
+            if(maxAmbig != -1 && maxAmbig <	read.ambigs)		{	read.trashCode += "ambig|";}
+            if(maxHomoP != -1 && maxHomoP < read.homop)         {	read.trashCode += "homop|";}
+            if(minLength > read.numBases)                       {	read.trashCode += "<length|";}
+            if(maxLength != -1 && maxLength < read.numBases)    {	read.trashCode += ">length|";}
+            if(maxN != -1 && maxN < read.numNs)                 {	read.trashCode += "n|"; }
+
+            if (read.trashCode != "") { continue; }
+
+            string aligned = seq.getAligned();
+
+            if (countingColumns) {
+                if (aligned.length() != alignmentLength) { read.wrongLength = true; continue; }
+                if(trump != '*')                        {	(*columnCounts)[thread].doTrump(seq);	}
+                if(gettingFreqs)                        {	(*columnCounts)[thread].getFreqs(seq);	}
+            }
+
+            if (!filteringSeqs) { continue; }
+
+            //filter.seqs stops on a sequence of the wrong length even when the filter keeps every column
+            if (aligned.length() != alignmentLength) { read.wrongLength = true; continue; }
+            if (!filtering) { read.filtered = aligned; continue; }
+
+            read.filtered.reserve(alignmentLength);
+            for(int j=0;j<alignmentLength;j++){
+                if(filter[j] == '1'){ read.filtered += aligned[j]; }
+            }
+
+            //unique.seqs reads the filtered sequence back in, which marks gaps at the ends as missing data
+            if ((read.filtered.length() != 0) && (read.filtered[0] == '-')) {
+                for (int j = 0; j < read.filtered.length(); j++) { if (read.filtered[j] == '-') { read.filtered[j] = '.'; } else { break; } }
+                for (int j = read.filtered.length()-1; j >= 0; j--) { if (read.filtered[j] == '-') { read.filtered[j] = '.'; } else { break; } }
+            }
+        }
+	}
+	catch(exception& e) {
+		m->errorOut(e, "QcSeqsCommand", "processReads");
+		exit(1);
+	}
+}
+/**************************************************************************************/
+void QcSeqsCommand::findUniques(FingerprintTable& uniques, vector<string>& seqs, vector<int>& reads, ofstream& outFasta) {
+	try {
+		vector<int> ids;
+		uniques.add(seqs, ids);
+
+		for (int i = 0; i < ids.size(); i++) {
+			if (ids[i] == uniqueReads.size()) { //this is a new unique sequence
+				outFasta << ">" << readNames[reads[i]] << endl << seqs[i] << endl;
+				uniqueReads.push_back(vector<int>(1, reads[i]));
+			}else { uniqueReads[ids[i]].push_back(reads[i]); } //this is a dup
+		}
+
+		seqs.clear(); reads.clear();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "QcSeqsCommand", "findUniques");
+		exit(1);
+	}
+}
+/**************************************************************************************/
+//the value of the index-th sequence if they were sorted by value
+static int getSortedValue(map<int, long long>& counts, long long index) {
+    long long total = 0;
+    for (map<int, long long>::iterator it = counts.begin(); it != counts.end(); it++) {
+        total += it->second;
+        if (total > index) { return it->first; }
+    }
+    return counts.rbegin()->first;
+}
+/**************************************************************************************/
+void QcSeqsCommand::optimizeScreen() {
+	try {
+        if (numReads == 0) { return; }
+
+		//optimize using all seqs, not just the uniques
+		long long criteriaPercentile	= (long long)(numReads * (criteria / (float) 100));
+        long long lowCriteriaPercentile = (long long)(numReads * ((100 - criteria) / (float) 100));
+
+		for (int i = 0; i < optimize.size(); i++) {
+			if (optimize[i] == "start") { startPos = getSortedValue(startPosition, criteriaPercentile); m->mothurOut("Optimizing start to " + toString(startPos) + "."); m->mothurOutEndLine(); }
+			else if (optimize[i] == "end") { endPos = getSortedValue(endPosition, lowCriteriaPercentile); m->mothurOut("Optimizing end to " + toString(endPos) + "."); m->mothurOutEndLine();}
+			else if (optimize[i] == "maxambig") { maxAmbig = getSortedValue(ambigBases, criteriaPercentile); m->mothurOut("Optimizing maxambig to " + toString(maxAmbig) + "."); m->mothurOutEndLine(); }
+			else if (optimize[i] == "maxhomop") { maxHomoP = getSortedValue(longHomoPolymer, criteriaPercentile); m->mothurOut("Optimizing maxhomop to " + toString(maxHomoP) + "."); m->mothurOutEndLine(); }
+            else if (optimize[i] == "minlength") { minLength = getSortedValue(seqLength, lowCriteriaPercentile); m->mothurOut("Optimizing minlength to " + toString(minLength) + "."); m->mothurOutEndLine(); if (minLength < 0) { m->control_pressed = true; } }
+			else if (optimize[i] == "maxlength") { maxLength = getSortedValue(seqLength, criteriaPercentile); m->mothurOut("Optimizing maxlength to " + toString(maxLength) + "."); m->mothurOutEndLine(); }
+            else if (optimize[i] == "maxn") { maxN = getSortedValue(numNs, criteriaPercentile); m->mothurOut("Optimizing maxn to " + toString(maxN) + "."); m->mothurOutEndLine(); }
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "QcSeqsCommand", "optimizeScreen");
+		exit(1);
+	}
+}
+/**************************************************************************************/
+//minimum, 2.5%, 25%, median, 75%, 97.5% and maximum, as summary.seqs finds them
+vector<int> QcSeqsCommand::getPercentiles(map<int, long long>& counts, double& mean) {
+	try {
+        long long ptile0_25	= 1+(long long)(numReads * 0.025);
+        long long ptile25	= 1+(long long)(numReads * 0.250);
+        long long ptile50	= 1+(long long)(numReads * 0.500);
+        long long ptile75	= 1+(long long)(numReads * 0.750);
+        long long ptile97_5	= 1+(long long)(numReads * 0.975);
+
+        vector<int> values(7, 0);
+        mean = 0;
+        if (counts.size() == 0) { return values; }
+
+        if ((counts.begin())->first != -1) { values[0] = (counts.begin())->first; }
+        for (int i = 1; i < 6; i++) { values[i] = values[0]; }
+
+        long long totalSoFar = 0;
+        long long lastValue = 0;
+        long long sum = 0;
+        for (map<int, long long>::iterator it = counts.begin(); it != counts.end(); it++) {
+            int value = it->first; if (value == -1) { value = 0; }
+            sum += (value*it->second);
+            totalSoFar += it->second;
+            if (((totalSoFar <= ptile0_25) && (totalSoFar > 1)) || ((lastValue < ptile0_25) && (totalSoFar > ptile0_25))){  values[1] = value;   }
+            if (((totalSoFar <= ptile25) && (totalSoFar > ptile0_25)) ||  ((lastValue < ptile25) && (totalSoFar > ptile25))) { values[2] = value;  }
+            if (((totalSoFar <= ptile50) && (totalSoFar > ptile25)) ||  ((lastValue < ptile50) && (totalSoFar > ptile50))) {  values[3] = value; }
+            if (((totalSoFar <= ptile75) && (totalSoFar > ptile50)) ||  ((lastValue < ptile75) && (totalSoFar > ptile75))) {  values[4] = value; }
+            if (((totalSoFar <= ptile97_5) && (totalSoFar > ptile75)) ||  ((lastValue < ptile97_5) && (totalSoFar > ptile97_5))) {  values[5] = value;  }
+            lastValue = totalSoFar;
+        }
+        values[6] = (counts.rbegin())->first;
+        mean = sum / (double) numReads;
+
+		return values;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "QcSeqsCommand", "getPercentiles");
+		exit(1);
+	}
+}
+/**************************************************************************************/
+void QcSeqsCommand::printSummary() {
+	try {
+        double meanStart, meanEnd, meanLength, meanAmbigs, meanHomop;
+        vector<int> starts = getPercentiles(startPosition, meanStart);
+        vector<int> ends = getPercentiles(endPosition, meanEnd);
+        vector<int> lengths = getPercentiles(seqLength, meanLength);
+        vector<int> ambigs = getPercentiles(ambigBases, meanAmbigs);
+        vector<int> homops = getPercentiles(longHomoPolymer, meanHomop);
+
+        vector<string> labels; labels.push_back("Minimum:\t"); labels.push_back("2.5%-tile:\t"); labels.push_back("25%-tile:\t"); labels.push_back("Median: \t"); labels.push_back("75%-tile:\t"); labels.push_back("97.5%-tile:\t"); labels.push_back("Maximum:\t");
+        vector<long long> ptiles; ptiles.push_back(1); ptiles.push_back(1+(long long)(numReads * 0.025)); ptiles.push_back(1+(long long)(numReads * 0.250)); ptiles.push_back(1+(long long)(numReads * 0.500)); ptiles.push_back(1+(long long)(numReads * 0.750)); ptiles.push_back(1+(long long)(numReads * 0.975)); ptiles.push_back(numReads);
+
+        m->mothurOutEndLine();
+		m->mothurOut("\t\tStart\tEnd\tNBases\tAmbigs\tPolymer\tNumSeqs"); m->mothurOutEndLine();
+        for (int i = 0; i < 7; i++) {
+            m->mothurOut(labels[i] + toString(starts[i]) + "\t" + toString(ends[i]) + "\t" + toString(lengths[i]) + "\t" + toString(ambigs[i]) + "\t" + toString(homops[i]) + "\t" + toString(ptiles[i])); m->mothurOutEndLine();
+        }
+		m->mothurOut("Mean:\t" + toString(meanStart) + "\t" + toString(meanEnd) + "\t" + toString(meanLength) + "\t" + toString(meanAmbigs) + "\t" + toString(meanHomop)); m->mothurOutEndLine();
+		if ((namefile == "") && (countfile == "")) {  m->mothurOut("# of Seqs:\t" + toString(numSeqs)); m->mothurOutEndLine(); }
+		else { m->mothurOut("# of unique seqs:\t" + toString(numSeqs)); m->mothurOutEndLine(); m->mothurOut("total # of seqs:\t" + toString(numReads)); m->mothurOutEndLine(); }
+	}
+	catch(exception& e) {
+		m->errorOut(e, "QcSeqsCommand", "printSummary");
+		exit(1);
+	}
+}
+/**************************************************************************************/
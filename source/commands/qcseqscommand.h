@@ -0,0 +1,85 @@
+//
+//  qcseqscommand.h
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__qcseqscommand__
+#define __Mothur__qcseqscommand__
+
+#include "command.hpp"
+#include "sequence.hpp"
+#include "counttable.h"
+#include "filters.h"
+#include "fingerprinttable.h"
+#include "summarycache.h"
+
+/* The qc.seqs command runs summary.seqs, screen.seqs, filter.seqs and unique.seqs on a fasta file in one pass.  Each batch of
+ sequences is summarized, screened and filtered on worker threads, and the good sequences are uniqued as they are read, so only
+ the final files are written.  When optimize is used, or the filter needs column counts, a statistics pass is made over the
+ file first, which writes nothing but the summary.  The first pass also writes the summary cache of the fasta file, and when
+ the cache is already there the statistics for optimize come from it. */
+
+/**************************************************************************************************/
+
+struct qcRead {
+    int start, end, numBases, ambigs, homop, numNs;
+    string trashCode; //empty if the sequence is good
+    string filtered;
+    bool wrongLength;
+};
+
+/**************************************************************************************************/
+
+class QcSeqsCommand : public Command {
+
+public:
+    QcSeqsCommand(string);
+    QcSeqsCommand();
+    ~QcSeqsCommand() {}
+
+    vector<string> setParameters();
+    string getCommandName()			{ return "qc.seqs";                 }
+    string getCommandCategory()		{ return "Sequence Processing";		}
+
+    string getHelpString();
+    string getOutputPattern(string);
+    string getCitation() { return "http://www.mothur.org/wiki/Qc.seqs"; }
+    string getDescription()		{ return "summarizes, screens, filters and uniques a fasta file in one pass"; }
+
+    int execute();
+    void help() { m->mothurOut(getHelpString()); }
+
+private:
+    bool abort;
+    string fastafile, namefile, countfile, outputDir, format, hard, vertical;
+    int processors, startPos, endPos, maxAmbig, maxHomoP, minLength, maxLength, maxN, criteria, alignmentLength;
+    float soft;
+    char trump;
+    vector<string> optimize, outputNames;
+
+    map<string, int> nameMap; //unique name -> number of sequences it represents
+    map<int, long long> startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, numNs;
+    long long numSeqs, numReads;
+
+    Filters F;
+    string filter;
+    bool filtering; //false if the filter keeps every column
+    long long numFilterSeqs;
+
+    //good reads are numbered in file order, each unique keeps the numbers of its reads with the representative first
+    vector<string> readNames;
+    vector< vector<int> > uniqueReads;
+
+    int readFasta(bool, bool, ofstream*, ofstream*, ofstream*, SummaryCache*); //screening, counting columns, summary, accnos, fasta, cache to write
+    void processReads(int, vector<Sequence>*, vector<qcRead>*, atomic<int>*, bool, bool, bool, vector<Filters>*);
+    void findUniques(FingerprintTable&, vector<string>&, vector<int>&, ofstream&);
+    void optimizeScreen();
+    void printSummary();
+    vector<int> getPercentiles(map<int, long long>&, double&);
+};
+
+/**************************************************************************************************/
+
+#endif
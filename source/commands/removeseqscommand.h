@@ -11,6 +11,7 @@
  */
  
 #include "command.hpp"
+#include "summarycache.h"
 
 class RemoveSeqsCommand : public Command {
 	
@@ -1754,10 +1754,25 @@ int ScreenSeqsCommand::getSummary(vector<unsigned long long>& positions){
 
 		int numSeqs = 0;
 		
-        if(processors == 1){
-            numSeqs = driverCreateSummary(startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, numNs, fastafile, lines[0]);
+        //a summary.seqs, qc.seqs or screen.seqs run on this fasta file leaves a cache, so the file does not need to be read again
+        SummaryCache cache(fastafile);
+        if (cache.read()) {
+            map<int, long long> starts, ends, lengths, ambigs, homops, ns;
+            numSeqs = cache.fillSummary(((namefile != "") || (countfile != "")), nameMap, starts, ends, lengths, ambigs, homops, ns, NULL);
+            
+            //each value once for every read that has it
+            for (map<int, long long>::iterator it = starts.begin(); it != starts.end(); it++)   { startPosition.insert(startPosition.end(), it->second, it->first);     }
+            for (map<int, long long>::iterator it = ends.begin(); it != ends.end(); it++)       { endPosition.insert(endPosition.end(), it->second, it->first);         }
+            for (map<int, long long>::iterator it = lengths.begin(); it != lengths.end(); it++) { seqLength.insert(seqLength.end(), it->second, it->first);             }
+            for (map<int, long long>::iterator it = ambigs.begin(); it != ambigs.end(); it++)   { ambigBases.insert(ambigBases.end(), it->second, it->first);           }
+            for (map<int, long long>::iterator it = homops.begin(); it != homops.end(); it++)   { longHomoPolymer.insert(longHomoPolymer.end(), it->second, it->first); }
+            for (map<int, long long>::iterator it = ns.begin(); it != ns.end(); it++)           { numNs.insert(numNs.end(), it->second, it->first);                     }
+        }else if(processors == 1){
+            cache.create();
+            numSeqs = driverCreateSummary(startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, numNs, fastafile, lines[0], &cache);
+            if (m->control_pressed) { cache.remove(); } else { cache.close(); }
         }else{
-            numSeqs = createProcessesCreateSummary(startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, numNs, fastafile);
+            numSeqs = createProcessesCreateSummary(startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, numNs, fastafile, &cache);
         }
         
         if (m->control_pressed) {  return 0; }
@@ -1791,7 +1806,7 @@ int ScreenSeqsCommand::getSummary(vector<unsigned long long>& positions){
 	}
 }
 /**************************************************************************************/
-int ScreenSeqsCommand::driverCreateSummary(vector<int>& startPosition, vector<int>& endPosition, vector<int>& seqLength, vector<int>& ambigBases, vector<int>& longHomoPolymer, vector<int>& numNs, string filename, linePair filePos) {	
+int ScreenSeqsCommand::driverCreateSummary(vector<int>& startPosition, vector<int>& endPosition, vector<int>& seqLength, vector<int>& ambigBases, vector<int>& longHomoPolymer, vector<int>& numNs, string filename, linePair filePos, SummaryCache* cache) {	
 	try {
 		
 		ifstream in;
@@ -1811,6 +1826,7 @@ int ScreenSeqsCommand::driverCreateSummary(vector<int>& startPosition, vector<in
 				
 			if (m->control_pressed) { in.close(); return 1; }
 					
+            unsigned long long recordStart = in.tellg();
 			Sequence current(in); m->gobble(in);
 	
 			if (current.getName() != "") {
@@ -1835,6 +1851,8 @@ int ScreenSeqsCommand::driverCreateSummary(vector<int>& startPosition, vector<in
 					longHomoPolymer.push_back(current.getLongHomoPolymer());
                     numNs.push_back(numns);
 				}
+                
+                if (cache != NULL) { cache->add(current.getName(), current.getStartPos(), current.getEndPos(), current.getNumBases(), current.getAmbigBases(), current.getLongHomoPolymer(), numns, recordStart); }
 				
 				count++;
 			}
@@ -1858,7 +1876,7 @@ int ScreenSeqsCommand::driverCreateSummary(vector<int>& startPosition, vector<in
 	}
 }
 /**************************************************************************************************/
-int ScreenSeqsCommand::createProcessesCreateSummary(vector<int>& startPosition, vector<int>& endPosition, vector<int>& seqLength, vector<int>& ambigBases, vector<int>& longHomoPolymer, vector<int>& numNs, string filename) {
+int ScreenSeqsCommand::createProcessesCreateSummary(vector<int>& startPosition, vector<int>& endPosition, vector<int>& seqLength, vector<int>& ambigBases, vector<int>& longHomoPolymer, vector<int>& numNs, string filename, SummaryCache* cache) {
 	try {
         
         int process = 1;
@@ -1876,7 +1894,10 @@ int ScreenSeqsCommand::createProcessesCreateSummary(vector<int>& startPosition,
 				processIDS.push_back(pid);  //create map from line number to pid so you can append files in correct order later
 				process++;
 			}else if (pid == 0){
-				num = driverCreateSummary(startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, numNs, fastafile, lines[process]);
+				SummaryCache part(fastafile);
+				part.createPart(fastafile + m->mothurGetpid(process) + ".stats.temp");
+				num = driverCreateSummary(startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, numNs, fastafile, lines[process], &part);
+				if (m->control_pressed) { part.remove(); } else { part.close(); }
 				
 				//pass numSeqs to parent
 				ofstream out;
@@ -1906,6 +1927,7 @@ int ScreenSeqsCommand::createProcessesCreateSummary(vector<int>& startPosition,
                 m->control_pressed = false;
                 for (int i=0;i<processIDS.size();i++) {
                     m->mothurRemove(contigsreport + (toString(processIDS[i]) + ".num.temp"));
+                    m->mothurRemove(fastafile + (toString(processIDS[i]) + ".stats.temp"));
                 }
                 recalc = true;
                 break;
@@ -1940,7 +1962,10 @@ int ScreenSeqsCommand::createProcessesCreateSummary(vector<int>& startPosition,
                     processIDS.push_back(pid);  //create map from line number to pid so you can append files in correct order later
                     process++;
                 }else if (pid == 0){
-                    num = driverCreateSummary(startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, numNs, fastafile, lines[process]);
+                    SummaryCache part(fastafile);
+                    part.createPart(fastafile + m->mothurGetpid(process) + ".stats.temp");
+                    num = driverCreateSummary(startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, numNs, fastafile, lines[process], &part);
+                    if (m->control_pressed) { part.remove(); } else { part.close(); }
                     
                     //pass numSeqs to parent
                     ofstream out;
@@ -1968,7 +1993,9 @@ int ScreenSeqsCommand::createProcessesCreateSummary(vector<int>& startPosition,
         }
 
 		
-		num = driverCreateSummary(startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, numNs, fastafile, lines[0]);
+		//do your part, the first part of the file goes straight into the cache
+		cache->create();
+		num = driverCreateSummary(startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, numNs, fastafile, lines[0], cache);
 		
 		//force parent to wait until all the processes are done
 		for (int i=0;i<processIDS.size();i++) { 
@@ -1994,7 +2021,9 @@ int ScreenSeqsCommand::createProcessesCreateSummary(vector<int>& startPosition,
 				
 			in.close();
 			m->mothurRemove(tempFilename);
+			cache->appendPart(fastafile + toString(processIDS[i]) + ".stats.temp");
 		}
+		if (m->control_pressed) { cache->remove(); } else { cache->close(); }
 		
 		
 #else 
@@ -2021,7 +2050,7 @@ int ScreenSeqsCommand::createProcessesCreateSummary(vector<int>& startPosition,
 		}
 		
         //do your part
-		num = driverCreateSummary(startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, numNs, fastafile, lines[processors-1]);
+		num = driverCreateSummary(startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, numNs, fastafile, lines[processors-1], NULL);
          
 		//Wait until all threads have terminated.
 		WaitForMultipleObjects(processors-1, hThreadArray, TRUE, INFINITE);
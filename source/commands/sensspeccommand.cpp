@@ -359,6 +359,27 @@ int SensSpecCommand::process(ListVector*& list, bool& getCutoff, string& origCut
 			}
 			phylipFile.close();
 		}
+		else if((format == "column") && BinaryDistanceFile::isBinary(distFile)){
+			
+			BinaryDistanceFile dists(distFile);
+			
+			for (unsigned long long k = 0; k < dists.getNumDists(); k++) {
+				if (m->control_pressed) { return 0; }
+				
+				if(dists.getDist(k) < cutoff){
+					string seqNameA = dists.getName(dists.getRow(k));
+					string seqNameB = dists.getName(dists.getColumn(k));
+					
+					string seqNamePair;
+					if(seqNameA <= seqNameB){
+						seqNamePair = seqNameA + '-' + seqNameB;
+					} else {
+						seqNamePair = seqNameB + '-' + seqNameA;
+					}
+                    distanceMap.insert(seqNamePair);
+				}
+			}
+		}
 		else if(format == "column"){
 
 			ifstream columnFile;
@@ -15,6 +15,7 @@
 #include "command.hpp"
 #include "listvector.hpp"
 #include "inputdata.h"
+#include "binarydistancefile.h"
 
 class SensSpecCommand : public Command {
 
@@ -215,7 +215,17 @@ int SeqSummaryCommand::execute(){
 		
 		if (m->control_pressed) { return 0; }
 			
-
+        //the cache written by an earlier summary of this fasta file has everything we need
+        SummaryCache cache(fastafile);
+        if (cache.read()) {
+            ofstream outSummary;
+            m->openOutputFile(summaryFile, outSummary);
+            outSummary << "seqname\tstart\tend\tnbases\tambigs\tpolymer\tnumSeqs" << endl;
+            
+            map<int, long long> numNs;
+            numSeqs = cache.fillSummary(((namefile != "") || (countfile != "")), nameMap, startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, numNs, &outSummary);
+            outSummary.close();
+        }else {
 			vector<unsigned long long> positions; 
 			#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
 				positions = m->divideFile(fastafile, processors);
@@ -235,10 +245,13 @@ int SeqSummaryCommand::execute(){
 			
 
 			if(processors == 1){
-				numSeqs = driverCreateSummary(startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, fastafile, summaryFile, lines[0]);
+                cache.create();
+				numSeqs = driverCreateSummary(startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, fastafile, summaryFile, lines[0], &cache);
+                if (m->control_pressed) { cache.remove(); } else { cache.close(); }
 			}else{
-				numSeqs = createProcessesCreateSummary(startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, fastafile, summaryFile); 
+				numSeqs = createProcessesCreateSummary(startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, fastafile, summaryFile, &cache); 
 			}
+        }
 			
 			if (m->control_pressed) {  return 0; }
 			
@@ -420,7 +433,7 @@ int SeqSummaryCommand::execute(){
 	}
 }
 /**************************************************************************************/
- long long SeqSummaryCommand::driverCreateSummary(map<int, long long>& startPosition, map<int,  long long>& endPosition, map<int,  long long>& seqLength, map<int,  long long>& ambigBases, map<int,  long long>& longHomoPolymer, string filename, string sumFile, linePair* filePos) {
+ long long SeqSummaryCommand::driverCreateSummary(map<int, long long>& startPosition, map<int,  long long>& endPosition, map<int,  long long>& seqLength, map<int,  long long>& ambigBases, map<int,  long long>& longHomoPolymer, string filename, string sumFile, linePair* filePos, SummaryCache* cache) {
 	try {
 		
 		ofstream outSummary;
@@ -447,6 +460,7 @@ int SeqSummaryCommand::execute(){
             
             if (m->debug) { m->mothurOut("[DEBUG]: count = " + toString(count) + "\n");  }
             
+            unsigned long long recordStart = in.tellg();
 			Sequence current(in); m->gobble(in);
            
 			if (current.getName() != "") {
@@ -493,6 +507,8 @@ int SeqSummaryCommand::execute(){
 				outSummary << thisSeqLength << '\t' << thisAmbig << '\t';
 				outSummary << thisHomoP << '\t' << num << endl;
                 
+                if (cache != NULL) { cache->add(current.getName(), thisStartPosition, thisEndPosition, thisSeqLength, thisAmbig, thisHomoP, current.getNumNs(), recordStart); }
+                
                 if (m->debug) { m->mothurOut("[DEBUG]: " + current.getName() + '\t' + toString(num) + "\n");  }
 			}
 			
@@ -514,7 +530,7 @@ int SeqSummaryCommand::execute(){
 	}
 }
 /**************************************************************************************************/
- long long SeqSummaryCommand::createProcessesCreateSummary(map<int, long long>& startPosition, map<int, long long>& endPosition, map<int,  long long>& seqLength, map<int,  long long>& ambigBases, map<int,  long long>& longHomoPolymer, string filename, string sumFile) {
+ long long SeqSummaryCommand::createProcessesCreateSummary(map<int, long long>& startPosition, map<int, long long>& endPosition, map<int,  long long>& seqLength, map<int,  long long>& ambigBases, map<int,  long long>& longHomoPolymer, string filename, string sumFile, SummaryCache* cache) {
 	try {
 		int process = 1;
 		int num = 0;
@@ -531,7 +547,10 @@ int SeqSummaryCommand::execute(){
 				processIDS.push_back(pid);  //create map from line number to pid so you can append files in correct order later
 				process++;
 			}else if (pid == 0){
-				num = driverCreateSummary(startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, fastafile, sumFile + m->mothurGetpid(process) + ".temp", lines[process]);
+				SummaryCache part(fastafile);
+				part.createPart(sumFile + m->mothurGetpid(process) + ".stats.temp");
+				num = driverCreateSummary(startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, fastafile, sumFile + m->mothurGetpid(process) + ".temp", lines[process], &part);
+				if (m->control_pressed) { part.remove(); } else { part.close(); }
 				
 				//pass numSeqs to parent
 				ofstream out;
@@ -564,6 +583,7 @@ int SeqSummaryCommand::execute(){
                 for (int i=0;i<processIDS.size();i++) {
                     m->mothurRemove(fastafile + (toString(processIDS[i]) + ".num.temp"));
                     m->mothurRemove(sumFile + (toString(processIDS[i]) + ".temp"));
+                    m->mothurRemove(sumFile + (toString(processIDS[i]) + ".stats.temp"));
                 }
                 recalc = true;
                 break;
@@ -597,7 +617,10 @@ int SeqSummaryCommand::execute(){
                     processIDS.push_back(pid);  //create map from line number to pid so you can append files in correct order later
                     process++;
                 }else if (pid == 0){
-                    num = driverCreateSummary(startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, fastafile, sumFile + m->mothurGetpid(process) + ".temp", lines[process]);
+                    SummaryCache part(fastafile);
+                    part.createPart(sumFile + m->mothurGetpid(process) + ".stats.temp");
+                    num = driverCreateSummary(startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, fastafile, sumFile + m->mothurGetpid(process) + ".temp", lines[process], &part);
+                    if (m->control_pressed) { part.remove(); } else { part.close(); }
                     
                     //pass numSeqs to parent
                     ofstream out;
@@ -627,8 +650,9 @@ int SeqSummaryCommand::execute(){
         }
 
         
-		//do your part
-		num = driverCreateSummary(startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, fastafile, sumFile, lines[0]);
+		//do your part, the first part of the file goes straight into the cache
+		cache->create();
+		num = driverCreateSummary(startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, fastafile, sumFile, lines[0], cache);
 
 		//force parent to wait until all the processes are done
 		for (int i=0;i<processIDS.size();i++) { 
@@ -695,7 +719,9 @@ int SeqSummaryCommand::execute(){
 			
 			m->appendFiles((sumFile + toString(processIDS[i]) + ".temp"), sumFile);
 			m->mothurRemove((sumFile + toString(processIDS[i]) + ".temp"));
+			cache->appendPart(sumFile + toString(processIDS[i]) + ".stats.temp");
 		}
+		if (m->control_pressed) { cache->remove(); } else { cache->close(); }
 		
 #else
 		//////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -726,7 +752,7 @@ int SeqSummaryCommand::execute(){
 		}
 		
         //do your part
-		num = driverCreateSummary(startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, fastafile, (sumFile+toString(processors-1)+".temp"), lines[processors-1]);
+		num = driverCreateSummary(startPosition, endPosition, seqLength, ambigBases, longHomoPolymer, fastafile, (sumFile+toString(processors-1)+".temp"), lines[processors-1], NULL);
         processIDS.push_back(processors-1);
 
 		//Wait until all threads have terminated.
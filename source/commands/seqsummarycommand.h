@@ -13,6 +13,7 @@
 #include "mothur.h"
 #include "command.hpp"
 #include "sequence.hpp"
+#include "summarycache.h"
 
 /**************************************************************************************************/
 
@@ -43,8 +44,8 @@ private:
 	vector<linePair*> lines;
 	vector<int> processIDS;
 	
-	long long createProcessesCreateSummary(map<int, long long>&, map<int,  long long>&, map<int,  long long>&, map<int,  long long>&, map<int,  long long>&, string, string);
-	long long driverCreateSummary(map<int, long long>&, map<int,  long long>&, map<int,  long long>&, map<int,  long long>&, map<int,  long long>&, string, string, linePair*);
+	long long createProcessesCreateSummary(map<int, long long>&, map<int,  long long>&, map<int,  long long>&, map<int,  long long>&, map<int,  long long>&, string, string, SummaryCache*);
+	long long driverCreateSummary(map<int, long long>&, map<int,  long long>&, map<int,  long long>&, map<int,  long long>&, map<int,  long long>&, string, string, linePair*, SummaryCache*);
 
 
 };
@@ -395,7 +395,10 @@ int ShhherCommand::execute(){
 		
         int numFiles = flowFileVector.size();
 		
-        if (numFiles < processors) { processors = numFiles; }
+        //each file gets its own process, the processors left over calculate the distances of a file with threads
+        if ((numFiles > 0) && (numFiles < processors)) { distProcessors = processors / numFiles; processors = numFiles; }
+        else { distProcessors = 1; }
+        if (distProcessors < 1) { distProcessors = 1; }
         
 #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
         if (processors == 1) { driver(flowFileVector, compositeFASTAFileName, compositeNamesFileName); }
@@ -760,24 +763,22 @@ int ShhherCommand::driver(vector<string> filenames, string thisCompositeFASTAFil
                 if (m->control_pressed) { break; }
                 
                 m->mothurOut("Calculating distances between flowgrams...\n");
-                string distFileName = flowFileName.substr(0,flowFileName.find_last_of('.')) + ".shhh.dist";
                 begTime = time(NULL);
                
                 
-                flowDistParentFork(numFlowCells, distFileName, numUniques, mapUniqueToSeq, mapSeqToUnique, lengths, flowDataPrI, flowDataIntI);
+                SparseDistanceMatrix* matrix = flowDistances(numFlowCells, numUniques, mapUniqueToSeq, lengths, flowDataPrI, flowDataIntI);
                 
                 m->mothurOutEndLine();
                 m->mothurOut("Total time: " + toString(time(NULL) - begTime) + '\t' + toString((clock() - begClock)/CLOCKS_PER_SEC) + '\n');
                 
                 
-                string namesFileName = flowFileName.substr(0,flowFileName.find_last_of('.')) + ".shhh.names";
-                createNamesFile(numSeqs, numUniques, namesFileName, seqNameVector, mapSeqToUnique, mapUniqueToSeq);
+                ListVector* list = getUniqueList(numSeqs, numUniques, seqNameVector, mapSeqToUnique);
                 
-                if (m->control_pressed) { break; }
+                if (m->control_pressed) { delete matrix; delete list; break; }
                 
                 m->mothurOut("\nClustering flowgrams...\n");
-                string listFileName = flowFileName.substr(0,flowFileName.find_last_of('.')) + ".shhh.list";
-                cluster(listFileName, distFileName, namesFileName);
+                stringstream listStream;
+                cluster(listStream, list, matrix);
                 
                 if (m->control_pressed) { break; }
                 
@@ -790,14 +791,10 @@ int ShhherCommand::driver(vector<string> filenames, string thisCompositeFASTAFil
                 vector<int> seqIndex;		//tMaster->anI;		the index that corresponds to seqNumber
                 
                 
-                int numOTUs = getOTUData(numSeqs, listFileName, otuData, cumNumSeqs, nSeqsPerOTU, aaP, aaI, seqNumber, seqIndex, nameMap);
+                int numOTUs = getOTUData(numSeqs, listStream, otuData, cumNumSeqs, nSeqsPerOTU, aaP, aaI, seqNumber, seqIndex, nameMap);
                 
                 if (m->control_pressed) { break; }
                 
-                m->mothurRemove(distFileName);
-                m->mothurRemove(namesFileName);
-                m->mothurRemove(listFileName);
-                
                 vector<double> dist;		//adDist - distance of sequences to centroids
                 vector<short> change;		//did the centroid sequence change? 0 = no; 1 = yes
                 vector<int> centroids;		//the representative flowgram for each cluster m
@@ -1017,87 +1014,118 @@ int ShhherCommand::getFlowData(string filename, vector<string>& thisSeqNameVecto
 }
 /**************************************************************************************************/
 
-int ShhherCommand::flowDistParentFork(int numFlowCells, string distFileName, int stopSeq, vector<int>& mapUniqueToSeq, vector<int>& mapSeqToUnique, vector<int>& lengths, vector<double>& flowDataPrI, vector<short>& flowDataIntI){
-	try{		
-        
-		ostringstream outStream;
-		outStream.setf(ios::fixed, ios::floatfield);
-		outStream.setf(ios::dec, ios::basefield);
-		outStream.setf(ios::showpoint);
-		outStream.precision(6);
+//fills the sparse matrix cluster() needs directly, rows are handed to the threads one at a time so the long rows at the end stay balanced
+SparseDistanceMatrix* ShhherCommand::flowDistances(int numFlowCells, int stopSeq, vector<int>& mapUniqueToSeq, vector<int>& lengths, vector<double>& flowDataPrI, vector<short>& flowDataIntI){
+	try{
+		//the kernel reads the intensities as float, same as the old per element conversion
+		vector<float> flowDataPrF(flowDataPrI.begin(), flowDataPrI.end());
+		
+		vector< vector<PDistCell> > rows(stopSeq);
+		atomic<int> nextRow(0);
+		mutex printLock;
 		
 		int begTime = time(NULL);
 		double begClock = clock();
-        
-		for(int i=0;i<stopSeq;i++){
-			
+		
+		int numThreads = distProcessors;
+		if (numThreads > stopSeq) { numThreads = stopSeq; }
+		if (numThreads < 1) { numThreads = 1; }
+		
+		vector<thread*> workerThreads;
+		for (int i = 1; i < numThreads; i++) {
+			workerThreads.push_back(new thread(&ShhherCommand::flowDistThread, this, numFlowCells, stopSeq, ref(mapUniqueToSeq), ref(lengths), ref(flowDataPrF), ref(flowDataIntI), ref(rows), ref(nextRow), ref(printLock), begTime, begClock));
+		}
+		flowDistThread(numFlowCells, stopSeq, mapUniqueToSeq, lengths, flowDataPrF, flowDataIntI, rows, nextRow, printLock, begTime, begClock);
+		
+		for (int i = 0; i < workerThreads.size(); i++) {
+			workerThreads[i]->join();
+			delete workerThreads[i];
+		}
+		
+		//cells are added in the order ReadColumnMatrix added them from the column file, so clustering ties break the same way
+		SparseDistanceMatrix* matrix = new SparseDistanceMatrix();
+		matrix->resize(stopSeq);
+		for (int i = 0; i < stopSeq; i++) {
 			if (m->control_pressed) { break; }
 			
-			for(int j=0;j<i;j++){
-				float flowDistance = calcPairwiseDist(numFlowCells, mapUniqueToSeq[i], mapUniqueToSeq[j], mapSeqToUnique, lengths, flowDataPrI, flowDataIntI);
-                
-				if(flowDistance < 1e-6){
-					outStream << mapUniqueToSeq[i] << '\t' << mapUniqueToSeq[j] << '\t' << 0.000000 << endl;
-				}
-				else if(flowDistance <= cutoff){
-					outStream << mapUniqueToSeq[i] << '\t' << mapUniqueToSeq[j] << '\t' << flowDistance << endl;
-				}
-			}
-			if(i % 100 == 0){
-				m->mothurOutJustToScreen(toString(i) + "\t" + toString(time(NULL) - begTime));
-				m->mothurOutJustToScreen("\t" + toString((clock()-begClock)/CLOCKS_PER_SEC)+"\n");
+			for (int j = 0; j < rows[i].size(); j++) {
+				PDistCell value(i, rows[i][j].dist);
+				matrix->addCell(rows[i][j].index, value);
 			}
+			vector<PDistCell> empty; rows[i].swap(empty);
 		}
 		
-		ofstream distFile(distFileName.c_str());
-		distFile << outStream.str();		
-		distFile.close();
-		
 		if (m->control_pressed) {}
 		else {
 			m->mothurOutJustToScreen(toString(stopSeq-1) + "\t" + toString(time(NULL) - begTime));
 			m->mothurOutJustToScreen("\t" + toString((clock()-begClock)/CLOCKS_PER_SEC)+"\n");
 		}
         
-        return 0;
+        return matrix;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "ShhherCommand", "flowDistParentFork");
+		m->errorOut(e, "ShhherCommand", "flowDistances");
 		exit(1);
 	}
 }
 /**************************************************************************************************/
 
-float ShhherCommand::calcPairwiseDist(int numFlowCells, int seqA, int seqB, vector<int>& mapSeqToUnique, vector<int>& lengths, vector<double>& flowDataPrI, vector<short>& flowDataIntI){
+void ShhherCommand::flowDistThread(int numFlowCells, int stopSeq, vector<int>& mapUniqueToSeq, vector<int>& lengths, vector<float>& flowDataPrF, vector<short>& flowDataIntI, vector< vector<PDistCell> >& rows, atomic<int>& nextRow, mutex& printLock, int begTime, double begClock){
 	try{
-		int minLength = lengths[mapSeqToUnique[seqA]];
-		if(lengths[seqB] < minLength){	minLength = lengths[mapSeqToUnique[seqB]];	}
-		
-		int ANumFlowCells = seqA * numFlowCells;
-		int BNumFlowCells = seqB * numFlowCells;
+		const double* joint = &jointLookUp[0];
 		
-		float dist = 0;
-		
-		for(int i=0;i<minLength;i++){
+		while (!m->control_pressed) {
+			int i = nextRow++;
+			if (i >= stopSeq) { break; }
 			
-			if (m->control_pressed) { break; }
+			int seqA = mapUniqueToSeq[i];
+			const short* intA = &flowDataIntI[seqA * numFlowCells];
+			const float* prA = &flowDataPrF[seqA * numFlowCells];
 			
-			int flowAIntI = flowDataIntI[ANumFlowCells + i];
-			float flowAPrI = flowDataPrI[ANumFlowCells + i];
+			for(int j=0;j<i;j++){
+				int seqB = mapUniqueToSeq[j];
+				
+				int minLength = lengths[i];
+				if(lengths[seqB] < minLength){	minLength = lengths[j];	}
+				
+				float flowDistance = calcPairwiseDist(intA, prA, &flowDataIntI[seqB * numFlowCells], &flowDataPrF[seqB * numFlowCells], minLength, joint);
+				
+				//the distances used to go through a column file written with 6 decimals, round them the same way
+				if(flowDistance < 1e-6){
+					flowDistance = 0;
+				}
+				else if(flowDistance <= cutoff){
+					flowDistance = (float)(nearbyint((double)flowDistance * 1000000.0) / 1000000.0);
+				}
+				else { continue; }
+				
+				if (flowDistance < cutoff) { rows[i].push_back(PDistCell(j, flowDistance)); }
+			}
 			
-			int flowBIntI = flowDataIntI[BNumFlowCells + i];
-			float flowBPrI = flowDataPrI[BNumFlowCells + i];
-			dist += jointLookUp[flowAIntI * NUMBINS + flowBIntI] - flowAPrI - flowBPrI;
+			if(i % 100 == 0){
+				lock_guard<mutex> guard(printLock);
+				m->mothurOutJustToScreen(toString(i) + "\t" + toString(time(NULL) - begTime));
+				m->mothurOutJustToScreen("\t" + toString((clock()-begClock)/CLOCKS_PER_SEC)+"\n");
+			}
 		}
-		
-		dist /= (float) minLength;
-		return dist;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "ShhherCommand", "calcPairwiseDist");
+		m->errorOut(e, "ShhherCommand", "flowDistThread");
 		exit(1);
 	}
 }
+/**************************************************************************************************/
+//flowgrams are contiguous rows of intensities and their -log probabilities, joint is the jointLookUp table
+float ShhherCommand::calcPairwiseDist(const short* flowAIntI, const float* flowAPrI, const short* flowBIntI, const float* flowBPrI, int minLength, const double* joint){
+	float dist = 0;
+	
+	for(int i=0;i<minLength;i++){
+		dist += joint[flowAIntI[i] * NUMBINS + flowBIntI[i]] - flowAPrI[i] - flowBPrI[i];
+	}
+	
+	dist /= (float) minLength;
+	return dist;
+}
 
 /**************************************************************************************************/
 
@@ -1176,7 +1204,8 @@ int ShhherCommand::getUniques(int numSeqs, int numFlowCells, vector<short>& uniq
 	}
 }
 /**************************************************************************************************/
-int ShhherCommand::createNamesFile(int numSeqs, int numUniques, string filename, vector<string>& seqNameVector, vector<int>& mapSeqToUnique, vector<int>& mapUniqueToSeq){
+//one bin per unique flowgram holding the names of its duplicates, the list the names file used to give ReadColumnMatrix
+ListVector* ShhherCommand::getUniqueList(int numSeqs, int numUniques, vector<string>& seqNameVector, vector<int>& mapSeqToUnique){
 	try{
 		
 		vector<string> duplicateNames(numUniques, "");
@@ -1184,44 +1213,27 @@ int ShhherCommand::createNamesFile(int numSeqs, int numUniques, string filename,
 			duplicateNames[mapSeqToUnique[i]] += seqNameVector[i] + ',';
 		}
 		
-		ofstream nameFile;
-		m->openOutputFile(filename, nameFile);
+		ListVector* list = new ListVector();
 		
 		for(int i=0;i<numUniques;i++){
 			
 			if (m->control_pressed) { break; }
 			
-            //			nameFile << seqNameVector[mapUniqueToSeq[i]] << '\t' << duplicateNames[i].substr(0, duplicateNames[i].find_last_of(',')) << endl;
-			nameFile << mapUniqueToSeq[i] << '\t' << duplicateNames[i].substr(0, duplicateNames[i].find_last_of(',')) << endl;
+			list->push_back(duplicateNames[i].substr(0, duplicateNames[i].find_last_of(',')));
 		}
-		
-		nameFile.close();
         
-		return 0;
+		return list;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "ShhherCommand", "createNamesFile");
+		m->errorOut(e, "ShhherCommand", "getUniqueList");
 		exit(1);
 	}
 }
 //**********************************************************************************************************************
 
-int ShhherCommand::cluster(string filename, string distFileName, string namesFileName){
+int ShhherCommand::cluster(ostream& listFile, ListVector* list, SparseDistanceMatrix* matrix){
 	try {
 		
-		ReadMatrix* read = new ReadColumnMatrix(distFileName); 	
-		read->setCutoff(cutoff);
-		
-		NameAssignment* clusterNameMap = new NameAssignment(namesFileName);
-		clusterNameMap->readMap();
-		read->read(clusterNameMap);
-        
-		ListVector* list = read->getListVector();
-		SparseDistanceMatrix* matrix = read->getDMatrix();
-		
-		delete read; 
-		delete clusterNameMap; 
-        
 		RAbundVector* rabund = new RAbundVector(list->getRAbundVector());
 		
         float adjust = -1.0;
@@ -1237,11 +1249,7 @@ int ShhherCommand::cluster(string filename, string distFileName, string namesFil
 		}
 		
 		list->setLabel(toString(cutoff));
-		
-		ofstream listFile;
-		m->openOutputFile(filename, listFile);
 		list->print(listFile, true);
-		listFile.close();
 		
 		delete matrix;	delete cluster;	delete rabund; delete list;
         
@@ -1254,7 +1262,7 @@ int ShhherCommand::cluster(string filename, string distFileName, string namesFil
 }
 /**************************************************************************************************/
 
-int ShhherCommand::getOTUData(int numSeqs, string fileName,  vector<int>& otuData,
+int ShhherCommand::getOTUData(int numSeqs, istream& listFile,  vector<int>& otuData,
                                vector<int>& cumNumSeqs,
                                vector<int>& nSeqsPerOTU,
                                vector<vector<int> >& aaP,	//tMaster->aanP:	each row is a different otu / each col contains the sequence indices
@@ -1264,8 +1272,6 @@ int ShhherCommand::getOTUData(int numSeqs, string fileName,  vector<int>& otuDat
                                map<string, int>& nameMap){
 	try {
         
-		ifstream listFile;
-		m->openInputFile(fileName, listFile);
 		string label;
         int numOTUs;
 		
@@ -1344,8 +1350,6 @@ int ShhherCommand::getOTUData(int numSeqs, string fileName,  vector<int>& otuDat
 		}
 		aaI = aaP;
 		seqIndex = seqNumber;
-		
-		listFile.close();	
         
         return numOTUs;
 		
@@ -12,8 +12,7 @@
 
 #include "mothur.h"
 #include "command.hpp"
-#include "readcolumn.h"
-#include "readmatrix.hpp"
+#include "sparsedistancematrix.h"
 #include "rabundvector.hpp"
 #include "sabundvector.hpp"
 #include "listvector.hpp"
@@ -53,7 +52,7 @@ private:
 	bool abort, large;
 	string outputDir, flowFileName, flowFilesFileName, lookupFileName, compositeFASTAFileName, compositeNamesFileName;
 
-	int processors, maxIters, largeSize;
+	int processors, distProcessors, maxIters, largeSize;
 	float cutoff, sigma, minDelta;
 	string flowOrder;
     
@@ -67,11 +66,12 @@ private:
     int createProcesses(vector<string>);
     int getFlowData(string, vector<string>&, vector<int>&, vector<short>&, map<string, int>&, int&);
     int getUniques(int, int, vector<short>&, vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<double>&, vector<short>&);
-    int flowDistParentFork(int, string, int, vector<int>&, vector<int>&, vector<int>&, vector<double>&, vector<short>&);
-    float calcPairwiseDist(int, int, int, vector<int>&, vector<int>&, vector<double>&, vector<short>&);
-    int createNamesFile(int, int, string, vector<string>&, vector<int>&, vector<int>&);
-    int cluster(string, string, string);
-    int getOTUData(int numSeqs, string,  vector<int>&, vector<int>&, vector<int>&, vector<vector<int> >&, vector<vector<int> >&, vector<int>&, vector<int>&,map<string, int>&);
+    SparseDistanceMatrix* flowDistances(int, int, vector<int>&, vector<int>&, vector<double>&, vector<short>&);
+    void flowDistThread(int, int, vector<int>&, vector<int>&, vector<float>&, vector<short>&, vector< vector<PDistCell> >&, atomic<int>&, mutex&, int, double);
+    float calcPairwiseDist(const short*, const float*, const short*, const float*, int, const double*);
+    ListVector* getUniqueList(int, int, vector<string>&, vector<int>&);
+    int cluster(ostream&, ListVector*, SparseDistanceMatrix*);
+    int getOTUData(int numSeqs, istream&,  vector<int>&, vector<int>&, vector<int>&, vector<vector<int> >&, vector<vector<int> >&, vector<int>&, vector<int>&,map<string, int>&);
     int calcCentroidsDriver(int numOTUs, vector<int>&, vector<int>&, vector<int>&, vector<short>&, vector<int>&, vector<double>&, vector<int>&, vector<short>&, vector<short>&, vector<int>&, int, vector<int>&);
     double getDistToCentroid(int, int, int, vector<short>&, vector<short>&, int);
     double getNewWeights(int, vector<int>&, vector<int>&, vector<double>&, vector<int>&, vector<double>&);
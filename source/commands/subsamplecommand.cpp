@@ -1499,13 +1499,11 @@ int SubSampleCommand::processRabund(RAbundVector*& rabund, ofstream& out) {
 			
 		if (thisSize != size) {
 				
-			vector<int> order;
-			for(int p=0;p<numBins;p++){
-				for(int j=0;j<rabund->get(p);j++){
-					order.push_back(p);
-				}
-			}
-			m->mothurRandomShuffle(order);
+			vector<int> counts, sampled;
+			for(int p=0;p<numBins;p++){ counts.push_back(rabund->get(p)); }
+			
+			SubSample sample;
+			sample.getSample(counts, size, sampled);
 			
 			RAbundVector* temp = new RAbundVector(numBins);
 			temp->setLabel(rabund->getLabel());
@@ -1513,14 +1511,8 @@ int SubSampleCommand::processRabund(RAbundVector*& rabund, ofstream& out) {
 			delete rabund;
 			rabund = temp;
 			
-			for (int j = 0; j < size; j++) {
-				
-				if (m->control_pressed) {  return 0; }
-				
-				int bin = order[j];
-				
-				int abund = rabund->get(bin);
-				rabund->set(bin, (abund+1));
+			for (int j = 0; j < numBins; j++) {
+				if (sampled[j] != 0) { rabund->set(j, sampled[j]); }
 			}
 		}
 		
@@ -1658,13 +1650,11 @@ int SubSampleCommand::processSabund(SAbundVector*& sabund, ofstream& out) {
 	
 		if (thisSize != size) {
 			
-			vector<int> order;
-			for(int p=0;p<numBins;p++){
-				for(int j=0;j<rabund->get(p);j++){
-					order.push_back(p);
-				}
-			}
-			m->mothurRandomShuffle(order);
+			vector<int> counts, sampled;
+			for(int p=0;p<numBins;p++){ counts.push_back(rabund->get(p)); }
+			
+			SubSample sample;
+			sample.getSample(counts, size, sampled);
 			
 			RAbundVector* temp = new RAbundVector(numBins);
 			temp->setLabel(rabund->getLabel());
@@ -1672,14 +1662,8 @@ int SubSampleCommand::processSabund(SAbundVector*& sabund, ofstream& out) {
 			delete rabund;
 			rabund = temp;
 			
-			for (int j = 0; j < size; j++) {
-	
-				if (m->control_pressed) {  return 0; }
-				
-				int bin = order[j];
-				
-				int abund = rabund->get(bin);
-				rabund->set(bin, (abund+1));
+			for (int j = 0; j < numBins; j++) {
+				if (sampled[j] != 0) { rabund->set(j, sampled[j]); }
 			}
 		}
 		
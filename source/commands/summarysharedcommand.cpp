@@ -212,96 +212,14 @@ SummarySharedCommand::SummarySharedCommand(string option)  {
 			
 			if (abort == false) {
 			
+				//keep the valid calculators, each thread makes its own set from them
 				ValidCalculators validCalculator;
-				int i;
-				
-				for (i=0; i<Estimators.size(); i++) {
-					if (validCalculator.isValidCalculator("sharedsummary", Estimators[i]) == true) { 
-						if (Estimators[i] == "sharedsobs") { 
-							sumCalculators.push_back(new SharedSobsCS());
-						}else if (Estimators[i] == "sharedchao") { 
-							sumCalculators.push_back(new SharedChao1());
-						}else if (Estimators[i] == "sharedace") { 
-							sumCalculators.push_back(new SharedAce());
-						}else if (Estimators[i] == "jabund") { 	
-							sumCalculators.push_back(new JAbund());
-						}else if (Estimators[i] == "sorabund") { 
-							sumCalculators.push_back(new SorAbund());
-						}else if (Estimators[i] == "jclass") { 
-							sumCalculators.push_back(new Jclass());
-						}else if (Estimators[i] == "sorclass") { 
-							sumCalculators.push_back(new SorClass());
-						}else if (Estimators[i] == "jest") { 
-							sumCalculators.push_back(new Jest());
-						}else if (Estimators[i] == "sorest") { 
-							sumCalculators.push_back(new SorEst());
-						}else if (Estimators[i] == "thetayc") { 
-							sumCalculators.push_back(new ThetaYC());
-						}else if (Estimators[i] == "thetan") { 
-							sumCalculators.push_back(new ThetaN());
-						}else if (Estimators[i] == "kstest") { 
-							sumCalculators.push_back(new KSTest());
-						}else if (Estimators[i] == "sharednseqs") { 
-							sumCalculators.push_back(new SharedNSeqs());
-						}else if (Estimators[i] == "ochiai") { 
-							sumCalculators.push_back(new Ochiai());
-						}else if (Estimators[i] == "anderberg") { 
-							sumCalculators.push_back(new Anderberg());
-						}else if (Estimators[i] == "kulczynski") { 
-							sumCalculators.push_back(new Kulczynski());
-						}else if (Estimators[i] == "kulczynskicody") { 
-							sumCalculators.push_back(new KulczynskiCody());
-						}else if (Estimators[i] == "lennon") { 
-							sumCalculators.push_back(new Lennon());
-						}else if (Estimators[i] == "morisitahorn") { 
-							sumCalculators.push_back(new MorHorn());
-						}else if (Estimators[i] == "braycurtis") { 
-							sumCalculators.push_back(new BrayCurtis());
-						}else if (Estimators[i] == "whittaker") { 
-							sumCalculators.push_back(new Whittaker());
-						}else if (Estimators[i] == "odum") { 
-							sumCalculators.push_back(new Odum());
-						}else if (Estimators[i] == "canberra") { 
-							sumCalculators.push_back(new Canberra());
-						}else if (Estimators[i] == "structeuclidean") { 
-							sumCalculators.push_back(new StructEuclidean());
-						}else if (Estimators[i] == "structchord") { 
-							sumCalculators.push_back(new StructChord());
-						}else if (Estimators[i] == "hellinger") { 
-							sumCalculators.push_back(new Hellinger());
-						}else if (Estimators[i] == "manhattan") { 
-							sumCalculators.push_back(new Manhattan());
-						}else if (Estimators[i] == "structpearson") { 
-							sumCalculators.push_back(new StructPearson());
-						}else if (Estimators[i] == "soergel") { 
-							sumCalculators.push_back(new Soergel());
-						}else if (Estimators[i] == "spearman") { 
-							sumCalculators.push_back(new Spearman());
-						}else if (Estimators[i] == "structkulczynski") { 
-							sumCalculators.push_back(new StructKulczynski());
-						}else if (Estimators[i] == "speciesprofile") { 
-							sumCalculators.push_back(new SpeciesProfile());
-						}else if (Estimators[i] == "hamming") { 
-							sumCalculators.push_back(new Hamming());
-						}else if (Estimators[i] == "structchi2") { 
-							sumCalculators.push_back(new StructChi2());
-						}else if (Estimators[i] == "gower") { 
-							sumCalculators.push_back(new Gower());
-						}else if (Estimators[i] == "memchi2") { 
-							sumCalculators.push_back(new MemChi2());
-						}else if (Estimators[i] == "memchord") { 
-							sumCalculators.push_back(new MemChord());
-						}else if (Estimators[i] == "memeuclidean") { 
-							sumCalculators.push_back(new MemEuclidean());
-						}else if (Estimators[i] == "mempearson") { 
-							sumCalculators.push_back(new MemPearson());
-						}else if (Estimators[i] == "jsd") {
-							sumCalculators.push_back(new JSD());
-						}else if (Estimators[i] == "rjsd") {
-							sumCalculators.push_back(new RJSD());
-						}
-					}
+				vector<string> validEstimators;
+				for (int i=0; i<Estimators.size(); i++) {
+					if (validCalculator.isValidCalculator("sharedsummary", Estimators[i]) == true) { validEstimators.push_back(Estimators[i]); }
 				}
+				Estimators = validEstimators;
+				sumCalculators = createCalculators();
 				
 				mult = false;
 			}
@@ -314,6 +232,102 @@ SummarySharedCommand::SummarySharedCommand(string option)  {
 }
 //**********************************************************************************************************************
 
+vector<Calculator*> SummarySharedCommand::createCalculators(){
+	try {
+		vector<Calculator*> calcs;
+		for (int i=0; i<Estimators.size(); i++) {
+			if (Estimators[i] == "sharedsobs") { 
+				calcs.push_back(new SharedSobsCS());
+			}else if (Estimators[i] == "sharedchao") { 
+				calcs.push_back(new SharedChao1());
+			}else if (Estimators[i] == "sharedace") { 
+				calcs.push_back(new SharedAce());
+			}else if (Estimators[i] == "jabund") { 	
+				calcs.push_back(new JAbund());
+			}else if (Estimators[i] == "sorabund") { 
+				calcs.push_back(new SorAbund());
+			}else if (Estimators[i] == "jclass") { 
+				calcs.push_back(new Jclass());
+			}else if (Estimators[i] == "sorclass") { 
+				calcs.push_back(new SorClass());
+			}else if (Estimators[i] == "jest") { 
+				calcs.push_back(new Jest());
+			}else if (Estimators[i] == "sorest") { 
+				calcs.push_back(new SorEst());
+			}else if (Estimators[i] == "thetayc") { 
+				calcs.push_back(new ThetaYC());
+			}else if (Estimators[i] == "thetan") { 
+				calcs.push_back(new ThetaN());
+			}else if (Estimators[i] == "kstest") { 
+				calcs.push_back(new KSTest());
+			}else if (Estimators[i] == "sharednseqs") { 
+				calcs.push_back(new SharedNSeqs());
+			}else if (Estimators[i] == "ochiai") { 
+				calcs.push_back(new Ochiai());
+			}else if (Estimators[i] == "anderberg") { 
+				calcs.push_back(new Anderberg());
+			}else if (Estimators[i] == "kulczynski") { 
+				calcs.push_back(new Kulczynski());
+			}else if (Estimators[i] == "kulczynskicody") { 
+				calcs.push_back(new KulczynskiCody());
+			}else if (Estimators[i] == "lennon") { 
+				calcs.push_back(new Lennon());
+			}else if (Estimators[i] == "morisitahorn") { 
+				calcs.push_back(new MorHorn());
+			}else if (Estimators[i] == "braycurtis") { 
+				calcs.push_back(new BrayCurtis());
+			}else if (Estimators[i] == "whittaker") { 
+				calcs.push_back(new Whittaker());
+			}else if (Estimators[i] == "odum") { 
+				calcs.push_back(new Odum());
+			}else if (Estimators[i] == "canberra") { 
+				calcs.push_back(new Canberra());
+			}else if (Estimators[i] == "structeuclidean") { 
+				calcs.push_back(new StructEuclidean());
+			}else if (Estimators[i] == "structchord") { 
+				calcs.push_back(new StructChord());
+			}else if (Estimators[i] == "hellinger") { 
+				calcs.push_back(new Hellinger());
+			}else if (Estimators[i] == "manhattan") { 
+				calcs.push_back(new Manhattan());
+			}else if (Estimators[i] == "structpearson") { 
+				calcs.push_back(new StructPearson());
+			}else if (Estimators[i] == "soergel") { 
+				calcs.push_back(new Soergel());
+			}else if (Estimators[i] == "spearman") { 
+				calcs.push_back(new Spearman());
+			}else if (Estimators[i] == "structkulczynski") { 
+				calcs.push_back(new StructKulczynski());
+			}else if (Estimators[i] == "speciesprofile") { 
+				calcs.push_back(new SpeciesProfile());
+			}else if (Estimators[i] == "hamming") { 
+				calcs.push_back(new Hamming());
+			}else if (Estimators[i] == "structchi2") { 
+				calcs.push_back(new StructChi2());
+			}else if (Estimators[i] == "gower") { 
+				calcs.push_back(new Gower());
+			}else if (Estimators[i] == "memchi2") { 
+				calcs.push_back(new MemChi2());
+			}else if (Estimators[i] == "memchord") { 
+				calcs.push_back(new MemChord());
+			}else if (Estimators[i] == "memeuclidean") { 
+				calcs.push_back(new MemEuclidean());
+			}else if (Estimators[i] == "mempearson") { 
+				calcs.push_back(new MemPearson());
+			}else if (Estimators[i] == "jsd") {
+				calcs.push_back(new JSD());
+			}else if (Estimators[i] == "rjsd") {
+				calcs.push_back(new RJSD());
+			}
+		}
+		return calcs;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SummarySharedCommand", "createCalculators");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
 int SummarySharedCommand::execute(){
 	try {
 	
@@ -580,310 +594,108 @@ int SummarySharedCommand::printSims(ostream& out, vector< vector<double> >& simM
 /***********************************************************/
 int SummarySharedCommand::process(vector<SharedRAbundVector*> thisLookup, string sumFileName, string sumAllFileName) {
 	try {
-        vector< vector< vector<seqDist> > > calcDistsTotals;  //each iter, one for each calc, then each groupCombos dists. this will be used to make .dist files
-        vector< vector<seqDist>  > calcDists; calcDists.resize(sumCalculators.size()); 		
+        //the whole dataset is split into the blocks of rows, each subsampled iteration is one item unless there are fewer iterations than processors
+        vector<linePair> blocks;
+        for (int i = 0; i < lines.size(); i++) { if (lines[i].start != lines[i].end) { blocks.push_back(lines[i]); } }
+        
+        int blocksPerIter = 1;
+        if (iters < processors) { blocksPerIter = blocks.size(); }
+        
+        int seed = 0;
+        if (subsample) { seed = m->getRandomNumber(); }
+        
+        ofstream out, outAll;
+        m->openOutputFileAppend(sumFileName, out);
+        if (mult) { m->openOutputFileAppend(sumAllFileName, outAll); }
+        
+        summarySharedData data(thisLookup, blocksPerIter, seed, &out, &outAll);
         
+        for (int i = 0; i < blocks.size(); i++) { data.items.push_back(iterBlock(0, blocks[i].start, blocks[i].end)); }
+        for (int thisIter = 1; thisIter < iters+1; thisIter++) {
+            if (blocksPerIter == 1) { data.items.push_back(iterBlock(thisIter, 0, numGroups)); }
+            else { for (int i = 0; i < blocks.size(); i++) { data.items.push_back(iterBlock(thisIter, blocks[i].start, blocks[i].end)); } }
+        }
+        data.sumOutput.resize(data.items.size(), "");
+        data.sumAllOutput.resize(data.items.size(), "");
+        data.finished.resize(data.items.size(), 0);
+        
+        int numPairs = (numGroups * (numGroups-1)) / 2;
+        data.calcDistsTotals.resize(iters+1);
         for (int thisIter = 0; thisIter < iters+1; thisIter++) {
-            
-            vector<SharedRAbundVector*> thisItersLookup = thisLookup;
-            
-            if (subsample && (thisIter != 0)) { //we want the summary results for the whole dataset, then the subsampling
-                SubSample sample;
-                vector<string> tempLabels; //dont need since we arent printing the sampled sharedRabunds
-                
-                //make copy of lookup so we don't get access violations
-                vector<SharedRAbundVector*> newLookup;
-                for (int k = 0; k < thisItersLookup.size(); k++) {
-                    SharedRAbundVector* temp = new SharedRAbundVector();
-                    temp->setLabel(thisItersLookup[k]->getLabel());
-                    temp->setGroup(thisItersLookup[k]->getGroup());
-                    newLookup.push_back(temp);
-                }
-                
-                //for each bin
-                for (int k = 0; k < thisItersLookup[0]->getNumBins(); k++) {
-                    if (m->control_pressed) { for (int j = 0; j < newLookup.size(); j++) {  delete newLookup[j];  } return 0; }
-                    for (int j = 0; j < thisItersLookup.size(); j++) { newLookup[j]->push_back(thisItersLookup[j]->getAbundance(k), thisItersLookup[j]->getGroup()); }
+            data.calcDistsTotals[thisIter].resize(sumCalculators.size());
+            for (int i = 0; i < sumCalculators.size(); i++) {
+                data.calcDistsTotals[thisIter][i].resize(numPairs);
+                for (int k = 0; k < numGroups; k++) {
+                    for (int l = 0; l < k; l++) { data.calcDistsTotals[thisIter][i][(k*(k-1))/2+l] = seqDist(l, k, 0.0); }
                 }
-                
-                tempLabels = sample.getSample(newLookup, subsampleSize);
-                thisItersLookup = newLookup;
             }
+        }
         
-            
-            if(processors == 1){
-                driver(thisItersLookup, 0, numGroups, sumFileName+".temp", sumAllFileName+".temp", calcDists);
-                m->appendFiles((sumFileName + ".temp"), sumFileName);
-                m->mothurRemove((sumFileName + ".temp"));
-                if (mult) {
-                    m->appendFiles((sumAllFileName + ".temp"), sumAllFileName);
-                    m->mothurRemove((sumAllFileName + ".temp"));
-                }
-            }else{
-                
-                int process = 1;
-                vector<int> processIDS;
-                bool recalc = false;
-                
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-                //loop through and create all the processes you want
-                while (process != processors) {
-                    pid_t pid = fork();
-                    
-                    if (pid > 0) {
-                        processIDS.push_back(pid); 
-                        process++;
-                    }else if (pid == 0){
-                        driver(thisItersLookup, lines[process].start, lines[process].end, sumFileName + m->mothurGetpid(process) + ".temp", sumAllFileName + m->mothurGetpid(process) + ".temp", calcDists);
-                        
-                        //only do this if you want a distance file
-                        if (createPhylip) {
-                            string tempdistFileName = m->getRootName(m->getSimpleName(sumFileName)) + m->mothurGetpid(process) + ".dist";
-                            ofstream outtemp;
-                            m->openOutputFile(tempdistFileName, outtemp);
-                            
-                            for (int i = 0; i < calcDists.size(); i++) {
-                                outtemp << calcDists[i].size() << endl;
-                                
-                                for (int j = 0; j < calcDists[i].size(); j++) {
-                                    outtemp << calcDists[i][j].seq1 << '\t' << calcDists[i][j].seq2 << '\t' << calcDists[i][j].dist << endl;
-                                }
-                            }
-                            outtemp.close();
-                        }
-                        
-                        exit(0);
-                    }else { 
-                        m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(process) + "\n"); processors = process;
-                        for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-                        //wait to die
-                        for (int i=0;i<processIDS.size();i++) {
-                            int temp = processIDS[i];
-                            wait(&temp);
-                        }
-                        m->control_pressed = false;
-                        for (int i=0;i<processIDS.size();i++) {
-                            m->mothurRemove(sumFileName + (toString(processIDS[i]) + ".temp"));
-                            m->mothurRemove(sumAllFileName + (toString(processIDS[i]) + ".temp"));
-                            if (createPhylip) { m->mothurRemove(m->getRootName(m->getSimpleName(sumFileName)) + (toString(processIDS[i]) + ".dist")); }
-                        }
-                        recalc = true;
-                        break;
-                    }
-                }
-                
-                if (recalc) {
-                    //test line, also set recalc to true.
-                    //for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); } for (int i=0;i<processIDS.size();i++) { int temp = processIDS[i]; wait(&temp); } m->control_pressed = false;  for (int i=0;i<processIDS.size();i++) {m->mothurRemove(sumFileName + (toString(processIDS[i]) + ".temp"));m->mothurRemove(sumAllFileName + (toString(processIDS[i]) + ".temp"));if (createPhylip) { m->mothurRemove(m->getRootName(m->getSimpleName(sumFileName)) + (toString(processIDS[i]) + ".dist")); }}processors=3; m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(processors) + "\n");
-                    
-                    /******************************************************/
-                    //comparison breakup to be used by different processes later
-                    lines.clear();
-                    numGroups = thisLookup.size();
-                    lines.resize(processors);
-                    for (int i = 0; i < processors; i++) {
-                        lines[i].start = int (sqrt(float(i)/float(processors)) * numGroups);
-                        lines[i].end = int (sqrt(float(i+1)/float(processors)) * numGroups);
-                    }		
-                    /******************************************************/
-                    
-                    calcDists.clear(); calcDists.resize(sumCalculators.size());
-                    processIDS.resize(0);
-                    process = 1;
-                    
-                    //loop through and create all the processes you want
-                    while (process != processors) {
-                        pid_t pid = fork();
-                        
-                        if (pid > 0) {
-                            processIDS.push_back(pid);
-                            process++;
-                        }else if (pid == 0){
-                            driver(thisItersLookup, lines[process].start, lines[process].end, sumFileName + m->mothurGetpid(process) + ".temp", sumAllFileName + m->mothurGetpid(process) + ".temp", calcDists);
-                            
-                            //only do this if you want a distance file
-                            if (createPhylip) {
-                                string tempdistFileName = m->getRootName(m->getSimpleName(sumFileName)) + m->mothurGetpid(process) + ".dist";
-                                ofstream outtemp;
-                                m->openOutputFile(tempdistFileName, outtemp);
-                                
-                                for (int i = 0; i < calcDists.size(); i++) {
-                                    outtemp << calcDists[i].size() << endl;
-                                    
-                                    for (int j = 0; j < calcDists[i].size(); j++) {
-                                        outtemp << calcDists[i][j].seq1 << '\t' << calcDists[i][j].seq2 << '\t' << calcDists[i][j].dist << endl;
-                                    }
-                                }
-                                outtemp.close();
-                            }
-                            
-                            exit(0);
-                        }else {
-                            m->mothurOut("[ERROR]: unable to spawn the necessary processes."); m->mothurOutEndLine();
-                            for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-                            exit(0);
-                        }
-                    }
-                    
-                }
-
-                //parent do your part
-                driver(thisItersLookup, lines[0].start, lines[0].end, sumFileName + m->mothurGetpid(process) + ".temp", sumAllFileName + m->mothurGetpid(process) + ".temp", calcDists);
-                m->appendFiles((sumFileName + m->mothurGetpid(process) + ".temp"), sumFileName);
-                m->mothurRemove((sumFileName + m->mothurGetpid(process) + ".temp"));
-                if (mult) { m->appendFiles((sumAllFileName + m->mothurGetpid(process) + ".temp"), sumAllFileName); }
-                
-                //force parent to wait until all the processes are done
-                for (int i = 0; i < processIDS.size(); i++) {
-                    int temp = processIDS[i];
-                    wait(&temp);
-                }
-                
-                for (int i = 0; i < processIDS.size(); i++) {
-                    m->appendFiles((sumFileName + toString(processIDS[i]) + ".temp"), sumFileName);
-                    m->mothurRemove((sumFileName + toString(processIDS[i]) + ".temp"));
-                    if (mult) {	m->mothurRemove((sumAllFileName + toString(processIDS[i]) + ".temp"));	}
-                    
-                    if (createPhylip) {
-                        string tempdistFileName = m->getRootName(m->getSimpleName(sumFileName)) + toString(processIDS[i]) +  ".dist";
-                        ifstream intemp;
-                        m->openInputFile(tempdistFileName, intemp);
-                        
-                        for (int k = 0; k < calcDists.size(); k++) {
-                            int size = 0;
-                            intemp >> size; m->gobble(intemp);
-                            
-                            for (int j = 0; j < size; j++) {
-                                int seq1 = 0;
-                                int seq2 = 0;
-                                float dist = 1.0;
-                                
-                                intemp >> seq1 >> seq2 >> dist;   m->gobble(intemp);
-                                
-                                seqDist tempDist(seq1, seq2, dist);
-                                calcDists[k].push_back(tempDist);
-                            }
-                        }
-                        intemp.close();
-                        m->mothurRemove(tempdistFileName);
-                    }
-                }
-#else
-                //////////////////////////////////////////////////////////////////////////////////////////////////////
-                //Windows version shared memory, so be careful when passing variables through the summarySharedData struct. 
-                //Above fork() will clone, so memory is separate, but that's not the case with windows, 
-                //Taking advantage of shared memory to pass results vectors.
-                //////////////////////////////////////////////////////////////////////////////////////////////////////
-                
-                vector<summarySharedData*> pDataArray; 
-                DWORD   dwThreadIdArray[processors-1];
-                HANDLE  hThreadArray[processors-1];
+        int numThreads = processors;
+        if (numThreads > data.items.size()) { numThreads = data.items.size(); }
+        
+        //each thread needs its own calculators
+        vector< vector<Calculator*> > threadCalcs;
+        for (int i = 1; i < numThreads; i++) { threadCalcs.push_back(createCalculators()); }
+        
+        vector<thread*> workerThreads;
+        for (int i = 1; i < numThreads; i++) {
+            workerThreads.push_back(new thread(&SummarySharedCommand::iterThread, this, &data, &threadCalcs[i-1]));
+        }
+        
+        //parent do your part
+        iterThread(&data, &sumCalculators);
+        
+        for (int i = 0; i < workerThreads.size(); i++) {
+            workerThreads[i]->join();
+            delete workerThreads[i];
+            for (int j = 0; j < threadCalcs[i].size(); j++) { delete threadCalcs[i][j]; }
+        }
+        
+        out.close();
+        if (mult) { outAll.close(); }
+        
+        if (m->control_pressed) { return 0; }
+        
+        vector< vector< vector<seqDist> > >& calcDistsTotals = data.calcDistsTotals;
+        vector< vector<seqDist>  > calcDists = calcDistsTotals[0];
+        calcDistsTotals.erase(calcDistsTotals.begin());
+        
+        if (createPhylip) {
+            for (int i = 0; i < calcDists.size(); i++) {
+                if (m->control_pressed) { break; }
                 
-                //Create processor worker threads.
-                for( int i=1; i<processors; i++ ){
-                    
-                    //make copy of lookup so we don't get access violations
-                    vector<SharedRAbundVector*> newLookup;
-                    for (int k = 0; k < thisLookup.size(); k++) {
-                        SharedRAbundVector* temp = new SharedRAbundVector();
-                        temp->setLabel(thisLookup[k]->getLabel());
-                        temp->setGroup(thisLookup[k]->getGroup());
-                        newLookup.push_back(temp);
-                    }
+                //initialize matrix
+                vector< vector<double> > matrix; //square matrix to represent the distance
+                matrix.resize(thisLookup.size());
+                for (int k = 0; k < thisLookup.size(); k++) {  matrix[k].resize(thisLookup.size(), 0.0); }
                 
+                for (int j = 0; j < calcDists[i].size(); j++) {
+                    int row = calcDists[i][j].seq1;
+                    int column = calcDists[i][j].seq2;
+                    double dist = calcDists[i][j].dist;
                     
-                    //for each bin
-                    for (int k = 0; k < thisItersLookup[0]->getNumBins(); k++) {
-                        if (m->control_pressed) { for (int j = 0; j < newLookup.size(); j++) {  delete newLookup[j];  } return 0; }
-                        for (int j = 0; j < thisItersLookup.size(); j++) { newLookup[j]->push_back(thisItersLookup[j]->getAbundance(k), thisItersLookup[j]->getGroup()); }
-                    }
-                    
-                    // Allocate memory for thread data.
-                    summarySharedData* tempSum = new summarySharedData((sumFileName+toString(i)+".temp"), m, lines[i].start, lines[i].end, Estimators, newLookup);
-                    pDataArray.push_back(tempSum);
-                    processIDS.push_back(i);
-                    
-                    hThreadArray[i-1] = CreateThread(NULL, 0, MySummarySharedThreadFunction, pDataArray[i-1], 0, &dwThreadIdArray[i-1]);   
+                    matrix[row][column] = dist;
+                    matrix[column][row] = dist;
                 }
                 
-                //parent do your part
-                driver(thisItersLookup, lines[0].start, lines[0].end, sumFileName +"0.temp", sumAllFileName + "0.temp", calcDists);
-                m->appendFiles((sumFileName + "0.temp"), sumFileName);
-                m->mothurRemove((sumFileName + "0.temp"));
-                if (mult) { m->appendFiles((sumAllFileName + "0.temp"), sumAllFileName); }
-                
-                //Wait until all threads have terminated.
-                WaitForMultipleObjects(processors-1, hThreadArray, TRUE, INFINITE);
-                
-                //Close all thread handles and free memory allocations.
-                for(int i=0; i < pDataArray.size(); i++){
-                    if (pDataArray[i]->count != (pDataArray[i]->end-pDataArray[i]->start)) {
-                        m->mothurOut("[ERROR]: process " + toString(i) + " only processed " + toString(pDataArray[i]->count) + " of " + toString(pDataArray[i]->end-pDataArray[i]->start) + " groups assigned to it, quitting. \n"); m->control_pressed = true; 
-                    }
-                    m->appendFiles((sumFileName + toString(processIDS[i]) + ".temp"), sumFileName);
-                    m->mothurRemove((sumFileName + toString(processIDS[i]) + ".temp"));
-                    
-                    for (int j = 0; j < pDataArray[i]->thisLookup.size(); j++) {  delete pDataArray[i]->thisLookup[j];  }
-                    
-                    if (createPhylip) {
-                        for (int k = 0; k < calcDists.size(); k++) {
-                            int size = pDataArray[i]->calcDists[k].size();
-                            for (int j = 0; j < size; j++) {    calcDists[k].push_back(pDataArray[i]->calcDists[k][j]);    }
-                        }
-                    }
-                    
-                    CloseHandle(hThreadArray[i]);
-                    delete pDataArray[i];
-                }
+                map<string, string> variables; 
+                variables["[filename]"] = outputDir + m->getRootName(m->getSimpleName(sharedfile));
+                variables["[calc]"] = sumCalculators[i]->getName();
+                variables["[distance]"] = thisLookup[0]->getLabel();
+                variables["[outputtag]"] = output;
+                variables["[tag2]"] = "";
+                string distFileName = getOutputFileName("phylip",variables);
+                outputNames.push_back(distFileName); outputTypes["phylip"].push_back(distFileName);
+                ofstream outDist;
+                m->openOutputFile(distFileName, outDist);
+                outDist.setf(ios::fixed, ios::floatfield); outDist.setf(ios::showpoint);
                 
-#endif
-            }
-            
-            if (subsample && (thisIter != 0)) { //we want the summary results for the whole dataset, then the subsampling
+                printSims(outDist, matrix);
                 
-                calcDistsTotals.push_back(calcDists); 
-                //clean up memory
-                for (int i = 0; i < thisItersLookup.size(); i++) { delete thisItersLookup[i]; }
-                thisItersLookup.clear();
-            }else {
-                if (createPhylip) {
-                    for (int i = 0; i < calcDists.size(); i++) {
-                        if (m->control_pressed) { break; }
-                        
-                        //initialize matrix
-                        vector< vector<double> > matrix; //square matrix to represent the distance
-                        matrix.resize(thisLookup.size());
-                        for (int k = 0; k < thisLookup.size(); k++) {  matrix[k].resize(thisLookup.size(), 0.0); }
-                        
-                        for (int j = 0; j < calcDists[i].size(); j++) {
-                            int row = calcDists[i][j].seq1;
-                            int column = calcDists[i][j].seq2;
-                            double dist = calcDists[i][j].dist;
-                            
-                            matrix[row][column] = dist;
-                            matrix[column][row] = dist;
-                        }
-                        
-                        map<string, string> variables; 
-                        variables["[filename]"] = outputDir + m->getRootName(m->getSimpleName(sharedfile));
-                        variables["[calc]"] = sumCalculators[i]->getName();
-                        variables["[distance]"] = thisLookup[0]->getLabel();
-                        variables["[outputtag]"] = output;
-                        variables["[tag2]"] = "";
-                        string distFileName = getOutputFileName("phylip",variables);
-                        outputNames.push_back(distFileName); outputTypes["phylip"].push_back(distFileName);
-                        ofstream outDist;
-                        m->openOutputFile(distFileName, outDist);
-                        outDist.setf(ios::fixed, ios::floatfield); outDist.setf(ios::showpoint);
-                        
-                        printSims(outDist, matrix);
-                        
-                        outDist.close();
-                    }
-                }
+                outDist.close();
             }
-            for (int i = 0; i < calcDists.size(); i++) {  calcDists[i].clear(); }
-		}
+        }
 
         if (iters != 0) {
             //we need to find the average distance and standard deviation for each groups distance
@@ -953,14 +765,59 @@ int SummarySharedCommand::process(vector<SharedRAbundVector*> thisLookup, string
 	}
 }
 /**************************************************************************************************/
-int SummarySharedCommand::driver(vector<SharedRAbundVector*> thisLookup, int start, int end, string sumFile, string sumAllFile, vector< vector<seqDist> >& calcDists) { 
+//pulls (iteration, rows) items until there are none left. A subsampled iteration draws its sample from an engine seeded with
+//seed+iteration, so every block of it sees the same sample and the results do not depend on the number of processors.
+//The items' lines are written in item order, the file comes out as if one processor made it.
+void SummarySharedCommand::iterThread(summarySharedData* data, vector<Calculator*>* calcs) {
+	try {
+        SubSample sample; //keeps its buffers from one iteration to the next
+        
+        while (!m->control_pressed) {
+            int i = data->nextItem++;
+            if (i >= data->items.size()) { break; }
+            
+            iterBlock item = data->items[i];
+            
+            vector<SharedRAbundVector*> thisItersLookup = data->thisLookup;
+            if (item.iter != 0) {
+                //make copy of lookup so we don't get access violations
+                thisItersLookup.clear();
+                for (int k = 0; k < data->thisLookup.size(); k++) { thisItersLookup.push_back(new SharedRAbundVector(*(data->thisLookup[k]))); }
+                
+                mt19937_64 engine(data->seed + item.iter);
+                sample.getSample(thisItersLookup, subsampleSize, engine);
+            }
+            
+            //the first block of each iteration adds the line for the calcs that can do all the groups
+            ostringstream sumOut, sumAllOut;
+            driver(thisItersLookup, item.start, item.end, (mult && (item.start == 0)), *calcs, sumOut, sumAllOut, data->calcDistsTotals[item.iter]);
+            
+            if (item.iter != 0) { for (int k = 0; k < thisItersLookup.size(); k++) { delete thisItersLookup[k]; } }
+            
+            lock_guard<mutex> guard(data->writeMutex);
+            data->sumOutput[i] = sumOut.str();
+            data->sumAllOutput[i] = sumAllOut.str();
+            data->finished[i] = 1;
+            
+            while ((data->nextWrite < data->items.size()) && data->finished[data->nextWrite]) {
+                *(data->out) << data->sumOutput[data->nextWrite];
+                if (mult) { *(data->outAll) << data->sumAllOutput[data->nextWrite]; }
+                data->sumOutput[data->nextWrite].clear(); data->sumAllOutput[data->nextWrite].clear();
+                data->nextWrite++;
+            }
+        }
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SummarySharedCommand", "iterThread");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+int SummarySharedCommand::driver(vector<SharedRAbundVector*>& thisLookup, int start, int end, bool doAll, vector<Calculator*>& calcs, ostream& outputFileHandle, ostream& outAll, vector< vector<seqDist> >& calcDists) { 
 	try {
 		
 		//loop through calculators and add to file all for all calcs that can do mutiple groups
-		if (mult == true) {
-			ofstream outAll;
-			m->openOutputFile(sumAllFile, outAll);
-			
+		if (doAll) {
 			//output label
 			outAll << thisLookup[0]->getLabel() << '\t';
 			
@@ -972,23 +829,19 @@ int SummarySharedCommand::driver(vector<SharedRAbundVector*> thisLookup, int sta
 			outNames = outNames.substr(0, outNames.length()-1); //rip off extra '-';
 			outAll << outNames << '\t';
 			
-			for(int i=0;i<sumCalculators.size();i++){
-				if (sumCalculators[i]->getMultiple() == true) { 
-					sumCalculators[i]->getValues(thisLookup);
+			for(int i=0;i<calcs.size();i++){
+				if (calcs[i]->getMultiple() == true) { 
+					calcs[i]->getValues(thisLookup);
 					
-					if (m->control_pressed) { outAll.close(); return 1; }
+					if (m->control_pressed) { return 1; }
 					
 					outAll << '\t';
-					sumCalculators[i]->print(outAll);
+					calcs[i]->print(outAll);
 				}
 			}
 			outAll << endl;
-			outAll.close();
 		}
 		
-		ofstream outputFileHandle;
-		m->openOutputFile(sumFile, outputFileHandle);
-		
 		vector<SharedRAbundVector*> subset;
 		for (int k = start; k < end; k++) { // pass cdd each set of groups to compare
 
@@ -1007,32 +860,29 @@ int SummarySharedCommand::driver(vector<SharedRAbundVector*> thisLookup, int sta
 					outputFileHandle << (thisLookup[k]->getGroup() +'\t' + thisLookup[l]->getGroup()) << '\t'; //print out groups
 				}
 				
-				for(int i=0;i<sumCalculators.size();i++) {
+				for(int i=0;i<calcs.size();i++) {
 					
 					//if this calc needs all groups to calculate the pair load all groups
-					if (sumCalculators[i]->getNeedsAll()) { 
+					if (calcs[i]->getNeedsAll()) { 
 						//load subset with rest of lookup for those calcs that need everyone to calc for a pair
 						for (int w = 0; w < thisLookup.size(); w++) {
 							if ((w != k) && (w != l)) { subset.push_back(thisLookup[w]); }
 						}
 					}
 					
-					vector<double> tempdata = sumCalculators[i]->getValues(subset); //saves the calculator outputs
+					vector<double> tempdata = calcs[i]->getValues(subset); //saves the calculator outputs
 					
-					if (m->control_pressed) { outputFileHandle.close(); return 1; }
+					if (m->control_pressed) { return 1; }
 					
 					outputFileHandle << '\t';
-					sumCalculators[i]->print(outputFileHandle);
+					calcs[i]->print(outputFileHandle);
 					
-					seqDist temp(l, k, tempdata[0]);
-					calcDists[i].push_back(temp);
+					calcDists[i][(k*(k-1))/2+l].dist = tempdata[0];
 				}
 				outputFileHandle << endl;
 			}
 		}
 		
-		outputFileHandle.close();
-		
 		return 0;
 	}
 	catch(exception& e) {
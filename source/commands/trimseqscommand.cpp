@@ -668,14 +668,20 @@ int TrimSeqsCommand::driverCreateTrim(string filename, string qFileName, string
 			}
 		}
 		
-		ifstream inFASTA;
-		m->openInputFile(filename, inFASTA);
-		inFASTA.seekg(line.start);
+		#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+			BlockReader inFASTA(filename, line.start, line.end);
+		#else
+			//windows pieces hold a number of sequences, so read to the end of the file
+			BlockReader inFASTA(filename, line.start, numeric_limits<unsigned long long>::max());
+		#endif
 		
-		ifstream qFile;
+		BlockReader* qFile = NULL;
 		if(qFileName != "")	{
-			m->openInputFile(qFileName, qFile);
-			qFile.seekg(qline.start);  
+			#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+				qFile = new BlockReader(qFileName, qline.start, qline.end);
+			#else
+				qFile = new BlockReader(qFileName, qline.start, numeric_limits<unsigned long long>::max());
+			#endif
 		}
 		
 		int count = 0;
@@ -724,9 +730,9 @@ int TrimSeqsCommand::driverCreateTrim(string filename, string qFileName, string
             
 			if (m->control_pressed) {
                 delete trimOligos; if (reorient) { delete rtrimOligos; }
-				inFASTA.close(); trimFASTAFile.close(); scrapFASTAFile.close();
+				trimFASTAFile.close(); scrapFASTAFile.close();
 				if ((createGroup) && (countfile == "")) {	 outGroupsFile.close();   }
-                if(qFileName != "")	{	qFile.close();	scrapQualFile.close(); trimQualFile.close();	}
+                if(qFileName != "")	{	delete qFile;	scrapQualFile.close(); trimQualFile.close();	}
                 if(nameFile != "")	{	scrapNameFile.close(); trimNameFile.close();	}
                 if(countfile != "")	{	scrapCountFile.close(); trimCountFile.close();	}
 				for (int i = 0; i < outputNames.size(); i++) {	m->mothurRemove(outputNames[i]); } return 0;
@@ -737,13 +743,13 @@ int TrimSeqsCommand::driverCreateTrim(string filename, string qFileName, string
             string commentString = "";
 			int currentSeqsDiffs = 0;
 
-			Sequence currSeq(inFASTA); m->gobble(inFASTA);
+			Sequence currSeq(inFASTA);
 			//cout << currSeq.getName() << '\t' << currSeq.getUnaligned() << endl;
             Sequence savedSeq(currSeq.getName(), currSeq.getAligned());
             
 			QualityScores currQual; QualityScores savedQual;
 			if(qFileName != ""){
-				currQual = QualityScores(qFile);  m->gobble(qFile);
+				currQual = QualityScores(*qFile);
                 savedQual.setName(currQual.getName()); savedQual.setScores(currQual.getScores());
                 //cout << currQual.getName() << endl;
 			}
@@ -1054,13 +1060,7 @@ int TrimSeqsCommand::driverCreateTrim(string filename, string qFileName, string
 				count++;
 			}
 			
-			#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-				unsigned long long pos = inFASTA.tellg();
-				if ((pos == -1) || (pos >= line.end)) { break; }
-			
-			#else
-				if (inFASTA.eof()) { break; }
-			#endif
+			if (inFASTA.eof()) { break; }
 			
 			//report progress
 			if((count) % 1000 == 0){	m->mothurOutJustToScreen(toString(count)+"\n"); 		}
@@ -1071,11 +1071,10 @@ int TrimSeqsCommand::driverCreateTrim(string filename, string qFileName, string
 		
 		delete trimOligos;
         if (reorient) { delete rtrimOligos; }
-		inFASTA.close();
 		trimFASTAFile.close();
 		scrapFASTAFile.close();
 		if (createGroup) {	 outGroupsFile.close();   }
-		if(qFileName != "")	{	qFile.close();	scrapQualFile.close(); trimQualFile.close();	}
+		if(qFileName != "")	{	delete qFile;	scrapQualFile.close(); trimQualFile.close();	}
 		if(nameFile != "")	{	scrapNameFile.close(); trimNameFile.close();	}
         if(countfile != "")	{	scrapCountFile.close(); trimCountFile.close();	}
 		
@@ -712,12 +712,14 @@ int UnifracUnweightedCommand::runRandomCalcs(Tree* thisTree, vector<double> user
         Unweighted unweighted(includeRoot);
         
         //get unweighted scores for random trees - if random is false iters = 0
+        //we need different random trees because when we swap the labels we only want to swap those in each pairwise comparison
+        vector<EstOutput> allRandomData = unweighted.getRandomValues(thisTree, iters, processors);
+        
+        if (m->control_pressed) { return 0; }
+        
         for (int j = 0; j < iters; j++) {
             
-            //we need a different getValues because when we swap the labels we only want to swap those in each pairwise comparison
-            randomData = unweighted.getValues(thisTree, "", "", processors, outputDir);
-            
-            if (m->control_pressed) { return 0; }
+            randomData = allRandomData[j];
 			
             for(int k = 0; k < numComp; k++) {	
                 //add trees unweighted score to map of scores
@@ -711,11 +711,8 @@ int UnifracWeightedCommand::runRandomCalcs(Tree* thisTree, vector<double> usersS
         }
        
         //get scores for random trees
-        for (int j = 0; j < iters; j++) {
-            createProcesses(thisTree,  namesOfGroupCombos, rScores);
-            if (m->control_pressed) { delete ct;  for (int i = 0; i < T.size(); i++) { delete T[i]; } delete output; outSum.close(); for (int i = 0; i < outputNames.size(); i++) {	m->mothurRemove(outputNames[i]);  } return 0; }
-            
-        }
+        createProcesses(thisTree,  namesOfGroupCombos, rScores);
+        if (m->control_pressed) { delete ct;  for (int i = 0; i < T.size(); i++) { delete T[i]; } delete output; outSum.close(); for (int i = 0; i < outputNames.size(); i++) {	m->mothurRemove(outputNames[i]);  } return 0; }
         lines.clear();
         
         //find the signifigance of the score for summary file
@@ -748,162 +745,34 @@ int UnifracWeightedCommand::runRandomCalcs(Tree* thisTree, vector<double> usersS
 }
 /**************************************************************************************************/
 
+//the threads are started once for all the random trees, each scores its combinations for every iteration with its own random
+//generator. Each combination's scores are only touched by one thread.  One processor keeps mothur's generator.
 int UnifracWeightedCommand::createProcesses(Tree* t, vector< vector<string> > namesOfGroupCombos, vector< vector<double> >& scores) {
 	try {
-        int process = 1;
-		vector<int> processIDS;
-		EstOutput results;
-        bool recalc = false;
+        DenseTree randT(t, m->getGroups());
         
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-		//loop through and create all the processes you want
-		while (process != processors) {
-			pid_t pid = fork();
-			
-			if (pid > 0) {
-				processIDS.push_back(pid);  //create map from line number to pid so you can append files in correct order later
-				process++;
-			}else if (pid == 0){
-				driver(t, namesOfGroupCombos, lines[process].start, lines[process].end, scores);
-			
-				//pass numSeqs to parent
-				ofstream out;
-				string tempFile = outputDir + m->mothurGetpid(process) + ".weightedcommand.results.temp";
-				m->openOutputFile(tempFile, out);
-				for (int i = lines[process].start; i < (lines[process].start + lines[process].end); i++) { out << scores[i][(scores[i].size()-1)] << '\t';  } out << endl;
-				out.close();
-				
-				exit(0);
-			}else { 
-                m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(process) + "\n"); processors = process;
-                for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-                //wait to die
-                for (int i=0;i<processIDS.size();i++) {
-                    int temp = processIDS[i];
-                    wait(&temp);
-                }
-                m->control_pressed = false;
-                for (int i=0;i<processIDS.size();i++) {
-                    m->mothurRemove(outputDir + (toString(processIDS[i]) + ".weightedcommand.results.temp"));
-                }
-                recalc = true;
-                break;
-			}
-		}
-		
-        if (recalc) {
-            //test line, also set recalc to true.
-            //for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); } for (int i=0;i<processIDS.size();i++) { int temp = processIDS[i]; wait(&temp); } m->control_pressed = false;  for (int i=0;i<processIDS.size();i++) {m->mothurRemove(outputDir + (toString(processIDS[i]) + ".weightedcommand.results.temp"));}processors=3; m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(processors) + "\n");
-            
-            lines.clear();
+        if (processors == 1) {
+            driver(&randT, namesOfGroupCombos, lines[0].start, lines[0].end, iters, scores, NULL);
+        }else {
+            int seed = m->getRandomNumber();
             
-            //breakdown work between processors
-            int remainingPairs = namesOfGroupCombos.size();
-            int startIndex = 0;
-            for (int remainingProcessors = processors; remainingProcessors > 0; remainingProcessors--) {
-                int numPairs = remainingPairs; //case for last processor
-                if (remainingProcessors != 1) { numPairs = ceil(remainingPairs / remainingProcessors); }
-                lines.push_back(linePair(startIndex, numPairs)); //startIndex, numPairs
-                startIndex = startIndex + numPairs;
-                remainingPairs = remainingPairs - numPairs;
+            vector<DenseTree*> randTrees;
+            vector<mt19937_64*> engines;
+            vector<thread*> workerThreads;
+            for (int i = 0; i < lines.size(); i++) { randTrees.push_back(new DenseTree(randT)); engines.push_back(new mt19937_64(seed + i)); }
+            for (int i = 1; i < lines.size(); i++) {
+                workerThreads.push_back(new thread(&UnifracWeightedCommand::driver, this, randTrees[i], namesOfGroupCombos, lines[i].start, lines[i].end, iters, ref(scores), engines[i]));
             }
             
-            results.clear();
-            processIDS.resize(0);
-            process = 1;
+            driver(randTrees[0], namesOfGroupCombos, lines[0].start, lines[0].end, iters, scores, engines[0]);
             
-            //loop through and create all the processes you want
-            while (process != processors) {
-                pid_t pid = fork();
-                
-                if (pid > 0) {
-                    processIDS.push_back(pid);  //create map from line number to pid so you can append files in correct order later
-                    process++;
-                }else if (pid == 0){
-                    driver(t, namesOfGroupCombos, lines[process].start, lines[process].end, scores);
-                    
-                    //pass numSeqs to parent
-                    ofstream out;
-                    string tempFile = outputDir + m->mothurGetpid(process) + ".weightedcommand.results.temp";
-                    m->openOutputFile(tempFile, out);
-                    for (int i = lines[process].start; i < (lines[process].start + lines[process].end); i++) { out << scores[i][(scores[i].size()-1)] << '\t';  } out << endl;
-                    out.close();
-                    
-                    exit(0);
-                }else { 
-                    m->mothurOut("[ERROR]: unable to spawn the necessary processes."); m->mothurOutEndLine(); 
-                    for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-                    exit(0);
-                }
+            for (int i = 0; i < workerThreads.size(); i++) {
+                workerThreads[i]->join();
+                delete workerThreads[i];
             }
+            for (int i = 0; i < engines.size(); i++) { delete randTrees[i]; delete engines[i]; }
         }
         
-		driver(t, namesOfGroupCombos, lines[0].start, lines[0].end, scores);
-		
-		//force parent to wait until all the processes are done
-		for (int i=0;i<(processors-1);i++) { 
-			int temp = processIDS[i];
-			wait(&temp);
-		}
-		
-		//get data created by processes
-		for (int i=0;i<(processors-1);i++) { 
-	
-			ifstream in;
-			string s = outputDir + toString(processIDS[i]) + ".weightedcommand.results.temp";
-			m->openInputFile(s, in);
-			
-			double tempScore;
-			for (int j = lines[(i+1)].start; j < (lines[(i+1)].start + lines[(i+1)].end); j++) { in >> tempScore; scores[j].push_back(tempScore); }
-			in.close();
-			m->mothurRemove(s);
-		}
-#else
-        //fill in functions
-        vector<weightedRandomData*> pDataArray;
-		DWORD   dwThreadIdArray[processors-1];
-		HANDLE  hThreadArray[processors-1];
-        vector<CountTable*> cts;
-        vector<Tree*> trees;
-		
-		//Create processor worker threads.
-		for( int i=1; i<processors; i++ ){
-            CountTable* copyCount = new CountTable();
-            copyCount->copy(ct);
-            Tree* copyTree = new Tree(copyCount);
-            copyTree->getCopy(t);
-            
-            cts.push_back(copyCount);
-            trees.push_back(copyTree);
-            
-            vector< vector<double> > copyScores = rScores;
-            
-            weightedRandomData* tempweighted = new weightedRandomData(m, lines[i].start, lines[i].end, namesOfGroupCombos, copyTree, copyCount, includeRoot, copyScores);
-			pDataArray.push_back(tempweighted);
-			processIDS.push_back(i);
-            
-			hThreadArray[i-1] = CreateThread(NULL, 0, MyWeightedRandomThreadFunction, pDataArray[i-1], 0, &dwThreadIdArray[i-1]);
-		}
-		
-		driver(t, namesOfGroupCombos, lines[0].start, lines[0].end, scores);
-		
-		//Wait until all threads have terminated.
-		WaitForMultipleObjects(processors-1, hThreadArray, TRUE, INFINITE);
-		
-		//Close all thread handles and free memory allocations.
-		for(int i=0; i < pDataArray.size(); i++){
-            for (int j = pDataArray[i]->start; j < (pDataArray[i]->start+pDataArray[i]->num); j++) {
-                scores[j].push_back(pDataArray[i]->scores[j][pDataArray[i]->scores[j].size()-1]);
-            }
-			delete cts[i];
-            delete trees[i];
-			CloseHandle(hThreadArray[i]);
-			delete pDataArray[i];
-		}
-
-		
-#endif	
-        
         return 0;
 	}
 	catch(exception& e) {
@@ -913,41 +782,34 @@ int UnifracWeightedCommand::createProcesses(Tree* t, vector< vector<string> > na
 }
 
 /**************************************************************************************************/
-int UnifracWeightedCommand::driver(Tree* t, vector< vector<string> > namesOfGroupCombos, int start, int num, vector< vector<double> >& scores) { 
- try {
-		Tree* randT = new Tree(ct);
-     
-        Weighted weighted(includeRoot);
-     
-		for (int h = start; h < (start+num); h++) {
-	
-			if (m->control_pressed) { return 0; }
-		
-			//initialize weighted score
-			string groupA = namesOfGroupCombos[h][0]; 
-			string groupB = namesOfGroupCombos[h][1];
-			
-			//copy T[i]'s info.
-			randT->getCopy(t);
-			 
-			//create a random tree with same topology as T[i], but different labels
-			randT->assembleRandomUnifracTree(groupA, groupB);
-			
-			if (m->control_pressed) { delete randT;  return 0;  }
-
-			//get wscore of random tree
-			EstOutput randomData = weighted.getValues(randT, groupA, groupB);
+int UnifracWeightedCommand::driver(DenseTree* randT, vector< vector<string> > namesOfGroupCombos, int start, int num, int numIters, vector< vector<double> >& scores, mt19937_64* engine) { 
+	try {
+		Weighted weighted(includeRoot);
 		
-			if (m->control_pressed) { delete randT;  return 0;  }
-										
-			//save scores
-			scores[h].push_back(randomData[0]);
+		for (int j = 0; j < numIters; j++) {
+			for (int h = start; h < (start+num); h++) {
+				
+				if (m->control_pressed) { return 0; }
+				
+				vector<int> groups;
+				groups.push_back(randT->getGroupIndex(namesOfGroupCombos[h][0]));
+				groups.push_back(randT->getGroupIndex(namesOfGroupCombos[h][1]));
+				
+				//create a random tree with same topology as T[i], but different labels
+				randT->resetLabels();
+				randT->randomLabels(groups, engine);
+				
+				//get wscore of random tree
+				EstOutput randomData = weighted.getValues(randT, groups[0], groups[1]);
+				
+				if (m->control_pressed) { return 0;  }
+				
+				//save scores
+				scores[h].push_back(randomData[0]);
+			}
 		}
-	
-		delete randT;
-	
+		
 		return 0;
-
 	}
 	catch(exception& e) {
 		m->errorOut(e, "UnifracWeightedCommand", "driver");
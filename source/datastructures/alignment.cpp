@@ -15,7 +15,7 @@
 
 /**************************************************************************************************/
 
-Alignment::Alignment() {	m = MothurOut::getInstance(); /*	do nothing	*/	}
+Alignment::Alignment() {	m = MothurOut::getInstance(); banded = false; usingBand = false; /*	do nothing	*/	}
 
 /**************************************************************************************************/
 
@@ -23,6 +23,7 @@ Alignment::Alignment(int A) : nCols(A), nRows(A) {
 	try {
  
 		m = MothurOut::getInstance();
+		banded = false; usingBand = false;
 		alignment.resize(nRows);			//	For the Gotoh and Needleman-Wunsch we initialize the dynamic programming
 		for(int i=0;i<nRows;i++){			//	matrix by initializing a matrix that is A x A.  By default we will set A
 			alignment[i].resize(nCols);		//	at 2000 for 16S rRNA gene sequences
@@ -39,6 +40,7 @@ Alignment::Alignment(int A, int nk) : nCols(A), nRows(A) {
     try {
         
         m = MothurOut::getInstance();
+        banded = false; usingBand = false;
         alignment.resize(nRows);			//	For the Gotoh and Needleman-Wunsch we initialize the dynamic programming
         for(int i=0;i<nRows;i++){			//	matrix by initializing a matrix that is A x A.  By default we will set A
             alignment[i].resize(nCols);		//	at 2000 for 16S rRNA gene sequences
@@ -54,6 +56,8 @@ void Alignment::resize(int A) {
 	try {
 		nCols = A;
 		nRows = A;
+		
+		if (alignment.size() == 0) { return; } //not allocated yet, initializeMatrix will use the new size
 
 		alignment.resize(nRows);			
 		for(int i=0;i<nRows;i++){			
@@ -66,6 +70,217 @@ void Alignment::resize(int A) {
 	}
 }
 /**************************************************************************************************/
+//allocates the nRows x nCols matrix, the first row points left and the first column points up with scores of zero
+void Alignment::initializeMatrix() {
+	try {
+		alignment.resize(nRows);
+		for(int i=0;i<nRows;i++){ alignment[i].resize(nCols); }
+		
+		for(int i=1;i<nCols;i++){
+			alignment[0][i].prevCell = 'l';
+			alignment[0][i].cValue = 0;
+			alignment[0][i].dValue = 0;
+		}
+		
+		for(int i=1;i<nRows;i++){
+			alignment[i][0].prevCell = 'u';
+			alignment[i][0].cValue = 0;
+			alignment[i][0].iValue = 0;
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Alignment", "initializeMatrix");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//aligns seqA and seqB in the band around the seed diagonal, if the band does not hold the alignment every diagonal is filled
+void Alignment::alignBanded() {
+	try {
+		int low, high;
+		if (findBand(low, high)) {
+			fillBand(low, high);
+			setBandedOverlap();
+			traceBack();
+			
+			if (bandCoversPath()) { return; }
+		}
+		
+		fillBand(2-lA, lB-2);
+		setBandedOverlap();
+		traceBack();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Alignment", "alignBanded");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//finds the band of diagonals to fill from the 8mers shared by seqA and seqB. The diagonals that have at least
+//an eighth as many shared 8mers as the best diagonal are covered, plus bandPadding diagonals on each side.
+//Returns false if there are too few shared 8mers to trust, the best diagonal needs a hit for every seedCoverage
+//bases of the shorter sequence. Pairs with fewer hits are not much alike and their best overlap may be a few
+//bases at the ends of the sequences, which no band would find.
+static const int seedSize = 8;
+static const int minSeedHits = 4;
+static const int seedCoverage = 32;
+static const int minBandPadding = 16;
+static const int bandMargin = 8;
+
+bool Alignment::findBand(int& low, int& high) {
+	try {
+		if ((lA < seedSize+1) || (lB < seedSize+1)) { return false; }
+		
+		int codes[256];
+		for (int i = 0; i < 256; i++) { codes[i] = -1; }
+		codes['A'] = 0; codes['C'] = 1; codes['G'] = 2; codes['T'] = 3; codes['U'] = 3;
+		codes['a'] = 0; codes['c'] = 1; codes['g'] = 2; codes['t'] = 3; codes['u'] = 3;
+		
+		int numSeeds = 1 << (2*seedSize);
+		int seedMask = numSeeds - 1;
+		if (seedHeads.size() != numSeeds) { seedHeads.assign(numSeeds, -1); }
+		seedNext.resize(lB);
+		seedVotes.assign(lA+lB, 0); //diagonal d is at d + lA
+		
+		//index the 8mers of seqB by their last position
+		int seed = 0; int run = 0;
+		for (int i = 1; i < lB; i++) {
+			int code = codes[(unsigned char)seqB[i]];
+			if (code == -1) { run = 0; continue; }
+			seed = ((seed << 2) | code) & seedMask; run++;
+			if (run >= seedSize) { seedNext[i] = seedHeads[seed]; seedHeads[seed] = i; }
+		}
+		
+		seed = 0; run = 0;
+		for (int j = 1; j < lA; j++) {
+			int code = codes[(unsigned char)seqA[j]];
+			if (code == -1) { run = 0; continue; }
+			seed = ((seed << 2) | code) & seedMask; run++;
+			if (run >= seedSize) {
+				for (int i = seedHeads[seed]; i != -1; i = seedNext[i]) { seedVotes[i - j + lA]++; }
+			}
+		}
+		
+		//reset the index for the next alignment
+		seed = 0; run = 0;
+		for (int i = 1; i < lB; i++) {
+			int code = codes[(unsigned char)seqB[i]];
+			if (code == -1) { run = 0; continue; }
+			seed = ((seed << 2) | code) & seedMask; run++;
+			if (run >= seedSize) { seedHeads[seed] = -1; }
+		}
+		
+		int bestVotes = *max_element(seedVotes.begin(), seedVotes.end());
+		if ((bestVotes < minSeedHits) || ((bestVotes * seedCoverage) < (min(lA, lB) - 1))) { return false; }
+		
+		int threshold = max(2, bestVotes / 8);
+		low = lB; high = -lA;
+		for (int d = 0; d < seedVotes.size(); d++) {
+			if (seedVotes[d] >= threshold) { low = min(low, d - lA); high = max(high, d - lA); }
+		}
+		
+		int padding = max(minBandPadding, (lA-1) / 10);
+		low -= padding; high += padding;
+		
+		return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Alignment", "findBand");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//sets up the storage to fill the diagonals from low to high, clipped to the matrix
+void Alignment::startBand(int low, int high) {
+	try {
+		usingBand = true;
+		bandLow = max(low, 2-lA);	//	row 1, column lA-1
+		bandHigh = min(high, lB-2);	//	row lB-1, column 1
+		if (bandHigh < bandLow) { bandHigh = bandLow; }
+		bandWidth = bandHigh - bandLow + 1;
+		
+		bandMoves.assign(((long long)lB * bandWidth + 3) / 4, 0);
+		
+		float negativeInfinity = -numeric_limits<float>::infinity();
+		bandLastColumn.assign(lB, (lA == 1) ? 0 : negativeInfinity); bandLastColumn[0] = 0;
+		bandLastRow.assign(lA, (lB == 1) ? 0 : negativeInfinity); bandLastRow[0] = 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Alignment", "startBand");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//same as Overlap::setOverlap, cells outside the band are never the highest scoring. If the best score of the
+//last column or the last row is within bandMargin diagonals of the edge of the band, the band may have cut off
+//a better end, so bandEdgeBest is set and the alignment is redone with every diagonal.
+void Alignment::setBandedOverlap() {
+	try {
+		float max = -100;
+		int rowIndex = lA - 1;
+		for (int i = 0; i < lB; i++) {
+			if (bandLastColumn[i] >= max) { rowIndex = i; max = bandLastColumn[i]; }
+		}
+		
+		max = -100;
+		int colIndex = lB - 1;
+		for (int i = 0; i < lA; i++) {
+			if (bandLastRow[i] >= max) { colIndex = i; max = bandLastRow[i]; }
+		}
+		
+		bandEdgeBest = nearBandEdge(rowIndex - (lA-1)) || nearBandEdge((lB-1) - colIndex);
+		
+		int row = lB-1;
+		int column = lA-1;
+		overlapUpRow = lB; overlapLeftColumn = lA;
+		
+		if(colIndex == column && rowIndex == row){}
+		else if(bandLastRow[colIndex] < bandLastColumn[rowIndex])	{ overlapUpRow = rowIndex;		}
+		else														{ overlapLeftColumn = colIndex;	}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Alignment", "setBandedOverlap");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//true if the traceback stayed at least bandMargin diagonals inside the edges of the band that cut the matrix.
+//If the traceback never entered the band the best end of the alignment was on the first row or column, and
+//there may be a better one outside the band.
+bool Alignment::bandCoversPath() {
+	if (bandEscaped || bandEdgeBest) { return false; }
+	if (pathLow > pathHigh) { return false; }
+	if (nearBandEdge(pathLow) || nearBandEdge(pathHigh)) { return false; }
+	return true;
+}
+/**************************************************************************************************/
+//true if the diagonal is within bandMargin diagonals of an edge of the band that cuts the matrix
+bool Alignment::nearBandEdge(int diagonal) {
+	if ((bandLow > (2-lA)) && (diagonal < (bandLow + bandMargin))) { return true; }
+	if ((bandHigh < (lB-2)) && (diagonal > (bandHigh - bandMargin))) { return true; }
+	return false;
+}
+/**************************************************************************************************/
+//the pointer for a cell, 'o' if a banded traceback leaves the band
+char Alignment::getMove(int row, int column) {
+	if (!usingBand) { return alignment[row][column].prevCell; }
+	
+	if (row == 0)		{ if (column == 0) { return 'x'; } return 'l'; }
+	if (column == 0)	{ return 'u'; }
+	if ((column == lA-1) && (row > overlapUpRow))		{ return 'u'; }
+	if ((row == lB-1) && (column > overlapLeftColumn))	{ return 'l'; }
+	
+	int diagonal = row - column;
+	if ((diagonal < bandLow) || (diagonal > bandHigh)) { return 'o'; }
+	pathLow = min(pathLow, diagonal); pathHigh = max(pathHigh, diagonal);
+	
+	long long index = (long long)row * bandWidth + (bandHigh - diagonal);
+	int move = (bandMoves[index >> 2] >> ((index & 3) * 2)) & 3;
+	if (move == 0)		{ return 'd'; }
+	else if (move == 1)	{ return 'u'; }
+	return 'l';
+}
+/**************************************************************************************************/
 
 void Alignment::traceBack(){			//	This traceback routine is used by the dynamic programming algorithms
 	try {	
@@ -77,33 +292,38 @@ void Alignment::traceBack(){			//	This traceback routine is used by the dynamic
 		int column = lA-1;
 		//	seqAstart = 1;
 		//	seqAend = column;
+		bandEscaped = false; pathLow = lB; pathHigh = -lA;
 		
-		AlignmentCell currentCell = alignment[row][column];	//	Start the traceback from the bottom-right corner of the
+		char currentMove = getMove(row, column);	//	Start the traceback from the bottom-right corner of the
 		//	matrix
 		
-		if(currentCell.prevCell == 'x'){	seqAaln = seqBaln = "NOALIGNMENT";		}//If there's an 'x' in the bottom-
+		if(currentMove == 'x'){	seqAaln = seqBaln = "NOALIGNMENT";		}//If there's an 'x' in the bottom-
 		else{	//	right corner bail out because it means nothing got aligned
             int count = 0;
-			while(currentCell.prevCell != 'x'){				//	while the previous cell isn't an 'x', keep going...
+			while(currentMove != 'x'){				//	while the previous cell isn't an 'x', keep going...
 				
-				if(currentCell.prevCell == 'u'){			//	if the pointer to the previous cell is 'u', go up in the
+				if(currentMove == 'u'){			//	if the pointer to the previous cell is 'u', go up in the
 					seqAaln = '-' + seqAaln;				//	matrix.  this indicates that we need to insert a gap in
 					seqBaln = seqB[row] + seqBaln;			//	seqA and a base in seqB
                     BBaseMap[row] = count;
-					currentCell = alignment[--row][column];
+					currentMove = getMove(--row, column);
 				}
-				else if(currentCell.prevCell == 'l'){		//	if the pointer to the previous cell is 'l', go to the left
+				else if(currentMove == 'l'){		//	if the pointer to the previous cell is 'l', go to the left
 					seqBaln = '-' + seqBaln;				//	in the matrix.  this indicates that we need to insert a gap
 					seqAaln = seqA[column] + seqAaln;		//	in seqB and a base in seqA
                     ABaseMap[column] = count;
-					currentCell = alignment[row][--column];
+					currentMove = getMove(row, --column);
+				}
+				else if(currentMove == 'o'){	//	a banded alignment left the band, it will be redone with every diagonal
+					bandEscaped = true;
+					return;
 				}
 				else{
 					seqAaln = seqA[column] + seqAaln;		//	otherwise we need to go diagonally up and to the left,
 					seqBaln = seqB[row] + seqBaln;			//	here we add a base to both alignments
                     BBaseMap[row] = count;
                     ABaseMap[column] = count;
-					currentCell = alignment[--row][--column];
+					currentMove = getMove(--row, --column);
 				}
                 count++;
 			}
@@ -10,6 +10,13 @@
  *
  *  This is a class for an abstract datatype for classes that implement various types of alignment	algorithms.
  *	As of 12/18/08 these included alignments based on blastn, needleman-wunsch, and the	Gotoh algorithms
+ *
+ *	The Needleman and Gotoh classes can also align in banded mode (setBanded). Only the cells on the diagonals
+ *	near the diagonal of the shared 8mers are filled, keeping two rows of scores and a 2 bit pointer per cell
+ *	instead of the full matrix. If the traceback or the best score of the last row or column comes within
+ *	bandMargin diagonals of the edge of the band, or there is no clear seed diagonal, the band is widened to
+ *	every diagonal and the alignment is redone. Otherwise the banded alignment is kept, so if the best path of the
+ *	full matrix lies outside the band while the banded path stays clear of its edges, the two can differ.
  * 
  */
 
@@ -42,10 +49,32 @@ public:
 	int getPairwiseLength();
 	void resize(int);
 	int getnRows() { return nRows; }
+	void setBanded(bool b) { banded = b; }
 //	int getLongestTemplateGap();
 
 protected:
 	void traceBack();
+	void initializeMatrix();
+	
+	void alignBanded();
+	virtual void fillBand(int, int) {} //fills the cells on the diagonals between the two values, see NeedlemanOverlap and GotohOverlap
+	bool findBand(int&, int&);
+	void startBand(int, int);
+	void setBandedOverlap();
+	bool bandCoversPath();
+	bool nearBandEdge(int);
+	char getMove(int, int);
+	void setBandMove(int row, int column, int move) { //move is 0 for 'd', 1 for 'u' and 2 for 'l'
+		long long index = (long long)row * bandWidth + (bandHigh - (row - column));
+		bandMoves[index >> 2] |= (unsigned char)(move << ((index & 3) * 2));
+	}
+	
+	bool banded, usingBand, bandEscaped, bandEdgeBest;
+	int bandLow, bandHigh, bandWidth, overlapUpRow, overlapLeftColumn, pathLow, pathHigh; //diagonals are row - column
+	vector<unsigned char> bandMoves;
+	vector<float> bandLastColumn, bandLastRow; //cValues of the last column and row
+	vector<float> bandC, bandPrevC, bandD, bandPrevD; //cValues and dValues of the current and previous rows
+	vector<int> seedHeads, seedNext, seedVotes;
 	string seqA, seqAaln;
 	string seqB, seqBaln;
 	int seqAstart, seqAend;
@@ -85,7 +85,7 @@ AlignmentDB::AlignmentDB(string fastaFileName, string s, int kmerSize, float gap
 			
 		}
 		else if(method == "suffix")		{	search = new SuffixDB(numSeqs);								}
-		else if(method == "blast")		{	search = new BlastDB(fastaFileName.substr(0,fastaFileName.find_last_of(".")+1), gapOpen, gapExtend, match, misMatch, "", threadID);	}
+		else if(method == "blast")		{	search = new BlastDB();	}
 		else {
 			method = "kmer";
 			m->mothurOut(method + " is not a valid search option. I will run the command using kmer, ksize=8.");
@@ -127,7 +127,7 @@ AlignmentDB::AlignmentDB(string s){
 		method = s;
 		
 		if(method == "suffix")		{	search = new SuffixDB();	}
-		else if(method == "blast")	{	search = new BlastDB("", 0);		}
+		else if(method == "blast")	{	search = new BlastDB();		}
 		else						{	search = new KmerDB();		}
 
 				
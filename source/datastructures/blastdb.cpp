@@ -1,10 +1,18 @@
 /*
  *  blastdb.cpp
- *  
+ *
  *
  *  Created by Pat Schloss on 12/22/08.
  *  Copyright 2008 Patrick D. Schloss. All rights reserved.
  *
+ *	The seed is 12 of 19 bases, spaced the way PatternHunter's seeds are so that the third base of a codon or any
+ *	single difference in a run of matches costs fewer hits than it does with a contiguous word.  The templates are
+ *	indexed every indexStride bases, so a run of 22 matching bases always gives a hit.  blastall -W 28 and megablast
+ *	needed 28.
+ *
+ *	The scores are blastn's 1/-3 for findClosestSequences and megablast's 1/-2 for findClosestMegaBlast, with gaps
+ *	5/2.  As with the blast executables, the gap and match parameters of the calling command are not used.
+ *
  */
 
 
@@ -12,242 +20,134 @@
 #include "sequence.hpp"
 #include "blastdb.hpp"
 
-/**************************************************************************************************/
+static const char spacedSeed[] = "1110100110010101111";
+static const int seedSpan = 19;
+static const int indexStride = 4;
+static const int minBucketBits = 10;
 
-BlastDB::BlastDB(string tag, float gO, float gE, float mm, float mM, string b, int tid) : Database(), 
-gapOpen(gO), gapExtend(gE), match(mm), misMatch(mM) {
-	try {
-		count = 0;
-		path = b;
-		threadID = tid;
-
-		int randNumber = m->getRandomNumber();;
-		//int randNumber = 12345;
-		string pid = m->mothurGetpid(threadID);
-		
-        if (m->debug) { m->mothurOut("[DEBUG]: tag = " + tag + "\t pid = " + pid + "\n"); }
-        
-		dbFileName = tag + pid + toString(randNumber) + ".template.unaligned.fasta";
-		queryFileName = tag + pid + toString(randNumber) + ".candidate.unaligned.fasta";
-		blastFileName = tag + pid + toString(randNumber) + ".blast";
-		
-		//make sure blast exists in the write place
-		if (path == "") {
-			path = m->getBlastPath();
-			//string tempPath = path;
-			//for (int i = 0; i < path.length(); i++) { tempPath[i] = tolower(path[i]); }
-			//path = path.substr(0, (tempPath.find_last_of('m')));
-			
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-			path += "blast/bin/";	
-#else
-			path += "blast\\bin\\";
-#endif			
-		}
-		
-		
-		string formatdbCommand;
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-		formatdbCommand = path + "formatdb";	//	format the database, -o option gives us the ability
-#else
-		formatdbCommand = path + "formatdb.exe";
-#endif
-		
-		//test to make sure formatdb exists
-		ifstream in;
-		formatdbCommand = m->getFullPathName(formatdbCommand);
-		int ableToOpen = m->openInputFile(formatdbCommand, in, "no error"); in.close();
-		if(ableToOpen == 1) {	m->mothurOut("[ERROR]: " + formatdbCommand + " file does not exist. mothur requires formatdb.exe."); m->mothurOutEndLine(); m->control_pressed = true; }
-		
-		string blastCommand;
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-		blastCommand = path + "blastall";	//	format the database, -o option gives us the ability
-#else
-		blastCommand = path + "blastall.exe";
-		//wrap entire string in ""
-		//blastCommand = "\"" + blastCommand + "\"";
-#endif
-		
-		//test to make sure formatdb exists
-		ifstream in2;
-		blastCommand = m->getFullPathName(blastCommand);
-		ableToOpen = m->openInputFile(blastCommand, in2, "no error"); in2.close();
-		if(ableToOpen == 1) {	m->mothurOut("[ERROR]: " + blastCommand + " file does not exist. mothur requires blastall.exe."); m->mothurOutEndLine(); m->control_pressed = true; }
-		
-		
-		string megablastCommand;
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-		megablastCommand = path + "megablast";	//	format the database, -o option gives us the ability
-#else
-		megablastCommand = path + "megablast.exe";
-#endif
-		
-		//test to make sure formatdb exists
-		ifstream in3;
-		megablastCommand = m->getFullPathName(megablastCommand);
-		ableToOpen = m->openInputFile(megablastCommand, in3, "no error"); in3.close();
-		if(ableToOpen == 1) {	m->mothurOut("[ERROR]: " +  megablastCommand + " file does not exist. mothur requires megablast.exe."); m->mothurOutEndLine(); m->control_pressed = true; }
-        
-	}
-	catch(exception& e) {
-		m->errorOut(e, "BlastDB", "BlastDB");
-		exit(1);
-	}
+//	blastall -p blastn, expect 10
+static const BlastDB::blastScoring blastnScoring = { 1, -3, 5, 2, 20, 30, 20, 1.374, 0.711, 10.0 };
+//	megablast -e 1e-10
+static const BlastDB::blastScoring megablastScoring = { 1, -2, 5, 2, 20, 30, 20, 1.28, 0.46, 1e-10 };
+
+static const int negInf = INT_MIN / 4;
+
+/**************************************************************************************************/
+struct seedHit {
+	int seq, diagonal, queryPos;
+	seedHit(int s, int d, int q) : seq(s), diagonal(d), queryPos(q) {}
+};
+inline bool compareSeedHits(const seedHit& left, const seedHit& right) {
+	if (left.seq != right.seq) { return (left.seq < right.seq); }
+	if (left.diagonal != right.diagonal) { return (left.diagonal < right.diagonal); }
+	return (left.queryPos < right.queryPos);
 }
 /**************************************************************************************************/
+//	score, identities and alignment length of the best alignment ending at a cell
+struct xDropCell {
+	int score, identities, length;
+	xDropCell() : score(negInf), identities(0), length(0) {}
+	xDropCell(int s, int i, int l) : score(s), identities(i), length(l) {}
+};
+/**************************************************************************************************/
+//	gapped X-drop extension of a and b away from an anchor, a[i*step] and b[j*step].  Returns the best score and fills
+//	the identities, length and how much of a and b that alignment uses.  Only the cells within xDrop of the best are kept.
+static int xDropExtend(const char* a, int aLength, const char* b, int bLength, int step, const BlastDB::blastScoring& sc,
+					   int& identities, int& length, int& aUsed, int& bUsed) {
 
-BlastDB::BlastDB(string b, int tid) : Database() {
-	try {
-		count = 0;
-		
-		path = b;
-		threadID = tid;
-		
-		//make sure blast exists in the write place
-		if (path == "") {
-			path = m->getBlastPath();
-			//string tempPath = path;
-			//for (int i = 0; i < path.length(); i++) { tempPath[i] = tolower(path[i]); }
-			//path = path.substr(0, (tempPath.find_last_of('m')));
-			
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-			path += "blast/bin/";	
-#else
-			path += "blast\\bin\\";
-#endif			
-		}
-		
-		int randNumber = m->getRandomNumber();;
-		string pid = m->mothurGetpid(threadID);
-		dbFileName = pid + toString(randNumber) + ".template.unaligned.fasta";
-		queryFileName = pid + toString(randNumber) + ".candidate.unaligned.fasta";
-		blastFileName = pid + toString(randNumber) + ".blast";
-		
-		string formatdbCommand;
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-		formatdbCommand = path + "formatdb";	//	format the database, -o option gives us the ability
-#else
-		formatdbCommand = path + "formatdb.exe";
-		//wrap entire string in ""
-		//formatdbCommand = "\"" + formatdbCommand + "\"";
-#endif
-		
-		//test to make sure formatdb exists
-		ifstream in;
-		formatdbCommand = m->getFullPathName(formatdbCommand);
-		int ableToOpen = m->openInputFile(formatdbCommand, in, "no error"); in.close();
-		if(ableToOpen == 1) {	m->mothurOut("[ERROR]: " +  formatdbCommand + " file does not exist. mothur requires formatdb.exe."); m->mothurOutEndLine(); m->control_pressed = true; }
-		
-		string blastCommand;
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-		blastCommand = path + "blastall";	//	format the database, -o option gives us the ability
-#else
-		blastCommand = path + "blastall.exe";
-		//wrap entire string in ""
-		//blastCommand = "\"" + blastCommand + "\"";
-#endif
-		
-		//test to make sure formatdb exists
-		ifstream in2;
-		blastCommand = m->getFullPathName(blastCommand);
-		ableToOpen = m->openInputFile(blastCommand, in2, "no error"); in2.close();
-		if(ableToOpen == 1) {	m->mothurOut("[ERROR]: " + blastCommand + " file does not exist. mothur requires blastall.exe."); m->mothurOutEndLine(); m->control_pressed = true; }
-		
-		
-		string megablastCommand;
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-		megablastCommand = path + "megablast";	//	format the database, -o option gives us the ability
-#else
-		megablastCommand = path + "megablast.exe";
-		//wrap entire string in ""
-		//megablastCommand = "\"" + megablastCommand + "\"";
-#endif
-		
-		//test to make sure formatdb exists
-		ifstream in3;
-		megablastCommand = m->getFullPathName(megablastCommand);
-		ableToOpen = m->openInputFile(megablastCommand, in3, "no error"); in3.close();
-		if(ableToOpen == 1) {	m->mothurOut("[ERROR]: " + megablastCommand + " file does not exist. mothur requires megablast.exe."); m->mothurOutEndLine(); m->control_pressed = true; }
-		
-		
+	int gapStart = sc.gapOpen + sc.gapExtend;
+	vector<xDropCell> prevH(bLength+1), prevF(bLength+1), curH(bLength+1), curF(bLength+1);
+
+	int best = 0; identities = 0; length = 0; aUsed = 0; bUsed = 0;
+
+	//	first row is a gap in a
+	int prevLo = 0, prevHi = 0;
+	prevH[0] = xDropCell(0, 0, 0);
+	for (int j = 1; j <= bLength; j++) {
+		int score = -(sc.gapOpen + sc.gapExtend * j);
+		if (score < -sc.gappedXDrop) { break; }
+		prevH[j] = xDropCell(score, 0, j);
+		prevHi = j;
 	}
-	catch(exception& e) {
-		m->errorOut(e, "BlastDB", "BlastDB");
-		exit(1);
+
+	for (int i = 1; i <= aLength; i++) {
+		int curLo = -1, curHi = -1;
+		xDropCell E;
+		char baseA = a[(i-1)*step];
+
+		for (int j = prevLo; j <= bLength; j++) {
+			if ((j > prevHi+1) && (E.score < best - sc.gappedXDrop)) { break; }
+
+			xDropCell F;
+			if (j <= prevHi) {
+				if (prevH[j].score - gapStart >= prevF[j].score - sc.gapExtend) { F = xDropCell(prevH[j].score - gapStart, prevH[j].identities, prevH[j].length+1); }
+				else { F = xDropCell(prevF[j].score - sc.gapExtend, prevF[j].identities, prevF[j].length+1); }
+			}
+
+			xDropCell H;
+			if ((j >= 1) && (j-1 >= prevLo) && (j-1 <= prevHi) && (prevH[j-1].score != negInf)) {
+				char baseB = b[(j-1)*step];
+				bool same = ((baseA == baseB) && (baseA != 4));
+				H = xDropCell(prevH[j-1].score + (same ? sc.match : sc.misMatch), prevH[j-1].identities + (same ? 1 : 0), prevH[j-1].length+1);
+			}
+			if (E.score > H.score) { H = E; }
+			if (F.score > H.score) { H = F; }
+
+			if (H.score < best - sc.gappedXDrop) { H = xDropCell(); }
+			if (F.score < best - sc.gappedXDrop) { F = xDropCell(); }
+			curH[j] = H; curF[j] = F;
+
+			if (H.score != negInf) {
+				if (curLo == -1) { curLo = j; }
+				curHi = j;
+				if (H.score > best) { best = H.score; identities = H.identities; length = H.length; aUsed = i; bUsed = j; }
+			}
+
+			//	gap in a for the next column
+			if (H.score - gapStart >= E.score - sc.gapExtend) { E = xDropCell(H.score - gapStart, H.identities, H.length+1); }
+			else { E = xDropCell(E.score - sc.gapExtend, E.identities, E.length+1); }
+		}
+
+		if (curLo == -1) { break; }
+		prevH.swap(curH); prevF.swap(curF);
+		prevLo = curLo; prevHi = curHi;
 	}
+
+	return best;
 }
+/**************************************************************************************************/
+
+BlastDB::BlastDB() : Database() { bucketBits = minBucketBits; seqStarts.push_back(0); }
 
 /**************************************************************************************************/
 
-BlastDB::~BlastDB(){
+BlastDB::~BlastDB(){}
+
+/**************************************************************************************************/
+//assumes you have added all the template sequences using the addSequence function and run generateDB.
+vector<int> BlastDB::findClosestSequences(Sequence* seq, int n) {
 	try{
-		m->mothurRemove(queryFileName);				//	let's clean stuff up and remove the temp files
-		m->mothurRemove(dbFileName);					//	let's clean stuff up and remove the temp files
-		m->mothurRemove((dbFileName+".nsq"));					//	let's clean stuff up and remove the temp files
-		m->mothurRemove((dbFileName+".nsi"));					//	let's clean stuff up and remove the temp files
-		m->mothurRemove((dbFileName+".nsd"));					//	let's clean stuff up and remove the temp files
-		m->mothurRemove((dbFileName+".nin"));					//	let's clean stuff up and remove the temp files
-		m->mothurRemove((dbFileName+".nhr"));					//	let's clean stuff up and remove the temp files
-		m->mothurRemove(blastFileName.c_str());				//	let's clean stuff up and remove the temp files
+		vector<int> topMatches = findClosestSequences(seq, n, searchScore);
+		Scores.clear();
+		return topMatches;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "BlastDB", "~BlastDB");
+		m->errorOut(e, "BlastDB", "findClosestSequences");
 		exit(1);
 	}
+
 }
 /**************************************************************************************************/
-//assumes you have added all the template sequences using the addSequence function and run generateDB.
-vector<int> BlastDB::findClosestSequences(Sequence* seq, int n) {
+//score is set to the percent identity of the best match, or 0 if there is none
+vector<int> BlastDB::findClosestSequences(Sequence* seq, int n, float& score) {
 	try{
 		vector<int> topMatches;
-		
-		ofstream queryFile;
-		int randNumber = m->getRandomNumber();;
-		string pid = scrubName(seq->getName());
-		
-		m->openOutputFile((queryFileName+pid+toString(randNumber)), queryFile);
-		queryFile << '>' << seq->getName() << endl;
-		queryFile << seq->getUnaligned() << endl;
-		queryFile.close();
-
-				
-		//	the goal here is to quickly survey the database to find the closest match.  To do this we are using the default
-		//	wordsize used in megablast.  I'm sure we're sacrificing accuracy for speed, but anyother way would take way too
-		//	long.  With this setting, it seems comparable in speed to the suffix tree approach.
-		
-		string blastCommand;
-		#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-		
-			blastCommand = path + "blastall -p blastn -d " + dbFileName + " -m 8 -W 28 -v " + toString(n) + " -b " + toString(n);
-			blastCommand += (" -i " + (queryFileName+pid+toString(randNumber)) + " -o " + blastFileName+pid+toString(randNumber));
-		#else
-			blastCommand =  "\"" + path + "blastall\" -p blastn -d " + "\"" + dbFileName + "\"" + " -m 8 -W 28 -v " + toString(n) + " -b " + toString(n);
-			blastCommand += (" -i " + (queryFileName+pid+toString(randNumber)) + " -o " + blastFileName+pid+toString(randNumber));
-			//wrap entire string in ""
-			blastCommand = "\"" + blastCommand + "\"";
-		#endif
-		
-		system(blastCommand.c_str());
-		
-		ifstream m8FileHandle;
-		m->openInputFile(blastFileName+pid+toString(randNumber), m8FileHandle, "no error");
-		
-		string dummy;
-		int templateAccession;
-		m->gobble(m8FileHandle);
-		
-		while(!m8FileHandle.eof()){
-			m8FileHandle >> dummy >> templateAccession >> searchScore;
-			
-			//get rest of junk in line
-			while (!m8FileHandle.eof())	{	char c = m8FileHandle.get(); if (c == 10 || c == 13){	break;	}	} 
-			
-			m->gobble(m8FileHandle);
-			topMatches.push_back(templateAccession);
-		}
-		m8FileHandle.close();
-		m->mothurRemove((queryFileName+pid+toString(randNumber)));
-		m->mothurRemove((blastFileName+pid+toString(randNumber)));
+		score = 0;
+
+		vector<blastHit> hits = search(seq, n, blastnScoring);
+
+		for (int i = 0; i < hits.size(); i++) { topMatches.push_back(hits[i].seq); }
+		if (hits.size() != 0) { score = hits[0].percentID; }
 
 		return topMatches;
 	}
@@ -260,65 +160,33 @@ vector<int> BlastDB::findClosestSequences(Sequence* seq, int n) {
 /**************************************************************************************************/
 //assumes you have added all the template sequences using the addSequence function and run generateDB.
 vector<int> BlastDB::findClosestMegaBlast(Sequence* seq, int n, int minPerID) {
+	try{
+		vector<int> topMatches = findClosestMegaBlast(seq, n, minPerID, Scores);
+		searchScore = 0;
+		if (Scores.size() != 0) { searchScore = Scores[Scores.size()-1]; }
+		return topMatches;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "BlastDB", "findClosestMegaBlast");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//scores is set to the percent identity of each match returned
+vector<int> BlastDB::findClosestMegaBlast(Sequence* seq, int n, int minPerID, vector<float>& scores) {
 	try{
 		vector<int> topMatches;
-		float numBases, mismatch, gap, startQuery, endQuery, startRef, endRef, score;
-		Scores.clear();
-		
-		ofstream queryFile;
-		int randNumber = m->getRandomNumber();
-		string pid = scrubName(seq->getName());
-		
-		m->openOutputFile((queryFileName+pid+toString(randNumber)), queryFile);
-		queryFile << '>' << seq->getName() << endl;
-		queryFile << seq->getUnaligned() << endl;
-		queryFile.close();
-//		cout << seq->getUnaligned() << endl;
-		//	the goal here is to quickly survey the database to find the closest match.  To do this we are using the default
-		//	wordsize used in megablast.  I'm sure we're sacrificing accuracy for speed, but anyother way would take way too
-		//	long.  With this setting, it seems comparable in speed to the suffix tree approach.
-//7000004128189528left	0	100		66	0	0	1	66	61	126	1e-31	 131	
-		string blastCommand;
-		#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-			blastCommand = path + "megablast -e 1e-10 -d " + dbFileName + " -m 8 -b " + toString(n) + " -v " + toString(n); //-W 28 -p blastn
-			blastCommand += (" -i " + (queryFileName+pid+toString(randNumber)) + " -o " + blastFileName+pid+toString(randNumber));
-		#else
-		//blastCommand = path + "blast\\bin\\megablast -e 1e-10 -d " + dbFileName + " -m 8 -b " + toString(n) + " -v " + toString(n); //-W 28 -p blastn
-		//blastCommand += (" -i " + (queryFileName+toString(randNumber)) + " -o " + blastFileName+toString(randNumber));
-
-			blastCommand =  "\"" + path + "megablast\" -e 1e-10 -d " + "\"" + dbFileName + "\"" + " -m 8 -b " + toString(n) + " -v " + toString(n); //-W 28 -p blastn
-			blastCommand += (" -i " + (queryFileName+pid+toString(randNumber)) + " -o " + blastFileName+pid+toString(randNumber));
-			//wrap entire string in ""
-			blastCommand = "\"" + blastCommand + "\"";
-
-		#endif
-		system(blastCommand.c_str());
-
-		ifstream m8FileHandle;
-		m->openInputFile(blastFileName+pid+toString(randNumber), m8FileHandle, "no error");
-	
-		string dummy, eScore;
-		int templateAccession;
-		m->gobble(m8FileHandle);
-		
-		while(!m8FileHandle.eof()){
-			m8FileHandle >> dummy >> templateAccession >> searchScore >> numBases >> mismatch >> gap >> startQuery >> endQuery >> startRef >> endRef >> eScore >> score;
-//			cout << dummy << '\t' << templateAccession << '\t' << searchScore << '\t' << numBases << '\t' << mismatch << '\t' << gap << '\t' << startQuery << '\t' << endQuery << '\t' << startRef << '\t' << endRef << '\t' << eScore << '\t' << score << endl; 
-			
-			//get rest of junk in line
-			//while (!m8FileHandle.eof())	{	char c = m8FileHandle.get(); if (c == 10 || c == 13){	break;	}else{ cout << c; }	} //
-				//cout << endl;
-			m->gobble(m8FileHandle);
-			if (searchScore >= minPerID) { 
-				topMatches.push_back(templateAccession);
-				Scores.push_back(searchScore);
+		scores.clear();
+
+		vector<blastHit> hits = search(seq, n, megablastScoring);
+
+		for (int i = 0; i < hits.size(); i++) {
+			if (hits[i].percentID >= minPerID) {
+				topMatches.push_back(hits[i].seq);
+				scores.push_back(hits[i].percentID);
 			}
-//cout << templateAccession << endl;
 		}
-		m8FileHandle.close();
-		m->mothurRemove((queryFileName+pid+toString(randNumber)));
-		m->mothurRemove((blastFileName+pid+toString(randNumber)));
-//cout << "\n" ;		
+
 		return topMatches;
 	}
 	catch(exception& e) {
@@ -327,70 +195,231 @@ vector<int> BlastDB::findClosestMegaBlast(Sequence* seq, int n, int minPerID) {
 	}
 }
 /**************************************************************************************************/
-void BlastDB::addSequence(Sequence seq) {
-	try {
-	
-		ofstream unalignedFastaFile;
-		m->openOutputFileAppend(dbFileName, unalignedFastaFile);				
-	
-		//	generating a fasta file with unaligned template
-		unalignedFastaFile << '>' << count << endl;					//	sequences, which will be input to formatdb
-		unalignedFastaFile << seq.getUnaligned() << endl;
-		unalignedFastaFile.close();
-	
-		count++;
+//the n best templates for either strand of the query, best first
+vector<BlastDB::blastHit> BlastDB::search(Sequence* seq, int n, const blastScoring& sc) {
+	try{
+		vector<blastHit> hits;
+		if (seedKeys.size() == 0) { return hits; }
+
+		string query = seq->getUnaligned();
+		vector<char> forward; forward.reserve(query.length());
+		for (int i = 0; i < query.length(); i++) {
+			switch (toupper(query[i])) {
+				case 'A': forward.push_back(0); break;
+				case 'C': forward.push_back(1); break;
+				case 'G': forward.push_back(2); break;
+				case 'T': case 'U': forward.push_back(3); break;
+				case '-': case '.': break;
+				default: forward.push_back(4); break;
+			}
+		}
+
+		vector<char> reverse(forward.size());
+		for (int i = 0; i < forward.size(); i++) {
+			char base = forward[forward.size()-1-i];
+			reverse[i] = ((base == 4) ? 4 : (3 - base));
+		}
+
+		map<int, vector<blastHit> > alignments;
+		searchStrand(forward, sc, alignments);
+		if (m->control_pressed) { return hits; }
+		searchStrand(reverse, sc, alignments);
+
+		//	templates whose best alignment is significant
+		double searchSpace = sc.K * (double)forward.size() * (double)bases.size();
+		for (map<int, vector<blastHit> >::iterator it = alignments.begin(); it != alignments.end(); it++) {
+			blastHit best = it->second[0];
+			for (int i = 1; i < it->second.size(); i++) {
+				if (it->second[i].score > best.score) { best = it->second[i]; }
+			}
+			double eValue = searchSpace * exp(-sc.lambda * best.score);
+			if (eValue <= sc.maxEValue) { hits.push_back(best); }
+		}
+
+		//	best score first, ties go to the earlier template
+		stable_sort(hits.begin(), hits.end(), compareHits);
+		if (hits.size() > n) { hits.resize(n); }
+
+		return hits;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "BlastDB", "addSequence");
+		m->errorOut(e, "BlastDB", "search");
 		exit(1);
 	}
 }
 /**************************************************************************************************/
-void BlastDB::generateDB() {
-	try {
-	
-		//m->mothurOut("Generating the temporary BLAST database...\t");	cout.flush();
-			
-		string formatdbCommand;
-		
-		#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-			formatdbCommand = path + "formatdb -p F -o T -i " + dbFileName;	//	format the database, -o option gives us the ability
-		#else
-			//formatdbCommand = path + "blast\\bin\\formatdb -p F -o T -i " + dbFileName;	//	format the database, -o option gives us the ability
-
-			formatdbCommand = "\"" + path + "formatdb\" -p F -o T -i " + "\"" +  dbFileName + "\"";
-			//wrap entire string in ""
-			formatdbCommand = "\"" + formatdbCommand + "\"";
-		#endif
-		//cout << formatdbCommand << endl;
-		system(formatdbCommand.c_str());								//	to get the right sequence names, i think. -p F
-																	//	option tells formatdb that seqs are DNA, not prot
-		//m->mothurOut("DONE."); m->mothurOutEndLine();	m->mothurOutEndLine(); cout.flush();
+//adds the alignments of one strand of the query to alignments, which holds every alignment found for each template
+void BlastDB::searchStrand(const vector<char>& query, const blastScoring& sc, map<int, vector<blastHit> >& alignments) {
+	try{
+		int queryLength = query.size();
+		if (queryLength < seedSpan) { return; }
+
+		//	every seed hit as its template, diagonal and query position
+		vector<seedHit> seedHits;
+		for (int i = 0; i + seedSpan <= queryLength; i++) {
+			unsigned int key;
+			if (!getSeedKey(&query[i], key)) { continue; }
+
+			unsigned int bucket = (key * 2654435761U) >> (32 - bucketBits);
+			for (unsigned int k = bucketStarts[bucket]; k < bucketStarts[bucket+1]; k++) {
+				if (seedKeys[k] != key) { continue; }
+				int seqIndex = getSeqIndex(seedPositions[k]);
+				int templatePos = seedPositions[k] - seqStarts[seqIndex];
+				seedHits.push_back(seedHit(seqIndex, templatePos - i, i));
+			}
+		}
+		sort(seedHits.begin(), seedHits.end(), compareSeedHits);
+
+		int lastSeq = -1, lastDiagonal = 0, extendedTo = 0;
+		int numNew = 0;	//	alignments found on this strand for lastSeq
+
+		for (int h = 0; h < seedHits.size(); h++) {
+			if (m->control_pressed) { return; }
+
+			int seqIndex = seedHits[h].seq, diagonal = seedHits[h].diagonal, queryPos = seedHits[h].queryPos;
+
+			if (seqIndex != lastSeq) { numNew = 0; }
+			if ((seqIndex == lastSeq) && (diagonal == lastDiagonal) && (queryPos < extendedTo)) { continue; } //already extended over this hit
+			lastSeq = seqIndex; lastDiagonal = diagonal;
+
+			const char* templateSeq = &bases[seqStarts[seqIndex]];
+			int templateLength = seqStarts[seqIndex+1] - seqStarts[seqIndex];
+
+			//	ungapped extension, the seed itself first
+			int score = 0;
+			for (int i = 0; i < seedSpan; i++) {
+				char base = query[queryPos+i];
+				score += (((base == templateSeq[queryPos+diagonal+i]) && (base != 4)) ? sc.match : sc.misMatch);
+			}
+			int best = score, start = queryPos, end = queryPos + seedSpan;
+			int runScore = score;
+			for (int i = queryPos+seedSpan; (i < queryLength) && (i+diagonal < templateLength); i++) {
+				runScore += (((query[i] == templateSeq[i+diagonal]) && (query[i] != 4)) ? sc.match : sc.misMatch);
+				if (runScore > best) { best = runScore; end = i+1; }
+				else if (runScore < best - sc.ungappedXDrop) { break; }
+			}
+			runScore = best;
+			for (int i = queryPos-1; (i >= 0) && (i+diagonal >= 0); i--) {
+				runScore += (((query[i] == templateSeq[i+diagonal]) && (query[i] != 4)) ? sc.match : sc.misMatch);
+				if (runScore > best) { best = runScore; start = i; }
+				else if (runScore < best - sc.ungappedXDrop) { break; }
+			}
+			extendedTo = end;
+
+			if (best < sc.ungappedCutoff) { continue; }
+
+			//	anchor the gapped extension in the middle of the ungapped one, unless an alignment already covers it
+			int queryAnchor = (start + end) / 2;
+			int templateAnchor = queryAnchor + diagonal;
+
+			vector<blastHit>& seqAlignments = alignments[seqIndex];
+			bool covered = false;
+			for (int i = seqAlignments.size() - numNew; i < seqAlignments.size(); i++) {
+				if ((queryAnchor >= seqAlignments[i].queryStart) && (queryAnchor < seqAlignments[i].queryEnd) &&
+					(templateAnchor >= seqAlignments[i].templateStart) && (templateAnchor < seqAlignments[i].templateEnd)) { covered = true; break; }
+			}
+			if (covered) { continue; }
+
+			int rightIDs, rightLength, rightQuery, rightTemplate, leftIDs, leftLength, leftQueryUsed, leftTemplateUsed;
+			int rightScore = xDropExtend(&query[queryAnchor], queryLength - queryAnchor, templateSeq + templateAnchor, templateLength - templateAnchor, 1, sc, rightIDs, rightLength, rightQuery, rightTemplate);
+			int leftScore = 0; leftIDs = 0; leftLength = 0; leftQueryUsed = 0; leftTemplateUsed = 0;
+			if ((queryAnchor > 0) && (templateAnchor > 0)) {
+				leftScore = xDropExtend(&query[queryAnchor-1], queryAnchor, templateSeq + templateAnchor - 1, templateAnchor, -1, sc, leftIDs, leftLength, leftQueryUsed, leftTemplateUsed);
+			}
+
+			blastHit hit;
+			hit.seq = seqIndex;
+			hit.score = rightScore + leftScore;
+			hit.identities = rightIDs + leftIDs;
+			hit.length = rightLength + leftLength;
+			hit.queryStart = queryAnchor - leftQueryUsed; hit.queryEnd = queryAnchor + rightQuery;
+			hit.templateStart = templateAnchor - leftTemplateUsed; hit.templateEnd = templateAnchor + rightTemplate;
+
+			//	percent identity as blast's tabular output rounds it
+			hit.percentID = 0;
+			if (hit.length != 0) { hit.percentID = floor(10000.0 * hit.identities / (double) hit.length + 0.5) / 100.0; }
+
+			seqAlignments.push_back(hit);
+			numNew++;
+		}
 	}
 	catch(exception& e) {
-		m->errorOut(e, "BlastDB", "generateDB");
+		m->errorOut(e, "BlastDB", "searchStrand");
 		exit(1);
 	}
 }
 /**************************************************************************************************/
-string BlastDB::scrubName(string seqName) {
+bool BlastDB::compareHits(const blastHit& left, const blastHit& right) { return (left.score > right.score); }
+/**************************************************************************************************/
+//the bases under the seed's 1s packed 2 bits apiece, false if one of them is not A, C, G or T
+bool BlastDB::getSeedKey(const char* seq, unsigned int& key) {
+	key = 0;
+	for (int i = 0; i < seedSpan; i++) {
+		if (spacedSeed[i] == '0') { continue; }
+		if (seq[i] == 4) { return false; }
+		key = (key << 2) | seq[i];
+	}
+	return true;
+}
+/**************************************************************************************************/
+int BlastDB::getSeqIndex(unsigned int pos) {
+	return (int)(upper_bound(seqStarts.begin(), seqStarts.end(), pos) - seqStarts.begin()) - 1;
+}
+/**************************************************************************************************/
+void BlastDB::addSequence(Sequence seq) {
 	try {
-		
-		string cleanName = "";
-		
-		for (int i = 0; i < seqName.length(); i++) {
-			if (isalnum(seqName[i])) { cleanName += seqName[i]; }
-			else { cleanName += "_";  }
+
+		string unaligned = seq.getUnaligned();
+		for (int i = 0; i < unaligned.length(); i++) {
+			switch (toupper(unaligned[i])) {
+				case 'A': bases.push_back(0); break;
+				case 'C': bases.push_back(1); break;
+				case 'G': bases.push_back(2); break;
+				case 'T': case 'U': bases.push_back(3); break;
+				default: bases.push_back(4); break;
+			}
 		}
-		
-		return cleanName;
+		seqStarts.push_back(bases.size());
+
 	}
 	catch(exception& e) {
-		m->errorOut(e, "BlastDB", "scrubName");
+		m->errorOut(e, "BlastDB", "addSequence");
 		exit(1);
 	}
 }
 /**************************************************************************************************/
+//hashes a seed every indexStride bases of each template, the buckets are as many as the seeds rounded up to a power of 2
+void BlastDB::generateDB() {
+	try {
 
-/**************************************************************************************************/
+		vector<unsigned int> keys, positions;
+		for (int i = 0; i < seqStarts.size()-1; i++) {
+			for (unsigned int pos = seqStarts[i]; pos + seedSpan <= seqStarts[i+1]; pos += indexStride) {
+				unsigned int key;
+				if (getSeedKey(&bases[pos], key)) { keys.push_back(key); positions.push_back(pos); }
+			}
+		}
+
+		bucketBits = minBucketBits;
+		while (((1U << bucketBits) < keys.size()) && (bucketBits < 30)) { bucketBits++; }
+
+		int numBuckets = 1 << bucketBits;
+		bucketStarts.assign(numBuckets+1, 0);
+		for (int i = 0; i < keys.size(); i++) { bucketStarts[((keys[i] * 2654435761U) >> (32 - bucketBits)) + 1]++; }
+		for (int b = 0; b < numBuckets; b++) { bucketStarts[b+1] += bucketStarts[b]; }
+
+		seedKeys.resize(keys.size()); seedPositions.resize(keys.size());
+		vector<unsigned int> next(bucketStarts.begin(), bucketStarts.end()-1);
+		for (int i = 0; i < keys.size(); i++) {
+			unsigned int bucket = (keys[i] * 2654435761U) >> (32 - bucketBits);
+			seedKeys[next[bucket]] = keys[i]; seedPositions[next[bucket]] = positions[i];
+			next[bucket]++;
+		}
 
+	}
+	catch(exception& e) {
+		m->errorOut(e, "BlastDB", "generateDB");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
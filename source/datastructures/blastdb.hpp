@@ -4,42 +4,63 @@
 
 /*
  *  blastdb.hpp
- *  
+ *
  *
  *  Created by Pat Schloss on 12/22/08.
  *  Copyright 2008 Patrick D. Schloss. All rights reserved.
  *
+ *	The blast searches are done in mothur.  generateDB indexes the templates by a spaced seed in a hash table, a search
+ *	looks up the seeds of both strands of the query, extends the hits without gaps and then extends the good ones with
+ *	gaps, X-drop style.  Each template is scored by its best alignment, the way blastall and megablast ranked them.
+ *
+ *	The searches that return their scores through the last argument only read the index and keep their work in locals,
+ *	so several threads can use them on one BlastDB. The Database versions without it store the scores for getSearchScore
+ *	and getSearchScores, so they are only safe when one thread searches the object.
  */
 
 #include "mothur.h"
+#include "database.hpp"
 
 class BlastDB : public Database {
 
 public:
-	BlastDB(string, float, float, float, float, string, int);
-	BlastDB(string, int);
+	BlastDB();
 	~BlastDB();
-	
+
 	void generateDB();
 	void addSequence(Sequence);
 	vector<int> findClosestSequences(Sequence*, int);
+	vector<int> findClosestSequences(Sequence*, int, float&);
 	vector<int> findClosestMegaBlast(Sequence*, int, int);
-	
+	vector<int> findClosestMegaBlast(Sequence*, int, int, vector<float>&);
+
+	struct blastScoring {	//	scores and statistics for one kind of search
+		int match, misMatch, gapOpen, gapExtend;
+		int ungappedXDrop, gappedXDrop, ungappedCutoff;
+		double lambda, K, maxEValue;
+	};
+
 private:
-	
-	string scrubName(string);
-	
-	string dbFileName;
-	string queryFileName;
-	string blastFileName;
-	string path;
-	
-	int count, threadID;
-	float gapOpen;
-	float gapExtend;
-	float match;
-	float misMatch;
-	
+
+	struct blastHit {		//	the best alignment of a template to the query
+		int seq, score, identities, length;
+		float percentID;
+		int queryStart, queryEnd, templateStart, templateEnd;	//	box covered by the alignment, ends excluded
+	};
+
+	static bool compareHits(const blastHit&, const blastHit&);	//	sorts by score, largest first
+	vector<blastHit> search(Sequence*, int, const blastScoring&);
+	void searchStrand(const vector<char>&, const blastScoring&, map<int, vector<blastHit> >&);
+	bool getSeedKey(const char*, unsigned int&);
+	int getSeqIndex(unsigned int);
+
+	vector<char> bases;					//	the templates back to back, coded 0-3 and 4 for anything else
+	vector<unsigned int> seqStarts;		//	template i is bases[seqStarts[i]] to bases[seqStarts[i+1]-1]
+	vector<unsigned int> bucketStarts;	//	seeds hashed to bucket b are seedKeys[bucketStarts[b]] to seedKeys[bucketStarts[b+1]-1]
+	vector<unsigned int> seedKeys;
+	vector<unsigned int> seedPositions;	//	position of each seed in bases
+	int bucketBits;
+
 };
 
 #endif
@@ -0,0 +1,463 @@
+//
+//  blockreader.cpp
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#include "blockreader.h"
+
+#ifdef USE_BOOST
+#include <zlib.h>
+#endif
+
+static const unsigned long long readSize = 4194304; //bytes of a plain file read at a time
+static const int textSize = 4194304; //bytes of text in a chunk decompressed from a gzip stream
+static const int chunksAhead = 4; //chunks the decompressing thread may have waiting
+static const int membersPerThread = 32; //bgzf members of up to 64Kb each thread decompresses for a chunk
+static const int bgzfHeaderSize = 18;
+
+/**************************************************************************************************/
+BlockReader::BlockReader(string filename, int threads) {
+    try {
+        m = MothurOut::getInstance();
+        numThreads = threads; if (numThreads < 1) { numThreads = 1; }
+        open(filename);
+        remaining = numeric_limits<unsigned long long>::max();
+
+        if (gz) {
+#ifdef USE_BOOST
+            decompressThread = new thread(&BlockReader::decompress, this);
+#else
+            m->mothurOut("[ERROR]: Reading compressed .gz files requires mothur built with USEBOOST=yes, cannot read " + filename + ".\n"); m->control_pressed = true;
+            doneDecompressing = true;
+#endif
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BlockReader", "BlockReader");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+BlockReader::BlockReader(string filename, unsigned long long start, unsigned long long end) {
+    try {
+        m = MothurOut::getInstance();
+        numThreads = 1;
+        open(filename);
+        remaining = 0;
+
+        if (gz) { m->mothurOut("[ERROR]: " + filename + " is compressed, it can only be read from the start.\n"); m->control_pressed = true; doneDecompressing = true; }
+        else if (end > start) { in.clear(); in.seekg(start); remaining = end - start; bufferPosition = start; }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BlockReader", "BlockReader");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+BlockReader::~BlockReader() {
+    try {
+        if (decompressThread != NULL) {
+            {
+                lock_guard<mutex> lock(chunkLock);
+                stopping = true;
+            }
+            chunkSpace.notify_all();
+            decompressThread->join();
+            delete decompressThread;
+        }
+        for (int i = 0; i < chunks.size(); i++) { delete chunks[i]; }
+        in.close();
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BlockReader", "~BlockReader");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void BlockReader::open(string filename) {
+    try {
+        bufferStart = 0; bufferEnd = 0; bufferPosition = 0;
+        gz = false; decompressThread = NULL; doneDecompressing = false; stopping = false; error = "";
+
+        if (m->openInputFileBinary(filename, in) != 0) { m->control_pressed = true; return; }
+
+        //a gzip file starts with 0x1f 0x8b
+        streampos start = in.tellg();
+        unsigned char magic[2] = { 0, 0 };
+        in.read((char*)magic, 2);
+        gz = ((in.gcount() == 2) && (magic[0] == 0x1f) && (magic[1] == 0x8b));
+        in.clear(); in.seekg(start);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BlockReader", "open");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//moves the unread text to the front of the buffer and adds the next block after it, false when there is nothing left
+bool BlockReader::fill() {
+    try {
+        if (bufferStart != 0) {
+            if (bufferEnd != bufferStart) { memmove(buffer.data(), buffer.data() + bufferStart, bufferEnd - bufferStart); }
+            bufferEnd -= bufferStart; bufferPosition += bufferStart; bufferStart = 0;
+        }
+
+        if (!gz) {
+            if ((remaining == 0) || !in) { return false; }
+
+            unsigned long long toRead = readSize; if (remaining < toRead) { toRead = remaining; }
+            if (buffer.size() < (bufferEnd + toRead)) { buffer.resize(bufferEnd + toRead); }
+            in.read(buffer.data() + bufferEnd, toRead);
+
+            size_t numRead = in.gcount();
+            bufferEnd += numRead;
+            if (numRead < toRead) { remaining = 0; }
+            else { remaining -= numRead; }
+
+            return (numRead != 0);
+        }
+
+        vector<char>* chunk = NULL;
+        {
+            unique_lock<mutex> lock(chunkLock);
+            while (chunks.empty() && !doneDecompressing) { chunkReady.wait(lock); }
+
+            if (chunks.empty()) {
+                if (error != "") { m->mothurOut(error); m->control_pressed = true; error = ""; }
+                return false;
+            }
+            chunk = chunks.front(); chunks.pop_front();
+        }
+        chunkSpace.notify_one();
+
+        if (bufferEnd == 0) { buffer.swap(*chunk); bufferEnd = buffer.size(); }
+        else {
+            if (buffer.size() < (bufferEnd + chunk->size())) { buffer.resize(bufferEnd + chunk->size()); }
+            memcpy(buffer.data() + bufferEnd, chunk->data(), chunk->size());
+            bufferEnd += chunk->size();
+        }
+        delete chunk;
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BlockReader", "fill");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//skips white space like MothurOut::gobble, then finds the end of the line like MothurOut::getline.
+//Offsets are from bufferStart, which fill keeps at the start of the record.
+bool BlockReader::findLine(size_t& offset, size_t& lineStart, size_t& lineEnd) {
+    try {
+        while (true) {
+            if ((bufferStart + offset) == bufferEnd) { if (!fill()) { return false; } continue; }
+            if (!isspace((unsigned char)buffer[bufferStart + offset])) { break; }
+            offset++;
+        }
+
+        lineStart = offset;
+        while (true) {
+            const char* text = buffer.data() + bufferStart;
+            size_t length = bufferEnd - bufferStart;
+            while ((offset < length) && (text[offset] != '\n') && (text[offset] != '\r') && (text[offset] != '\f')) { offset++; }
+
+            if (offset < length) { lineEnd = offset; offset++; break; }
+            if (!fill()) { lineEnd = offset; break; }
+        }
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BlockReader", "findLine");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void BlockReader::setView(textView& view, size_t start, size_t end) {
+    view.data = buffer.data() + bufferStart + start;
+    view.length = end - start;
+}
+/**************************************************************************************************/
+bool BlockReader::getLine(textView& line) {
+    try {
+        size_t offset = 0; size_t lineStart, lineEnd;
+        if (!findLine(offset, lineStart, lineEnd)) { line = textView(); return false; }
+
+        setView(line, lineStart, lineEnd);
+        bufferStart += offset;
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BlockReader", "getLine");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+bool BlockReader::getFastq(fastqRecord& record) {
+    try {
+        size_t offset = 0;
+        size_t lineStarts[4], lineEnds[4];
+        if (!findLine(offset, lineStarts[0], lineEnds[0])) { record = fastqRecord(); return false; }
+
+        for (int i = 1; i < 4; i++) {
+            if (!findLine(offset, lineStarts[i], lineEnds[i])) { lineStarts[i] = offset; lineEnds[i] = offset; }
+        }
+
+        setView(record.header, lineStarts[0], lineEnds[0]);
+        setView(record.sequence, lineStarts[1], lineEnds[1]);
+        setView(record.header2, lineStarts[2], lineEnds[2]);
+        setView(record.quality, lineStarts[3], lineEnds[3]);
+        bufferStart += offset;
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BlockReader", "getFastq");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+bool BlockReader::getFasta(fastaRecord& record) {
+    try {
+        size_t offset = 0; size_t headerStart, headerEnd;
+        if (!findLine(offset, headerStart, headerEnd)) { record = fastaRecord(); return false; }
+
+        //the body runs to the next '>'
+        size_t bodyStart = offset;
+        while (true) {
+            const char* text = buffer.data() + bufferStart;
+            size_t length = bufferEnd - bufferStart;
+            const char* found = NULL;
+            if (offset < length) { found = (const char*)memchr(text + offset, '>', length - offset); }
+
+            if (found != NULL) { offset = found - text; break; }
+            offset = length;
+            if (!fill()) { break; }
+        }
+
+        setView(record.header, headerStart, headerEnd);
+        setView(record.body, bodyStart, offset);
+        bufferStart += offset;
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BlockReader", "getFasta");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+bool BlockReader::eof() {
+    try {
+        while (true) {
+            while ((bufferStart < bufferEnd) && isspace((unsigned char)buffer[bufferStart])) { bufferStart++; }
+            if (bufferStart < bufferEnd) { return false; }
+            if (!fill()) { return true; }
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BlockReader", "eof");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+#ifdef USE_BOOST
+//runs on its own thread, filling chunks until the file is decompressed or the reader is deleted
+void BlockReader::decompress() {
+    try {
+        if (!decompressMembers()) { decompressStream(); }
+
+        {
+            lock_guard<mutex> lock(chunkLock);
+            doneDecompressing = true;
+        }
+        chunkReady.notify_all();
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BlockReader", "decompress");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//waits for room in the queue, false if the reader is being deleted
+bool BlockReader::addChunk(vector<char>* chunk) {
+    try {
+        if (chunk->size() == 0) { delete chunk; return true; }
+
+        unique_lock<mutex> lock(chunkLock);
+        while (!stopping && (chunks.size() >= chunksAhead)) { chunkSpace.wait(lock); }
+        if (stopping) { delete chunk; return false; }
+
+        chunks.push_back(chunk);
+        lock.unlock();
+        chunkReady.notify_one();
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BlockReader", "addChunk");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//A bgzf member is a gzip member with a 'BC' extra field holding its compressed size, so the members can be split off
+//without decompressing them. The trailer of each member holds its decompressed size. Returns false, with the file at the
+//start of the member, when a member is not bgzf, so the rest is read as a plain gzip stream.
+bool BlockReader::decompressMembers() {
+    try {
+        int batchSize = numThreads * membersPerThread;
+        vector< vector<char> > members, texts;
+
+        while (!stopping) {
+            members.clear();
+            bool isBGZF = true;
+            bool truncated = false;
+
+            while (members.size() < batchSize) {
+                streampos memberStart = in.tellg();
+                unsigned char header[bgzfHeaderSize];
+                in.read((char*)header, bgzfHeaderSize);
+                int numRead = in.gcount();
+                if (numRead == 0) { break; }
+
+                //magic, deflate, FEXTRA, XLEN = 6, 'B', 'C', SLEN = 2, BSIZE
+                isBGZF = ((numRead == bgzfHeaderSize) && (header[0] == 0x1f) && (header[1] == 0x8b) && (header[2] == 8) && ((header[3] & 4) != 0)
+                          && (header[10] == 6) && (header[11] == 0) && (header[12] == 'B') && (header[13] == 'C') && (header[14] == 2) && (header[15] == 0));
+                int memberSize = 0;
+                if (isBGZF) { memberSize = (header[16] | (header[17] << 8)) + 1; }
+                if (memberSize < (bgzfHeaderSize + 8)) { isBGZF = false; }
+                if (!isBGZF) { in.clear(); in.seekg(memberStart); break; }
+
+                members.push_back(vector<char>(memberSize));
+                memcpy(members.back().data(), header, bgzfHeaderSize);
+                in.read(members.back().data() + bgzfHeaderSize, memberSize - bgzfHeaderSize);
+                if (in.gcount() != (memberSize - bgzfHeaderSize)) { truncated = true; members.pop_back(); break; }
+            }
+
+            if (members.size() != 0) {
+                texts.assign(members.size(), vector<char>());
+                atomic<int> nextMember(0);
+                atomic<bool> failed(false);
+
+                int numWorkers = numThreads;
+                if (numWorkers > members.size()) { numWorkers = members.size(); }
+
+                vector<thread*> workerThreads;
+                for (int i = 1; i < numWorkers; i++) { workerThreads.push_back(new thread(&BlockReader::inflateMembers, this, &members, &texts, &nextMember, &failed)); }
+                inflateMembers(&members, &texts, &nextMember, &failed);
+                for (int i = 0; i < workerThreads.size(); i++) { workerThreads[i]->join(); delete workerThreads[i]; }
+
+                if (failed) { lock_guard<mutex> lock(chunkLock); error = "[ERROR]: the compressed file is damaged, stopping.\n"; return true; }
+
+                size_t chunkSize = 0;
+                for (int i = 0; i < texts.size(); i++) { chunkSize += texts[i].size(); }
+                vector<char>* chunk = new vector<char>();
+                chunk->reserve(chunkSize);
+                for (int i = 0; i < texts.size(); i++) { chunk->insert(chunk->end(), texts[i].begin(), texts[i].end()); }
+                if (!addChunk(chunk)) { return true; }
+            }
+
+            if (truncated) { lock_guard<mutex> lock(chunkLock); error = "[ERROR]: the compressed file ends part way through a block, it may be truncated.\n"; return true; }
+            if (!isBGZF) { return false; }
+            if (members.size() < batchSize) { return true; } //end of file
+        }
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BlockReader", "decompressMembers");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void BlockReader::inflateMembers(vector< vector<char> >* members, vector< vector<char> >* texts, atomic<int>* nextMember, atomic<bool>* failed) {
+    try {
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        if (inflateInit2(&stream, 15+16) != Z_OK) { *failed = true; return; }
+
+        while (true) {
+            int i = (*nextMember)++;
+            if (i >= members->size()) { break; }
+
+            vector<char>& member = (*members)[i];
+            const unsigned char* trailer = (const unsigned char*)member.data() + member.size() - 4;
+            unsigned int size = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | ((unsigned int)trailer[3] << 24);
+
+            //one spare byte so an empty member still has somewhere to write
+            vector<char>& text = (*texts)[i];
+            text.resize(size + 1);
+
+            inflateReset(&stream);
+            stream.next_in = (Bytef*)member.data(); stream.avail_in = member.size();
+            stream.next_out = (Bytef*)text.data(); stream.avail_out = text.size();
+
+            int result = inflate(&stream, Z_FINISH);
+            if ((result != Z_STREAM_END) || (stream.total_out != size)) { *failed = true; }
+            text.resize(size);
+        }
+
+        inflateEnd(&stream);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BlockReader", "inflateMembers");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//decompresses the rest of the file on this thread, one gzip member after another
+void BlockReader::decompressStream() {
+    try {
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        if (inflateInit2(&stream, 15+32) != Z_OK) { lock_guard<mutex> lock(chunkLock); error = "[ERROR]: could not start decompressing the file.\n"; return; }
+
+        vector<char> input(readSize);
+        vector<char>* text = new vector<char>(textSize);
+        size_t used = 0;
+        bool inMember = false;
+        int numMembers = 0;
+
+        while (!stopping) {
+            if (stream.avail_in == 0) {
+                in.read(input.data(), input.size());
+                stream.next_in = (Bytef*)input.data(); stream.avail_in = in.gcount();
+                if (stream.avail_in == 0) {
+                    if (inMember) { lock_guard<mutex> lock(chunkLock); error = "[ERROR]: the compressed file ends part way through, it may be truncated.\n"; }
+                    break;
+                }
+            }
+
+            stream.next_out = (Bytef*)(text->data() + used); stream.avail_out = text->size() - used;
+            int result = inflate(&stream, Z_NO_FLUSH);
+            used = text->size() - stream.avail_out;
+
+            if (result == Z_STREAM_END) { inflateReset(&stream); inMember = false; numMembers++; }
+            else if (result == Z_OK) { inMember = true; }
+            else {
+                //padding after the last member is ignored, as gzip does
+                if (!((numMembers != 0) && (stream.total_out == 0))) { lock_guard<mutex> lock(chunkLock); error = "[ERROR]: the compressed file is damaged, stopping.\n"; }
+                break;
+            }
+
+            if (used == text->size()) {
+                if (!addChunk(text)) { text = NULL; break; }
+                text = new vector<char>(textSize);
+                used = 0;
+            }
+        }
+
+        if (text != NULL) { text->resize(used); addChunk(text); }
+        inflateEnd(&stream);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BlockReader", "decompressStream");
+        exit(1);
+    }
+}
+#endif
+/**************************************************************************************************/
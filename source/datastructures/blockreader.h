@@ -0,0 +1,96 @@
+//
+//  blockreader.h
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__blockreader__
+#define __Mothur__blockreader__
+
+#include "mothur.h"
+#include "mothurout.h"
+
+/* This class reads a text file in large blocks and hands out its lines and records as views into the block, so splitting
+ a record does not allocate or copy. A view is valid until the next call to the reader.
+
+ A .gz file is decompressed by a thread running ahead of the reader. When the file is bgzf, the blocked gzip written by
+ bgzip and many sequencers, each member records its compressed size and the members are decompressed on several threads
+ at once. Reading .gz files needs zlib, which is linked with the boost libraries, so it is only available with USE_BOOST.
+
+ A plain file can be read from a start to an end position, like the pieces made by MothurOut::divideFile.
+ */
+
+/**************************************************************************************************/
+
+struct textView {
+    const char* data; //not null terminated
+    int length;
+
+    textView() : data(NULL), length(0) {}
+    string getString() const { return string(data, length); }
+};
+
+/**************************************************************************************************/
+//the lines of a record, without their line ends. At the end of a file the missing lines are empty.
+struct fastqRecord {
+    textView header, sequence, header2, quality; //@name comment, bases, +name, scores
+};
+
+struct fastaRecord {
+    textView header, body; //>name comment, everything up to the next '>'
+};
+
+/**************************************************************************************************/
+
+class BlockReader {
+
+public:
+
+    BlockReader(string, int); //filename, number of threads decompressing a bgzf file
+    BlockReader(string, unsigned long long, unsigned long long); //filename, start, end. Plain text only.
+    ~BlockReader();
+
+    bool getLine(textView&); //false at the end of the file
+    bool getFastq(fastqRecord&); //false at the end of the file
+    bool getFasta(fastaRecord&); //false at the end of the file
+    bool eof(); //skips white space, like MothurOut::gobble, and reports whether anything is left
+    unsigned long long tell() { return bufferPosition + bufferStart; } //position of the next unread character in the text
+    bool isCompressed() { return gz; }
+
+private:
+
+    MothurOut* m;
+    ifstream in;
+
+    vector<char> buffer; //the unread text is buffer[bufferStart] to buffer[bufferEnd-1]
+    size_t bufferStart, bufferEnd;
+    unsigned long long bufferPosition; //position of buffer[0] in the text
+    unsigned long long remaining; //bytes of a plain file left to read
+    bool gz;
+
+    //the decompressing thread appends chunks of text and the reader takes them in order
+    thread* decompressThread;
+    deque< vector<char>* > chunks;
+    bool doneDecompressing;
+    atomic<bool> stopping; //set when the reader is deleted
+    string error; //found by the decompressing thread, reported by the reader
+    int numThreads;
+    mutex chunkLock;
+    condition_variable chunkReady, chunkSpace;
+
+    void open(string);
+    bool fill();
+    bool findLine(size_t&, size_t&, size_t&);
+    void setView(textView&, size_t, size_t);
+
+    void decompress();
+    void decompressStream();
+    bool decompressMembers();
+    void inflateMembers(vector< vector<char> >*, vector< vector<char> >*, atomic<int>*, atomic<bool>*);
+    bool addChunk(vector<char>*);
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -32,6 +32,11 @@ inline bool compareSeqMatches (seqMatch member, seqMatch member2){ //sorts large
 	}
 }
 /**************************************************************************************************/
+inline bool compareSeqMatchesThenIndex (const seqMatch& member, const seqMatch& member2){ //sorts largest to smallest, ties by smallest seq
+	if (member.match != member2.match) { return (member.match > member2.match); }
+	return (member.seq < member2.seq);
+}
+/**************************************************************************************************/
 inline bool compareSeqMatchesReverse (seqMatch member, seqMatch member2){ //sorts largest to smallest
 	if(member.match < member2.match){
 		return true;   }   
@@ -51,6 +56,7 @@ public:
 	virtual string getName(int) { return ""; }  
 	virtual vector<int> findClosestSequences(Sequence*, int) = 0;  // returns indexes of n closest sequences to query
 	virtual vector<int> findClosestMegaBlast(Sequence*, int, int){return results;}
+	virtual vector<int> findClosestMegaBlast(Sequence*, int, int, vector<float>&){return results;}  //sets the scores instead of storing them
 	virtual float getSearchScore();
 	virtual vector<float> getSearchScores() { return Scores; } //assumes you already called findClosestMegaBlast
 	virtual int getLongestBase(); 
@@ -0,0 +1,160 @@
+//
+//  densetree.cpp
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#include "densetree.h"
+
+/**************************************************************************************************/
+DenseTree::DenseTree(Tree* t, vector<string> g) : groups(g) {
+    try {
+        m = MothurOut::getInstance();
+
+        numNodes = t->getNumNodes();
+        numLeaves = t->getNumLeaves();
+        numGroups = groups.size();
+        numCols = 0;
+        root = numNodes-1;
+
+        CountTable* ct = t->getCountTable();
+        for (int j = 0; j < numGroups; j++) {
+            groupIndex[groups[j]] = j;
+            groupSizes.push_back(ct->getGroupCount(groups[j]));
+        }
+
+        parent.resize(numNodes); lchild.resize(numNodes); rchild.resize(numNodes); branchLength.resize(numNodes);
+        for (int i = 0; i < numNodes; i++) {
+            parent[i] = t->tree[i].getParent();
+            lchild[i] = t->tree[i].getLChild();
+            rchild[i] = t->tree[i].getRChild();
+            branchLength[i] = t->tree[i].getBranchLength();
+            if (parent[i] == -1) { root = i; }
+        }
+
+        leafCounts.resize(numLeaves*numGroups, 0);
+        leafDominant.resize(numLeaves*numGroups, 0);
+        for (int i = 0; i < numLeaves; i++) {
+            for (map<string, int>::iterator it = t->tree[i].pcount.begin(); it != t->tree[i].pcount.end(); it++) {
+                map<string, int>::iterator itIndex = groupIndex.find(it->first);
+                if (itIndex != groupIndex.end()) { leafCounts[i*numGroups+itIndex->second] = it->second; }
+            }
+            for (map<string, int>::iterator it = t->tree[i].pGroups.begin(); it != t->tree[i].pGroups.end(); it++) {
+                map<string, int>::iterator itIndex = groupIndex.find(it->first);
+                if (itIndex != groupIndex.end()) { leafDominant[i*numGroups+itIndex->second] = 1; }
+            }
+        }
+
+        resetLabels();
+    }
+    catch(exception& e) {
+        m->errorOut(e, "DenseTree", "DenseTree");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+int DenseTree::getGroupIndex(string group) {
+    map<string, int>::iterator it = groupIndex.find(group);
+    if (it == groupIndex.end()) { return -1; }
+    return it->second;
+}
+/**************************************************************************************************/
+void DenseTree::resetLabels() {
+    labels.resize(numLeaves);
+    for (int i = 0; i < numLeaves; i++) { labels[i] = i; }
+}
+/**************************************************************************************************/
+bool DenseTree::holdsAny(int leaf, vector<int>& g) {
+    int row = labels[leaf]*numGroups;
+    for (int j = 0; j < g.size(); j++) { if (leafCounts[row+g[j]] != 0) { return true; } }
+    return false;
+}
+/**************************************************************************************************/
+//same draws as Tree::randomLabels, only leaves holding one of the groups trade labels
+void DenseTree::randomLabels(vector<int>& g, mt19937_64* engine) {
+    try {
+        for (int i = 0; i < numLeaves; i++) {
+            int z;
+            if (engine == NULL) { z = m->getRandomIndex(i); }
+            else { uniform_int_distribution<int> dis(0, i); z = dis(*engine); } //draws at i == 0 too, so the engine stays in step with Tree
+
+            if (holdsAny(z, g) && holdsAny(i, g)) { swap(labels[i], labels[z]); }
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "DenseTree", "randomLabels");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void DenseTree::assembleTree(vector<int>& g) {
+    try {
+        numCols = g.size();
+        counts.assign(numNodes*numCols, 0);
+
+        for (int i = 0; i < numLeaves; i++) {
+            int row = labels[i]*numGroups;
+            for (int j = 0; j < numCols; j++) { counts[i*numCols+j] = leafCounts[row+g[j]]; }
+        }
+
+        for (int i = numLeaves; i < numNodes; i++) {
+            int lc = lchild[i]; int rc = rchild[i];
+            if ((lc == -1) || (rc == -1)) { continue; }
+            for (int j = 0; j < numCols; j++) { counts[i*numCols+j] = counts[lc*numCols+j] + counts[rc*numCols+j]; }
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "DenseTree", "assembleTree");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+bool DenseTree::holdsAll(int i) {
+    for (int j = 0; j < numCols; j++) { if (counts[i*numCols+j] != counts[root*numCols+j]) { return false; } }
+    return true;
+}
+/**************************************************************************************************/
+//the parsimony score of the groups given, a node whose children share no group has a change. Matches Tree::mergeUserGroups
+int DenseTree::getParsimony(vector<int>& g) {
+    try {
+        int k = g.size();
+        pGroups.assign(numNodes*k, 0);
+        vector<int> sizes(numNodes, 0);
+
+        for (int i = 0; i < numLeaves; i++) {
+            int row = labels[i]*numGroups;
+            for (int j = 0; j < k; j++) {
+                if (leafDominant[row+g[j]]) { pGroups[i*k+j] = 1; sizes[i]++; }
+            }
+        }
+
+        int score = 0;
+        for (int i = numLeaves; i < numNodes; i++) {
+            if (m->control_pressed) { return score; }
+
+            int lc = lchild[i]; int rc = rchild[i];
+
+            //keep the groups both children have, if there are none keep all of them
+            int both = 0;
+            for (int j = 0; j < k; j++) { if (pGroups[lc*k+j] && pGroups[rc*k+j]) { both++; } }
+
+            for (int j = 0; j < k; j++) {
+                if (both != 0)  { pGroups[i*k+j] = (pGroups[lc*k+j] && pGroups[rc*k+j]);  }
+                else            { pGroups[i*k+j] = (pGroups[lc*k+j] || pGroups[rc*k+j]);  }
+                sizes[i] += pGroups[i*k+j];
+            }
+
+            //if isize are 0 then that branch is to be ignored, if you have more groups than either of your kids then theres been a change.
+            if ((sizes[i] == 0) || (sizes[lc] == 0) || (sizes[rc] == 0)) { }
+            else if ((sizes[i] > sizes[rc]) || (sizes[i] > sizes[lc])) { score++; }
+        }
+
+        return score;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "DenseTree", "getParsimony");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
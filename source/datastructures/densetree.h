@@ -0,0 +1,75 @@
+//
+//  densetree.h
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__densetree__
+#define __Mothur__densetree__
+
+#include "mothur.h"
+#include "mothurout.h"
+#include "tree.h"
+
+/* This class is a compact copy of a Tree for the calculators that relabel and rescore it many times.  Groups are integer
+ indexes into the groups it was built with, the parent, children and branch lengths are flat arrays and the leaves' group
+ counts are one numLeaves x numGroups matrix.
+
+ Relabelling a leaf moves an index into that matrix instead of swapping the node's maps, and assembleTree sums just the groups
+ being scored into a numNodes x (groups scored) matrix.  The first numLeaves nodes are the leaves and children come before their
+ parents, as in Tree.
+ */
+
+/**************************************************************************************************/
+
+class DenseTree {
+
+public:
+    DenseTree(Tree*, vector<string>); //tree, groups to index
+    ~DenseTree() {}
+
+    int getNumNodes()   { return numNodes;  }
+    int getNumLeaves()  { return numLeaves; }
+    int getNumGroups()  { return numGroups; }
+    int getRoot()       { return root;      }
+    vector<string> getGroups() { return groups; }
+    int getGroupIndex(string); //-1 if the group is not indexed
+
+    int getParent(int i)            { return parent[i];         }
+    int getLChild(int i)            { return lchild[i];         }
+    int getRChild(int i)            { return rchild[i];         }
+    float getBranchLength(int i)    { return branchLength[i];   }
+    int getGroupSize(int g)         { return groupSizes[g];     } //sequences from group g in the count table
+    int getLeafCount(int leaf, int g) { return leafCounts[labels[leaf]*numGroups+g]; } //sequences from group g in this leaf
+
+    void resetLabels(); //puts each leaf's own groups back
+    void randomLabels(vector<int>&, mt19937_64* engine = NULL); //groups to shuffle, NULL uses mothur's generator
+
+    //fills the counts of the groups given, node i's count of groups[j] is getCount(i, j)
+    void assembleTree(vector<int>&);
+    int getCount(int i, int j) { return counts[i*numCols+j]; }
+    bool holdsAll(int); //does this node hold every sequence from the assembled groups that is in the tree
+
+    int getParsimony(vector<int>&);
+
+private:
+    MothurOut* m;
+    int numNodes, numLeaves, numGroups, numCols, root;
+    vector<string> groups;
+    map<string, int> groupIndex;
+    vector<int> parent, lchild, rchild;
+    vector<float> branchLength;
+    vector<int> groupSizes;
+    vector<int> leafCounts;     //row r is the counts leaf r had in the tree
+    vector<char> leafDominant;  //leaf parsimony groups, the groups with the leaf's highest count
+    vector<int> labels;         //leaf i carries row labels[i]
+    vector<int> counts;         //numNodes x numCols
+    vector<char> pGroups;       //numNodes x numCols, parsimony groups
+
+    bool holdsAny(int, vector<int>&);
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -8,18 +8,27 @@
 
 #include "fastqread.h"
 
+/*******************************************************************************/
+//goes from solexa to sanger. Used fq_all2std.pl as a reference.
+static vector<int> fillConvertTable() {
+    vector<int> convertTable;
+    for (int i = -64; i < 65; i++) {
+        convertTable.push_back(((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499)));
+    }
+    return convertTable;
+}
+/*******************************************************************************/
+//built once instead of by every read
+const vector<int>& FastqRead::getConvertTable() {
+    static const vector<int> convertTable = fillConvertTable();
+    return convertTable;
+}
 
 /*******************************************************************************/
 FastqRead::FastqRead() {
     try {
         m = MothurOut::getInstance();
         format = "illumina1.8+"; name = ""; sequence = ""; scores.clear();
-        //fill convert table - goes from solexa to sanger. Used fq_all2std.pl as a reference.
-        for (int i = -64; i < 65; i++) {
-            char temp = (char) ((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499));
-            convertTable.push_back(temp);
-            convertBackTable.push_back(((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499)));
-        }
     }
     catch(exception& e) {
         m->errorOut(e, "FastqRead", "FastqRead");
@@ -31,12 +40,6 @@ FastqRead::FastqRead(Sequence s, QualityScores q) {
     try {
         m = MothurOut::getInstance(); format = "illumina1.8+";
         
-        //fill convert table - goes from solexa to sanger. Used fq_all2std.pl as a reference.
-        for (int i = -64; i < 65; i++) {
-            char temp = (char) ((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499));
-            convertTable.push_back(temp);
-            convertBackTable.push_back(((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499)));
-        }
         
         if (s.getName() != q.getName()) { m->mothurOut("[ERROR]: sequence name does not match quality score name. Cannot construct fastq object.\n"); m->control_pressed = true; }
         else {
@@ -59,12 +62,6 @@ FastqRead::FastqRead(Sequence s, QualityScores q, string f) {
     try {
         m = MothurOut::getInstance(); format = f;
         
-        //fill convert table - goes from solexa to sanger. Used fq_all2std.pl as a reference.
-        for (int i = -64; i < 65; i++) {
-            char temp = (char) ((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499));
-            convertTable.push_back(temp);
-            convertBackTable.push_back(((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499)));
-        }
         
         if (s.getName() != q.getName()) { m->mothurOut("[ERROR]: sequence name does not match quality score name. Cannot construct fastq object.\n"); m->control_pressed = true; }
         else {
@@ -87,12 +84,6 @@ FastqRead::FastqRead(string f) {
     try {
         m = MothurOut::getInstance();
         format = f; name = ""; sequence = ""; scores.clear();
-        //fill convert table - goes from solexa to sanger. Used fq_all2std.pl as a reference.
-        for (int i = -64; i < 65; i++) {
-            char temp = (char) ((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499));
-            convertTable.push_back(temp);
-            convertBackTable.push_back(((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499)));
-        }
     }
     catch(exception& e) {
         m->errorOut(e, "FastqRead", "FastqRead");
@@ -105,12 +96,6 @@ FastqRead::FastqRead(string f, string n, string s, vector<int> sc) {
     try {
         m = MothurOut::getInstance();
         format = f; name = n; sequence = s; scores = sc;
-        //fill convert table - goes from solexa to sanger. Used fq_all2std.pl as a reference.
-        for (int i = -64; i < 65; i++) {
-            char temp = (char) ((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499));
-            convertTable.push_back(temp);
-            convertBackTable.push_back(((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499)));
-        }
     }
     catch(exception& e) {
         m->errorOut(e, "FastqRead", "FastqRead");
@@ -125,11 +110,6 @@ FastqRead::FastqRead(ifstream& in, bool& ignore, string f) {
         
         ignore = false;
         format = f;
-        //fill convert table - goes from solexa to sanger. Used fq_all2std.pl as a reference.
-        for (int i = -64; i < 65; i++) {
-            char temp = (char) ((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499));
-            convertTable.push_back(temp);
-        }
         
         //read sequence name
         string line = m->getline(in); m->gobble(in);
@@ -173,6 +153,67 @@ FastqRead::FastqRead(ifstream& in, bool& ignore, string f) {
     }
 }
 //**********************************************************************************************************************
+//same checks as the ifstream version, but splits the record in place instead of copying each line
+FastqRead::FastqRead(BlockReader& in, bool& ignore, string f) {
+    try {
+        m = MothurOut::getInstance();
+        
+        ignore = false;
+        format = f;
+        
+        fastqRecord record;
+        in.getFastq(record);
+        
+        //read sequence name, the comment is the rest of the words on the line
+        const char* pos = record.header.data; const char* end = pos + record.header.length;
+        while ((pos != end) && isspace(*pos)) { pos++; }
+        const char* nameEnd = pos; while ((nameEnd != end) && !isspace(*nameEnd)) { nameEnd++; }
+        name = string(pos, nameEnd-pos);
+        if (name == "") {  m->mothurOut("[WARNING]: Blank fasta name, ignoring read."); m->mothurOutEndLine(); ignore=true;  }
+        else if (name[0] != '@') { m->mothurOut("[WARNING]: reading " + name + " expected a name with @ as a leading character, ignoring read."); m->mothurOutEndLine(); ignore=true; }
+        else { name = name.substr(1); }
+        pos = nameEnd;
+        while (pos != end) {
+            while ((pos != end) && isspace(*pos)) { pos++; }
+            const char* wordEnd = pos; while ((wordEnd != end) && !isspace(*wordEnd)) { wordEnd++; }
+            if (wordEnd != pos) { if (comment != "") { comment += " "; } comment.append(pos, wordEnd-pos); }
+            pos = wordEnd;
+        }
+        
+        //read sequence
+        sequence = record.sequence.getString();
+        if (sequence == "") {  m->mothurOut("[WARNING]: missing sequence for " + name + ", ignoring."); ignore=true; }
+        
+        //read sequence name
+        pos = record.header2.data; end = pos + record.header2.length;
+        while ((pos != end) && isspace(*pos)) { pos++; }
+        nameEnd = pos; while ((nameEnd != end) && !isspace(*nameEnd)) { nameEnd++; }
+        string name2 = string(pos, nameEnd-pos);
+        if (name2 == "") {  m->mothurOut("[WARNING]: expected a name with + as a leading character, ignoring."); ignore=true; }
+        else if (name2[0] != '+') { m->mothurOut("[WARNING]: reading " + name2 + " expected a name with + as a leading character, ignoring."); ignore=true; }
+        else { name2 = name2.substr(1); if (name2 == "") { name2 = name; } }
+        
+        //read quality scores
+        string quality = record.quality.getString();
+        if (quality == "") {  m->mothurOut("[WARNING]: missing quality for " + name2 + ", ignoring."); ignore=true; }
+        
+        //sanity check sequence length and number of quality scores match
+        if (name2 != "") { if (name != name2) { m->mothurOut("[WARNING]: names do not match. read " + name + " for fasta and " + name2 + " for quality, ignoring."); ignore=true; } }
+        if (quality.length() != sequence.length()) { m->mothurOut("[WARNING]: Lengths do not match for sequence " + name + ". Read " + toString(sequence.length()) + " characters for fasta and " + toString(quality.length()) + " characters for quality scores, ignoring read."); ignore=true; }
+        
+        scores = convertQual(quality);
+        scoreString.swap(quality);
+        m->checkName(name);
+        
+        if (m->debug) { m->mothurOut("[DEBUG]: " + name + " " + sequence + " " + scoreString + "\n"); }
+        
+    }
+    catch(exception& e) {
+        m->errorOut(e, "FastqRead", "FastqRead");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
 #ifdef USE_BOOST
 FastqRead::FastqRead(boost::iostreams::filtering_istream& in, bool& ignore, string f) {
     try {
@@ -180,11 +221,6 @@ FastqRead::FastqRead(boost::iostreams::filtering_istream& in, bool& ignore, stri
         
         ignore = false;
         format = f;
-        //fill convert table - goes from solexa to sanger. Used fq_all2std.pl as a reference.
-        for (int i = -64; i < 65; i++) {
-            char temp = (char) ((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499));
-            convertTable.push_back(temp);
-        }
         
         //read sequence name
         string line = ""; std::getline(in, line); m->gobble(in);
@@ -243,7 +279,7 @@ vector<int> FastqRead::convertQual(string qual) {
             }else if (format == "illumina1.8+") {
                 temp -= int('!'); //char '!' //33
             }else if (format == "solexa") {
-                temp = int(convertTable[temp]); //convert to sanger
+                temp = getConvertTable()[temp]; //convert to sanger
                 temp -= int('!'); //char '!' //33
             }else {
                 temp -= int('!'); //char '!' //33
@@ -273,7 +309,7 @@ string FastqRead::convertQual(vector<int> qual) {
 
             int temp = qual[i] + controlChar;
             
-            if (format == "solexa") { temp = convertBackTable[temp];  }
+            if (format == "solexa") { temp = getConvertTable()[temp];  }
             
             char qualChar = (char) temp;
             
@@ -13,6 +13,7 @@
 #include "mothurout.h"
 #include "sequence.hpp"
 #include "qualityscores.h"
+#include "blockreader.h"
 
 
 /* This class is a representation of a fastqread.  If no format is given, defaults to illumina1.8+.
@@ -38,6 +39,7 @@ public:
     FastqRead(string f); 
     FastqRead(string f, string n, string s, vector<int> sc); 
     FastqRead(ifstream&, bool&, string f);
+    FastqRead(BlockReader&, bool&, string f);
     #ifdef USE_BOOST
     FastqRead(boost::iostreams::filtering_istream&, bool&, string f);
     #endif
@@ -64,11 +66,10 @@ private:
     string sequence;
     string scoreString;
     string format;
-    vector<char> convertTable;
-    vector<int> convertBackTable;
     
     vector<int> convertQual(string qual);
     string convertQual(vector<int>);
+    static const vector<int>& getConvertTable();
     
 };
 
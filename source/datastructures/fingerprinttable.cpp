@@ -0,0 +1,149 @@
+//
+//  fingerprinttable.cpp
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#include "fingerprinttable.h"
+
+/**************************************************************************************************/
+FingerprintTable::FingerprintTable(int threads) {
+    try {
+        m = MothurOut::getInstance();
+        numThreads = threads; if (numThreads < 1) { numThreads = 1; }
+        numUniques = 0;
+        partitions.resize(numThreads);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "FingerprintTable", "FingerprintTable");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+static inline unsigned long long rotateLeft(unsigned long long x, int r) { return (x << r) | (x >> (64 - r)); }
+
+static inline unsigned long long finalMix(unsigned long long h) {
+    h ^= h >> 33; h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+/**************************************************************************************************/
+//two 64 bit lanes fed 8 characters at a time
+seqFingerprint FingerprintTable::getFingerprint(const string& seq) {
+    const unsigned long long k1 = 0x87c37b91114253d5ULL;
+    const unsigned long long k2 = 0x4cf5ad432745937fULL;
+
+    seqFingerprint f;
+    f.first = 0x9e3779b97f4a7c15ULL ^ seq.length();
+    f.second = 0xc2b2ae3d27d4eb4fULL + seq.length();
+
+    const char* data = seq.data();
+    size_t length = seq.length();
+    size_t i = 0;
+    while (i < length) {
+        unsigned long long word = 0;
+        size_t numChars = length - i; if (numChars > 8) { numChars = 8; }
+        memcpy(&word, data + i, numChars);
+        i += numChars;
+
+        f.first ^= rotateLeft(word * k1, 31) * k2;
+        f.first = rotateLeft(f.first, 27) * 5 + 0x52dce729;
+        f.second ^= rotateLeft(word * k2, 33) * k1;
+        f.second = (rotateLeft(f.second, 31) + f.first) * 5 + 0x38495ab5;
+    }
+
+    f.first = finalMix(f.first + f.second);
+    f.second = finalMix(f.second + f.first);
+
+    return f;
+}
+/**************************************************************************************************/
+void FingerprintTable::add(vector<string>& seqs, vector<int>& ids) {
+    try {
+        vector<seqFingerprint> fingerprints(seqs.size());
+
+        //fingerprint the batch, then look up the reads
+        atomic<int> nextRead(0);
+        vector<thread*> workerThreads;
+        for (int i = 1; i < numThreads; i++) { workerThreads.push_back(new thread(&FingerprintTable::fingerprintReads, this, &seqs, &fingerprints, &nextRead)); }
+        fingerprintReads(&seqs, &fingerprints, &nextRead);
+        for (int i = 0; i < workerThreads.size(); i++) { workerThreads[i]->join(); delete workerThreads[i]; }
+
+        addFingerprinted(seqs, fingerprints, ids);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "FingerprintTable", "add");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//each thread looks up the reads in its partition
+void FingerprintTable::addFingerprinted(vector<string>& seqs, vector<seqFingerprint>& fingerprints, vector<int>& ids) {
+    try {
+        vector<int> localIds(seqs.size(), -1);
+
+        vector<thread*> workerThreads;
+        for (int i = 1; i < numThreads; i++) { workerThreads.push_back(new thread(&FingerprintTable::findReads, this, i, &seqs, &fingerprints, &localIds)); }
+        findReads(0, &seqs, &fingerprints, &localIds);
+        for (int i = 0; i < workerThreads.size(); i++) { workerThreads[i]->join(); delete workerThreads[i]; }
+
+        //new local ids are handed out in file order within a partition, so number them in file order across partitions
+        ids.resize(seqs.size());
+        for (int i = 0; i < seqs.size(); i++) {
+            partition& thisPartition = partitions[fingerprints[i].first % numThreads];
+            if (localIds[i] == thisPartition.uniqueIds.size()) { thisPartition.uniqueIds.push_back(numUniques); numUniques++; }
+            ids[i] = thisPartition.uniqueIds[localIds[i]];
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "FingerprintTable", "addFingerprinted");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void FingerprintTable::fingerprintReads(vector<string>* seqs, vector<seqFingerprint>* fingerprints, atomic<int>* nextRead) {
+    try {
+        int numSeqs = seqs->size();
+        while (true) {
+            int i = (*nextRead)++;
+            if (i >= numSeqs) { break; }
+            (*fingerprints)[i] = getFingerprint((*seqs)[i]);
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "FingerprintTable", "fingerprintReads");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void FingerprintTable::findReads(int p, vector<string>* seqs, vector<seqFingerprint>* fingerprints, vector<int>* localIds) {
+    try {
+        partition& thisPartition = partitions[p];
+
+        for (int i = 0; i < seqs->size(); i++) {
+            if (((*fingerprints)[i].first % numThreads) != p) { continue; }
+
+            const string& seq = (*seqs)[i];
+            int newId = thisPartition.seqs.size();
+
+            pair<unordered_map<seqFingerprint, int, seqFingerprintHash>::iterator, bool> found = thisPartition.ids.insert(make_pair((*fingerprints)[i], newId));
+            if (!found.second) {
+                if (thisPartition.seqs[found.first->second] == seq) { (*localIds)[i] = found.first->second; continue; }
+
+                //same fingerprint, different sequence
+                pair<map<string, int>::iterator, bool> collision = thisPartition.collisions.insert(make_pair(seq, newId));
+                if (!collision.second) { (*localIds)[i] = collision.first->second; continue; }
+            }
+
+            thisPartition.seqs.push_back(seq);
+            (*localIds)[i] = newId;
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "FingerprintTable", "findReads");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
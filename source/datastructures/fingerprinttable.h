@@ -0,0 +1,77 @@
+//
+//  fingerprinttable.h
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__fingerprinttable__
+#define __Mothur__fingerprinttable__
+
+#include "mothur.h"
+#include "mothurout.h"
+#include <unordered_map>
+
+/* This class finds the identical sequences in a stream of reads.  Each sequence is reduced to a 128 bit fingerprint, and the
+ table maps fingerprints to unique ids, so a lookup hashes the sequence once instead of comparing it to the keys of a map.
+ A matching fingerprint is confirmed by comparing the sequence to the unique it matched, so two different sequences with the
+ same fingerprint are still kept apart.
+
+ Reads are added in batches in file order.  The fingerprints of a batch are computed on several threads, then the table is
+ split into one partition per thread by fingerprint, so each thread looks up the reads of its own partition without locking.
+ Unique ids are numbered in the order of their first read, which does not depend on the number of threads.
+ */
+
+/**************************************************************************************************/
+
+struct seqFingerprint {
+    unsigned long long first, second;
+
+    seqFingerprint() : first(0), second(0) {}
+    bool operator==(const seqFingerprint& other) const { return ((first == other.first) && (second == other.second)); }
+};
+
+struct seqFingerprintHash {
+    size_t operator()(const seqFingerprint& f) const { return (size_t)f.second; } //first picks the partition
+};
+
+/**************************************************************************************************/
+
+class FingerprintTable {
+
+#ifdef UNIT_TEST
+    friend class TestFingerprintTable;
+#endif
+
+public:
+
+    FingerprintTable(int); //number of threads
+    ~FingerprintTable() {}
+
+    //fills with the unique id of each sequence in the batch. A read whose id equals the number of uniques before it is new.
+    void add(vector<string>&, vector<int>&);
+    int getNumUniques() { return numUniques; }
+
+    static seqFingerprint getFingerprint(const string&);
+
+private:
+
+    struct partition {
+        unordered_map<seqFingerprint, int, seqFingerprintHash> ids; //fingerprint -> local id
+        map<string, int> collisions; //sequences whose fingerprint belongs to a different sequence -> local id
+        vector<string> seqs; //local id -> sequence, to confirm matches
+        vector<int> uniqueIds; //local id -> unique id
+    };
+
+    MothurOut* m;
+    int numThreads, numUniques;
+    vector<partition> partitions;
+
+    void addFingerprinted(vector<string>&, vector<seqFingerprint>&, vector<int>&);
+    void fingerprintReads(vector<string>*, vector<seqFingerprint>*, atomic<int>*);
+    void findReads(int, vector<string>*, vector<seqFingerprint>*, vector<int>*);
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -67,7 +67,7 @@ vector< map<int, int> > Kmer::getKmerCounts(string sequence){	//	Calculate kmer
 	
 /**************************************************************************************************/
 
-int Kmer::getKmerNumber(string sequence, int index){
+int Kmer::getKmerNumber(const string& sequence, int index){
 	
 //	Here we convert a kmer to a number between 0 and maxKmer.  For example, AAAA would equal 0 and TTTT would equal 255.
 //	If there's an N in the kmer, it is set to 256 (if we are looking at 4mers).  The largest we can look at are 8mers,
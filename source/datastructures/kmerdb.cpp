@@ -14,6 +14,12 @@
  *	then will read in the database file (readKmerDB), otherwise it will generate one and store the data in memory
  *	(generateKmerDB)
  *
+ *	The database file starts with the release version line, padded with zeros to a multiple of 8 bytes, then:
+ *		header: "MOTHKMER", format version (uint32), kmer size (uint32), number of sequences (uint32), unused (uint32),
+ *				number of sequence indices (uint64)
+ *		offsets: maxKmer+2 uint64, the sequences with kmer i are at offsets[i] to offsets[i+1]-1 in the sequence indices
+ *		sequence indices: int32 for each kmer in kmer order
+ *
  *	The search method used here is roughly the same as that used in the SimRank program that is found at the
  *	greengenes website.  The default kmer size is 7.  The speed complexity is between O(L) and O(LN).  When I use 7mers
  *	on average a kmer is found in ~100 other sequences with a database of ~5000 sequences.  If this is the case then the
@@ -27,10 +33,20 @@
 #include "database.hpp"
 #include "kmerdb.hpp"
 
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+	#include <sys/mman.h>
+	#include <fcntl.h>
+#endif
+
+static const char kmerDBMagic[] = "MOTHKMER";
+static const int kmerDBHeaderSize = 32;
+static const unsigned int kmerDBFormatVersion = 1;
+
 /**************************************************************************************************/
 
 KmerDB::KmerDB(string fastaFileName, int kSize) : Database(), kmerSize(kSize) {
 	try { 
+		kmerOffsets = NULL; kmerSeqs = NULL; mappedData = NULL; mappedSize = 0;
 	
 		kmerDBName = fastaFileName.substr(0,fastaFileName.find_last_of(".")+1) + char('0'+ kmerSize) + "mer";
 		
@@ -48,13 +64,18 @@ KmerDB::KmerDB(string fastaFileName, int kSize) : Database(), kmerSize(kSize) {
 
 }
 /**************************************************************************************************/
-KmerDB::KmerDB() : Database() {}
+KmerDB::KmerDB() : Database() { kmerOffsets = NULL; kmerSeqs = NULL; mappedData = NULL; mappedSize = 0; }
 /**************************************************************************************************/
 
-KmerDB::~KmerDB(){}
+KmerDB::~KmerDB(){
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+	if (mappedData != NULL) { munmap((void*)mappedData, mappedSize); }
+#endif
+}
 
 /**************************************************************************************************/
-
+//the query kmers are found once and each distinct kmer's sequences are counted. The counts are 2 byte so the
+//reset and the best match scan touch as little memory as possible, and only the top num matches are ordered.
 vector<int> KmerDB::findClosestSequences(Sequence* candidateSeq, int num){
 	try {
 		if (num > numSeqs) { m->mothurOut("[WARNING]: you requested " + toString(num) + " closest sequences, but the template only contains " + toString(numSeqs) + ", adjusting."); m->mothurOutEndLine(); num = numSeqs; }
@@ -64,34 +85,62 @@ vector<int> KmerDB::findClosestSequences(Sequence* candidateSeq, int num){
 		searchScore = 0;
 		Scores.clear();
 		
-		vector<int> matches(numSeqs, 0);						//	a record of the sequences with shared kmers
-		vector<int> timesKmerFound(kmerLocations.size()+1, 0);	//	a record of the kmers that we have already found
+		if (kmerSeen.size() != (maxKmer+2)) { kmerSeen.assign(maxKmer+2, 0); }	//	a record of the kmers that we have already found
 		
+		string unaligned = candidateSeq->getUnaligned();
 		int numKmers = candidateSeq->getNumBases() - kmerSize + 1;	
-	
+		
+		queryKmers.clear();
 		for(int i=0;i<numKmers;i++){
-			int kmerNumber = kmer.getKmerNumber(candidateSeq->getUnaligned(), i);		//	go through the query sequence and get a kmer number
-			if(timesKmerFound[kmerNumber] == 0){				//	if we haven't seen it before...
-				for(int j=0;j<kmerLocations[kmerNumber].size();j++){//increase the count for each sequence that also has
-					matches[kmerLocations[kmerNumber][j]]++;	//	that kmer
-				}
+			int kmerNumber = kmer.getKmerNumber(unaligned, i);	//	go through the query sequence and get a kmer number
+			if(kmerSeen[kmerNumber] == 0){						//	if we haven't seen it before...
+				kmerSeen[kmerNumber] = 1;						//	ok, we've seen the kmer now
+				queryKmers.push_back(kmerNumber);
+			}
+		}
+		for(int i=0;i<queryKmers.size();i++){ kmerSeen[queryKmers[i]] = 0; }
+		
+		//a sequence can share at most one match per distinct query kmer
+		if (queryKmers.size() <= 65535)	{ findTopMatches(matchCounts, num, numKmers, topMatches);		}
+		else							{ findTopMatches(wideMatchCounts, num, numKmers, topMatches);	}
+		
+		return topMatches;		
+	}
+	catch(exception& e) {
+		m->errorOut(e, "KmerDB", "findClosestSequences");
+		exit(1);
+	}	
+}
+/**************************************************************************************************/
+//counts the query kmers in each template and saves the num best templates and their scores
+template <class T> void KmerDB::findTopMatches(vector<T>& matches, int num, int numKmers, vector<int>& topMatches){
+	try {
+		matches.assign(numSeqs, 0);								//	a record of the sequences with shared kmers
+		
+		for(int i=0;i<queryKmers.size();i++){
+			const int* seqsWithKmer;
+			int numWithKmer = getKmerSeqs(queryKmers[i], seqsWithKmer);
+			for(int j=0;j<numWithKmer;j++){						//increase the count for each sequence that also has
+				matches[seqsWithKmer[j]]++;						//	that kmer
 			}
-			timesKmerFound[kmerNumber] = 1;						//	ok, we've seen the kmer now
 		}
 		
 		if (num != 1) {
-			vector<seqMatch> seqMatches; seqMatches.resize(numSeqs);
+			seqMatches.resize(numSeqs);
 			for(int i=0;i<numSeqs;i++){		
 				seqMatches[i].seq = i;
 				seqMatches[i].match = matches[i];
 			}
 			
-			//sorts putting largest matches first
-			sort(seqMatches.begin(), seqMatches.end(), compareSeqMatches);
+			//puts the largest num matches first, ties go to the earlier template
+			if (num < numSeqs) { nth_element(seqMatches.begin(), seqMatches.begin()+num, seqMatches.end(), compareSeqMatchesThenIndex); }
+			sort(seqMatches.begin(), seqMatches.begin()+num, compareSeqMatchesThenIndex);
+			
+			if (numSeqs != 0) {
+				searchScore = seqMatches[0].match;
+				searchScore = 100 * searchScore / (float) numKmers;		//	return the Sequence object corresponding to the db
+			}
 			
-			searchScore = seqMatches[0].match;
-			searchScore = 100 * searchScore / (float) numKmers;		//	return the Sequence object corresponding to the db
-		
 			//save top matches
 			for (int i = 0; i < num; i++) {
 				topMatches.push_back(seqMatches[i].seq);
@@ -99,14 +148,15 @@ vector<int> KmerDB::findClosestSequences(Sequence* candidateSeq, int num){
 				Scores.push_back(thisScore);
 			}
 		}else{
+			//find the best count first, the loop has no branches so the compiler can vectorize it
+			T best = 0;
+			for(int i=0;i<numSeqs;i++){ best = max(best, matches[i]); }
+			
 			int bestIndex = 0;
 			int bestMatch = -1;
-			for(int i=0;i<numSeqs;i++){	
-				
-				if (matches[i] > bestMatch) {
-					bestIndex = i;
-					bestMatch = matches[i];
-				}
+			if (numSeqs != 0) {
+				bestIndex = find(matches.begin(), matches.end(), best) - matches.begin();
+				bestMatch = best;
 			}
 			
 			searchScore = bestMatch;
@@ -114,10 +164,9 @@ vector<int> KmerDB::findClosestSequences(Sequence* candidateSeq, int num){
 			topMatches.push_back(bestIndex);
 			Scores.push_back(searchScore);
 		}
-		return topMatches;		
 	}
 	catch(exception& e) {
-		m->errorOut(e, "KmerDB", "findClosestSequences");
+		m->errorOut(e, "KmerDB", "findTopMatches");
 		exit(1);
 	}	
 }
@@ -128,17 +177,32 @@ void KmerDB::generateDB(){
 	try {
 		
 		ofstream kmerFile;										//	once we have the kmerLocations folder print it out
-		m->openOutputFile(kmerDBName, kmerFile);					//	to a file
+		m->openOutputFileBinary(kmerDBName, kmerFile);			//	to a file
 		
-		//output version
-		kmerFile << "#" << m->getVersion() << endl;
+		//output version, padded so the offsets are 8 byte aligned when the file is mapped
+		string versionLine = "#" + m->getVersion() + "\n";
+		versionLine.resize((versionLine.length() + 7) / 8 * 8, '\0');
+		kmerFile.write(versionLine.c_str(), versionLine.length());
 		
-		for(int i=0;i<maxKmer;i++){								//	step through all of the possible kmer numbers
-			kmerFile << i << ' ' << kmerLocations[i].size();	//	print the kmer number and the number of sequences with
-			for(int j=0;j<kmerLocations[i].size();j++){			//	that kmer.  then print out the indices of the sequences
-				kmerFile << ' ' << kmerLocations[i][j];			//	with that kmer.
-			}
-			kmerFile << endl;
+		//the kmer maxKmer (kmers containing an N) is not saved
+		vector<unsigned long long> offsets(maxKmer+2, 0);
+		for(int i=0;i<maxKmer;i++){ offsets[i+1] = offsets[i] + kmerLocations[i].size(); }
+		offsets[maxKmer+1] = offsets[maxKmer];
+		
+		char header[kmerDBHeaderSize];
+		memset(header, 0, kmerDBHeaderSize);
+		unsigned int kSize = kmerSize; unsigned int numTemplates = count;
+		unsigned long long numEntries = offsets[maxKmer];
+		memcpy(header, kmerDBMagic, 8);
+		memcpy(header + 8, &kmerDBFormatVersion, 4);
+		memcpy(header + 12, &kSize, 4);
+		memcpy(header + 16, &numTemplates, 4);
+		memcpy(header + 24, &numEntries, 8);
+		kmerFile.write(header, kmerDBHeaderSize);
+		
+		kmerFile.write((const char*)&offsets[0], offsets.size() * sizeof(unsigned long long));
+		for(int i=0;i<maxKmer;i++){								//	then the indices of the sequences with each kmer
+			if (kmerLocations[i].size() != 0) { kmerFile.write((const char*)&kmerLocations[i][0], kmerLocations[i].size() * sizeof(int)); }
 		}
 		kmerFile.close();
 		
@@ -176,6 +240,89 @@ void KmerDB::addSequence(Sequence seq) {
 /**************************************************************************************************/
 
 void KmerDB::readKmerDB(ifstream& kmerDBFile){
+	try {
+		
+		kmerDBFile.seekg(0);									//	start at the beginning of the file
+		
+		//read version
+		string line = m->getline(kmerDBFile);
+		
+		//the binary index starts at the next multiple of 8 bytes
+		unsigned long long headerStart = ((line.length() + 1) + 7) / 8 * 8;
+		char magic[8];
+		kmerDBFile.seekg(headerStart);
+		kmerDBFile.read(magic, 8);
+		bool binary = (kmerDBFile.gcount() == 8) && (memcmp(magic, kmerDBMagic, 8) == 0);
+		kmerDBFile.clear();
+		
+		if (binary) { kmerDBFile.close(); mapKmerDB(headerStart); }
+		else		{ readTextKmerDB(kmerDBFile); }
+	}
+	catch(exception& e) {
+		m->errorOut(e, "KmerDB", "readKmerDB");
+		exit(1);
+	}	
+}
+/**************************************************************************************************/
+//maps the binary index read only, on platforms without mmap the file is read into memory
+bool KmerDB::mapKmerDB(unsigned long long headerStart){
+	try {
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+		int fd = open(kmerDBName.c_str(), O_RDONLY);
+		if (fd == -1) { m->mothurOut("[ERROR]: Could not open " + kmerDBName + ".\n"); m->control_pressed = true; return false; }
+		
+		struct stat fileInfo;
+		fstat(fd, &fileInfo);
+		mappedSize = fileInfo.st_size;
+		
+		void* mapped = mmap(NULL, mappedSize, PROT_READ, MAP_SHARED, fd, 0);
+		close(fd);
+		if (mapped == MAP_FAILED) { m->mothurOut("[ERROR]: Could not map " + kmerDBName + ".\n"); m->control_pressed = true; return false; }
+		madvise(mapped, mappedSize, MADV_WILLNEED);
+		mappedData = (const char*)mapped;
+		const char* data = mappedData;
+#else
+		ifstream in(kmerDBName.c_str(), ios::binary);
+		if (!in) { m->mothurOut("[ERROR]: Could not open " + kmerDBName + ".\n"); m->control_pressed = true; return false; }
+		
+		in.seekg(0, ios::end); mappedSize = in.tellg(); in.seekg(0, ios::beg);
+		fileData.resize((mappedSize + 7) / 8 + 1);
+		if (mappedSize != 0) { in.read((char*)&fileData[0], mappedSize); }
+		in.close();
+		const char* data = (const char*)&fileData[0];
+#endif
+		
+		if (mappedSize < (headerStart + kmerDBHeaderSize)) {
+			m->mothurOut("[ERROR]: " + kmerDBName + " is not a valid kmer database file, please delete it and run the command again to rebuild it.\n"); m->control_pressed = true; return false;
+		}
+		
+		unsigned int version, kSize;
+		unsigned long long numEntries;
+		memcpy(&version, data + headerStart + 8, 4);
+		memcpy(&kSize, data + headerStart + 12, 4);
+		memcpy(&numEntries, data + headerStart + 24, 8);
+		
+		unsigned long long expectedSize = headerStart + kmerDBHeaderSize + (maxKmer+2) * sizeof(unsigned long long) + numEntries * sizeof(int);
+		if ((version != kmerDBFormatVersion) || (kSize != kmerSize) || (expectedSize > mappedSize)) {
+			m->mothurOut("[ERROR]: " + kmerDBName + " is not a valid kmer database file, please delete it and run the command again to rebuild it.\n"); m->control_pressed = true; return false;
+		}
+		
+		kmerOffsets = (const unsigned long long*)(data + headerStart + kmerDBHeaderSize);
+		kmerSeqs = (const int*)(kmerOffsets + maxKmer + 2);
+		
+		//the lists are no longer needed
+		vector<vector<int> > empty; kmerLocations.swap(empty);
+		
+		return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "KmerDB", "mapKmerDB");
+		exit(1);
+	}	
+}
+/**************************************************************************************************/
+//database files from before the binary index
+void KmerDB::readTextKmerDB(ifstream& kmerDBFile){
 	try {
 					
 		kmerDBFile.seekg(0);									//	start at the beginning of the file
@@ -199,7 +346,7 @@ void KmerDB::readKmerDB(ifstream& kmerDBFile){
 		
 	}
 	catch(exception& e) {
-		m->errorOut(e, "KmerDB", "readKmerDB");
+		m->errorOut(e, "KmerDB", "readTextKmerDB");
 		exit(1);
 	}	
 }
@@ -209,7 +356,7 @@ int KmerDB::getCount(int kmer) {
 	try {
 		if (kmer < 0) { return 0; }  //if user gives negative number
 		else if (kmer > maxKmer) {	return 0;	}  //or a kmer that is bigger than maxkmer
-		else {	return kmerLocations[kmer].size();	}  // kmer is in vector range
+		else {	const int* seqs; return getKmerSeqs(kmer, seqs);	}  // kmer is in vector range
 	}
 	catch(exception& e) {
 		m->errorOut(e, "KmerDB", "getCount");
@@ -238,7 +385,7 @@ vector<int> KmerDB::getSequencesWithKmer(int kmer) {
 	
 		if (kmer < 0) { }  //if user gives negative number
 		else if (kmer > maxKmer) {	}  //or a kmer that is bigger than maxkmer
-		else {	seqs = kmerLocations[kmer];	}
+		else {	const int* seqsWithKmer; int num = getKmerSeqs(kmer, seqsWithKmer); seqs.assign(seqsWithKmer, seqsWithKmer + num);	}
 		
 		return seqs;
 	}
@@ -16,6 +16,15 @@
  *	Construction of an object of this type will first look for an appropriately named database file and if it is found
  *	then will read in the database file (readKmerDB), otherwise it will generate one and store the data in memory
  *	(generateKmerDB)
+ *
+ *	The database file is the release version line followed by a binary index: a header, the offsets of each kmer's
+ *	sequences and the sequence indices for all the kmers in kmer order.  readKmerDB memory maps the file read only, so
+ *	reading it takes no time and the pages are shared by every thread and process using the same reference.  Database
+ *	files from earlier releases are text and are still read into kmerLocations.
+ *
+ *	findClosestSequences is not reentrant: it reuses the member scratch buffers and sets Scores and searchScore, so two
+ *	threads must never search the same KmerDB at once.  Threads each construct their own KmerDB, the mapped index is
+ *	still shared between them.
 
  */
 
@@ -43,7 +52,32 @@ private:
 	int kmerSize;
 	int maxKmer, count;
 	string kmerDBName;
-	vector<vector<int> > kmerLocations;
+	vector<vector<int> > kmerLocations; //filled by addSequence or from a text database file
+	
+	//set when a binary database file is read, the sequences with kmer i are kmerSeqs[kmerOffsets[i]] to kmerSeqs[kmerOffsets[i+1]-1]
+	const unsigned long long* kmerOffsets;
+	const int* kmerSeqs;
+	const char* mappedData;
+	unsigned long long mappedSize;
+	vector<unsigned long long> fileData; //the index on platforms without mmap, 8 byte elements keep the offsets aligned
+	
+	//scratch space reused by every search, see the note above on threads
+	vector<unsigned short> matchCounts;
+	vector<int> wideMatchCounts; //used if the query has more than 65535 distinct kmers
+	vector<char> kmerSeen;
+	vector<int> queryKmers;
+	vector<seqMatch> seqMatches;
+	
+	template <class T> void findTopMatches(vector<T>&, int, int, vector<int>&);
+	bool mapKmerDB(unsigned long long);
+	void readTextKmerDB(ifstream&);
+	
+	//sets seqs to the sequences with the kmer and returns how many there are
+	int getKmerSeqs(int kmer, const int*& seqs) const {
+		if (kmerOffsets != NULL) { seqs = kmerSeqs + kmerOffsets[kmer]; return (int)(kmerOffsets[kmer+1] - kmerOffsets[kmer]); }
+		if (kmerLocations[kmer].size() == 0) { seqs = NULL; return 0; }
+		seqs = &kmerLocations[kmer][0]; return kmerLocations[kmer].size();
+	}
 };
 
 #endif
@@ -9,12 +9,13 @@
 #include "optimatrix.h"
 #include "progress.hpp"
 #include "counttable.h"
+#include "binarydistancefile.h"
 
 /***********************************************************************/
 
 OptiMatrix::OptiMatrix(string d, string df, double c, bool s) : distFile(d), distFormat(df), cutoff(c), sim(s) {
     m = MothurOut::getInstance();
-    countfile = ""; namefile = "";
+    countfile = ""; namefile = ""; closeStart.push_back(0);
     
     if (distFormat == "phylip") { readPhylip(); }
     else { readColumn();  }
@@ -22,6 +23,7 @@ OptiMatrix::OptiMatrix(string d, string df, double c, bool s) : distFile(d), dis
 /***********************************************************************/
 OptiMatrix::OptiMatrix(string d, string nc, string f, string df, double c, bool s) : distFile(d), distFormat(df), format(f), cutoff(c), sim(s) {
     m = MothurOut::getInstance();
+    closeStart.push_back(0);
     
     if (format == "name") { namefile = nc; countfile = ""; }
     else if (format == "count") { countfile = nc; namefile = ""; }
@@ -69,8 +71,8 @@ ListVector* OptiMatrix::getListSingle() {
 long int OptiMatrix::print(ostream& out) {
     try {
         long int count = 0;
-        for (int i = 0; i < closeness.size(); i++) {
-            for(set<int>::iterator it = closeness[i].begin(); it != closeness[i].end(); it++){
+        for (int i = 0; i < getNumSeqs(); i++) {
+            for(vector<int>::const_iterator it = getCloseBegin(i); it != getCloseEnd(i); it++){
                 out << *it << '\t';
                 count++;
             }
@@ -87,7 +89,7 @@ long int OptiMatrix::print(ostream& out) {
 /***********************************************************************/
 string OptiMatrix::getName(int index) {
     try {
-        if (index > closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->control_pressed = true; return ""; }
+        if (index > getNumSeqs()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->control_pressed = true; return ""; }
         string name = nameMap[index];
         return name;
     }
@@ -99,9 +101,7 @@ string OptiMatrix::getName(int index) {
 /***********************************************************************/
 bool OptiMatrix::isClose(int i, int toFind){
     try {
-        bool found = false;
-        if (closeness[i].count(toFind) != 0) { found = true; }
-        return found;
+        return binary_search(getCloseBegin(i), getCloseEnd(i), toFind);
         
     }
     catch(exception& e) {
@@ -110,6 +110,49 @@ bool OptiMatrix::isClose(int i, int toFind){
     }
 }
 /***********************************************************************/
+//the neighbours of i are closeSeqs[closeStart[i]] to closeSeqs[closeStart[i+1]-1], sorted so isClose can binary search them.
+//the readers save each close pair once in closePairs, this counts the neighbours of each sequence, places them and then
+//sorts each row and removes the duplicates a column file has if it lists a pair in both directions.
+void OptiMatrix::buildCloseness(int numSeqs){
+    try {
+        closeStart.assign(numSeqs+1, 0);
+        for (long long i = 0; i < closePairs.size(); i++) {
+            closeStart[closePairs[i].first+1]++;
+            if (closePairs[i].first != closePairs[i].second) { closeStart[closePairs[i].second+1]++; }
+        }
+        for (int i = 0; i < numSeqs; i++) { closeStart[i+1] += closeStart[i]; }
+        
+        closeSeqs.resize(closeStart[numSeqs]);
+        vector<long long> next(closeStart.begin(), closeStart.end()-1);
+        for (long long i = 0; i < closePairs.size(); i++) {
+            int a = closePairs[i].first; int b = closePairs[i].second;
+            closeSeqs[next[a]++] = b;
+            if (a != b) { closeSeqs[next[b]++] = a; }
+        }
+        vector< pair<int, int> >().swap(closePairs);
+        next.clear();
+        
+        long long numClose = 0;
+        for (int i = 0; i < numSeqs; i++) {
+            vector<int>::iterator rowStart = closeSeqs.begin() + closeStart[i];
+            vector<int>::iterator rowEnd = closeSeqs.begin() + closeStart[i+1];
+            
+            sort(rowStart, rowEnd);
+            rowEnd = unique(rowStart, rowEnd);
+            
+            closeStart[i] = numClose;
+            for (vector<int>::iterator it = rowStart; it != rowEnd; it++) { closeSeqs[numClose] = *it; numClose++; }
+        }
+        closeStart[numSeqs] = numClose;
+        closeSeqs.resize(numClose);
+        vector<int>(closeSeqs).swap(closeSeqs);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiMatrix", "buildCloseness");
+        exit(1);
+    }
+}
+/***********************************************************************/
 
 string OptiMatrix::findDistFormat(string distFile){
     try {
@@ -210,7 +253,7 @@ int OptiMatrix::readPhylip(){
         }
         singleton.clear();
 
-        closeness.resize(nonSingletonCount);
+        closePairs.clear();
         
         map<string, string> names;
         if (namefile != "") {
@@ -255,8 +298,7 @@ int OptiMatrix::readPhylip(){
                     if(distance < cutoff){
                         int newB = singletonIndexSwap[j];
                         int newA = singletonIndexSwap[i];
-                        closeness[newA].insert(newB);
-                        closeness[newB].insert(newA);
+                        closePairs.push_back(make_pair(newA, newB));
                     }
                     index++; reading->update(index);
                 }
@@ -290,8 +332,7 @@ int OptiMatrix::readPhylip(){
                     if(distance < cutoff && j < i){
                         int newB = singletonIndexSwap[j];
                         int newA = singletonIndexSwap[i];
-                        closeness[newA].insert(newB);
-                        closeness[newB].insert(newA);
+                        closePairs.push_back(make_pair(newA, newB));
                     }
                     index++; reading->update(index);
                 }
@@ -307,6 +348,8 @@ int OptiMatrix::readPhylip(){
         in.close();
         reading->finish();
         delete reading;
+        
+        buildCloseness(nonSingletonCount);
 
         if (m->debug) { unsigned long long ramUsed = m->getRAMUsed(); unsigned long long total = m->getTotalRAM();
             m->mothurOut("\nCurrent RAM usage: " + toString(ramUsed/(double)GIG) + " Gigabytes. Total Ram: " + toString(total/(double)GIG) + " Gigabytes.\n"); }
@@ -332,6 +375,8 @@ int OptiMatrix::readColumn(){
             nameMap.push_back(it->first);
         }
         
+        if (BinaryDistanceFile::isBinary(distFile)) { return readBinaryColumn(nameAssignment); }
+        
         string firstName, secondName;
         float distance;
         
@@ -384,7 +429,7 @@ int OptiMatrix::readColumn(){
         ifstream in;
         m->openInputFile(distFile, in);
         
-        closeness.resize(nonSingletonCount);
+        closePairs.clear();
         
         map<string, string> names;
         if (namefile != "") {
@@ -419,8 +464,7 @@ int OptiMatrix::readColumn(){
                 
                 int newB = singletonIndexSwap[indexB];
                 int newA = singletonIndexSwap[indexA];
-                closeness[newA].insert(newB);
-                closeness[newB].insert(newA);
+                closePairs.push_back(make_pair(newA, newB));
                 
                 if (namefile != "") {
                     firstName = names[firstName];  //redundant names
@@ -434,6 +478,8 @@ int OptiMatrix::readColumn(){
         in.close();
         nameAssignment.clear();
         
+        buildCloseness(nonSingletonCount);
+        
         return 1;
         
     }
@@ -443,3 +489,98 @@ int OptiMatrix::readColumn(){
     }
 }
 /***********************************************************************/
+//same as readColumn, but the distances come from a mapped binary distance file, so each name is looked up once instead of once per distance
+int OptiMatrix::readBinaryColumn(map<string, int>& nameAssignment){
+    try {
+        BinaryDistanceFile dists(distFile);
+        if (m->control_pressed) { return 0; }
+        
+        //binary file id -> nameAssignment index
+        vector<int> fileToIndex; fileToIndex.resize(dists.getNumSeqs(), -1);
+        for (int i = 0; i < dists.getNumSeqs(); i++) {
+            map<string,int>::iterator it = nameAssignment.find(dists.getName(i));
+            if (it != nameAssignment.end()) { fileToIndex[i] = it->second; }
+        }
+        
+        unsigned long long numDists = dists.getNumDists();
+        
+        ///////////////////// Read to eliminate singletons ///////////////////////
+        vector<bool> singleton; singleton.resize(nameAssignment.size(), true);
+        for (unsigned long long k = 0; k < numDists; k++) {
+            
+            if (m->control_pressed) { return 0; }
+            
+            float distance = dists.getDist(k);
+            if (sim) { distance = 1.0 - distance;  }  //user has entered a sim matrix that we need to convert.
+            
+            if(distance < cutoff){
+                unsigned int row = dists.getRow(k); unsigned int col = dists.getColumn(k);
+                
+                if(fileToIndex[row] == -1){  m->mothurOut("AAError: Sequence '" + dists.getName(row) + "' was not found in the name or count file, please correct\n"); exit(1);  }
+                if(fileToIndex[col] == -1){  m->mothurOut("ABError: Sequence '" + dists.getName(col) + "' was not found in the name or count file, please correct\n"); exit(1);  }
+                
+                singleton[fileToIndex[row]] = false;
+                singleton[fileToIndex[col]] = false;
+            }
+        }
+        //////////////////////////////////////////////////////////////////////////
+        
+        vector<int> singletonIndexSwap; singletonIndexSwap.resize(singleton.size(), -1);
+        int nonSingletonCount = 0;
+        for (int i = 0; i < singleton.size(); i++) {
+            if (!singleton[i]) { //if you are a singleton
+                singletonIndexSwap[i] = nonSingletonCount;
+                nonSingletonCount++;
+            }else { singletons.push_back(nameMap[i]); }
+        }
+        singleton.clear();
+        
+        closePairs.clear();
+        
+        map<string, string> names;
+        if (namefile != "") {
+            m->readNames(namefile, names);
+            for (int i = 0; i < singletons.size(); i++) {
+                singletons[i] = names[singletons[i]];
+            }
+        }
+        
+        for (unsigned long long k = 0; k < numDists; k++) {
+            
+            if (m->control_pressed) { return 0; }
+            
+            float distance = dists.getDist(k);
+            if (sim) { distance = 1.0 - distance;  }  //user has entered a sim matrix that we need to convert.
+            
+            if(distance < cutoff){
+                unsigned int row = dists.getRow(k); unsigned int col = dists.getColumn(k);
+                
+                int newA = singletonIndexSwap[fileToIndex[row]];
+                int newB = singletonIndexSwap[fileToIndex[col]];
+                closePairs.push_back(make_pair(newA, newB));
+            }
+        }
+        
+        //the binary file names each sequence once, so the names only need to be set once per sequence
+        for (int i = 0; i < fileToIndex.size(); i++) {
+            if (fileToIndex[i] == -1) { continue; }
+            int newIndex = singletonIndexSwap[fileToIndex[i]];
+            if (newIndex == -1) { continue; }
+            
+            string name = dists.getName(i);
+            if (namefile != "") { name = names[name]; } //redundant names
+            nameMap[newIndex] = name;
+        }
+        nameAssignment.clear();
+        
+        buildCloseness(nonSingletonCount);
+        
+        return 1;
+        
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiMatrix", "readBinaryColumn");
+        exit(1);
+    }
+}
+/***********************************************************************/
@@ -20,16 +20,17 @@ class OptiMatrix {
 
     
 public:
-    OptiMatrix() { m = MothurOut::getInstance(); }
+    OptiMatrix() { m = MothurOut::getInstance(); closeStart.push_back(0); }
     OptiMatrix(string, string, double, bool); //distfile, distformat, cutoff, sim
     OptiMatrix(string, string, string, string, double, bool); //distfile, name or count, format, distformat, cutoff, sim
     ~OptiMatrix(){ }
     
-    set<int> getCloseSeqs(int i) { return closeness[i]; }
-    //int get(int i, int j) { return closeness[i][j]; }
+    vector<int> getCloseSeqs(int i) { return vector<int>(getCloseBegin(i), getCloseEnd(i)); }
+    vector<int>::const_iterator getCloseBegin(int i) const { return closeSeqs.begin() + closeStart[i]; } //iterate the close seqs without copying them
+    vector<int>::const_iterator getCloseEnd(int i) const { return closeSeqs.begin() + closeStart[i+1]; }
     bool isClose(int, int);
-    int getNumClose(int index) { return closeness[index].size(); }
-    int getNumSeqs() { return closeness.size(); }
+    int getNumClose(int index) { return closeStart[index+1] - closeStart[index]; }
+    int getNumSeqs() { return closeStart.size() - 1; }
     int getNumSingletons() { return singletons.size(); }
     //map<int, string> getNameMap() { return nameMap; }
     string getName(int); //name from nameMap index
@@ -39,7 +40,10 @@ public:
     
 private:
     
-    vector< set<int> > closeness;  //closeness[0] contains indexes of seqs "close" to seq 0.
+    //compressed sparse rows, the seqs "close" to seq i are closeSeqs[closeStart[i]] to closeSeqs[closeStart[i+1]-1] in sorted order.
+    vector<int> closeSeqs;
+    vector<long long> closeStart;
+    vector< pair<int, int> > closePairs; //close pairs saved while reading, before the rows are built
     vector<string> singletons;
     vector<string> nameMap;
     
@@ -52,6 +56,8 @@ private:
     string findDistFormat(string distFile);
     int readPhylip();
     int readColumn();
+    int readBinaryColumn(map<string, int>&);
+    void buildCloseness(int);
     map<string, int> readNames(string namefile, vector<string>&);
     
 };
@@ -0,0 +1,222 @@
+//
+//  packedseq.cpp
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#include "packedseq.h"
+
+//index is the 4 bit code stored in the planes, '.' and '-' are stored as code 0 plus their own plane
+static const char packedAlphabet[] = "ACGTUNRYSWKMBDHV";
+
+/**************************************************************************************************/
+PackedSeq::PackedSeq() {
+    m = MothurOut::getInstance();
+    name = ""; aligned = ""; alignLength = 0; numWords = 0; packed = true;
+    numBases = 0; numDots = 0; firstNonDot = -1; lastNonDot = -1; endDotsOnly = true;
+}
+/**************************************************************************************************/
+PackedSeq::PackedSeq(Sequence seq) {
+    try {
+        m = MothurOut::getInstance();
+        name = seq.getName();
+        pack(seq.getAligned());
+    }
+    catch(exception& e) {
+        m->errorOut(e, "PackedSeq", "PackedSeq");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+PackedSeq::PackedSeq(string n, string seq) {
+    try {
+        m = MothurOut::getInstance();
+        name = n;
+        pack(seq);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "PackedSeq", "PackedSeq");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void PackedSeq::pack(string seq) {
+    try {
+        int codes[256];
+        for (int i = 0; i < 256; i++) { codes[i] = -1; }
+        for (int i = 0; i < 16; i++) { codes[(unsigned char)packedAlphabet[i]] = i; }
+        codes[(unsigned char)'.'] = 16;
+        codes[(unsigned char)'-'] = 17;
+
+        alignLength = seq.length();
+        numWords = (alignLength + 63) / 64;
+        packed = true;
+        aligned = "";
+        bits.assign(numWords*6, 0);
+        blockCounts.assign(numWords*5, 0);
+        numBases = 0; numDots = 0; firstNonDot = -1; lastNonDot = -1;
+
+        for (int i = 0; i < alignLength; i++) {
+            int code = codes[(unsigned char)seq[i]];
+
+            if (code == -1) { packed = false; break; }
+
+            packedWord* word = &bits[(i / 64)*6];
+            packedWord bit = ((packedWord)1) << (i % 64);
+
+            if (code == 16)         { word[4] |= bit; numDots++; continue; }
+
+            if (firstNonDot == -1) { firstNonDot = i; }
+            lastNonDot = i;
+
+            if (code == 17)         { word[5] |= bit;  }
+            else {
+                for (int p = 0; p < 4; p++) { if (code & (1 << p)) { word[p] |= bit; } }
+                blockCounts[(i / 64)*5 + min(code, 4)]++;
+                numBases++;
+            }
+        }
+
+        //dots between the first and last non dot column
+        endDotsOnly = true;
+        for (int i = firstNonDot; (i != -1) && (i <= lastNonDot); i++) { if (seq[i] == '.') { endDotsOnly = false; break; } }
+
+        if (!packed) { aligned = seq; bits.clear(); blockCounts.clear(); numWords = 0; endDotsOnly = false; }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "PackedSeq", "pack");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+string PackedSeq::getAligned() const {
+    if (!packed) { return aligned; }
+
+    string seq; seq.resize(alignLength);
+    for (int i = 0; i < alignLength; i++) {
+        const packedWord* word = &bits[(i / 64)*6];
+        int shift = i % 64;
+
+        if ((word[4] >> shift) & 1)         { seq[i] = '.'; }
+        else if ((word[5] >> shift) & 1)    { seq[i] = '-'; }
+        else {
+            int code = 0;
+            for (int p = 0; p < 4; p++) { code |= (int)((word[p] >> shift) & 1) << p; }
+            seq[i] = packedAlphabet[code];
+        }
+    }
+    return seq;
+}
+/**************************************************************************************************/
+packedWord PackedSeq::getValidMask(int w) const {
+    int remaining = alignLength - (w * 64);
+    if (remaining >= 64) { return ~((packedWord)0); }
+    return (((packedWord)1) << remaining) - 1;
+}
+/**************************************************************************************************/
+int PackedSeq::countMismatches(const PackedSeq& other, int maxDiffs) const {
+    try {
+        int numBad = 0;
+
+        if (!packed || !other.packed) {
+            string seq1 = getAligned(); string seq2 = other.getAligned();
+            for (int i = 0; i < seq1.length(); i++) {
+                if (seq1[i] != seq2[i]) { numBad++; }
+                if (numBad > maxDiffs) { return numBad; }
+            }
+            return numBad;
+        }
+
+        for (int w = 0; w < numWords; w++) {
+            numBad += popCount(notEqual(getWord(w), other.getWord(w)) & getValidMask(w));
+            if (numBad > maxDiffs) { return numBad; }
+        }
+
+        return numBad;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "PackedSeq", "countMismatches");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//in each word, base b of A can only match base b of B, so A has at least sum(max(0, countA[b] - countB[b])) base columns
+//where B has something else. Up to min(basesA, nonBasesB) of those can be across from a gap or '.' in B, the rest are mismatches.
+int PackedSeq::minMismatches(const PackedSeq& A, const PackedSeq& B) {
+    int numBad = 0;
+    if (!A.packed || !B.packed || (A.numWords != B.numWords)) { return 0; }
+
+    for (int w = 0; w < A.numWords; w++) {
+        const unsigned char* a = &A.blockCounts[w*5];
+        const unsigned char* b = &B.blockCounts[w*5];
+        int cols = popCount(A.getValidMask(w));
+
+        int onlyA = 0, onlyB = 0, basesA = 0, basesB = 0;
+        for (int k = 0; k < 5; k++) {
+            int d = (int)a[k] - (int)b[k];
+            if (d > 0) { onlyA += d; } else { onlyB -= d; }
+            basesA += a[k]; basesB += b[k];
+        }
+
+        int badA = onlyA - min(basesA, cols - basesB);
+        int badB = onlyB - min(basesB, cols - basesA);
+        numBad += max(0, max(badA, badB));
+    }
+
+    return numBad;
+}
+/**************************************************************************************************/
+//same as above, but also counts the base columns across from a gap or '.'
+int PackedSeq::minDifferences(const PackedSeq& A, const PackedSeq& B) {
+    int numBad = 0;
+    if (!A.packed || !B.packed || (A.numWords != B.numWords)) { return 0; }
+
+    for (int w = 0; w < A.numWords; w++) {
+        const unsigned char* a = &A.blockCounts[w*5];
+        const unsigned char* b = &B.blockCounts[w*5];
+
+        int onlyA = 0, onlyB = 0;
+        for (int k = 0; k < 5; k++) {
+            int d = (int)a[k] - (int)b[k];
+            if (d > 0) { onlyA += d; } else { onlyB -= d; }
+        }
+        numBad += max(onlyA, onlyB);
+    }
+
+    return numBad;
+}
+/**************************************************************************************************/
+int PackedSeq::popCount(packedWord x) {
+#if defined (__GNUC__) || defined (__clang__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+/**************************************************************************************************/
+//position of the lowest set bit, x must not be 0
+int PackedSeq::firstSet(packedWord x) {
+#if defined (__GNUC__) || defined (__clang__)
+    return __builtin_ctzll(x);
+#else
+    int pos = 0;
+    while (!((x >> pos) & 1)) { pos++; }
+    return pos;
+#endif
+}
+/**************************************************************************************************/
+//position of the highest set bit, x must not be 0
+int PackedSeq::lastSet(packedWord x) {
+#if defined (__GNUC__) || defined (__clang__)
+    return 63 - __builtin_clzll(x);
+#else
+    int pos = 63;
+    while (!((x >> pos) & 1)) { pos--; }
+    return pos;
+#endif
+}
+/**************************************************************************************************/
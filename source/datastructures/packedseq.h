@@ -0,0 +1,93 @@
+//
+//  packedseq.h
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__packedseq__
+#define __Mothur__packedseq__
+
+#include "mothur.h"
+#include "mothurout.h"
+#include "sequence.hpp"
+
+/* This class stores an aligned sequence as bit planes with one bit per alignment column.  Every 64 columns are stored as 6 words:
+ 4 planes holding a 4 bit base code, one plane marking the '.' columns and one marking the '-' columns.  The distance calculators
+ use the planes to compare 64 columns with a handful of word operations instead of walking the aligned strings one char at a time.
+
+ The packed alphabet is ACGTUNRYSWKMBDHV plus '.' and '-'.  If a sequence contains any other character it is left unpacked and
+ the calculators fall back to their string versions, so the distances are always identical to the unpacked ones.
+ */
+
+typedef unsigned long long packedWord;
+
+/**************************************************************************************************/
+
+class PackedSeq {
+
+public:
+
+    PackedSeq();
+    PackedSeq(Sequence);
+    PackedSeq(string, string); //name, aligned
+    ~PackedSeq() {}
+
+    string getName() const { return name; }
+    string getAligned() const;
+    Sequence getSequence() const { return Sequence(name, getAligned()); }
+    int getAlignLength() const { return alignLength; }
+    int getNumWords() const { return numWords; }
+    bool isPacked() const { return packed; }
+    int getNumBases() const { return numBases; }
+    int getNumDots() const { return numDots; }
+    int getFirstNonDot() const { return firstNonDot; }
+    int getLastNonDot() const { return lastNonDot; }
+    bool hasEndDotsOnly() const { return endDotsOnly; } //true if '.' only appears before the first and after the last base or '-'
+
+    //the 6 words for columns w*64 to w*64+63: code planes 0-3, dots, dashes
+    const packedWord* getWord(int w) const { return &bits[w*6]; }
+
+    //mask of the valid columns in word w, the last word may be partially filled
+    packedWord getValidMask(int w) const;
+
+    //counts the columns where the aligned chars differ, stops once the count is above maxDiffs
+    int countMismatches(const PackedSeq&, int) const;
+
+    //lower bounds on the differences between two packed sequences, computed from the per word base counts only.
+    //minMismatches counts columns where both have a base and the bases differ, minDifferences counts base columns where the other sequence has anything else.
+    static int minMismatches(const PackedSeq&, const PackedSeq&);
+    static int minDifferences(const PackedSeq&, const PackedSeq&);
+
+    static int popCount(packedWord);
+    static int firstSet(packedWord);
+    static int lastSet(packedWord);
+
+    //columns where the chars of a and b differ
+    static packedWord notEqual(const packedWord* a, const packedWord* b) {
+        return (a[0] ^ b[0]) | (a[1] ^ b[1]) | (a[2] ^ b[2]) | (a[3] ^ b[3]) | (a[4] ^ b[4]) | (a[5] ^ b[5]);
+    }
+
+    //columns that are in seeds, or in pass and reachable from a seed by stepping forward through pass columns only.
+    //carry holds the top bit of the previous words result and is updated for the next word.
+    static packedWord fillThrough(packedWord seeds, packedWord pass, packedWord& carry) {
+        packedWord starts = pass & ((seeds << 1) | carry);
+        packedWord filled = seeds | (pass & ~(pass + starts));
+        carry = filled >> 63;
+        return filled;
+    }
+
+private:
+    MothurOut* m;
+    string name, aligned; //aligned is only saved if the sequence can not be packed
+    int alignLength, numWords, numBases, numDots, firstNonDot, lastNonDot;
+    bool packed, endDotsOnly;
+    vector<packedWord> bits;
+    vector<unsigned char> blockCounts; //numWords * 5: number of A, C, G, T and other bases in each word
+
+    void pack(string);
+};
+
+/**************************************************************************************************/
+
+#endif /* defined(__Mothur__packedseq__) */
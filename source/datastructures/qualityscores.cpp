@@ -90,6 +90,56 @@ QualityScores::QualityScores(ifstream& qFile){
 	
 }
 /**************************************************************************************************/
+//reads the same as the ifstream version, but parses the scores in place instead of through a stringstream
+QualityScores::QualityScores(BlockReader& qFile){
+	try {
+		
+		m = MothurOut::getInstance();
+		
+		fastaRecord record;
+		qFile.getFasta(record);
+		
+		const char* pos = record.header.data; const char* end = pos + record.header.length;
+		const char* nameEnd = pos; while ((nameEnd != end) && !isspace(*nameEnd)) { nameEnd++; }
+		seqName = "";
+		if (nameEnd != pos) {
+			seqName = string(pos+1, nameEnd-pos-1);
+			m->checkName(seqName);
+		}else{ m->mothurOut("Error in reading your qfile. Blank name."); m->mothurOutEndLine(); m->control_pressed = true;  }
+		
+		if (m->debug) { m->mothurOut("[DEBUG]: name = '" + seqName + "'\n.");  }
+		
+		if (!m->control_pressed) {
+			pos = record.body.data; end = pos + record.body.length;
+			qScores.reserve(record.body.length / 3);
+			
+			while (pos != end) {
+				while ((pos != end) && isspace(*pos)) { pos++; }
+				if (pos == end) { break; }
+				
+				const char* scoreEnd = pos; int score = 0; bool digits = true;
+				while ((scoreEnd != end) && !isspace(*scoreEnd)) {
+					if ((*scoreEnd > 47) && (*scoreEnd < 58)) { score = (score * 10) + (*scoreEnd - 48); }
+					else { digits = false; }
+					scoreEnd++;
+				}
+				
+				//check to make sure its a number
+				if (!digits) { m->mothurOut("[ERROR]: In sequence " + seqName + "'s quality scores, expected a number and got " + string(pos, scoreEnd-pos) + ", setting score to 0."); m->mothurOutEndLine(); score = 0; }
+				
+				qScores.push_back(score);
+				pos = scoreEnd;
+			}
+		}
+		
+		seqLength = qScores.size();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "QualityScores", "QualityScores");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
 #ifdef USE_BOOST
 QualityScores::QualityScores(boost::iostreams::filtering_istream& qFile){
     try {
@@ -25,6 +25,7 @@ public:
     ~QualityScores() {}
     QualityScores(string n, vector<int> qs);
 	QualityScores(ifstream&);
+    QualityScores(BlockReader&);
     #ifdef USE_BOOST
     QualityScores(boost::iostreams::filtering_istream&);
     #endif
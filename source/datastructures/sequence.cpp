@@ -189,6 +189,68 @@ Sequence::Sequence(ifstream& fastaFile){
 	}							
 }
 //********************************************************************************************************************
+//reads the same as the ifstream version, but parses the record in place. Commented out sequences are skipped whole.
+Sequence::Sequence(BlockReader& fastaFile){
+	try {
+		m = MothurOut::getInstance();
+		initialize();
+		
+		fastaRecord record;
+		fastaFile.getFasta(record);
+		
+		const char* pos = record.header.data; const char* end = pos + record.header.length;
+		const char* nameEnd = pos; while ((nameEnd != end) && !isspace(*nameEnd)) { nameEnd++; }
+		
+		if (nameEnd != pos) {
+			name = string(pos+1, nameEnd-pos-1);
+			m->checkName(name);
+		}else{ m->mothurOut("Error in reading your fastafile. Blank name."); m->mothurOutEndLine(); m->control_pressed = true;  }
+		
+		if (!m->control_pressed) { 
+			
+			//read comments
+			while ((name[0] == '#') && !fastaFile.eof()) {
+				fastaFile.getFasta(record);
+				pos = record.header.data; end = pos + record.header.length;
+				nameEnd = pos; while ((nameEnd != end) && !isspace(*nameEnd)) { nameEnd++; }
+				name = ""; if (nameEnd != pos) { name = string(pos+1, nameEnd-pos-1); }
+			}
+			if (name[0] == '#') { name = ""; record.body = textView(); nameEnd = end; }
+			
+			comment = string(nameEnd, end-nameEnd);
+			
+			int numAmbig = 0;
+			string sequence = "";
+			sequence.reserve(record.body.length);
+			for (int i = 0; i < record.body.length; i++) {
+				char letter = record.body.data[i];
+				if (letter == ' ') {;}
+				else if(isprint(letter)){
+					letter = toupper(letter);
+					if(letter == 'U'){letter = 'T';}
+					if(letter != '.' && letter != '-' && letter != 'A' && letter != 'T' && letter != 'G'  && letter != 'C' && letter != 'N'){
+						letter = 'N';
+						numAmbig++;
+					}
+					sequence += letter;
+				}
+			}
+			
+			setAligned(sequence);	
+			//setUnaligned removes any gap characters for us						
+			setUnaligned(sequence);	
+			
+			if ((numAmbig / (float) numBases) > 0.25) { m->mothurOut("[WARNING]: We found more than 25% of the bases in sequence " + name + " to be ambiguous. Mothur is not setup to process protein sequences."); m->mothurOutEndLine(); }
+			
+		}
+
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Sequence", "Sequence");
+		exit(1);
+	}							
+}
+//********************************************************************************************************************
 //this function will jump over commented out sequences, but if the last sequence in a file is commented out it makes a blank seq
 #ifdef USE_BOOST
 Sequence::Sequence(boost::iostreams::filtering_istream& fastaFile){
@@ -19,6 +19,7 @@
 
 #include "mothur.h"
 #include "mothurout.h"
+#include "blockreader.h"
 
 
 /**************************************************************************************************/
@@ -33,6 +34,7 @@ public:
 	Sequence();
 	Sequence(string, string);
 	Sequence(ifstream&);
+    Sequence(BlockReader&);
     Sequence(ifstream&, string&, bool);
 	Sequence(istringstream&);
 	//these constructors just set the unaligned string to save space
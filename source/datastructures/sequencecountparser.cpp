@@ -204,6 +204,48 @@ vector<Sequence> SequenceCountParser::getSeqs(string g){
 	}
 }
 /************************************************************/
+int SequenceCountParser::getSeqs(string g, vector<seqPriorityNode>& nameVector){
+	try {
+		map<string, vector<Sequence> >::iterator it;
+		nameVector.clear();
+		
+		it = seqs.find(g);
+		if(it == seqs.end()) {
+			m->mothurOut("[ERROR]: No sequences available for group " + g + ", please correct."); m->mothurOutEndLine();
+			return 0;
+		}
+		
+		vector<Sequence>& seqForThisGroup = it->second;
+		
+		map<string, int> countForThisGroup = getCountTable(g);
+		map<string, int>::iterator itCount;
+		int error = 0;
+		
+		for (int i = 0; i < seqForThisGroup.size(); i++) {
+			itCount = countForThisGroup.find(seqForThisGroup[i].getName());
+			
+			if (itCount == countForThisGroup.end()){
+				error = 1;
+				m->mothurOut("[ERROR]: " + seqForThisGroup[i].getName() + " is in your fastafile, but is not in your count file, please correct."); m->mothurOutEndLine();
+			}else {
+                seqPriorityNode temp(itCount->second, seqForThisGroup[i].getUnaligned(), seqForThisGroup[i].getName());
+				nameVector.push_back(temp);
+			}
+		}
+		
+		if (error == 1) { nameVector.clear(); return 1; }
+		
+		//sort by num represented
+		sort(nameVector.begin(), nameVector.end(), compareSeqPriorityNodes);
+		
+		return 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SequenceCountParser", "getSeqs");
+		exit(1);
+	}
+}
+/************************************************************/
 int SequenceCountParser::getSeqs(string g, string filename, string tag, string tag2, long long& numSeqs, bool uchimeFormat=false){
 	try {
 		map<string, vector<Sequence> >::iterator it;
@@ -227,27 +269,8 @@ int SequenceCountParser::getSeqs(string g, string filename, string tag, string t
 				//>seqName /ab=numRedundantSeqs/
 				//sequence
 				
-				map<string, int> countForThisGroup = getCountTable(g);
-				map<string, int>::iterator itCount;
-				int error = 0;
+				if (getSeqs(g, nameVector) == 1) { out.close(); m->mothurRemove(filename); return 1; }
 				
-				for (int i = 0; i < seqForThisGroup.size(); i++) {
-					itCount = countForThisGroup.find(seqForThisGroup[i].getName());
-					
-					if (itCount == countForThisGroup.end()){
-						error = 1;
-						m->mothurOut("[ERROR]: " + seqForThisGroup[i].getName() + " is in your fastafile, but is not in your count file, please correct."); m->mothurOutEndLine();
-					}else {
-                        seqPriorityNode temp(itCount->second, seqForThisGroup[i].getUnaligned(), seqForThisGroup[i].getName());
-						nameVector.push_back(temp);
-					}
-				}
-				
-				if (error == 1) { out.close(); m->mothurRemove(filename); return 1; }
-				
-				//sort by num represented
-				sort(nameVector.begin(), nameVector.end(), compareSeqPriorityNodes);
-                
 				//print new file in order of
 				for (int i = 0; i < nameVector.size(); i++) {
 					
@@ -38,6 +38,7 @@ public:
     vector<Sequence> getSeqs(string); //returns unique sequences in a specific group
     map<string, int> getCountTable(string); //returns seqName -> numberOfRedundantSeqs for a specific group - the count file format, but each line is parsed by group.
     
+    int getSeqs(string, vector<seqPriorityNode>&); //unique sequences in a specific group and their abundances, sorted by abundance - group, seqs. returns 1 if a sequence is missing from the name or count file
     int getSeqs(string, string, string, string, long long&, bool); //prints unique sequences in a specific group to a file - group, filename, uchimeFormat=false, tag (/ab= or ;size=), tag2(/ or ;)
     int getCountTable(string, string); //print seqName -> numberRedundantSeqs for a specific group - group, filename
     
@@ -219,6 +219,50 @@ vector<Sequence> SequenceParser::getSeqs(string g){
 	}
 }
 /************************************************************/
+int SequenceParser::getSeqs(string g, vector<seqPriorityNode>& nameVector){
+	try {
+		map<string, vector<Sequence> >::iterator it;
+		nameVector.clear();
+		
+		it = seqs.find(g);
+		if(it == seqs.end()) {
+			m->mothurOut("[ERROR]: No sequences available for group " + g + ", please correct."); m->mothurOutEndLine();
+			return 0;
+		}
+		
+		vector<Sequence>& seqForThisGroup = it->second;
+		
+		map<string, string> nameMapForThisGroup = getNameMap(g);
+		map<string, string>::iterator itNameMap;
+		int error = 0;
+		
+		for (int i = 0; i < seqForThisGroup.size(); i++) {
+			itNameMap = nameMapForThisGroup.find(seqForThisGroup[i].getName());
+			
+			if (itNameMap == nameMapForThisGroup.end()){
+				error = 1;
+				m->mothurOut("[ERROR]: " + seqForThisGroup[i].getName() + " is in your fastafile, but is not in your namesfile, please correct."); m->mothurOutEndLine();
+			}else {
+				int num = m->getNumNames(itNameMap->second);
+				
+				seqPriorityNode temp(num, seqForThisGroup[i].getUnaligned(), seqForThisGroup[i].getName());
+				nameVector.push_back(temp);
+			}
+		}
+		
+		if (error == 1) { nameVector.clear(); return 1; }
+		
+		//sort by num represented
+		sort(nameVector.begin(), nameVector.end(), compareSeqPriorityNodes);
+		
+		return 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SequenceParser", "getSeqs");
+		exit(1);
+	}
+}
+/************************************************************/
 int SequenceParser::getSeqs(string g, string filename, string tag, string tag2, long long& numSeqs, bool uchimeFormat=false){
 	try {
 		map<string, vector<Sequence> >::iterator it;
@@ -243,29 +287,8 @@ int SequenceParser::getSeqs(string g, string filename, string tag, string tag2,
 				//>seqName /ab=numRedundantSeqs/
 				//sequence
 				
-				map<string, string> nameMapForThisGroup = getNameMap(g);
-				map<string, string>::iterator itNameMap;
-				int error = 0;
+				if (getSeqs(g, nameVector) == 1) { out.close(); m->mothurRemove(filename); return 1; }
 				
-				for (int i = 0; i < seqForThisGroup.size(); i++) {
-					itNameMap = nameMapForThisGroup.find(seqForThisGroup[i].getName());
-					
-					if (itNameMap == nameMapForThisGroup.end()){
-						error = 1;
-						m->mothurOut("[ERROR]: " + seqForThisGroup[i].getName() + " is in your fastafile, but is not in your namesfile, please correct."); m->mothurOutEndLine();
-					}else {
-						int num = m->getNumNames(itNameMap->second);
-						
-						seqPriorityNode temp(num, seqForThisGroup[i].getUnaligned(), seqForThisGroup[i].getName());
-						nameVector.push_back(temp);
-					}
-				}
-				
-				if (error == 1) { out.close(); m->mothurRemove(filename); return 1; }
-				
-				//sort by num represented
-				sort(nameVector.begin(), nameVector.end(), compareSeqPriorityNodes);
-
 				//print new file in order of
 				for (int i = 0; i < nameVector.size(); i++) {
 					
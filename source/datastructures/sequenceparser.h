@@ -41,6 +41,7 @@ class SequenceParser {
 		vector<Sequence> getSeqs(string); //returns unique sequences in a specific group
 		map<string, string> getNameMap(string); //returns seqName -> namesOfRedundantSeqs separated by commas for a specific group - the name file format, but each line is parsed by group.
 		
+		int getSeqs(string, vector<seqPriorityNode>&); //unique sequences in a specific group and their abundances, sorted by abundance - group, seqs. returns 1 if a sequence is missing from the name or count file
 		int getSeqs(string, string, string, string, long long&, bool); //prints unique sequences in a specific group to a file - group, filename, uchimeFormat=false, tag(/ab= or ;size=), tag2(/ or ;)
 		int getNameMap(string, string); //print seqName -> namesOfRedundantSeqs separated by commas for a specific group - group, filename
 		
@@ -0,0 +1,443 @@
+//
+//  summarycache.cpp
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+//  The cache file is:
+//      header: "MOTHSTAT", format version (uint32), unused (uint32), fasta size (uint64), fasta modification time (int64),
+//              number of sequences (uint64), number of blocks (uint64), directory position (uint64), path length (uint64)
+//      the full path of the fasta file, padded with zeros to a multiple of 8 bytes
+//      blocks: number of sequences n (uint64), length of the names (uint64), the starts, ends, bases, ambigs, homopolymers
+//              and N's (int32 x n each), the record positions (uint64 x n), the name offsets (uint32 x n+1) and the names,
+//              each padded to a multiple of 8 bytes
+//      directory: the position of each block (uint64)
+//
+
+#include "summarycache.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+	#include <sys/mman.h>
+	#include <fcntl.h>
+#endif
+
+static const char summaryCacheMagic[] = "MOTHSTAT";
+static const int summaryCacheHeaderSize = 64;
+static const unsigned int summaryCacheFormatVersion = 1;
+static const int blockSize = 65536; //sequences in a block
+static const int copySize = 4194304; //bytes copied from a part at a time
+
+static unsigned long long padded(unsigned long long length) { return (length + 7) / 8 * 8; }
+
+/**************************************************************************************************/
+SummaryCache::SummaryCache(string f) {
+    try {
+        m = MothurOut::getInstance();
+        fastafile = f;
+        numSeqs = 0; fastaSize = 0; fastaTime = 0;
+        mappedData = NULL; mappedSize = 0;
+        writing = false; isPart = false;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SummaryCache", "SummaryCache");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+SummaryCache::~SummaryCache() {
+    try {
+        if (writing) { remove(); } //never finished
+        unmap();
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SummaryCache", "~SummaryCache");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+bool SummaryCache::getFastaKey() {
+    try {
+        struct stat fileInfo;
+        if (stat(fastafile.c_str(), &fileInfo) != 0) { return false; }
+
+        fastaPath = m->getFullPathName(fastafile);
+        fastaSize = fileInfo.st_size;
+        fastaTime = (long long)fileInfo.st_mtime * 1000000000LL;
+#if defined (__APPLE__) || (__MACH__)
+        fastaTime += fileInfo.st_mtimespec.tv_nsec;
+#elif defined (linux) || (__linux) || (__linux__)
+        fastaTime += fileInfo.st_mtim.tv_nsec;
+#endif
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SummaryCache", "getFastaKey");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//maps the cache read only, on platforms without mmap the file is read into memory
+bool SummaryCache::read() {
+    try {
+        unmap(); blocks.clear(); numSeqs = 0;
+
+        string cacheName = getCacheName(fastafile);
+        if (!getFastaKey()) { return false; }
+
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+        int fd = ::open(cacheName.c_str(), O_RDONLY);
+        if (fd == -1) { return false; }
+
+        struct stat fileInfo;
+        fstat(fd, &fileInfo);
+        if (fileInfo.st_size < summaryCacheHeaderSize) { ::close(fd); return false; }
+        mappedSize = fileInfo.st_size;
+
+        void* mapped = mmap(NULL, mappedSize, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) { mappedSize = 0; return false; }
+        mappedData = (const char*)mapped;
+        const char* data = mappedData;
+#else
+        ifstream in(cacheName.c_str(), ios::binary);
+        if (!in) { return false; }
+
+        in.seekg(0, ios::end); mappedSize = in.tellg(); in.seekg(0, ios::beg);
+        if (mappedSize < summaryCacheHeaderSize) { mappedSize = 0; return false; }
+        fileData.resize((mappedSize + 7) / 8);
+        in.read((char*)&fileData[0], mappedSize);
+        in.close();
+        const char* data = (const char*)&fileData[0];
+#endif
+
+        unsigned int version;
+        unsigned long long size, totalSeqs, numBlocks, directory, pathLength;
+        long long time;
+        memcpy(&version, data + 8, 4);
+        memcpy(&size, data + 16, 8);
+        memcpy(&time, data + 24, 8);
+        memcpy(&totalSeqs, data + 32, 8);
+        memcpy(&numBlocks, data + 40, 8);
+        memcpy(&directory, data + 48, 8);
+        memcpy(&pathLength, data + 56, 8);
+
+        bool valid = (memcmp(data, summaryCacheMagic, 8) == 0) && (version == summaryCacheFormatVersion);
+        valid = valid && (size == fastaSize) && (time == fastaTime);
+        valid = valid && ((summaryCacheHeaderSize + pathLength) <= mappedSize) && (string(data + summaryCacheHeaderSize, pathLength) == fastaPath);
+        valid = valid && (directory <= mappedSize) && (numBlocks <= ((mappedSize - directory) / 8));
+        if (!valid) { unmap(); return false; }
+
+        const unsigned long long* directoryOffsets = (const unsigned long long*)(data + directory);
+        for (int i = 0; i < numBlocks; i++) {
+            unsigned long long offset = directoryOffsets[i];
+            if ((offset % 8 != 0) || ((offset + 16) > mappedSize)) { unmap(); blocks.clear(); return false; }
+
+            unsigned long long n, nameLength;
+            memcpy(&n, data + offset, 8);
+            memcpy(&nameLength, data + offset + 8, 8);
+            if (n > blockSize) { unmap(); blocks.clear(); return false; }
+
+            unsigned long long length = 16 + 24 * n + 8 * n + padded(4 * (n+1)) + padded(nameLength);
+            if ((offset + length) > mappedSize) { unmap(); blocks.clear(); return false; }
+
+            summaryBlock block;
+            block.numSeqs = n;
+            const int* columns = (const int*)(data + offset + 16);
+            block.starts = columns; block.ends = columns + n; block.numBases = columns + 2*n;
+            block.ambigs = columns + 3*n; block.homops = columns + 4*n; block.numNs = columns + 5*n;
+            block.recordStarts = (const unsigned long long*)(columns + 6*n);
+            block.nameOffsets = (const unsigned int*)(block.recordStarts + n);
+            block.names = (const char*)block.nameOffsets + padded(4 * (n+1));
+            //every name must lie inside the name data, so getName never reads past the block
+            bool namesInside = (block.nameOffsets[n] == nameLength);
+            for (int j = 0; namesInside && (j < n); j++) { namesInside = (block.nameOffsets[j] <= block.nameOffsets[j+1]); }
+            if (!namesInside) { unmap(); blocks.clear(); return false; }
+
+            blocks.push_back(block);
+            numSeqs += n;
+        }
+
+        if (numSeqs != totalSeqs) { unmap(); blocks.clear(); numSeqs = 0; return false; }
+
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+        madvise((void*)mappedData, mappedSize, MADV_SEQUENTIAL);
+#endif
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SummaryCache", "read");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+long long SummaryCache::fillSummary(bool hasNames, map<string, int>& nameMap, map<int, long long>& startPosition, map<int, long long>& endPosition, map<int, long long>& seqLength, map<int, long long>& ambigBases, map<int, long long>& longHomoPolymer, map<int, long long>& numNs, ofstream* outSummary) {
+    try {
+        long long count = 0;
+        for (int b = 0; b < blocks.size(); b++) {
+            if (m->control_pressed) { break; }
+
+            const summaryBlock& block = blocks[b];
+            for (int i = 0; i < block.numSeqs; i++) {
+                string name = block.getName(i);
+
+                int num = 1;
+                if (hasNames) {
+                    //make sure this sequence is in the namefile, else error
+                    map<string, int>::iterator it = nameMap.find(name);
+
+                    if (it == nameMap.end()) { m->mothurOut("[ERROR]: '" + name + "' is not in your name or count file, please correct."); m->mothurOutEndLine(); m->control_pressed = true; }
+                    else { num = it->second; }
+                }
+
+                startPosition[block.starts[i]] += num;
+                endPosition[block.ends[i]] += num;
+                seqLength[block.numBases[i]] += num;
+                ambigBases[block.ambigs[i]] += num;
+                longHomoPolymer[block.homops[i]] += num;
+                numNs[block.numNs[i]] += num;
+                count++;
+
+                if (outSummary != NULL) {
+                    (*outSummary) << name << '\t' << block.starts[i] << '\t' << block.ends[i] << '\t';
+                    (*outSummary) << block.numBases[i] << '\t' << block.ambigs[i] << '\t' << block.homops[i] << '\t' << num << endl;
+                }
+            }
+        }
+
+        return count;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SummaryCache", "fillSummary");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void SummaryCache::unmap() {
+    try {
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+        if (mappedData != NULL) { munmap((void*)mappedData, mappedSize); }
+#endif
+        mappedData = NULL; mappedSize = 0;
+        vector<unsigned long long> empty; fileData.swap(empty);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SummaryCache", "unmap");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+bool SummaryCache::create() {
+    try {
+        isPart = false;
+        return open(getCacheName(fastafile) + ".temp");
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SummaryCache", "create");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+bool SummaryCache::createPart(string partName) {
+    try {
+        isPart = true;
+        return open(partName);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SummaryCache", "createPart");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//a fasta file that cannot be found, or a directory that cannot be written, just means there is no cache
+bool SummaryCache::open(string filename) {
+    try {
+        writing = false;
+        if (!getFastaKey()) { return false; }
+
+        outputName = filename;
+        out.open(outputName.c_str(), ios::binary | ios::trunc);
+        if (!out) { out.clear(); return false; }
+        writing = true;
+
+        //the header is filled in by close
+        string header(summaryCacheHeaderSize + padded(fastaPath.length()), '\0');
+        memcpy(&header[summaryCacheHeaderSize], fastaPath.c_str(), fastaPath.length());
+        out.write(header.c_str(), header.length());
+
+        numSeqs = 0; blockOffsets.clear();
+        starts.clear(); ends.clear(); numBases.clear(); ambigs.clear(); homops.clear(); numNs.clear();
+        recordStarts.clear(); nameOffsets.assign(1, 0); names = "";
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SummaryCache", "open");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void SummaryCache::add(string name, int start, int end, int bases, int ambig, int homop, int ns, unsigned long long recordStart) {
+    try {
+        if (!writing) { return; }
+
+        starts.push_back(start); ends.push_back(end); numBases.push_back(bases);
+        ambigs.push_back(ambig); homops.push_back(homop); numNs.push_back(ns);
+        recordStarts.push_back(recordStart);
+        names += name; nameOffsets.push_back(names.length());
+        numSeqs++;
+
+        if (starts.size() == blockSize) { writeBlock(); }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SummaryCache", "add");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void SummaryCache::writeBlock() {
+    try {
+        unsigned long long n = starts.size();
+        if (n == 0) { return; }
+
+        blockOffsets.push_back(out.tellp());
+
+        unsigned long long nameLength = names.length();
+        out.write((const char*)&n, 8);
+        out.write((const char*)&nameLength, 8);
+        out.write((const char*)&starts[0], 4*n);
+        out.write((const char*)&ends[0], 4*n);
+        out.write((const char*)&numBases[0], 4*n);
+        out.write((const char*)&ambigs[0], 4*n);
+        out.write((const char*)&homops[0], 4*n);
+        out.write((const char*)&numNs[0], 4*n);
+        out.write((const char*)&recordStarts[0], 8*n);
+
+        char zeros[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+        out.write((const char*)&nameOffsets[0], 4*(n+1));
+        out.write(zeros, padded(4*(n+1)) - 4*(n+1));
+        out.write(names.c_str(), nameLength);
+        out.write(zeros, padded(nameLength) - nameLength);
+
+        starts.clear(); ends.clear(); numBases.clear(); ambigs.clear(); homops.clear(); numNs.clear();
+        recordStarts.clear(); nameOffsets.assign(1, 0); names = "";
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SummaryCache", "writeBlock");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void SummaryCache::appendPart(string partName) {
+    try {
+        if (!writing) { m->mothurRemove(partName); return; }
+
+        writeBlock();
+
+        ifstream in(partName.c_str(), ios::binary);
+        char header[summaryCacheHeaderSize];
+        in.read(header, summaryCacheHeaderSize);
+        if (in.gcount() != summaryCacheHeaderSize) { in.close(); m->mothurRemove(partName); remove(); return; } //the part was never finished
+
+        unsigned int version;
+        unsigned long long partSeqs, numBlocks, directory, pathLength;
+        memcpy(&version, header + 8, 4);
+        memcpy(&partSeqs, header + 32, 8);
+        memcpy(&numBlocks, header + 40, 8);
+        memcpy(&directory, header + 48, 8);
+        memcpy(&pathLength, header + 56, 8);
+
+        //the blocks are between the path and the directory, and only their positions change
+        unsigned long long partStart = summaryCacheHeaderSize + padded(pathLength);
+        unsigned long long outStart = out.tellp();
+
+        //close writes the magic last, so a part without it was never finished
+        bool valid = (memcmp(header, summaryCacheMagic, 8) == 0) && (version == summaryCacheFormatVersion);
+        valid = valid && (pathLength == fastaPath.length()) && (directory >= partStart) && (directory % 8 == 0);
+        if (!valid) { in.close(); m->mothurRemove(partName); remove(); return; }
+
+        vector<unsigned long long> partOffsets(numBlocks);
+        in.seekg(directory);
+        if (numBlocks != 0) { in.read((char*)&partOffsets[0], 8 * numBlocks); }
+        if (!in) { in.close(); m->mothurRemove(partName); remove(); return; }
+        for (int i = 0; i < numBlocks; i++) {
+            if ((partOffsets[i] < partStart) || (partOffsets[i] >= directory)) { in.close(); m->mothurRemove(partName); remove(); return; }
+            blockOffsets.push_back(partOffsets[i] - partStart + outStart);
+        }
+
+        in.seekg(partStart);
+        vector<char> buffer(copySize);
+        unsigned long long toCopy = directory - partStart;
+        while (toCopy > 0) {
+            unsigned long long length = copySize; if (toCopy < length) { length = toCopy; }
+            in.read(&buffer[0], length);
+            if (in.gcount() != length) { break; }
+            out.write(&buffer[0], length);
+            toCopy -= length;
+        }
+        in.close();
+        m->mothurRemove(partName);
+
+        if (toCopy != 0) { remove(); return; }
+        numSeqs += partSeqs;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SummaryCache", "appendPart");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void SummaryCache::close() {
+    try {
+        if (!writing) { return; }
+
+        writeBlock();
+
+        unsigned long long directory = out.tellp();
+        if (blockOffsets.size() != 0) { out.write((const char*)&blockOffsets[0], 8 * blockOffsets.size()); }
+
+        char header[summaryCacheHeaderSize];
+        memset(header, 0, summaryCacheHeaderSize);
+        unsigned long long numBlocks = blockOffsets.size();
+        unsigned long long totalSeqs = numSeqs;
+        unsigned long long pathLength = fastaPath.length();
+        memcpy(header, summaryCacheMagic, 8);
+        memcpy(header + 8, &summaryCacheFormatVersion, 4);
+        memcpy(header + 16, &fastaSize, 8);
+        memcpy(header + 24, &fastaTime, 8);
+        memcpy(header + 32, &totalSeqs, 8);
+        memcpy(header + 40, &numBlocks, 8);
+        memcpy(header + 48, &directory, 8);
+        memcpy(header + 56, &pathLength, 8);
+        out.seekp(0);
+        out.write(header, summaryCacheHeaderSize);
+
+        bool good = out.good();
+        out.close();
+        writing = false;
+
+        if (!good) { m->mothurRemove(outputName); return; }
+        if (!isPart) { m->renameFile(outputName, getCacheName(fastafile)); }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SummaryCache", "close");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void SummaryCache::remove() {
+    try {
+        if (!writing) { return; }
+        out.close(); out.clear();
+        writing = false;
+        m->mothurRemove(outputName);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SummaryCache", "remove");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
@@ -0,0 +1,98 @@
+//
+//  summarycache.h
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__summarycache__
+#define __Mothur__summarycache__
+
+#include "mothur.h"
+#include "mothurout.h"
+
+/* This class stores the summary of each sequence in a fasta file - start, end, number of bases, ambiguous bases, longest
+ homopolymer and number of N's - with the name and position of its record, in a binary file next to the fasta file.  The
+ file records the path, size and modification time of the fasta file, so it is only used while the fasta file is unchanged.
+
+ Commands that read the whole fasta file, like summary.seqs, write the cache as they go.  summary.seqs, screen.seqs and
+ qc.seqs then get the summaries from the cache instead of reading the fasta file again, and get.seqs and remove.seqs use the
+ record positions to read only the sequences they write.
+
+ The sequences are stored in blocks, each with one column per value, so a block can be used directly from the mapped file.
+ A block is written by one process, so the processes of a command each write a part and the parts are appended in order.
+ */
+
+/**************************************************************************************************/
+
+struct summaryBlock {
+    int numSeqs;
+    const int *starts, *ends, *numBases, *ambigs, *homops, *numNs;
+    const unsigned long long* recordStarts; //position of the record in the fasta file
+    const unsigned int* nameOffsets; //the name of sequence i is names[nameOffsets[i]] to names[nameOffsets[i+1]-1]
+    const char* names;
+
+    string getName(int i) const { return string(names + nameOffsets[i], nameOffsets[i+1] - nameOffsets[i]); }
+};
+
+/**************************************************************************************************/
+
+class SummaryCache {
+
+public:
+
+    SummaryCache(string); //fasta file
+    ~SummaryCache();
+
+    static string getCacheName(string fastafile) { return fastafile + ".stats"; }
+
+    //reading
+    bool read(); //maps the cache file, false if there is none or it does not match the fasta file
+    long long getNumSeqs() { return numSeqs; }
+    int getNumBlocks() { return blocks.size(); }
+    const summaryBlock& getBlock(int i) { return blocks[i]; }
+    //adds each sequence once for every read it represents, from nameMap if hasNames, and writes its summary.seqs line
+    //to outSummary if it is not NULL.  Returns the number of sequences.
+    long long fillSummary(bool, map<string, int>&, map<int, long long>&, map<int, long long>&, map<int, long long>&, map<int, long long>&, map<int, long long>&, map<int, long long>&, ofstream*); //hasNames, nameMap, start, end, bases, ambigs, homop, Ns, outSummary
+
+    //writing, the cache is written to a temporary file that close renames, so it is never read half written
+    bool create();
+    bool createPart(string); //a part of the fasta file, written by one process
+    void add(string, int, int, int, int, int, int, unsigned long long); //name, start, end, bases, ambigs, homop, Ns, record position
+    void appendPart(string); //adds the sequences of a finished part and removes the part file
+    void close();
+    void remove(); //abandons the file being written
+
+private:
+
+    MothurOut* m;
+    string fastafile, outputName;
+    long long numSeqs;
+
+    //the key of the fasta file
+    string fastaPath;
+    unsigned long long fastaSize;
+    long long fastaTime;
+
+    vector<summaryBlock> blocks;
+    const char* mappedData;
+    unsigned long long mappedSize;
+    vector<unsigned long long> fileData; //the cache on platforms without mmap
+
+    ofstream out;
+    bool writing, isPart;
+    vector<unsigned long long> blockOffsets;
+    vector<int> starts, ends, numBases, ambigs, homops, numNs;
+    vector<unsigned long long> recordStarts;
+    vector<unsigned int> nameOffsets;
+    string names;
+
+    bool getFastaKey();
+    bool open(string);
+    void writeBlock();
+    void unmap();
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -826,7 +826,8 @@ map<string,int> Tree::mergeGcounts(int position) {
 	}
 }
 /**************************************************************************************************/
-void Tree::randomLabels(vector<string> g) {
+//engine lets threads draw from their own generator, NULL uses mothur's
+void Tree::randomLabels(vector<string> g, mt19937_64* engine) {
 	try {
 	
 		//initialize groupNodeInfo
@@ -837,7 +838,8 @@ void Tree::randomLabels(vector<string> g) {
 		for(int i = 0; i < numLeaves; i++){
 			int z;
 			//get random index to switch with
-			z = m->getRandomIndex(i);
+			if (engine == NULL) { z = m->getRandomIndex(i); }
+			else { uniform_int_distribution<int> dis(0, i); z = dis(*engine); }
 			
 			//you only want to randomize the nodes that are from a group the user wants analyzed, so
 			//if either of the leaf nodes you are about to switch are not in the users groups then you don't want to switch them.
@@ -891,14 +893,14 @@ void Tree::randomBlengths()  {
 	}
 }
 /*************************************************************************************************/
-void Tree::assembleRandomUnifracTree(vector<string> g) {
-	randomLabels(g);
+void Tree::assembleRandomUnifracTree(vector<string> g, mt19937_64* engine) {
+	randomLabels(g, engine);
 	assembleTree();
 }
 /*************************************************************************************************/
-void Tree::assembleRandomUnifracTree(string groupA, string groupB) {
+void Tree::assembleRandomUnifracTree(string groupA, string groupB, mt19937_64* engine) {
 	vector<string> temp; temp.push_back(groupA); temp.push_back(groupB);
-	randomLabels(temp);
+	randomLabels(temp, engine);
 	assembleTree();
 }
 
@@ -29,8 +29,8 @@ public:
     //int getSubTree(Tree* originalToCopy, vector<string> seqToInclude, map<string, string> nameMap);  //used with (int, TreeMap) constructor. SeqsToInclude contains subsample wanted - assumes these are unique seqs and size of vector=numLeaves passed into constructor. nameMap is unique -> redundantList can be empty if no namesfile was provided. 
     
 	void assembleRandomTree();
-	void assembleRandomUnifracTree(vector<string>);
-	void assembleRandomUnifracTree(string, string);
+	void assembleRandomUnifracTree(vector<string>, mt19937_64* engine = NULL);
+	void assembleRandomUnifracTree(string, string, mt19937_64* engine = NULL);
     
 	void createNewickFile(string);
 	int getIndex(string);
@@ -65,7 +65,7 @@ private:
 	void addNamesToCounts(map<string, string>);
 	void randomTopology();
 	void randomBlengths();
-	void randomLabels(vector<string>);
+	void randomLabels(vector<string>, mt19937_64*);
 	//void randomLabels(string, string);
 	void printBranch(int, ostream&, map<string, string>);  //recursively print out tree
     void printBranch(int, ostream&, string);
@@ -26,21 +26,11 @@
 /**************************************************************************************************/
 
 GotohOverlap::GotohOverlap(float gO, float gE, float f, float mm, int r) :
-	gapOpen(gO), gapExtend(gE), match(f), mismatch(mm), Alignment(r) {
+	gapOpen(gO), gapExtend(gE), match(f), mismatch(mm), Alignment() {
 	
 	try {
-		for(int i=1;i<nCols;i++){				//	we initialize the dynamic programming matrix by setting the pointers in
-			alignment[0][i].prevCell = 'l';		//	the first row to the left
-			alignment[0][i].cValue = 0;
-			alignment[0][i].dValue = 0;
-		}
-		
-		for(int i=1;i<nRows;i++){				//	we initialize the dynamic programming matrix by setting the pointers in
-			alignment[i][0].prevCell = 'u';		//	the first column upward
-			alignment[i][0].cValue = 0;
-			alignment[i][0].iValue = 0;
-		}
-		
+		nRows = r;	nCols = r;		//	the r x r matrix is allocated by the first alignment that needs it (initializeMatrix),
+									//	banded alignments do not use it
 	}
 	catch(exception& e) {
 		m->errorOut(e, "GotohOverlap", "GotohOverlap");
@@ -55,6 +45,11 @@ void GotohOverlap::align(string A, string B){
 		seqA = ' ' + A;	lA = seqA.length();		//	the algorithm requires that the first character be a dummy value
 		seqB = ' ' + B;	lB = seqB.length();		//	the algorithm requires that the first character be a dummy value
 		
+		if (banded) { alignBanded(); return; }
+		
+		usingBand = false;
+		if (alignment.size() == 0) { initializeMatrix(); }
+		
 		for(int i=1;i<lB;i++){					//	the recursion here is shown in Webb and Miller, Fig. 1A.  Note that 
 			for(int j=1;j<lA;j++){				//	if we need to conserve on space we should see Fig. 1B, which is linear
 				//	in space, which I think is unnecessary
@@ -100,3 +95,59 @@ void GotohOverlap::align(string A, string B){
 }
 
 /**************************************************************************************************/
+//the same recursion as align for the cells with low <= row - column <= high, the cells outside the band score -infinity
+void GotohOverlap::fillBand(int low, int high){
+	try {
+		startBand(low, high);
+		float negativeInfinity = -numeric_limits<float>::infinity();
+		
+		bandPrevC.assign(lA, 0);				//	the first row and column score zero
+		bandC.assign(lA, 0);
+		bandPrevD.assign(lA, 0);
+		bandD.assign(lA, 0);
+		int prevEnd = lA-1;
+		
+		for(int i=1;i<lB;i++){
+			int jStart = max(1, i - bandHigh);
+			int jEnd = min(lA-1, i - bandLow);
+			if (jStart > jEnd) { prevEnd = 0; continue; }
+			
+			if (prevEnd < jEnd)	{ bandPrevC[jEnd] = negativeInfinity; bandPrevD[jEnd] = negativeInfinity;	}	//	above the band
+			
+			float iValue = 0;													//	the first column
+			if (jStart > 1)		{ bandC[jStart-1] = negativeInfinity; iValue = negativeInfinity;	}	//	left of the band
+			
+			for(int j=jStart;j<=jEnd;j++){
+				float diagonal;
+				if(seqB[i] == seqA[j])	{	diagonal = bandPrevC[j-1] + match;		}
+				else					{	diagonal = bandPrevC[j-1] + mismatch;	}
+				
+				iValue = max(iValue, bandC[j-1] + gapOpen) + gapExtend;
+				float dValue = max(bandPrevD[j], bandPrevC[j] + gapOpen) + gapExtend;
+				bandD[j] = dValue;
+				
+				if(iValue > dValue){
+					if(iValue > diagonal){	bandC[j] = iValue;		setBandMove(i, j, 2);	}
+					else{					bandC[j] = diagonal;							}
+				}
+				else{
+					if(dValue > diagonal){	bandC[j] = dValue;		setBandMove(i, j, 1);	}
+					else{					bandC[j] = diagonal;							}
+				}
+			}
+			
+			if (jEnd == lA-1)	{ bandLastColumn[i] = bandC[lA-1];	}
+			if (i == lB-1)		{ for(int j=jStart;j<=jEnd;j++){ bandLastRow[j] = bandC[j]; } }
+			
+			bandC.swap(bandPrevC);
+			bandD.swap(bandPrevD);
+			prevEnd = jEnd;
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "GotohOverlap", "fillBand");
+		exit(1);
+	}
+}
+
+/**************************************************************************************************/
@@ -38,6 +38,8 @@ private:
 	float gapExtend;
 	float match;
 	float mismatch;
+	
+	void fillBand(int, int);
 };
 
 /**************************************************************************************************/
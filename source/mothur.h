@@ -42,6 +42,7 @@
 #include <map>
 #include <string>
 #include <list>
+#include <deque>
 #include <string.h>
 
 //math
@@ -52,6 +53,12 @@
 #include <random>
 #include <chrono>
 
+//threads
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
 //misc
 #include <cerrno>
 #include <ctime>
@@ -212,6 +219,16 @@ struct linePair {
     linePair(){ start=0; end=0; }
     ~linePair(){}
 };
+/**********************************************************/
+//rows start to end of the group pairs of one iteration, iteration 0 is the whole dataset and the rest are subsamples
+struct iterBlock {
+    int iter;
+    int start;
+    int end;
+    iterBlock(int i, int s, int e) : iter(i), start(s), end(e) {}
+    iterBlock(){ iter=0; start=0; end=0; }
+    ~iterBlock(){}
+};
 /***********************************************************************/
 struct PDistCell{
 	ull index;
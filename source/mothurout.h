@@ -217,6 +217,7 @@ class MothurOut {
         int mothurRandomShuffle(SharedOrderVector&);
         int mothurRandomShuffle(vector<SharedRAbundVector*>&);
         void setRandomSeed(unsigned s) { mersenne_twister_engine.seed(s); }
+        mt19937_64& getRandomEngine() { return mersenne_twister_engine; }
     
 		
 		//math operation
@@ -25,18 +25,10 @@
 /**************************************************************************************************/
 
 NeedlemanOverlap::NeedlemanOverlap(float gO, float f, float mm, int r) ://	note that we don't have a gap extend
-gap(gO), match(f), mismatch(mm), Alignment(r) {							//	the gap openning penalty is assessed for
+gap(gO), match(f), mismatch(mm), Alignment() {							//	the gap openning penalty is assessed for
 	try {																	//	every gapped position
-		for(int i=1;i<nCols;i++){
-			alignment[0][i].prevCell = 'l';					//	initialize first row by pointing all poiters to the left
-			alignment[0][i].cValue = 0;						//	and the score to zero
-		}
-		
-		for(int i=1;i<nRows;i++){
-			alignment[i][0].prevCell = 'u';					//	initialize first column by pointing all poiters upwards
-			alignment[i][0].cValue = 0;						//	and the score to zero
-		}
-	
+		nRows = r;	nCols = r;		//	the r x r matrix is allocated by the first alignment that needs it (initializeMatrix),
+									//	banded alignments do not use it
 	}
 	catch(exception& e) {
 		m->errorOut(e, "NeedlemanOverlap", "NeedlemanOverlap");
@@ -54,6 +46,11 @@ void NeedlemanOverlap::align(string A, string B){
 	
 		seqA = ' ' + A;	lA = seqA.length();		//	algorithm requires a dummy space at the beginning of each string
 		seqB = ' ' + B;	lB = seqB.length();		//	algorithm requires a dummy space at the beginning of each string
+		
+		if (banded) { alignBanded(); return; }
+		
+		usingBand = false;
+		if (alignment.size() == 0) { initializeMatrix(); }
 
 		if (lA > nRows) { m->mothurOut("One of your candidate sequences is longer than you longest template sequence. Your longest template sequence is " + toString(nRows) + ". Your candidate is " + toString(lA) + "."); m->mothurOutEndLine();  }
 		
@@ -104,6 +101,55 @@ void NeedlemanOverlap::align(string A, string B){
 
 }
 /**************************************************************************************************/
+//the same recursion as align for the cells with low <= row - column <= high, the cells outside the band score -infinity
+void NeedlemanOverlap::fillBand(int low, int high){
+	try {
+		startBand(low, high);
+		float negativeInfinity = -numeric_limits<float>::infinity();
+		
+		bandPrevC.assign(lA, 0);				//	the first row and column score zero
+		bandC.assign(lA, 0);
+		int prevEnd = lA-1;
+		
+		for(int i=1;i<lB;i++){
+			int jStart = max(1, i - bandHigh);
+			int jEnd = min(lA-1, i - bandLow);
+			if (jStart > jEnd) { prevEnd = 0; continue; }
+			
+			if (prevEnd < jEnd)	{ bandPrevC[jEnd] = negativeInfinity;	}	//	above the band
+			if (jStart > 1)		{ bandC[jStart-1] = negativeInfinity;	}	//	left of the band
+			
+			for(int j=jStart;j<=jEnd;j++){
+				float diagonal;
+				if(seqB[i] == seqA[j])	{	diagonal = bandPrevC[j-1] + match;		}
+				else					{	diagonal = bandPrevC[j-1] + mismatch;	}
+				
+				float up	= bandPrevC[j] + gap;
+				float left	= bandC[j-1] + gap;
+				
+				if(diagonal >= up){
+					if(diagonal >= left){	bandC[j] = diagonal;						}
+					else{					bandC[j] = left;	setBandMove(i, j, 2);	}
+				}
+				else{
+					if(up >= left){			bandC[j] = up;		setBandMove(i, j, 1);	}
+					else{					bandC[j] = left;	setBandMove(i, j, 2);	}
+				}
+			}
+			
+			if (jEnd == lA-1)	{ bandLastColumn[i] = bandC[lA-1];	}
+			if (i == lB-1)		{ for(int j=jStart;j<=jEnd;j++){ bandLastRow[j] = bandC[j]; } }
+			
+			bandC.swap(bandPrevC);
+			prevEnd = jEnd;
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "NeedlemanOverlap", "fillBand");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
 
 void NeedlemanOverlap::alignPrimer(string A, string B){
 	try {
@@ -111,6 +157,9 @@ void NeedlemanOverlap::alignPrimer(string A, string B){
 		seqA = ' ' + A;	lA = seqA.length();		//	algorithm requires a dummy space at the beginning of each string
 		seqB = ' ' + B;	lB = seqB.length();		//	algorithm requires a dummy space at the beginning of each string
         
+		usingBand = false;
+		if (alignment.size() == 0) { initializeMatrix(); }
+        
 		if (lA > nRows) { m->mothurOut("One of your candidate sequences is longer than you longest template sequence. Your longest template sequence is " + toString(nRows) + ". Your candidate is " + toString(lA) + "."); m->mothurOutEndLine();  }
 		
 		for(int i=1;i<lB;i++){					//	This code was largely translated from Perl code provided in Ex 3.1
@@ -39,6 +39,7 @@ private:
 	float match;
 	float mismatch;
     bool isEquivalent(char, char);
+	void fillBand(int, int);
 };
 
 /**************************************************************************************************/
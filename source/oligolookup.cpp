@@ -0,0 +1,324 @@
+//
+//  oligolookup.cpp
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#include "oligolookup.h"
+
+//read bases stored in the tables, a read with anything else at its start is left to the callers search
+static const char readAlphabet[] = "ACGTN";
+//oligo bases the tables understand, an oligo with anything else turns the tables off
+static const string oligoAlphabet = "ACGTRYMKWSBDHVN";
+//keeps a long degenerate primer from building a huge table
+static const long long maxTableEntries = 4000000;
+//a read one substitution from an oligo is at least 2 edits from any other oligo this far away, and the aligner breaking a score
+//tie the other way can only cost the closest oligo one more difference
+static const int minSeparation = 4;
+
+/**************************************************************************************************/
+OligoLookup::OligoLookup() {
+    m = MothurOut::getInstance();
+    maxDiffs = 0; maxLength = 0; exactIndexed = false; closeIndexed = false;
+}
+/**************************************************************************************************/
+OligoLookup::OligoLookup(vector<string> o, int d) {
+    try {
+        m = MothurOut::getInstance();
+        oligos = o;
+        //only single substitutions are indexed, with two a barcode one indel away can align better than the closest one in the table
+        maxDiffs = min(d, 1);
+        maxLength = 0;
+        exactIndexed = true;
+        closeIndexed = (maxDiffs > 0);
+
+        set<int> uniqueLengths;
+        for (int i = 0; i < oligos.size(); i++) {
+            uniqueLengths.insert(oligos[i].length());
+            if (oligos[i].length() > maxLength) { maxLength = oligos[i].length(); }
+            for (int j = 0; j < oligos[i].length(); j++) {
+                if (oligoAlphabet.find(oligos[i][j]) == string::npos) { exactIndexed = false; closeIndexed = false; }
+            }
+        }
+        lengths.assign(uniqueLengths.begin(), uniqueLengths.end());
+
+        long long budget = maxTableEntries;
+        for (int i = 0; (i < oligos.size()) && exactIndexed; i++) {
+            string current = oligos[i];
+            exactIndexed = expand(i, 0, 0, 0, current, exact, budget);
+        }
+        if (!exactIndexed) { exact.clear(); closeIndexed = false; }
+
+        if (closeIndexed) { closeIndexed = separated(); }
+
+        budget = maxTableEntries;
+        for (int i = 0; (i < oligos.size()) && closeIndexed; i++) {
+            string current = oligos[i];
+            closeIndexed = expand(i, 0, 0, maxDiffs, current, close, budget);
+        }
+        if (!closeIndexed) { close.clear(); }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OligoLookup", "OligoLookup");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//same rules as TrimOligos::compareDNASeq for one base
+bool OligoLookup::matches(char oligo, char base) {
+    if (oligo == base) { return true; }
+    if (oligo == 'A' || oligo == 'T' || oligo == 'G' || oligo == 'C')	{	return false;	}
+    else if ((oligo == 'N' || oligo == 'I') && (base == 'N'))	{	return false;	}
+    else if (oligo == 'R')	{	return (base == 'A' || base == 'G');	}
+    else if (oligo == 'Y')	{	return (base == 'C' || base == 'T');	}
+    else if (oligo == 'M')	{	return (base == 'C' || base == 'A');	}
+    else if (oligo == 'K')	{	return (base == 'T' || base == 'G');	}
+    else if (oligo == 'W')	{	return (base == 'T' || base == 'A');	}
+    else if (oligo == 'S')	{	return (base == 'C' || base == 'G');	}
+    else if (oligo == 'B')	{	return (base == 'C' || base == 'T' || base == 'G');	}
+    else if (oligo == 'D')	{	return (base == 'A' || base == 'T' || base == 'G');	}
+    else if (oligo == 'H')	{	return (base == 'A' || base == 'T' || base == 'C');	}
+    else if (oligo == 'V')	{	return (base == 'A' || base == 'C' || base == 'G');	}
+    return true;
+}
+/**************************************************************************************************/
+//true if a read base exists that both oligo bases match
+bool OligoLookup::compatible(char first, char second) {
+    for (int b = 0; b < 5; b++) {
+        if (matches(first, readAlphabet[b]) && matches(second, readAlphabet[b])) { return true; }
+    }
+    return false;
+}
+/**************************************************************************************************/
+//the fewest edits between one oligo and a prefix of the other, bases that can match the same read base count as equal
+int OligoLookup::prefixDistance(const string& first, const string& second) {
+    try {
+        int lF = first.length(); int lS = second.length();
+        vector< vector<int> > dist(lF+1, vector<int>(lS+1, 0));
+        for (int i = 0; i <= lF; i++) { dist[i][0] = i; }
+        for (int j = 0; j <= lS; j++) { dist[0][j] = j; }
+
+        for (int i = 1; i <= lF; i++) {
+            for (int j = 1; j <= lS; j++) {
+                int diagonal = dist[i-1][j-1] + (compatible(first[i-1], second[j-1]) ? 0 : 1);
+                dist[i][j] = min(diagonal, min(dist[i-1][j], dist[i][j-1]) + 1);
+            }
+        }
+
+        int best = lF + lS;
+        for (int j = 0; j <= lS; j++) { best = min(best, dist[lF][j]); } //all of first, a prefix of second
+        for (int i = 0; i <= lF; i++) { best = min(best, dist[i][lS]); } //a prefix of first, all of second
+
+        return best;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OligoLookup", "prefixDistance");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//true if every pair of oligos is minSeparation edits apart. An N or I in an oligo is not charged for a gap by
+//TrimOligos::countDiffs, so oligos with them are never separated.
+bool OligoLookup::separated() {
+    try {
+        for (int i = 0; i < oligos.size(); i++) {
+            if ((oligos[i].find('N') != string::npos) || (oligos[i].find('I') != string::npos)) { return false; }
+        }
+
+        for (int i = 0; i < oligos.size(); i++) {
+            if (m->control_pressed) { return false; }
+            for (int j = i+1; j < oligos.size(); j++) {
+                if (prefixDistance(oligos[i], oligos[j]) < minSeparation) { return false; }
+            }
+        }
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OligoLookup", "separated");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//adds every read string within limit substitutions of oligo o, keeping the fewest substitutions for each string
+bool OligoLookup::expand(int o, int pos, int diffs, int limit, string& current, unordered_map<string, vector< pair<int, int> > >& table, long long& budget) {
+    try {
+        if (pos == oligos[o].length()) {
+            vector< pair<int, int> >& entry = table[current];
+            if ((entry.size() != 0) && (entry.back().first == o)) { entry.back().second = min(entry.back().second, diffs); }
+            else { entry.push_back(make_pair(o, diffs)); budget--; }
+            return (budget >= 0);
+        }
+
+        for (int b = 0; b < 5; b++) {
+            current[pos] = readAlphabet[b];
+            if (matches(oligos[o][pos], readAlphabet[b])) {
+                if (!expand(o, pos+1, diffs, limit, current, table, budget)) { return false; }
+            }else if (diffs < limit) {
+                if (!expand(o, pos+1, diffs+1, limit, current, table, budget)) { return false; }
+            }
+        }
+        current[pos] = oligos[o][pos];
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OligoLookup", "expand");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+bool OligoLookup::readableStart(const string& read) {
+    int length = min((int)read.length(), maxLength);
+    for (int i = 0; i < length; i++) {
+        char base = read[i];
+        if ((base != 'A') && (base != 'C') && (base != 'G') && (base != 'T') && (base != 'N')) { return false; }
+    }
+    return true;
+}
+/**************************************************************************************************/
+bool OligoLookup::findExact(const string& read, vector<int>& matched) {
+    try {
+        matched.clear();
+        if (!exactIndexed || !readableStart(read)) { return false; }
+
+        for (int i = 0; i < lengths.size(); i++) {
+            if (lengths[i] > read.length()) { break; }
+
+            unordered_map<string, vector< pair<int, int> > >::iterator it = exact.find(read.substr(0, lengths[i]));
+            if (it != exact.end()) {
+                for (int j = 0; j < it->second.size(); j++) { matched.push_back(it->second[j].first); }
+            }
+        }
+        sort(matched.begin(), matched.end());
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OligoLookup", "findExact");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+int OligoLookup::findFirst(const string& read) {
+    try {
+        if (oligos.size() == 0) { return -1; }
+
+        vector<int> matched;
+        if (!findExact(read, matched)) { return 0; }
+
+        int first = -1;
+        if (matched.size() != 0) { first = matched[0]; }
+
+        //the search stops at the first oligo longer than the read
+        if (read.length() < maxLength) {
+            int end = oligos.size();
+            if (first != -1) { end = first; }
+            for (int i = 0; i < end; i++) {
+                if (read.length() < oligos[i].length()) { return i; }
+            }
+        }
+
+        return first;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OligoLookup", "findFirst");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+bool OligoLookup::findClose(const string& read, vector<int>& closest) {
+    try {
+        closest.clear();
+        if (!closeIndexed) { return false; }
+
+        int closestDiff = maxDiffs + 1;
+        for (int i = 0; i < lengths.size(); i++) {
+            if (lengths[i] > read.length()) { break; }
+
+            unordered_map<string, vector< pair<int, int> > >::iterator it = close.find(read.substr(0, lengths[i]));
+            if (it == close.end()) { continue; }
+
+            for (int j = 0; j < it->second.size(); j++) {
+                if (it->second[j].second < closestDiff) { closestDiff = it->second[j].second; closest.clear(); closest.push_back(it->second[j].first); }
+                else if (it->second[j].second == closestDiff) { closest.push_back(it->second[j].first); }
+            }
+        }
+
+        if (closest.size() == 0) { return false; }
+        sort(closest.begin(), closest.end());
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OligoLookup", "findClose");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+OligoPairLookup::OligoPairLookup(map<int, oligosPair>& pairs, int diffs) {
+    try {
+        set<string> uniqueForward, uniqueReverse;
+        bool forwardNone = false; bool reverseNone = false;
+        indexed = true;
+
+        for (map<int, oligosPair>::iterator it = pairs.begin(); it != pairs.end(); it++) {
+            if (it->second.forward == "NONE") { forwardNone = true; } else { uniqueForward.insert(it->second.forward); }
+            if (it->second.reverse == "NONE") { reverseNone = true; } else { uniqueReverse.insert(it->second.reverse); }
+            if ((it->second.forward == "NONE") && (it->second.reverse == "NONE")) { indexed = false; }
+        }
+
+        //"NONE" always matches in the aligned search, so that side keeps using it
+        vector<string> forwardOligos(uniqueForward.begin(), uniqueForward.end());
+        vector<string> reverseOligos(uniqueReverse.begin(), uniqueReverse.end());
+        forward = OligoLookup(forwardOligos, (forwardNone ? 0 : diffs));
+        reverse = OligoLookup(reverseOligos, (reverseNone ? 0 : diffs));
+
+        for (map<int, oligosPair>::iterator it = pairs.begin(); it != pairs.end(); it++) {
+            keys.push_back(it->first);
+            forwardLengths.push_back(it->second.forward.length());
+            reverseLengths.push_back(it->second.reverse.length());
+
+            if (it->second.forward == "NONE") { pairForward.push_back(-1); }
+            else { pairForward.push_back(lower_bound(forwardOligos.begin(), forwardOligos.end(), it->second.forward) - forwardOligos.begin()); }
+            if (it->second.reverse == "NONE") { pairReverse.push_back(-1); }
+            else { pairReverse.push_back(lower_bound(reverseOligos.begin(), reverseOligos.end(), it->second.reverse) - reverseOligos.begin()); }
+        }
+    }
+    catch(exception& e) {
+        MothurOut::getInstance()->errorOut(e, "OligoPairLookup", "OligoPairLookup");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+int OligoPairLookup::findFirst(const string& forwardRead, const string& reverseRead) {
+    try {
+        if (keys.size() == 0) { return -1; }
+        if (!indexed) { return keys[0]; }
+
+        vector<int> forwardMatches, reverseMatches;
+        if (!forward.findExact(forwardRead, forwardMatches)) { return keys[0]; }
+        if (!reverse.findExact(reverseRead, reverseMatches)) { return keys[0]; }
+
+        vector<bool> forwardFound(forward.getNumOligos(), false);
+        vector<bool> reverseFound(reverse.getNumOligos(), false);
+        for (int i = 0; i < forwardMatches.size(); i++) { forwardFound[forwardMatches[i]] = true; }
+        for (int i = 0; i < reverseMatches.size(); i++) { reverseFound[reverseMatches[i]] = true; }
+
+        for (int i = 0; i < keys.size(); i++) {
+            if ((forwardRead.length() < forwardLengths[i]) || (reverseRead.length() < reverseLengths[i])) { return keys[i]; }
+
+            if (pairForward[i] == -1) { if (reverseFound[pairReverse[i]]) { return keys[i]; } }
+            else if (pairReverse[i] == -1) { if (forwardFound[pairForward[i]]) { return keys[i]; } }
+            else if (forwardFound[pairForward[i]] && reverseFound[pairReverse[i]]) { return keys[i]; }
+        }
+
+        return -1;
+    }
+    catch(exception& e) {
+        MothurOut::getInstance()->errorOut(e, "OligoPairLookup", "findFirst");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
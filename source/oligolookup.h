@@ -0,0 +1,87 @@
+//
+//  oligolookup.h
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__oligolookup__
+#define __Mothur__oligolookup__
+
+#include "mothur.h"
+#include "mothurout.h"
+#include <unordered_map>
+
+/* This class finds the barcodes or primers at the start of a read with hash lookups instead of comparing the read to every oligo.
+ Each oligo is expanded into every read string of A, C, G, T and N it matches, using the same ambiguity rules as TrimOligos::compareDNASeq.
+ If diffs is 1 or more the strings one substitution away are stored too, so for a read with a sequencing error in its barcode
+ TrimOligos only aligns the closest barcodes instead of every barcode.  Indels and second substitutions are not in the table,
+ TrimOligos still aligns the read to every barcode when the lookup finds nothing.
+
+ A barcode one substitution from the read is only sure to be the best one if no other barcode can align with as few differences,
+ for example with an indel.  The substitution table is only used if every pair of oligos is at least minSeparation edits apart,
+ comparing each oligo to the prefixes of the other, otherwise findClose always returns false and TrimOligos aligns every oligo.
+
+ Oligos are numbered in the order they are passed in, which is the order TrimOligos searches them.
+ */
+
+/**************************************************************************************************/
+
+class OligoLookup {
+
+public:
+    OligoLookup();
+    OligoLookup(vector<string>, int); //oligos in search order, substitutions to index
+    ~OligoLookup() {}
+
+    int getNumOligos() { return oligos.size(); }
+    string getOligo(int i) { return oligos[i]; }
+
+    //index of the first oligo that is longer than the read or matches the start of it, 0 if the table can't tell, -1 if none
+    int findFirst(const string&);
+    //fills with the oligos matching the start of the read in increasing order, false if the table can't tell
+    bool findExact(const string&, vector<int>&);
+    //true if oligos are within one substitution of the start of the read, fills with the closest ones in increasing order
+    bool findClose(const string&, vector<int>&);
+
+    static bool matches(char, char); //oligo base, read base
+
+private:
+    MothurOut* m;
+    vector<string> oligos;
+    vector<int> lengths; //distinct oligo lengths
+    int maxDiffs, maxLength;
+    bool exactIndexed, closeIndexed;
+    unordered_map<string, vector< pair<int, int> > > exact; //read string -> oligos
+    unordered_map<string, vector< pair<int, int> > > close; //read string -> oligo, substitutions
+
+    bool expand(int, int, int, int, string&, unordered_map<string, vector< pair<int, int> > >&, long long&);
+    bool readableStart(const string&);
+    bool separated();
+    int prefixDistance(const string&, const string&);
+    static bool compatible(char, char);
+};
+
+/**************************************************************************************************/
+//the forward and reverse oligos of a paired oligos file, for the functions that strip a forward and a reverse read
+class OligoPairLookup {
+
+public:
+    OligoPairLookup() : indexed(false) {}
+    OligoPairLookup(map<int, oligosPair>&, int); //pairs, substitutions to index
+    ~OligoPairLookup() {}
+
+    //key of the first pair that is longer than the reads or matches both of them, first key if the table can't tell, -1 if none
+    int findFirst(const string&, const string&);
+
+    OligoLookup forward, reverse; //unique forward and reverse oligos, "NONE" left out
+
+private:
+    vector<int> keys, pairForward, pairReverse; //index into forward and reverse, -1 for "NONE"
+    vector<int> forwardLengths, reverseLengths;
+    bool indexed;
+};
+
+/**************************************************************************************************/
+
+#endif
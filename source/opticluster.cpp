@@ -22,7 +22,7 @@ int OptiCluster::initialize(double& value, bool randomize, string initialize) {
         
         vector<int> temp;
         bins.push_back(temp);
-        seqBin[numSeqs] = -1;
+        seqBin.assign(numSeqs, 0);
         insertLocation = numSeqs;
         
         if (initialize == "singleton") {
@@ -39,12 +39,9 @@ int OptiCluster::initialize(double& value, bool randomize, string initialize) {
             if (randomize) { m->mothurRandomShuffle(randomizeSeqs); }
             
             //for each sequence (singletons removed on read)
-            for (map<int, int>::iterator it = seqBin.begin(); it != seqBin.end(); it++) {
-                if (it->second == -1) { }
-                else {
-                    long long numCloseSeqs = (matrix->getCloseSeqs(it->first)).size(); //does not include self
-                    falseNegatives += numCloseSeqs;
-                }
+            for (int i = 0; i < numSeqs; i++) {
+                long long numCloseSeqs = matrix->getNumClose(i); //does not include self
+                falseNegatives += numCloseSeqs;
             }
             falseNegatives /= 2; //square matrix
             trueNegatives = numSeqs * (numSeqs-1)/2 - (falsePositives + falseNegatives + truePositives); //since everyone is a singleton no one clusters together. True negative = num far apart
@@ -61,12 +58,9 @@ int OptiCluster::initialize(double& value, bool randomize, string initialize) {
             if (randomize) { m->mothurRandomShuffle(randomizeSeqs); }
             
             //for each sequence (singletons removed on read)
-            for (map<int, int>::iterator it = seqBin.begin(); it != seqBin.end(); it++) {
-                if (it->second == -1) { }
-                else {
-                    long long numCloseSeqs = (matrix->getCloseSeqs(it->first)).size(); //does not include self
-                    truePositives += numCloseSeqs;
-                }
+            for (int i = 0; i < numSeqs; i++) {
+                long long numCloseSeqs = matrix->getNumClose(i); //does not include self
+                truePositives += numCloseSeqs;
             }
             truePositives /= 2; //square matrix
             falsePositives = numSeqs * (numSeqs-1)/2 - (trueNegatives + falseNegatives + truePositives);
@@ -98,83 +92,23 @@ int OptiCluster::initialize(double& value, bool randomize, string initialize) {
 /***********************************************************************/
 /* for each sequence with mutual information (close)
 * remove from current OTU and calculate MCC when sequence forms its own OTU or joins one of the other OTUs where there is a sequence within the `threshold` (no need to calculate MCC if the paired sequence is already in same OTU and no need to try every OTU - just those where there's a close sequence) 
- * keep or move the sequence to the OTU where the `metric` is the largest - flip a coin on ties */
+ * keep or move the sequence to the OTU where the `metric` is the largest - flip a coin on ties 
+ * with more than one processor the sequences are processed in batches, see updateParallel */
 bool OptiCluster::update(double& listMetric) {
     try {
         
-        //for each sequence (singletons removed on read)
-        for (int i = 0; i < randomizeSeqs.size(); i++) {
-            
-            if (m->control_pressed) { break; }
-            
-            map<int, int>::iterator it = seqBin.find(randomizeSeqs[i]);
+        if (processors > 1) { updateParallel(); }
+        else {
+            vector<int> closeBins;
             
-            int seqNumber = it->first;
-            int binNumber = it->second;
-            
-            
-            if (binNumber == -1) { }
-            else {
-                
-                long long tn, tp, fp, fn;
-                double bestMetric = -1;
-                long long bestBin, bestTp, bestTn, bestFn, bestFp;
-                tn = trueNegatives; tp = truePositives; fp = falsePositives; fn = falseNegatives;
-                
-                //this calculation is used to save time in the move and adjust function.
-                //we don't need to calculate the cost of moving out of our current bin each time we
-                //test moving into a new bin. Only calc this once per iteration.
-                long long cCount = 0;  long long fCount = 0;
-                for (int i = 0; i < bins[binNumber].size(); i++) { //how many close sequences are in the old bin?
-                    if (seqNumber == bins[binNumber][i]) {}
-                    else if (!matrix->isClose(seqNumber, bins[binNumber][i])) {  fCount++;   }
-                    else { cCount++;  }
-                }
-                
-                //metric in current bin
-                bestMetric = calcScoreCurrentBin(tp, tn, fp, fn); bestBin = binNumber; bestTp = tp; bestTn = tn; bestFp = fp; bestFn = fn;
-                
-                //if not already singleton, then calc value if singleton was created
-                if (!((bins[binNumber].size()) == 1)) {
-                    //make a singleton
-                    //move out of old bin
-                    fn+=cCount; tn+=fCount; fp-=fCount; tp-=cCount;
-                    double singleMetric = moveAdjustTFValues(binNumber, seqNumber, -1, tp, tn, fp, fn);
-                    if (singleMetric > bestMetric) {
-                        bestBin = -1; bestTp = tp; bestTn = tn; bestFp = fp; bestFn = fn;
-                        bestMetric = singleMetric;
-                    }
-                }
-                
-                set<int> binsToTry;
-                set<int> closeSeqs = matrix->getCloseSeqs(seqNumber);
-                for (set<int>::iterator itClose = closeSeqs.begin(); itClose != closeSeqs.end(); itClose++) {  binsToTry.insert(seqBin[*itClose]); }
-                
-                //merge into each "close" otu
-                for (set<int>::iterator it = binsToTry.begin(); it != binsToTry.end(); it++) {
-                    tn = trueNegatives; tp = truePositives; fp = falsePositives; fn = falseNegatives;
-                    fn+=cCount; tn+=fCount; fp-=fCount; tp-=cCount;
-                    double newMetric = moveAdjustTFValues(binNumber, seqNumber, *it, tp, tn, fp, fn);
-                    
-                    //new best
-                    if (newMetric > bestMetric) { bestMetric = newMetric; bestBin = (*it); bestTp = tp; bestTn = tn; bestFp = fp; bestFn = fn; }
-                }
-                
-                bool usedInsert = false;
-                if (bestBin == -1) {  bestBin = insertLocation;  usedInsert = true;  }
-                
-                if (bestBin != binNumber) {
-                    truePositives = bestTp; trueNegatives = bestTn; falsePositives = bestFp; falseNegatives = bestFn;
-            
-                    //move seq from i to j
-                    bins[bestBin].push_back(seqNumber); //add seq to bestbin
-                    bins[binNumber].erase(remove(bins[binNumber].begin(), bins[binNumber].end(), seqNumber), bins[binNumber].end()); //remove from old bin i
-                }
+            //for each sequence (singletons removed on read)
+            for (int i = 0; i < randomizeSeqs.size(); i++) {
                 
-                if (usedInsert) { insertLocation = findInsert(); }
+                if (m->control_pressed) { break; }
                 
-                //update seqBins
-                seqBin[seqNumber] = bestBin; //set new OTU location
+                optiMove move; move.seq = randomizeSeqs[i];
+                evaluateMove(move, closeBins);
+                commitMove(move);
             }
         }
         
@@ -202,6 +136,214 @@ bool OptiCluster::update(double& listMetric) {
     }
 }
 /***********************************************************************/
+/* the moves for a batch of sequences are found by the threads against the OTUs as they were at the start of the batch, then made
+ * in the randomized order. If an earlier move in the batch changed the sequences OTU or the OTU of one of its close sequences,
+ * the move is found again before it is made, so every move is correct for the OTUs it is made on. The batch size does not depend
+ * on the number of processors, so the OTUs are the same for any processors > 1 given the same seed. The threads are started once
+ * for the iteration and wait for each batch. */
+void OptiCluster::updateParallel() {
+    try {
+        vector<char> touched(bins.size(), 0); //bins whose sequences changed in this batch
+        vector<int> touchedBins;
+        vector<int> closeBins;
+        
+        optiMoveBatch batch;
+        vector<thread*> workerThreads;
+        for (int i = 1; i < processors; i++) {
+            workerThreads.push_back(new thread(&OptiCluster::moveWorker, this, &batch, i));
+        }
+        
+        for (int start = 0; start < randomizeSeqs.size(); start += moveBatchSize) {
+            
+            if (m->control_pressed) { break; }
+            
+            int end = min((int)randomizeSeqs.size(), start + moveBatchSize);
+            {
+                lock_guard<mutex> lock(batch.lock);
+                batch.moves.assign(end - start, optiMove());
+                for (int i = start; i < end; i++) { batch.moves[i-start].seq = randomizeSeqs[i]; }
+                batch.numFinished = 0;
+                batch.batchNum++;
+            }
+            batch.batchReady.notify_all();
+            
+            evaluateMoves(batch.moves, 0, processors);
+            
+            {
+                unique_lock<mutex> lock(batch.lock);
+                while (batch.numFinished < workerThreads.size()) { batch.batchFinished.wait(lock); }
+            }
+            
+            vector<optiMove>& moves = batch.moves;
+            for (int i = 0; i < moves.size(); i++) {
+                if (isStale(moves[i], touched)) { evaluateMove(moves[i], closeBins); }
+                
+                if (moves[i].toBin != moves[i].fromBin) {
+                    commitMove(moves[i]);
+                    touched[moves[i].fromBin] = 1; touched[moves[i].toBin] = 1;
+                    touchedBins.push_back(moves[i].fromBin); touchedBins.push_back(moves[i].toBin);
+                }
+            }
+            
+            for (int i = 0; i < touchedBins.size(); i++) { touched[touchedBins[i]] = 0; }
+            touchedBins.clear();
+        }
+        
+        {
+            lock_guard<mutex> lock(batch.lock);
+            batch.done = true;
+        }
+        batch.batchReady.notify_all();
+        for (int i = 0; i < workerThreads.size(); i++) { workerThreads[i]->join(); delete workerThreads[i]; }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiCluster", "updateParallel");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//finds the moves of each batch for every processors'th sequence, starting at first, until updateParallel is done
+void OptiCluster::moveWorker(optiMoveBatch* batch, int first) {
+    try {
+        int lastBatch = 0;
+        while (true) {
+            {
+                unique_lock<mutex> lock(batch->lock);
+                while (!batch->done && (batch->batchNum == lastBatch)) { batch->batchReady.wait(lock); }
+                if (batch->done) { break; }
+                lastBatch = batch->batchNum;
+            }
+            
+            evaluateMoves(batch->moves, first, processors);
+            
+            {
+                lock_guard<mutex> lock(batch->lock);
+                batch->numFinished++;
+            }
+            batch->batchFinished.notify_one();
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiCluster", "moveWorker");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//finds the moves for every step'th sequence in the batch, starting at first
+void OptiCluster::evaluateMoves(vector<optiMove>& moves, int first, int step) {
+    try {
+        vector<int> closeBins;
+        for (int i = first; i < moves.size(); i += step) {
+            if (m->control_pressed) { break; }
+            evaluateMove(moves[i], closeBins);
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiCluster", "evaluateMoves");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//true if the sequences OTU or the OTU of one of its close sequences changed after the move was found
+bool OptiCluster::isStale(const optiMove& move, const vector<char>& touched) {
+    try {
+        if (touched[seqBin[move.seq]]) { return true; }
+        
+        for (vector<int>::const_iterator itClose = matrix->getCloseBegin(move.seq); itClose != matrix->getCloseEnd(move.seq); itClose++) {
+            if (touched[seqBin[*itClose]]) { return true; }
+        }
+        
+        return false;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiCluster", "isStale");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//finds the best OTU for move.seq without changing the OTUs, closeBins is scratch space
+void OptiCluster::evaluateMove(optiMove& move, vector<int>& closeBins) {
+    try {
+        int seqNumber = move.seq;
+        int binNumber = seqBin[seqNumber];
+        
+        move.fromBin = binNumber; move.toBin = binNumber;
+        move.tp = 0; move.tn = 0; move.fp = 0; move.fn = 0;
+        
+        long long tn, tp, fp, fn;
+        tn = trueNegatives; tp = truePositives; fp = falsePositives; fn = falseNegatives;
+        
+        //the OTUs of the close sequences, sorted so each OTU is a run whose length is the number of close sequences in it
+        closeBins.clear();
+        for (vector<int>::const_iterator itClose = matrix->getCloseBegin(seqNumber); itClose != matrix->getCloseEnd(seqNumber); itClose++) {
+            if (*itClose != seqNumber) { closeBins.push_back(seqBin[*itClose]); }
+        }
+        sort(closeBins.begin(), closeBins.end());
+        
+        //how many close and far sequences are in the old bin?
+        long long cCount = upper_bound(closeBins.begin(), closeBins.end(), binNumber) - lower_bound(closeBins.begin(), closeBins.end(), binNumber);
+        long long fCount = bins[binNumber].size() - 1 - cCount;
+        
+        //metric in current bin
+        double bestMetric = calcScoreCurrentBin(tp, tn, fp, fn);
+        
+        //if not already singleton, then calc value if singleton was created
+        if (!((bins[binNumber].size()) == 1)) {
+            double singleMetric = calcScoreCurrentBin(tp-cCount, tn+fCount, fp-fCount, fn+cCount);
+            if (singleMetric > bestMetric) {
+                move.toBin = -1; move.tp = -cCount; move.tn = fCount; move.fp = -fCount; move.fn = cCount;
+                bestMetric = singleMetric;
+            }
+        }
+        
+        //merge into each "close" otu
+        for (int i = 0; i < closeBins.size();) {
+            int newBin = closeBins[i];
+            long long ncCount = 0;
+            while ((i < closeBins.size()) && (closeBins[i] == newBin)) { ncCount++; i++; }
+            
+            if (newBin == binNumber) { continue; } //staying put is the current metric
+            
+            long long nfCount = bins[newBin].size() - ncCount;
+            
+            //move out of old bin and into new bin
+            long long dtp = ncCount - cCount; long long dtn = fCount - nfCount; long long dfp = nfCount - fCount; long long dfn = cCount - ncCount;
+            double newMetric = calcScoreCurrentBin(tp+dtp, tn+dtn, fp+dfp, fn+dfn);
+            
+            //new best
+            if (newMetric > bestMetric) { bestMetric = newMetric; move.toBin = newBin; move.tp = dtp; move.tn = dtn; move.fp = dfp; move.fn = dfn; }
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiCluster", "evaluateMove");
+        exit(1);
+    }
+}
+/***********************************************************************/
+void OptiCluster::commitMove(optiMove& move) {
+    try {
+        if (move.toBin == move.fromBin) { return; }
+        
+        bool usedInsert = false;
+        if (move.toBin == -1) {  move.toBin = insertLocation;  usedInsert = true;  }
+        
+        truePositives += move.tp; trueNegatives += move.tn; falsePositives += move.fp; falseNegatives += move.fn;
+        
+        //move seq from i to j
+        bins[move.toBin].push_back(move.seq); //add seq to bestbin
+        bins[move.fromBin].erase(remove(bins[move.fromBin].begin(), bins[move.fromBin].end(), move.seq), bins[move.fromBin].end()); //remove from old bin i
+        
+        if (usedInsert) { insertLocation = findInsert(); }
+        
+        //update seqBins
+        seqBin[move.seq] = move.toBin; //set new OTU location
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiCluster", "commitMove");
+        exit(1);
+    }
+}
+/***********************************************************************/
 double OptiCluster::moveAdjustTFValues(int bin, int seq, int newBin,  long long& tp,  long long& tn,  long long& fp,  long long& fn) {
     try {
         
@@ -12,6 +12,25 @@
 #include "cluster.hpp"
 #include "optimatrix.h"
 
+/***********************************************************************/
+//a candidate move for one sequence, the tp, tn, fp and fn values are the changes to the totals if the move is made
+struct optiMove {
+    int seq, fromBin, toBin; //toBin is -1 for a new singleton OTU
+    long long tp, tn, fp, fn;
+    
+    optiMove() : seq(0), fromBin(0), toBin(0), tp(0), tn(0), fp(0), fn(0) {}
+};
+/***********************************************************************/
+//the batch of moves the threads of updateParallel are working on, batchNum counts the batches handed out
+struct optiMoveBatch {
+    vector<optiMove> moves;
+    int batchNum, numFinished;
+    bool done;
+    mutex lock;
+    condition_variable batchReady, batchFinished;
+    
+    optiMoveBatch() : batchNum(0), numFinished(0), done(false) {}
+};
 /***********************************************************************/
 
 class OptiCluster : public Cluster {
@@ -20,12 +39,12 @@ public:
     
 #ifdef UNIT_TEST
     friend class TestOptiCluster;
-    OptiCluster() : Cluster() { m = MothurOut::getInstance(); truePositives = 0; trueNegatives = 0; falseNegatives = 0; falsePositives = 0; } //for testing class
+    OptiCluster() : Cluster() { m = MothurOut::getInstance(); processors = 1; truePositives = 0; trueNegatives = 0; falseNegatives = 0; falsePositives = 0; } //for testing class
     void setVariables(OptiMatrix* mt, string met) { matrix = mt; metric = met; }
 #endif
     
-    OptiCluster(OptiMatrix* mt, string met, long long ns) : Cluster() {
-        m = MothurOut::getInstance(); matrix = mt; metric = met; truePositives = 0; trueNegatives = 0; falseNegatives = 0; falsePositives = 0; numSingletons = ns;
+    OptiCluster(OptiMatrix* mt, string met, long long ns, int proc) : Cluster() {
+        m = MothurOut::getInstance(); matrix = mt; metric = met; truePositives = 0; trueNegatives = 0; falseNegatives = 0; falsePositives = 0; numSingletons = ns; processors = proc;
     }
     ~OptiCluster() {}
     bool updateDistance(PDistCell& colCell, PDistCell& rowCell) { return false; } //inheritance compliant
@@ -38,13 +57,23 @@ public:
     
 private:
     MothurOut* m;
-    map<int, int> seqBin; //sequence# -> bin#
+    vector<int> seqBin; //sequence# -> bin#
     OptiMatrix* matrix;
     vector<int> randomizeSeqs;
     vector< vector<int> > bins; //bin[0] -> seqs in bin[0]
     string metric;
     long long truePositives, trueNegatives, falsePositives, falseNegatives, numSeqs, insertLocation, totalPairs, numSingletons;
+    int processors;
     
+    static const int moveBatchSize = 1024; //fixed so the parallel results do not depend on the number of processors
+    
+    void updateParallel();
+    void moveWorker(optiMoveBatch*, int);
+    void evaluateMoves(vector<optiMove>&, int, int);
+    void evaluateMove(optiMove&, vector<int>&);
+    void commitMove(optiMove&);
+    bool isStale(const optiMove&, const vector<char>&);
+
     int findInsert();
     double calcMCC(long long, long long, long long, long long);
     double calcSens( long long,  long long,  long long,  long long);
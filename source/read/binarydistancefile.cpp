@@ -0,0 +1,210 @@
+//
+//  binarydistancefile.cpp
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#include "binarydistancefile.h"
+
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+    #include <sys/mman.h>
+    #include <fcntl.h>
+#endif
+
+static const char binaryDistMagic[] = "MOTHDIST";
+static const int binaryDistHeaderSize = 32;
+static const unsigned int binaryDistVersion = 1;
+
+const int BinaryDistanceFile::recordSize;
+
+/**************************************************************************************************/
+BinaryDistanceFile::BinaryDistanceFile(string f) : filename(f) {
+    try {
+        m = MothurOut::getInstance();
+        data = NULL; dists = NULL; numDists = 0; fileSize = 0; precision = 1;
+        mapFile();
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BinaryDistanceFile", "BinaryDistanceFile");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void BinaryDistanceFile::mapFile() {
+    try {
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd == -1) { m->mothurOut("[ERROR]: Could not open " + filename + ".\n"); m->control_pressed = true; return; }
+
+        struct stat fileInfo;
+        fstat(fd, &fileInfo);
+        fileSize = fileInfo.st_size;
+
+        if (fileSize >= binaryDistHeaderSize) {
+            void* mapped = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) { m->mothurOut("[ERROR]: Could not map " + filename + ".\n"); m->control_pressed = true; close(fd); return; }
+            madvise(mapped, fileSize, MADV_SEQUENTIAL);
+            data = (const char*)mapped;
+        }
+        close(fd);
+#else
+        ifstream in(filename.c_str(), ios::binary);
+        if (!in) { m->mothurOut("[ERROR]: Could not open " + filename + ".\n"); m->control_pressed = true; return; }
+
+        in.seekg(0, ios::end); fileSize = in.tellg(); in.seekg(0, ios::beg);
+        fileData.resize(fileSize);
+        if (fileSize != 0) { in.read(&fileData[0], fileSize); data = &fileData[0]; }
+        in.close();
+#endif
+
+        if ((fileSize < binaryDistHeaderSize) || (memcmp(data, binaryDistMagic, 8) != 0)) {
+            m->mothurOut("[ERROR]: " + filename + " is not a binary distance file.\n"); m->control_pressed = true; return;
+        }
+
+        unsigned int version, numSeqs;
+        unsigned long long namesSize;
+        memcpy(&version, data + 8, 4);
+        memcpy(&precision, data + 12, 4);
+        memcpy(&numSeqs, data + 16, 4);
+        memcpy(&namesSize, data + 24, 8);
+
+        if ((version != binaryDistVersion) || (precision == 0) || ((binaryDistHeaderSize + namesSize) > fileSize)) {
+            m->mothurOut("[ERROR]: " + filename + " is not a valid binary distance file.\n"); m->control_pressed = true; return;
+        }
+
+        names.reserve(numSeqs);
+        const char* start = data + binaryDistHeaderSize;
+        const char* end = start + namesSize;
+        while ((start < end) && (names.size() < numSeqs)) {
+            const char* nameEnd = (const char*)memchr(start, '\n', end - start);
+            if (nameEnd == NULL) { break; }
+            names.push_back(string(start, nameEnd));
+            start = nameEnd + 1;
+        }
+
+        if (names.size() != numSeqs) { m->mothurOut("[ERROR]: " + filename + " has a damaged name table.\n"); m->control_pressed = true; return; }
+
+        unsigned long long distsSize = fileSize - binaryDistHeaderSize - namesSize;
+        if ((distsSize % recordSize) != 0) { m->mothurOut("[ERROR]: " + filename + " is truncated, its last distance is incomplete.\n"); m->control_pressed = true; names.clear(); return; }
+
+        dists = data + binaryDistHeaderSize + namesSize;
+        numDists = distsSize / recordSize;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BinaryDistanceFile", "mapFile");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+BinaryDistanceFile::~BinaryDistanceFile() {
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+    if (data != NULL) { munmap((void*)data, fileSize); }
+#endif
+}
+/**************************************************************************************************/
+int BinaryDistanceFile::exportColumn(string outputFile) {
+    try {
+        ofstream out;
+        m->openOutputFile(outputFile, out);
+        out.setf(ios::fixed, ios::showpoint);
+        out << setprecision(4);
+
+        for (unsigned long long k = 0; k < numDists; k++) {
+            if (m->control_pressed) { break; }
+            out << names[getRow(k)] << ' ' << names[getColumn(k)] << ' ' << getDist(k) << '\n';
+        }
+        out.close();
+
+        return 0;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BinaryDistanceFile", "exportColumn");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+bool BinaryDistanceFile::isBinary(string f) {
+    ifstream in(f.c_str(), ios::binary);
+    if (!in) { return false; }
+
+    char magic[8];
+    in.read(magic, 8);
+    bool binary = (in.gcount() == 8) && (memcmp(magic, binaryDistMagic, 8) == 0);
+    in.close();
+
+    return binary;
+}
+/**************************************************************************************************/
+void BinaryDistanceFile::writeHeader(string f, const vector<string>& seqNames, unsigned int p) {
+    MothurOut* m = MothurOut::getInstance();
+    try {
+        string nameTable = "";
+        for (int i = 0; i < seqNames.size(); i++) { nameTable += seqNames[i] + '\n'; }
+
+        char header[binaryDistHeaderSize];
+        memset(header, 0, binaryDistHeaderSize);
+        unsigned int numSeqs = seqNames.size();
+        unsigned long long namesSize = nameTable.length();
+        memcpy(header, binaryDistMagic, 8);
+        memcpy(header + 8, &binaryDistVersion, 4);
+        memcpy(header + 12, &p, 4);
+        memcpy(header + 16, &numSeqs, 4);
+        memcpy(header + 24, &namesSize, 8);
+
+        ofstream out(f.c_str(), ios::binary | ios::trunc);
+        if (!out) { m->mothurOut("[ERROR]: Could not open " + f + ".\n"); m->control_pressed = true; return; }
+        out.write(header, binaryDistHeaderSize);
+        out.write(nameTable.c_str(), namesSize);
+        out.close();
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BinaryDistanceFile", "writeHeader");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+unsigned int BinaryDistanceFile::precisionForCutoff(double cutoff) {
+    if (cutoff > 1.0) { cutoff = 1.0; } //distances from dist.seqs are never above 1
+    
+    unsigned int p = 1000000;
+    while ((p > 1) && ((cutoff * p) > 65535)) { p /= 10; }
+    
+    return p;
+}
+/**************************************************************************************************/
+void BinaryDistanceFile::appendRecord(string& buffer, unsigned int row, unsigned int col, double dist, unsigned int p) {
+    //round the way the column files print the distances
+    char rounded[32];
+    snprintf(rounded, 32, "%.4g", dist);
+    
+    double scaled = floor(atof(rounded) * p + 0.5);
+    if (scaled < 0)             { scaled = 0;       }
+    else if (scaled > 65535)    { scaled = 65535;   }
+    unsigned short value = (unsigned short)scaled;
+
+    char record[recordSize];
+    memcpy(record, &row, 4);
+    memcpy(record + 4, &col, 4);
+    memcpy(record + 8, &value, 2);
+    buffer.append(record, recordSize);
+}
+/**************************************************************************************************/
+void BinaryDistanceFile::appendRecords(string f, string& buffer) {
+    MothurOut* m = MothurOut::getInstance();
+    try {
+        if (buffer.length() == 0) { return; }
+
+        ofstream out(f.c_str(), ios::binary | ios::app);
+        if (!out) { m->mothurOut("[ERROR]: Could not open " + f + ".\n"); m->control_pressed = true; return; }
+        out.write(buffer.c_str(), buffer.length());
+        out.close();
+
+        buffer.clear();
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BinaryDistanceFile", "appendRecords");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
@@ -0,0 +1,75 @@
+//
+//  binarydistancefile.h
+//  Mothur
+//
+//  Copyright (c) 2017 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__binarydistancefile__
+#define __Mothur__binarydistancefile__
+
+#include "mothur.h"
+#include "mothurout.h"
+
+/* A sparse distance matrix stored in binary form, written by dist.seqs with output=binary and read by cluster and cluster.split
+ in place of a column file.
+
+ The file is a 32 byte header, the name table and then the distances:
+    header: "MOTHDIST", version (uint32), precision (uint32), number of sequences (uint32), unused (uint32), size of the name table in bytes (uint64)
+    name table: the sequence names, each followed by '\n'. A sequence's index in the table is its id.
+    distances: one 10 byte record per distance, row id (uint32), column id (uint32) and the distance times precision rounded to a uint16.
+
+ Distances are rounded to 4 significant digits, like the column files, before they are quantised. dist.seqs picks the largest
+ precision that still fits its cutoff in a uint16. With cutoffs up to 0.065 the binary distances are identical to the column
+ file values down to 0.001, with cutoffs up to 0.65 down to 0.01, and with the default cutoff of 1.0 they are kept to 4 decimal places.
+
+ The number of distances is not stored, it is the size of the distance section divided by the record size. This lets the
+ writers append records without going back to the header. Readers memory map the file, so reading the distances costs nothing
+ more than walking the records, and the ids avoid a name lookup per distance.
+ */
+
+/**************************************************************************************************/
+
+class BinaryDistanceFile {
+
+public:
+
+    BinaryDistanceFile(string); //maps the file for reading
+    ~BinaryDistanceFile();
+
+    unsigned int getNumSeqs() const { return names.size(); }
+    string getName(unsigned int i) const { return names[i]; }
+    vector<string> getNames() const { return names; }
+    unsigned long long getNumDists() const { return numDists; }
+    unsigned int getPrecision() const { return precision; }
+
+    unsigned int getRow(unsigned long long k) const { unsigned int row; memcpy(&row, dists + k*recordSize, 4); return row; }
+    unsigned int getColumn(unsigned long long k) const { unsigned int col; memcpy(&col, dists + k*recordSize + 4, 4); return col; }
+    float getDist(unsigned long long k) const { unsigned short value; memcpy(&value, dists + k*recordSize + 8, 2); return (float)value / (float)precision; }
+
+    int exportColumn(string); //writes the distances as a column formatted file
+
+    static const int recordSize = 10;
+
+    static bool isBinary(string); //true if the file starts with the binary distance header
+    static unsigned int precisionForCutoff(double); //largest power of 10 that keeps distances up to the cutoff in a uint16
+    static void writeHeader(string, const vector<string>&, unsigned int); //creates the file with its header and name table
+    static void appendRecord(string&, unsigned int, unsigned int, double, unsigned int); //adds an encoded distance to the buffer
+    static void appendRecords(string, string&); //appends the buffered records to the file and clears the buffer
+
+private:
+    MothurOut* m;
+    string filename;
+    vector<string> names;
+    unsigned int precision;
+    unsigned long long numDists, fileSize;
+    const char* data;
+    const char* dists;
+    vector<char> fileData; //the file contents on platforms without mmap
+
+    void mapFile();
+};
+
+/**************************************************************************************************/
+
+#endif /* defined(__Mothur__binarydistancefile__) */
@@ -9,6 +9,7 @@
 
 #include "readcolumn.h"
 #include "progress.hpp"
+#include "binarydistancefile.h"
 
 /***********************************************************************/
 
@@ -36,6 +37,11 @@ int ReadColumnMatrix::read(NameAssignment* nameMap){
 		int nseqs = nameMap->size();
         DMatrix->resize(nseqs);
 		list = new ListVector(nameMap->getListVector());
+		
+		if (BinaryDistanceFile::isBinary(distFile)) {
+			map<string, int> nameIndex(nameMap->begin(), nameMap->end());
+			return readBinary(nameIndex);
+		}
 	
 		Progress* reading = new Progress("Reading matrix:     ", nseqs * nseqs);
 
@@ -161,6 +167,13 @@ int ReadColumnMatrix::read(CountTable* countTable){
         
         DMatrix->resize(nseqs);
 		list = new ListVector(countTable->getListVector());
+		
+		if (BinaryDistanceFile::isBinary(distFile)) {
+			map<string, int> nameIndex;
+			vector<string> seqNames = countTable->getNamesOfSeqs();
+			for (int i = 0; i < seqNames.size(); i++) { nameIndex[seqNames[i]] = countTable->get(seqNames[i]); }
+			return readBinary(nameIndex);
+		}
         
 		Progress* reading = new Progress("Reading matrix:     ", nseqs * nseqs);
         
@@ -273,6 +286,54 @@ int ReadColumnMatrix::read(CountTable* countTable){
 	}
 }
 
+/***********************************************************************/
+//the binary files are written by dist.seqs and cluster.split, they are lower triangular and each distance is stored once.
+//nameIndex maps the sequence names to their matrix index.
+int ReadColumnMatrix::readBinary(map<string, int>& nameIndex){
+	try {
+		fileHandle.close();
+		
+		BinaryDistanceFile dists(distFile);
+		if (m->control_pressed) { return 0; }
+		
+		//binary file id -> matrix index, a missing name is only an error if one of its distances is used
+		vector<int> fileToIndex; fileToIndex.resize(dists.getNumSeqs(), -1);
+		for (int i = 0; i < dists.getNumSeqs(); i++) {
+			map<string, int>::iterator it = nameIndex.find(dists.getName(i));
+			if (it != nameIndex.end()) { fileToIndex[i] = it->second; }
+		}
+		
+		unsigned long long numDists = dists.getNumDists();
+		for (unsigned long long k = 0; k < numDists; k++) {
+			
+			if (m->control_pressed) {  return 0; }
+			
+			float distance = dists.getDist(k);
+			if (sim) { distance = 1.0 - distance;  }  //user has entered a sim matrix that we need to convert.
+			
+			unsigned int row = dists.getRow(k); unsigned int col = dists.getColumn(k);
+			
+			if(distance < cutoff && row != col){
+				int itA = fileToIndex[row];
+				int itB = fileToIndex[col];
+				
+				if(itA == -1){  m->mothurOut("AAError: Sequence '" + dists.getName(row) + "' was not found in the names file, please correct\n"); exit(1);  }
+				if(itB == -1){  m->mothurOut("ABError: Sequence '" + dists.getName(col) + "' was not found in the names file, please correct\n"); exit(1);  }
+				
+				if (itA > itB)	{ PDistCell value(itA, distance); DMatrix->addCell(itB, value); }
+				else			{ PDistCell value(itB, distance); DMatrix->addCell(itA, value); }
+			}
+		}
+		
+		list->setLabel("0");
+		
+		return 1;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ReadColumnMatrix", "readBinary");
+		exit(1);
+	}
+}
 /***********************************************************************/
 ReadColumnMatrix::~ReadColumnMatrix(){}
 /***********************************************************************/
@@ -25,6 +25,8 @@ private:
 	ifstream fileHandle;
 	string distFile;
 	
+	int readBinary(map<string, int>&);
+	
 };
 
 /******************************************************/
@@ -70,8 +70,9 @@ int SplitMatrix::split(){
 int SplitMatrix::splitDistance(){
 	try {
         
-		if (large)	{ splitDistanceLarge(); }
-		else		{ splitDistanceRAM();	}
+		if (BinaryDistanceFile::isBinary(distFile))	{ splitDistanceBinary();	}
+		else if (large)								{ splitDistanceLarge();		}
+		else										{ splitDistanceRAM();		}
 		
 		return 0;
 			
@@ -247,6 +248,32 @@ int SplitMatrix::splitDistanceFileByTax(map<string, int>& seqGroup, int numGroup
 		map<string, int>::iterator it;
 		map<string, int>::iterator it2;
 		
+		if (BinaryDistanceFile::isBinary(distFile)) {
+			BinaryDistanceFile binaryFile(distFile);
+			if (m->control_pressed) { return 0; }
+			
+			vector<int> groupOfSeq; groupOfSeq.resize(binaryFile.getNumSeqs(), -1);
+			for (int i = 0; i < binaryFile.getNumSeqs(); i++) {
+				it = seqGroup.find(binaryFile.getName(i));
+				if (it != seqGroup.end()) { groupOfSeq[i] = it->second; }
+			}
+			
+			vector<string> tempDistFiles;
+			splitBinaryFileByGroup(binaryFile, groupOfSeq, numGroups, false, tempDistFiles);
+			
+			splitNames(seqGroup, numGroups, tempDistFiles);
+			
+			if (m->control_pressed)	 {
+				for (int i = 0; i < dists.size(); i++) {
+					m->mothurRemove((dists[i].begin()->first));
+					m->mothurRemove((dists[i].begin()->second));
+				}
+				dists.clear();
+			}
+			
+			return 0;
+		}
+		
         ofstream outFile;
 		ifstream dFile;
 		m->openInputFile(distFile, dFile);
@@ -535,6 +562,123 @@ int SplitMatrix::splitDistanceLarge(){
 		exit(1);
 	}
 }
+/***********************************************************************/
+//the binary file has integer ids, so the sequences are grouped with a union find over the ids instead of searching sets of names
+int SplitMatrix::splitDistanceBinary(){
+	try {
+		BinaryDistanceFile binaryFile(distFile);
+		if (m->control_pressed) { return 0; }
+		
+		int numSeqs = binaryFile.getNumSeqs();
+		unsigned long long numDists = binaryFile.getNumDists();
+		
+		vector<int> parent; parent.resize(numSeqs);
+		for (int i = 0; i < numSeqs; i++) { parent[i] = i; }
+		vector<bool> hasDist; hasDist.resize(numSeqs, false);
+		
+		for (unsigned long long k = 0; k < numDists; k++) {
+			
+			if (m->control_pressed) { return 0; }
+			
+			if (binaryFile.getDist(k) < cutoff) {
+				int a = binaryFile.getRow(k); int b = binaryFile.getColumn(k);
+				hasDist[a] = true; hasDist[b] = true;
+				
+				while (parent[a] != a) { parent[a] = parent[parent[a]]; a = parent[a]; }
+				while (parent[b] != b) { parent[b] = parent[parent[b]]; b = parent[b]; }
+				if (a < b)		{ parent[b] = a; }
+				else if (b < a)	{ parent[a] = b; }
+			}
+		}
+		
+		//number the groups in the order of their smallest id
+		int numGroups = 0;
+		vector<int> groupOfSeq; groupOfSeq.resize(numSeqs, -1);
+		for (int i = 0; i < numSeqs; i++) {
+			if (!hasDist[i]) { continue; }
+			
+			int root = i;
+			while (parent[root] != root) { root = parent[root]; }
+			
+			if (root == i)	{ groupOfSeq[i] = numGroups; numGroups++;	}
+			else			{ groupOfSeq[i] = groupOfSeq[root];		}
+		}
+		parent.clear(); hasDist.clear();
+		
+		vector<string> tempDistFiles;
+		splitBinaryFileByGroup(binaryFile, groupOfSeq, numGroups, true, tempDistFiles);
+		
+		if (m->control_pressed) { for (int i = 0; i < tempDistFiles.size(); i++) { m->mothurRemove(tempDistFiles[i]); } return 0; }
+		
+		map<string, int> seqGroup;
+		for (int i = 0; i < numSeqs; i++) {
+			if (groupOfSeq[i] != -1) { seqGroup[binaryFile.getName(i)] = groupOfSeq[i]; }
+		}
+		
+		splitNames(seqGroup, numGroups, tempDistFiles);
+		
+		return 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SplitMatrix", "splitDistanceBinary");
+		exit(1);
+	}
+}
+/***********************************************************************/
+//writes the distances between sequences in the same group to a binary file per group. Each group file gets its own name table,
+//so its ids run from 0 to the group size. A group file is only created once it has a distance, like the column splitters.
+int SplitMatrix::splitBinaryFileByGroup(BinaryDistanceFile& binaryFile, vector<int>& groupOfSeq, int numGroups, bool useCutoff, vector<string>& tempDistFiles){
+	try {
+		unsigned int precision = binaryFile.getPrecision();
+		
+		vector<unsigned int> localID; localID.resize(groupOfSeq.size(), 0);
+		vector< vector<string> > groupNames; groupNames.resize(numGroups);
+		for (int i = 0; i < groupOfSeq.size(); i++) {
+			if (groupOfSeq[i] == -1) { continue; }
+			localID[i] = groupNames[groupOfSeq[i]].size();
+			groupNames[groupOfSeq[i]].push_back(binaryFile.getName(i));
+		}
+		
+		tempDistFiles.clear();
+		for (int i = 0; i < numGroups; i++) {
+			string fileName = distFile + "." + toString(i) + ".temp";
+			m->mothurRemove(fileName);
+			tempDistFiles.push_back(fileName);
+		}
+		
+		//for buffering the io to improve speed
+		vector<string> outputs;  outputs.resize(numGroups, "");
+		vector<bool> wroteHeader; wroteHeader.resize(numGroups, false);
+		int bufferSize = 4096 * BinaryDistanceFile::recordSize;
+		
+		for (unsigned long long k = 0; k < binaryFile.getNumDists(); k++) {
+			
+			if (m->control_pressed) { return 0; }
+			
+			unsigned int row = binaryFile.getRow(k); unsigned int col = binaryFile.getColumn(k);
+			int group = groupOfSeq[row];
+			
+			if ((group == -1) || (group != groupOfSeq[col])) { continue; }
+			
+			float dist = binaryFile.getDist(k);
+			if (useCutoff && (dist >= cutoff)) { continue; }
+			
+			if (!wroteHeader[group]) { BinaryDistanceFile::writeHeader(tempDistFiles[group], groupNames[group], precision); wroteHeader[group] = true; }
+			
+			BinaryDistanceFile::appendRecord(outputs[group], localID[row], localID[col], dist, precision);
+			if (outputs[group].length() >= bufferSize) { BinaryDistanceFile::appendRecords(tempDistFiles[group], outputs[group]); }
+		}
+		
+		//write out any remaining buffers
+		for (int i = 0; i < numGroups; i++) { BinaryDistanceFile::appendRecords(tempDistFiles[i], outputs[i]); }
+		
+		return 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SplitMatrix", "splitBinaryFileByGroup");
+		exit(1);
+	}
+}
 //********************************************************************************************************************
 int SplitMatrix::splitNames(map<string, int>& seqGroup, int numGroups, vector<string>& tempDistFiles){
 	try {
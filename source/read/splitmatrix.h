@@ -12,6 +12,7 @@
 
 #include "mothur.h"
 #include "mothurout.h"
+#include "binarydistancefile.h"
 
 /******************************************************/
 
@@ -42,6 +43,8 @@ class SplitMatrix  {
 		int splitClassify();
 		int splitDistanceLarge();
 		int splitDistanceRAM();
+		int splitDistanceBinary();
+		int splitBinaryFileByGroup(BinaryDistanceFile&, vector<int>&, int, bool, vector<string>&);
 		int splitNames(map<string, int>& groups, int, vector<string>&);
         int splitNamesVsearch(map<string, int>& groups, int, vector<string>&);
 		int splitDistanceFileByTax(map<string, int>&, int);
@@ -30,21 +30,16 @@ Tree* SubSample::getSample(Tree* T, CountTable* ct, CountTable* newCt, int size)
                 if (thisSize >= size) {	
                     
                     vector<string> names = ct->getNamesOfSeqs(Groups[i]);
-                    vector<int> random;
-                    for (int j = 0; j < names.size(); j++) {
-                        int num = ct->getGroupCount(names[j], Groups[i]);
-                        for (int k = 0; k < num; k++) { random.push_back(j); }
-                    }
-                    m->mothurRandomShuffle(random);
+                    vector<int> groupCounts(names.size(), 0);
+                    for (int j = 0; j < names.size(); j++) { groupCounts[j] = ct->getGroupCount(names[j], Groups[i]); }
                     
-                    vector<int> sampleRandoms; sampleRandoms.resize(names.size(), 0);
-                    for (int j = 0; j < size; j++) { sampleRandoms[random[j]]++; }
-                    for (int j = 0; j < sampleRandoms.size(); j++) {
-                        newCt->setAbund(names[j], Groups[i], sampleRandoms[j]);
+                    vector<int> sampleCounts;
+                    getSample(groupCounts, size, sampleCounts);
+                    
+                    for (int j = 0; j < names.size(); j++) {
+                        newCt->setAbund(names[j], Groups[i], sampleCounts[j]);
+                        doNotIncludeTotals[names[j]] += (groupCounts[j] - sampleCounts[j]);
                     }
-                    sampleRandoms.clear(); sampleRandoms.resize(names.size(), 0);
-                    for (int j = size; j < thisSize; j++) { sampleRandoms[random[j]]++; }
-                    for (int j = 0; j < sampleRandoms.size(); j++) {  doNotIncludeTotals[names[j]] += sampleRandoms[j]; }
                 }else {  m->mothurOut("[ERROR]: You have selected a size that is larger than "+Groups[i]+" number of sequences.\n"); m->control_pressed = true; }
             }
 
@@ -111,37 +106,9 @@ vector<string> SubSample::getSample(vector<SharedRAbundVector*>& thislookup, int
 		//save mothurOut's binLabels to restore for next label
 		vector<string> saveBinLabels = m->currentSharedBinLabels;
 		
-		int numBins = thislookup[0]->getNumBins();
-		for (int i = 0; i < thislookup.size(); i++) {		
-			int thisSize = thislookup[i]->getNumSeqs();
-			
-			if (thisSize != size) {
-				
-				string thisgroup = thislookup[i]->getGroup();
-				
-				OrderVector order = thislookup[i]->getOrderVector(NULL);
-                
-                m->mothurRandomShuffle(order);
-				
-				SharedRAbundVector* temp = new SharedRAbundVector(numBins);
-				temp->setLabel(thislookup[i]->getLabel());
-				temp->setGroup(thislookup[i]->getGroup());
-				
-				delete thislookup[i];
-				thislookup[i] = temp;
-				
-				
-				for (int j = 0; j < size; j++) {
-					
-					if (m->control_pressed) {  return m->currentSharedBinLabels; }
-					
-					int bin = order.get(j);
-					
-					int abund = thislookup[i]->getAbundance(bin);
-					thislookup[i]->set(bin, (abund+1), thisgroup);
-				}	
-			}
-		}
+		sampleLookup(thislookup, size, m->getRandomEngine());
+		
+		if (m->control_pressed) { return m->currentSharedBinLabels; }
 		
 		//subsampling may have created some otus with no sequences in them
 		eliminateZeroOTUS(thislookup);
@@ -161,7 +128,62 @@ vector<string> SubSample::getSample(vector<SharedRAbundVector*>& thislookup, int
 	}
 }	
 //**********************************************************************************************************************
-int SubSample::eliminateZeroOTUS(vector<SharedRAbundVector*>& thislookup) {
+int SubSample::getSample(vector<SharedRAbundVector*>& thislookup, int size, mt19937_64& engine) {
+	try {
+		
+		sampleLookup(thislookup, size, engine);
+		
+		if (m->control_pressed) { return 0; }
+		
+		//subsampling may have created some otus with no sequences in them
+		eliminateZeroOTUS(thislookup, false);
+		
+		return 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SubSample", "getSample-sharedEngine");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+//replaces each group with more than size sequences by a sample of size of them
+int SubSample::sampleLookup(vector<SharedRAbundVector*>& thislookup, int size, mt19937_64& engine) {
+	try {
+		
+		int numBins = thislookup[0]->getNumBins();
+		counts.resize(numBins);
+		for (int i = 0; i < thislookup.size(); i++) {
+			if (m->control_pressed) {  return 0; }
+			
+			if (thislookup[i]->getNumSeqs() == size) { continue; }
+			
+			string thisgroup = thislookup[i]->getGroup();
+			
+			for (int j = 0; j < numBins; j++) { counts[j] = thislookup[i]->getAbundance(j); }
+			getSample(counts, size, sampled, engine);
+			
+			SharedRAbundVector* temp = new SharedRAbundVector(numBins);
+			temp->setLabel(thislookup[i]->getLabel());
+			temp->setGroup(thisgroup);
+			
+			delete thislookup[i];
+			thislookup[i] = temp;
+			
+			for (int j = 0; j < numBins; j++) {
+				if (sampled[j] != 0) { thislookup[i]->set(j, sampled[j], thisgroup); }
+			}
+		}
+		
+		return 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SubSample", "sampleLookup");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+//updateLabels=false skips the bin labels, mothurOuts binlabels are left alone
+int SubSample::eliminateZeroOTUS(vector<SharedRAbundVector*>& thislookup, bool updateLabels) {
 	try {
 		
 		vector<SharedRAbundVector*> newLookup;
@@ -189,6 +211,8 @@ int SubSample::eliminateZeroOTUS(vector<SharedRAbundVector*>& thislookup) {
 				for (int j = 0; j < thislookup.size(); j++) {
 					newLookup[j]->push_back(thislookup[j]->getAbundance(i), thislookup[j]->getGroup());
 				}
+				if (!updateLabels) { continue; }
+				
 				//if there is a bin label use it otherwise make one
 				string binLabel = "Otu";
 				string sbinNumber = toString(i+1);
@@ -207,7 +231,7 @@ int SubSample::eliminateZeroOTUS(vector<SharedRAbundVector*>& thislookup) {
 		thislookup.clear();
 		
 		thislookup = newLookup;
-		m->currentSharedBinLabels = newBinLabels;
+		if (updateLabels) { m->currentSharedBinLabels = newBinLabels; }
 		
 		return 0;
 		
@@ -221,24 +245,21 @@ int SubSample::eliminateZeroOTUS(vector<SharedRAbundVector*>& thislookup) {
 int SubSample::getSample(SAbundVector*& sabund, int size) {
 	try {
 		
-        int numBins = sabund->getNumBins();
         int thisSize = sabund->getNumSeqs();
-
-        OrderVector order = sabund->getOrderVector();
         
 		if (thisSize > size) {
-			m->mothurRandomShuffle(order);
+            RAbundVector whole = sabund->getRAbundVector();
+            int numBins = whole.getNumBins();
+            
+            counts.resize(numBins);
+            for (int j = 0; j < numBins; j++) { counts[j] = whole.get(j); }
+            getSample(counts, size, sampled);
 			
             RAbundVector rabund(numBins);
 			rabund.setLabel(sabund->getLabel());
-
-			for (int j = 0; j < size; j++) {
-                
-				if (m->control_pressed) { return 0; }
-				
-                int abund = rabund.get(order.get(j));
-				rabund.set(order.get(j), (abund+1));
-			}
+            for (int j = 0; j < numBins; j++) { if (sampled[j] != 0) { rabund.set(j, sampled[j]); } }
+            
+			if (m->control_pressed) { return 0; }
 
             delete sabund;
             sabund = new SAbundVector();
@@ -267,31 +288,32 @@ CountTable SubSample::getSample(CountTable& ct, int size, vector<string> Groups)
             sampledCt.addGroup(Groups[i]);
             
             vector<string> names = ct.getNamesOfSeqs(Groups[i]);
-            vector<string> allNames;
+            int total = 0;
+            counts.resize(names.size());
             for (int j = 0; j < names.size(); j++) {
                 
                 if (m->control_pressed) { return sampledCt; }
                 
-                int num = ct. getGroupCount(names[j], Groups[i]);
-                for (int k = 0; k < num; k++) { allNames.push_back(names[j]); }
+                counts[j] = ct. getGroupCount(names[j], Groups[i]);
+                total += counts[j];
             }
             
-            m->mothurRandomShuffle(allNames);
-            
-            if (allNames.size() < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than "+Groups[i]+" number of sequences.\n"); m->control_pressed = true; }
+            if (total < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than "+Groups[i]+" number of sequences.\n"); m->control_pressed = true; }
             else{
-                for (int j = 0; j < size; j++) {
+                getSample(counts, size, sampled);
+                
+                for (int j = 0; j < names.size(); j++) {
                     
-                    if (m->control_pressed) { return sampledCt; }
+                    if (sampled[j] == 0) { continue; }
                     
-                    map<string, vector<int> >::iterator it = tempCount.find(allNames[j]);
+                    map<string, vector<int> >::iterator it = tempCount.find(names[j]);
                     
                     if (it == tempCount.end()) { //we have not seen this sequence at all yet
                         vector<int> tempGroups; tempGroups.resize(Groups.size(), 0);
-                        tempGroups[i]++;
-                        tempCount[allNames[j]] = tempGroups;
+                        tempGroups[i] = sampled[j];
+                        tempCount[names[j]] = tempGroups;
                     }else{
-                        tempCount[allNames[j]][i]++;
+                        tempCount[names[j]][i] = sampled[j];
                     }
                 }
             }
@@ -318,16 +340,17 @@ CountTable SubSample::getSample(CountTable& ct, int size, vector<string> Groups,
         
         if (ct.hasGroupInfo()) {
             map<string, vector<int> > tempCount;
-            vector<item> allNames;
-            map<string, int> groupMap;
+            vector<string> allNames; //the name and group of each count
+            vector<int> allGroups;
+            int total = 0;
             
             vector<string> myGroups;
             if (pickedGroups) { myGroups = Groups; }
             else {  myGroups = ct.getNamesOfGroups(); }
             
+            counts.clear();
             for (int i = 0; i < myGroups.size(); i++) {
                 sampledCt.addGroup(myGroups[i]);
-                groupMap[myGroups[i]] = i;
                 
                 vector<string> names = ct.getNamesOfSeqs(myGroups[i]);
                 for (int j = 0; j < names.size(); j++) {
@@ -335,32 +358,30 @@ CountTable SubSample::getSample(CountTable& ct, int size, vector<string> Groups,
                     if (m->control_pressed) { return sampledCt; }
                     
                     int num = ct. getGroupCount(names[j], myGroups[i]);
-                    for (int k = 0; k < num; k++) { 
-                        item temp(names[j], myGroups[i]);
-                        allNames.push_back(temp); 
-                    }
+                    allNames.push_back(names[j]); allGroups.push_back(i); counts.push_back(num);
+                    total += num;
                 }
             }
             
-            m->mothurRandomShuffle(allNames);
-            
-            if (allNames.size() < size) { 
+            if (total < size) { 
                 if (pickedGroups) { m->mothurOut("[ERROR]: You have selected a size that is larger than the number of sequences.\n"); } 
                 else { m->mothurOut("[ERROR]: You have selected a size that is larger than the number of sequences in the groups you chose.\n"); }
                 m->control_pressed = true; return sampledCt; }
             else{
-                for (int j = 0; j < size; j++) {
+                getSample(counts, size, sampled);
+                
+                for (int j = 0; j < allNames.size(); j++) {
                     
-                    if (m->control_pressed) { return sampledCt; }
+                    if (sampled[j] == 0) { continue; }
                     
-                    map<string, vector<int> >::iterator it = tempCount.find(allNames[j].name);
+                    map<string, vector<int> >::iterator it = tempCount.find(allNames[j]);
                     
                     if (it == tempCount.end()) { //we have not seen this sequence at all yet
                         vector<int> tempGroups; tempGroups.resize(myGroups.size(), 0);
-                        tempGroups[groupMap[allNames[j].group]]++;
-                        tempCount[allNames[j].name] = tempGroups;
+                        tempGroups[allGroups[j]] = sampled[j];
+                        tempCount[allNames[j]] = tempGroups;
                     }else{
-                        tempCount[allNames[j].name][groupMap[allNames[j].group]]++;
+                        tempCount[allNames[j]][allGroups[j]] = sampled[j];
                     }
                 }
             }
@@ -377,25 +398,22 @@ CountTable SubSample::getSample(CountTable& ct, int size, vector<string> Groups,
         }else {
             vector<string> names = ct.getNamesOfSeqs();
             map<string, int> nameMap;
-            vector<string> allNames;
+            int total = 0;
             
+            counts.resize(names.size());
             for (int i = 0; i < names.size(); i++) {
-                int num = ct.getNumSeqs(names[i]);
-                for (int j = 0; j < num; j++) { allNames.push_back(names[i]); }
+                counts[i] = ct.getNumSeqs(names[i]);
+                total += counts[i];
             }
             
-            if (allNames.size() < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than the number of sequences.\n"); m->control_pressed = true; return sampledCt; }
+            if (total < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than the number of sequences.\n"); m->control_pressed = true; return sampledCt; }
             else {
-                m->mothurRandomShuffle(allNames);
+                getSample(counts, size, sampled);
                 
-                for (int j = 0; j < size; j++) {
+                for (int j = 0; j < names.size(); j++) {
                     if (m->control_pressed) { return sampledCt; }
                     
-                    map<string, int>::iterator it = nameMap.find(allNames[j]);
-                    
-                    //we have not seen this sequence at all yet
-                    if (it == nameMap.end()) { nameMap[allNames[j]] = 1;  }
-                    else{  nameMap[allNames[j]]++;  }
+                    if (sampled[j] != 0) { nameMap[names[j]] = sampled[j]; }
                 }
                 
                 //build count table
@@ -414,5 +432,108 @@ CountTable SubSample::getSample(CountTable& ct, int size, vector<string> Groups,
 	}
 }
 //**********************************************************************************************************************
-
-
+int SubSample::getSample(vector<int>& thisCounts, int size, vector<int>& thisSampled) {
+	try {
+        return getSample(thisCounts, size, thisSampled, m->getRandomEngine());
+    }
+	catch(exception& e) {
+		m->errorOut(e, "SubSample", "getSample-counts");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+//draws the bins in order, bin i's share of what is left to draw is hypergeometric given the sequences left in it and after it.
+//If size is not less than the total every sequence is kept.
+int SubSample::getSample(vector<int>& thisCounts, int size, vector<int>& thisSampled, mt19937_64& engine) {
+	try {
+        int total = 0;
+        for (int i = 0; i < thisCounts.size(); i++) { total += thisCounts[i]; }
+        
+        if (size >= total) { thisSampled = thisCounts; return 0; }
+        
+        thisSampled.assign(thisCounts.size(), 0);
+        
+        int left = total;
+        int toDraw = size;
+        for (int i = 0; i < thisCounts.size(); i++) {
+            if (toDraw == 0) { break; }
+            if (thisCounts[i] == 0) { continue; }
+            
+            thisSampled[i] = hypergeometric(thisCounts[i], left, toDraw, engine);
+            left -= thisCounts[i];
+            toDraw -= thisSampled[i];
+        }
+        
+        return 0;
+    }
+	catch(exception& e) {
+		m->errorOut(e, "SubSample", "getSample-countsEngine");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+//how many of the n drawn without replacement from N are from the K marked ones
+int SubSample::hypergeometric(int K, int N, int n, mt19937_64& engine) {
+	try {
+        if ((n == 0) || (K == 0)) { return 0; }
+        if (K == N) { return n; }
+        if (n == N) { return K; }
+        
+        //the distribution is the same with K and n traded, so K is the smaller
+        if (K > n) { int temp = K; K = n; n = temp; }
+        
+        uniform_real_distribution<double> dis(0.0, 1.0);
+        
+        //few marked, each is drawn with probability (draws left) / (sequences left)
+        if (K <= 16) {
+            int x = 0;
+            for (int j = 0; j < K; j++) { if ((dis(engine) * (double)(N-j)) < (double)(n-x)) { x++; } }
+            return x;
+        }
+        
+        //otherwise walk out from the mode alternating sides until the uniform is used up, about a standard deviation of steps
+        int low = n - (N-K); if (low < 0) { low = 0; }
+        int high = K;
+        int mode = (int)(((double)(n+1) * (double)(K+1)) / (double)(N+2));
+        if (mode < low) { mode = low; }
+        if (mode > high) { mode = high; }
+        
+        double pMode = exp(logChoose(K, mode) + logChoose(N-K, n-mode) - logChoose(N, n));
+        double u = dis(engine) - pMode;
+        if (u <= 0) { return mode; }
+        
+        int left = mode; int right = mode;
+        double pLeft = pMode; double pRight = pMode;
+        while ((left > low) || (right < high)) {
+            if (right < high) {
+                pRight *= ((double)(K-right) * (double)(n-right)) / ((double)(right+1) * (double)(N-K-n+right+1));
+                right++;
+                u -= pRight;
+                if (u <= 0) { return right; }
+            }
+            if (left > low) {
+                pLeft *= ((double)left * (double)(N-K-n+left)) / ((double)(K-left+1) * (double)(n-left+1));
+                left--;
+                u -= pLeft;
+                if (u <= 0) { return left; }
+            }
+        }
+        
+        return mode; //rounding left a sliver of probability
+    }
+	catch(exception& e) {
+		m->errorOut(e, "SubSample", "hypergeometric");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+//the sampling threads call this, lgamma sets the global signgam so the reentrant lgamma_r is used where there is one
+double SubSample::logChoose(int n, int k) {
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+    int sign;
+    return (lgamma_r((double)n+1.0, &sign) - lgamma_r((double)k+1.0, &sign) - lgamma_r((double)(n-k)+1.0, &sign));
+#else
+    return (lgamma((double)n+1.0) - lgamma((double)k+1.0) - lgamma((double)(n-k)+1.0));
+#endif
+}
+//**********************************************************************************************************************
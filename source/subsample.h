@@ -17,6 +17,8 @@
 
 
 //subsampling overwrites the sharedRabunds.  If you need to reuse the original use the getSamplePreserve function.
+//the samples are drawn from the counts, one hypergeometric draw per bin, so no vector with an entry per sequence is made or shuffled.
+//The draws come from a SubSample's own buffers, give each thread its own SubSample.
 
 class SubSample {
 	
@@ -26,15 +28,22 @@ class SubSample {
         ~SubSample() {}
     
         vector<string> getSample(vector<SharedRAbundVector*>&, int); //returns the bin labels for the subsample, mothurOuts binlabels are preserved so you can run this multiple times. Overwrites original vector passed in, if you need to preserve it deep copy first.
+        int getSample(vector<SharedRAbundVector*>&, int, mt19937_64&); //same as above drawing from the engine given instead of mothur's generator, leaves mothurOuts binlabels alone so threads can use it. Overwrites original vector passed in.
         Tree* getSample(Tree*, CountTable*, CountTable*, int); //creates new subsampled tree. Uses first counttable to fill new counttable with sabsampled seqs. Sets groups of seqs not in subsample to "doNotIncludeMe".
         int getSample(SAbundVector*&, int); //destroys sabundvector passed in, so copy it if you need it
         CountTable getSample(CountTable&, int, vector<string>); //subsample a countTable bygroup(same number sampled from each group, returns subsampled countTable 
         CountTable getSample(CountTable&, int, vector<string>, bool); //subsample a countTable. If you want to only sample from specific groups, pass in groups in the vector and set bool=true, otherwise set bool=false.   
+        int getSample(vector<int>&, int, vector<int>&); //counts, size, sampled. sampled[i] is how many of the size drawn came from counts[i], uses mothur's generator
+        int getSample(vector<int>&, int, vector<int>&, mt19937_64&); //same as above drawing from the engine given
     
     private:
     
         MothurOut* m;
-        int eliminateZeroOTUS(vector<SharedRAbundVector*>&);
+        vector<int> counts, sampled; //reused by every sample this object draws
+        int sampleLookup(vector<SharedRAbundVector*>&, int, mt19937_64&);
+        int hypergeometric(int, int, int, mt19937_64&);
+        double logChoose(int, int);
+        int eliminateZeroOTUS(vector<SharedRAbundVector*>&, bool updateLabels = true);
          map<string, string> deconvolute(map<string, string> wholeSet, vector<string>& subsampleWanted); //returns new nameMap containing only subsampled names, and removes redundants from subsampled wanted because it makes the new nameMap.
 
 
@@ -58,6 +58,12 @@ TrimOligos::TrimOligos(int p, int b, int l, int s, map<string, int> pr, map<stri
                 maxSpacerLength = spacer[i].length();
             }
         }
+        
+        vector<string> barcodeOligos, primerOligos;
+        for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++){ barcodeOligos.push_back(it->first); }
+        for(it=primers.begin();it!=primers.end();it++){ primerOligos.push_back(it->first); }
+        barcodeLookup = OligoLookup(barcodeOligos, bdiffs);
+        primerLookup = OligoLookup(primerOligos, pdiffs);
     }
     catch(exception& e) {
         m->errorOut(e, "TrimOligos", "TrimOligos");
@@ -132,6 +138,8 @@ TrimOligos::TrimOligos(int p, int b, int l, int s, map<int, oligosPair> pr, map<
         
         ipbarcodes = br;
         ipprimers = pr;
+        pairedBarcodeLookup = OligoPairLookup(ipbarcodes, bdiffs);
+        pairedPrimerLookup = OligoPairLookup(ipprimers, pdiffs);
     }
     catch(exception& e) {
         m->errorOut(e, "TrimOligos", "TrimOligos");
@@ -171,6 +179,12 @@ TrimOligos::TrimOligos(int p, int rd, int b, map<string, int> pr, map<string, in
             }
         }
         maxRPrimerLength = maxFPrimerLength;
+        
+        vector<string> barcodeOligos, primerOligos;
+        for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++){ barcodeOligos.push_back(it->first); }
+        for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++){ primerOligos.push_back(it->first); }
+        barcodeLookup = OligoLookup(barcodeOligos, bdiffs);
+        primerLookup = OligoLookup(primerOligos, pdiffs);
     }
     catch(exception& e) {
         m->errorOut(e, "TrimOligos", "TrimOligos");
@@ -412,8 +426,11 @@ vector<int> TrimOligos::stripBarcode(Sequence& seq, QualityScores& qual, int& gr
         success.push_back(bdiffs + 1000);	//guilty until proven innocent
         success.push_back(1e6); //no matches found
         
-        //can you find the barcode
-        for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++){
+        //can you find the barcode, the lookup jumps straight to the one that ends the search
+        map<string,int>::iterator itFirst = barcodes.end();
+        int first = barcodeLookup.findFirst(rawSequence);
+        if (first != -1) { itFirst = barcodes.find(barcodeLookup.getOligo(first)); }
+        for(map<string,int>::iterator it=itFirst;it!=barcodes.end();it++){
             string oligo = it->first;
             if(rawSequence.length() < oligo.length()){	//let's just assume that the barcodes are the same length
                 success[0] = rawSequence.length();
@@ -449,7 +466,17 @@ vector<int> TrimOligos::stripBarcode(Sequence& seq, QualityScores& qual, int& gr
             int minGroup = -1;
             int minPos = 0;
             
-            for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++){
+            //only align the barcodes the lookup found within bdiffs substitutions, or all of them if it found none
+            vector<map<string,int>::iterator> searchOligos;
+            vector<int> closest;
+            if ((rawSequence.length() >= maxFBarcodeLength) && barcodeLookup.findClose(rawSequence, closest)) {
+                for (int i = 0; i < closest.size(); i++) { searchOligos.push_back(barcodes.find(barcodeLookup.getOligo(closest[i]))); }
+            }else {
+                for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++){ searchOligos.push_back(it); }
+            }
+            
+            for(int s = 0; s < searchOligos.size(); s++){
+                map<string,int>::iterator it = searchOligos[s];
                 string oligo = it->first;
                 // int length = oligo.length();
                 
@@ -528,8 +555,11 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
         success.push_back(bdiffs + 1000);
         success.push_back(1e6);
         
-        //can you find the forward barcode
-        for(map<int,oligosPair>::iterator it=ipbarcodes.begin();it!=ipbarcodes.end();it++){
+        //can you find the forward barcode, the lookup jumps straight to the pair that ends the search
+        map<int,oligosPair>::iterator itFirst = ipbarcodes.end();
+        int first = pairedBarcodeLookup.findFirst(rawFSequence, rawRSequence);
+        if (first != -1) { itFirst = ipbarcodes.find(first); }
+        for(map<int,oligosPair>::iterator it=itFirst;it!=ipbarcodes.end();it++){
             string foligo = it->second.forward;
             string roligo = it->second.reverse;
             
@@ -594,7 +624,17 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
              but if best match forward = 4, and reverse = 1, we want to count as a valid match because forward 1 and forward 4 are the same. so both barcodes map to same group.
              */
             //cout << endl << forwardSeq.getName() << endl;
-            for(map<string, vector<int> >::iterator it=ifbarcodes.begin();it!=ifbarcodes.end();it++){
+            //only align the forward barcodes the lookup found within bdiffs substitutions, or all of them if it found none
+            vector<map<string, vector<int> >::iterator> searchForward;
+            vector<int> closest;
+            if ((rawFSequence.length() >= maxFBarcodeLength) && pairedBarcodeLookup.forward.findClose(rawFSequence, closest)) {
+                for (int i = 0; i < closest.size(); i++) { searchForward.push_back(ifbarcodes.find(pairedBarcodeLookup.forward.getOligo(closest[i]))); }
+            }else {
+                for(map<string, vector<int> >::iterator it=ifbarcodes.begin();it!=ifbarcodes.end();it++){ searchForward.push_back(it); }
+            }
+            
+            for(int s = 0; s < searchForward.size(); s++){
+                map<string, vector<int> >::iterator it = searchForward[s];
                 string oligo = it->first;
                 
                 if(rawFSequence.length() < maxFBarcodeLength){	//let's just assume that the barcodes are the same length
@@ -669,7 +709,16 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
                 vector< vector<int> > minRGroup;
                 vector<int> minRPos;
                 
-                for(map<string, vector<int> >::iterator it=irbarcodes.begin();it!=irbarcodes.end();it++){
+                //only align the reverse barcodes the lookup found within bdiffs substitutions, or all of them if it found none
+                vector<map<string, vector<int> >::iterator> searchReverse;
+                if ((rawRSequence.length() >= maxRBarcodeLength) && pairedBarcodeLookup.reverse.findClose(rawRSequence, closest)) {
+                    for (int i = 0; i < closest.size(); i++) { searchReverse.push_back(irbarcodes.find(pairedBarcodeLookup.reverse.getOligo(closest[i]))); }
+                }else {
+                    for(map<string, vector<int> >::iterator it=irbarcodes.begin();it!=irbarcodes.end();it++){ searchReverse.push_back(it); }
+                }
+                
+                for(int s = 0; s < searchReverse.size(); s++){
+                    map<string, vector<int> >::iterator it = searchReverse[s];
                     string oligo = it->first;
                     //cout << "before = " << oligo << '\t' << rawRSequence.substr(0,oligo.length()+bdiffs) << endl;
                     if(rawRSequence.length() < maxRBarcodeLength){	//let's just assume that the barcodes are the same length
@@ -780,8 +829,11 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
         success.push_back(bdiffs + 1000);
         success.push_back(1e6);
         
-        //can you find the forward barcode
-        for(map<int,oligosPair>::iterator it=ipbarcodes.begin();it!=ipbarcodes.end();it++){
+        //can you find the forward barcode, the lookup jumps straight to the pair that ends the search
+        map<int,oligosPair>::iterator itFirst = ipbarcodes.end();
+        int first = pairedBarcodeLookup.findFirst(rawFSequence, rawRSequence);
+        if (first != -1) { itFirst = ipbarcodes.find(first); }
+        for(map<int,oligosPair>::iterator it=itFirst;it!=ipbarcodes.end();it++){
             string foligo = it->second.forward;
             string roligo = it->second.reverse;
             
@@ -858,7 +910,17 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
              but if best match forward = 4, and reverse = 1, we want to count as a valid match because forward 1 and forward 4 are the same. so both barcodes map to same group.
              */
             //cout << endl << forwardSeq.getName() << endl;
-            for(map<string, vector<int> >::iterator it=ifbarcodes.begin();it!=ifbarcodes.end();it++){
+            //only align the forward barcodes the lookup found within bdiffs substitutions, or all of them if it found none
+            vector<map<string, vector<int> >::iterator> searchForward;
+            vector<int> closest;
+            if ((rawFSequence.length() >= maxFBarcodeLength) && pairedBarcodeLookup.forward.findClose(rawFSequence, closest)) {
+                for (int i = 0; i < closest.size(); i++) { searchForward.push_back(ifbarcodes.find(pairedBarcodeLookup.forward.getOligo(closest[i]))); }
+            }else {
+                for(map<string, vector<int> >::iterator it=ifbarcodes.begin();it!=ifbarcodes.end();it++){ searchForward.push_back(it); }
+            }
+            
+            for(int s = 0; s < searchForward.size(); s++){
+                map<string, vector<int> >::iterator it = searchForward[s];
                 string oligo = it->first;
                 
                 if(rawFSequence.length() < maxFBarcodeLength){	//let's just assume that the barcodes are the same length
@@ -930,7 +992,16 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
                 vector< vector<int> > minRGroup;
                 vector<int> minRPos;
                 
-                for(map<string, vector<int> >::iterator it=irbarcodes.begin();it!=irbarcodes.end();it++){
+                //only align the reverse barcodes the lookup found within bdiffs substitutions, or all of them if it found none
+                vector<map<string, vector<int> >::iterator> searchReverse;
+                if ((rawRSequence.length() >= maxRBarcodeLength) && pairedBarcodeLookup.reverse.findClose(rawRSequence, closest)) {
+                    for (int i = 0; i < closest.size(); i++) { searchReverse.push_back(irbarcodes.find(pairedBarcodeLookup.reverse.getOligo(closest[i]))); }
+                }else {
+                    for(map<string, vector<int> >::iterator it=irbarcodes.begin();it!=irbarcodes.end();it++){ searchReverse.push_back(it); }
+                }
+                
+                for(int s = 0; s < searchReverse.size(); s++){
+                    map<string, vector<int> >::iterator it = searchReverse[s];
                     string oligo = it->first;
                     //cout << "before = " << oligo << '\t' << rawRSequence.substr(0,oligo.length()+bdiffs) << endl;
                     if(rawRSequence.length() < maxRBarcodeLength){	//let's just assume that the barcodes are the same length
@@ -1622,8 +1693,11 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
         success.push_back(pdiffs + 1000);
         success.push_back(1e6);
         
-        //can you find the forward barcode
-        for(map<int,oligosPair>::iterator it=ipprimers.begin();it!=ipprimers.end();it++){
+        //can you find the forward barcode, the lookup jumps straight to the pair that ends the search
+        map<int,oligosPair>::iterator itFirst = ipprimers.end();
+        int first = pairedPrimerLookup.findFirst(rawFSequence, rawRSequence);
+        if (first != -1) { itFirst = ipprimers.find(first); }
+        for(map<int,oligosPair>::iterator it=itFirst;it!=ipprimers.end();it++){
             string foligo = it->second.forward;
             string roligo = it->second.reverse;
             
@@ -1692,7 +1766,17 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
              but if best match forward = 4, and reverse = 1, we want to count as a valid match because forward 1 and forward 4 are the same. so both barcodes map to same group.
              */
             //cout << endl << forwardSeq.getName() << endl;
-            for(map<string, vector<int> >::iterator it=ifprimers.begin();it!=ifprimers.end();it++){
+            //only align the forward primers the lookup found within pdiffs substitutions, or all of them if it found none
+            vector<map<string, vector<int> >::iterator> searchForward;
+            vector<int> closest;
+            if ((rawFSequence.length() >= maxFPrimerLength) && pairedPrimerLookup.forward.findClose(rawFSequence, closest)) {
+                for (int i = 0; i < closest.size(); i++) { searchForward.push_back(ifprimers.find(pairedPrimerLookup.forward.getOligo(closest[i]))); }
+            }else {
+                for(map<string, vector<int> >::iterator it=ifprimers.begin();it!=ifprimers.end();it++){ searchForward.push_back(it); }
+            }
+            
+            for(int s = 0; s < searchForward.size(); s++){
+                map<string, vector<int> >::iterator it = searchForward[s];
                 string oligo = it->first;
                 
                 if(rawFSequence.length() < maxFPrimerLength){	//let's just assume that the barcodes are the same length
@@ -1766,7 +1850,16 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
                 vector< vector<int> > minRGroup;
                 vector<int> minRPos;
                 
-                for(map<string, vector<int> >::iterator it=irprimers.begin();it!=irprimers.end();it++){
+                //only align the reverse primers the lookup found within pdiffs substitutions, or all of them if it found none
+                vector<map<string, vector<int> >::iterator> searchReverse;
+                if ((rawRSequence.length() >= maxRPrimerLength) && pairedPrimerLookup.reverse.findClose(rawRSequence, closest)) {
+                    for (int i = 0; i < closest.size(); i++) { searchReverse.push_back(irprimers.find(pairedPrimerLookup.reverse.getOligo(closest[i]))); }
+                }else {
+                    for(map<string, vector<int> >::iterator it=irprimers.begin();it!=irprimers.end();it++){ searchReverse.push_back(it); }
+                }
+                
+                for(int s = 0; s < searchReverse.size(); s++){
+                    map<string, vector<int> >::iterator it = searchReverse[s];
                     string oligo = it->first;
                     //cout << "before = " << oligo << '\t' << rawRSequence.substr(0,oligo.length()+pdiffs) << endl;
                     if(rawRSequence.length() < maxRPrimerLength){	//let's just assume that the barcodes are the same length
@@ -1879,8 +1972,11 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
         success.push_back(pdiffs + 1000);
         success.push_back(1e6);
         
-        //can you find the forward barcode
-        for(map<int,oligosPair>::iterator it=ipprimers.begin();it!=ipprimers.end();it++){
+        //can you find the forward barcode, the lookup jumps straight to the pair that ends the search
+        map<int,oligosPair>::iterator itFirst = ipprimers.end();
+        int first = pairedPrimerLookup.findFirst(rawFSequence, rawRSequence);
+        if (first != -1) { itFirst = ipprimers.find(first); }
+        for(map<int,oligosPair>::iterator it=itFirst;it!=ipprimers.end();it++){
             string foligo = it->second.forward;
             string roligo = it->second.reverse;
             
@@ -1945,7 +2041,17 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
              but if best match forward = 4, and reverse = 1, we want to count as a valid match because forward 1 and forward 4 are the same. so both barcodes map to same group.
              */
             //cout << endl << forwardSeq.getName() << endl;
-            for(map<string, vector<int> >::iterator it=ifprimers.begin();it!=ifprimers.end();it++){
+            //only align the forward primers the lookup found within pdiffs substitutions, or all of them if it found none
+            vector<map<string, vector<int> >::iterator> searchForward;
+            vector<int> closest;
+            if ((rawFSequence.length() >= maxFPrimerLength) && pairedPrimerLookup.forward.findClose(rawFSequence, closest)) {
+                for (int i = 0; i < closest.size(); i++) { searchForward.push_back(ifprimers.find(pairedPrimerLookup.forward.getOligo(closest[i]))); }
+            }else {
+                for(map<string, vector<int> >::iterator it=ifprimers.begin();it!=ifprimers.end();it++){ searchForward.push_back(it); }
+            }
+            
+            for(int s = 0; s < searchForward.size(); s++){
+                map<string, vector<int> >::iterator it = searchForward[s];
                 string oligo = it->first;
                 
                 if(rawFSequence.length() < maxFPrimerLength){	//let's just assume that the barcodes are the same length
@@ -2019,7 +2125,16 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
                 vector< vector<int> > minRGroup;
                 vector<int> minRPos;
                 
-                for(map<string, vector<int> >::iterator it=irprimers.begin();it!=irprimers.end();it++){
+                //only align the reverse primers the lookup found within pdiffs substitutions, or all of them if it found none
+                vector<map<string, vector<int> >::iterator> searchReverse;
+                if ((rawRSequence.length() >= maxRPrimerLength) && pairedPrimerLookup.reverse.findClose(rawRSequence, closest)) {
+                    for (int i = 0; i < closest.size(); i++) { searchReverse.push_back(irprimers.find(pairedPrimerLookup.reverse.getOligo(closest[i]))); }
+                }else {
+                    for(map<string, vector<int> >::iterator it=irprimers.begin();it!=irprimers.end();it++){ searchReverse.push_back(it); }
+                }
+                
+                for(int s = 0; s < searchReverse.size(); s++){
+                    map<string, vector<int> >::iterator it = searchReverse[s];
                     string oligo = it->first;
                     //cout << "before = " << oligo << '\t' << rawRSequence.substr(0,oligo.length()+pdiffs) << endl;
                     if(rawRSequence.length() < maxRPrimerLength){	//let's just assume that the barcodes are the same length
@@ -2128,8 +2243,11 @@ vector<int> TrimOligos::stripBarcode(Sequence& seq, int& group){
         success.push_back(bdiffs + 1000);	//guilty until proven innocent
         success.push_back(1e6);
         
-        //can you find the barcode
-        for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++){
+        //can you find the barcode, the lookup jumps straight to the one that ends the search
+        map<string,int>::iterator itFirst = barcodes.end();
+        int first = barcodeLookup.findFirst(rawSequence);
+        if (first != -1) { itFirst = barcodes.find(barcodeLookup.getOligo(first)); }
+        for(map<string,int>::iterator it=itFirst;it!=barcodes.end();it++){
             string oligo = it->first;
             if(rawSequence.length() < oligo.length()){	//let's just assume that the barcodes are the same length
                 success[0] = rawSequence.length();
@@ -2159,7 +2277,17 @@ vector<int> TrimOligos::stripBarcode(Sequence& seq, int& group){
             int minGroup = -1;
             int minPos = 0;
             
-            for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++){
+            //only align the barcodes the lookup found within bdiffs substitutions, or all of them if it found none
+            vector<map<string,int>::iterator> searchOligos;
+            vector<int> closest;
+            if ((rawSequence.length() >= maxFBarcodeLength) && barcodeLookup.findClose(rawSequence, closest)) {
+                for (int i = 0; i < closest.size(); i++) { searchOligos.push_back(barcodes.find(barcodeLookup.getOligo(closest[i]))); }
+            }else {
+                for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++){ searchOligos.push_back(it); }
+            }
+            
+            for(int s = 0; s < searchOligos.size(); s++){
+                map<string,int>::iterator it = searchOligos[s];
                 string oligo = it->first;
                 // int length = oligo.length();
                 
@@ -2233,8 +2361,11 @@ vector<int> TrimOligos::stripForward(Sequence& seq, int& group){
         success.push_back(pdiffs + 1000);	//guilty until proven innocent
         success.push_back(1e6);
         
-        //can you find the primer
-        for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++){
+        //can you find the primer, the lookup jumps straight to the one that ends the search
+        map<string,int>::iterator itFirst = primers.end();
+        int first = primerLookup.findFirst(rawSequence);
+        if (first != -1) { itFirst = primers.find(primerLookup.getOligo(first)); }
+        for(map<string,int>::iterator it=itFirst;it!=primers.end();it++){
             string oligo = it->first;
             if(rawSequence.length() < oligo.length()){	//let's just assume that the primers are the same length
                 success[0] = rawSequence.length();
@@ -2264,7 +2395,17 @@ vector<int> TrimOligos::stripForward(Sequence& seq, int& group){
             int minGroup = -1;
             int minPos = 0;
             
-            for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++){
+            //only align the primers the lookup found within pdiffs substitutions, or all of them if it found none
+            vector<map<string,int>::iterator> searchOligos;
+            vector<int> closest;
+            if ((rawSequence.length() >= maxFPrimerLength) && primerLookup.findClose(rawSequence, closest)) {
+                for (int i = 0; i < closest.size(); i++) { searchOligos.push_back(primers.find(primerLookup.getOligo(closest[i]))); }
+            }else {
+                for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++){ searchOligos.push_back(it); }
+            }
+            
+            for(int s = 0; s < searchOligos.size(); s++){
+                map<string,int>::iterator it = searchOligos[s];
                 string oligo = it->first;
                 // int length = oligo.length();
                 
@@ -2341,8 +2482,11 @@ vector<int> TrimOligos::stripForward(Sequence& seq, QualityScores& qual, int& gr
         
         string rawSequence = seq.getUnaligned();
         
-        //can you find the primer
-        for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++){
+        //can you find the primer, the lookup jumps straight to the one that ends the search
+        map<string,int>::iterator itFirst = primers.end();
+        int first = primerLookup.findFirst(rawSequence);
+        if (first != -1) { itFirst = primers.find(primerLookup.getOligo(first)); }
+        for(map<string,int>::iterator it=itFirst;it!=primers.end();it++){
             string oligo = it->first;
             if(rawSequence.length() < oligo.length()){	//let's just assume that the primers are the same length
                 success[0] = rawSequence.length();
@@ -2375,7 +2519,17 @@ vector<int> TrimOligos::stripForward(Sequence& seq, QualityScores& qual, int& gr
             int minGroup = -1;
             int minPos = 0;
             
-            for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++){
+            //only align the primers the lookup found within pdiffs substitutions, or all of them if it found none
+            vector<map<string,int>::iterator> searchOligos;
+            vector<int> closest;
+            if ((rawSequence.length() >= maxFPrimerLength) && primerLookup.findClose(rawSequence, closest)) {
+                for (int i = 0; i < closest.size(); i++) { searchOligos.push_back(primers.find(primerLookup.getOligo(closest[i]))); }
+            }else {
+                for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++){ searchOligos.push_back(it); }
+            }
+            
+            for(int s = 0; s < searchOligos.size(); s++){
+                map<string,int>::iterator it = searchOligos[s];
                 string oligo = it->first;
                 // int length = oligo.length();
                 
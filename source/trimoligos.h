@@ -14,6 +14,7 @@
 #include "mothurout.h"
 #include "sequence.hpp"
 #include "qualityscores.h"
+#include "oligolookup.h"
 
 
 class TrimOligos {
@@ -75,6 +76,8 @@ class TrimOligos {
         map<string, vector<int> > irprimers;
         map<int, oligosPair> ipbarcodes;
         map<int, oligosPair> ipprimers;
+        OligoLookup barcodeLookup, primerLookup;
+        OligoPairLookup pairedBarcodeLookup, pairedPrimerLookup;
     
         int maxFBarcodeLength, maxRBarcodeLength, maxFPrimerLength, maxRPrimerLength, maxLinkerLength, maxSpacerLength;
 	
@@ -9,7 +9,7 @@ bool isgap(byte c)
 
 const char *WordToStrAmino(unsigned Word, unsigned WordLength)
 	{
-	static char Str[32];
+	static thread_local char Str[32];
 	for (unsigned i = 0; i < WordLength; ++i)
 		{
 		unsigned Letter = Word%20;
@@ -34,7 +34,7 @@ const char *WordToStrAmino2(unsigned Word, unsigned WordLength, char *Str)
 
 const char *WordToStrNucleo(unsigned Word, unsigned WordLength)
 	{
-	static char Str[32];
+	static thread_local char Str[32];
 	for (unsigned i = 0; i < WordLength; ++i)
 		{
 		unsigned Letter = Word%4;
@@ -3,8 +3,8 @@
 #include "dp.h"
 #include "seq.h"
 
-static AlnParams g_AP;
-static bool g_APInitDone = false;
+static thread_local AlnParams g_AP;
+static thread_local bool g_APInitDone = false;
 
 bool GlobalAlign(const SeqData &Query, const SeqData &Target, PathData &PD)
 	{
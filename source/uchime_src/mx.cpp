@@ -5,12 +5,12 @@
 
 char ProbToChar(float p);
 
-list<MxBase *> *MxBase::m_Matrices = 0;
-unsigned MxBase::m_AllocCount;
-unsigned MxBase::m_ZeroAllocCount;
-unsigned MxBase::m_GrowAllocCount;
-double MxBase::m_TotalBytes;
-double MxBase::m_MaxBytes;
+thread_local list<MxBase *> *MxBase::m_Matrices = 0;
+thread_local unsigned MxBase::m_AllocCount;
+thread_local unsigned MxBase::m_ZeroAllocCount;
+thread_local unsigned MxBase::m_GrowAllocCount;
+thread_local double MxBase::m_TotalBytes;
+thread_local double MxBase::m_MaxBytes;
 
 static const char *LogizeStr(const char *s)
 	{
@@ -48,7 +48,10 @@ void MxBase::OnDtor(MxBase *Mx)
 			{
 			m_Matrices->erase(p);
 			if (m_Matrices->empty())
+				{
 				delete m_Matrices;
+				m_Matrices = 0;
+				}
 			return;
 			}
 		}
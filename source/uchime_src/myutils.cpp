@@ -10,6 +10,8 @@
 #include <map>
 #include <signal.h>
 #include <float.h>
+#include <mutex>
+#include <stdexcept>
 
 #ifdef _MSC_VER
 #include <crtdbg.h>
@@ -40,9 +42,10 @@ const unsigned MY_IO_BUFSIZ = 32000;
 const unsigned MAX_FORMATTED_STRING_LENGTH = 64000;
 
 static char *g_IOBuffers[256];
+static mutex g_IOBuffersLock;
 static time_t g_StartTime = time(0);
 static vector<string> g_Argv;
-static double g_PeakMemUseBytes;
+static thread_local double g_PeakMemUseBytes;
 
 #if	TEST_UTILS
 void TestUtils()
@@ -80,14 +83,15 @@ static void AllocBuffer(FILE *f)
 	int fd = fileno(f);
 	if (fd < 0 || fd >= 256)
 		return;
+	lock_guard<mutex> Lock(g_IOBuffersLock);
 	if (g_IOBuffers[fd] == 0)
 		g_IOBuffers[fd] = myalloc(char, MY_IO_BUFSIZ);
 	setvbuf(f, g_IOBuffers[fd], _IOFBF, MY_IO_BUFSIZ);
 	}
 
-static void FreeBuffer(FILE *f)
+// Caller holds g_IOBuffersLock.
+static void FreeBuffer(int fd)
 	{
-	int fd = fileno(f);
 	if (fd < 0 || fd >= 256)
 		return;
 	if (g_IOBuffers[fd] == 0)
@@ -101,13 +105,14 @@ unsigned GetElapsedSecs()
 	return (unsigned) (time(0) - g_StartTime);
 	}
 
-static unsigned g_NewCalls;
-static unsigned g_FreeCalls;
-static double g_InitialMemUseBytes;
-static double g_TotalAllocBytes;
-static double g_TotalFreeBytes;
-static double g_NetBytes;
-static double g_MaxNetBytes;
+// Per thread, so threads searching at once don't race on the counts.
+static thread_local unsigned g_NewCalls;
+static thread_local unsigned g_FreeCalls;
+static thread_local double g_InitialMemUseBytes;
+static thread_local double g_TotalAllocBytes;
+static thread_local double g_TotalFreeBytes;
+static thread_local double g_NetBytes;
+static thread_local double g_MaxNetBytes;
 
 void LogAllocStats()
 	{
@@ -477,10 +482,15 @@ void CloseStdioFile(FILE *f)
 	{
 	if (f == 0)
 		return;
+
+// Another thread may be given fd as soon as f is closed,
+// it must not find this buffer still assigned to it.
+	int fd = fileno(f);
+	lock_guard<mutex> Lock(g_IOBuffersLock);
 	int Ok = fclose(f);
 	if (Ok != 0)
 		Die("fclose(%p)=%d", f, Ok);
-	FreeBuffer(f);
+	FreeBuffer(fd);
 	}
 
 off_t GetStdioFilePos(FILE *f)
@@ -514,7 +524,7 @@ void DeleteStdioFile(const string &FileName)
 
 void myvstrprintf(string &Str, const char *Format, va_list ArgList)
 	{
-	static char szStr[MAX_FORMATTED_STRING_LENGTH];
+	static thread_local char szStr[MAX_FORMATTED_STRING_LENGTH];
 	vsnprintf(szStr, MAX_FORMATTED_STRING_LENGTH-1, Format, ArgList);
 	szStr[MAX_FORMATTED_STRING_LENGTH - 1] = '\0';
 	Str.assign(szStr);
@@ -545,7 +555,7 @@ void Log(const char *Format, ...)
 	if (g_fLog == 0)
 		return;
 
-	static bool InLog = false;
+	static thread_local bool InLog = false;
 	if (InLog)
 		return;
 
@@ -558,12 +568,10 @@ void Log(const char *Format, ...)
 	InLog = false;
 	}
 
+// Throws rather than exits, uchime may be running inside another
+// program. The uchime command line catches it in main().
 void Die(const char *Format, ...)
 	{
-	static bool InDie = false;
-	if (InDie)
-		exit(1);
-	InDie = true;
 	string Msg;
 
 	if (g_fLog != 0)
@@ -573,34 +581,25 @@ void Die(const char *Format, ...)
 	myvstrprintf(Msg, Format, ArgList);
 	va_end(ArgList);
 
-	fprintf(stderr, "\n\n");
 	Log("\n");
 	time_t t = time(0);
 	Log("%s", asctime(localtime(&t)));
 	for (unsigned i = 0; i < g_Argv.size(); i++)
-		{
-		fprintf(stderr, (i == 0) ? "%s" : " %s", g_Argv[i].c_str());
 		Log((i == 0) ? "%s" : " %s", g_Argv[i].c_str());
-		}
-	fprintf(stderr, "\n");
 	Log("\n");
 
 	time_t CurrentTime = time(0);
 	unsigned ElapsedSeconds = unsigned(CurrentTime - g_StartTime);
 	const char *sstr = SecsToStr(ElapsedSeconds);
 	Log("Elapsed time: %s\n", sstr);
-
-	const char *szStr = Msg.c_str();
-	fprintf(stderr, "\n---Fatal error---\n%s\n", szStr);
-	Log("\n---Fatal error---\n%s\n", szStr);
+	Log("\n---Fatal error---\n%s\n", Msg.c_str());
 
 #ifdef _MSC_VER
 	if (IsDebuggerPresent())
  		__debugbreak();
-	_CrtSetDbgFlag(0);
 #endif
 
-	exit(1);
+	throw runtime_error(Msg);
 	}
 
 void Warning(const char *Format, ...)
@@ -638,8 +637,8 @@ double GetMemUseBytes()
 #elif	linux || __linux__
 double GetMemUseBytes()
 	{
-	static char statm[64];
-	static int PageSize = 1;
+	static thread_local char statm[64];
+	static thread_local int PageSize = 1;
 	if (0 == statm[0])
 		{
 		PageSize = sysconf(_SC_PAGESIZE);
@@ -722,7 +721,7 @@ const char *SecsToHHMMSS(int Secs)
 	int HH = Secs/3600;
 	int MM = (Secs - HH*3600)/60;
 	int SS = Secs%60;
-	static char Str[16];
+	static thread_local char Str[16];
 	if (HH == 0)
 		sprintf(Str, "%02d:%02d", MM, SS);
 	else
@@ -735,7 +734,7 @@ const char *SecsToStr(double Secs)
 	if (Secs >= 10.0)
 		return SecsToHHMMSS((int) Secs);
 
-	static char Str[16];
+	static thread_local char Str[16];
 	if (Secs < 1e-6)
 		sprintf(Str, "%.2gs", Secs);
 	else if (Secs < 1e-3)
@@ -747,7 +746,7 @@ const char *SecsToStr(double Secs)
 
 const char *MemBytesToStr(double Bytes)
 	{
-	static char Str[32];
+	static thread_local char Str[32];
 
 	if (Bytes < 1e6)
 		sprintf(Str, "%.1fkb", Bytes/1e3);
@@ -766,7 +765,7 @@ const char *MemBytesToStr(double Bytes)
 
 const char *IntToStr(unsigned i)
 	{
-	static char Str[32];
+	static thread_local char Str[32];
 
 	double d = (double) i;
 	if (i < 10000)
@@ -788,7 +787,7 @@ const char *IntToStr(unsigned i)
 
 const char *FloatToStr(double d)
 	{
-	static char Str[32];
+	static thread_local char Str[32];
 
 	double a = fabs(d);
 	if (a < 0.01)
@@ -960,7 +959,7 @@ const char *PctStr(double x, double y)
 		else
 			return "inf%";
 		}
-	static char Str[16];
+	static thread_local char Str[16];
 	double p = x*100.0/y;
 	sprintf(Str, "%5.1f%%", p);
 	return Str;
@@ -1167,12 +1166,8 @@ void CmdLineErr(const char *Format, ...)
 	string Str;
 	myvstrprintf(Str, Format, ArgList);
 	va_end(ArgList);
-	fprintf(stderr, "\n");
-	fprintf(stderr, "Invalid command line\n");
-	fprintf(stderr, "%s\n", Str.c_str());
-	fprintf(stderr, "For list of command-line options use --help.\n");
-	fprintf(stderr, "\n");
-	exit(1);
+	Die("Invalid command line\n%s\nFor list of command-line options use --help.",
+	  Str.c_str());
 	}
 
 static set<OptInfo>::iterator GetOptInfo(const string &LongName,
@@ -1207,6 +1202,7 @@ static void DefineFlagOpt(const string &LongName, const string &Help,
   void *Value, bool *OptSet)
 	{
 	*(bool *) Value = false;
+	*OptSet = false;
 
 	OptInfo Opt;
 	Opt.Value = Value;
@@ -1222,6 +1218,7 @@ static void DefineTogOpt(const string &LongName, bool Default, const string &Hel
   void *Value, bool *OptSet)
 	{
 	*(bool *) Value = Default;
+	*OptSet = false;
 
 	OptInfo Opt;
 	Opt.Value = Value;
@@ -1237,6 +1234,7 @@ static void DefineIntOpt(const string &LongName, int Default, int Min, int Max,
   const string &Help, void *Value, bool *OptSet)
 	{
 	*(int *) Value = Default;
+	*OptSet = false;
 
 	OptInfo Opt;
 	Opt.Value = Value;
@@ -1254,6 +1252,7 @@ static void DefineUnsOpt(const string &LongName, unsigned Default, unsigned Min,
   unsigned Max, const string &Help, void *Value, bool *OptSet)
 	{
 	*(unsigned *) Value = Default;
+	*OptSet = false;
 
 	OptInfo Opt;
 	Opt.Value = Value;
@@ -1271,6 +1270,7 @@ static void DefineFloatOpt(const string &LongName, double Default, double Min,
   double Max, const string &Help, void *Value, bool *OptSet)
 	{
 	*(double *) Value = Default;
+	*OptSet = false;
 
 	OptInfo Opt;
 	Opt.Value = Value;
@@ -1288,6 +1288,7 @@ static void DefineStrOpt(const string &LongName, const char *Default,
   const string &Help, void *Value, bool *OptSet)
 	{
 	*(string *) Value = (Default == 0 ? "" : string(Default));
+	*OptSet = false;
 
 	OptInfo Opt;
 	Opt.Value = Value;
@@ -1526,6 +1527,13 @@ void MyCmdLine(int argc, char **argv)
 	static unsigned RecurseDepth = 0;
 	++RecurseDepth;
 
+// May be called again for a new run, every option goes back to its default.
+	if (RecurseDepth == 1)
+		{
+		g_Opts.clear();
+		g_Argv.clear();
+		}
+
 	DefineFlagOpt("compilerinfo", "Write info about compiler types and #defines to stdout.",
 	  (void *) &opt_compilerinfo, &optset_compilerinfo);
 	DefineFlagOpt("quiet", "Turn off progress messages.", (void *) &opt_quiet, &optset_quiet);
@@ -1550,76 +1558,82 @@ void MyCmdLine(int argc, char **argv)
 #define ENUM_OPT(LongName, Values, Default)		DefineEnumOpt(#LongName, Values, Default, "help", (void *) &opt_##LongName, &optset_##LongName);
 #include "myopts.h"
 
-	if (RecurseDepth == 0)
-		g_Argv.clear();
-
 	for (int i = 0; i < argc; ++i) {
 		g_Argv.push_back(string(argv[i]));
 	}
 
-	int i = 1;
-	for (;;)
+	try
 		{
-		if (i >= argc)
-			break;
-		const string &Arg = g_Argv[i];
-			
-		if (Arg.empty())
-			continue;
-		else if (Arg == "file:" && i + 1 < argc)
-			{
-			const string &FileName = g_Argv[i+1];
-			vector<string> Args;
-			GetArgsFromFile(FileName, Args);
-			for (vector<string>::const_iterator p = Args.begin();
-			  p != Args.end(); ++p)
-				{
-				g_Argv.push_back(*p);
-				++argc;
-				}
-			i += 2;
-			continue;
-			}
-		else if (Arg.size() > 1 && Arg[0] == '-')
+		int i = 1;
+		for (;;)
 			{
-			string LongName = (Arg.size() > 2 && Arg[1] == '-' ? Arg.substr(2) : Arg.substr(1));
-			OptInfo Opt = *GetOptInfo(LongName, true);
-			*Opt.OptSet = true;
-			if (Opt.Type == OT_Flag)
+			if (i >= argc)
+				break;
+			const string &Arg = g_Argv[i];
+			
+			if (Arg.empty())
+				continue;
+			else if (Arg == "file:" && i + 1 < argc)
 				{
-				g_Opts.erase(Opt);
-				*(bool *) Opt.Value = true;
-				g_Opts.insert(Opt);
-				++i;
+				const string &FileName = g_Argv[i+1];
+				vector<string> Args;
+				GetArgsFromFile(FileName, Args);
+				for (vector<string>::const_iterator p = Args.begin();
+				  p != Args.end(); ++p)
+					{
+					g_Argv.push_back(*p);
+					++argc;
+					}
+				i += 2;
 				continue;
 				}
-			else if (Opt.Type == OT_Tog)
+			else if (Arg.size() > 1 && Arg[0] == '-')
 				{
-				g_Opts.erase(Opt);
-				if (string("no") + Opt.LongName == LongName)
-					*(bool *) Opt.Value = false;
-				else
+				string LongName = (Arg.size() > 2 && Arg[1] == '-' ? Arg.substr(2) : Arg.substr(1));
+				OptInfo Opt = *GetOptInfo(LongName, true);
+				*Opt.OptSet = true;
+				if (Opt.Type == OT_Flag)
 					{
-					asserta(Opt.LongName == LongName);
+					g_Opts.erase(Opt);
 					*(bool *) Opt.Value = true;
+					g_Opts.insert(Opt);
+					++i;
+					continue;
+					}
+				else if (Opt.Type == OT_Tog)
+					{
+					g_Opts.erase(Opt);
+					if (string("no") + Opt.LongName == LongName)
+						*(bool *) Opt.Value = false;
+					else
+						{
+						asserta(Opt.LongName == LongName);
+						*(bool *) Opt.Value = true;
+						}
+					g_Opts.insert(Opt);
+					++i;
+					continue;
 					}
-				g_Opts.insert(Opt);
-				++i;
-				continue;
-				}
 
-			++i;
-			if (i >= argc)
-				CmdLineErr("Missing value for option --%s", LongName.c_str());
+				++i;
+				if (i >= argc)
+					CmdLineErr("Missing value for option --%s", LongName.c_str());
 
-			string Value = g_Argv[i];
-			SetOpt(Opt, Value);
+				string Value = g_Argv[i];
+				SetOpt(Opt, Value);
 
-			++i;
-			continue;
+				++i;
+				continue;
+				}
+			else
+				CmdLineErr("Expected -option_name or --option_name, got '%s'", Arg.c_str());
 			}
-		else
-			CmdLineErr("Expected -option_name or --option_name, got '%s'", Arg.c_str());
+		}
+	catch (...)
+		{
+// Bad options throw, leave the depth ready for the next call.
+		--RecurseDepth;
+		throw;
 		}
 
 	--RecurseDepth;
@@ -14,8 +14,32 @@ struct PathBuffer
 	bool InUse;
 	};
 
-static PathBuffer **g_PathBuffers;
-static unsigned g_PathBufferSize;
+// Each thread has its own pool, freed when the thread exits.
+struct PathBufferPool
+	{
+	PathBuffer **Buffers;
+	unsigned Size;
+
+	PathBufferPool()
+		{
+		Buffers = 0;
+		Size = 0;
+		}
+
+	~PathBufferPool()
+		{
+		for (unsigned i = 0; i < Size; ++i)
+			{
+			MYFREE(Buffers[i]->Buffer, Buffers[i]->Size, Path);
+			MYFREE(Buffers[i], 1, Path);
+			}
+		MYFREE(Buffers, Size, Path);
+		}
+	};
+
+static thread_local PathBufferPool g_PathBufferPool;
+#define g_PathBuffers		g_PathBufferPool.Buffers
+#define g_PathBufferSize	g_PathBufferPool.Size
 
 static char *AllocBuffer(unsigned Size)
 	{
@@ -8,7 +8,7 @@
 
 #define TRACE	0
 
-extern FILE *g_fUChime;
+extern thread_local FILE *g_fUChime;
 
 void GetCandidateParents(Ultra &U, const SeqData &QSD, float AbQ,
   vector<unsigned> &Parents);
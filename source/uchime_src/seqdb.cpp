@@ -5,6 +5,8 @@
 #include "sfasta.h"
 #include "seq.h"
 
+unsigned GetWord(const byte *Seq);
+
 void SeqToFasta(FILE *f, const char *Label, const byte *Seq, unsigned L)
 	{
 	const unsigned ROWLEN = 80;
@@ -59,6 +61,9 @@ void SeqDB::Clear(bool ctor)
 	m_Aligned = false;
 	m_IsNucleo = false;
 	m_IsNucleoSet = false;
+
+	m_Words.clear();
+	m_WordsIndexed = false;
 	}
 
 void SeqDB::InitEmpty(bool Nucleo)
@@ -263,10 +268,40 @@ unsigned SeqDB::AddSeq(const char *Label, const byte *Seq, unsigned L)
 
 	m_SeqLengths[Index] = L;
 
+	if (m_WordsIndexed)
+		AddWords(Index);
+
 	EndTimer(AddSeq);
 	return Index;
 	}
 
+// USort finds the words of every target for every query, index them
+// once instead. Sequences added later are indexed as they are added.
+void SeqDB::IndexWords()
+	{
+	m_Words.clear();
+	m_WordsIndexed = true;
+	for (unsigned SeqIndex = 0; SeqIndex < m_SeqCount; ++SeqIndex)
+		AddWords(SeqIndex);
+	}
+
+void SeqDB::AddWords(unsigned SeqIndex)
+	{
+	m_Words.resize(SeqIndex + 1);
+	vector<unsigned> &Words = m_Words[SeqIndex];
+	Words.clear();
+
+	const unsigned L = m_SeqLengths[SeqIndex];
+	if (L <= opt_w)
+		return;
+
+	const byte *Seq = m_Seqs[SeqIndex];
+	const unsigned N = L - opt_w + 1;
+	Words.reserve(N);
+	for (unsigned i = 0; i < N; ++i)
+		Words.push_back(GetWord(Seq + i));
+	}
+
 unsigned SeqDB::GetIndex(const char *Label) const
 	{
 	for (unsigned i = 0; i < m_SeqCount; ++i)
@@ -26,6 +26,10 @@ public:
 	bool m_IsNucleo;
 	bool m_IsNucleoSet;
 
+// Words of each sequence, see IndexWords()
+	vector<vector<unsigned> > m_Words;
+	bool m_WordsIndexed;
+
 public:
 	SeqDB();
 	~SeqDB();
@@ -33,6 +37,8 @@ public:
 	void InitEmpty(bool Nucleo);
 
 	unsigned AddSeq(const char *Label, const byte *Seq, unsigned L);
+	void IndexWords();
+	void AddWords(unsigned SeqIndex);
 
 	byte *GetSeq(unsigned SeqIndex) const
 		{
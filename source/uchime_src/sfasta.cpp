@@ -221,7 +221,7 @@ const byte *SFasta::GetNextSeqLo()
 		else
 			{
 			const char *Label = (m_Label == 0 ? "" : m_Label);
-			static bool WarningDone = false;
+			static thread_local bool WarningDone = false;
 			if (!WarningDone)
 				{
 				if (isgap(c))
@@ -2,14 +2,16 @@
 
 #define TRACE	0
 
-Mx<byte> g_Mx_TBBit;
-byte **g_TBBit;
-float *g_DPRow1;
-float *g_DPRow2;
-static float *g_DPBuffer1;
-static float *g_DPBuffer2;
+// One set per thread so threads can align at once, the vectors
+// free the rows when the thread exits.
+thread_local Mx<byte> g_Mx_TBBit;
+thread_local byte **g_TBBit;
+thread_local float *g_DPRow1;
+thread_local float *g_DPRow2;
+static thread_local vector<float> g_DPBuffer1;
+static thread_local vector<float> g_DPBuffer2;
 
-static unsigned g_CacheLB;
+static thread_local unsigned g_CacheLB;
 
 void AllocBit(unsigned LA, unsigned LB)
 	{
@@ -17,18 +19,15 @@ void AllocBit(unsigned LA, unsigned LB)
 	g_TBBit = g_Mx_TBBit.GetData();
 	if (LB > g_CacheLB)
 		{
-		MYFREE(g_DPBuffer1, g_CacheLB, AllocBit);
-		MYFREE(g_DPBuffer2, g_CacheLB, AllocBit);
-
 		g_CacheLB = LB + 128;
 
 	// Allow use of [-1]
 		//g_DPBuffer1 = myalloc<float>(g_CacheLB+3);
 		//g_DPBuffer2 = myalloc<float>(g_CacheLB+3);
-		g_DPBuffer1 = MYALLOC(float, g_CacheLB+3, AllocBit);
-		g_DPBuffer2 = MYALLOC(float, g_CacheLB+3, AllocBit);
-		g_DPRow1 = g_DPBuffer1 + 1;
-		g_DPRow2 = g_DPBuffer2 + 1;
+		g_DPBuffer1.resize(g_CacheLB+3);
+		g_DPBuffer2.resize(g_CacheLB+3);
+		g_DPRow1 = &g_DPBuffer1[0] + 1;
+		g_DPRow2 = &g_DPBuffer2[0] + 1;
 		}
 	}
 
@@ -0,0 +1,287 @@
+#include "myutils.h"
+#include "chime.h"
+#include "seqdb.h"
+#include "dp.h"
+#include "ultra.h"
+#include "hspfinder.h"
+#include "uchime.h"
+#include <algorithm>
+#include <set>
+
+bool SearchChime(Ultra &U, const SeqData &QSD, float QAb,
+  const AlnParams &AP, const AlnHeuristics &AH, HSPFinder &HF,
+  float MinFractId, ChimeHit2 &Hit);
+void SetNucSubstMx(double Match, double Mismatch);
+
+// Each search sets these for the thread running it.
+thread_local FILE *g_fUChime;
+thread_local FILE *g_fUChimeAlns;
+static thread_local const vector<float> *g_SortVecFloat;
+thread_local bool g_UchimeDeNovo = false;
+
+void Usage()
+	{
+	printf("\n");
+	printf("UCHIME %s by Robert C. Edgar\n", MY_VERSION);
+	printf("http://www.drive5.com/uchime\n");
+	printf("\n");
+	printf("This software is donated to the public domain\n");
+	printf("\n");
+
+	printf(
+#include "help.h"
+		);
+	}
+
+void SetBLOSUM62()
+	{
+	Die("SetBLOSUM62 not implemented");
+	}
+
+void ReadSubstMx(const string &/*FileName*/, Mx<float> &/*Mxf*/)
+	{
+	Die("ReadSubstMx not implemented");
+	}
+
+void LogAllocs()
+	{
+	/*empty*/
+	}
+
+static bool CmpDescVecFloat(unsigned i, unsigned j)
+	{
+	return (*g_SortVecFloat)[i] > (*g_SortVecFloat)[j];
+	}
+
+void Range(vector<unsigned> &v, unsigned N)
+	{
+	v.clear();
+	v.reserve(N);
+	for (unsigned i = 0; i < N; ++i)
+		v.push_back(i);
+	}
+
+void SortDescending(const vector<float> &Values, vector<unsigned> &Order)
+	{
+	StartTimer(Sort);
+	const unsigned N = SIZE(Values);
+	Range(Order, N);
+	g_SortVecFloat = &Values;
+	sort(Order.begin(), Order.end(), CmpDescVecFloat);
+	EndTimer(Sort);
+	}
+
+float GetAbFromLabel(const string &Label)
+	{
+	vector<string> Fields;
+	Split(Label, Fields, '/');
+	const unsigned N = SIZE(Fields);
+	for (unsigned i = 0; i < N; ++i)
+		{
+		const string &Field = Fields[i];
+		if (Field.substr(0, 3) == "ab=")
+			{
+			string a = Field.substr(3, string::npos);
+			return (float) atof(a.c_str());
+			}
+		}
+	if (g_UchimeDeNovo)
+		Die("Missing abundance /ab=xx/ in label >%s", Label.c_str());
+	return 0.0;
+	}
+
+void UChimeInit()
+	{
+	if (!optset_w)
+		opt_w = 8;
+
+	Log("%8.2f  minh\n", opt_minh);
+	Log("%8.2f  xn\n", opt_xn);
+	Log("%8.2f  dn\n", opt_dn);
+	Log("%8.2f  xa\n", opt_xa);
+	Log("%8.2f  mindiv\n", opt_mindiv);
+	Log("%8u  maxp\n", opt_maxp);
+
+// Matrix is set once and only read by searches.
+	SetNucSubstMx(opt_match, opt_mismatch);
+	}
+
+void UChimeSetOpts(const vector<string> &Args)
+	{
+	string Name = "uchime";
+	vector<char *> argv;
+	argv.push_back((char *) Name.c_str());
+	for (unsigned i = 0; i < SIZE(Args); ++i)
+		argv.push_back((char *) Args[i].c_str());
+
+	MyCmdLine(SIZE(argv), &argv[0]);
+	UChimeInit();
+	}
+
+SeqDB *UChimeReadDB(const string &FileName)
+	{
+	SeqDB *DB = new SeqDB;
+	try
+		{
+		DB->FromFasta(FileName);
+		if (!DB->IsNucleo())
+			Die("Database contains amino acid sequences");
+		}
+	catch (...)
+		{
+		delete DB;
+		throw;
+		}
+
+// Index words now so searches don't each redo it.
+	DB->IndexWords();
+	return DB;
+	}
+
+void UChimeFreeDB(SeqDB *DB)
+	{
+	delete DB;
+	}
+
+// Die() throws, so a search that fails closes its output files here,
+// which also frees their I/O buffers. A close that fails while the
+// first error is unwinding is ignored.
+struct SearchFilesCloser
+	{
+	~SearchFilesCloser()
+		{
+		try
+			{
+			CloseStdioFile(g_fUChime);
+			CloseStdioFile(g_fUChimeAlns);
+			}
+		catch (...)
+			{
+			}
+		g_fUChime = 0;
+		g_fUChimeAlns = 0;
+		}
+	};
+
+static unsigned Search(const SeqDB &Input, const SeqDB *RefDB,
+  const string &OutFileName, const string &AlnsFileName, unsigned &HitCount)
+	{
+	g_UchimeDeNovo = (RefDB == 0);
+
+	float MinFractId = 0.95f;
+	if (optset_id)
+		MinFractId = (float) opt_id;
+
+	g_fUChime = 0;
+	g_fUChimeAlns = 0;
+	SearchFilesCloser Closer;
+	if (OutFileName != "")
+		g_fUChime = CreateStdioFile(OutFileName);
+	if (AlnsFileName != "")
+		g_fUChimeAlns = CreateStdioFile(AlnsFileName);
+
+	const unsigned QuerySeqCount = Input.GetSeqCount();
+	vector<unsigned> Order;
+	for (unsigned i = 0; i < QuerySeqCount; ++i)
+		Order.push_back(i);
+
+// De novo searches grow their own database of parents, searches
+// only read a reference database so it can be shared.
+	SeqDB DeNovoDB;
+	SeqDB &DB = (g_UchimeDeNovo ? DeNovoDB : *(SeqDB *) RefDB);
+	if (g_UchimeDeNovo)
+		{
+		vector<float> Abs;
+		for (unsigned i = 0; i < QuerySeqCount; ++i)
+			{
+			const char *Label = Input.GetLabel(i);
+			float Ab = GetAbFromLabel(Label);
+			Abs.push_back(Ab);
+			}
+		SortDescending(Abs, Order);
+		DeNovoDB.m_IsNucleoSet = true;
+		DeNovoDB.m_IsNucleo = true;
+		DeNovoDB.IndexWords();
+		}
+
+	HitCount = 0;
+	for (unsigned i = 0; i < QuerySeqCount; ++i)
+		{
+		unsigned QuerySeqIndex = Order[i];
+
+		SeqData QSD;
+		Input.GetSeqData(QuerySeqIndex, QSD);
+
+		float QAb = -1.0;
+		if (g_UchimeDeNovo)
+			QAb = GetAbFromLabel(QSD.Label);
+
+		ChimeHit2 Hit;
+		AlnParams &AP = *(AlnParams *) 0;
+		AlnHeuristics &AH = *(AlnHeuristics *) 0;
+		HSPFinder &HF = *(HSPFinder *) 0;
+		bool Found = SearchChime(DB, QSD, QAb, AP, AH, HF, MinFractId, Hit);
+		if (Found)
+			++HitCount;
+		else
+			{
+			if (g_UchimeDeNovo)
+				DeNovoDB.AddSeq(QSD.Label, QSD.Seq, QSD.L);
+			}
+
+		WriteChimeHit(g_fUChime, Hit);
+
+		ProgressStep(i, QuerySeqCount, "%u/%u chimeras found (%.1f%%)", HitCount, i, Pct(HitCount, i+1));
+		}
+
+// Cleared before closing so the closer never closes a file twice.
+	FILE *fOut = g_fUChime;
+	g_fUChime = 0;
+	CloseStdioFile(fOut);
+	FILE *fAlns = g_fUChimeAlns;
+	g_fUChimeAlns = 0;
+	CloseStdioFile(fAlns);
+
+	return QuerySeqCount;
+	}
+
+unsigned UChime(const vector<string> &Labels, const vector<string> &Seqs,
+  const SeqDB *RefDB, const string &OutFileName, const string &AlnsFileName,
+  unsigned &HitCount)
+	{
+	asserta(SIZE(Labels) == SIZE(Seqs));
+
+// Same filtering as reading a FASTA file: letters only, and
+// --minlen / --maxlen applied.
+	SeqDB Input;
+	Input.InitEmpty(true);
+	const unsigned N = SIZE(Seqs);
+	for (unsigned i = 0; i < N; ++i)
+		{
+		const string &s = Seqs[i];
+		string Seq;
+		for (unsigned j = 0; j < SIZE(s); ++j)
+			if (isalpha(s[j]))
+				Seq.push_back(s[j]);
+
+		unsigned L = SIZE(Seq);
+		if (L < opt_minlen)
+			continue;
+		if (L > opt_maxlen && opt_maxlen != 0)
+			continue;
+		Input.AddSeq(Labels[i].c_str(), (const byte *) Seq.c_str(), L);
+		}
+
+	return Search(Input, RefDB, OutFileName, AlnsFileName, HitCount);
+	}
+
+unsigned UChime(const string &InputFileName, const SeqDB *RefDB,
+  const string &OutFileName, const string &AlnsFileName, unsigned &HitCount)
+	{
+	SeqDB Input;
+	Input.FromFasta(InputFileName);
+	if (!Input.IsNucleo())
+		Die("Input contains amino acid sequences");
+
+	return Search(Input, RefDB, OutFileName, AlnsFileName, HitCount);
+	}
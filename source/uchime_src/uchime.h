@@ -0,0 +1,39 @@
+#ifndef uchime_h
+#define uchime_h
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct SeqDB;
+
+// Entry points for running uchime inside another program. Errors are
+// reported by Die(), which throws runtime_error.
+
+// Parse uchime command-line options (without the program name) and
+// set up the substitution matrix. Call before starting any searches,
+// the options are shared by every thread.
+void UChimeSetOpts(const vector<string> &Args);
+
+// Same, for a caller that has already run MyCmdLine().
+void UChimeInit();
+
+// Print command-line help to stdout.
+void Usage();
+
+// Read a reference database. The database is read-only once loaded,
+// so one copy may be searched by several threads at once.
+SeqDB *UChimeReadDB(const string &FileName);
+void UChimeFreeDB(SeqDB *DB);
+
+// Search queries for chimeras, de novo if RefDB is null in which case
+// labels must have /ab=xx/. Results are written to OutFileName and
+// AlnsFileName if not empty. Returns number of queries searched.
+unsigned UChime(const vector<string> &Labels, const vector<string> &Seqs,
+  const SeqDB *RefDB, const string &OutFileName, const string &AlnsFileName,
+  unsigned &HitCount);
+unsigned UChime(const string &InputFileName, const SeqDB *RefDB,
+  const string &OutFileName, const string &AlnsFileName, unsigned &HitCount);
+
+#endif // uchime_h
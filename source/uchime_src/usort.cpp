@@ -7,8 +7,8 @@
 
 void SortDescending(const vector<float> &Values, vector<unsigned> &Order);
 
-static byte *g_QueryHasWord;
-static unsigned g_WordCount;
+static thread_local vector<byte> g_QueryHasWord;
+static thread_local unsigned g_WordCount;
 
 unsigned GetWord(const byte *Seq)
 	{
@@ -24,16 +24,16 @@ unsigned GetWord(const byte *Seq)
 
 static void SetQuery(const SeqData &Query)
 	{
-	if (g_QueryHasWord == 0)
+	if (g_QueryHasWord.empty())
 		{
 		g_WordCount = 4;
 		for (unsigned i = 1; i < opt_w; ++i)
 			g_WordCount *= 4;
 
-		g_QueryHasWord = myalloc(byte, g_WordCount);
+		g_QueryHasWord.resize(g_WordCount);
 		}
 
-	memset(g_QueryHasWord, 0, g_WordCount);
+	memset(&g_QueryHasWord[0], 0, g_WordCount);
 
 	if (Query.L <= opt_w)
 		return;
@@ -64,6 +64,16 @@ static unsigned GetUniqueWordsInCommon(const SeqData &Target)
 	return Count;
 	}
 
+static unsigned GetUniqueWordsInCommon(const vector<unsigned> &Words)
+	{
+	unsigned Count = 0;
+	const unsigned N = SIZE(Words);
+	for (unsigned i = 0; i < N; ++i)
+		if (g_QueryHasWord[Words[i]])
+			++Count;
+	return Count;
+	}
+
 void USort(const SeqData &Query, const SeqDB &DB, vector<float> &WordCounts, 
   vector<unsigned> &Order)
 	{
@@ -75,9 +85,15 @@ void USort(const SeqData &Query, const SeqDB &DB, vector<float> &WordCounts,
 	const unsigned SeqCount = DB.GetSeqCount();
 	for (unsigned SeqIndex = 0; SeqIndex < SeqCount; ++SeqIndex)
 		{
-		SeqData Target;
-		DB.GetSeqData(SeqIndex, Target);
-		float WordCount = (float) GetUniqueWordsInCommon(Target);
+		float WordCount;
+		if (DB.m_WordsIndexed)
+			WordCount = (float) GetUniqueWordsInCommon(DB.m_Words[SeqIndex]);
+		else
+			{
+			SeqData Target;
+			DB.GetSeqData(SeqIndex, Target);
+			WordCount = (float) GetUniqueWordsInCommon(Target);
+			}
 		WordCounts.push_back(WordCount);
 		}
 	SortDescending(WordCounts, Order);